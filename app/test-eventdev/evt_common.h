@@ -39,6 +39,7 @@ enum evt_prod_type {
 	EVT_PROD_TYPE_SYNT,          /* Producer type Synthetic i.e. CPU. */
 	EVT_PROD_TYPE_ETH_RX_ADPTR,  /* Producer type Eth Rx Adapter. */
 	EVT_PROD_TYPE_EVENT_TIMER_ADPTR,  /* Producer type Timer Adapter. */
+	EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR,  /* Producer type Crypto Adapter. */
 	EVT_PROD_TYPE_MAX,
 };
 
@@ -55,9 +56,12 @@ struct evt_options {
 	uint8_t timdev_cnt;
 	uint8_t nb_timer_adptrs;
 	uint8_t timdev_use_burst;
+	uint8_t timdev_batched;
+	uint8_t crypto_adptr_mode;
 	uint8_t sched_type_list[EVT_MAX_STAGES];
 	uint16_t mbuf_sz;
 	uint16_t wkr_deq_dep;
+	uint16_t crypto_batch_sz;
 	uint32_t nb_flows;
 	uint32_t tx_first;
 	uint32_t max_pkt_sz;
@@ -70,6 +74,7 @@ struct evt_options {
 	uint64_t max_tmo_nsec;
 	uint64_t timer_tick_nsec;
 	uint64_t optm_timer_tick_nsec;
+	uint64_t crypto_flush_nsec;
 	enum evt_prod_type prod_type;
 };
 
@@ -120,6 +125,15 @@ evt_service_setup(uint32_t service_id)
 			RTE_MAX_LCORE);
 	if (core_cnt < 0)
 		return -ENOENT;
+	/* A multi-thread safe service can run on all the service cores. */
+	if (rte_service_probe_capability(service_id,
+				RTE_SERVICE_CAP_MT_SAFE)) {
+		while (core_cnt--)
+			if (rte_service_map_lcore_set(service_id,
+					core_array[core_cnt], 1))
+				return -ENOENT;
+		return 0;
+	}
 	/* Get the core which has least number of services running. */
 	while (core_cnt--) {
 		/* Reset default mapping */
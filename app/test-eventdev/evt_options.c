@@ -10,6 +10,7 @@
 #include <rte_string_fns.h>
 #include <rte_common.h>
 #include <rte_eventdev.h>
+#include <rte_event_crypto_adapter.h>
 #include <rte_lcore.h>
 
 #include "evt_options.h"
@@ -33,6 +34,7 @@ evt_options_default(struct evt_options *opt)
 	opt->timer_tick_nsec = 1E3; /* 1000ns ~ 1us */
 	opt->max_tmo_nsec = 1E5;  /* 100000ns ~100us */
 	opt->expiry_nsec = 1E4;   /* 10000ns ~10us */
+	opt->crypto_batch_sz = 32;
 	opt->prod_type = EVT_PROD_TYPE_SYNT;
 }
 
@@ -118,6 +120,54 @@ evt_parse_timer_prod_type_burst(struct evt_options *opt,
 	return 0;
 }
 
+static int
+evt_parse_timdev_batched(struct evt_options *opt,
+		const char *arg __rte_unused)
+{
+	opt->timdev_batched = 1;
+	return 0;
+}
+
+static int
+evt_parse_crypto_prod_type(struct evt_options *opt,
+		const char *arg __rte_unused)
+{
+	opt->prod_type = EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR;
+	return 0;
+}
+
+static int
+evt_parse_crypto_adptr_mode(struct evt_options *opt, const char *arg)
+{
+	uint8_t mode;
+	int ret;
+
+	ret = parser_read_uint8(&mode, arg);
+	opt->crypto_adptr_mode = mode ? RTE_EVENT_CRYPTO_ADAPTER_OP_FORWARD :
+					RTE_EVENT_CRYPTO_ADAPTER_OP_NEW;
+	return ret;
+}
+
+static int
+evt_parse_crypto_batch_sz(struct evt_options *opt, const char *arg)
+{
+	int ret;
+
+	ret = parser_read_uint16(&(opt->crypto_batch_sz), arg);
+
+	return ret;
+}
+
+static int
+evt_parse_crypto_flush_nsec(struct evt_options *opt, const char *arg)
+{
+	int ret;
+
+	ret = parser_read_uint64(&(opt->crypto_flush_nsec), arg);
+
+	return ret;
+}
+
 static int
 evt_parse_test_name(struct evt_options *opt, const char *arg)
 {
@@ -278,6 +328,15 @@ usage(char *program)
 		"\t                     in ns.\n"
 		"\t--prod_type_timerdev_burst : use timer device as producer\n"
 		"\t                             burst mode.\n"
+		"\t--timdev_batched   : use the batched software timer\n"
+		"\t                     adapter.\n"
+		"\t--prod_type_cryptodev : use crypto device as producer.\n"
+		"\t--crypto_adptr_mode : 0 for OP_NEW mode (default) and\n"
+		"\t                     1 for OP_FORWARD mode.\n"
+		"\t--crypto_batch_sz  : crypto adapter enqueue batch size\n"
+		"\t                     per queue pair.\n"
+		"\t--crypto_flush_nsec : crypto adapter enqueue flush\n"
+		"\t                     timeout in ns.\n"
 		"\t--nb_timers        : number of timers to arm.\n"
 		"\t--nb_timer_adptrs  : number of timer adapters to use.\n"
 		"\t--timer_tick_nsec  : timer tick interval in ns.\n"
@@ -349,6 +408,11 @@ static struct option lgopts[] = {
 	{ EVT_PROD_ETHDEV,         0, 0, 0 },
 	{ EVT_PROD_TIMERDEV,       0, 0, 0 },
 	{ EVT_PROD_TIMERDEV_BURST, 0, 0, 0 },
+	{ EVT_TIMDEV_BATCHED,      0, 0, 0 },
+	{ EVT_PROD_CRYPTODEV,      0, 0, 0 },
+	{ EVT_CRYPTO_ADPTR_MODE,   1, 0, 0 },
+	{ EVT_CRYPTO_BATCH_SZ,     1, 0, 0 },
+	{ EVT_CRYPTO_FLUSH_NSEC,   1, 0, 0 },
 	{ EVT_NB_TIMERS,           1, 0, 0 },
 	{ EVT_NB_TIMER_ADPTRS,     1, 0, 0 },
 	{ EVT_TIMER_TICK_NSEC,     1, 0, 0 },
@@ -383,6 +447,11 @@ evt_opts_parse_long(int opt_idx, struct evt_options *opt)
 		{ EVT_PROD_ETHDEV, evt_parse_eth_prod_type},
 		{ EVT_PROD_TIMERDEV, evt_parse_timer_prod_type},
 		{ EVT_PROD_TIMERDEV_BURST, evt_parse_timer_prod_type_burst},
+		{ EVT_TIMDEV_BATCHED, evt_parse_timdev_batched},
+		{ EVT_PROD_CRYPTODEV, evt_parse_crypto_prod_type},
+		{ EVT_CRYPTO_ADPTR_MODE, evt_parse_crypto_adptr_mode},
+		{ EVT_CRYPTO_BATCH_SZ, evt_parse_crypto_batch_sz},
+		{ EVT_CRYPTO_FLUSH_NSEC, evt_parse_crypto_flush_nsec},
 		{ EVT_NB_TIMERS, evt_parse_nb_timers},
 		{ EVT_NB_TIMER_ADPTRS, evt_parse_nb_timer_adptrs},
 		{ EVT_TIMER_TICK_NSEC, evt_parse_timer_tick_nsec},
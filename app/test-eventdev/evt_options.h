@@ -9,6 +9,7 @@
 #include <stdbool.h>
 
 #include <rte_common.h>
+#include <rte_cryptodev.h>
 #include <rte_ethdev.h>
 #include <rte_eventdev.h>
 #include <rte_lcore.h>
@@ -35,6 +36,11 @@
 #define EVT_PROD_ETHDEV          ("prod_type_ethdev")
 #define EVT_PROD_TIMERDEV        ("prod_type_timerdev")
 #define EVT_PROD_TIMERDEV_BURST  ("prod_type_timerdev_burst")
+#define EVT_TIMDEV_BATCHED       ("timdev_batched")
+#define EVT_PROD_CRYPTODEV       ("prod_type_cryptodev")
+#define EVT_CRYPTO_ADPTR_MODE    ("crypto_adptr_mode")
+#define EVT_CRYPTO_BATCH_SZ      ("crypto_batch_sz")
+#define EVT_CRYPTO_FLUSH_NSEC    ("crypto_flush_nsec")
 #define EVT_NB_TIMERS            ("nb_timers")
 #define EVT_NB_TIMER_ADPTRS      ("nb_timer_adptrs")
 #define EVT_TIMER_TICK_NSEC      ("timer_tick_nsec")
@@ -257,6 +263,8 @@ evt_dump_producer_type(struct evt_options *opt)
 			snprintf(name, EVT_PROD_MAX_NAME_LEN,
 				"Event timer adapter producer");
 		evt_dump("nb_timer_adapters", "%d", opt->nb_timer_adptrs);
+		evt_dump("timdev_batched", "%s",
+				EVT_BOOL_FMT(opt->timdev_batched));
 		evt_dump("max_tmo_nsec", "%"PRIu64"", opt->max_tmo_nsec);
 		evt_dump("expiry_nsec", "%"PRIu64"", opt->expiry_nsec);
 		if (opt->optm_timer_tick_nsec)
@@ -266,6 +274,20 @@ evt_dump_producer_type(struct evt_options *opt)
 			evt_dump("timer_tick_nsec", "%"PRIu64"",
 					opt->timer_tick_nsec);
 		break;
+	case EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR:
+		snprintf(name, EVT_PROD_MAX_NAME_LEN,
+				"Event crypto adapter producers");
+		evt_dump("crypto adapter mode", "%s",
+				opt->crypto_adptr_mode ? "OP_FORWARD" :
+				"OP_NEW");
+		evt_dump("nb_cryptodev", "%u", rte_cryptodev_count());
+		if (opt->crypto_adptr_mode) {
+			evt_dump("crypto_batch_sz", "%u",
+					opt->crypto_batch_sz);
+			evt_dump("crypto_flush_nsec", "%"PRIu64"",
+					opt->crypto_flush_nsec);
+		}
+		break;
 	}
 	evt_dump("prod_type", "%s", name);
 }
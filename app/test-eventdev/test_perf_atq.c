@@ -48,7 +48,13 @@ perf_atq_worker(void *arg, const int enable_fwd_latency)
 			continue;
 		}
 
-		if (enable_fwd_latency && !prod_timer_type)
+		if (prod_crypto_type &&
+		    (ev.event_type == RTE_EVENT_TYPE_CRYPTODEV) &&
+		    perf_handle_crypto_ev(pool, &ev))
+			continue;
+
+		if (enable_fwd_latency && !prod_timer_type &&
+		    !prod_crypto_type)
 		/* first stage in pipeline, mark ts to compute fwd latency */
 			atq_mark_fwd_latency(&ev);
 
@@ -87,7 +93,14 @@ perf_atq_worker_burst(void *arg, const int enable_fwd_latency)
 		}
 
 		for (i = 0; i < nb_rx; i++) {
-			if (enable_fwd_latency && !prod_timer_type) {
+			if (prod_crypto_type &&
+			    (ev[i].event_type == RTE_EVENT_TYPE_CRYPTODEV) &&
+			    perf_handle_crypto_ev(pool, &ev[i])) {
+				ev[i].op = RTE_EVENT_OP_RELEASE;
+				continue;
+			}
+			if (enable_fwd_latency && !prod_timer_type &&
+			    !prod_crypto_type) {
 				rte_prefetch0(ev[i+1].event_ptr);
 				/* first stage in pipeline.
 				 * mark time stamp to compute fwd latency
@@ -175,7 +188,9 @@ perf_atq_eventdev_setup(struct evt_test *test, struct evt_options *opt)
 		return ret;
 	}
 
-	ret = evt_configure_eventdev(opt, nb_queues, nb_ports);
+	/* An extra queue feeds the crypto adapter in OP_FORWARD mode */
+	ret = evt_configure_eventdev(opt, perf_crypto_fwd_mode(opt) ?
+			nb_queues + 1 : nb_queues, nb_ports);
 	if (ret) {
 		evt_err("failed to configure eventdev %d", opt->dev_id);
 		return ret;
@@ -254,6 +269,12 @@ perf_atq_eventdev_setup(struct evt_test *test, struct evt_options *opt)
 				return ret;
 			}
 		}
+	} else if (opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR) {
+		ret = rte_event_crypto_adapter_start(TEST_PERF_CA_ID);
+		if (ret) {
+			evt_err("failed to start crypto adapter");
+			return ret;
+		}
 	}
 
 	return 0;
@@ -85,6 +85,7 @@ perf_event_timer_producer(void *arg)
 	uint32_t flow_counter = 0;
 	uint64_t count = 0;
 	uint64_t arm_latency = 0;
+	uint64_t arm_cycles;
 	const uint8_t nb_timer_adptrs = opt->nb_timer_adptrs;
 	const uint32_t nb_flows = t->nb_flows;
 	const uint64_t nb_timers = opt->nb_timers;
@@ -110,6 +111,7 @@ perf_event_timer_producer(void *arg)
 	if (opt->verbose_level > 1)
 		printf("%s(): lcore %d\n", __func__, rte_lcore_id());
 
+	arm_cycles = rte_get_timer_cycles();
 	while (count < nb_timers && t->done == false) {
 		if (rte_mempool_get_bulk(pool, (void **)m, BURST_SIZE) < 0)
 			continue;
@@ -130,12 +132,17 @@ perf_event_timer_producer(void *arg)
 		}
 		count += BURST_SIZE;
 	}
+	arm_cycles = rte_get_timer_cycles() - arm_cycles;
 	fflush(stdout);
 	rte_delay_ms(1000);
 	printf("%s(): lcore %d Average event timer arm latency = %.3f us\n",
 			__func__, rte_lcore_id(),
 			count ? (float)(arm_latency / count) /
 			(rte_get_timer_hz() / 1000000) : 0);
+	printf("%s(): lcore %d Event timer arm rate = %.3f Mtimers/s\n",
+			__func__, rte_lcore_id(),
+			arm_cycles ? (float)count * rte_get_timer_hz() /
+			arm_cycles / 1E6 : 0);
 	return 0;
 }
 
@@ -149,6 +156,7 @@ perf_event_timer_producer_burst(void *arg)
 	uint32_t flow_counter = 0;
 	uint64_t count = 0;
 	uint64_t arm_latency = 0;
+	uint64_t arm_cycles;
 	const uint8_t nb_timer_adptrs = opt->nb_timer_adptrs;
 	const uint32_t nb_flows = t->nb_flows;
 	const uint64_t nb_timers = opt->nb_timers;
@@ -174,6 +182,7 @@ perf_event_timer_producer_burst(void *arg)
 	if (opt->verbose_level > 1)
 		printf("%s(): lcore %d\n", __func__, rte_lcore_id());
 
+	arm_cycles = rte_get_timer_cycles();
 	while (count < nb_timers && t->done == false) {
 		if (rte_mempool_get_bulk(pool, (void **)m, BURST_SIZE) < 0)
 			continue;
@@ -192,12 +201,86 @@ perf_event_timer_producer_burst(void *arg)
 		arm_latency += rte_get_timer_cycles() - m[i - 1]->timestamp;
 		count += BURST_SIZE;
 	}
+	arm_cycles = rte_get_timer_cycles() - arm_cycles;
 	fflush(stdout);
 	rte_delay_ms(1000);
 	printf("%s(): lcore %d Average event timer arm latency = %.3f us\n",
 			__func__, rte_lcore_id(),
 			count ? (float)(arm_latency / count) /
 			(rte_get_timer_hz() / 1000000) : 0);
+	printf("%s(): lcore %d Event timer arm rate = %.3f Mtimers/s\n",
+			__func__, rte_lcore_id(),
+			arm_cycles ? (float)count * rte_get_timer_hz() /
+			arm_cycles / 1E6 : 0);
+	return 0;
+}
+
+static inline int
+perf_event_crypto_producer(void *arg)
+{
+	uint16_t i;
+	struct prod_data *p  = arg;
+	struct test_perf *t = p->t;
+	struct evt_options *opt = t->opt;
+	const uint8_t dev_id = p->dev_id;
+	const uint8_t port = p->port_id;
+	const uint8_t cdev_id = p->ca.cdev_id;
+	const uint16_t qp_id = p->ca.cdev_qp_id;
+	const uint64_t nb_pkts = t->nb_pkts;
+	const bool fwd_mode = perf_crypto_fwd_mode(opt);
+	struct rte_mempool *pool = t->pool;
+	struct rte_crypto_op *ops[BURST_SIZE];
+	struct perf_elt *m[BURST_SIZE];
+	struct rte_event ev[BURST_SIZE];
+	uint16_t nb_enq;
+	uint64_t count = 0;
+
+	if (opt->verbose_level > 1)
+		printf("%s(): lcore %d cdev_id %d qp_id %d\n", __func__,
+				rte_lcore_id(), cdev_id, qp_id);
+
+	/* In OP_FORWARD mode the requests are events to the adapter port */
+	memset(ev, 0, sizeof(ev));
+	for (i = 0; i < BURST_SIZE; i++) {
+		ev[i].op = RTE_EVENT_OP_NEW;
+		ev[i].queue_id = t->ca_queue_id;
+		ev[i].sched_type = RTE_SCHED_TYPE_ATOMIC;
+		ev[i].priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+		ev[i].event_type = RTE_EVENT_TYPE_CPU;
+	}
+
+	while (count < nb_pkts && t->done == false) {
+		if (rte_mempool_get_bulk(pool, (void **)m, BURST_SIZE) < 0)
+			continue;
+		if (rte_crypto_op_bulk_alloc(t->ca_op_pool,
+				RTE_CRYPTO_OP_TYPE_SYMMETRIC,
+				ops, BURST_SIZE) == 0) {
+			rte_mempool_put_bulk(pool, (void **)m, BURST_SIZE);
+			continue;
+		}
+		for (i = 0; i < BURST_SIZE; i++) {
+			rte_crypto_op_attach_sym_session(ops[i], p->ca.sess);
+			*rte_crypto_op_ctod_offset(ops[i], struct perf_elt **,
+					PERF_CA_ELT_OFFSET) = m[i];
+			m[i]->timestamp = rte_get_timer_cycles();
+			ev[i].event_ptr = ops[i];
+		}
+
+		nb_enq = 0;
+		while (nb_enq < BURST_SIZE && t->done == false) {
+			if (fwd_mode)
+				nb_enq += rte_event_enqueue_burst(dev_id, port,
+						ev + nb_enq, BURST_SIZE - nb_enq);
+			else
+				nb_enq += rte_cryptodev_enqueue_burst(cdev_id,
+						qp_id, ops + nb_enq,
+						BURST_SIZE - nb_enq);
+			if (nb_enq < BURST_SIZE)
+				rte_pause();
+		}
+		count += BURST_SIZE;
+	}
+
 	return 0;
 }
 
@@ -215,6 +298,8 @@ perf_producer_wrapper(void *arg)
 	else if (t->opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR &&
 			t->opt->timdev_use_burst)
 		return perf_event_timer_producer_burst(arg);
+	else if (t->opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR)
+		return perf_event_crypto_producer(arg);
 	return 0;
 }
 
@@ -325,7 +410,9 @@ perf_launch_lcores(struct evt_test *test, struct evt_options *opt,
 				t->result = EVT_TEST_SUCCESS;
 				if (opt->prod_type == EVT_PROD_TYPE_SYNT ||
 					opt->prod_type ==
-					EVT_PROD_TYPE_EVENT_TIMER_ADPTR) {
+					EVT_PROD_TYPE_EVENT_TIMER_ADPTR ||
+					opt->prod_type ==
+					EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR) {
 					t->done = true;
 					rte_smp_wmb();
 					break;
@@ -335,7 +422,8 @@ perf_launch_lcores(struct evt_test *test, struct evt_options *opt,
 
 		if (new_cycles - dead_lock_cycles > dead_lock_sample &&
 		    (opt->prod_type == EVT_PROD_TYPE_SYNT ||
-		     opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR)) {
+		     opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR ||
+		     opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR)) {
 			remaining = t->outstand_pkts - processed_pkts(t);
 			if (dead_lock_remaining == remaining) {
 				rte_event_dev_dump(opt->dev_id, stdout);
@@ -417,6 +505,8 @@ perf_event_timer_adapter_setup(struct test_perf *t)
 
 	if (nb_producers == 1)
 		flags |= RTE_EVENT_TIMER_ADAPTER_F_SP_PUT;
+	if (t->opt->timdev_batched)
+		flags |= RTE_EVENT_TIMER_ADAPTER_F_BATCHED;
 
 	for (i = 0; i < t->opt->nb_timer_adptrs; i++) {
 		struct rte_event_timer_adapter_conf config = {
@@ -458,15 +548,177 @@ perf_event_timer_adapter_setup(struct test_perf *t)
 	return 0;
 }
 
+static int
+perf_event_crypto_adapter_setup(struct test_perf *t, uint8_t nb_queues,
+		struct rte_event_port_conf port_conf)
+{
+	struct evt_options *opt = t->opt;
+	struct rte_crypto_sym_xform xform = {
+		.type = RTE_CRYPTO_SYM_XFORM_CIPHER,
+		.next = NULL,
+		.cipher = {
+			.algo = RTE_CRYPTO_CIPHER_NULL,
+			.op = RTE_CRYPTO_CIPHER_OP_ENCRYPT,
+		},
+	};
+	struct rte_event_crypto_adapter_queue_pair_batch_conf batch_conf = {
+		.batch_size = opt->crypto_batch_sz,
+		.flush_timeout_ns = opt->crypto_flush_nsec,
+	};
+	const uint8_t cdev_count = rte_cryptodev_count();
+	uint32_t service_id;
+	uint16_t port, prod;
+	uint32_t cap;
+	int ret;
+
+	ret = rte_event_crypto_adapter_create(TEST_PERF_CA_ID, opt->dev_id,
+			&port_conf, opt->crypto_adptr_mode);
+	if (ret) {
+		evt_err("failed to create crypto adapter");
+		return ret;
+	}
+
+	prod = 0;
+	for (port = t->nb_workers; port < perf_nb_event_ports(opt); port++) {
+		struct prod_data *p = &t->prod[port];
+		union rte_event_crypto_metadata m_data;
+		struct rte_cryptodev_sym_session *sess;
+
+		/* Spread the producers over the cryptodev queue pairs */
+		p->ca.cdev_id = prod % cdev_count;
+		p->ca.cdev_qp_id = prod / cdev_count;
+
+		ret = rte_event_crypto_adapter_caps_get(opt->dev_id,
+				p->ca.cdev_id, &cap);
+		if (ret) {
+			evt_err("failed to get crypto adapter capabilities");
+			return ret;
+		}
+
+		memset(&m_data, 0, sizeof(m_data));
+		m_data.request_info.cdev_id = p->ca.cdev_id;
+		m_data.request_info.queue_pair_id = p->ca.cdev_qp_id;
+		m_data.response_info.queue_id = p->queue_id;
+		m_data.response_info.sched_type = opt->sched_type_list[0];
+		m_data.response_info.priority = RTE_EVENT_DEV_PRIORITY_NORMAL;
+		m_data.response_info.flow_id = prod;
+
+		if (cap & RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_QP_EV_BIND)
+			ret = rte_event_crypto_adapter_queue_pair_add(
+					TEST_PERF_CA_ID, p->ca.cdev_id,
+					p->ca.cdev_qp_id,
+					&m_data.response_info);
+		else
+			ret = rte_event_crypto_adapter_queue_pair_add(
+					TEST_PERF_CA_ID, p->ca.cdev_id,
+					p->ca.cdev_qp_id, NULL);
+		if (ret) {
+			evt_err("failed to add queue pair %u of cryptodev %u",
+					p->ca.cdev_qp_id, p->ca.cdev_id);
+			return ret;
+		}
+
+		if (opt->crypto_adptr_mode ==
+				RTE_EVENT_CRYPTO_ADAPTER_OP_FORWARD &&
+		    !(cap & RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_FWD)) {
+			ret = rte_event_crypto_adapter_queue_pair_batch_config(
+					TEST_PERF_CA_ID, p->ca.cdev_id,
+					p->ca.cdev_qp_id, &batch_conf);
+			if (ret) {
+				evt_err("failed to configure crypto adapter batch");
+				return ret;
+			}
+		}
+
+		sess = rte_cryptodev_sym_session_create(t->ca_sess_pool);
+		if (sess == NULL) {
+			evt_err("failed to create crypto session");
+			return -ENOMEM;
+		}
+		p->ca.sess = sess;
+
+		ret = rte_cryptodev_sym_session_init(p->ca.cdev_id, sess,
+				&xform, t->ca_sess_priv_pool);
+		if (ret) {
+			evt_err("failed to init crypto session");
+			return ret;
+		}
+
+		ret = rte_cryptodev_sym_session_set_user_data(sess, &m_data,
+				sizeof(m_data));
+		if (ret) {
+			evt_err("failed to set crypto session metadata");
+			return ret;
+		}
+		prod++;
+	}
+
+	if (perf_crypto_fwd_mode(opt)) {
+		struct rte_event_queue_conf q_conf = {
+			.priority = RTE_EVENT_DEV_PRIORITY_HIGHEST,
+			.schedule_type = RTE_SCHED_TYPE_ATOMIC,
+			.event_queue_cfg = RTE_EVENT_QUEUE_CFG_SINGLE_LINK,
+			.nb_atomic_flows = opt->nb_flows,
+			.nb_atomic_order_sequences = opt->nb_flows,
+		};
+		uint8_t ca_port;
+
+		/* The event queue after the worker ones feeds the adapter */
+		t->ca_queue_id = nb_queues;
+		ret = rte_event_queue_setup(opt->dev_id, t->ca_queue_id,
+				&q_conf);
+		if (ret) {
+			evt_err("failed to setup queue=%d", t->ca_queue_id);
+			return ret;
+		}
+
+		ret = rte_event_crypto_adapter_event_port_get(TEST_PERF_CA_ID,
+				&ca_port);
+		if (ret) {
+			evt_err("failed to get crypto adapter port");
+			return ret;
+		}
+
+		ret = rte_event_port_link(opt->dev_id, ca_port,
+				&t->ca_queue_id, NULL, 1);
+		if (ret != 1) {
+			evt_err("failed to link queue %d to crypto adapter port",
+					t->ca_queue_id);
+			return -EINVAL;
+		}
+	}
+
+	if (rte_event_crypto_adapter_service_id_get(TEST_PERF_CA_ID,
+			&service_id) == 0) {
+		ret = evt_service_setup(service_id);
+		if (ret) {
+			evt_err("Failed to setup service core"
+					" for crypto adapter\n");
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 int
 perf_event_dev_port_setup(struct evt_test *test, struct evt_options *opt,
 				uint8_t stride, uint8_t nb_queues,
 				const struct rte_event_port_conf *port_conf)
 {
 	struct test_perf *t = evt_test_priv(test);
+	uint8_t queues[EVT_MAX_QUEUES];
+	uint8_t *link_queues = NULL;
 	uint16_t port, prod;
 	int ret = -1;
 
+	/* Keep the crypto adapter queue away from the workers */
+	if (perf_crypto_fwd_mode(opt)) {
+		for (prod = 0; prod < nb_queues; prod++)
+			queues[prod] = prod;
+		link_queues = queues;
+	}
+
 	/* setup one port per worker, linking to all queues */
 	for (port = 0; port < evt_nr_active_lcores(opt->wlcores);
 				port++) {
@@ -484,7 +736,8 @@ perf_event_dev_port_setup(struct evt_test *test, struct evt_options *opt,
 			return ret;
 		}
 
-		ret = rte_event_port_link(opt->dev_id, port, NULL, NULL, 0);
+		ret = rte_event_port_link(opt->dev_id, port, link_queues,
+				NULL, nb_queues);
 		if (ret != nb_queues) {
 			evt_err("failed to link all queues to port %d", port);
 			return -EINVAL;
@@ -531,6 +784,13 @@ perf_event_dev_port_setup(struct evt_test *test, struct evt_options *opt,
 			}
 			prod++;
 		}
+
+		if (opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR) {
+			ret = perf_event_crypto_adapter_setup(t, nb_queues,
+					*port_conf);
+			if (ret)
+				return ret;
+		}
 	}
 
 	return ret;
@@ -570,7 +830,8 @@ perf_opt_check(struct evt_options *opt, uint64_t nb_queues)
 	}
 
 	if (opt->prod_type == EVT_PROD_TYPE_SYNT ||
-			opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR) {
+			opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR ||
+			opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR) {
 		/* Validate producer lcores */
 		if (evt_lcores_has_overlap(opt->plcores,
 					rte_get_master_lcore())) {
@@ -604,7 +865,8 @@ perf_opt_check(struct evt_options *opt, uint64_t nb_queues)
 
 	/* Fixups */
 	if ((opt->nb_stages == 1 &&
-			opt->prod_type != EVT_PROD_TYPE_EVENT_TIMER_ADPTR) &&
+			opt->prod_type != EVT_PROD_TYPE_EVENT_TIMER_ADPTR &&
+			opt->prod_type != EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR) &&
 			opt->fwd_latency) {
 		evt_info("fwd_latency is valid when nb_stages > 1, disabling");
 		opt->fwd_latency = 0;
@@ -617,6 +879,14 @@ perf_opt_check(struct evt_options *opt, uint64_t nb_queues)
 	if (opt->nb_pkts == 0)
 		opt->nb_pkts = INT64_MAX/evt_nr_active_lcores(opt->plcores);
 
+	if (opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR &&
+	    (opt->crypto_batch_sz == 0 || opt->crypto_batch_sz >
+	     RTE_EVENT_CRYPTO_ADAPTER_MAX_BATCH_SIZE)) {
+		evt_err("crypto_batch_sz must be in 1..%d",
+			RTE_EVENT_CRYPTO_ADAPTER_MAX_BATCH_SIZE);
+		return -1;
+	}
+
 	return 0;
 }
 
@@ -645,6 +915,8 @@ perf_eventdev_destroy(struct evt_test *test, struct evt_options *opt)
 		for (i = 0; i < opt->nb_timer_adptrs; i++)
 			rte_event_timer_adapter_stop(t->timer_adptr[i]);
 	}
+	if (opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR)
+		rte_event_crypto_adapter_stop(TEST_PERF_CA_ID);
 	rte_event_dev_stop(opt->dev_id);
 	rte_event_dev_close(opt->dev_id);
 }
@@ -679,7 +951,8 @@ perf_ethdev_setup(struct evt_test *test, struct evt_options *opt)
 	};
 
 	if (opt->prod_type == EVT_PROD_TYPE_SYNT ||
-			opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR)
+			opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR ||
+			opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR)
 		return 0;
 
 	if (!rte_eth_dev_count_avail()) {
@@ -752,13 +1025,167 @@ void perf_ethdev_destroy(struct evt_test *test, struct evt_options *opt)
 	}
 }
 
+#define NB_CRYPTODEV_DESCRIPTORS	1024
+int
+perf_cryptodev_setup(struct evt_test *test, struct evt_options *opt)
+{
+	struct test_perf *t = evt_test_priv(test);
+	unsigned int max_session_size;
+	uint8_t cdev_count, cdev_id;
+	uint32_t nb_plcores;
+	uint16_t nb_qps;
+	int ret;
+
+	if (opt->prod_type != EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR)
+		return 0;
+
+	cdev_count = rte_cryptodev_count();
+	if (cdev_count == 0) {
+		evt_err("No crypto devices available\n");
+		return -ENODEV;
+	}
+
+	/* The private area of an op points to the perf_elt of the request */
+	t->ca_op_pool = rte_crypto_op_pool_create(
+			"perf_ca_op_pool", RTE_CRYPTO_OP_TYPE_SYMMETRIC,
+			opt->pool_sz, 128, sizeof(struct perf_elt *),
+			rte_socket_id());
+	if (t->ca_op_pool == NULL) {
+		evt_err("Failed to create crypto op pool");
+		return -ENOMEM;
+	}
+
+	/* One session per producer, carrying the adapter metadata */
+	nb_plcores = evt_nr_active_lcores(opt->plcores);
+	t->ca_sess_pool = rte_cryptodev_sym_session_pool_create(
+			"perf_ca_sess_pool", nb_plcores, 0, 0,
+			sizeof(union rte_event_crypto_metadata), SOCKET_ID_ANY);
+	if (t->ca_sess_pool == NULL) {
+		evt_err("Failed to create sym session pool");
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	max_session_size = 0;
+	for (cdev_id = 0; cdev_id < cdev_count; cdev_id++) {
+		unsigned int session_size;
+
+		session_size =
+			rte_cryptodev_sym_get_private_session_size(cdev_id);
+		if (session_size > max_session_size)
+			max_session_size = session_size;
+	}
+
+	t->ca_sess_priv_pool = rte_mempool_create("perf_ca_sess_priv_pool",
+			nb_plcores, max_session_size, 0, 0, NULL, NULL, NULL,
+			NULL, SOCKET_ID_ANY, 0);
+	if (t->ca_sess_priv_pool == NULL) {
+		evt_err("failed to create sym session private pool");
+		ret = -ENOMEM;
+		goto err;
+	}
+
+	/* One queue pair per producer, spread over the cryptodevs */
+	nb_qps = (nb_plcores + cdev_count - 1) / cdev_count;
+	for (cdev_id = 0; cdev_id < cdev_count; cdev_id++) {
+		struct rte_cryptodev_qp_conf qp_conf;
+		struct rte_cryptodev_config conf;
+		struct rte_cryptodev_info info;
+		uint16_t qp_id;
+
+		rte_cryptodev_info_get(cdev_id, &info);
+		if (nb_qps > info.max_nb_queue_pairs) {
+			evt_err("Not enough queue pairs per cryptodev (%u)",
+					nb_qps);
+			ret = -EINVAL;
+			goto err;
+		}
+
+		conf.nb_queue_pairs = nb_qps;
+		conf.socket_id = SOCKET_ID_ANY;
+		conf.ff_disable = RTE_CRYPTODEV_FF_SECURITY;
+
+		ret = rte_cryptodev_configure(cdev_id, &conf);
+		if (ret) {
+			evt_err("Failed to configure cryptodev (%u)", cdev_id);
+			goto err;
+		}
+
+		qp_conf.nb_descriptors = NB_CRYPTODEV_DESCRIPTORS;
+		qp_conf.mp_session = t->ca_sess_pool;
+		qp_conf.mp_session_private = t->ca_sess_priv_pool;
+
+		for (qp_id = 0; qp_id < conf.nb_queue_pairs; qp_id++) {
+			ret = rte_cryptodev_queue_pair_setup(cdev_id, qp_id,
+					&qp_conf,
+					rte_cryptodev_socket_id(cdev_id));
+			if (ret) {
+				evt_err("Failed to setup queue pair %u of cryptodev %u",
+						qp_id, cdev_id);
+				goto err;
+			}
+		}
+
+		ret = rte_cryptodev_start(cdev_id);
+		if (ret) {
+			evt_err("Failed to start cryptodev (%u)", cdev_id);
+			goto err;
+		}
+	}
+
+	return 0;
+err:
+	for (cdev_id = 0; cdev_id < cdev_count; cdev_id++)
+		rte_cryptodev_stop(cdev_id);
+
+	rte_mempool_free(t->ca_op_pool);
+	rte_mempool_free(t->ca_sess_pool);
+	rte_mempool_free(t->ca_sess_priv_pool);
+
+	return ret;
+}
+
+void
+perf_cryptodev_destroy(struct evt_test *test, struct evt_options *opt)
+{
+	uint8_t cdev_id, cdev_count = rte_cryptodev_count();
+	struct test_perf *t = evt_test_priv(test);
+	uint16_t port;
+
+	if (opt->prod_type != EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR)
+		return;
+
+	for (port = t->nb_workers; port < perf_nb_event_ports(opt); port++) {
+		struct prod_data *p = &t->prod[port];
+
+		if (p->ca.sess == NULL)
+			continue;
+
+		rte_event_crypto_adapter_queue_pair_del(TEST_PERF_CA_ID,
+				p->ca.cdev_id, p->ca.cdev_qp_id);
+		rte_cryptodev_sym_session_clear(p->ca.cdev_id, p->ca.sess);
+		rte_cryptodev_sym_session_free(p->ca.sess);
+		p->ca.sess = NULL;
+	}
+
+	rte_event_crypto_adapter_free(TEST_PERF_CA_ID);
+
+	for (cdev_id = 0; cdev_id < cdev_count; cdev_id++)
+		rte_cryptodev_stop(cdev_id);
+
+	rte_mempool_free(t->ca_op_pool);
+	rte_mempool_free(t->ca_sess_pool);
+	rte_mempool_free(t->ca_sess_priv_pool);
+}
+
 int
 perf_mempool_setup(struct evt_test *test, struct evt_options *opt)
 {
 	struct test_perf *t = evt_test_priv(test);
 
 	if (opt->prod_type == EVT_PROD_TYPE_SYNT ||
-			opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR) {
+			opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR ||
+			opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR) {
 		t->pool = rte_mempool_create(test->name, /* mempool name */
 				opt->pool_sz, /* number of elements*/
 				sizeof(struct perf_elt), /* element size*/
@@ -9,9 +9,11 @@
 #include <stdbool.h>
 #include <unistd.h>
 
+#include <rte_cryptodev.h>
 #include <rte_cycles.h>
 #include <rte_ethdev.h>
 #include <rte_eventdev.h>
+#include <rte_event_crypto_adapter.h>
 #include <rte_event_eth_rx_adapter.h>
 #include <rte_event_timer_adapter.h>
 #include <rte_lcore.h>
@@ -33,10 +35,17 @@ struct worker_data {
 	struct test_perf *t;
 } __rte_cache_aligned;
 
+struct crypto_adptr_data {
+	uint8_t cdev_id;
+	uint16_t cdev_qp_id;
+	struct rte_cryptodev_sym_session *sess;
+};
+
 struct prod_data {
 	uint8_t dev_id;
 	uint8_t port_id;
 	uint8_t queue_id;
+	struct crypto_adptr_data ca;
 	struct test_perf *t;
 } __rte_cache_aligned;
 
@@ -58,6 +67,10 @@ struct test_perf {
 	uint8_t sched_type_list[EVT_MAX_STAGES] __rte_cache_aligned;
 	struct rte_event_timer_adapter *timer_adptr[
 		RTE_EVENT_TIMER_ADAPTER_NUM_MAX] __rte_cache_aligned;
+	uint8_t ca_queue_id;
+	struct rte_mempool *ca_op_pool;
+	struct rte_mempool *ca_sess_pool;
+	struct rte_mempool *ca_sess_priv_pool;
 } __rte_cache_aligned;
 
 struct perf_elt {
@@ -72,6 +85,11 @@ struct perf_elt {
 
 #define BURST_SIZE 16
 
+#define TEST_PERF_CA_ID 0
+/* A crypto op carries the perf_elt of the request in its private area */
+#define PERF_CA_ELT_OFFSET \
+	(sizeof(struct rte_crypto_op) + sizeof(struct rte_crypto_sym_op))
+
 #define PERF_WORKER_INIT\
 	struct worker_data *w  = arg;\
 	struct test_perf *t = w->t;\
@@ -80,6 +98,8 @@ struct perf_elt {
 	const uint8_t port = w->port_id;\
 	const uint8_t prod_timer_type = \
 		opt->prod_type == EVT_PROD_TYPE_EVENT_TIMER_ADPTR;\
+	const uint8_t prod_crypto_type = \
+		opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR;\
 	uint8_t *const sched_type_list = &t->sched_type_list[0];\
 	struct rte_mempool *const pool = t->pool;\
 	const uint8_t nb_stages = t->opt->nb_stages;\
@@ -91,6 +111,27 @@ struct perf_elt {
 		printf("%s(): lcore %d dev_id %d port=%d\n", __func__,\
 				rte_lcore_id(), dev, port)
 
+/* Replace a crypto completion event by the perf_elt of its request */
+static inline __attribute__((always_inline)) int
+perf_handle_crypto_ev(struct rte_mempool *const pool, struct rte_event *ev)
+{
+	struct rte_crypto_op *op = ev->event_ptr;
+	struct perf_elt *m;
+
+	m = *rte_crypto_op_ctod_offset(op, struct perf_elt **,
+			PERF_CA_ELT_OFFSET);
+	if (unlikely(op->status != RTE_CRYPTO_OP_STATUS_SUCCESS)) {
+		rte_crypto_op_free(op);
+		rte_mempool_put(pool, m);
+		return -1;
+	}
+	rte_crypto_op_free(op);
+
+	ev->event_ptr = m;
+	ev->event_type = RTE_EVENT_TYPE_CPU;
+	return 0;
+}
+
 static inline __attribute__((always_inline)) int
 perf_process_last_stage(struct rte_mempool *const pool,
 		struct rte_event *const ev, struct worker_data *const w,
@@ -139,10 +180,21 @@ perf_nb_event_ports(struct evt_options *opt)
 			evt_nr_active_lcores(opt->plcores);
 }
 
+/* In OP_FORWARD mode the crypto requests go through an extra event queue
+ * linked to the crypto adapter event port only.
+ */
+static inline bool
+perf_crypto_fwd_mode(struct evt_options *opt)
+{
+	return opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR &&
+		opt->crypto_adptr_mode == RTE_EVENT_CRYPTO_ADAPTER_OP_FORWARD;
+}
+
 int perf_test_result(struct evt_test *test, struct evt_options *opt);
 int perf_opt_check(struct evt_options *opt, uint64_t nb_queues);
 int perf_test_setup(struct evt_test *test, struct evt_options *opt);
 int perf_ethdev_setup(struct evt_test *test, struct evt_options *opt);
+int perf_cryptodev_setup(struct evt_test *test, struct evt_options *opt);
 int perf_mempool_setup(struct evt_test *test, struct evt_options *opt);
 int perf_event_dev_port_setup(struct evt_test *test, struct evt_options *opt,
 				uint8_t stride, uint8_t nb_queues,
@@ -154,6 +206,7 @@ void perf_opt_dump(struct evt_options *opt, uint8_t nb_queues);
 void perf_test_destroy(struct evt_test *test, struct evt_options *opt);
 void perf_eventdev_destroy(struct evt_test *test, struct evt_options *opt);
 void perf_ethdev_destroy(struct evt_test *test, struct evt_options *opt);
+void perf_cryptodev_destroy(struct evt_test *test, struct evt_options *opt);
 void perf_mempool_destroy(struct evt_test *test, struct evt_options *opt);
 
 #endif /* _TEST_PERF_COMMON_ */
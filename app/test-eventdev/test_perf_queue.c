@@ -49,7 +49,14 @@ perf_queue_worker(void *arg, const int enable_fwd_latency)
 			rte_pause();
 			continue;
 		}
-		if (enable_fwd_latency && !prod_timer_type)
+
+		if (prod_crypto_type &&
+		    (ev.event_type == RTE_EVENT_TYPE_CRYPTODEV) &&
+		    perf_handle_crypto_ev(pool, &ev))
+			continue;
+
+		if (enable_fwd_latency && !prod_timer_type &&
+		    !prod_crypto_type)
 		/* first q in pipeline, mark timestamp to compute fwd latency */
 			mark_fwd_latency(&ev, nb_stages);
 
@@ -88,7 +95,14 @@ perf_queue_worker_burst(void *arg, const int enable_fwd_latency)
 		}
 
 		for (i = 0; i < nb_rx; i++) {
-			if (enable_fwd_latency && !prod_timer_type) {
+			if (prod_crypto_type &&
+			    (ev[i].event_type == RTE_EVENT_TYPE_CRYPTODEV) &&
+			    perf_handle_crypto_ev(pool, &ev[i])) {
+				ev[i].op = RTE_EVENT_OP_RELEASE;
+				continue;
+			}
+			if (enable_fwd_latency && !prod_timer_type &&
+			    !prod_crypto_type) {
 				rte_prefetch0(ev[i+1].event_ptr);
 				/* first queue in pipeline.
 				 * mark time stamp to compute fwd latency
@@ -176,7 +190,9 @@ perf_queue_eventdev_setup(struct evt_test *test, struct evt_options *opt)
 		return ret;
 	}
 
-	ret = evt_configure_eventdev(opt, nb_queues, nb_ports);
+	/* An extra queue feeds the crypto adapter in OP_FORWARD mode */
+	ret = evt_configure_eventdev(opt, perf_crypto_fwd_mode(opt) ?
+			nb_queues + 1 : nb_queues, nb_ports);
 	if (ret) {
 		evt_err("failed to configure eventdev %d", opt->dev_id);
 		return ret;
@@ -192,7 +208,7 @@ perf_queue_eventdev_setup(struct evt_test *test, struct evt_options *opt)
 		q_conf.schedule_type =
 			(opt->sched_type_list[queue % nb_stages]);
 
-		if (opt->q_priority) {
+		if (opt->q_priority && nb_stages > 1) {
 			uint8_t stage_pos = queue % nb_stages;
 			/* Configure event queues(stage 0 to stage n) with
 			 * RTE_EVENT_DEV_PRIORITY_LOWEST to
@@ -269,6 +285,12 @@ perf_queue_eventdev_setup(struct evt_test *test, struct evt_options *opt)
 				return ret;
 			}
 		}
+	} else if (opt->prod_type == EVT_PROD_TYPE_EVENT_CRYPTO_ADPTR) {
+		ret = rte_event_crypto_adapter_start(TEST_PERF_CA_ID);
+		if (ret) {
+			evt_err("failed to start crypto adapter");
+			return ret;
+		}
 	}
 
 	return 0;
@@ -311,11 +333,13 @@ static const struct evt_test_ops perf_queue =  {
 	.test_setup         = perf_test_setup,
 	.mempool_setup      = perf_mempool_setup,
 	.ethdev_setup	    = perf_ethdev_setup,
+	.cryptodev_setup    = perf_cryptodev_setup,
 	.eventdev_setup     = perf_queue_eventdev_setup,
 	.launch_lcores      = perf_queue_launch_lcores,
 	.eventdev_destroy   = perf_eventdev_destroy,
 	.mempool_destroy    = perf_mempool_destroy,
 	.ethdev_destroy	    = perf_ethdev_destroy,
+	.cryptodev_destroy  = perf_cryptodev_destroy,
 	.test_result        = perf_test_result,
 	.test_destroy       = perf_test_destroy,
 };
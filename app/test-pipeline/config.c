@@ -151,6 +151,7 @@ app_parse_args(int argc, char **argv)
 		{"hash-cuckoo-96", 0, 0, 0},
 		{"hash-cuckoo-112", 0, 0, 0},
 		{"hash-cuckoo-128", 0, 0, 0},
+		{"ah", 0, 0, 0},
 		{NULL, 0, 0, 0}
 	};
 	uint32_t lcores[3], n_lcores, lcore_id, pipeline_type_provided;
@@ -185,6 +186,7 @@ app_parse_args(int argc, char **argv)
 	argvopt = argv;
 
 	app.pipeline_type = e_APP_PIPELINE_HASH_KEY16_LRU;
+	app.pipeline_ah = 0;
 	pipeline_type_provided = 0;
 
 	while ((opt = getopt_long(argc, argvopt, "p:",
@@ -198,6 +200,11 @@ app_parse_args(int argc, char **argv)
 			break;
 
 		case 0: /* long options */
+			if (!strcmp(lgopts[option_index].name, "ah")) {
+				app.pipeline_ah = 1;
+				break;
+			}
+
 			if (!pipeline_type_provided) {
 				uint32_t i;
 
@@ -56,6 +56,7 @@ struct app_params {
 
 	/* App behavior */
 	uint32_t pipeline_type;
+	uint32_t pipeline_ah;
 } __rte_cache_aligned;
 
 extern struct app_params app;
@@ -118,6 +119,9 @@ void app_main_loop_worker_pipeline_acl(void);
 void app_main_loop_worker_pipeline_lpm(void);
 void app_main_loop_worker_pipeline_lpm_ipv6(void);
 
+struct rte_pipeline;
+void app_main_loop_pipeline_run(struct rte_pipeline *p);
+
 void app_main_loop_tx(void);
 
 #define APP_FLUSH 0
@@ -20,6 +20,24 @@
 
 #include "main.h"
 
+static int
+app_pipeline_port_in_ah_nop(__rte_unused struct rte_pipeline *p,
+	__rte_unused struct rte_mbuf **pkts,
+	__rte_unused uint32_t n,
+	__rte_unused void *arg)
+{
+	return 0;
+}
+
+static int
+app_pipeline_port_out_ah_nop(__rte_unused struct rte_pipeline *p,
+	__rte_unused struct rte_mbuf **pkts,
+	__rte_unused uint64_t pkts_mask,
+	__rte_unused void *arg)
+{
+	return 0;
+}
+
 static void
 translate_options(uint32_t *special, uint32_t *ext, uint32_t *key_size)
 {
@@ -110,7 +128,8 @@ app_main_loop_worker_pipeline_hash(void) {
 		struct rte_pipeline_port_in_params port_params = {
 			.ops = &rte_port_ring_reader_ops,
 			.arg_create = (void *) &port_ring_params,
-			.f_action = NULL,
+			.f_action = app.pipeline_ah ?
+				app_pipeline_port_in_ah_nop : NULL,
 			.arg_ah = NULL,
 			.burst_size = app.burst_size_worker_read,
 		};
@@ -131,7 +150,8 @@ app_main_loop_worker_pipeline_hash(void) {
 		struct rte_pipeline_port_out_params port_params = {
 			.ops = &rte_port_ring_writer_ops,
 			.arg_create = (void *) &port_ring_params,
-			.f_action = NULL,
+			.f_action = app.pipeline_ah ?
+				app_pipeline_port_out_ah_nop : NULL,
 			.arg_ah = NULL,
 		};
 
@@ -365,17 +385,7 @@ app_main_loop_worker_pipeline_hash(void) {
 		rte_panic("Pipeline consistency check failed\n");
 
 	/* Run-time */
-#if APP_FLUSH == 0
-	for ( ; ; )
-		rte_pipeline_run(p);
-#else
-	for (i = 0; ; i++) {
-		rte_pipeline_run(p);
-
-		if ((i & APP_FLUSH) == 0)
-			rte_pipeline_flush(p);
-	}
-#endif
+	app_main_loop_pipeline_run(p);
 }
 
 uint64_t test_hash(
@@ -39,6 +39,7 @@
 #include <rte_lpm.h>
 #include <rte_lpm6.h>
 #include <rte_malloc.h>
+#include <rte_pipeline.h>
 
 #include "main.h"
 
@@ -105,6 +106,47 @@ app_main_loop_worker(void) {
 	}
 }
 
+#ifndef APP_STATS_PERIOD_LOG2
+#define APP_STATS_PERIOD_LOG2 24
+#endif
+
+void
+app_main_loop_pipeline_run(struct rte_pipeline *p) {
+	uint64_t n_pkts = 0, t_start;
+	uint32_t i;
+
+	RTE_LOG(INFO, USER1, "Core %u pipeline action handlers %s\n",
+		rte_lcore_id(), app.pipeline_ah ? "enabled" : "disabled");
+
+	t_start = rte_rdtsc();
+
+	for (i = 1; ; i++) {
+		n_pkts += rte_pipeline_run(p);
+
+#if APP_FLUSH != 0
+		if ((i & APP_FLUSH) == 0)
+			rte_pipeline_flush(p);
+#endif
+
+		if ((i & ((1 << APP_STATS_PERIOD_LOG2) - 1)) == 0) {
+			uint64_t t_end = rte_rdtsc();
+			uint64_t cycles = t_end - t_start;
+
+			if (n_pkts)
+				RTE_LOG(INFO, USER1,
+					"Core %u: %" PRIu64 " pkts, "
+					"%.2f cycles/pkt, %.2f Mpps\n",
+					rte_lcore_id(), n_pkts,
+					(double) cycles / n_pkts,
+					(double) n_pkts * rte_get_tsc_hz() /
+					cycles / 1000000);
+
+			n_pkts = 0;
+			t_start = t_end;
+		}
+	}
+}
+
 void
 app_main_loop_tx(void) {
 	uint32_t i;
@@ -2879,7 +2879,8 @@ setup_gro(const char *onoff, portid_t port_id)
 			return;
 		}
 		if (gro_flush_cycles == GRO_DEFAULT_FLUSH_CYCLES) {
-			gro_ports[port_id].param.gro_types = RTE_GRO_TCP_IPV4;
+			gro_ports[port_id].param.gro_types = RTE_GRO_TCP_IPV4 |
+				RTE_GRO_TCP_IPV6 | RTE_GRO_UDP_IPV4;
 			gro_ports[port_id].param.max_flow_num =
 				GRO_DEFAULT_FLOW_NUM;
 			gro_ports[port_id].param.max_item_per_flow =
@@ -730,6 +730,18 @@
         "Func":    default_autotest,
         "Report":  None,
     },
+    {
+        "Name":    "Sched perf autotest",
+        "Command": "sched_perf_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
+    {
+        "Name":    "IP fragmentation perf autotest",
+        "Command": "ipfrag_perf_autotest",
+        "Func":    default_autotest,
+        "Report":  None,
+    },
     {
         "Name":    "Lpm6 perf autotest",
         "Command": "lpm6_perf_autotest",
@@ -0,0 +1,310 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_mbuf.h>
+#include <rte_net.h>
+#include <rte_random.h>
+
+#include "test.h"
+
+#define CKSUM_PERF_BURST	32
+#define CKSUM_PERF_ITERS	1000
+#define CKSUM_PERF_MAX_LEN	9000
+#define CKSUM_MBUF_DATA_SZ	(CKSUM_PERF_MAX_LEN + RTE_PKTMBUF_HEADROOM)
+#define CKSUM_NB_MBUF		(2 * CKSUM_PERF_BURST)
+
+static const uint32_t cksum_perf_sizes[] = {
+	64, 128, 256, 512, 1024, 1500, 4096, 9000,
+};
+
+static struct rte_mempool *pkt_pool;
+
+/* IPv4/TCP or IPv6/UDP headers, in front of a random payload */
+static void
+cksum_pkt_init(void *data, uint32_t len, int ipv6)
+{
+	struct rte_ether_hdr *eth = data;
+	struct rte_ipv4_hdr *ip4;
+	struct rte_ipv6_hdr *ip6;
+	uint8_t *p = data;
+	uint32_t i;
+
+	for (i = 0; i < len; i++)
+		p[i] = rte_rand();
+
+	if (ipv6) {
+		eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+		ip6 = (struct rte_ipv6_hdr *)(eth + 1);
+		ip6->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ip6->payload_len = rte_cpu_to_be_16(len - sizeof(*eth) -
+			sizeof(*ip6));
+		ip6->proto = IPPROTO_UDP;
+		ip6->hop_limits = 64;
+	} else {
+		eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+		ip4 = (struct rte_ipv4_hdr *)(eth + 1);
+		ip4->version_ihl = RTE_IPV4_VHL_DEF;
+		ip4->fragment_offset = 0;
+		ip4->total_length = rte_cpu_to_be_16(len - sizeof(*eth));
+		ip4->time_to_live = 64;
+		ip4->next_proto_id = IPPROTO_TCP;
+	}
+}
+
+static void
+cksum_mbuf_init(struct rte_mbuf *m, int ipv6)
+{
+	m->l2_len = sizeof(struct rte_ether_hdr);
+	if (ipv6) {
+		m->l3_len = sizeof(struct rte_ipv6_hdr);
+		m->ol_flags = PKT_TX_IPV6 | PKT_TX_UDP_CKSUM;
+		m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6 |
+			RTE_PTYPE_L4_UDP;
+	} else {
+		m->l3_len = sizeof(struct rte_ipv4_hdr);
+		m->ol_flags = PKT_TX_IPV4 | PKT_TX_IP_CKSUM |
+			PKT_TX_TCP_CKSUM;
+		m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+			RTE_PTYPE_L4_TCP;
+	}
+}
+
+/* L4 checksum field of a packet initialized by cksum_pkt_init() */
+static uint16_t *
+cksum_l4_field(struct rte_mbuf *m, int ipv6)
+{
+	if (ipv6)
+		return &rte_pktmbuf_mtod_offset(m, struct rte_udp_hdr *,
+			m->l2_len + m->l3_len)->dgram_cksum;
+	return &rte_pktmbuf_mtod_offset(m, struct rte_tcp_hdr *,
+		m->l2_len + m->l3_len)->cksum;
+}
+
+/* checksums computed per packet with the rte_ip.h functions */
+static void
+cksum_scalar(struct rte_mbuf *m, int ipv6)
+{
+	struct rte_ipv4_hdr *ip4;
+	void *l3_hdr, *l4_hdr;
+	uint16_t *l4_cksum;
+
+	l3_hdr = rte_pktmbuf_mtod_offset(m, void *, m->l2_len);
+	l4_hdr = rte_pktmbuf_mtod_offset(m, void *, m->l2_len + m->l3_len);
+	l4_cksum = cksum_l4_field(m, ipv6);
+	*l4_cksum = 0;
+	if (ipv6) {
+		*l4_cksum = rte_ipv6_udptcp_cksum(l3_hdr, l4_hdr);
+	} else {
+		ip4 = l3_hdr;
+		ip4->hdr_checksum = 0;
+		ip4->hdr_checksum = rte_ipv4_cksum(ip4);
+		*l4_cksum = rte_ipv4_udptcp_cksum(ip4, l4_hdr);
+	}
+}
+
+static int
+test_cksum_perf_size(struct rte_mbuf **pkts, uint32_t len, int ipv6)
+{
+	uint16_t ref_l3[CKSUM_PERF_BURST], ref_l4[CKSUM_PERF_BURST];
+	const char *name = ipv6 ? "IPv6/UDP" : "IPv4/TCP";
+	struct rte_ipv4_hdr *ip4;
+	uint64_t tsc, sum = 0;
+	uint32_t i, j;
+
+	for (i = 0; i < CKSUM_PERF_BURST; i++) {
+		rte_pktmbuf_reset(pkts[i]);
+		cksum_pkt_init(rte_pktmbuf_append(pkts[i], len), len, ipv6);
+		cksum_mbuf_init(pkts[i], ipv6);
+		if (rte_raw_cksum(rte_pktmbuf_mtod(pkts[i], void *), len) !=
+				rte_net_raw_cksum(rte_pktmbuf_mtod(pkts[i],
+				void *), len)) {
+			printf("%s %u: raw checksum mismatch\n", name, len);
+			return -1;
+		}
+	}
+
+	tsc = rte_rdtsc_precise();
+	for (j = 0; j < CKSUM_PERF_ITERS; j++)
+		for (i = 0; i < CKSUM_PERF_BURST; i++)
+			sum += rte_raw_cksum(rte_pktmbuf_mtod(pkts[i], void *),
+				len);
+	tsc = rte_rdtsc_precise() - tsc;
+	printf("%s %5u: rte_raw_cksum %8.1f", name, len,
+		(double)tsc / (CKSUM_PERF_ITERS * CKSUM_PERF_BURST));
+
+	tsc = rte_rdtsc_precise();
+	for (j = 0; j < CKSUM_PERF_ITERS; j++)
+		for (i = 0; i < CKSUM_PERF_BURST; i++)
+			sum += rte_net_raw_cksum(rte_pktmbuf_mtod(pkts[i],
+				void *), len);
+	tsc = rte_rdtsc_precise() - tsc;
+	printf(", rte_net_raw_cksum %8.1f",
+		(double)tsc / (CKSUM_PERF_ITERS * CKSUM_PERF_BURST));
+
+	tsc = rte_rdtsc_precise();
+	for (j = 0; j < CKSUM_PERF_ITERS; j++)
+		for (i = 0; i < CKSUM_PERF_BURST; i++)
+			cksum_scalar(pkts[i], ipv6);
+	tsc = rte_rdtsc_precise() - tsc;
+	printf(", per packet %8.1f",
+		(double)tsc / (CKSUM_PERF_ITERS * CKSUM_PERF_BURST));
+
+	for (i = 0; i < CKSUM_PERF_BURST; i++) {
+		ip4 = rte_pktmbuf_mtod_offset(pkts[i], struct rte_ipv4_hdr *,
+			pkts[i]->l2_len);
+		ref_l3[i] = ipv6 ? 0 : ip4->hdr_checksum;
+		ref_l4[i] = *cksum_l4_field(pkts[i], ipv6);
+	}
+
+	tsc = rte_rdtsc_precise();
+	for (j = 0; j < CKSUM_PERF_ITERS; j++) {
+		if (rte_net_cksum_fill_burst(pkts, CKSUM_PERF_BURST) !=
+				CKSUM_PERF_BURST) {
+			printf("\n%s %u: cannot fill checksums\n", name, len);
+			return -1;
+		}
+	}
+	tsc = rte_rdtsc_precise() - tsc;
+	printf(", fill burst %8.1f",
+		(double)tsc / (CKSUM_PERF_ITERS * CKSUM_PERF_BURST));
+
+	for (i = 0; i < CKSUM_PERF_BURST; i++) {
+		ip4 = rte_pktmbuf_mtod_offset(pkts[i], struct rte_ipv4_hdr *,
+			pkts[i]->l2_len);
+		if ((!ipv6 && ip4->hdr_checksum != ref_l3[i]) ||
+				*cksum_l4_field(pkts[i], ipv6) != ref_l4[i]) {
+			printf("\n%s %u: checksum mismatch\n", name, len);
+			return -1;
+		}
+	}
+
+	tsc = rte_rdtsc_precise();
+	for (j = 0; j < CKSUM_PERF_ITERS; j++)
+		rte_net_cksum_verify_burst(pkts, CKSUM_PERF_BURST);
+	tsc = rte_rdtsc_precise() - tsc;
+	printf(", verify burst %8.1f cycles/packet\n",
+		(double)tsc / (CKSUM_PERF_ITERS * CKSUM_PERF_BURST));
+
+	for (i = 0; i < CKSUM_PERF_BURST; i++) {
+		if ((pkts[i]->ol_flags & PKT_RX_L4_CKSUM_MASK) !=
+				PKT_RX_L4_CKSUM_GOOD || (!ipv6 &&
+				(pkts[i]->ol_flags & PKT_RX_IP_CKSUM_MASK) !=
+				PKT_RX_IP_CKSUM_GOOD)) {
+			printf("%s %u: checksum not verified\n", name, len);
+			return -1;
+		}
+	}
+
+	/* keep the computations */
+	if (sum == 0)
+		printf("\n");
+
+	return 0;
+}
+
+/* checksum of a packet split at odd offsets, against a contiguous copy */
+static int
+test_cksum_multi_seg(int ipv6)
+{
+	static const uint32_t seg_len[] = { 101, 333, 1, 64, 1001 };
+	struct rte_mbuf *m = NULL, *seg, *ref;
+	uint32_t i, off, len = 0;
+	int ret = -1;
+
+	for (i = 0; i < RTE_DIM(seg_len); i++)
+		len += seg_len[i];
+
+	ref = rte_pktmbuf_alloc(pkt_pool);
+	if (ref == NULL)
+		return -1;
+	cksum_pkt_init(rte_pktmbuf_append(ref, len), len, ipv6);
+	cksum_mbuf_init(ref, ipv6);
+
+	for (i = 0, off = 0; i < RTE_DIM(seg_len); off += seg_len[i++]) {
+		seg = rte_pktmbuf_alloc(pkt_pool);
+		if (seg == NULL)
+			goto out;
+		memcpy(rte_pktmbuf_append(seg, seg_len[i]),
+			rte_pktmbuf_mtod_offset(ref, void *, off), seg_len[i]);
+		if (m == NULL)
+			m = seg;
+		else if (rte_pktmbuf_chain(m, seg) != 0) {
+			rte_pktmbuf_free(seg);
+			goto out;
+		}
+	}
+	cksum_mbuf_init(m, ipv6);
+
+	cksum_scalar(ref, ipv6);
+	if (rte_net_cksum_fill_burst(&m, 1) != 1 ||
+			*cksum_l4_field(m, ipv6) != *cksum_l4_field(ref, ipv6))
+		goto out;
+
+	rte_net_cksum_verify_burst(&m, 1);
+	if ((m->ol_flags & PKT_RX_L4_CKSUM_MASK) != PKT_RX_L4_CKSUM_GOOD)
+		goto out;
+
+	/* corrupt the payload in the last segment */
+	*rte_pktmbuf_mtod(rte_pktmbuf_lastseg(m), uint8_t *) ^= 0x10;
+	rte_net_cksum_verify_burst(&m, 1);
+	if ((m->ol_flags & PKT_RX_L4_CKSUM_MASK) != PKT_RX_L4_CKSUM_BAD)
+		goto out;
+
+	ret = 0;
+out:
+	if (ret != 0)
+		printf("%s multi-segment checksum failed\n",
+			ipv6 ? "IPv6/UDP" : "IPv4/TCP");
+	rte_pktmbuf_free(m);
+	rte_pktmbuf_free(ref);
+	return ret;
+}
+
+static int
+test_cksum_perf(void)
+{
+	struct rte_mbuf *pkts[CKSUM_PERF_BURST];
+	uint32_t i;
+	int ipv6, ret = -1;
+
+	pkt_pool = rte_pktmbuf_pool_create("CKSUM_PERF_POOL", CKSUM_NB_MBUF,
+		0, 0, CKSUM_MBUF_DATA_SZ, SOCKET_ID_ANY);
+	if (pkt_pool == NULL) {
+		printf("Cannot create mbuf pool\n");
+		return -1;
+	}
+
+	if (rte_pktmbuf_alloc_bulk(pkt_pool, pkts, CKSUM_PERF_BURST) != 0) {
+		printf("Cannot allocate mbufs\n");
+		goto out_pool;
+	}
+
+	for (ipv6 = 0; ipv6 <= 1; ipv6++) {
+		if (test_cksum_multi_seg(ipv6) != 0)
+			goto out;
+		for (i = 0; i < RTE_DIM(cksum_perf_sizes); i++)
+			if (test_cksum_perf_size(pkts, cksum_perf_sizes[i],
+					ipv6) != 0)
+				goto out;
+	}
+
+	ret = 0;
+out:
+	for (i = 0; i < CKSUM_PERF_BURST; i++)
+		rte_pktmbuf_free(pkts[i]);
+out_pool:
+	rte_mempool_free(pkt_pool);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(cksum_perf_autotest, test_cksum_perf);
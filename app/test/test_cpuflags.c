@@ -145,6 +145,18 @@ test_cpuflags(void)
 	printf("Check for AVX512F:\t");
 	CHECK_FOR_FLAG(RTE_CPUFLAG_AVX512F);
 
+	printf("Check for AVX512BW:\t");
+	CHECK_FOR_FLAG(RTE_CPUFLAG_AVX512BW);
+
+	printf("Check for AVX512VBMI:\t");
+	CHECK_FOR_FLAG(RTE_CPUFLAG_AVX512VBMI);
+
+	printf("Check for GFNI:\t\t");
+	CHECK_FOR_FLAG(RTE_CPUFLAG_GFNI);
+
+	printf("Check for VPCLMULQDQ:\t");
+	CHECK_FOR_FLAG(RTE_CPUFLAG_VPCLMULQDQ);
+
 	printf("Check for TRBOBST:\t");
 	CHECK_FOR_FLAG(RTE_CPUFLAG_TRBOBST);
 
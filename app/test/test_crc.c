@@ -15,6 +15,7 @@
 #define CRC16_VEC_LEN1     12
 #define CRC16_VEC_LEN2     2
 #define LINE_LEN           75
+#define CRC_BULK_NB        11
 
 /* CRC test vector */
 static const uint8_t crc_vec[CRC_VEC_LEN] = {
@@ -47,6 +48,14 @@ static const uint32_t crc32_vec2_res = 0xefaae02f;
 static const uint32_t crc16_vec_res = 0x6bec;
 static const uint16_t crc16_vec1_res = 0x8cdd;
 static const uint16_t crc16_vec2_res = 0xec5b;
+static const uint32_t crc32c_vec_res = 0x65fa5498;
+static const uint32_t crc32c_vec1_res = 0x38bf1ee7;
+static const uint32_t crc32c_vec2_res = 0x17f21d0d;
+
+/* lengths of the buffers of the bulk CRC test */
+static const uint32_t crc_bulk_len[CRC_BULK_NB] = {
+	1512, 348, 1500, 64, 2, 256, 255, 1024, 15, 16, 33,
+};
 
 static int
 crc_calc(const uint8_t *vec,
@@ -100,6 +109,24 @@ test_crc_calc(void)
 		goto fail;
 	}
 
+	/* 32-bit Castagnoli CRC: Test 4 */
+	type = RTE_NET_CRC32C;
+	result = crc_calc(crc_vec, CRC_VEC_LEN, type);
+	if (result != crc32c_vec_res) {
+		error = -7;
+		goto fail;
+	}
+	result = crc_calc(test_data, CRC32_VEC_LEN1, type);
+	if (result != crc32c_vec1_res) {
+		error = -8;
+		goto fail;
+	}
+	result = crc_calc(test_data, CRC32_VEC_LEN2, type);
+	if (result != crc32c_vec2_res) {
+		error = -9;
+		goto fail;
+	}
+
 	/* 16-bit CCITT CRC:  Test 4 */
 	type = RTE_NET_CRC16_CCITT;
 	result = crc_calc(crc_vec, CRC_VEC_LEN, type);
@@ -128,6 +155,47 @@ test_crc_calc(void)
 	return error;
 }
 
+static int
+test_crc_calc_bulk(void)
+{
+	const void *data[CRC_BULK_NB];
+	uint32_t crc[CRC_BULK_NB];
+	enum rte_net_crc_type type;
+	uint8_t *test_data;
+	uint32_t i, nb;
+	int error = 0;
+
+	test_data = rte_zmalloc(NULL, CRC_BULK_NB * CRC32_VEC_LEN1, 0);
+	if (test_data == NULL)
+		return -1;
+
+	for (i = 0; i < CRC_BULK_NB * CRC32_VEC_LEN1; i++)
+		test_data[i] = crc32_vec1[i % 12] + i / CRC32_VEC_LEN1;
+	for (i = 0; i < CRC_BULK_NB; i++)
+		data[i] = &test_data[i * CRC32_VEC_LEN1 + i];
+
+	/* the CRCs of the buffers must be the ones computed one by one */
+	for (type = RTE_NET_CRC16_CCITT; type < RTE_NET_CRC_REQS; type++) {
+		for (nb = 0; nb <= CRC_BULK_NB; nb++) {
+			memset(crc, 0, sizeof(crc));
+			rte_net_crc_calc_bulk(data, crc_bulk_len, crc, nb,
+				type);
+			for (i = 0; i < CRC_BULK_NB; i++) {
+				if (crc[i] != (i < nb ? rte_net_crc_calc(
+						data[i], crc_bulk_len[i],
+						type) : 0)) {
+					error = -10;
+					goto fail;
+				}
+			}
+		}
+	}
+
+fail:
+	rte_free(test_data);
+	return error;
+}
+
 static int
 test_crc(void)
 {
@@ -158,6 +226,30 @@ test_crc(void)
 		return ret;
 	}
 
+	/* set CRC avx512 mode */
+	rte_net_crc_set_alg(RTE_NET_CRC_AVX512);
+
+	ret = test_crc_calc();
+	if (ret < 0) {
+		printf("test_crc (x86_64 AVX512): failed (%d)\n", ret);
+		return ret;
+	}
+
+	ret = test_crc_calc_bulk();
+	if (ret < 0) {
+		printf("test_crc (bulk x86_64 AVX512): failed (%d)\n", ret);
+		return ret;
+	}
+
+	/* bulk computation one buffer after the other */
+	rte_net_crc_set_alg(RTE_NET_CRC_SCALAR);
+
+	ret = test_crc_calc_bulk();
+	if (ret < 0) {
+		printf("test_crc (bulk scalar): failed (%d)\n", ret);
+		return ret;
+	}
+
 	return 0;
 }
 
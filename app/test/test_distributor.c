@@ -510,6 +510,83 @@ test_flush_with_worker_shutdown(struct worker_params *wp,
 	return 0;
 }
 
+/*
+ * Test that a worker removed from a burst distributor with flow affinity
+ * doesn't get new flows, and that the last worker can't be removed.
+ */
+static int
+sanity_test_with_worker_remove(struct worker_params *wp,
+		struct rte_mempool *p)
+{
+	struct rte_distributor *d = wp->dist;
+	const unsigned int num_workers = rte_lcore_count() - 1;
+	struct rte_mbuf *bufs[BURST];
+	struct rte_mbuf *returns[BURST*2];
+	unsigned int i, count;
+
+	printf("=== Sanity test of worker removal ===\n");
+
+	if (rte_distributor_flow_affinity_set(d, 1) != 0 ||
+			rte_distributor_worker_remove(d, 0) != 0 ||
+			rte_distributor_worker_remove(d, 0) != -EINVAL) {
+		printf("Line %d: Error removing worker 0\n", __LINE__);
+		return -1;
+	}
+	for (i = 1; i < num_workers - 1; i++)
+		rte_distributor_worker_remove(d, i);
+	if (rte_distributor_worker_remove(d, num_workers - 1) != -EBUSY) {
+		printf("Line %d: Error, last worker removed\n", __LINE__);
+		return -1;
+	}
+	for (i = 1; i < num_workers - 1; i++)
+		rte_distributor_worker_add(d, i);
+
+	clear_packet_count();
+	if (rte_mempool_get_bulk(p, (void *)bufs, BURST) != 0) {
+		printf("line %d: Error getting mbufs from pool\n", __LINE__);
+		return -1;
+	}
+
+	/* new flows, that can't be in flight on worker 0 */
+	for (i = 0; i < BURST; i++)
+		bufs[i]->hash.usr = 0x4000 + (i << 1);
+
+	rte_distributor_process(d, bufs, BURST);
+	count = 0;
+	do {
+		rte_distributor_flush(d);
+		count += rte_distributor_returned_pkts(d,
+				returns, BURST*2);
+	} while (count < BURST);
+
+	for (i = 0; i < num_workers; i++)
+		printf("Worker %u handled %u packets\n", i,
+				worker_stats[i].handled_packets);
+
+	if (total_packet_count() != BURST) {
+		printf("Line %d: Error, not all packets flushed. "
+				"Expected %u, got %u\n",
+				__LINE__, BURST, total_packet_count());
+		return -1;
+	}
+	if (worker_stats[0].handled_packets != 0) {
+		printf("Line %d: Error, removed worker got %u packets\n",
+				__LINE__, worker_stats[0].handled_packets);
+		return -1;
+	}
+
+	if (rte_distributor_worker_add(d, 0) != 0 ||
+			rte_distributor_worker_add(d, 0) != -EINVAL) {
+		printf("Line %d: Error adding worker 0\n", __LINE__);
+		return -1;
+	}
+	rte_distributor_flow_affinity_set(d, 0);
+	rte_mempool_put_bulk(p, (void *)bufs, BURST);
+
+	printf("Sanity test with worker removal passed\n\n");
+	return 0;
+}
+
 static
 int test_error_distributor_create_name(void)
 {
@@ -682,6 +759,15 @@ test_distributor(void)
 				goto err;
 			quit_workers(&worker_params, p);
 
+			if (dist[i] == db) {
+				rte_eal_mp_remote_launch(handle_work,
+						&worker_params, SKIP_MASTER);
+				if (sanity_test_with_worker_remove(
+						&worker_params, p) < 0)
+					goto err;
+				quit_workers(&worker_params, p);
+			}
+
 		} else {
 			printf("Too few cores to run worker shutdown test\n");
 		}
@@ -15,6 +15,7 @@
 
 #define ITER_POWER_CL 25 /* log 2 of how many iterations  for Cache Line test */
 #define ITER_POWER 21 /* log 2 of how many iterations we do when timing. */
+#define ITER_POWER_SCALE 18 /* log 2 of iterations per worker count */
 #define BURST 64
 #define BIG_BATCH 1024
 
@@ -177,6 +178,65 @@ perf_test(struct rte_distributor *d, struct rte_mempool *p)
 	return 0;
 }
 
+/*
+ * Time the burst distributor with a growing number of the workers getting
+ * new flows, the other ones being removed from the distributor, and report
+ * the packet rate for each number of workers.
+ */
+static int
+perf_test_scaling(struct rte_distributor *d, struct rte_mempool *p,
+		int flow_affinity)
+{
+	const unsigned int num_workers = rte_lcore_count() - 1;
+	unsigned int i, n, nb_active;
+	uint64_t start, end;
+	struct rte_mbuf *bufs[BURST];
+
+	if (rte_mempool_get_bulk(p, (void *)bufs, BURST) != 0) {
+		printf("Error getting mbufs from pool\n");
+		return -1;
+	}
+	for (i = 0; i < BURST; i++)
+		bufs[i]->hash.usr = i;
+
+	rte_distributor_flow_affinity_set(d, flow_affinity);
+	for (i = 1; i < num_workers; i++)
+		rte_distributor_worker_remove(d, i);
+
+	nb_active = 1;
+	for (n = 1; n <= num_workers; n = RTE_MIN(n * 2, num_workers)) {
+		for (; nb_active < n; nb_active++)
+			rte_distributor_worker_add(d, nb_active);
+
+		clear_packet_count();
+		start = rte_rdtsc();
+		for (i = 0; i < (1 << ITER_POWER_SCALE); i++)
+			rte_distributor_process(d, bufs, BURST);
+		end = rte_rdtsc();
+
+		/* the flushes also clear the flows in flight on the workers */
+		do {
+			usleep(100);
+			rte_distributor_process(d, NULL, 0);
+		} while (total_packet_count() < (BURST << ITER_POWER_SCALE));
+		rte_distributor_process(d, NULL, 0);
+		rte_distributor_clear_returns(d);
+
+		printf("%2u workers: %6.2f Mpps\n", n,
+			(double)(BURST << ITER_POWER_SCALE) * rte_get_tsc_hz() /
+			(end - start) / 1E6);
+
+		if (n == num_workers)
+			break;
+	}
+
+	rte_distributor_flow_affinity_set(d, 0);
+	rte_mempool_put_bulk(p, (void *)bufs, BURST);
+	printf("=== Scaling test done ===\n\n");
+
+	return 0;
+}
+
 /* Useful function which ensures that all worker functions terminate */
 static void
 quit_workers(struct rte_distributor *d, struct rte_mempool *p)
@@ -262,6 +322,18 @@ test_distributor_perf(void)
 		return -1;
 	quit_workers(db, p);
 
+	printf("=== Scaling test of distributor (burst mode) ===\n");
+	rte_eal_mp_remote_launch(handle_work, db, SKIP_MASTER);
+	if (perf_test_scaling(db, p, 0) < 0)
+		return -1;
+	quit_workers(db, p);
+
+	printf("=== Scaling test of distributor (burst mode, flow affinity) ===\n");
+	rte_eal_mp_remote_launch(handle_work, db, SKIP_MASTER);
+	if (perf_test_scaling(db, p, 1) < 0)
+		return -1;
+	quit_workers(db, p);
+
 	return 0;
 }
 
@@ -7,6 +7,7 @@
 #include <rte_common.h>
 #include <rte_mempool.h>
 #include <rte_mbuf.h>
+#include <rte_cycles.h>
 #include <rte_cryptodev.h>
 #include <rte_eventdev.h>
 #include <rte_bus_vdev.h>
@@ -27,6 +28,11 @@
 #define TEST_APP_EV_PRIORITY       0
 #define TEST_APP_EV_FLOWID         0xAABB
 #define TEST_CRYPTO_EV_QUEUE_ID    1
+#define TEST_BATCH_SIZE            16
+#define TEST_BATCH_NB_OPS          4
+#define TEST_BATCH_FLUSH_TMO_NS    (50 * 1000 * 1000ULL)
+#define TEST_BATCH_WAIT_S          5
+#define TEST_DEFAULT_BATCH_SIZE    32
 #define TEST_ADAPTER_ID            0
 #define TEST_CDEV_ID               0
 #define TEST_CDEV_QP_ID            0
@@ -340,6 +346,133 @@ test_session_with_op_forward_mode(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_session_with_op_forward_batch_mode(void)
+{
+	struct rte_event_crypto_adapter_queue_pair_batch_conf conf = {
+		.batch_size = TEST_BATCH_SIZE,
+		.flush_timeout_ns = TEST_BATCH_FLUSH_TMO_NS,
+	};
+	struct rte_crypto_op *ops[TEST_BATCH_NB_OPS];
+	struct rte_event ev[TEST_BATCH_NB_OPS];
+	struct rte_event_crypto_adapter_stats stats;
+	struct rte_crypto_sym_xform cipher_xform;
+	struct rte_cryptodev_sym_session *sess;
+	union rte_event_crypto_metadata m_data;
+	uint64_t tmo_cycles, start, deadline, first = 0;
+	unsigned int i, nb_recv;
+	uint32_t cap;
+	int ret;
+
+	ret = rte_event_crypto_adapter_caps_get(TEST_ADAPTER_ID, evdev, &cap);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get adapter capabilities\n");
+
+	/* Batching applies to the SW adapter in forward mode only */
+	if (cap & (RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_FWD |
+		   RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_NEW))
+		return TEST_SKIPPED;
+
+	ret = rte_event_crypto_adapter_queue_pair_batch_config(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, TEST_CDEV_QP_ID, &conf);
+	TEST_ASSERT_SUCCESS(ret, "Failed to configure batching\n");
+
+	map_adapter_service_core();
+	TEST_ASSERT_SUCCESS(rte_event_crypto_adapter_start(TEST_ADAPTER_ID),
+				"Failed to start event crypto adapter");
+
+	memset(&cipher_xform, 0, sizeof(cipher_xform));
+	cipher_xform.type = RTE_CRYPTO_SYM_XFORM_CIPHER;
+	cipher_xform.cipher.algo = RTE_CRYPTO_CIPHER_NULL;
+	cipher_xform.cipher.op = RTE_CRYPTO_CIPHER_OP_ENCRYPT;
+
+	sess = rte_cryptodev_sym_session_create(params.session_mpool);
+	TEST_ASSERT_NOT_NULL(sess, "Session creation failed\n");
+	ret = rte_cryptodev_sym_session_init(TEST_CDEV_ID, sess,
+			&cipher_xform, params.session_priv_mpool);
+	TEST_ASSERT_SUCCESS(ret, "Failed to init session\n");
+
+	memset(&m_data, 0, sizeof(m_data));
+	rte_memcpy(&m_data.response_info, &response_info,
+		   sizeof(response_info));
+	rte_memcpy(&m_data.request_info, &request_info, sizeof(request_info));
+	ret = rte_cryptodev_sym_session_set_user_data(sess, &m_data,
+						      sizeof(m_data));
+	TEST_ASSERT_SUCCESS(ret, "Failed to set session user data\n");
+
+	/* Fewer ops than the batch size: only the timeout flushes them */
+	memset(ev, 0, sizeof(ev));
+	for (i = 0; i < TEST_BATCH_NB_OPS; i++) {
+		ops[i] = rte_crypto_op_alloc(params.op_mpool,
+				RTE_CRYPTO_OP_TYPE_SYMMETRIC);
+		TEST_ASSERT_NOT_NULL(ops[i],
+			"Failed to allocate symmetric crypto operation\n");
+		ops[i]->sym->m_src = alloc_fill_mbuf(params.mbuf_pool,
+				text_64B, PACKET_LENGTH, 0);
+		TEST_ASSERT_NOT_NULL(ops[i]->sym->m_src,
+				     "Failed to allocate mbuf!\n");
+		ops[i]->sym->cipher.data.offset = 0;
+		ops[i]->sym->cipher.data.length = PACKET_LENGTH;
+		rte_crypto_op_attach_sym_session(ops[i], sess);
+
+		ev[i].queue_id = TEST_CRYPTO_EV_QUEUE_ID;
+		ev[i].sched_type = RTE_SCHED_TYPE_ATOMIC;
+		ev[i].flow_id = 0xAABB;
+		ev[i].event_ptr = ops[i];
+	}
+
+	rte_event_crypto_adapter_stats_reset(TEST_ADAPTER_ID);
+	tmo_cycles = TEST_BATCH_FLUSH_TMO_NS * rte_get_tsc_hz() / NS_PER_S;
+	start = rte_get_tsc_cycles();
+	deadline = start + TEST_BATCH_WAIT_S * rte_get_tsc_hz();
+
+	ret = rte_event_enqueue_burst(evdev, TEST_APP_PORT_ID, ev,
+				      TEST_BATCH_NB_OPS);
+	TEST_ASSERT_EQUAL(ret, TEST_BATCH_NB_OPS,
+			  "Failed to send events to crypto adapter\n");
+
+	nb_recv = 0;
+	while (nb_recv < TEST_BATCH_NB_OPS && rte_get_tsc_cycles() < deadline) {
+		struct rte_event recv_ev;
+		struct rte_crypto_op *op;
+
+		if (rte_event_dequeue_burst(evdev, TEST_APP_PORT_ID,
+					    &recv_ev, 1, 0) == 0) {
+			rte_pause();
+			continue;
+		}
+		if (nb_recv++ == 0)
+			first = rte_get_tsc_cycles();
+
+		op = recv_ev.event_ptr;
+		TEST_ASSERT_EQUAL(op->status, RTE_CRYPTO_OP_STATUS_SUCCESS,
+				  "Crypto op failed\n");
+		rte_pktmbuf_free(op->sym->m_src);
+		rte_crypto_op_free(op);
+	}
+	TEST_ASSERT_EQUAL(nb_recv, TEST_BATCH_NB_OPS,
+			  "Received %u of %u ops\n", nb_recv,
+			  TEST_BATCH_NB_OPS);
+	TEST_ASSERT(first - start >= tmo_cycles,
+		    "Ops completed before the flush timeout\n");
+
+	ret = rte_event_crypto_adapter_stats_get(TEST_ADAPTER_ID, &stats);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get adapter stats\n");
+	TEST_ASSERT_EQUAL(stats.crypto_enq_count, TEST_BATCH_NB_OPS,
+			  "Unexpected cryptodev enqueue count\n");
+
+	rte_cryptodev_sym_session_clear(TEST_CDEV_ID, sess);
+	rte_cryptodev_sym_session_free(sess);
+
+	/* Restore the defaults for the following test cases */
+	conf.batch_size = TEST_DEFAULT_BATCH_SIZE;
+	conf.flush_timeout_ns = 0;
+	ret = rte_event_crypto_adapter_queue_pair_batch_config(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, TEST_CDEV_QP_ID, &conf);
+	TEST_ASSERT_SUCCESS(ret, "Failed to restore batching\n");
+
+	return TEST_SUCCESS;
+}
+
 static int
 send_op_recv_ev(struct rte_crypto_op *op)
 {
@@ -564,7 +697,9 @@ configure_cryptodev(void)
 
 	params.session_mpool = rte_cryptodev_sym_session_pool_create(
 			"CRYPTO_ADAPTER_SESSION_MP",
-			MAX_NB_SESSIONS, 0, 0, 0, SOCKET_ID_ANY);
+			MAX_NB_SESSIONS, 0, 0,
+			sizeof(union rte_event_crypto_metadata),
+			SOCKET_ID_ANY);
 	TEST_ASSERT_NOT_NULL(params.session_mpool,
 			"session mempool allocation failed\n");
 
@@ -738,6 +873,68 @@ test_crypto_adapter_qp_add_del(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_crypto_adapter_qp_batch_config(void)
+{
+	struct rte_event_crypto_adapter_queue_pair_batch_conf conf = {
+		.batch_size = 16,
+		.flush_timeout_ns = 10000,
+	};
+	int32_t nb_qps = rte_cryptodev_queue_pair_count(TEST_CDEV_ID);
+	uint32_t cap;
+	int ret;
+
+	ret = rte_event_crypto_adapter_caps_get(TEST_ADAPTER_ID, evdev, &cap);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get adapter capabilities\n");
+
+	/* No queue pair added yet */
+	ret = rte_event_crypto_adapter_queue_pair_batch_config(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, TEST_CDEV_QP_ID, &conf);
+	TEST_ASSERT(ret == -EINVAL || ret == -ENOTSUP,
+		    "Expected failure without queue pair, ret = %d\n", ret);
+
+	if (cap & RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_QP_EV_BIND) {
+		ret = rte_event_crypto_adapter_queue_pair_add(TEST_ADAPTER_ID,
+				TEST_CDEV_ID, TEST_CDEV_QP_ID, &response_info);
+	} else
+		ret = rte_event_crypto_adapter_queue_pair_add(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, TEST_CDEV_QP_ID, NULL);
+	TEST_ASSERT_SUCCESS(ret, "Failed to add queue pair\n");
+
+	ret = rte_event_crypto_adapter_queue_pair_batch_config(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, TEST_CDEV_QP_ID, NULL);
+	TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, got %d\n", ret);
+
+	conf.batch_size = 0;
+	ret = rte_event_crypto_adapter_queue_pair_batch_config(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, TEST_CDEV_QP_ID, &conf);
+	TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, got %d\n", ret);
+
+	conf.batch_size = RTE_EVENT_CRYPTO_ADAPTER_MAX_BATCH_SIZE + 1;
+	ret = rte_event_crypto_adapter_queue_pair_batch_config(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, TEST_CDEV_QP_ID, &conf);
+	TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, got %d\n", ret);
+
+	conf.batch_size = 16;
+	ret = rte_event_crypto_adapter_queue_pair_batch_config(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, nb_qps, &conf);
+	TEST_ASSERT(ret == -EINVAL, "Expected -EINVAL, got %d\n", ret);
+
+	ret = rte_event_crypto_adapter_queue_pair_batch_config(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, -1, &conf);
+	if (cap & RTE_EVENT_CRYPTO_ADAPTER_CAP_INTERNAL_PORT_OP_FWD)
+		TEST_ASSERT(ret == -ENOTSUP, "Expected -ENOTSUP, got %d\n",
+			    ret);
+	else
+		TEST_ASSERT_SUCCESS(ret, "Failed to configure batching\n");
+
+	ret = rte_event_crypto_adapter_queue_pair_del(TEST_ADAPTER_ID,
+					TEST_CDEV_ID, TEST_CDEV_QP_ID);
+	TEST_ASSERT_SUCCESS(ret, "Failed to delete queue pair\n");
+
+	return TEST_SUCCESS;
+}
+
 static int
 configure_event_crypto_adapter(enum rte_event_crypto_adapter_mode mode)
 {
@@ -949,6 +1146,10 @@ static struct unit_test_suite functional_testsuite = {
 				test_crypto_adapter_free,
 				test_crypto_adapter_stats),
 
+		TEST_CASE_ST(test_crypto_adapter_create,
+				test_crypto_adapter_free,
+				test_crypto_adapter_qp_batch_config),
+
 		TEST_CASE_ST(test_crypto_adapter_conf_op_forward_mode,
 				test_crypto_adapter_stop,
 				test_session_with_op_forward_mode),
@@ -957,6 +1158,10 @@ static struct unit_test_suite functional_testsuite = {
 				test_crypto_adapter_stop,
 				test_sessionless_with_op_forward_mode),
 
+		TEST_CASE_ST(test_crypto_adapter_conf_op_forward_mode,
+				test_crypto_adapter_stop,
+				test_session_with_op_forward_batch_mode),
+
 		TEST_CASE_ST(test_crypto_adapter_conf_op_new_mode,
 				test_crypto_adapter_stop,
 				test_session_with_op_new_mode),
@@ -5,12 +5,19 @@
 #include <rte_common.h>
 #include <rte_mempool.h>
 #include <rte_mbuf.h>
+#include <rte_cycles.h>
 #include <rte_ethdev.h>
 #include <rte_eventdev.h>
 #include <rte_bus_vdev.h>
+#include <rte_service.h>
 
 #include <rte_event_eth_rx_adapter.h>
 
+#if defined(RTE_LIBRTE_PMD_RING) || defined(RTE_LIBRTE_RING_PMD)
+#include <rte_eth_ring.h>
+#define RX_ADAPTER_DATA_TESTS
+#endif
+
 #include "test.h"
 
 #define MAX_NUM_RX_QUEUE	64
@@ -21,6 +28,24 @@
 #define TEST_DEV_ID		0
 #define TEST_ETHDEV_ID		0
 
+/* Data path tests: Rx queues of a ring port feeding a SW event device */
+#define DATA_NB_QUEUE		4
+#define DATA_RING_SIZE		1024
+#define DATA_NB_MBUF		4096
+#define DATA_PKT_LEN		64
+#define DATA_MAX_NB_RX		128
+#define DATA_NB_EVENT		1024
+#define DATA_SCHED_ITER		4
+/* Bursts read from an Rx queue in one poll, and the most rounds an idle
+ * Rx queue is skipped for, in adaptive polling mode
+ */
+#define DATA_BATCH_SIZE		32
+#define DATA_MAX_SKIP		64
+/* Event vectors of the data path tests */
+#define DATA_VECTOR_SZ		8
+#define DATA_VECTOR_TMO_NS	(100 * 1000 * 1000ULL)
+#define DATA_VECTOR_WAIT_S	5
+
 struct event_eth_rx_adapter_test_params {
 	struct rte_mempool *mp;
 	uint16_t rx_rings, tx_rings;
@@ -676,6 +701,671 @@ adapter_stats(void)
 	return TEST_SUCCESS;
 }
 
+static int
+adapter_event_vector(void)
+{
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	struct rte_mempool *vp, *small_vp;
+	struct rte_event ev;
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+					 &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR))
+		return TEST_SKIPPED;
+
+	err = rte_event_eth_rx_adapter_vector_limits_get(TEST_DEV_ID,
+						TEST_ETHDEV_ID, NULL);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_vector_limits_get(TEST_DEV_ID,
+						TEST_ETHDEV_ID, &limits);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT(limits.min_sz <= limits.max_sz &&
+		    limits.min_timeout_ns <= limits.max_timeout_ns,
+		    "Invalid vector limits");
+
+	vp = rte_event_vector_pool_create("rx_adapter_vector", 64, 0,
+					limits.max_sz, rte_socket_id());
+	TEST_ASSERT(vp != NULL, "Failed to create vector pool %d", rte_errno);
+	small_vp = rte_event_vector_pool_create("rx_adapter_small_vector", 64,
+					0, limits.min_sz, rte_socket_id());
+	TEST_ASSERT(small_vp != NULL, "Failed to create vector pool %d",
+		    rte_errno);
+
+	memset(&ev, 0, sizeof(ev));
+	ev.queue_id = 0;
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	ev.priority = 0;
+
+	queue_config.rx_queue_flags =
+		RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR;
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+
+	vec_conf.vector_sz = limits.max_sz;
+	vec_conf.vector_timeout_ns = limits.min_timeout_ns;
+	vec_conf.vector_mp = vp;
+
+	/* Queues not added with the event vector flag */
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, NULL);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	vec_conf.vector_sz = limits.max_sz + 1;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	vec_conf.vector_sz = limits.max_sz;
+	vec_conf.vector_timeout_ns = limits.max_timeout_ns + 1;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	/* Vector pool elements too small for the vector size */
+	vec_conf.vector_timeout_ns = limits.min_timeout_ns;
+	vec_conf.vector_mp = small_vp;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	vec_conf.vector_mp = vp;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, -1, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	rte_mempool_free(small_vp);
+	rte_mempool_free(vp);
+
+	return TEST_SUCCESS;
+}
+
+static int
+adapter_poll_mode(void)
+{
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	struct rte_event_eth_rx_adapter_queue_stats q_stats;
+	struct rte_event ev;
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_rx_adapter_poll_mode_set(TEST_INST_ID,
+				RTE_EVENT_ETH_RX_ADAPTER_POLL_ADAPTIVE);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_poll_mode_set(TEST_INST_ID,
+				RTE_EVENT_ETH_RX_ADAPTER_POLL_ADAPTIVE + 1);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_poll_mode_set(1,
+				RTE_EVENT_ETH_RX_ADAPTER_POLL_WRR);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_caps_get(TEST_DEV_ID, TEST_ETHDEV_ID,
+					 &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Queue not added */
+	err = rte_event_eth_rx_adapter_queue_stats_get(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &q_stats);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	memset(&ev, 0, sizeof(ev));
+	ev.queue_id = 0;
+	ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	ev.priority = 0;
+
+	queue_config.rx_queue_flags = 0;
+	queue_config.ev = ev;
+	queue_config.servicing_weight = 1;
+
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1, &queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_stats_get(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, NULL);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_stats_get(TEST_INST_ID,
+					TEST_ETHDEV_ID, 0, &q_stats);
+	if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT) {
+		TEST_ASSERT(err == -ENOTSUP, "Expected -ENOTSUP got %d", err);
+	} else {
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+		TEST_ASSERT(q_stats.rx_packets == 0 &&
+			    q_stats.rx_poll_count == 0,
+			    "Expected zero queue stats");
+
+		err = rte_event_eth_rx_adapter_queue_stats_reset(TEST_INST_ID,
+						TEST_ETHDEV_ID, 0);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	}
+
+	err = rte_event_eth_rx_adapter_queue_stats_reset(TEST_INST_ID,
+					TEST_ETHDEV_ID, MAX_NUM_RX_QUEUE);
+	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
+
+	err = rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, TEST_ETHDEV_ID,
+						-1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_poll_mode_set(TEST_INST_ID,
+				RTE_EVENT_ETH_RX_ADAPTER_POLL_WRR);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return TEST_SUCCESS;
+}
+
+#ifdef RX_ADAPTER_DATA_TESTS
+struct event_eth_rx_adapter_data_params {
+	struct rte_mempool *mp;
+	struct rte_ring *rx_r[DATA_NB_QUEUE];
+	struct rte_ring *tx_r;
+	uint16_t eth_port;
+	uint8_t evdev_id;
+	uint32_t evdev_sid;
+	uint32_t rxa_sid;
+};
+
+static struct event_eth_rx_adapter_data_params data_params;
+
+static int
+data_conf_cb(uint8_t id, uint8_t dev_id,
+	     struct rte_event_eth_rx_adapter_conf *conf, void *arg)
+{
+	RTE_SET_USED(id);
+	RTE_SET_USED(dev_id);
+	RTE_SET_USED(arg);
+
+	/* Port 0 dequeues the events, port 1 is the adapter's */
+	conf->event_port_id = 1;
+	conf->max_nb_rx = DATA_MAX_NB_RX;
+	return 0;
+}
+
+static int
+data_testsuite_setup(void)
+{
+	struct rte_event_dev_info dev_info;
+	struct rte_event_dev_config config;
+	struct rte_event_port_conf p_conf;
+	char name[RTE_RING_NAMESIZE];
+	unsigned int i;
+	int err;
+
+	err = rte_vdev_init("event_sw_rxa", NULL);
+	TEST_ASSERT(err == 0, "Failed to create event_sw_rxa %d", err);
+	err = rte_event_dev_get_dev_id("event_sw_rxa");
+	TEST_ASSERT(err >= 0, "Failed to find event_sw_rxa %d", err);
+	data_params.evdev_id = err;
+
+	err = rte_event_dev_info_get(data_params.evdev_id, &dev_info);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	memset(&config, 0, sizeof(config));
+	config.nb_event_queues = 1;
+	config.nb_event_ports = 2;
+	config.nb_event_queue_flows = dev_info.max_event_queue_flows;
+	config.nb_event_port_dequeue_depth =
+			dev_info.max_event_port_dequeue_depth;
+	config.nb_event_port_enqueue_depth =
+			dev_info.max_event_port_enqueue_depth;
+	config.nb_events_limit = dev_info.max_num_events;
+	err = rte_event_dev_configure(data_params.evdev_id, &config);
+	TEST_ASSERT(err == 0, "Event device initialization failed err %d",
+			err);
+
+	err = rte_event_queue_setup(data_params.evdev_id, 0, NULL);
+	TEST_ASSERT(err == 0, "Event queue setup failed err %d", err);
+
+	memset(&p_conf, 0, sizeof(p_conf));
+	p_conf.new_event_threshold = dev_info.max_num_events;
+	p_conf.dequeue_depth = dev_info.max_event_port_dequeue_depth;
+	p_conf.enqueue_depth = dev_info.max_event_port_enqueue_depth;
+	for (i = 0; i < config.nb_event_ports; i++) {
+		err = rte_event_port_setup(data_params.evdev_id, i, &p_conf);
+		TEST_ASSERT(err == 0, "Event port setup failed err %d", err);
+	}
+	err = rte_event_port_link(data_params.evdev_id, 0, NULL, NULL, 0);
+	TEST_ASSERT(err == 1, "Event port link failed err %d", err);
+
+	err = rte_event_dev_service_id_get(data_params.evdev_id,
+					   &data_params.evdev_sid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_service_runstate_set(data_params.evdev_sid, 1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_service_set_runstate_mapped_check(data_params.evdev_sid, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_dev_start(data_params.evdev_id);
+	TEST_ASSERT(err == 0, "Event device start failed err %d", err);
+
+	data_params.mp = rte_pktmbuf_pool_create("rxa_data_pool",
+						 DATA_NB_MBUF, MBUF_CACHE_SIZE,
+						 MBUF_PRIV_SIZE,
+						 RTE_MBUF_DEFAULT_BUF_SIZE,
+						 rte_socket_id());
+	TEST_ASSERT(data_params.mp != NULL, "Failed to create mbuf pool");
+
+	for (i = 0; i < DATA_NB_QUEUE; i++) {
+		snprintf(name, sizeof(name), "rxa_data_rx%u", i);
+		data_params.rx_r[i] = rte_ring_create(name, DATA_RING_SIZE,
+						rte_socket_id(),
+						RING_F_SP_ENQ | RING_F_SC_DEQ);
+		TEST_ASSERT(data_params.rx_r[i] != NULL,
+			    "Failed to allocate ring");
+	}
+	data_params.tx_r = rte_ring_create("rxa_data_tx", DATA_RING_SIZE,
+					rte_socket_id(),
+					RING_F_SP_ENQ | RING_F_SC_DEQ);
+	TEST_ASSERT(data_params.tx_r != NULL, "Failed to allocate ring");
+
+	err = rte_eth_from_rings("rxa_data", data_params.rx_r, DATA_NB_QUEUE,
+				 &data_params.tx_r, 1, rte_socket_id());
+	TEST_ASSERT(err >= 0, "Port creation failed %d", err);
+	data_params.eth_port = err;
+
+	err = port_init(data_params.eth_port, data_params.mp);
+	TEST_ASSERT(err == 0, "Port initialization failed err %d", err);
+
+	return TEST_SUCCESS;
+}
+
+static void
+data_testsuite_teardown(void)
+{
+	unsigned int i;
+
+	rte_eth_dev_stop(data_params.eth_port);
+	rte_vdev_uninit("net_ring_rxa_data");
+	for (i = 0; i < DATA_NB_QUEUE; i++)
+		rte_ring_free(data_params.rx_r[i]);
+	rte_ring_free(data_params.tx_r);
+
+	rte_event_dev_stop(data_params.evdev_id);
+	rte_vdev_uninit("event_sw_rxa");
+
+	rte_mempool_free(data_params.mp);
+	memset(&data_params, 0, sizeof(data_params));
+}
+
+static int
+data_adapter_create(void)
+{
+	int err;
+
+	err = rte_event_eth_rx_adapter_create_ext(TEST_INST_ID,
+					data_params.evdev_id, data_conf_cb,
+					NULL);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return err;
+}
+
+static void
+data_adapter_free(void)
+{
+	rte_event_eth_rx_adapter_stop(TEST_INST_ID);
+	rte_event_eth_rx_adapter_queue_del(TEST_INST_ID, data_params.eth_port,
+					   -1);
+	rte_event_eth_rx_adapter_free(TEST_INST_ID);
+}
+
+/* Adds the Rx queue, or all of them for -1, and starts the adapter */
+static int
+data_adapter_start(int32_t rx_queue_id, uint32_t rx_queue_flags)
+{
+	struct rte_event_eth_rx_adapter_queue_conf queue_config;
+	int err;
+
+	memset(&queue_config, 0, sizeof(queue_config));
+	queue_config.rx_queue_flags = rx_queue_flags;
+	queue_config.ev.queue_id = 0;
+	queue_config.ev.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	queue_config.servicing_weight = 1;
+
+	err = rte_event_eth_rx_adapter_queue_add(TEST_INST_ID,
+					data_params.eth_port, rx_queue_id,
+					&queue_config);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_service_id_get(TEST_INST_ID,
+						&data_params.rxa_sid);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_service_runstate_set(data_params.rxa_sid, 1);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = rte_service_set_runstate_mapped_check(data_params.rxa_sid, 0);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	err = rte_event_eth_rx_adapter_start(TEST_INST_ID);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return TEST_SUCCESS;
+}
+
+/* Puts n packets on an Rx queue, returning them in m if not NULL */
+static int
+data_rx_inject(uint16_t rx_queue_id, struct rte_mbuf **m, uint16_t n)
+{
+	struct rte_mbuf *pkts[DATA_RING_SIZE];
+	uint16_t i;
+
+	if (n > RTE_DIM(pkts) ||
+	    rte_pktmbuf_alloc_bulk(data_params.mp, pkts, n) != 0)
+		return -ENOMEM;
+
+	for (i = 0; i < n; i++) {
+		memset(rte_pktmbuf_append(pkts[i], DATA_PKT_LEN), 0,
+		       DATA_PKT_LEN);
+		if (m != NULL)
+			m[i] = pkts[i];
+	}
+
+	if (rte_ring_enqueue_bulk(data_params.rx_r[rx_queue_id],
+				  (void **)pkts, n, NULL) != n) {
+		rte_pktmbuf_free_bulk(pkts, n);
+		return -ENOSPC;
+	}
+
+	return 0;
+}
+
+/*
+ * Runs the adapter service once, then the event device until the events
+ * the adapter enqueued are dequeued, returns the number of events stored
+ * in ev.
+ */
+static uint16_t
+data_service_run(struct rte_event *ev, uint16_t max_ev)
+{
+	uint16_t nb_ev = 0;
+	unsigned int i;
+
+	rte_service_run_iter_on_app_lcore(data_params.rxa_sid, 0);
+	for (i = 0; i < DATA_SCHED_ITER; i++) {
+		rte_service_run_iter_on_app_lcore(data_params.evdev_sid, 0);
+		nb_ev += rte_event_dequeue_burst(data_params.evdev_id, 0,
+						 &ev[nb_ev], max_ev - nb_ev, 0);
+	}
+
+	return nb_ev;
+}
+
+static void
+data_events_free(struct rte_event *ev, uint16_t nb_ev)
+{
+	uint16_t i;
+
+	for (i = 0; i < nb_ev; i++) {
+		if (ev[i].event_type == RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR) {
+			rte_pktmbuf_free_bulk(ev[i].vec->mbufs,
+					      ev[i].vec->nb_elem);
+			rte_mempool_put(rte_mempool_from_obj(ev[i].vec),
+					ev[i].vec);
+		} else {
+			rte_pktmbuf_free(ev[i].mbuf);
+		}
+	}
+}
+
+/* Runs the adapter service once, returns the events dequeued after it */
+static uint16_t
+data_service_run_free(void)
+{
+	struct rte_event ev[DATA_NB_EVENT];
+	uint16_t nb_ev;
+
+	nb_ev = data_service_run(ev, RTE_DIM(ev));
+	data_events_free(ev, nb_ev);
+
+	return nb_ev;
+}
+
+static int
+data_queue_stats(uint16_t rx_queue_id,
+		 struct rte_event_eth_rx_adapter_queue_stats *q_stats)
+{
+	int err;
+
+	err = rte_event_eth_rx_adapter_queue_stats_get(TEST_INST_ID,
+				data_params.eth_port, rx_queue_id, q_stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * Idle Rx queues back off, a queue getting traffic again is polled within
+ * the longest back off and then at every round, while a backlog raises
+ * its share of the bursts.
+ */
+static int
+adapter_poll_adaptive_traffic(void)
+{
+	struct rte_event_eth_rx_adapter_queue_stats q_stats[DATA_NB_QUEUE];
+	struct rte_event_eth_rx_adapter_queue_stats q0_stats;
+	uint64_t nb_rx, max_rx;
+	unsigned int i, q;
+	int err;
+
+	err = rte_event_eth_rx_adapter_poll_mode_set(TEST_INST_ID,
+				RTE_EVENT_ETH_RX_ADAPTER_POLL_ADAPTIVE);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	err = data_adapter_start(-1, 0);
+	TEST_ASSERT(err == 0, "Failed to start the adapter");
+
+	/* No traffic: the skips grow up to the longest back off */
+	for (i = 0; i < 4 * DATA_MAX_SKIP; i++)
+		data_service_run_free();
+	for (q = 0; q < DATA_NB_QUEUE; q++) {
+		TEST_ASSERT_SUCCESS(data_queue_stats(q, &q_stats[q]),
+				    "Failed to get queue stats");
+		TEST_ASSERT(q_stats[q].rx_poll_count <= 16,
+			    "Idle queue %u polled %" PRIu64 " times", q,
+			    q_stats[q].rx_poll_count);
+		TEST_ASSERT(q_stats[q].rx_skip_count >= 2 * DATA_MAX_SKIP,
+			    "Idle queue %u skipped %" PRIu64 " rounds", q,
+			    q_stats[q].rx_skip_count);
+	}
+
+	/* Traffic on queue 0: picked up within the longest back off */
+	TEST_ASSERT_SUCCESS(data_rx_inject(0, NULL, DATA_BATCH_SIZE),
+			    "Failed to inject packets");
+	for (i = 0; i <= DATA_MAX_SKIP + 1; i++) {
+		nb_rx = data_service_run_free();
+		if (nb_rx != 0)
+			break;
+	}
+	TEST_ASSERT_EQUAL(nb_rx, DATA_BATCH_SIZE,
+			  "Got %" PRIu64 " events after %u rounds", nb_rx, i);
+
+	/* Busy queue 0 is polled every round, the idle ones stay skipped */
+	for (q = 0; q < DATA_NB_QUEUE; q++)
+		TEST_ASSERT_SUCCESS(data_queue_stats(q, &q_stats[q]),
+				    "Failed to get queue stats");
+	for (i = 0; i < DATA_MAX_SKIP; i++) {
+		TEST_ASSERT_SUCCESS(data_rx_inject(0, NULL, DATA_BATCH_SIZE),
+				    "Failed to inject packets");
+		nb_rx = data_service_run_free();
+		TEST_ASSERT_EQUAL(nb_rx, DATA_BATCH_SIZE,
+				  "Round %u: got %" PRIu64 " events", i, nb_rx);
+	}
+	for (q = 0; q < DATA_NB_QUEUE; q++) {
+		struct rte_event_eth_rx_adapter_queue_stats s;
+
+		TEST_ASSERT_SUCCESS(data_queue_stats(q, &s),
+				    "Failed to get queue stats");
+		nb_rx = s.rx_poll_count - q_stats[q].rx_poll_count;
+		if (q == 0)
+			TEST_ASSERT(nb_rx >= DATA_MAX_SKIP,
+				    "Busy queue polled %" PRIu64 " times",
+				    nb_rx);
+		else
+			TEST_ASSERT(nb_rx <= 2,
+				    "Idle queue %u polled %" PRIu64 " times",
+				    q, nb_rx);
+	}
+
+	/* Backlog on queue 0: its turns grow past a single burst */
+	TEST_ASSERT_SUCCESS(data_queue_stats(0, &q0_stats),
+			    "Failed to get queue stats");
+	TEST_ASSERT_SUCCESS(data_rx_inject(0, NULL, 16 * DATA_BATCH_SIZE),
+			    "Failed to inject packets");
+	max_rx = 0;
+	for (i = 0; i < 16; i++)
+		max_rx = RTE_MAX(max_rx, (uint64_t)data_service_run_free());
+	TEST_ASSERT_SUCCESS(data_queue_stats(0, &q_stats[0]),
+			    "Failed to get queue stats");
+	TEST_ASSERT_EQUAL(q_stats[0].rx_packets - q0_stats.rx_packets,
+			  16 * DATA_BATCH_SIZE, "Backlog not drained");
+	TEST_ASSERT(max_rx > DATA_BATCH_SIZE,
+		    "Busy queue not boosted, %" PRIu64 " events per round",
+		    max_rx);
+
+	/* Traffic on idle queue 3 is picked up as well */
+	TEST_ASSERT_SUCCESS(data_rx_inject(3, NULL, DATA_BATCH_SIZE),
+			    "Failed to inject packets");
+	for (i = 0; i <= DATA_MAX_SKIP + 1; i++) {
+		nb_rx = data_service_run_free();
+		if (nb_rx != 0)
+			break;
+	}
+	TEST_ASSERT_EQUAL(nb_rx, DATA_BATCH_SIZE,
+			  "Got %" PRIu64 " events after %u rounds", nb_rx, i);
+
+	return TEST_SUCCESS;
+}
+
+/* Checks a vector event holds the n mbufs of m from Rx queue rx_queue_id */
+static int
+data_vector_check(struct rte_event *ev, uint16_t rx_queue_id,
+		  struct rte_mbuf **m, uint16_t n)
+{
+	uint16_t i;
+
+	TEST_ASSERT_EQUAL(ev->event_type,
+			  RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR,
+			  "Unexpected event type %u", ev->event_type);
+	TEST_ASSERT_EQUAL(ev->vec->nb_elem, n, "Vector of %u mbufs, not %u",
+			  ev->vec->nb_elem, n);
+	TEST_ASSERT(ev->vec->attr_valid &&
+		    ev->vec->port == data_params.eth_port &&
+		    ev->vec->queue == rx_queue_id,
+		    "Invalid vector attributes");
+	for (i = 0; i < n; i++)
+		TEST_ASSERT(ev->vec->mbufs[i] == m[i],
+			    "Unexpected mbuf %u in the vector", i);
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * An Rx queue's mbufs fill vectors that are enqueued once full, while the
+ * vector left partially filled is only enqueued after its timeout.
+ */
+static int
+adapter_vector_traffic(void)
+{
+	struct rte_event_eth_rx_adapter_event_vector_config vec_conf;
+	struct rte_mbuf *m[2 * DATA_VECTOR_SZ + DATA_VECTOR_SZ / 2];
+	struct rte_event ev[DATA_NB_EVENT];
+	uint64_t tmo_cycles, start, deadline;
+	struct rte_mempool *vp;
+	uint16_t nb_ev;
+	uint32_t cap;
+	int err;
+
+	err = rte_event_eth_rx_adapter_caps_get(data_params.evdev_id,
+						data_params.eth_port, &cap);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR))
+		return TEST_SKIPPED;
+
+	vp = rte_event_vector_pool_create("rxa_data_vector", 64, 0,
+					  DATA_VECTOR_SZ, rte_socket_id());
+	TEST_ASSERT(vp != NULL, "Failed to create vector pool %d", rte_errno);
+
+	err = data_adapter_start(1,
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR);
+	TEST_ASSERT(err == 0, "Failed to start the adapter");
+
+	vec_conf.vector_sz = DATA_VECTOR_SZ;
+	vec_conf.vector_timeout_ns = DATA_VECTOR_TMO_NS;
+	vec_conf.vector_mp = vp;
+	err = rte_event_eth_rx_adapter_queue_event_vector_config(TEST_INST_ID,
+					data_params.eth_port, 1, &vec_conf);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+
+	/* Two full vectors are enqueued at once, in the Rx order */
+	TEST_ASSERT_SUCCESS(data_rx_inject(1, m, RTE_DIM(m)),
+			    "Failed to inject packets");
+	tmo_cycles = DATA_VECTOR_TMO_NS * rte_get_tsc_hz() / NS_PER_S;
+	start = rte_get_tsc_cycles();
+	deadline = start + DATA_VECTOR_WAIT_S * rte_get_tsc_hz();
+
+	nb_ev = data_service_run(ev, RTE_DIM(ev));
+	TEST_ASSERT_EQUAL(nb_ev, 2, "Got %u vector events, expected 2", nb_ev);
+	TEST_ASSERT_SUCCESS(data_vector_check(&ev[0], 1, m, DATA_VECTOR_SZ),
+			    "Invalid first vector");
+	TEST_ASSERT_SUCCESS(data_vector_check(&ev[1], 1, &m[DATA_VECTOR_SZ],
+					      DATA_VECTOR_SZ),
+			    "Invalid second vector");
+	data_events_free(ev, nb_ev);
+
+	/* The rest of the mbufs wait in a vector for its timeout */
+	do {
+		nb_ev = data_service_run(ev, RTE_DIM(ev));
+	} while (nb_ev == 0 && rte_get_tsc_cycles() < deadline);
+	TEST_ASSERT(rte_get_tsc_cycles() - start >= tmo_cycles,
+		    "Partial vector enqueued before its timeout");
+	TEST_ASSERT_EQUAL(nb_ev, 1, "Got %u vector events, expected 1", nb_ev);
+	TEST_ASSERT_SUCCESS(data_vector_check(&ev[0], 1, &m[2 * DATA_VECTOR_SZ],
+					      DATA_VECTOR_SZ / 2),
+			    "Invalid partial vector");
+	data_events_free(ev, nb_ev);
+
+	rte_mempool_free(vp);
+
+	return TEST_SUCCESS;
+}
+
+static struct unit_test_suite event_eth_rx_data_tests = {
+	.suite_name = "rx event eth adapter data path test suite",
+	.setup = data_testsuite_setup,
+	.teardown = data_testsuite_teardown,
+	.unit_test_cases = {
+		TEST_CASE_ST(data_adapter_create, data_adapter_free,
+			     adapter_poll_adaptive_traffic),
+		TEST_CASE_ST(data_adapter_create, data_adapter_free,
+			     adapter_vector_traffic),
+		TEST_CASES_END() /**< NULL terminate unit test array */
+	}
+};
+#endif
+
 static struct unit_test_suite event_eth_rx_tests = {
 	.suite_name = "rx event eth adapter test suite",
 	.setup = testsuite_setup,
@@ -688,6 +1378,9 @@ static struct unit_test_suite event_eth_rx_tests = {
 					adapter_multi_eth_add_del),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_start_stop),
 		TEST_CASE_ST(adapter_create, adapter_free, adapter_stats),
+		TEST_CASE_ST(adapter_create, adapter_free,
+					adapter_event_vector),
+		TEST_CASE_ST(adapter_create, adapter_free, adapter_poll_mode),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -706,7 +1399,15 @@ static struct unit_test_suite event_eth_rx_intr_tests = {
 static int
 test_event_eth_rx_adapter_common(void)
 {
-	return unit_test_suite_runner(&event_eth_rx_tests);
+	int ret = 0;
+
+	/* Before adapter_multi_eth_add_del takes all the free ethdev ports */
+#ifdef RX_ADAPTER_DATA_TESTS
+	ret = unit_test_suite_runner(&event_eth_rx_data_tests);
+#endif
+	if (ret == 0)
+		ret = unit_test_suite_runner(&event_eth_rx_tests);
+	return ret;
 }
 
 static int
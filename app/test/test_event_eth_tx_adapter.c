@@ -31,6 +31,8 @@
 #define TEST_ETHDEV_PAIR_ID	PORT(PAIR_PORT_INDEX(0))
 
 #define EDEV_RETRY		0xffff
+#define VECTOR_SIZE		32
+#define NB_VECTOR		8
 
 struct event_eth_tx_adapter_test_params {
 	struct rte_mempool *mp;
@@ -457,9 +459,79 @@ tx_adapter_single(uint16_t port, uint16_t tx_queue_id,
 	return -1;
 }
 
+static int
+tx_adapter_vector(struct rte_mempool *vp, uint16_t port, uint16_t tx_queue_id,
+		struct rte_mbuf **m, uint16_t n, uint8_t qid, int attr_valid)
+{
+	struct rte_event_vector *vec;
+	struct rte_event event;
+	struct rte_mbuf *r[VECTOR_SIZE];
+	unsigned int l;
+	uint16_t nb_rx;
+	uint16_t i;
+	int ret;
+
+	ret = rte_mempool_get(vp, (void **)&vec);
+	TEST_ASSERT_SUCCESS(ret, "Failed to get event vector");
+
+	vec->nb_elem = n;
+	vec->attr_valid = attr_valid;
+	vec->port = port;
+	vec->queue = tx_queue_id;
+	for (i = 0; i < n; i++) {
+		m[i]->port = port;
+		rte_event_eth_tx_adapter_txq_set(m[i], tx_queue_id);
+		vec->mbufs[i] = m[i];
+	}
+
+	memset(&event, 0, sizeof(event));
+	event.queue_id = qid;
+	event.op = RTE_EVENT_OP_NEW;
+	event.event_type = RTE_EVENT_TYPE_CPU_VECTOR;
+	event.sched_type = RTE_SCHED_TYPE_ATOMIC;
+	event.vec = vec;
+
+	l = 0;
+	while (rte_event_enqueue_burst(TEST_DEV_ID, 0, &event, 1) != 1) {
+		l++;
+		if (l > EDEV_RETRY)
+			break;
+	}
+
+	TEST_ASSERT(l < EDEV_RETRY, "Unable to enqueue to eventdev");
+	nb_rx = 0;
+	l = 0;
+	while (nb_rx < n && l++ < EDEV_RETRY) {
+
+		if (eid != ~0ULL) {
+			ret = rte_service_run_iter_on_app_lcore(eid, 0);
+			TEST_ASSERT(ret == 0, "failed to run service %d", ret);
+		}
+
+		ret = rte_service_run_iter_on_app_lcore(tid, 0);
+		TEST_ASSERT(ret == 0, "failed to run service %d", ret);
+
+		nb_rx += rte_eth_rx_burst(TEST_ETHDEV_PAIR_ID, tx_queue_id,
+					&r[nb_rx], n - nb_rx);
+	}
+
+	TEST_ASSERT_EQUAL(nb_rx, n, "Expected %u packets received %u",
+			n, nb_rx);
+	for (i = 0; i < n; i++)
+		TEST_ASSERT_EQUAL(r[i], m[i], "mbuf comparison failed"
+				" expected %p received %p", m[i], r[i]);
+
+	/* The adapter returns the vector to its pool */
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(vp), NB_VECTOR,
+			"Event vector not freed");
+
+	return 0;
+}
+
 static int
 tx_adapter_service(void)
 {
+	struct rte_mempool *vp;
 	struct rte_event_eth_tx_adapter_stats stats;
 	uint32_t i;
 	int err;
@@ -616,6 +688,31 @@ tx_adapter_service(void)
 			0,
 			stats.tx_packets);
 
+	vp = rte_event_vector_pool_create("tx_adapter_vector", NB_VECTOR, 0,
+					VECTOR_SIZE, SOCKET0);
+	TEST_ASSERT(vp != NULL, "Failed to create vector pool %d", rte_errno);
+
+	for (i = 0; i < RING_SIZE; i++)
+		pbufs[i] = &bufs[i];
+	for (q = 0; q < MAX_NUM_QUEUE; q++) {
+		/* Port and queue from the vector, then from the mbufs */
+		err = tx_adapter_vector(vp, TEST_ETHDEV_ID, q, pbufs,
+					VECTOR_SIZE, ev_qid, 1);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+		err = tx_adapter_vector(vp, TEST_ETHDEV_ID, q, pbufs,
+					VECTOR_SIZE, ev_qid, 0);
+		TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	}
+
+	rte_mempool_free(vp);
+
+	err = rte_event_eth_tx_adapter_stats_get(TEST_INST_ID, &stats);
+	TEST_ASSERT(err == 0, "Expected 0 got %d", err);
+	TEST_ASSERT_EQUAL(stats.tx_packets, 2 * MAX_NUM_QUEUE * VECTOR_SIZE,
+			"stats.tx_packets expected %u got %"PRIu64,
+			2 * MAX_NUM_QUEUE * VECTOR_SIZE,
+			stats.tx_packets);
+
 	err = rte_event_eth_tx_adapter_stats_get(1, &stats);
 	TEST_ASSERT(err == -EINVAL, "Expected -EINVAL got %d", err);
 
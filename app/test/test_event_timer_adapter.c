@@ -281,7 +281,7 @@ test_port_conf_cb(uint16_t id, uint8_t event_dev_id, uint8_t *event_port_id,
 }
 
 static int
-_timdev_setup(uint64_t max_tmo_ns, uint64_t bkt_tck_ns)
+_timdev_setup(uint64_t max_tmo_ns, uint64_t bkt_tck_ns, uint64_t flags)
 {
 	struct rte_event_timer_adapter_info info;
 	struct rte_event_timer_adapter_conf config = {
@@ -290,7 +290,7 @@ _timdev_setup(uint64_t max_tmo_ns, uint64_t bkt_tck_ns)
 		.timer_tick_ns = bkt_tck_ns,
 		.max_tmo_ns = max_tmo_ns,
 		.nb_timers = MAX_TIMERS * 10,
-		.flags = RTE_EVENT_TIMER_ADAPTER_F_ADJUST_RES,
+		.flags = RTE_EVENT_TIMER_ADAPTER_F_ADJUST_RES | flags,
 	};
 	uint32_t caps = 0;
 	const char *pool_name = "timdev_test_pool";
@@ -338,9 +338,9 @@ timdev_setup_usec(void)
 {
 	return using_services ?
 		/* Max timeout is 10,000us and bucket interval is 100us */
-		_timdev_setup(1E7, 1E5) :
+		_timdev_setup(1E7, 1E5, 0) :
 		/* Max timeout is 100us and bucket interval is 1us */
-		_timdev_setup(1E5, 1E3);
+		_timdev_setup(1E5, 1E3, 0);
 }
 
 static int
@@ -348,30 +348,44 @@ timdev_setup_usec_multicore(void)
 {
 	return using_services ?
 		/* Max timeout is 10,000us and bucket interval is 100us */
-		_timdev_setup(1E7, 1E5) :
+		_timdev_setup(1E7, 1E5, 0) :
 		/* Max timeout is 100us and bucket interval is 1us */
-		_timdev_setup(1E5, 1E3);
+		_timdev_setup(1E5, 1E3, 0);
 }
 
 static int
 timdev_setup_msec(void)
 {
 	/* Max timeout is 2 mins, and bucket interval is 100 ms */
-	return _timdev_setup(180 * NSECPERSEC, NSECPERSEC / 10);
+	return _timdev_setup(180 * NSECPERSEC, NSECPERSEC / 10, 0);
+}
+
+static int
+timdev_setup_msec_batched(void)
+{
+	/* Same as timdev_setup_msec, with the batched software adapter */
+	return _timdev_setup(180 * NSECPERSEC, NSECPERSEC / 10,
+			     RTE_EVENT_TIMER_ADAPTER_F_BATCHED);
+}
+
+static int
+timdev_setup_sec_batched(void)
+{
+	return _timdev_setup(1E11, 1E9, RTE_EVENT_TIMER_ADAPTER_F_BATCHED);
 }
 
 static int
 timdev_setup_sec(void)
 {
 	/* Max timeout is 100sec and bucket interval is 1sec */
-	return _timdev_setup(1E11, 1E9);
+	return _timdev_setup(1E11, 1E9, 0);
 }
 
 static int
 timdev_setup_sec_multicore(void)
 {
 	/* Max timeout is 100sec and bucket interval is 1sec */
-	return _timdev_setup(1E11, 1E9);
+	return _timdev_setup(1E11, 1E9, 0);
 }
 
 static void
@@ -1027,7 +1041,7 @@ static int
 adapter_start(void)
 {
 	TEST_ASSERT_SUCCESS(_timdev_setup(180 * NSECPERSEC,
-			NSECPERSEC / 10),
+			NSECPERSEC / 10, 0),
 			"Failed to start adapter");
 	TEST_ASSERT_EQUAL(rte_event_timer_adapter_start(timdev), -EALREADY,
 			"Timer adapter started without call to stop.");
@@ -1831,6 +1845,24 @@ static struct unit_test_suite event_timer_adptr_functional_testsuite  = {
 		TEST_CASE_ST(timdev_setup_msec, timdev_teardown,
 				adapter_tick_resolution),
 		TEST_CASE(adapter_create_max),
+		TEST_CASE_ST(timdev_setup_sec_batched, timdev_teardown,
+				test_timer_cancel_random),
+		TEST_CASE_ST(timdev_setup_msec_batched, timdev_teardown,
+				stat_inc_reset_ev_enq),
+		TEST_CASE_ST(timdev_setup_msec_batched, timdev_teardown,
+			     event_timer_arm),
+		TEST_CASE_ST(timdev_setup_msec_batched, timdev_teardown,
+			     event_timer_arm_double),
+		TEST_CASE_ST(timdev_setup_msec_batched, timdev_teardown,
+			     event_timer_arm_expiry),
+		TEST_CASE_ST(timdev_setup_msec_batched, timdev_teardown,
+				event_timer_arm_rearm),
+		TEST_CASE_ST(timdev_setup_msec_batched, timdev_teardown,
+				event_timer_arm_invalid_timeout),
+		TEST_CASE_ST(timdev_setup_msec_batched, timdev_teardown,
+				event_timer_cancel),
+		TEST_CASE_ST(timdev_setup_msec_batched, timdev_teardown,
+				event_timer_cancel_double),
 		TEST_CASES_END() /**< NULL terminate unit test array */
 	}
 };
@@ -0,0 +1,902 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_vxlan.h>
+#include <rte_mbuf.h>
+#include <rte_gro.h>
+
+#include "test.h"
+
+#define GRO_ETH_LEN       sizeof(struct rte_ether_hdr)
+#define GRO_IPV4_LEN      sizeof(struct rte_ipv4_hdr)
+#define GRO_IPV6_LEN      sizeof(struct rte_ipv6_hdr)
+#define GRO_IPV6_EXT_LEN  8
+#define GRO_TCP_LEN       sizeof(struct rte_tcp_hdr)
+#define GRO_VXLAN_LEN     (sizeof(struct rte_udp_hdr) + \
+	sizeof(struct rte_vxlan_hdr) + GRO_ETH_LEN)
+#define GRO_HDR_MAX_LEN   128
+
+#define GRO_TCP_PYLD_LEN  100
+#define GRO_SENT_SEQ      1000
+
+/* TCP/IPv6 version, traffic class and flow label */
+#define GRO_VTC_FLOW(tc, label) \
+	((6U << 28) | ((uint32_t)(tc) << 20) | (label))
+
+/* UDP/IPv4 datagram of three fragments */
+#define GRO_FRAG_LEN      400
+#define GRO_DGRAM_LEN     (3 * GRO_FRAG_LEN)
+
+/*
+ * GRO context of GRO_TBL_FLOWS items, flows and hash buckets. The flows
+ * of a test differ in their (outer) Ethernet source address only, which
+ * isn't hashed, so they all share one hash value and bucket.
+ */
+#define GRO_TBL_FLOWS     8
+
+#define NB_MBUF           64
+
+static struct rte_mempool *pkt_pool;
+
+/* Payload pattern, which differs between flows */
+static uint8_t
+gro_pyld_byte(uint32_t flow, uint32_t offset)
+{
+	return (uint8_t)(offset * 7 + flow * 13 + 3);
+}
+
+/*
+ * Allocate a packet made of the given headers and pyld_len payload
+ * bytes, which follow the pattern of the flow from pyld_off.
+ */
+static struct rte_mbuf *
+gro_pkt_build(const uint8_t *hdr, uint16_t hdr_len, uint32_t flow,
+	uint32_t pyld_off, uint16_t pyld_len)
+{
+	struct rte_mbuf *m;
+	uint8_t *data;
+	uint16_t i;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	data = (uint8_t *)rte_pktmbuf_append(m, hdr_len + pyld_len);
+	if (data == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+
+	memcpy(data, hdr, hdr_len);
+	for (i = 0; i < pyld_len; i++)
+		data[hdr_len + i] = gro_pyld_byte(flow, pyld_off + i);
+
+	return m;
+}
+
+/*
+ * Check that a packet holds hdr_len header bytes, then pyld_len payload
+ * bytes following the pattern of the flow from pyld_off, over all its
+ * segments.
+ */
+static int
+gro_pyld_check(struct rte_mbuf *m, uint16_t hdr_len, uint32_t flow,
+	uint32_t pyld_off, uint32_t pyld_len)
+{
+	struct rte_mbuf *seg;
+	uint32_t k = 0;
+	uint16_t j;
+
+	if (m->pkt_len != hdr_len + pyld_len || m->data_len < hdr_len)
+		return -1;
+
+	for (seg = m; seg != NULL; seg = seg->next)
+		for (j = (seg == m) ? hdr_len : 0; j < seg->data_len; j++, k++)
+			if (*rte_pktmbuf_mtod_offset(seg, uint8_t *, j) !=
+					gro_pyld_byte(flow, pyld_off + k))
+				return -1;
+
+	return (k == pyld_len) ? 0 : -1;
+}
+
+static void
+gro_eth_hdr_build(struct rte_ether_hdr *eth, uint32_t flow,
+	uint16_t ether_type)
+{
+	memset(eth, 0, sizeof(*eth));
+	eth->d_addr.addr_bytes[0] = 0x02;
+	eth->d_addr.addr_bytes[5] = 0x01;
+	eth->s_addr.addr_bytes[0] = 0x02;
+	eth->s_addr.addr_bytes[4] = (uint8_t)(flow >> 8);
+	eth->s_addr.addr_bytes[5] = (uint8_t)flow;
+	eth->ether_type = rte_cpu_to_be_16(ether_type);
+}
+
+static void
+gro_tcp_hdr_build(struct rte_tcp_hdr *tcp, uint32_t seq)
+{
+	memset(tcp, 0, sizeof(*tcp));
+	tcp->src_port = rte_cpu_to_be_16(1234);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(seq);
+	tcp->recv_ack = rte_cpu_to_be_32(1);
+	tcp->data_off = (GRO_TCP_LEN / 4) << 4;
+	tcp->tcp_flags = RTE_TCP_ACK_FLAG;
+	tcp->rx_win = rte_cpu_to_be_16(0xffff);
+}
+
+static void
+gro_ipv4_hdr_build(struct rte_ipv4_hdr *ip, uint8_t proto, uint16_t len,
+	uint16_t ip_id, uint16_t frag_off)
+{
+	memset(ip, 0, sizeof(*ip));
+	ip->version_ihl = RTE_IPV4_VHL_DEF;
+	ip->total_length = rte_cpu_to_be_16(GRO_IPV4_LEN + len);
+	ip->packet_id = rte_cpu_to_be_16(ip_id);
+	ip->fragment_offset = rte_cpu_to_be_16(frag_off);
+	ip->time_to_live = 64;
+	ip->next_proto_id = proto;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(192, 168, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(192, 168, 0, 2));
+}
+
+/* Build a TCP/IPv4 segment of the flow */
+static struct rte_mbuf *
+gro_tcp4_pkt_build(uint32_t flow, uint32_t seq, uint16_t pyld_len)
+{
+	uint8_t hdr[GRO_HDR_MAX_LEN];
+	struct rte_mbuf *m;
+
+	gro_eth_hdr_build((struct rte_ether_hdr *)hdr, flow,
+		RTE_ETHER_TYPE_IPV4);
+	gro_ipv4_hdr_build((struct rte_ipv4_hdr *)(hdr + GRO_ETH_LEN),
+		IPPROTO_TCP, GRO_TCP_LEN + pyld_len, 0, RTE_IPV4_HDR_DF_FLAG);
+	gro_tcp_hdr_build((struct rte_tcp_hdr *)(hdr + GRO_ETH_LEN +
+		GRO_IPV4_LEN), seq);
+
+	m = gro_pkt_build(hdr, GRO_ETH_LEN + GRO_IPV4_LEN + GRO_TCP_LEN, flow,
+		seq, pyld_len);
+	if (m == NULL)
+		return NULL;
+
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		RTE_PTYPE_L4_TCP;
+	m->l2_len = GRO_ETH_LEN;
+	m->l3_len = GRO_IPV4_LEN;
+	m->l4_len = GRO_TCP_LEN;
+
+	return m;
+}
+
+/* Build a VxLAN packet of the flow, carrying a TCP/IPv4 segment */
+static struct rte_mbuf *
+gro_vxlan_pkt_build(uint32_t flow, uint32_t seq, uint16_t pyld_len)
+{
+	const uint16_t inner_len = GRO_IPV4_LEN + GRO_TCP_LEN + pyld_len;
+	uint8_t hdr[GRO_HDR_MAX_LEN];
+	struct rte_vxlan_hdr *vxlan;
+	struct rte_udp_hdr *udp;
+	struct rte_mbuf *m;
+	uint8_t *p = hdr;
+
+	gro_eth_hdr_build((struct rte_ether_hdr *)p, flow,
+		RTE_ETHER_TYPE_IPV4);
+	p += GRO_ETH_LEN;
+	gro_ipv4_hdr_build((struct rte_ipv4_hdr *)p, IPPROTO_UDP,
+		GRO_VXLAN_LEN + inner_len, 0, RTE_IPV4_HDR_DF_FLAG);
+	p += GRO_IPV4_LEN;
+
+	udp = (struct rte_udp_hdr *)p;
+	udp->src_port = rte_cpu_to_be_16(5000);
+	udp->dst_port = rte_cpu_to_be_16(RTE_VXLAN_DEFAULT_PORT);
+	udp->dgram_len = rte_cpu_to_be_16(GRO_VXLAN_LEN + inner_len);
+	udp->dgram_cksum = 0;
+	vxlan = (struct rte_vxlan_hdr *)(udp + 1);
+	vxlan->vx_flags = rte_cpu_to_be_32(0x08000000);
+	vxlan->vx_vni = rte_cpu_to_be_32(100 << 8);
+	p = (uint8_t *)(vxlan + 1);
+
+	gro_eth_hdr_build((struct rte_ether_hdr *)p, 0, RTE_ETHER_TYPE_IPV4);
+	p += GRO_ETH_LEN;
+	gro_ipv4_hdr_build((struct rte_ipv4_hdr *)p, IPPROTO_TCP,
+		GRO_TCP_LEN + pyld_len, 0, RTE_IPV4_HDR_DF_FLAG);
+	p += GRO_IPV4_LEN;
+	gro_tcp_hdr_build((struct rte_tcp_hdr *)p, seq);
+	p += GRO_TCP_LEN;
+
+	m = gro_pkt_build(hdr, p - hdr, flow, seq, pyld_len);
+	if (m == NULL)
+		return NULL;
+
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		RTE_PTYPE_L4_UDP | RTE_PTYPE_TUNNEL_VXLAN |
+		RTE_PTYPE_INNER_L2_ETHER | RTE_PTYPE_INNER_L3_IPV4 |
+		RTE_PTYPE_INNER_L4_TCP;
+	m->outer_l2_len = GRO_ETH_LEN;
+	m->outer_l3_len = GRO_IPV4_LEN;
+	m->l2_len = GRO_VXLAN_LEN;
+	m->l3_len = GRO_IPV4_LEN;
+	m->l4_len = GRO_TCP_LEN;
+
+	return m;
+}
+
+/*
+ * Build a TCP/IPv6 segment of the flow, optionally with a hop-by-hop
+ * options header.
+ */
+static struct rte_mbuf *
+gro_tcp6_pkt_build(uint32_t flow, uint32_t vtc_flow, uint32_t seq,
+	uint16_t pyld_len, int ext)
+{
+	uint8_t hdr[GRO_HDR_MAX_LEN];
+	uint16_t l3_len = GRO_IPV6_LEN + (ext ? GRO_IPV6_EXT_LEN : 0);
+	struct rte_ipv6_hdr *ip6;
+	struct rte_mbuf *m;
+	uint8_t *opt;
+	uint32_t i;
+
+	gro_eth_hdr_build((struct rte_ether_hdr *)hdr, flow,
+		RTE_ETHER_TYPE_IPV6);
+
+	ip6 = (struct rte_ipv6_hdr *)(hdr + GRO_ETH_LEN);
+	ip6->vtc_flow = rte_cpu_to_be_32(vtc_flow);
+	ip6->payload_len = rte_cpu_to_be_16(l3_len - GRO_IPV6_LEN +
+		GRO_TCP_LEN + pyld_len);
+	ip6->proto = ext ? 0 : IPPROTO_TCP;
+	ip6->hop_limits = 64;
+	for (i = 0; i < sizeof(ip6->src_addr); i++) {
+		ip6->src_addr[i] = i;
+		ip6->dst_addr[i] = 0x80 | i;
+	}
+
+	/* Hop-by-hop options header, padded with a PadN option */
+	if (ext) {
+		opt = (uint8_t *)(ip6 + 1);
+		opt[0] = IPPROTO_TCP;
+		opt[1] = 0;
+		opt[2] = 1;
+		opt[3] = GRO_IPV6_EXT_LEN - 4;
+		memset(opt + 4, 0, GRO_IPV6_EXT_LEN - 4);
+	}
+
+	gro_tcp_hdr_build((struct rte_tcp_hdr *)(hdr + GRO_ETH_LEN + l3_len),
+		seq);
+
+	m = gro_pkt_build(hdr, GRO_ETH_LEN + l3_len + GRO_TCP_LEN, flow, seq,
+		pyld_len);
+	if (m == NULL)
+		return NULL;
+
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L4_TCP |
+		(ext ? RTE_PTYPE_L3_IPV6_EXT : RTE_PTYPE_L3_IPV6);
+	m->l2_len = GRO_ETH_LEN;
+	m->l3_len = l3_len;
+	m->l4_len = GRO_TCP_LEN;
+
+	return m;
+}
+
+/*
+ * Build a fragment of a UDP/IPv4 datagram, whose bytes from frag_off on
+ * follow the payload pattern of the IPv4 ID. GRO doesn't parse the UDP
+ * header, so the pattern stands in for it.
+ */
+static struct rte_mbuf *
+gro_udp4_frag_build(uint16_t ip_id, uint16_t frag_off, uint16_t len,
+	int more_frags)
+{
+	uint8_t hdr[GRO_HDR_MAX_LEN];
+	struct rte_mbuf *m;
+
+	gro_eth_hdr_build((struct rte_ether_hdr *)hdr, 0,
+		RTE_ETHER_TYPE_IPV4);
+
+	gro_ipv4_hdr_build((struct rte_ipv4_hdr *)(hdr + GRO_ETH_LEN),
+		IPPROTO_UDP, len, ip_id,
+		(frag_off / RTE_IPV4_HDR_OFFSET_UNITS) |
+		(more_frags ? RTE_IPV4_HDR_MF_FLAG : 0));
+
+	m = gro_pkt_build(hdr, GRO_ETH_LEN + GRO_IPV4_LEN, ip_id, frag_off,
+		len);
+	if (m == NULL)
+		return NULL;
+
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		((more_frags || frag_off) ? RTE_PTYPE_L4_FRAG :
+		 RTE_PTYPE_L4_UDP);
+	m->l2_len = GRO_ETH_LEN;
+	m->l3_len = GRO_IPV4_LEN;
+
+	return m;
+}
+
+static int
+gro_pool_check_full(void)
+{
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(pkt_pool), NB_MBUF,
+		"%u mbufs leaked\n",
+		NB_MBUF - rte_mempool_avail_count(pkt_pool));
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * TCP/IPv6 segments are only merged within a flow of the same traffic
+ * class and flow label, and never when they have extension headers.
+ */
+static int
+test_gro_tcp6_flows(void)
+{
+	const uint32_t vtc_flow = GRO_VTC_FLOW(0x12, 0x12345);
+	const uint32_t vtc_flow_tc = GRO_VTC_FLOW(0x13, 0x12345);
+	const uint32_t vtc_flow_label = GRO_VTC_FLOW(0x12, 0x54321);
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_TCP_IPV6,
+		.max_flow_num = 8,
+		.max_item_per_flow = 8,
+	};
+	struct rte_mbuf *pkts[6];
+	struct rte_ipv6_hdr *ip6;
+	uint32_t seq = GRO_SENT_SEQ;
+	uint32_t i, vtc, found = 0;
+	uint16_t nb_pkts;
+
+	/*
+	 * Each segment after the first one is in sequence with the merged
+	 * packet, so only the flow key keeps it apart.
+	 */
+	pkts[0] = gro_tcp6_pkt_build(0, vtc_flow, seq, GRO_TCP_PYLD_LEN, 0);
+	seq += GRO_TCP_PYLD_LEN;
+	pkts[1] = gro_tcp6_pkt_build(0, vtc_flow, seq, GRO_TCP_PYLD_LEN, 0);
+	seq += GRO_TCP_PYLD_LEN;
+	pkts[2] = gro_tcp6_pkt_build(0, vtc_flow_tc, seq, GRO_TCP_PYLD_LEN,
+		0);
+	pkts[3] = gro_tcp6_pkt_build(0, vtc_flow_label, seq,
+		GRO_TCP_PYLD_LEN, 0);
+	pkts[4] = gro_tcp6_pkt_build(0, vtc_flow, seq, GRO_TCP_PYLD_LEN, 0);
+	seq += GRO_TCP_PYLD_LEN;
+	pkts[5] = gro_tcp6_pkt_build(0, vtc_flow, seq, GRO_TCP_PYLD_LEN, 1);
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		TEST_ASSERT_NOT_NULL(pkts[i], "Cannot build packet %u\n", i);
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, RTE_DIM(pkts), &param);
+	TEST_ASSERT_EQUAL(nb_pkts, 4, "Got %u packets instead of 4\n",
+		nb_pkts);
+
+	for (i = 0; i < nb_pkts; i++) {
+		ip6 = rte_pktmbuf_mtod_offset(pkts[i], struct rte_ipv6_hdr *,
+			GRO_ETH_LEN);
+		vtc = rte_be_to_cpu_32(ip6->vtc_flow);
+
+		if (pkts[i]->l3_len != GRO_IPV6_LEN) {
+			/* Returned as it was */
+			TEST_ASSERT_EQUAL(vtc, vtc_flow,
+				"Wrong extension header packet\n");
+			TEST_ASSERT_SUCCESS(gro_pyld_check(pkts[i],
+				GRO_ETH_LEN + GRO_IPV6_LEN +
+				GRO_IPV6_EXT_LEN + GRO_TCP_LEN, 0,
+				GRO_SENT_SEQ + 3 * GRO_TCP_PYLD_LEN,
+				GRO_TCP_PYLD_LEN),
+				"Extension header packet was merged\n");
+			found |= 1 << 0;
+		} else if (vtc == vtc_flow) {
+			TEST_ASSERT_EQUAL(pkts[i]->nb_segs, 3,
+				"Flow merged %u segments instead of 3\n",
+				pkts[i]->nb_segs);
+			TEST_ASSERT_SUCCESS(gro_pyld_check(pkts[i],
+				GRO_ETH_LEN + GRO_IPV6_LEN + GRO_TCP_LEN, 0,
+				GRO_SENT_SEQ, 3 * GRO_TCP_PYLD_LEN),
+				"Wrong merged payload\n");
+			TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip6->payload_len),
+				GRO_TCP_LEN + 3 * GRO_TCP_PYLD_LEN,
+				"Wrong merged payload_len %u\n",
+				rte_be_to_cpu_16(ip6->payload_len));
+			found |= 1 << 1;
+		} else {
+			/* The traffic class and flow label flows */
+			TEST_ASSERT(vtc == vtc_flow_tc || vtc == vtc_flow_label,
+				"Unexpected vtc_flow 0x%x\n", vtc);
+			TEST_ASSERT_SUCCESS(gro_pyld_check(pkts[i],
+				GRO_ETH_LEN + GRO_IPV6_LEN + GRO_TCP_LEN, 0,
+				GRO_SENT_SEQ + 2 * GRO_TCP_PYLD_LEN,
+				GRO_TCP_PYLD_LEN),
+				"Packet of flow 0x%x was merged\n", vtc);
+			found |= (vtc == vtc_flow_tc) ? 1 << 2 : 1 << 3;
+		}
+	}
+	TEST_ASSERT_EQUAL(found, 0xfU, "Missing packets: 0x%x\n", found);
+
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+
+	return gro_pool_check_full();
+}
+
+/* Check the IPv4 header of a flushed UDP/IPv4 datagram or fragment */
+static int
+gro_udp4_frag_check(struct rte_mbuf *m, uint16_t frag_off, uint16_t len,
+	int more_frags, uint16_t nb_segs)
+{
+	struct rte_ipv4_hdr *ip;
+	uint16_t fo;
+
+	ip = rte_pktmbuf_mtod_offset(m, struct rte_ipv4_hdr *, GRO_ETH_LEN);
+	fo = rte_be_to_cpu_16(ip->fragment_offset);
+
+	TEST_ASSERT_EQUAL(m->nb_segs, nb_segs,
+		"ID %u: %u segments instead of %u\n",
+		rte_be_to_cpu_16(ip->packet_id), m->nb_segs, nb_segs);
+	TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip->total_length),
+		GRO_IPV4_LEN + len, "ID %u: wrong total_length %u\n",
+		rte_be_to_cpu_16(ip->packet_id),
+		rte_be_to_cpu_16(ip->total_length));
+	TEST_ASSERT_EQUAL((fo & RTE_IPV4_HDR_OFFSET_MASK),
+		frag_off / RTE_IPV4_HDR_OFFSET_UNITS,
+		"ID %u: wrong fragment offset %u\n",
+		rte_be_to_cpu_16(ip->packet_id),
+		fo & RTE_IPV4_HDR_OFFSET_MASK);
+	TEST_ASSERT_EQUAL(!!(fo & RTE_IPV4_HDR_MF_FLAG), !!more_frags,
+		"ID %u: wrong MF bit\n", rte_be_to_cpu_16(ip->packet_id));
+	TEST_ASSERT_SUCCESS(gro_pyld_check(m, GRO_ETH_LEN + GRO_IPV4_LEN,
+		rte_be_to_cpu_16(ip->packet_id), frag_off, len),
+		"ID %u: wrong payload\n",
+		rte_be_to_cpu_16(ip->packet_id));
+
+	return TEST_SUCCESS;
+}
+
+/*
+ * UDP/IPv4 fragments arriving out of order are merged, and the offset
+ * and MF bit of partly reassembled datagrams are fixed up on flush.
+ */
+static int
+test_gro_udp4_frags(void)
+{
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_UDP_IPV4,
+		.max_flow_num = 8,
+		.max_item_per_flow = 8,
+	};
+	struct rte_mbuf *pkts[8];
+	struct rte_ipv4_hdr *ip;
+	uint32_t i, found = 0;
+	uint16_t nb_pkts;
+
+	/* ID 1: last, first, then middle fragment, which fills the gap */
+	pkts[0] = gro_udp4_frag_build(1, 2 * GRO_FRAG_LEN, GRO_FRAG_LEN, 0);
+	pkts[1] = gro_udp4_frag_build(1, 0, GRO_FRAG_LEN, 1);
+	/* ID 2: the first two fragments in reverse order */
+	pkts[2] = gro_udp4_frag_build(2, GRO_FRAG_LEN, GRO_FRAG_LEN, 1);
+	pkts[3] = gro_udp4_frag_build(2, 0, GRO_FRAG_LEN, 1);
+	/* ID 3: the last two fragments, the first one missing */
+	pkts[4] = gro_udp4_frag_build(3, 2 * GRO_FRAG_LEN, GRO_FRAG_LEN, 0);
+	pkts[5] = gro_udp4_frag_build(3, GRO_FRAG_LEN, GRO_FRAG_LEN, 1);
+	pkts[6] = gro_udp4_frag_build(1, GRO_FRAG_LEN, GRO_FRAG_LEN, 1);
+	/* ID 4: a datagram which isn't fragmented */
+	pkts[7] = gro_udp4_frag_build(4, 0, GRO_FRAG_LEN, 0);
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		TEST_ASSERT_NOT_NULL(pkts[i], "Cannot build packet %u\n", i);
+
+	nb_pkts = rte_gro_reassemble_burst(pkts, RTE_DIM(pkts), &param);
+	TEST_ASSERT_EQUAL(nb_pkts, 4, "Got %u packets instead of 4\n",
+		nb_pkts);
+
+	for (i = 0; i < nb_pkts; i++) {
+		ip = rte_pktmbuf_mtod_offset(pkts[i], struct rte_ipv4_hdr *,
+			GRO_ETH_LEN);
+		switch (rte_be_to_cpu_16(ip->packet_id)) {
+		case 1:
+			TEST_ASSERT_SUCCESS(gro_udp4_frag_check(pkts[i], 0,
+				GRO_DGRAM_LEN, 0, 3),
+				"Datagram 1 not reassembled\n");
+			break;
+		case 2:
+			TEST_ASSERT_SUCCESS(gro_udp4_frag_check(pkts[i], 0,
+				2 * GRO_FRAG_LEN, 1, 2),
+				"Datagram 2 head not merged\n");
+			break;
+		case 3:
+			TEST_ASSERT_SUCCESS(gro_udp4_frag_check(pkts[i],
+				GRO_FRAG_LEN, 2 * GRO_FRAG_LEN, 0, 2),
+				"Datagram 3 tail not merged\n");
+			break;
+		case 4:
+			TEST_ASSERT_SUCCESS(gro_udp4_frag_check(pkts[i], 0,
+				GRO_FRAG_LEN, 0, 1),
+				"Datagram 4 changed\n");
+			break;
+		default:
+			TEST_ASSERT(0, "Unexpected packet ID %u\n",
+				rte_be_to_cpu_16(ip->packet_id));
+		}
+		found |= 1 << rte_be_to_cpu_16(ip->packet_id);
+	}
+	TEST_ASSERT_EQUAL(found, 0x1eU, "Missing datagrams: 0x%x\n", found);
+
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+
+	return gro_pool_check_full();
+}
+
+/*
+ * Fragments of incomplete UDP/IPv4 datagrams stay in a GRO context until
+ * they time out, and are then flushed as they are.
+ */
+static int
+test_gro_udp4_timeout(void)
+{
+	struct rte_gro_param param = {
+		.gro_types = RTE_GRO_UDP_IPV4,
+		.max_flow_num = 4,
+		.max_item_per_flow = 4,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	struct rte_mbuf *pkts[3], *out[4];
+	struct rte_ipv4_hdr *ip;
+	uint32_t i, found = 0;
+	uint16_t nb_pkts;
+	void *ctx;
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_ASSERT_NOT_NULL(ctx, "Cannot create GRO context\n");
+
+	/* ID 1 lacks its last fragment, ID 2 its first two */
+	pkts[0] = gro_udp4_frag_build(1, GRO_FRAG_LEN, GRO_FRAG_LEN, 1);
+	pkts[1] = gro_udp4_frag_build(1, 0, GRO_FRAG_LEN, 1);
+	pkts[2] = gro_udp4_frag_build(2, 2 * GRO_FRAG_LEN, GRO_FRAG_LEN, 0);
+	for (i = 0; i < RTE_DIM(pkts); i++)
+		if (pkts[i] == NULL)
+			goto fail;
+
+	nb_pkts = rte_gro_reassemble(pkts, RTE_DIM(pkts), ctx);
+	if (nb_pkts != 0) {
+		printf("%u fragments not stored\n", nb_pkts);
+		goto fail;
+	}
+	if (rte_gro_get_pkt_count(ctx) != 2) {
+		printf("%"PRIu64" packets stored instead of 2\n",
+			rte_gro_get_pkt_count(ctx));
+		goto fail;
+	}
+
+	/* Nothing is old enough yet */
+	nb_pkts = rte_gro_timeout_flush(ctx, rte_get_tsc_hz() * 60,
+		RTE_GRO_UDP_IPV4, out, RTE_DIM(out));
+	if (nb_pkts != 0) {
+		printf("%u packets flushed before timeout\n", nb_pkts);
+		rte_pktmbuf_free_bulk(out, nb_pkts);
+		goto fail;
+	}
+
+	nb_pkts = rte_gro_timeout_flush(ctx, 0, RTE_GRO_UDP_IPV4, out,
+		RTE_DIM(out));
+	rte_gro_ctx_destroy(ctx);
+	TEST_ASSERT_EQUAL(nb_pkts, 2, "Flushed %u packets instead of 2\n",
+		nb_pkts);
+
+	for (i = 0; i < nb_pkts; i++) {
+		ip = rte_pktmbuf_mtod_offset(out[i], struct rte_ipv4_hdr *,
+			GRO_ETH_LEN);
+		if (rte_be_to_cpu_16(ip->packet_id) == 1) {
+			TEST_ASSERT_SUCCESS(gro_udp4_frag_check(out[i], 0,
+				2 * GRO_FRAG_LEN, 1, 2),
+				"Datagram 1 head not flushed\n");
+			found |= 1 << 1;
+		} else {
+			TEST_ASSERT_SUCCESS(gro_udp4_frag_check(out[i],
+				2 * GRO_FRAG_LEN, GRO_FRAG_LEN, 0, 1),
+				"Datagram 2 tail not flushed\n");
+			found |= 1 << 2;
+		}
+	}
+	TEST_ASSERT_EQUAL(found, 0x6U, "Missing datagrams: 0x%x\n", found);
+
+	rte_pktmbuf_free_bulk(out, nb_pkts);
+
+	return gro_pool_check_full();
+
+fail:
+	/* Stored fragments are freed along with their pool */
+	rte_gro_ctx_destroy(ctx);
+	return TEST_FAILED;
+}
+
+/* TCP based GRO types, whose tables index flows by hash */
+struct gro_flow_type {
+	const char *name;
+	uint64_t gro_type;
+	uint16_t hdr_len;
+	struct rte_mbuf *(*pkt_build)(uint32_t flow, uint32_t seq,
+		uint16_t pyld_len);
+};
+
+static struct rte_mbuf *
+gro_tcp6_flow_pkt_build(uint32_t flow, uint32_t seq, uint16_t pyld_len)
+{
+	return gro_tcp6_pkt_build(flow, GRO_VTC_FLOW(0, 0), seq, pyld_len, 0);
+}
+
+static const struct gro_flow_type gro_flow_types[] = {
+	{
+		.name = "TCP/IPv4",
+		.gro_type = RTE_GRO_TCP_IPV4,
+		.hdr_len = GRO_ETH_LEN + GRO_IPV4_LEN + GRO_TCP_LEN,
+		.pkt_build = gro_tcp4_pkt_build,
+	},
+	{
+		.name = "TCP/IPv6",
+		.gro_type = RTE_GRO_TCP_IPV6,
+		.hdr_len = GRO_ETH_LEN + GRO_IPV6_LEN + GRO_TCP_LEN,
+		.pkt_build = gro_tcp6_flow_pkt_build,
+	},
+	{
+		.name = "VxLAN",
+		.gro_type = RTE_GRO_IPV4_VXLAN_TCP_IPV4,
+		.hdr_len = GRO_ETH_LEN + GRO_IPV4_LEN + GRO_VXLAN_LEN +
+			GRO_IPV4_LEN + GRO_TCP_LEN,
+		.pkt_build = gro_vxlan_pkt_build,
+	},
+};
+
+/* The flow of a packet, from its (outer) Ethernet source address */
+static uint32_t
+gro_pkt_flow(struct rte_mbuf *m)
+{
+	struct rte_ether_hdr *eth = rte_pktmbuf_mtod(m, struct rte_ether_hdr *);
+
+	return ((uint32_t)eth->s_addr.addr_bytes[4] << 8) |
+		eth->s_addr.addr_bytes[5];
+}
+
+/*
+ * Store packets of the given flows with the given sequence number in a
+ * GRO context, all of them either merged or stored.
+ */
+static int
+gro_flows_reassemble(const struct gro_flow_type *type, void *ctx,
+	const uint32_t *flows, uint32_t nb_flows, uint32_t seq)
+{
+	struct rte_mbuf *pkts[GRO_TBL_FLOWS];
+	uint16_t nb_pkts;
+	uint32_t i;
+
+	for (i = 0; i < nb_flows; i++) {
+		pkts[i] = type->pkt_build(flows[i], seq, GRO_TCP_PYLD_LEN);
+		if (pkts[i] == NULL) {
+			rte_pktmbuf_free_bulk(pkts, i);
+			return -1;
+		}
+	}
+
+	nb_pkts = rte_gro_reassemble(pkts, nb_flows, ctx);
+	if (nb_pkts != 0) {
+		rte_pktmbuf_free_bulk(pkts, nb_pkts);
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Flush the packets stored before timeout_cycles and check that they
+ * are those of the flows in flow_mask, holding nb_segs segments from
+ * the sequence number seq on.
+ */
+static int
+gro_flows_flush(const struct gro_flow_type *type, void *ctx,
+	uint64_t timeout_cycles, uint16_t max_nb_out, uint32_t flow_mask,
+	uint32_t seq, uint16_t nb_segs)
+{
+	struct rte_mbuf *out[GRO_TBL_FLOWS];
+	uint32_t found = 0, flow;
+	uint16_t nb_pkts, i;
+	int ret = 0;
+
+	nb_pkts = rte_gro_timeout_flush(ctx, timeout_cycles, type->gro_type,
+		out, max_nb_out);
+
+	for (i = 0; i < nb_pkts; i++) {
+		flow = gro_pkt_flow(out[i]);
+		if (flow >= 32 || (found & (1U << flow)) ||
+				out[i]->nb_segs != nb_segs ||
+				gro_pyld_check(out[i], type->hdr_len, flow, seq,
+					nb_segs * GRO_TCP_PYLD_LEN) != 0) {
+			printf("%s: wrong packet of flow %u flushed\n",
+				type->name, flow);
+			ret = -1;
+		} else
+			found |= 1U << flow;
+	}
+	rte_pktmbuf_free_bulk(out, nb_pkts);
+
+	if (ret == 0 && found != flow_mask) {
+		printf("%s: flushed flows 0x%x instead of 0x%x\n",
+			type->name, found, flow_mask);
+		ret = -1;
+	}
+
+	return ret;
+}
+
+/*
+ * Fill, merge into, flush and refill the flow table of a GRO context,
+ * all the flows colliding on one hash value. The lookups have to walk
+ * the bucket chain, and the flushes unlink flows at its head, middle
+ * and tail.
+ */
+static int
+test_gro_flow_table(const struct gro_flow_type *type)
+{
+	static const uint32_t flows[] = {0, 1, 2, 3, 4, 5, 6, 7};
+	static const uint32_t flows_rev[] = {7, 6, 5, 4, 3, 2, 1, 0};
+	static const uint32_t flows_reuse[] = {10, 11};
+	static const uint32_t flows_old[] = {12, 13};
+	static const uint32_t flow_new = 14;
+	struct rte_gro_param param = {
+		.gro_types = type->gro_type,
+		.max_flow_num = GRO_TBL_FLOWS / 2,
+		.max_item_per_flow = 2,
+		.socket_id = SOCKET_ID_ANY,
+	};
+	const uint32_t seq = GRO_SENT_SEQ;
+	const uint32_t seq_next = GRO_SENT_SEQ + GRO_TCP_PYLD_LEN;
+	struct rte_mbuf *pkt;
+	uint64_t mid;
+	uint16_t nb_pkts;
+	void *ctx;
+	int ret = TEST_FAILED;
+
+	RTE_BUILD_BUG_ON(RTE_DIM(flows) != GRO_TBL_FLOWS);
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_ASSERT_NOT_NULL(ctx, "%s: cannot create GRO context\n",
+		type->name);
+
+	/* Fill the table, then one flow more is returned */
+	if (gro_flows_reassemble(type, ctx, flows, GRO_TBL_FLOWS, seq) != 0) {
+		printf("%s: flows not stored\n", type->name);
+		goto out;
+	}
+	pkt = type->pkt_build(GRO_TBL_FLOWS, seq, GRO_TCP_PYLD_LEN);
+	if (pkt == NULL)
+		goto out;
+	nb_pkts = rte_gro_reassemble(&pkt, 1, ctx);
+	rte_pktmbuf_free(pkt);
+	if (nb_pkts != 1) {
+		printf("%s: flow stored in a full table\n", type->name);
+		goto out;
+	}
+
+	/* Each next segment finds its own flow in the chain */
+	if (gro_flows_reassemble(type, ctx, flows_rev, GRO_TBL_FLOWS,
+				seq_next) != 0 ||
+			rte_gro_get_pkt_count(ctx) != GRO_TBL_FLOWS) {
+		printf("%s: segments not merged\n", type->name);
+		goto out;
+	}
+	if (gro_flows_flush(type, ctx, 0, GRO_TBL_FLOWS,
+				(1U << GRO_TBL_FLOWS) - 1, seq,
+				2) != 0)
+		goto out;
+
+	/* Reuse the flows and items freed by the flush */
+	if (gro_flows_reassemble(type, ctx, flows_reuse,
+				RTE_DIM(flows_reuse), seq) != 0 ||
+			gro_flows_flush(type, ctx, 0, GRO_TBL_FLOWS,
+				(1U << 10) | (1U << 11), seq, 1) != 0)
+		goto out;
+
+	/*
+	 * Flush the two older flows one at a time, then check that the
+	 * newer one still merges and the flushed ones don't.
+	 */
+	if (gro_flows_reassemble(type, ctx, flows_old, RTE_DIM(flows_old),
+				seq) != 0)
+		goto out;
+	rte_delay_ms(2);
+	mid = rte_rdtsc();
+	rte_delay_ms(2);
+	if (gro_flows_reassemble(type, ctx, &flow_new, 1, seq) != 0)
+		goto out;
+
+	pkt = NULL;
+	nb_pkts = rte_gro_timeout_flush(ctx, rte_rdtsc() - mid,
+		type->gro_type, &pkt, 1);
+	if (nb_pkts != 1 || (gro_pkt_flow(pkt) != flows_old[0] &&
+				gro_pkt_flow(pkt) != flows_old[1])) {
+		printf("%s: timeout flush of a flow failed\n", type->name);
+		rte_pktmbuf_free_bulk(&pkt, nb_pkts);
+		goto out;
+	}
+	if (gro_flows_flush(type, ctx, rte_rdtsc() - mid, GRO_TBL_FLOWS,
+				(1U << flows_old[0]) ^ (1U << flows_old[1]) ^
+				(1U << gro_pkt_flow(pkt)), seq, 1) != 0) {
+		rte_pktmbuf_free(pkt);
+		goto out;
+	}
+	rte_pktmbuf_free(pkt);
+
+	if (rte_gro_get_pkt_count(ctx) != 1 ||
+			gro_flows_reassemble(type, ctx, &flow_new, 1,
+				seq_next) != 0 ||
+			rte_gro_get_pkt_count(ctx) != 1) {
+		printf("%s: segment not merged after timeout flush\n",
+			type->name);
+		goto out;
+	}
+	rte_delay_ms(2);
+	mid = rte_rdtsc();
+	rte_delay_ms(2);
+	if (gro_flows_reassemble(type, ctx, flows_old, 1, seq_next) != 0 ||
+			rte_gro_get_pkt_count(ctx) != 2) {
+		printf("%s: segment merged into a flushed flow\n",
+			type->name);
+		goto out;
+	}
+	if (gro_flows_flush(type, ctx, rte_rdtsc() - mid, GRO_TBL_FLOWS,
+				1U << flow_new, seq, 2) != 0)
+		goto out;
+	if (gro_flows_flush(type, ctx, 0, GRO_TBL_FLOWS, 1U << flows_old[0],
+				seq_next, 1) != 0)
+		goto out;
+
+	ret = TEST_SUCCESS;
+out:
+	/* Stored packets are freed along with their pool */
+	rte_gro_ctx_destroy(ctx);
+	if (ret != TEST_SUCCESS)
+		return ret;
+
+	return gro_pool_check_full();
+}
+
+static int
+test_gro(void)
+{
+	uint32_t i;
+	int ret;
+
+	/* No mempool cache, so that the pool can be checked for leaks */
+	pkt_pool = rte_pktmbuf_pool_create("test_gro_pool", NB_MBUF, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (pkt_pool == NULL) {
+		printf("Error creating mempool\n");
+		return -1;
+	}
+
+	ret = test_gro_tcp6_flows();
+	if (ret != 0)
+		goto out;
+
+	ret = test_gro_udp4_frags();
+	if (ret != 0)
+		goto out;
+
+	ret = test_gro_udp4_timeout();
+	if (ret != 0)
+		goto out;
+
+	for (i = 0; i < RTE_DIM(gro_flow_types); i++) {
+		ret = test_gro_flow_table(&gro_flow_types[i]);
+		if (ret != 0)
+			goto out;
+	}
+
+out:
+	rte_mempool_free(pkt_pool);
+
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(gro_autotest, test_gro);
@@ -0,0 +1,394 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_ether.h>
+#include <rte_ethdev.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_mbuf.h>
+#include <rte_gso.h>
+
+#include "test.h"
+
+#define GSO_HDR_ETH_LEN   sizeof(struct rte_ether_hdr)
+#define GSO_HDR_EXT_LEN   8
+#define GSO_HDR_L3_LEN    (sizeof(struct rte_ipv6_hdr) + GSO_HDR_EXT_LEN)
+#define GSO_HDR_TCP_LEN   sizeof(struct rte_tcp_hdr)
+#define GSO_HDR_LEN       (GSO_HDR_ETH_LEN + GSO_HDR_L3_LEN + GSO_HDR_TCP_LEN)
+
+/* Input packet: headers and 3000 payload bytes in three 1000-byte parts */
+#define GSO_PYLD_PART_LEN 1000
+#define GSO_PYLD_PARTS    3
+#define GSO_PYLD_LEN      (GSO_PYLD_PART_LEN * GSO_PYLD_PARTS)
+
+/* Output segments of 700 payload bytes, some spanning two input parts */
+#define GSO_SEG_PYLD_LEN  700
+#define GSO_NB_SEGS       \
+	((GSO_PYLD_LEN + GSO_SEG_PYLD_LEN - 1) / GSO_SEG_PYLD_LEN)
+
+#define GSO_SENT_SEQ      1000
+#define GSO_TCP_FLAGS     (RTE_TCP_ACK_FLAG | RTE_TCP_PSH_FLAG | \
+	RTE_TCP_FIN_FLAG)
+
+#define NB_MBUF           32
+
+static struct rte_mempool *in_pool;
+static struct rte_mempool *direct_pool;
+static struct rte_mempool *indirect_pool;
+
+static uint8_t
+gso_pyld_byte(uint32_t offset)
+{
+	return (uint8_t)(offset * 7 + 3);
+}
+
+/*
+ * Build a TCP/IPv6 packet with a hop-by-hop options header, whose payload
+ * is split over GSO_PYLD_PARTS segments, the first one also holding the
+ * headers.
+ */
+static struct rte_mbuf *
+gso_tcp6_pkt_build(void)
+{
+	struct rte_ether_hdr *eth;
+	struct rte_ipv6_hdr *ip6;
+	struct rte_tcp_hdr *tcp;
+	struct rte_mbuf *m, *seg;
+	uint8_t *ext, *data;
+	uint32_t i, j;
+
+	m = rte_pktmbuf_alloc(in_pool);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m, GSO_HDR_LEN);
+	memset(eth, 0, GSO_HDR_LEN);
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV6);
+
+	ip6 = (struct rte_ipv6_hdr *)(eth + 1);
+	ip6->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip6->payload_len = rte_cpu_to_be_16(GSO_HDR_EXT_LEN + GSO_HDR_TCP_LEN +
+		GSO_PYLD_LEN);
+	ip6->proto = 0; /* Hop-by-hop options */
+	ip6->hop_limits = 64;
+	for (i = 0; i < sizeof(ip6->src_addr); i++) {
+		ip6->src_addr[i] = i;
+		ip6->dst_addr[i] = 0x80 | i;
+	}
+
+	/* Hop-by-hop options header, padded with a PadN option */
+	ext = (uint8_t *)(ip6 + 1);
+	ext[0] = IPPROTO_TCP;
+	ext[1] = 0;
+	ext[2] = 1;
+	ext[3] = GSO_HDR_EXT_LEN - 4;
+
+	tcp = (struct rte_tcp_hdr *)(ext + GSO_HDR_EXT_LEN);
+	tcp->src_port = rte_cpu_to_be_16(1234);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(GSO_SENT_SEQ);
+	tcp->data_off = (GSO_HDR_TCP_LEN / 4) << 4;
+	tcp->tcp_flags = GSO_TCP_FLAGS;
+
+	for (i = 0; i < GSO_PYLD_PARTS; i++) {
+		seg = (i == 0) ? m : rte_pktmbuf_alloc(in_pool);
+		if (seg == NULL)
+			goto fail;
+
+		data = (uint8_t *)rte_pktmbuf_append(seg, GSO_PYLD_PART_LEN);
+		if (data == NULL ||
+				(seg != m && rte_pktmbuf_chain(m, seg) != 0)) {
+			if (seg != m)
+				rte_pktmbuf_free(seg);
+			goto fail;
+		}
+		for (j = 0; j < GSO_PYLD_PART_LEN; j++)
+			data[j] = gso_pyld_byte(i * GSO_PYLD_PART_LEN + j);
+	}
+
+	m->ol_flags = PKT_TX_TCP_SEG | PKT_TX_IPV6;
+	m->l2_len = GSO_HDR_ETH_LEN;
+	m->l3_len = GSO_HDR_L3_LEN;
+	m->l4_len = GSO_HDR_TCP_LEN;
+
+	return m;
+
+fail:
+	rte_pktmbuf_free(m);
+	return NULL;
+}
+
+/*
+ * Check that all the objects of a pool are back in it exactly once: a
+ * double free would leave a duplicate, a leak a missing object.
+ */
+static int
+gso_pool_check_full(struct rte_mempool *mp)
+{
+	void *objs[NB_MBUF + 1];
+	uint32_t n, i, j;
+	int ret = 0;
+
+	for (n = 0; n < RTE_DIM(objs); n++)
+		if (rte_mempool_get(mp, &objs[n]) != 0)
+			break;
+
+	if (n != mp->size)
+		ret = -1;
+	for (i = 0; i < n; i++)
+		for (j = i + 1; j < n; j++)
+			if (objs[i] == objs[j])
+				ret = -1;
+
+	rte_mempool_put_bulk(mp, objs, n);
+	if (ret != 0)
+		printf("%s: %u objects out of %u\n", mp->name, n, mp->size);
+
+	return ret;
+}
+
+static int
+gso_pools_check_full(void)
+{
+	TEST_ASSERT_SUCCESS(gso_pool_check_full(in_pool),
+		"Input mbufs leaked or freed twice\n");
+	TEST_ASSERT_SUCCESS(gso_pool_check_full(direct_pool),
+		"Direct mbufs leaked or freed twice\n");
+	TEST_ASSERT_SUCCESS(gso_pool_check_full(indirect_pool),
+		"Indirect mbufs leaked or freed twice\n");
+
+	return TEST_SUCCESS;
+}
+
+static void
+gso_ctx_init(struct rte_gso_ctx *ctx)
+{
+	memset(ctx, 0, sizeof(*ctx));
+	ctx->direct_pool = direct_pool;
+	ctx->indirect_pool = indirect_pool;
+	ctx->gso_types = DEV_TX_OFFLOAD_TCP_TSO;
+	ctx->gso_size = GSO_HDR_LEN + GSO_SEG_PYLD_LEN;
+}
+
+static int
+test_gso_tcp6_segments(void)
+{
+	struct rte_mbuf *pkt, *segs[GSO_NB_SEGS + 1], *m;
+	const struct rte_ipv6_hdr *ip6, *ip6_in;
+	const struct rte_tcp_hdr *tcp;
+	struct rte_gso_ctx ctx;
+	uint8_t hdr_in[GSO_HDR_LEN];
+	uint32_t offset, pyld_len, i, j, k;
+	uint8_t tcp_flags;
+	int ret;
+
+	pkt = gso_tcp6_pkt_build();
+	TEST_ASSERT_NOT_NULL(pkt, "Cannot build the input packet\n");
+	memcpy(hdr_in, rte_pktmbuf_mtod(pkt, void *), GSO_HDR_LEN);
+	ip6_in = (const struct rte_ipv6_hdr *)(hdr_in + GSO_HDR_ETH_LEN);
+
+	gso_ctx_init(&ctx);
+	ret = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	TEST_ASSERT_EQUAL(ret, GSO_NB_SEGS, "Got %d segments instead of %d\n",
+		ret, GSO_NB_SEGS);
+
+	offset = 0;
+	for (i = 0; i < GSO_NB_SEGS; i++) {
+		m = segs[i];
+		pyld_len = RTE_MIN((uint32_t)GSO_SEG_PYLD_LEN, GSO_PYLD_LEN - offset);
+
+		TEST_ASSERT_EQUAL(m->pkt_len, GSO_HDR_LEN + pyld_len,
+			"Segment %u: wrong length %u\n", i, m->pkt_len);
+		TEST_ASSERT_EQUAL(m->data_len, GSO_HDR_LEN,
+			"Segment %u: headers not in the first mbuf\n", i);
+
+		/* Headers copied, including the extension header */
+		ip6 = rte_pktmbuf_mtod_offset(m, const struct rte_ipv6_hdr *,
+			GSO_HDR_ETH_LEN);
+		TEST_ASSERT_BUFFERS_ARE_EQUAL(rte_pktmbuf_mtod(m, void *),
+			hdr_in, GSO_HDR_ETH_LEN,
+			"Segment %u: wrong Ethernet header\n", i);
+		TEST_ASSERT_EQUAL(ip6->vtc_flow, ip6_in->vtc_flow,
+			"Segment %u: wrong IPv6 header\n", i);
+		TEST_ASSERT_BUFFERS_ARE_EQUAL(&ip6->proto, &ip6_in->proto,
+			GSO_HDR_L3_LEN - offsetof(struct rte_ipv6_hdr, proto),
+			"Segment %u: wrong IPv6 headers\n", i);
+
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip6->payload_len),
+			GSO_HDR_EXT_LEN + GSO_HDR_TCP_LEN + pyld_len,
+			"Segment %u: wrong payload_len %u\n", i,
+			rte_be_to_cpu_16(ip6->payload_len));
+
+		tcp = rte_pktmbuf_mtod_offset(m, const struct rte_tcp_hdr *,
+			GSO_HDR_ETH_LEN + GSO_HDR_L3_LEN);
+		TEST_ASSERT_BUFFERS_ARE_EQUAL(tcp, hdr_in + GSO_HDR_ETH_LEN +
+			GSO_HDR_L3_LEN, offsetof(struct rte_tcp_hdr, sent_seq),
+			"Segment %u: wrong TCP ports\n", i);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_32(tcp->sent_seq),
+			GSO_SENT_SEQ + offset, "Segment %u: wrong seq %u\n",
+			i, rte_be_to_cpu_32(tcp->sent_seq));
+
+		/* PSH and FIN only on the last segment */
+		tcp_flags = (i == GSO_NB_SEGS - 1) ? GSO_TCP_FLAGS :
+			RTE_TCP_ACK_FLAG;
+		TEST_ASSERT_EQUAL(tcp->tcp_flags, tcp_flags,
+			"Segment %u: wrong TCP flags 0x%x\n", i,
+			tcp->tcp_flags);
+
+		/* Payload */
+		k = 0;
+		for (m = m->next; m != NULL; m = m->next)
+			for (j = 0; j < m->data_len; j++, k++)
+				TEST_ASSERT_EQUAL(
+					*rte_pktmbuf_mtod_offset(m, uint8_t *,
+					j), gso_pyld_byte(offset + k),
+					"Segment %u: wrong payload byte %u\n",
+					i, k);
+		TEST_ASSERT_EQUAL(k, pyld_len,
+			"Segment %u: wrong payload length %u\n", i, k);
+
+		offset += pyld_len;
+	}
+
+	/* The input mbufs go back to their pool with the last segment */
+	rte_pktmbuf_free_bulk(segs, GSO_NB_SEGS);
+
+	return gso_pools_check_full();
+}
+
+static int
+test_gso_tcp6_nomem(void)
+{
+	struct rte_mbuf *pkt, *segs[GSO_NB_SEGS + 1], *seg;
+	struct rte_mbuf *held[NB_MBUF];
+	struct rte_gso_ctx ctx;
+	uint32_t n_held;
+	int ret;
+
+	pkt = gso_tcp6_pkt_build();
+	TEST_ASSERT_NOT_NULL(pkt, "Cannot build the input packet\n");
+
+	/* Leave room for the first two output segments only */
+	for (n_held = 0; n_held < NB_MBUF; n_held++) {
+		held[n_held] = rte_pktmbuf_alloc(indirect_pool);
+		if (held[n_held] == NULL)
+			break;
+	}
+	rte_pktmbuf_free_bulk(held + n_held - 3, 3);
+	n_held -= 3;
+
+	gso_ctx_init(&ctx);
+	ret = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+	rte_pktmbuf_free_bulk(held, n_held);
+	TEST_ASSERT_EQUAL(ret, -ENOMEM, "Segmentation returned %d\n", ret);
+
+	/* The input packet is left as it was */
+	TEST_ASSERT_EQUAL(pkt->ol_flags, (PKT_TX_TCP_SEG | PKT_TX_IPV6),
+		"Input packet flags changed\n");
+	TEST_ASSERT_EQUAL(pkt->pkt_len, GSO_HDR_LEN + GSO_PYLD_LEN,
+		"Input packet length changed\n");
+	for (seg = pkt; seg != NULL; seg = seg->next)
+		TEST_ASSERT_EQUAL(rte_mbuf_refcnt_read(seg), 1,
+			"Input mbuf still referenced\n");
+
+	rte_pktmbuf_free(pkt);
+
+	return gso_pools_check_full();
+}
+
+/*
+ * Tunneled packets with an inner TCP/IPv6 segment aren't supported and
+ * must be passed through untouched, not segmented as plain TCP/IPv6.
+ */
+static int
+test_gso_tcp6_tunnel(void)
+{
+	static const uint64_t tunnel_flags[] = {
+		PKT_TX_TUNNEL_VXLAN | PKT_TX_OUTER_IPV4,
+		PKT_TX_TUNNEL_VXLAN | PKT_TX_OUTER_IPV6,
+		PKT_TX_TUNNEL_GRE | PKT_TX_OUTER_IPV4,
+		PKT_TX_TUNNEL_GRE | PKT_TX_OUTER_IPV6,
+	};
+	struct rte_mbuf *pkt, *segs[GSO_NB_SEGS + 1];
+	struct rte_gso_ctx ctx;
+	uint8_t hdr_in[GSO_HDR_LEN];
+	uint64_t ol_flags;
+	uint32_t i;
+	int ret;
+
+	gso_ctx_init(&ctx);
+	ctx.gso_types |= DEV_TX_OFFLOAD_VXLAN_TNL_TSO |
+		DEV_TX_OFFLOAD_GRE_TNL_TSO;
+
+	for (i = 0; i < RTE_DIM(tunnel_flags); i++) {
+		pkt = gso_tcp6_pkt_build();
+		TEST_ASSERT_NOT_NULL(pkt, "Cannot build the input packet\n");
+		ol_flags = pkt->ol_flags | tunnel_flags[i];
+		pkt->ol_flags = ol_flags;
+		pkt->outer_l2_len = GSO_HDR_ETH_LEN;
+		pkt->outer_l3_len = sizeof(struct rte_ipv6_hdr);
+		memcpy(hdr_in, rte_pktmbuf_mtod(pkt, void *), GSO_HDR_LEN);
+
+		ret = rte_gso_segment(pkt, &ctx, segs, RTE_DIM(segs));
+		TEST_ASSERT_EQUAL(ret, 1, "Tunnel %u: got %d segments\n", i, ret);
+		TEST_ASSERT_EQUAL(segs[0], pkt,
+			"Tunnel %u: input packet not passed through\n", i);
+		TEST_ASSERT_EQUAL(pkt->ol_flags, ol_flags,
+			"Tunnel %u: input packet flags changed\n", i);
+		TEST_ASSERT_EQUAL(pkt->pkt_len, GSO_HDR_LEN + GSO_PYLD_LEN,
+			"Tunnel %u: input packet length changed\n", i);
+		TEST_ASSERT_BUFFERS_ARE_EQUAL(rte_pktmbuf_mtod(pkt, void *),
+			hdr_in, GSO_HDR_LEN,
+			"Tunnel %u: input packet headers changed\n", i);
+		TEST_ASSERT_EQUAL(rte_mbuf_refcnt_read(pkt), 1,
+			"Tunnel %u: input mbuf still referenced\n", i);
+
+		rte_pktmbuf_free(pkt);
+	}
+
+	return gso_pools_check_full();
+}
+
+static int
+test_gso(void)
+{
+	int ret;
+
+	/* No mempool cache, so that the pools can be checked for leaks */
+	in_pool = rte_pktmbuf_pool_create("test_gso_in", NB_MBUF, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	direct_pool = rte_pktmbuf_pool_create("test_gso_direct", NB_MBUF, 0,
+		0, RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	indirect_pool = rte_pktmbuf_pool_create("test_gso_indirect", NB_MBUF,
+		0, 0, 0, SOCKET_ID_ANY);
+
+	ret = -1;
+	if (in_pool == NULL || direct_pool == NULL || indirect_pool == NULL) {
+		printf("Error creating mempools\n");
+		goto out;
+	}
+
+	ret = test_gso_tcp6_segments();
+	if (ret != 0)
+		goto out;
+
+	ret = test_gso_tcp6_nomem();
+	if (ret != 0)
+		goto out;
+
+	ret = test_gso_tcp6_tunnel();
+
+out:
+	rte_mempool_free(indirect_pool);
+	rte_mempool_free(direct_pool);
+	rte_mempool_free(in_pool);
+
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(gso_autotest, test_gso);
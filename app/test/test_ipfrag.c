@@ -0,0 +1,602 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_ip.h>
+#include <rte_ip_frag.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+
+#include "test.h"
+
+#define NUM_MBUFS		1024
+#define BURST			32
+
+/* every datagram is made of 3 fragments, the last one shorter */
+#define FRAG_NB			3
+#define FRAG_LEN		1024
+#define FRAG_LAST_LEN		512
+#define DGRAM_LEN		((FRAG_NB - 1) * FRAG_LEN + FRAG_LAST_LEN)
+
+#define TBL_BUCKETS		64
+#define TBL_BUCKET_ENTRIES	4
+#define TBL_MAX_ENTRIES		256
+#define TBL_MAX_CYCLES		100
+
+/* a burst of datagrams spans several groups of the bulk functions */
+#define BULK_NB_DGRAMS		16
+
+/* concurrent use of a shared table */
+#define SHARED_NB_DGRAMS	256
+#define SHARED_NB_ROUNDS	4
+#define SHARED_BUCKETS		512
+#define SHARED_MAX_ENTRIES	512
+
+#define IPV4_HDR_LEN	sizeof(struct rte_ipv4_hdr)
+#define IPV6_HDR_LEN	sizeof(struct rte_ipv6_hdr)
+#define IPV6_FRAG_HDR_LEN \
+	(IPV6_HDR_LEN + sizeof(struct ipv6_extension_fragment))
+
+static struct rte_mempool *pkt_pool;
+
+static inline uint8_t
+pattern(uint16_t id, uint32_t pos)
+{
+	return (uint8_t)(id * 7 + pos);
+}
+
+/*
+ * Build an IPv4 or IPv6 packet holding bytes [ofs, ofs + len) of datagram
+ * id. It is a fragment unless it holds the whole datagram. The id is also
+ * stored in the source address, where it is still found after reassembly.
+ */
+static struct rte_mbuf *
+pkt_build(int ipv6, uint16_t id, uint16_t ofs, uint16_t len, int mf)
+{
+	struct ipv6_extension_fragment *frag_hdr;
+	struct rte_ipv4_hdr *ip4;
+	struct rte_ipv6_hdr *ip6;
+	struct rte_mbuf *m;
+	uint8_t *data;
+	uint32_t hdr_len, i;
+	int is_frag;
+
+	m = rte_pktmbuf_alloc(pkt_pool);
+	if (m == NULL)
+		return NULL;
+
+	is_frag = ofs != 0 || mf;
+	if (!ipv6)
+		hdr_len = IPV4_HDR_LEN;
+	else if (is_frag)
+		hdr_len = IPV6_FRAG_HDR_LEN;
+	else
+		hdr_len = IPV6_HDR_LEN;
+
+	data = (uint8_t *)rte_pktmbuf_append(m, hdr_len + len);
+	if (data == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+	memset(data, 0, hdr_len);
+
+	if (ipv6) {
+		ip6 = (struct rte_ipv6_hdr *)data;
+		ip6->vtc_flow = rte_cpu_to_be_32(6 << 28);
+		ip6->payload_len = rte_cpu_to_be_16(hdr_len - IPV6_HDR_LEN +
+			len);
+		ip6->proto = is_frag ? IPPROTO_FRAGMENT : IPPROTO_UDP;
+		ip6->hop_limits = 64;
+		ip6->src_addr[14] = id >> 8;
+		ip6->src_addr[15] = id & 0xff;
+		ip6->dst_addr[15] = 1;
+		if (is_frag) {
+			frag_hdr = (struct ipv6_extension_fragment *)(ip6 + 1);
+			frag_hdr->next_header = IPPROTO_UDP;
+			frag_hdr->frag_data = rte_cpu_to_be_16(
+				RTE_IPV6_SET_FRAG_DATA(ofs, mf ? 1 : 0));
+			frag_hdr->id = rte_cpu_to_be_32(id);
+		}
+	} else {
+		ip4 = (struct rte_ipv4_hdr *)data;
+		ip4->version_ihl = RTE_IPV4_VHL_DEF;
+		ip4->total_length = rte_cpu_to_be_16(hdr_len + len);
+		ip4->packet_id = rte_cpu_to_be_16(id);
+		ip4->fragment_offset = rte_cpu_to_be_16(
+			(ofs / RTE_IPV4_HDR_OFFSET_UNITS) |
+			(mf ? RTE_IPV4_HDR_MF_FLAG : 0));
+		ip4->time_to_live = 64;
+		ip4->next_proto_id = IPPROTO_UDP;
+		ip4->src_addr = rte_cpu_to_be_32(RTE_IPV4(10, 0, id >> 8,
+			id & 0xff));
+		ip4->dst_addr = rte_cpu_to_be_32(RTE_IPV4(10, 1, 0, 1));
+	}
+
+	for (i = 0; i < len; i++)
+		data[hdr_len + i] = pattern(id, ofs + i);
+
+	m->l2_len = 0;
+	m->l3_len = hdr_len;
+
+	return m;
+}
+
+/* Build fragment idx of datagram id */
+static struct rte_mbuf *
+frag_build(int ipv6, uint16_t id, uint32_t idx)
+{
+	if (idx == FRAG_NB - 1)
+		return pkt_build(ipv6, id, idx * FRAG_LEN, FRAG_LAST_LEN, 0);
+
+	return pkt_build(ipv6, id, idx * FRAG_LEN, FRAG_LEN, 1);
+}
+
+static int
+pkt_is_ipv6(const struct rte_mbuf *m)
+{
+	return (*rte_pktmbuf_mtod(m, const uint8_t *) >> 4) == 6;
+}
+
+static uint16_t
+pkt_id(const struct rte_mbuf *m)
+{
+	const struct rte_ipv6_hdr *ip6;
+	const struct rte_ipv4_hdr *ip4;
+
+	if (pkt_is_ipv6(m)) {
+		ip6 = rte_pktmbuf_mtod(m, const struct rte_ipv6_hdr *);
+		return (ip6->src_addr[14] << 8) | ip6->src_addr[15];
+	}
+
+	ip4 = rte_pktmbuf_mtod(m, const struct rte_ipv4_hdr *);
+	return rte_be_to_cpu_16(ip4->packet_id);
+}
+
+/* Check a reassembled datagram: headers, length and payload */
+static int
+dgram_check(const struct rte_mbuf *m, int ipv6)
+{
+	const struct rte_ipv4_hdr *ip4;
+	const struct rte_ipv6_hdr *ip6;
+	uint8_t buf[DGRAM_LEN];
+	const uint8_t *p;
+	uint32_t hdr_len, i;
+	uint16_t id;
+
+	TEST_ASSERT_EQUAL(pkt_is_ipv6(m), ipv6, "Wrong IP version\n");
+	id = pkt_id(m);
+	hdr_len = ipv6 ? IPV6_HDR_LEN : IPV4_HDR_LEN;
+	TEST_ASSERT_EQUAL(m->pkt_len, hdr_len + DGRAM_LEN,
+		"Datagram %u: wrong length %u\n", id, m->pkt_len);
+
+	if (ipv6) {
+		ip6 = rte_pktmbuf_mtod(m, const struct rte_ipv6_hdr *);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip6->payload_len),
+			DGRAM_LEN, "Datagram %u: wrong payload length\n", id);
+		TEST_ASSERT_EQUAL(ip6->proto, IPPROTO_UDP,
+			"Datagram %u: fragment header not removed\n", id);
+	} else {
+		ip4 = rte_pktmbuf_mtod(m, const struct rte_ipv4_hdr *);
+		TEST_ASSERT_EQUAL(rte_be_to_cpu_16(ip4->total_length),
+			hdr_len + DGRAM_LEN,
+			"Datagram %u: wrong total length\n", id);
+		TEST_ASSERT(!rte_ipv4_frag_pkt_is_fragmented(ip4),
+			"Datagram %u: still a fragment\n", id);
+	}
+
+	p = rte_pktmbuf_read(m, hdr_len, DGRAM_LEN, buf);
+	TEST_ASSERT_NOT_NULL(p, "Datagram %u: cannot read payload\n", id);
+	for (i = 0; i < DGRAM_LEN; i++)
+		TEST_ASSERT_EQUAL(p[i], pattern(id, i),
+			"Datagram %u: wrong payload byte %u\n", id, i);
+
+	return 0;
+}
+
+/*
+ * Check the reassembled datagrams, one per id in [0, nb), and free them.
+ * Datagrams with an odd id are IPv6 ones.
+ */
+static int
+dgrams_check(struct rte_mbuf **pkts, uint16_t nb_pkts, uint16_t nb)
+{
+	uint8_t seen[BULK_NB_DGRAMS];
+	uint16_t i, id;
+	int ret = 0;
+
+	memset(seen, 0, sizeof(seen));
+	for (i = 0; i < nb_pkts; i++) {
+		id = pkt_id(pkts[i]);
+		if (ret == 0 && (id >= nb || seen[id] ||
+				dgram_check(pkts[i], id & 1) != 0))
+			ret = -1;
+		else if (id < nb)
+			seen[id] = 1;
+	}
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+
+	TEST_ASSERT_SUCCESS(ret, "Unexpected or invalid datagram\n");
+	TEST_ASSERT_EQUAL(nb_pkts, nb, "Reassembled %u datagrams out of %u\n",
+		nb_pkts, nb);
+
+	return 0;
+}
+
+/* Check that every mbuf went back to the pool */
+static int
+pool_check_full(void)
+{
+	TEST_ASSERT_EQUAL(rte_mempool_avail_count(pkt_pool), NUM_MBUFS,
+		"%u mbufs leaked\n", rte_mempool_in_use_count(pkt_pool));
+
+	return 0;
+}
+
+static int
+test_ipfrag_bulk_in_order(void)
+{
+	struct rte_mbuf *pkts[BULK_NB_DGRAMS * FRAG_NB + 1];
+	struct rte_ip_frag_death_row dr;
+	struct rte_ip_frag_tbl *tbl;
+	uint16_t id, nb, n;
+	uint32_t i;
+	int ret;
+
+	tbl = rte_ip_frag_table_create(TBL_BUCKETS, TBL_BUCKET_ENTRIES,
+		TBL_MAX_ENTRIES, TBL_MAX_CYCLES, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(tbl, "Cannot create fragmentation table\n");
+	memset(&dr, 0, sizeof(dr));
+
+	/* a packet that is not a fragment, then interleaved datagrams */
+	n = 0;
+	pkts[n] = pkt_build(0, BULK_NB_DGRAMS, 0, FRAG_LEN, 0);
+	TEST_ASSERT_NOT_NULL(pkts[n], "Cannot build packet\n");
+	n++;
+	for (i = 0; i < FRAG_NB; i++)
+		for (id = 0; id < BULK_NB_DGRAMS; id++) {
+			pkts[n] = frag_build(id & 1, id, i);
+			TEST_ASSERT_NOT_NULL(pkts[n], "Cannot build fragment\n");
+			n++;
+		}
+
+	nb = rte_ip_frag_reassemble_bulk(tbl, &dr, pkts, n, 0, pkts);
+	TEST_ASSERT_EQUAL(nb, BULK_NB_DGRAMS + 1, "Got %u packets\n", nb);
+
+	/* the packet that is not a fragment is returned first, as is */
+	TEST_ASSERT_EQUAL(pkt_id(pkts[0]), BULK_NB_DGRAMS,
+		"Packet that is not a fragment not passed through\n");
+	TEST_ASSERT_EQUAL(pkts[0]->pkt_len, IPV4_HDR_LEN + FRAG_LEN,
+		"Packet that is not a fragment modified\n");
+	rte_pktmbuf_free(pkts[0]);
+
+	ret = dgrams_check(pkts + 1, nb - 1, BULK_NB_DGRAMS);
+	TEST_ASSERT_EQUAL(dr.cnt, 0, "%u mbufs in death row\n", dr.cnt);
+	rte_ip_frag_table_destroy(tbl);
+	TEST_ASSERT_SUCCESS(ret, "In order reassembly failed\n");
+
+	return pool_check_full();
+}
+
+static int
+test_ipfrag_bulk_out_of_order(void)
+{
+	struct rte_mbuf *pkts[BULK_NB_DGRAMS * FRAG_NB];
+	struct rte_ip_frag_death_row dr;
+	struct rte_ip_frag_tbl *tbl;
+	uint16_t id, nb, n;
+	uint32_t i;
+	int ret;
+
+	tbl = rte_ip_frag_table_create(TBL_BUCKETS, TBL_BUCKET_ENTRIES,
+		TBL_MAX_ENTRIES, TBL_MAX_CYCLES, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(tbl, "Cannot create fragmentation table\n");
+	memset(&dr, 0, sizeof(dr));
+
+	/* the last fragments first, the first ones in a later burst */
+	n = 0;
+	for (i = FRAG_NB - 1; i != 0; i--)
+		for (id = 0; id < BULK_NB_DGRAMS; id++) {
+			pkts[n] = frag_build(id & 1, id, i);
+			TEST_ASSERT_NOT_NULL(pkts[n], "Cannot build fragment\n");
+			n++;
+		}
+
+	nb = rte_ip_frag_reassemble_bulk(tbl, &dr, pkts, n, 0, pkts);
+	TEST_ASSERT_EQUAL(nb, 0, "Got %u packets before the first fragments\n",
+		nb);
+
+	for (id = 0; id < BULK_NB_DGRAMS; id++) {
+		pkts[id] = frag_build(id & 1, id, 0);
+		TEST_ASSERT_NOT_NULL(pkts[id], "Cannot build fragment\n");
+	}
+
+	nb = rte_ip_frag_reassemble_bulk(tbl, &dr, pkts, BULK_NB_DGRAMS, 1,
+		pkts);
+	ret = dgrams_check(pkts, nb, BULK_NB_DGRAMS);
+	TEST_ASSERT_EQUAL(dr.cnt, 0, "%u mbufs in death row\n", dr.cnt);
+	rte_ip_frag_table_destroy(tbl);
+	TEST_ASSERT_SUCCESS(ret, "Out of order reassembly failed\n");
+
+	return pool_check_full();
+}
+
+static int
+test_ipfrag_bulk_overlap(void)
+{
+	struct rte_mbuf *pkts[2 * FRAG_NB];
+	struct rte_ip_frag_death_row dr;
+	struct rte_ip_frag_tbl *tbl;
+	uint16_t nb;
+	uint32_t i;
+	int ipv6, ret;
+
+	for (ipv6 = 0; ipv6 <= 1; ipv6++) {
+		tbl = rte_ip_frag_table_create(TBL_BUCKETS, TBL_BUCKET_ENTRIES,
+			TBL_MAX_ENTRIES, TBL_MAX_CYCLES, SOCKET_ID_ANY);
+		TEST_ASSERT_NOT_NULL(tbl,
+			"Cannot create fragmentation table\n");
+		memset(&dr, 0, sizeof(dr));
+
+		/*
+		 * The second fragment of datagram 0 overlaps the first one.
+		 * Datagram 1, in the same burst, is valid.
+		 */
+		pkts[0] = pkt_build(ipv6, 0, 0, FRAG_LEN, 1);
+		pkts[1] = pkt_build(ipv6, 0, FRAG_LEN / 2, FRAG_LEN, 1);
+		pkts[2] = pkt_build(ipv6, 0, FRAG_LEN / 2 + FRAG_LEN,
+			FRAG_LAST_LEN, 0);
+		for (i = 0; i < FRAG_NB; i++)
+			pkts[FRAG_NB + i] = frag_build(ipv6, 1, i);
+		for (i = 0; i < RTE_DIM(pkts); i++)
+			TEST_ASSERT_NOT_NULL(pkts[i], "Cannot build fragment\n");
+
+		nb = rte_ip_frag_reassemble_bulk(tbl, &dr, pkts,
+			RTE_DIM(pkts), 0, pkts);
+		TEST_ASSERT_EQUAL(nb, 1, "IPv%d: got %u packets\n",
+			ipv6 ? 6 : 4, nb);
+		ret = pkt_id(pkts[0]) == 1 ? dgram_check(pkts[0], ipv6) : -1;
+		rte_pktmbuf_free(pkts[0]);
+		TEST_ASSERT_SUCCESS(ret, "IPv%d: valid datagram not reassembled\n",
+			ipv6 ? 6 : 4);
+
+		/* all the fragments of datagram 0 are dropped */
+		TEST_ASSERT_EQUAL(dr.cnt, FRAG_NB,
+			"IPv%d: %u mbufs in death row\n", ipv6 ? 6 : 4, dr.cnt);
+		rte_ip_frag_free_death_row(&dr, 0);
+		rte_ip_frag_table_destroy(tbl);
+
+		ret = pool_check_full();
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int
+test_ipfrag_bulk_timeout(void)
+{
+	struct rte_mbuf *pkts[BULK_NB_DGRAMS * FRAG_NB];
+	struct rte_ip_frag_death_row dr;
+	struct rte_ip_frag_tbl *tbl;
+	uint64_t tms;
+	uint16_t id, nb, n;
+	uint32_t i;
+
+	tbl = rte_ip_frag_table_create(TBL_BUCKETS, TBL_BUCKET_ENTRIES,
+		TBL_MAX_ENTRIES, TBL_MAX_CYCLES, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(tbl, "Cannot create fragmentation table\n");
+	memset(&dr, 0, sizeof(dr));
+
+	/* all but the last fragments, then let them expire */
+	n = 0;
+	for (i = 0; i < FRAG_NB - 1; i++)
+		for (id = 0; id < BULK_NB_DGRAMS; id++) {
+			pkts[n] = frag_build(id & 1, id, i);
+			TEST_ASSERT_NOT_NULL(pkts[n], "Cannot build fragment\n");
+			n++;
+		}
+	nb = rte_ip_frag_reassemble_bulk(tbl, &dr, pkts, n, 0, pkts);
+	TEST_ASSERT_EQUAL(nb, 0, "Got %u packets\n", nb);
+
+	rte_frag_table_del_expired_entries(tbl, &dr, TBL_MAX_CYCLES);
+	TEST_ASSERT_EQUAL(dr.cnt, 0, "Fragments expired too early\n");
+
+	tms = 2 * TBL_MAX_CYCLES;
+	rte_frag_table_del_expired_entries(tbl, &dr, tms);
+	TEST_ASSERT_EQUAL(dr.cnt, n, "%u of %u fragments expired\n", dr.cnt,
+		n);
+	rte_ip_frag_free_death_row(&dr, 0);
+
+	/* the last fragments alone don't make a datagram */
+	for (id = 0; id < BULK_NB_DGRAMS; id++) {
+		pkts[id] = frag_build(id & 1, id, FRAG_NB - 1);
+		TEST_ASSERT_NOT_NULL(pkts[id], "Cannot build fragment\n");
+	}
+	nb = rte_ip_frag_reassemble_bulk(tbl, &dr, pkts, BULK_NB_DGRAMS, tms,
+		pkts);
+	TEST_ASSERT_EQUAL(nb, 0, "Got %u packets after the timeout\n", nb);
+
+	/*
+	 * Complete them too late: the expired entries are reused, which
+	 * drops the last fragments.
+	 */
+	tms += 2 * TBL_MAX_CYCLES;
+	for (id = 0; id < BULK_NB_DGRAMS; id++) {
+		pkts[id] = frag_build(id & 1, id, 0);
+		TEST_ASSERT_NOT_NULL(pkts[id], "Cannot build fragment\n");
+	}
+	nb = rte_ip_frag_reassemble_bulk(tbl, &dr, pkts, BULK_NB_DGRAMS, tms,
+		pkts);
+	TEST_ASSERT_EQUAL(nb, 0, "Got %u packets after the timeout\n", nb);
+	TEST_ASSERT_EQUAL(dr.cnt, BULK_NB_DGRAMS,
+		"%u expired fragments dropped\n", dr.cnt);
+	rte_ip_frag_free_death_row(&dr, 0);
+
+	/* the table frees the fragments it still holds */
+	rte_ip_frag_table_destroy(tbl);
+
+	return pool_check_full();
+}
+
+struct ipfrag_shared_params {
+	struct rte_ip_frag_shared_tbl *tbl;
+	struct rte_mbuf **pkts;
+	uint16_t nb_pkts;
+	uint16_t nb_dgrams;
+	int ret;
+};
+
+/* Reassemble a share of the fragments with the shared table */
+static int
+ipfrag_shared_worker(void *arg)
+{
+	struct ipfrag_shared_params *sp = arg;
+	struct rte_mbuf *out[BURST];
+	struct rte_ip_frag_death_row dr;
+	uint16_t i, j, n, nb;
+
+	memset(&dr, 0, sizeof(dr));
+	sp->nb_dgrams = 0;
+	sp->ret = 0;
+
+	for (i = 0; i < sp->nb_pkts; i += n) {
+		n = RTE_MIN(sp->nb_pkts - i, BURST);
+		nb = rte_ip_frag_shared_reassemble_bulk(sp->tbl, &dr,
+			sp->pkts + i, n, rte_rdtsc(), out);
+		for (j = 0; j < nb; j++) {
+			if (sp->ret == 0 &&
+					dgram_check(out[j], pkt_id(out[j]) & 1))
+				sp->ret = -1;
+			rte_pktmbuf_free(out[j]);
+		}
+		sp->nb_dgrams += nb;
+		if (dr.cnt != 0)
+			sp->ret = -1;
+	}
+
+	return sp->ret;
+}
+
+static int
+test_ipfrag_shared_concurrent(void)
+{
+	static struct rte_mbuf *pkts[2][SHARED_NB_DGRAMS * FRAG_NB];
+	struct ipfrag_shared_params sp[2];
+	struct rte_ip_frag_shared_tbl *tbl;
+	unsigned int lcore_id, round;
+	uint16_t id, n[2];
+	uint32_t i, j;
+	int ret;
+
+	if (rte_lcore_count() < 2) {
+		printf("Need at least 2 lcores for the shared table test\n");
+		return TEST_SKIPPED;
+	}
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+
+	tbl = rte_ip_frag_shared_table_create(2, SHARED_BUCKETS,
+		TBL_BUCKET_ENTRIES, SHARED_MAX_ENTRIES, rte_get_tsc_hz(),
+		SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(tbl, "Cannot create shared table\n");
+
+	ret = 0;
+	for (round = 0; round < SHARED_NB_ROUNDS && ret == 0; round++) {
+		/*
+		 * The fragments of each datagram are split between the two
+		 * lcores, so both complete datagrams of the other.
+		 */
+		n[0] = n[1] = 0;
+		for (id = 0; id < SHARED_NB_DGRAMS; id++)
+			for (i = 0; i < FRAG_NB; i++) {
+				pkts[(id + i) & 1][n[(id + i) & 1]++] =
+					frag_build(id & 1,
+						round * SHARED_NB_DGRAMS + id,
+						i);
+			}
+		for (i = 0; i < RTE_DIM(sp); i++) {
+			sp[i].tbl = tbl;
+			sp[i].pkts = pkts[i];
+			sp[i].nb_pkts = n[i];
+			for (j = 0; j < n[i]; j++)
+				if (pkts[i][j] == NULL)
+					ret = -1;
+		}
+		if (ret != 0) {
+			printf("Round %u: cannot build fragments\n", round);
+			for (i = 0; i < RTE_DIM(sp); i++)
+				for (j = 0; j < n[i]; j++)
+					rte_pktmbuf_free(pkts[i][j]);
+			break;
+		}
+
+		rte_eal_remote_launch(ipfrag_shared_worker, &sp[1], lcore_id);
+		ipfrag_shared_worker(&sp[0]);
+		rte_eal_wait_lcore(lcore_id);
+
+		if (sp[0].ret != 0 || sp[1].ret != 0 ||
+				sp[0].nb_dgrams + sp[1].nb_dgrams !=
+				SHARED_NB_DGRAMS) {
+			printf("Round %u: reassembled %u + %u datagrams out of %u\n",
+				round, sp[0].nb_dgrams, sp[1].nb_dgrams,
+				SHARED_NB_DGRAMS);
+			ret = -1;
+		}
+	}
+
+	rte_ip_frag_shared_table_destroy(tbl);
+	TEST_ASSERT_SUCCESS(ret, "Concurrent reassembly failed\n");
+
+	return pool_check_full();
+}
+
+static int
+test_setup(void)
+{
+	if (pkt_pool == NULL) {
+		pkt_pool = rte_pktmbuf_pool_create("ipfrag_test_pool",
+			NUM_MBUFS, 0, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			SOCKET_ID_ANY);
+		if (pkt_pool == NULL) {
+			printf("%s: Error creating mempool\n", __func__);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void
+test_teardown(void)
+{
+	rte_mempool_free(pkt_pool);
+	pkt_pool = NULL;
+}
+
+static struct unit_test_suite ipfrag_test_suite  = {
+	.setup = test_setup,
+	.teardown = test_teardown,
+	.suite_name = "IP Fragmentation Unit Test Suite",
+	.unit_test_cases = {
+		TEST_CASE(test_ipfrag_bulk_in_order),
+		TEST_CASE(test_ipfrag_bulk_out_of_order),
+		TEST_CASE(test_ipfrag_bulk_overlap),
+		TEST_CASE(test_ipfrag_bulk_timeout),
+		TEST_CASE(test_ipfrag_shared_concurrent),
+		TEST_CASES_END()
+	}
+};
+
+static int
+test_ipfrag(void)
+{
+	return unit_test_suite_runner(&ipfrag_test_suite);
+}
+
+REGISTER_TEST_COMMAND(ipfrag_autotest, test_ipfrag);
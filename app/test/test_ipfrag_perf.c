@@ -0,0 +1,221 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_errno.h>
+#include <rte_ip.h>
+#include <rte_ip_frag.h>
+#include <rte_mbuf.h>
+
+#include "test.h"
+
+#define PERF_BURST       32
+#define PERF_ITERATIONS  (1 << 12)
+#define PERF_PKT_LEN     9000
+#define PERF_MTU         1500
+#define PERF_FRAGS_MAX   8
+
+#define NB_IN_MBUF       (PERF_BURST * (PERF_PKT_LEN / 1024 + 1))
+#define NB_OUT_MBUF      (4 * PERF_BURST * PERF_FRAGS_MAX)
+#define IN_MBUF_DATA_SZ  (PERF_PKT_LEN + RTE_PKTMBUF_HEADROOM)
+
+static struct rte_mempool *in_pool;
+static struct rte_mempool *direct_pool;
+static struct rte_mempool *indirect_pool;
+
+/*
+ * Build a burst of IPv4 or IPv6 packets of PERF_PKT_LEN bytes, made of
+ * segments of seg_len bytes.
+ */
+static int
+perf_pkts_init(struct rte_mbuf **pkts, int ipv6, uint32_t seg_len)
+{
+	struct rte_ipv4_hdr *ip4;
+	struct rte_ipv6_hdr *ip6;
+	struct rte_mbuf *m, *seg;
+	uint32_t i, len;
+
+	for (i = 0; i < PERF_BURST; i++) {
+		m = NULL;
+		for (len = 0; len < PERF_PKT_LEN; len += seg_len) {
+			seg = rte_pktmbuf_alloc(in_pool);
+			if (seg == NULL ||
+					rte_pktmbuf_append(seg, RTE_MIN(seg_len,
+					PERF_PKT_LEN - len)) == NULL)
+				return -1;
+			if (m == NULL)
+				m = seg;
+			else if (rte_pktmbuf_chain(m, seg) != 0)
+				return -1;
+		}
+		pkts[i] = m;
+
+		if (ipv6) {
+			ip6 = rte_pktmbuf_mtod(m, struct rte_ipv6_hdr *);
+			memset(ip6, 0, sizeof(*ip6));
+			ip6->vtc_flow = rte_cpu_to_be_32(6 << 28);
+			ip6->payload_len = rte_cpu_to_be_16(PERF_PKT_LEN -
+				sizeof(*ip6));
+			ip6->proto = IPPROTO_UDP;
+			ip6->hop_limits = 64;
+		} else {
+			ip4 = rte_pktmbuf_mtod(m, struct rte_ipv4_hdr *);
+			memset(ip4, 0, sizeof(*ip4));
+			ip4->version_ihl = RTE_IPV4_VHL_DEF;
+			ip4->total_length = rte_cpu_to_be_16(PERF_PKT_LEN);
+			ip4->packet_id = rte_cpu_to_be_16(i);
+			ip4->time_to_live = 64;
+			ip4->next_proto_id = IPPROTO_UDP;
+		}
+	}
+
+	return 0;
+}
+
+static int32_t
+perf_fragment_packet(struct rte_mbuf **pkts, struct rte_mbuf **frags,
+	uint32_t nb_frags_max, int ipv6)
+{
+	uint32_t i, n;
+	int32_t ret;
+
+	n = 0;
+	for (i = 0; i < PERF_BURST; i++) {
+		if (ipv6)
+			ret = rte_ipv6_fragment_packet(pkts[i], frags + n,
+				nb_frags_max - n, PERF_MTU, direct_pool,
+				indirect_pool);
+		else
+			ret = rte_ipv4_fragment_packet(pkts[i], frags + n,
+				nb_frags_max - n, PERF_MTU, direct_pool,
+				indirect_pool);
+		if (ret < 0)
+			return ret;
+		n += ret;
+	}
+
+	return n;
+}
+
+static int32_t
+perf_fragment_bulk(struct rte_mbuf **pkts, struct rte_mbuf **frags,
+	uint32_t nb_frags_max, int ipv6)
+{
+	uint16_t n, nb_frags;
+
+	if (ipv6)
+		n = rte_ipv6_fragment_bulk(pkts, PERF_BURST, frags,
+			nb_frags_max, PERF_MTU, direct_pool, indirect_pool,
+			&nb_frags);
+	else
+		n = rte_ipv4_fragment_bulk(pkts, PERF_BURST, frags,
+			nb_frags_max, PERF_MTU, direct_pool, indirect_pool,
+			&nb_frags);
+	if (n != PERF_BURST) {
+		rte_pktmbuf_free_bulk(frags, nb_frags);
+		return -rte_errno;
+	}
+
+	return nb_frags;
+}
+
+static int
+test_ipfrag_perf_type(int ipv6, uint32_t seg_len)
+{
+	struct rte_mbuf *pkts[PERF_BURST];
+	struct rte_mbuf *frags[2][PERF_BURST * PERF_FRAGS_MAX];
+	uint64_t cycles[2] = {0, 0}, start;
+	int32_t n[2];
+	uint32_t i, k;
+
+	TEST_ASSERT_SUCCESS(perf_pkts_init(pkts, ipv6, seg_len),
+		"Error building input packets\n");
+
+	for (i = 0; i < PERF_ITERATIONS; i++) {
+		start = rte_rdtsc();
+		n[0] = perf_fragment_packet(pkts, frags[0], RTE_DIM(frags[0]),
+			ipv6);
+		cycles[0] += rte_rdtsc() - start;
+
+		start = rte_rdtsc();
+		n[1] = perf_fragment_bulk(pkts, frags[1], RTE_DIM(frags[1]),
+			ipv6);
+		cycles[1] += rte_rdtsc() - start;
+
+		TEST_ASSERT(n[0] > 0 && n[0] == n[1],
+			"Fragmentation failed: %d/%d fragments\n", n[0], n[1]);
+
+		/* both APIs must produce the same fragments */
+		if (i == 0) {
+			for (k = 0; k < (uint32_t)n[0]; k++) {
+				TEST_ASSERT(frags[0][k]->pkt_len ==
+					frags[1][k]->pkt_len &&
+					frags[0][k]->nb_segs ==
+					frags[1][k]->nb_segs &&
+					memcmp(rte_pktmbuf_mtod(frags[0][k],
+					void *), rte_pktmbuf_mtod(frags[1][k],
+					void *), frags[0][k]->data_len) == 0,
+					"Fragment %u differs\n", k);
+			}
+		}
+
+		rte_pktmbuf_free_bulk(frags[0], n[0]);
+		rte_pktmbuf_free_bulk(frags[1], n[1]);
+	}
+
+	printf("IPv%d %u-byte segments: fragment_packet: %7.2f cycles/pkt, "
+		"fragment_bulk: %7.2f cycles/pkt\n", ipv6 ? 6 : 4, seg_len,
+		(double)cycles[0] / (PERF_ITERATIONS * PERF_BURST),
+		(double)cycles[1] / (PERF_ITERATIONS * PERF_BURST));
+
+	rte_pktmbuf_free_bulk(pkts, PERF_BURST);
+
+	return 0;
+}
+
+static int
+test_ipfrag_perf(void)
+{
+	static const uint32_t seg_len[] = {PERF_PKT_LEN, 2048};
+	uint32_t i;
+	int ipv6, err;
+
+	in_pool = rte_pktmbuf_pool_create("test_ipfrag_in", NB_IN_MBUF, 0, 0,
+		IN_MBUF_DATA_SZ, SOCKET_ID_ANY);
+	direct_pool = rte_pktmbuf_pool_create("test_ipfrag_direct",
+		NB_OUT_MBUF, PERF_BURST, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+		SOCKET_ID_ANY);
+	indirect_pool = rte_pktmbuf_pool_create("test_ipfrag_indirect",
+		2 * NB_OUT_MBUF, PERF_BURST, 0, 0, SOCKET_ID_ANY);
+
+	err = -1;
+	if (in_pool == NULL || direct_pool == NULL || indirect_pool == NULL) {
+		printf("Error creating mempools\n");
+		goto out;
+	}
+
+	printf("Burst size: %u, packet length: %u, MTU: %u\n",
+		PERF_BURST, PERF_PKT_LEN, PERF_MTU);
+
+	for (ipv6 = 0; ipv6 <= 1; ipv6++) {
+		for (i = 0; i < RTE_DIM(seg_len); i++) {
+			err = test_ipfrag_perf_type(ipv6, seg_len[i]);
+			if (err != 0)
+				goto out;
+		}
+	}
+
+out:
+	rte_mempool_free(indirect_pool);
+	rte_mempool_free(direct_pool);
+	rte_mempool_free(in_pool);
+
+	return err;
+}
+
+REGISTER_TEST_COMMAND(ipfrag_perf_autotest, test_ipfrag_perf);
@@ -12,6 +12,7 @@
 
 #include <rte_cycles.h>
 #include <rte_meter.h>
+#include <rte_random.h>
 
 #define mlog(format, ...) do{\
 		printf("Line %d:",__LINE__);\
@@ -676,6 +677,110 @@ tm_test_trtcm_rfc4115_color_aware_check(void)
 	return 0;
 }
 
+#define TM_TEST_BULK_N_METERS 4
+#define TM_TEST_BULK_N_PKTS   64
+
+/**
+ * functional test for the bulk srTCM and trTCM checks: every burst is metered
+ * with the bulk and with the single packet functions on identical meters,
+ * with several packets of the burst on the same meter.
+ */
+static inline int
+tm_test_color_check_bulk(void)
+{
+#define BULK_CHECK_MSG "color_check_bulk"
+	struct rte_meter_srtcm_profile sp;
+	struct rte_meter_trtcm_profile tp;
+	struct rte_meter_srtcm sm[TM_TEST_BULK_N_METERS];
+	struct rte_meter_srtcm sm_ref[TM_TEST_BULK_N_METERS];
+	struct rte_meter_trtcm tm[TM_TEST_BULK_N_METERS];
+	struct rte_meter_trtcm tm_ref[TM_TEST_BULK_N_METERS];
+	struct rte_meter_srtcm *sm_pkt[TM_TEST_BULK_N_PKTS];
+	struct rte_meter_srtcm_profile *sp_pkt[TM_TEST_BULK_N_PKTS];
+	struct rte_meter_trtcm *tm_pkt[TM_TEST_BULK_N_PKTS];
+	struct rte_meter_trtcm_profile *tp_pkt[TM_TEST_BULK_N_PKTS];
+	uint64_t time[TM_TEST_BULK_N_PKTS];
+	uint32_t pkt_len[TM_TEST_BULK_N_PKTS], meter_id[TM_TEST_BULK_N_PKTS];
+	enum rte_color in[TM_TEST_BULK_N_PKTS], out[TM_TEST_BULK_N_PKTS];
+	uint64_t hz = rte_get_tsc_hz(), now;
+	uint32_t i, j, burst;
+
+	if (rte_meter_srtcm_profile_config(&sp, &sparams) != 0)
+		melog(BULK_CHECK_MSG);
+	if (rte_meter_trtcm_profile_config(&tp, &tparams) != 0)
+		melog(BULK_CHECK_MSG);
+
+	for (i = 0; i < TM_TEST_BULK_N_METERS; i++) {
+		if (rte_meter_srtcm_config(&sm[i], &sp) != 0)
+			melog(BULK_CHECK_MSG);
+		if (rte_meter_trtcm_config(&tm[i], &tp) != 0)
+			melog(BULK_CHECK_MSG);
+	}
+	memcpy(sm_ref, sm, sizeof(sm));
+	memcpy(tm_ref, tm, sizeof(tm));
+
+	now = rte_get_tsc_cycles();
+	for (burst = 0; burst < 32; burst++) {
+		now += rte_rand_max(hz / 10000);
+
+		for (i = 0; i < TM_TEST_BULK_N_PKTS; i++) {
+			j = rte_rand_max(TM_TEST_BULK_N_METERS);
+			meter_id[i] = j;
+			sm_pkt[i] = &sm[j];
+			sp_pkt[i] = &sp;
+			tm_pkt[i] = &tm[j];
+			tp_pkt[i] = &tp;
+			time[i] = now + i;
+			pkt_len[i] = 64 + rte_rand_max(1454);
+			in[i] = (enum rte_color)rte_rand_max(RTE_COLORS);
+		}
+
+		/* srTCM color blind */
+		rte_meter_srtcm_color_blind_check_bulk(sm_pkt, sp_pkt, time,
+			pkt_len, out, TM_TEST_BULK_N_PKTS);
+		for (i = 0; i < TM_TEST_BULK_N_PKTS; i++)
+			if (rte_meter_srtcm_color_blind_check(
+				&sm_ref[meter_id[i]], &sp, time[i],
+				pkt_len[i]) != out[i])
+				melog(BULK_CHECK_MSG" srtcm blind %u", i);
+
+		/* srTCM color aware */
+		memcpy(out, in, sizeof(out));
+		rte_meter_srtcm_color_aware_check_bulk(sm_pkt, sp_pkt, time,
+			pkt_len, out, TM_TEST_BULK_N_PKTS);
+		for (i = 0; i < TM_TEST_BULK_N_PKTS; i++)
+			if (rte_meter_srtcm_color_aware_check(
+				&sm_ref[meter_id[i]], &sp, time[i],
+				pkt_len[i], in[i]) != out[i])
+				melog(BULK_CHECK_MSG" srtcm aware %u", i);
+
+		/* trTCM color blind */
+		rte_meter_trtcm_color_blind_check_bulk(tm_pkt, tp_pkt, time,
+			pkt_len, out, TM_TEST_BULK_N_PKTS);
+		for (i = 0; i < TM_TEST_BULK_N_PKTS; i++)
+			if (rte_meter_trtcm_color_blind_check(
+				&tm_ref[meter_id[i]], &tp, time[i],
+				pkt_len[i]) != out[i])
+				melog(BULK_CHECK_MSG" trtcm blind %u", i);
+
+		/* trTCM color aware */
+		memcpy(out, in, sizeof(out));
+		rte_meter_trtcm_color_aware_check_bulk(tm_pkt, tp_pkt, time,
+			pkt_len, out, TM_TEST_BULK_N_PKTS);
+		for (i = 0; i < TM_TEST_BULK_N_PKTS; i++)
+			if (rte_meter_trtcm_color_aware_check(
+				&tm_ref[meter_id[i]], &tp, time[i],
+				pkt_len[i], in[i]) != out[i])
+				melog(BULK_CHECK_MSG" trtcm aware %u", i);
+
+		if (memcmp(sm, sm_ref, sizeof(sm)) != 0 ||
+			memcmp(tm, tm_ref, sizeof(tm)) != 0)
+			melog(BULK_CHECK_MSG" meter state");
+	}
+
+	return 0;
+}
+
 /**
  * test main entrance for library meter
  */
@@ -709,6 +814,9 @@ test_meter(void)
 	if (tm_test_trtcm_rfc4115_color_aware_check() != 0)
 		return -1;
 
+	if (tm_test_color_check_bulk() != 0)
+		return -1;
+
 	return 0;
 
 }
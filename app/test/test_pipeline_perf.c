@@ -0,0 +1,233 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_pipeline.h>
+#include <rte_port_ring.h>
+#include <rte_ring.h>
+#include <rte_table_array.h>
+
+#include "test.h"
+
+#define PERF_BURST       RTE_PORT_IN_BURST_SIZE_MAX
+#define PERF_ITERATIONS  (1 << 16)
+#define PERF_RING_SIZE   (4 * PERF_BURST)
+#define PERF_N_ENTRIES   16
+
+#define NB_MBUF          (2 * PERF_BURST)
+#define MBUF_PRIV_SZ     RTE_CACHE_LINE_SIZE
+
+/* the array table key is at the start of the mbuf private area */
+#define PERF_KEY_OFFSET  sizeof(struct rte_mbuf)
+
+static int
+perf_port_in_ah(struct rte_pipeline *p, struct rte_mbuf **pkts, uint32_t n,
+	void *arg)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(pkts);
+	RTE_SET_USED(n);
+	RTE_SET_USED(arg);
+	return 0;
+}
+
+static int
+perf_table_hit_ah(struct rte_pipeline *p, struct rte_mbuf **pkts,
+	uint64_t pkts_mask, struct rte_pipeline_table_entry **entries,
+	void *arg)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(pkts);
+	RTE_SET_USED(pkts_mask);
+	RTE_SET_USED(entries);
+	RTE_SET_USED(arg);
+	return 0;
+}
+
+static int
+perf_port_out_ah(struct rte_pipeline *p, struct rte_mbuf **pkts,
+	uint64_t pkts_mask, void *arg)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(pkts);
+	RTE_SET_USED(pkts_mask);
+	RTE_SET_USED(arg);
+	return 0;
+}
+
+/*
+ * Build a pipeline of a ring input port, an array table whose entries
+ * send the packets to a ring output port, and the output port. With ah
+ * set, every stage gets an action handler that does nothing, which
+ * selects the run loop that checks and calls the action handlers.
+ */
+static struct rte_pipeline *
+perf_pipeline_create(struct rte_ring *r_in, struct rte_ring *r_out, int ah)
+{
+	struct rte_pipeline_params pipeline_params = {
+		.name = "pipeline_perf",
+		.socket_id = rte_socket_id(),
+		.offset_port_id = 0,
+	};
+	struct rte_port_ring_reader_params port_ring_params = {
+		.ring = r_in,
+	};
+	struct rte_port_ring_writer_params port_ring_writer_params = {
+		.ring = r_out,
+		.tx_burst_sz = PERF_BURST,
+	};
+	struct rte_pipeline_port_in_params port_in_params = {
+		.ops = &rte_port_ring_reader_ops,
+		.arg_create = &port_ring_params,
+		.f_action = ah ? perf_port_in_ah : NULL,
+		.arg_ah = NULL,
+		.burst_size = PERF_BURST,
+	};
+	struct rte_pipeline_port_out_params port_out_params = {
+		.ops = &rte_port_ring_writer_ops,
+		.arg_create = &port_ring_writer_params,
+		.f_action = ah ? perf_port_out_ah : NULL,
+		.arg_ah = NULL,
+	};
+	struct rte_table_array_params table_array_params = {
+		.n_entries = PERF_N_ENTRIES,
+		.offset = PERF_KEY_OFFSET,
+	};
+	struct rte_pipeline_table_params table_params = {
+		.ops = &rte_table_array_ops,
+		.arg_create = &table_array_params,
+		.f_action_hit = ah ? perf_table_hit_ah : NULL,
+		.f_action_miss = NULL,
+		.arg_ah = NULL,
+		.action_data_size = 0,
+	};
+	struct rte_pipeline_table_entry table_entry = {
+		.action = RTE_PIPELINE_ACTION_PORT,
+	};
+	struct rte_pipeline_table_entry *entry_ptr;
+	struct rte_table_array_key key;
+	struct rte_pipeline *p;
+	uint32_t port_in_id, port_out_id, table_id;
+	int key_found;
+
+	p = rte_pipeline_create(&pipeline_params);
+	if (p == NULL)
+		return NULL;
+
+	if (rte_pipeline_port_in_create(p, &port_in_params, &port_in_id) ||
+			rte_pipeline_port_out_create(p, &port_out_params,
+				&port_out_id) ||
+			rte_pipeline_table_create(p, &table_params, &table_id) ||
+			rte_pipeline_port_in_connect_to_table(p, port_in_id,
+				table_id))
+		goto error;
+
+	table_entry.port_id = port_out_id;
+	for (key.pos = 0; key.pos < PERF_N_ENTRIES; key.pos++)
+		if (rte_pipeline_table_entry_add(p, table_id, &key,
+				&table_entry, &key_found, &entry_ptr))
+			goto error;
+
+	if (rte_pipeline_port_in_enable(p, port_in_id) ||
+			rte_pipeline_check(p))
+		goto error;
+
+	return p;
+
+error:
+	rte_pipeline_free(p);
+	return NULL;
+}
+
+static int
+test_pipeline_perf_type(struct rte_mbuf **pkts, struct rte_ring *r_in,
+	struct rte_ring *r_out, int ah)
+{
+	struct rte_pipeline *p;
+	uint64_t cycles, start;
+	uint32_t i, n;
+	int n_pkts;
+
+	p = perf_pipeline_create(r_in, r_out, ah);
+	TEST_ASSERT_NOT_NULL(p, "Error creating pipeline\n");
+
+	cycles = 0;
+	for (i = 0; i < PERF_ITERATIONS; i++) {
+		n = rte_ring_sp_enqueue_burst(r_in, (void **)pkts, PERF_BURST,
+			NULL);
+		TEST_ASSERT_EQUAL(n, PERF_BURST, "Error filling input ring\n");
+
+		start = rte_rdtsc();
+		n_pkts = rte_pipeline_run(p);
+		cycles += rte_rdtsc() - start;
+		TEST_ASSERT_EQUAL(n_pkts, PERF_BURST,
+			"Pipeline ran %d packets\n", n_pkts);
+
+		/* The mbufs are reused for the next burst */
+		rte_pipeline_flush(p);
+		n = rte_ring_sc_dequeue_burst(r_out, (void **)pkts, PERF_BURST,
+			NULL);
+		TEST_ASSERT_EQUAL(n, PERF_BURST,
+			"Pipeline sent %u packets\n", n);
+	}
+
+	printf("%-24s %6.2f cycles/pkt\n",
+		ah ? "empty action handlers:" : "no action handler:",
+		(double)cycles / ((uint64_t)PERF_ITERATIONS * PERF_BURST));
+
+	rte_pipeline_free(p);
+
+	return 0;
+}
+
+static int
+test_pipeline_perf(void)
+{
+	struct rte_mbuf *pkts[PERF_BURST];
+	struct rte_ring *r_in, *r_out;
+	struct rte_mempool *mp;
+	uint32_t i;
+	int err;
+
+	mp = rte_pktmbuf_pool_create("test_pipeline_perf", NB_MBUF, 0,
+		MBUF_PRIV_SZ, RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(mp, "Error creating mempool\n");
+	r_in = rte_ring_create("pipeline_perf_in", PERF_RING_SIZE,
+		SOCKET_ID_ANY, RING_F_SP_ENQ | RING_F_SC_DEQ);
+	r_out = rte_ring_create("pipeline_perf_out", PERF_RING_SIZE,
+		SOCKET_ID_ANY, RING_F_SP_ENQ | RING_F_SC_DEQ);
+
+	err = -1;
+	if (r_in == NULL || r_out == NULL ||
+			rte_pktmbuf_alloc_bulk(mp, pkts, PERF_BURST) != 0) {
+		printf("Error creating rings or allocating mbufs\n");
+		goto out;
+	}
+
+	/* Spread the packets over the table entries */
+	for (i = 0; i < PERF_BURST; i++)
+		RTE_MBUF_METADATA_UINT32(pkts[i], PERF_KEY_OFFSET) = i;
+
+	printf("Burst size: %u\n", PERF_BURST);
+
+	err = test_pipeline_perf_type(pkts, r_in, r_out, 0);
+	if (err == 0)
+		err = test_pipeline_perf_type(pkts, r_in, r_out, 1);
+
+	rte_pktmbuf_free_bulk(pkts, PERF_BURST);
+out:
+	rte_ring_free(r_out);
+	rte_ring_free(r_in);
+	rte_mempool_free(mp);
+
+	return err;
+}
+
+REGISTER_TEST_COMMAND(pipeline_perf_autotest, test_pipeline_perf);
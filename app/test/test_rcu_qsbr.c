@@ -3,6 +3,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <rte_pause.h>
 #include <rte_rcu_qsbr.h>
 #include <rte_hash.h>
@@ -10,6 +11,7 @@
 #include <rte_malloc.h>
 #include <rte_cycles.h>
 #include <rte_random.h>
+#include <rte_errno.h>
 #include <unistd.h>
 
 #include "test.h"
@@ -617,6 +619,203 @@ test_rcu_qsbr_dump(void)
 	return 0;
 }
 
+#define TEST_RCU_DQ_SIZE 16
+
+static uint32_t dq_freed[TEST_RCU_DQ_SIZE * 4];
+static uint32_t dq_nb_freed;
+static uint32_t dq_nb_free_calls;
+
+static void
+test_rcu_qsbr_free_resource(void *p, void *e, unsigned int n)
+{
+	uint32_t *data = e;
+	unsigned int i;
+
+	RTE_SET_USED(p);
+
+	for (i = 0; i < n && dq_nb_freed < RTE_DIM(dq_freed); i++)
+		dq_freed[dq_nb_freed++] = data[i];
+	dq_nb_free_calls++;
+}
+
+static void
+test_rcu_qsbr_dq_params(struct rte_rcu_qsbr_dq_parameters *params)
+{
+	memset(params, 0, sizeof(*params));
+	params->name = "TEST_RCU";
+	params->size = TEST_RCU_DQ_SIZE;
+	params->esize = sizeof(uint32_t);
+	params->free_fn = test_rcu_qsbr_free_resource;
+	params->v = t[0];
+}
+
+/*
+ * rte_rcu_qsbr_dq_create: create a queue used to store the data structure
+ * elements that can be freed later.
+ */
+static int
+test_rcu_qsbr_dq_create(void)
+{
+	struct rte_rcu_qsbr_dq_parameters params;
+	struct rte_rcu_qsbr_dq *dq;
+
+	printf("\nTest rte_rcu_qsbr_dq_create()\n");
+
+	/* Negative tests */
+	dq = rte_rcu_qsbr_dq_create(NULL);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL), "dq create NULL params");
+
+	test_rcu_qsbr_dq_params(&params);
+	params.free_fn = NULL;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL), "dq create NULL free_fn");
+
+	test_rcu_qsbr_dq_params(&params);
+	params.v = NULL;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL), "dq create NULL QSBR");
+
+	test_rcu_qsbr_dq_params(&params);
+	params.size = 0;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL), "dq create size 0");
+
+	test_rcu_qsbr_dq_params(&params);
+	params.esize = 3;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL),
+		"dq create esize not multiple of 4");
+
+	test_rcu_qsbr_dq_params(&params);
+	params.trigger_reclaim_limit = 1;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq != NULL),
+		"dq create max_reclaim_size 0");
+
+	/* Positive test */
+	test_rcu_qsbr_dq_params(&params);
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq == NULL), "dq create valid params");
+
+	rte_rcu_qsbr_dq_delete(dq);
+
+	return 0;
+}
+
+/*
+ * rte_rcu_qsbr_dq_enqueue/reclaim/delete: resources are only freed, in
+ * order and in batches, once the readers have reported their quiescent
+ * state.
+ */
+static int
+test_rcu_qsbr_dq_reclaim(void)
+{
+	struct rte_rcu_qsbr_dq_parameters params;
+	struct rte_rcu_qsbr_dq *dq;
+	unsigned int freed, pending, available;
+	uint32_t i, n;
+	int ret;
+
+	printf("\nTest rte_rcu_qsbr_dq_enqueue/reclaim/delete()\n");
+
+	rte_rcu_qsbr_init(t[0], RTE_MAX_LCORE);
+	rte_rcu_qsbr_thread_register(t[0], enabled_core_ids[0]);
+	rte_rcu_qsbr_thread_online(t[0], enabled_core_ids[0]);
+
+	test_rcu_qsbr_dq_params(&params);
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq == NULL), "dq create");
+
+	/* Negative tests */
+	i = 0;
+	ret = rte_rcu_qsbr_dq_enqueue(NULL, &i);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 1), "dq enqueue NULL dq");
+	ret = rte_rcu_qsbr_dq_enqueue(dq, NULL);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 1), "dq enqueue NULL data");
+	ret = rte_rcu_qsbr_dq_reclaim(NULL, 1, NULL, NULL, NULL);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 1), "dq reclaim NULL dq");
+	ret = rte_rcu_qsbr_dq_reclaim(dq, 0, NULL, NULL, NULL);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 1), "dq reclaim 0 resources");
+
+	dq_nb_freed = 0;
+	dq_nb_free_calls = 0;
+	for (i = 0; i < 10; i++) {
+		ret = rte_rcu_qsbr_dq_enqueue(dq, &i);
+		TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "dq enqueue");
+	}
+
+	/* The reader has not reported its quiescent state */
+	ret = rte_rcu_qsbr_dq_reclaim(dq, ~0, &freed, &pending, &available);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0 || freed != 0 ||
+		pending != 10 || dq_nb_free_calls != 0),
+		"dq reclaim before quiescent state");
+
+	rte_rcu_qsbr_quiescent(t[0], enabled_core_ids[0]);
+
+	/* At most n resources are freed, in a single call */
+	ret = rte_rcu_qsbr_dq_reclaim(dq, 4, &freed, &pending, NULL);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0 || freed != 4 ||
+		pending != 6 || dq_nb_free_calls != 1),
+		"dq reclaim limited");
+
+	ret = rte_rcu_qsbr_dq_reclaim(dq, ~0, &freed, &pending, &available);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0 || freed != 6 ||
+		pending != 0 || available != TEST_RCU_DQ_SIZE ||
+		dq_nb_free_calls != 2), "dq reclaim all");
+
+	for (i = 0; i < 10; i++)
+		TEST_RCU_QSBR_RETURN_IF_ERROR((dq_freed[i] != i),
+			"dq reclaim order");
+
+	/* The queue holds at least size resources */
+	for (n = 0; n < TEST_RCU_DQ_SIZE * 4; n++)
+		if (rte_rcu_qsbr_dq_enqueue(dq, &n) != 0)
+			break;
+	TEST_RCU_QSBR_RETURN_IF_ERROR((n < TEST_RCU_DQ_SIZE ||
+		rte_errno != ENOSPC), "dq enqueue full");
+
+	/* Resources waiting for the readers can not be deleted */
+	ret = rte_rcu_qsbr_dq_delete(dq);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 1 || rte_errno != EAGAIN),
+		"dq delete pending");
+
+	rte_rcu_qsbr_quiescent(t[0], enabled_core_ids[0]);
+
+	ret = rte_rcu_qsbr_dq_delete(dq);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0 || dq_nb_freed != 10 + n),
+		"dq delete");
+
+	/* Automatic reclamation once trigger_reclaim_limit is reached */
+	test_rcu_qsbr_dq_params(&params);
+	params.trigger_reclaim_limit = 4;
+	params.max_reclaim_size = 2;
+	params.flags = RTE_RCU_QSBR_DQ_MT_UNSAFE;
+	dq = rte_rcu_qsbr_dq_create(&params);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq == NULL), "dq create auto reclaim");
+
+	dq_nb_freed = 0;
+	for (i = 0; i < 4; i++)
+		rte_rcu_qsbr_dq_enqueue(dq, &i);
+	rte_rcu_qsbr_quiescent(t[0], enabled_core_ids[0]);
+	rte_rcu_qsbr_dq_enqueue(dq, &i);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((dq_nb_freed != 2 || dq_freed[0] != 0 ||
+		dq_freed[1] != 1), "dq automatic reclaim");
+
+	rte_rcu_qsbr_quiescent(t[0], enabled_core_ids[0]);
+	ret = rte_rcu_qsbr_dq_delete(dq);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0 || dq_nb_freed != 5),
+		"dq delete auto reclaim");
+
+	/* Deleting NULL is allowed */
+	ret = rte_rcu_qsbr_dq_delete(NULL);
+	TEST_RCU_QSBR_RETURN_IF_ERROR((ret != 0), "dq delete NULL");
+
+	rte_rcu_qsbr_thread_offline(t[0], enabled_core_ids[0]);
+	rte_rcu_qsbr_thread_unregister(t[0], enabled_core_ids[0]);
+
+	return 0;
+}
+
 static int
 test_rcu_qsbr_reader(void *arg)
 {
@@ -1028,6 +1227,12 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_thread_offline() < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_dq_create() < 0)
+		goto test_fail;
+
+	if (test_rcu_qsbr_dq_reclaim() < 0)
+		goto test_fail;
+
 	printf("\nFunctional tests\n");
 
 	if (test_rcu_qsbr_sw_sv_3qs() < 0)
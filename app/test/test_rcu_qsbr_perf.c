@@ -4,6 +4,7 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include <inttypes.h>
 #include <rte_pause.h>
 #include <rte_rcu_qsbr.h>
@@ -276,6 +277,108 @@ test_rcu_qsbr_wperf(void)
 	return 0;
 }
 
+static struct rte_rcu_qsbr_dq *dq;
+static rte_atomic64_t frees;
+
+static void
+test_rcu_qsbr_dq_free(void *p, void *e, unsigned int n)
+{
+	RTE_SET_USED(p);
+	RTE_SET_USED(e);
+
+	rte_atomic64_add(&frees, n);
+}
+
+static int
+test_rcu_qsbr_dq_writer_perf(void *arg)
+{
+	uint64_t loop_cnt = 0;
+	uint64_t begin, cycles;
+
+	RTE_SET_USED(arg);
+
+	begin = rte_rdtsc_precise();
+
+	do {
+		/* Defer freeing of the resource */
+		if (rte_rcu_qsbr_dq_enqueue(dq, &loop_cnt) != 0)
+			rte_rcu_qsbr_dq_reclaim(dq, 32, NULL, NULL, NULL);
+		else
+			loop_cnt++;
+	} while (loop_cnt < 2000000);
+
+	cycles = rte_rdtsc_precise() - begin;
+	rte_atomic64_add(&check_cycles, cycles);
+	rte_atomic64_add(&checks, loop_cnt);
+	return 0;
+}
+
+/*
+ * Perf test: Multiple writers deferring the free of resources on a
+ * single defer queue, with automatic reclamation.
+ */
+static int
+test_rcu_qsbr_dq_wperf(void)
+{
+	struct rte_rcu_qsbr_dq_parameters params;
+	size_t sz;
+	unsigned int i;
+
+	rte_atomic64_clear(&checks);
+	rte_atomic64_clear(&check_cycles);
+	rte_atomic64_clear(&frees);
+
+	printf("\nPerf test: %d Writers, defer queue enqueue\n", num_cores);
+
+	/* No reader is registered, the resources can be freed as soon as
+	 * they are reclaimed.
+	 */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	t[0] = (struct rte_rcu_qsbr *)rte_zmalloc("rcu0", sz,
+						RTE_CACHE_LINE_SIZE);
+	rte_rcu_qsbr_init(t[0], RTE_MAX_LCORE);
+
+	memset(&params, 0, sizeof(params));
+	params.name = "PERF_TEST";
+	params.size = TOTAL_ENTRY;
+	params.esize = sizeof(uint64_t);
+	params.trigger_reclaim_limit = TOTAL_ENTRY / 8;
+	params.max_reclaim_size = 32;
+	params.free_fn = test_rcu_qsbr_dq_free;
+	params.v = t[0];
+	dq = rte_rcu_qsbr_dq_create(&params);
+	if (dq == NULL) {
+		printf("Defer queue creation failed\n");
+		rte_free(t[0]);
+		return -1;
+	}
+
+	/* Writer threads are launched */
+	for (i = 0; i < num_cores; i++)
+		rte_eal_remote_launch(test_rcu_qsbr_dq_writer_perf,
+				NULL, enabled_core_ids[i]);
+
+	/* Wait until all writers have exited */
+	rte_eal_mp_wait_lcore();
+
+	if (rte_rcu_qsbr_dq_delete(dq) != 0) {
+		printf("Defer queue deletion failed\n");
+		rte_free(t[0]);
+		return -1;
+	}
+
+	printf("Total defer queue enqueues = %"PRIi64", frees = %"PRIi64"\n",
+		rte_atomic64_read(&checks), rte_atomic64_read(&frees));
+	printf("Cycles per %d enqueues: %"PRIi64"\n", RCU_SCALE_DOWN,
+		rte_atomic64_read(&check_cycles) /
+		(rte_atomic64_read(&checks) / RCU_SCALE_DOWN));
+
+	rte_free(t[0]);
+
+	return rte_atomic64_read(&frees) == rte_atomic64_read(&checks) ?
+		0 : -1;
+}
+
 /*
  * RCU test cases using rte_hash data structure.
  */
@@ -644,6 +747,9 @@ test_rcu_qsbr_main(void)
 	if (test_rcu_qsbr_wperf() < 0)
 		goto test_fail;
 
+	if (test_rcu_qsbr_dq_wperf() < 0)
+		goto test_fail;
+
 	if (test_rcu_qsbr_sw_sv_1qs() < 0)
 		goto test_fail;
 
@@ -11,6 +11,7 @@
 #include <rte_mbuf.h>
 #include <rte_reorder.h>
 #include <rte_lcore.h>
+#include <rte_launch.h>
 #include <rte_malloc.h>
 
 #include "test.h"
@@ -19,6 +20,8 @@
 #define REORDER_BUFFER_SIZE 16384
 #define NUM_MBUFS (2*REORDER_BUFFER_SIZE)
 #define REORDER_BUFFER_SIZE_INVALID 2049
+#define REORDER_MP_NUM_BUFS 4096
+#define REORDER_MP_TIMEOUT_S 10
 
 struct reorder_unittest_params {
 	struct rte_mempool *p;
@@ -268,8 +271,10 @@ test_reorder_drain(void)
 		ret = -1;
 		goto exit;
 	}
-	if (robufs[0] != NULL)
+	if (robufs[0] != NULL) {
 		rte_pktmbuf_free(robufs[0]);
+		robufs[0] = NULL;
+	}
 
 	/* Insert more packets
 	 * RB[] = {NULL, NULL, NULL, NULL}
@@ -303,8 +308,10 @@ test_reorder_drain(void)
 		goto exit;
 	}
 	for (i = 0; i < 3; i++) {
-		if (robufs[i] != NULL)
+		if (robufs[i] != NULL) {
 			rte_pktmbuf_free(robufs[i]);
+			robufs[i] = NULL;
+		}
 	}
 
 	/*
@@ -330,6 +337,209 @@ test_reorder_drain(void)
 	return ret;
 }
 
+static int
+test_reorder_mp_insert_drain(void)
+{
+	struct rte_reorder_mp_buffer *b;
+	struct rte_mempool *p = test_params->p;
+	const unsigned int size = 8;
+	const unsigned int num_bufs = 13;
+	struct rte_mbuf *bufs[num_bufs];
+	struct rte_mbuf *robufs[num_bufs];
+	unsigned int i, cnt;
+
+	b = rte_reorder_mp_create("test_mp", rte_socket_id(), size, 0);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+	TEST_ASSERT(rte_reorder_mp_create("test_mp", rte_socket_id(), size,
+			0) == NULL && rte_errno == EEXIST,
+			"No error on create() with already existing name");
+
+	for (i = 0; i < num_bufs; i++) {
+		bufs[i] = rte_pktmbuf_alloc(p);
+		TEST_ASSERT_NOT_NULL(bufs[i], "Packet allocation failed\n");
+		bufs[i]->seqn = i;
+	}
+
+	/* 0 is missing: nothing is drained */
+	for (i = 3; i >= 1; i--)
+		TEST_ASSERT_SUCCESS(rte_reorder_mp_insert(b, bufs[i]),
+				"Failed to insert seqn %u", i);
+	cnt = rte_reorder_mp_drain(b, robufs, num_bufs);
+	TEST_ASSERT_EQUAL(cnt, 0, "Drained %u packets across a gap", cnt);
+
+	TEST_ASSERT_SUCCESS(rte_reorder_mp_insert(b, bufs[0]),
+			"Failed to insert seqn 0");
+	cnt = rte_reorder_mp_drain(b, robufs, num_bufs);
+	TEST_ASSERT_EQUAL(cnt, 4, "Drained %u packets instead of 4", cnt);
+	for (i = 0; i < cnt; i++)
+		TEST_ASSERT_EQUAL(robufs[i], bufs[i], "Packet %u out of order", i);
+
+	/* window is now [4, 11] */
+	TEST_ASSERT(rte_reorder_mp_insert(b, bufs[12]) == -1 &&
+			rte_errno == ENOSPC, "No error inserting early packet");
+	TEST_ASSERT(rte_reorder_mp_insert(b, bufs[2]) == -1 &&
+			rte_errno == ERANGE, "No error inserting late packet");
+
+	/* 4 is missing, but the window gets full: it is skipped */
+	cnt = rte_reorder_mp_insert_burst(b, &bufs[5], 7);
+	TEST_ASSERT_EQUAL(cnt, 7, "Inserted %u packets instead of 7", cnt);
+	cnt = rte_reorder_mp_drain(b, robufs, num_bufs);
+	TEST_ASSERT_EQUAL(cnt, 7, "Drained %u packets instead of 7", cnt);
+	for (i = 0; i < cnt; i++)
+		TEST_ASSERT_EQUAL(robufs[i], bufs[i + 5],
+				"Packet %u out of order", i + 5);
+	TEST_ASSERT(rte_reorder_mp_insert(b, bufs[4]) == -1 &&
+			rte_errno == ERANGE, "No error inserting skipped packet");
+
+	/* left in the buffer, freed with it */
+	TEST_ASSERT_SUCCESS(rte_reorder_mp_insert(b, bufs[12]),
+			"Failed to insert seqn 12");
+
+	rte_reorder_mp_free(b);
+	rte_pktmbuf_free(bufs[4]);
+	for (i = 0; i < 4; i++)
+		rte_pktmbuf_free(bufs[i]);
+	for (i = 5; i < 12; i++)
+		rte_pktmbuf_free(bufs[i]);
+
+	return 0;
+}
+
+static int
+test_reorder_mp_timeout(void)
+{
+	struct rte_reorder_mp_buffer *b;
+	struct rte_mempool *p = test_params->p;
+	struct rte_mbuf *m, *robuf;
+	unsigned int cnt;
+
+	b = rte_reorder_mp_create("test_mp_timeout", rte_socket_id(), 16,
+			rte_get_timer_hz() / 1000);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	m = rte_pktmbuf_alloc(p);
+	TEST_ASSERT_NOT_NULL(m, "Packet allocation failed\n");
+	m->seqn = 1;
+	TEST_ASSERT_SUCCESS(rte_reorder_mp_insert(b, m),
+			"Failed to insert seqn 1");
+
+	/* 0 is missing: it is skipped once the timeout has elapsed */
+	cnt = rte_reorder_mp_drain(b, &robuf, 1);
+	TEST_ASSERT_EQUAL(cnt, 0, "Drained a packet across a gap");
+	rte_delay_ms(5);
+	cnt = rte_reorder_mp_drain(b, &robuf, 1);
+	TEST_ASSERT(cnt == 1 && robuf == m, "Gap not skipped after timeout");
+
+	rte_pktmbuf_free(m);
+	rte_reorder_mp_free(b);
+
+	return 0;
+}
+
+struct reorder_mp_worker_params {
+	struct rte_reorder_mp_buffer *b;
+	struct rte_mbuf **bufs;
+	unsigned int first;
+	unsigned int step;
+};
+
+/* Set by a failed worker, or by the main lcore to stop the workers */
+static volatile int reorder_mp_stop;
+
+static int
+reorder_mp_worker(void *arg)
+{
+	struct reorder_mp_worker_params *wp = arg;
+	unsigned int i;
+
+	for (i = wp->first; i < REORDER_MP_NUM_BUFS; i += wp->step) {
+		while (rte_reorder_mp_insert(wp->b, wp->bufs[i]) != 0) {
+			if (rte_errno != ENOSPC || reorder_mp_stop) {
+				reorder_mp_stop = 1;
+				return -1;
+			}
+			rte_pause();
+		}
+	}
+
+	return 0;
+}
+
+static int
+test_reorder_mp_multi(void)
+{
+	struct reorder_mp_worker_params wp[RTE_MAX_LCORE];
+	struct rte_mbuf *bufs[REORDER_MP_NUM_BUFS];
+	struct rte_mbuf *robufs[BURST];
+	struct rte_reorder_mp_buffer *b;
+	unsigned int i, cnt, nb_workers, nb_drained;
+	unsigned int lcore_id;
+	uint64_t deadline;
+	int ret = 0;
+
+	nb_workers = rte_lcore_count() - 1;
+	if (nb_workers == 0) {
+		printf("%s: not enough lcores, skipping\n", __func__);
+		return TEST_SKIPPED;
+	}
+
+	/* never skip gaps */
+	b = rte_reorder_mp_create("test_mp_multi", rte_socket_id(), 256,
+			UINT64_MAX);
+	TEST_ASSERT_NOT_NULL(b, "Failed to create reorder buffer");
+
+	TEST_ASSERT_SUCCESS(rte_pktmbuf_alloc_bulk(test_params->p, bufs,
+			REORDER_MP_NUM_BUFS), "Packet allocation failed\n");
+	for (i = 0; i < REORDER_MP_NUM_BUFS; i++)
+		bufs[i]->seqn = i;
+
+	/* each worker inserts every nb_workers'th packet */
+	reorder_mp_stop = 0;
+	i = 0;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		wp[i].b = b;
+		wp[i].bufs = bufs;
+		wp[i].first = i;
+		wp[i].step = nb_workers;
+		rte_eal_remote_launch(reorder_mp_worker, &wp[i], lcore_id);
+		i++;
+	}
+
+	/* give up if a worker failed or the packets stop coming */
+	deadline = rte_get_timer_cycles() +
+		REORDER_MP_TIMEOUT_S * rte_get_timer_hz();
+	for (nb_drained = 0; nb_drained != REORDER_MP_NUM_BUFS; ) {
+		if (reorder_mp_stop || rte_get_timer_cycles() > deadline) {
+			reorder_mp_stop = 1;
+			break;
+		}
+		cnt = rte_reorder_mp_drain(b, robufs, BURST);
+		for (i = 0; i < cnt; i++) {
+			if (robufs[i] != bufs[nb_drained + i])
+				ret = -1;
+		}
+		nb_drained += cnt;
+	}
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (rte_eal_wait_lcore(lcore_id) < 0)
+			ret = -1;
+	}
+
+	/* after a failure, the packets left in the buffer are freed with it
+	 * and the ones never inserted go away with the mempool
+	 */
+	rte_pktmbuf_free_bulk(bufs, nb_drained);
+	rte_reorder_mp_free(b);
+
+	TEST_ASSERT_EQUAL(nb_drained, REORDER_MP_NUM_BUFS,
+			"Drained %u packets out of %u", nb_drained,
+			REORDER_MP_NUM_BUFS);
+	TEST_ASSERT_SUCCESS(ret, "Packets drained out of order");
+
+	return 0;
+}
+
 static int
 test_setup(void)
 {
@@ -380,6 +590,9 @@ static struct unit_test_suite reorder_test_suite  = {
 		TEST_CASE(test_reorder_free),
 		TEST_CASE(test_reorder_insert),
 		TEST_CASE(test_reorder_drain),
+		TEST_CASE(test_reorder_mp_insert_drain),
+		TEST_CASE(test_reorder_mp_timeout),
+		TEST_CASE(test_reorder_mp_multi),
 		TEST_CASES_END()
 	}
 };
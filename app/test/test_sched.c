@@ -114,6 +114,209 @@ prepare_pkt(struct rte_sched_port *port, struct rte_mbuf *mbuf)
 }
 
 
+#define N_PARTITIONS     2
+#define N_PKTS_PARTITION 5
+
+/**
+ * test port partitions, one per subport
+ */
+static int
+test_sched_port_partition(struct rte_mempool *mp)
+{
+	struct rte_sched_port_params params = port_param;
+	struct rte_sched_port *port, *partition[N_PARTITIONS];
+	struct rte_mbuf *in_mbufs[N_PKTS_PARTITION];
+	struct rte_mbuf *out_mbufs[N_PKTS_PARTITION];
+	uint32_t subport, pipe;
+	int i, err;
+
+	params.name = "test_sched_partition";
+	params.n_subports_per_port = N_PARTITIONS;
+
+	port = rte_sched_port_config(&params);
+	TEST_ASSERT_NOT_NULL(port, "Error config sched port\n");
+
+	for (subport = 0; subport < N_PARTITIONS; subport++) {
+		err = rte_sched_subport_config(port, subport, subport_param);
+		TEST_ASSERT_SUCCESS(err, "Error config sched, err=%d\n", err);
+
+		err = rte_sched_pipe_config(port, subport, PIPE, 0);
+		TEST_ASSERT_SUCCESS(err, "Error config sched pipe, err=%d\n",
+			err);
+	}
+
+	TEST_ASSERT_NULL(rte_sched_port_partition_create(port, 1, N_PARTITIONS),
+		"Partition with invalid subport range created\n");
+	TEST_ASSERT_NULL(rte_sched_port_partition_create(port, 0, 0),
+		"Partition without subports created\n");
+
+	for (subport = 0; subport < N_PARTITIONS; subport++) {
+		partition[subport] =
+			rte_sched_port_partition_create(port, subport, 1);
+		TEST_ASSERT_NOT_NULL(partition[subport],
+			"Error creating port partition %u\n", subport);
+	}
+
+	err = rte_sched_subport_config(partition[0], 0, subport_param);
+	TEST_ASSERT_FAIL(err, "Subport configured through port partition\n");
+
+	for (subport = 0; subport < N_PARTITIONS; subport++) {
+		for (i = 0; i < N_PKTS_PARTITION; i++) {
+			in_mbufs[i] = rte_pktmbuf_alloc(mp);
+			TEST_ASSERT_NOT_NULL(in_mbufs[i],
+				"Packet allocation failed\n");
+			prepare_pkt(port, in_mbufs[i]);
+			rte_sched_port_pkt_write(port, in_mbufs[i], subport,
+				PIPE, TC, QUEUE, RTE_COLOR_GREEN);
+		}
+
+		err = rte_sched_port_enqueue(partition[subport], in_mbufs,
+			N_PKTS_PARTITION);
+		TEST_ASSERT_EQUAL(err, N_PKTS_PARTITION,
+			"Wrong enqueue, err=%d\n", err);
+	}
+
+	for (subport = 0; subport < N_PARTITIONS; subport++) {
+		err = rte_sched_port_dequeue(partition[subport], out_mbufs,
+			N_PKTS_PARTITION);
+		TEST_ASSERT_EQUAL(err, N_PKTS_PARTITION,
+			"Wrong dequeue, err=%d\n", err);
+
+		for (i = 0; i < N_PKTS_PARTITION; i++) {
+			uint32_t pkt_subport, traffic_class, queue;
+
+			rte_sched_port_pkt_read_tree_path(port, out_mbufs[i],
+				&pkt_subport, &pipe, &traffic_class, &queue);
+			TEST_ASSERT_EQUAL(pkt_subport, subport,
+				"Wrong subport\n");
+
+			rte_pktmbuf_free(out_mbufs[i]);
+		}
+
+		err = rte_sched_port_dequeue(partition[subport], out_mbufs,
+			N_PKTS_PARTITION);
+		TEST_ASSERT_EQUAL(err, 0, "Wrong dequeue, err=%d\n", err);
+	}
+
+	for (subport = 0; subport < N_PARTITIONS; subport++)
+		rte_sched_port_free(partition[subport]);
+	rte_sched_port_free(port);
+
+	return 0;
+}
+
+#define LAYOUT_N_QUEUES    4
+#define LAYOUT_N_BE_QUEUES 1
+#define LAYOUT_N_SP_TCS    (LAYOUT_N_QUEUES - LAYOUT_N_BE_QUEUES)
+#define LAYOUT_N_PKTS      8
+
+/**
+ * test port with 4 queues per pipe: 3 strict priority TCs and best-effort
+ */
+static int
+test_sched_pipe_layout(struct rte_mempool *mp)
+{
+	struct rte_sched_port_params params = port_param;
+	struct rte_sched_subport_params sp = subport_param[0];
+	struct rte_sched_subport_params *sp_ptr = &sp;
+	struct rte_sched_pipe_params pp = pipe_profile[0];
+	struct rte_sched_port *port;
+	struct rte_mbuf *in_mbufs[LAYOUT_N_PKTS];
+	struct rte_mbuf *out_mbufs[LAYOUT_N_PKTS];
+	uint32_t n_tc_pkts[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE] = {0};
+	uint32_t footprint, footprint_small, tc, pipe;
+	int i, err;
+
+	params.name = "test_sched_layout";
+	for (tc = LAYOUT_N_SP_TCS; tc < RTE_SCHED_TRAFFIC_CLASS_BE; tc++) {
+		sp.qsize[tc] = 0;
+		sp.tc_rate[tc] = 0;
+		pp.tc_rate[tc] = 0;
+	}
+	sp.pipe_profiles = &pp;
+
+	footprint = rte_sched_port_get_memory_footprint(&params, &sp_ptr);
+	TEST_ASSERT(footprint != 0, "Error getting memory footprint\n");
+
+	/* Invalid layouts */
+	params.n_queues_per_pipe = 2 * RTE_SCHED_QUEUES_PER_PIPE;
+	TEST_ASSERT_NULL(rte_sched_port_config(&params),
+		"Port with too many queues per pipe configured\n");
+
+	params.n_queues_per_pipe = RTE_SCHED_QUEUES_PER_PIPE;
+	params.n_be_queues_per_pipe = 1;
+	TEST_ASSERT_NULL(rte_sched_port_config(&params),
+		"Port with too many strict priority TCs configured\n");
+
+	params.n_queues_per_pipe = LAYOUT_N_QUEUES;
+	params.n_be_queues_per_pipe = LAYOUT_N_BE_QUEUES;
+
+	footprint_small = rte_sched_port_get_memory_footprint(&params, &sp_ptr);
+	TEST_ASSERT(footprint_small != 0 && footprint_small < footprint,
+		"Wrong memory footprint %u, 16 queue pipes need %u\n",
+		footprint_small, footprint);
+
+	sp_ptr = subport_param;
+	TEST_ASSERT_EQUAL(rte_sched_port_get_memory_footprint(&params, &sp_ptr),
+		0, "Subport with TC not in the pipe accepted\n");
+
+	port = rte_sched_port_config(&params);
+	TEST_ASSERT_NOT_NULL(port, "Error config sched port\n");
+
+	err = rte_sched_subport_config(port, SUBPORT, &sp);
+	TEST_ASSERT_SUCCESS(err, "Error config sched, err=%d\n", err);
+
+	for (pipe = 0; pipe < sp.n_pipes_per_subport_enabled; pipe++) {
+		err = rte_sched_pipe_config(port, SUBPORT, pipe, 0);
+		TEST_ASSERT_SUCCESS(err, "Error config sched pipe %u, err=%d\n",
+			pipe, err);
+	}
+
+	/* Two packets for each TC of the pipe, on different pipes */
+	for (i = 0; i < LAYOUT_N_PKTS; i++) {
+		tc = i % LAYOUT_N_QUEUES;
+		if (tc == LAYOUT_N_SP_TCS)
+			tc = RTE_SCHED_TRAFFIC_CLASS_BE;
+
+		in_mbufs[i] = rte_pktmbuf_alloc(mp);
+		TEST_ASSERT_NOT_NULL(in_mbufs[i], "Packet allocation failed\n");
+		prepare_pkt(port, in_mbufs[i]);
+		rte_sched_port_pkt_write(port, in_mbufs[i], SUBPORT, i, tc, 0,
+			RTE_COLOR_GREEN);
+	}
+
+	err = rte_sched_port_enqueue(port, in_mbufs, LAYOUT_N_PKTS);
+	TEST_ASSERT_EQUAL(err, LAYOUT_N_PKTS, "Wrong enqueue, err=%d\n", err);
+
+	err = rte_sched_port_dequeue(port, out_mbufs, LAYOUT_N_PKTS);
+	TEST_ASSERT_EQUAL(err, LAYOUT_N_PKTS, "Wrong dequeue, err=%d\n", err);
+
+	for (i = 0; i < LAYOUT_N_PKTS; i++) {
+		uint32_t subport, traffic_class, queue;
+
+		rte_sched_port_pkt_read_tree_path(port, out_mbufs[i],
+			&subport, &pipe, &traffic_class, &queue);
+		TEST_ASSERT_EQUAL(subport, SUBPORT, "Wrong subport\n");
+		TEST_ASSERT(pipe < LAYOUT_N_PKTS, "Wrong pipe\n");
+		TEST_ASSERT_EQUAL(queue, 0, "Wrong queue\n");
+		n_tc_pkts[traffic_class]++;
+
+		rte_pktmbuf_free(out_mbufs[i]);
+	}
+
+	for (tc = 0; tc < LAYOUT_N_SP_TCS; tc++)
+		TEST_ASSERT_EQUAL(n_tc_pkts[tc], 2, "Wrong TC %u\n", tc);
+	TEST_ASSERT_EQUAL(n_tc_pkts[RTE_SCHED_TRAFFIC_CLASS_BE], 2,
+		"Wrong best-effort TC\n");
+
+	err = rte_sched_port_dequeue(port, out_mbufs, LAYOUT_N_PKTS);
+	TEST_ASSERT_EQUAL(err, 0, "Wrong dequeue, err=%d\n", err);
+
+	rte_sched_port_free(port);
+
+	return 0;
+}
+
 /**
  * test main entrance for library sched
  */
@@ -192,7 +395,11 @@ test_sched(void)
 
 	rte_sched_port_free(port);
 
-	return 0;
+	err = test_sched_port_partition(mp);
+	if (err != 0)
+		return err;
+
+	return test_sched_pipe_layout(mp);
 }
 
 REGISTER_TEST_COMMAND(sched_autotest, test_sched);
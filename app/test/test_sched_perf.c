@@ -0,0 +1,206 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_mbuf.h>
+#include <rte_random.h>
+#include <rte_sched.h>
+
+#include "test.h"
+
+#define PERF_RATE        4000000000ULL /* bytes per second */
+#define PERF_N_PIPES     4096
+#define PERF_QSIZE       64
+#define PERF_BURST       64
+#define PERF_ITERATIONS  (1 << 16)
+#define PERF_N_QIDS      (1 << 16)
+#define PERF_PKT_LEN     64
+
+#define NB_MBUF          (2 * PERF_BURST)
+#define MBUF_DATA_SZ     (2048 + RTE_PKTMBUF_HEADROOM)
+
+static struct rte_sched_pipe_params pipe_profile[] = {
+	{ /* Profile #0 */
+		.tb_rate = PERF_RATE,
+		.tb_size = 1000000,
+
+		.tc_rate = {PERF_RATE, PERF_RATE, PERF_RATE, PERF_RATE,
+			PERF_RATE, PERF_RATE, PERF_RATE, PERF_RATE, PERF_RATE,
+			PERF_RATE, PERF_RATE, PERF_RATE, PERF_RATE},
+		.tc_period = 40,
+		.tc_ov_weight = 1,
+
+		.wrr_weights = {1, 1, 1, 1},
+	},
+};
+
+static struct rte_sched_subport_params subport_param = {
+	.tb_rate = PERF_RATE,
+	.tb_size = 1000000,
+
+	.tc_rate = {PERF_RATE, PERF_RATE, PERF_RATE, PERF_RATE,
+		PERF_RATE, PERF_RATE, PERF_RATE, PERF_RATE, PERF_RATE,
+		PERF_RATE, PERF_RATE, PERF_RATE, PERF_RATE},
+	.tc_period = 10,
+	.n_pipes_per_subport_enabled = PERF_N_PIPES,
+	.qsize = {PERF_QSIZE, PERF_QSIZE, PERF_QSIZE, PERF_QSIZE, PERF_QSIZE,
+		PERF_QSIZE, PERF_QSIZE, PERF_QSIZE, PERF_QSIZE, PERF_QSIZE,
+		PERF_QSIZE, PERF_QSIZE, PERF_QSIZE},
+	.pipe_profiles = pipe_profile,
+	.n_pipe_profiles = 1,
+	.n_max_pipe_profiles = 1,
+};
+
+static struct rte_sched_port_params port_param = {
+	.name = "test_sched_perf",
+	.socket = 0, /* computed */
+	.rate = PERF_RATE,
+	.mtu = 1522,
+	.frame_overhead = RTE_SCHED_FRAME_OVERHEAD_DEFAULT,
+	.n_subports_per_port = 1,
+	.n_pipes_per_subport = PERF_N_PIPES,
+};
+
+static uint32_t qids[PERF_N_QIDS][4]; /* pipe, tc, queue, color */
+
+enum perf_type {
+	perf_type_random,
+	perf_type_single_pipe,
+};
+
+static const char *
+perf_type_desc(enum perf_type perf_type)
+{
+	switch (perf_type) {
+	case perf_type_random:
+		return "Random pipes";
+	case perf_type_single_pipe:
+		return "Single pipe";
+	default:
+		return NULL;
+	}
+}
+
+static void
+perf_qids_init(enum perf_type perf_type)
+{
+	uint32_t i;
+
+	for (i = 0; i < PERF_N_QIDS; i++) {
+		uint32_t tc = rte_rand_max(RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE);
+
+		qids[i][0] = (perf_type == perf_type_random) ?
+			rte_rand_max(PERF_N_PIPES) : 0;
+		qids[i][1] = tc;
+		qids[i][2] = (tc == RTE_SCHED_TRAFFIC_CLASS_BE) ?
+			rte_rand_max(RTE_SCHED_BE_QUEUES_PER_PIPE) : 0;
+		qids[i][3] = rte_rand_max(RTE_COLORS);
+	}
+}
+
+static int
+test_sched_perf_type(struct rte_mempool *mp, enum perf_type perf_type)
+{
+	struct rte_mbuf *pkts[PERF_BURST], *out[PERF_BURST];
+	struct rte_sched_port *port;
+	uint64_t enq_cycles = 0, deq_cycles = 0, n_enq = 0, n_deq = 0;
+	uint32_t i, j, k, n_pkts, qid = 0;
+	int err;
+
+	port_param.socket = rte_socket_id();
+	port = rte_sched_port_config(&port_param);
+	TEST_ASSERT_NOT_NULL(port, "Error config sched port\n");
+
+	err = rte_sched_subport_config(port, 0, &subport_param);
+	TEST_ASSERT_SUCCESS(err, "Error config sched, err=%d\n", err);
+
+	for (i = 0; i < PERF_N_PIPES; i++) {
+		err = rte_sched_pipe_config(port, 0, i, 0);
+		TEST_ASSERT_SUCCESS(err, "Error config sched pipe %u, err=%d\n",
+			i, err);
+	}
+
+	perf_qids_init(perf_type);
+
+	err = rte_pktmbuf_alloc_bulk(mp, pkts, PERF_BURST);
+	TEST_ASSERT_SUCCESS(err, "Error allocating mbufs\n");
+
+	for (i = 0; i < PERF_ITERATIONS; i++) {
+		uint64_t start;
+
+		for (j = 0; j < PERF_BURST; j++) {
+			uint32_t *q = qids[qid++ & (PERF_N_QIDS - 1)];
+
+			rte_sched_port_pkt_write(port, pkts[j], 0, q[0], q[1],
+				q[2], (enum rte_color)q[3]);
+			pkts[j]->pkt_len = PERF_PKT_LEN;
+			pkts[j]->data_len = PERF_PKT_LEN;
+		}
+
+		start = rte_rdtsc();
+		n_pkts = rte_sched_port_enqueue(port, pkts, PERF_BURST);
+		enq_cycles += rte_rdtsc() - start;
+		n_enq += n_pkts;
+
+		/* Drain the port, the mbufs are reused for the next burst */
+		for (k = 0; k < n_pkts; ) {
+			uint32_t n;
+
+			start = rte_rdtsc();
+			n = rte_sched_port_dequeue(port, out + k, n_pkts - k);
+			deq_cycles += rte_rdtsc() - start;
+			k += n;
+		}
+		n_deq += n_pkts;
+
+		/* Replace the dropped mbufs */
+		if (n_pkts < PERF_BURST) {
+			err = rte_pktmbuf_alloc_bulk(mp, out + n_pkts,
+				PERF_BURST - n_pkts);
+			TEST_ASSERT_SUCCESS(err, "Error allocating mbufs\n");
+		}
+
+		memcpy(pkts, out, sizeof(pkts));
+	}
+
+	printf("%-14s enqueue: %6.2f cycles/pkt, dequeue: %6.2f cycles/pkt, "
+		"dropped: %" PRIu64 "\n", perf_type_desc(perf_type),
+		(double)enq_cycles / n_enq, (double)deq_cycles / n_deq,
+		(uint64_t)PERF_ITERATIONS * PERF_BURST - n_enq);
+
+	rte_pktmbuf_free_bulk(pkts, PERF_BURST);
+	rte_sched_port_free(port);
+
+	return 0;
+}
+
+static int
+test_sched_perf(void)
+{
+	struct rte_mempool *mp;
+	int err;
+
+	mp = rte_pktmbuf_pool_create("test_sched_perf", NB_MBUF, 0, 0,
+		MBUF_DATA_SZ, SOCKET_ID_ANY);
+	TEST_ASSERT_NOT_NULL(mp, "Error creating mempool\n");
+
+	printf("Burst size: %u, pipes: %u, queue size: %u\n",
+		PERF_BURST, PERF_N_PIPES, PERF_QSIZE);
+
+	err = test_sched_perf_type(mp, perf_type_random);
+	if (err == 0)
+		err = test_sched_perf_type(mp, perf_type_single_pipe);
+
+	rte_mempool_free(mp);
+
+	return err;
+}
+
+REGISTER_TEST_COMMAND(sched_perf_autotest, test_sched_perf);
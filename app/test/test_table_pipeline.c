@@ -4,9 +4,13 @@
 
 #include <string.h>
 #include <rte_pipeline.h>
+#include <rte_table_action.h>
 #include <rte_log.h>
 #include <inttypes.h>
 #include <rte_hexdump.h>
+#include <rte_malloc.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
 #include "test_table.h"
 #include "test_table_pipeline.h"
 
@@ -500,6 +504,322 @@ test_pipeline_single_filter(int test_type, int expected_count)
 
 }
 
+/*
+ * Fused table action test: the same bursts go through an ENCAP + NAT + TTL +
+ * STATS profile, which gets the fused hit handler, and through the same
+ * profile plus TIME, which keeps the default handler. Both must leave the
+ * packets and the rule counters byte for byte identical.
+ */
+#define FUSED_N_PKTS		7
+#define FUSED_N_RULES		2
+#define FUSED_IP_OFFSET		(sizeof(struct rte_mbuf) +		\
+	RTE_PKTMBUF_HEADROOM + sizeof(struct rte_ether_hdr))
+
+struct fused_test_action {
+	struct rte_table_action *action;
+	struct rte_pipeline_table_params params;
+	struct rte_pipeline_table_entry *entries[FUSED_N_RULES];
+};
+
+static void
+fused_test_action_free(struct fused_test_action *t)
+{
+	uint32_t i;
+
+	for (i = 0; i < FUSED_N_RULES; i++)
+		rte_free(t->entries[i]);
+	rte_table_action_free(t->action);
+}
+
+static int
+fused_test_action_create(struct fused_test_action *t, int fused)
+{
+	struct rte_table_action_common_config common = {
+		.ip_version = 1,
+		.ip_offset = FUSED_IP_OFFSET,
+	};
+	struct rte_table_action_encap_config encap = {
+		.encap_mask = 1LLU << RTE_TABLE_ACTION_ENCAP_ETHER,
+	};
+	struct rte_table_action_nat_config nat = {
+		.source_nat = 1,
+		.proto = IPPROTO_TCP,
+	};
+	struct rte_table_action_ttl_config ttl = {
+		.drop = 1,
+		.n_packets_enabled = 1,
+	};
+	struct rte_table_action_stats_config stats = {
+		.n_packets_enabled = 1,
+		.n_bytes_enabled = 1,
+	};
+	struct rte_table_action_profile *profile;
+	uint32_t i;
+	int status = 0;
+
+	memset(t, 0, sizeof(*t));
+
+	profile = rte_table_action_profile_create(&common);
+	if (profile == NULL)
+		return -1;
+
+	status |= rte_table_action_profile_action_register(profile,
+		RTE_TABLE_ACTION_ENCAP, &encap);
+	status |= rte_table_action_profile_action_register(profile,
+		RTE_TABLE_ACTION_NAT, &nat);
+	status |= rte_table_action_profile_action_register(profile,
+		RTE_TABLE_ACTION_TTL, &ttl);
+	status |= rte_table_action_profile_action_register(profile,
+		RTE_TABLE_ACTION_STATS, &stats);
+	if (!fused)
+		status |= rte_table_action_profile_action_register(profile,
+			RTE_TABLE_ACTION_TIME, NULL);
+	status |= rte_table_action_profile_freeze(profile);
+	if (status == 0)
+		t->action = rte_table_action_create(profile, 0);
+	rte_table_action_profile_free(profile);
+	if (t->action == NULL)
+		return -1;
+
+	if (rte_table_action_table_params_get(t->action, &t->params) != 0)
+		return -1;
+
+	for (i = 0; i < FUSED_N_RULES; i++) {
+		struct rte_table_action_fwd_params fwd_params = {
+			.action = RTE_PIPELINE_ACTION_PORT,
+			.id = 0,
+		};
+		struct rte_table_action_encap_params encap_params = {
+			.type = RTE_TABLE_ACTION_ENCAP_ETHER,
+			.ether.ether = {
+				.da.addr_bytes = {0x02, 0, 0, 0, 1, i},
+				.sa.addr_bytes = {0x02, 0, 0, 0, 2, i},
+			},
+		};
+		struct rte_table_action_nat_params nat_params = {
+			.ip_version = 1,
+			.addr.ipv4 = RTE_IPV4(10, 0, 0, 1 + i),
+			.port = 5000 + i,
+		};
+		struct rte_table_action_ttl_params ttl_params = {
+			.decrement = 1,
+		};
+		struct rte_table_action_stats_params stats_params = {
+			.n_packets = 0,
+			.n_bytes = 0,
+		};
+		void *data;
+
+		data = rte_zmalloc(NULL, sizeof(struct rte_pipeline_table_entry) +
+			t->params.action_data_size, RTE_CACHE_LINE_SIZE);
+		if (data == NULL)
+			return -1;
+		t->entries[i] = data;
+
+		status |= rte_table_action_apply(t->action, data,
+			RTE_TABLE_ACTION_FWD, &fwd_params);
+		status |= rte_table_action_apply(t->action, data,
+			RTE_TABLE_ACTION_ENCAP, &encap_params);
+		status |= rte_table_action_apply(t->action, data,
+			RTE_TABLE_ACTION_NAT, &nat_params);
+		status |= rte_table_action_apply(t->action, data,
+			RTE_TABLE_ACTION_TTL, &ttl_params);
+		status |= rte_table_action_apply(t->action, data,
+			RTE_TABLE_ACTION_STATS, &stats_params);
+	}
+
+	return (status == 0) ? 0 : -1;
+}
+
+/* Ethernet + IPv4 + TCP; every third packet arrives with TTL 1. */
+static struct rte_mbuf *
+fused_test_pkt_create(uint32_t id)
+{
+	uint16_t payload_len = 16 + 5 * id;
+	uint16_t ip_len = sizeof(struct rte_ipv4_hdr) +
+		sizeof(struct rte_tcp_hdr) + payload_len;
+	struct rte_ether_hdr *eth;
+	struct rte_ipv4_hdr *ip;
+	struct rte_tcp_hdr *tcp;
+	struct rte_mbuf *m;
+	uint8_t *payload;
+	uint16_t i;
+
+	m = rte_pktmbuf_alloc(pool);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+		sizeof(struct rte_ether_hdr) + ip_len);
+	if (eth == NULL) {
+		rte_pktmbuf_free(m);
+		return NULL;
+	}
+
+	memset(eth, 0, sizeof(*eth));
+	eth->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+
+	ip = (struct rte_ipv4_hdr *)&eth[1];
+	memset(ip, 0, sizeof(*ip));
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(ip_len);
+	ip->packet_id = rte_cpu_to_be_16(id);
+	ip->time_to_live = (id % 3) ? 64 : 1;
+	ip->next_proto_id = IPPROTO_TCP;
+	ip->src_addr = rte_cpu_to_be_32(RTE_IPV4(192, 168, 0, 1 + id));
+	ip->dst_addr = rte_cpu_to_be_32(RTE_IPV4(192, 168, 1, 1));
+
+	tcp = (struct rte_tcp_hdr *)&ip[1];
+	memset(tcp, 0, sizeof(*tcp));
+	tcp->src_port = rte_cpu_to_be_16(1024 + id);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(id * 1000);
+	tcp->data_off = (sizeof(struct rte_tcp_hdr) / 4) << 4;
+	tcp->tcp_flags = RTE_TCP_ACK_FLAG;
+
+	payload = (uint8_t *)&tcp[1];
+	for (i = 0; i < payload_len; i++)
+		payload[i] = (uint8_t)(id + i);
+
+	tcp->cksum = rte_ipv4_udptcp_cksum(ip, tcp);
+	ip->hdr_checksum = rte_ipv4_cksum(ip);
+
+	return m;
+}
+
+static int
+test_table_action_fused(void)
+{
+	/* One full burst (4-packet group plus tail), then a sparse mask. */
+	static const uint64_t masks[] = {
+		(1LLU << FUSED_N_PKTS) - 1,
+		0x5A,
+	};
+	struct rte_pipeline_params pipeline_params = {
+		.name = "PIPELINE_FUSED",
+		.socket_id = 0,
+	};
+	struct fused_test_action t[2];
+	struct rte_pipeline *pipeline = NULL;
+	uint64_t n_pkts[FUSED_N_RULES] = {0};
+	uint64_t n_bytes[FUSED_N_RULES] = {0};
+	uint64_t n_ttl_drops[FUSED_N_RULES] = {0};
+	uint32_t i, k, r;
+	int ret = -1;
+
+	memset(t, 0, sizeof(t));
+	if (fused_test_action_create(&t[0], 1) != 0 ||
+		fused_test_action_create(&t[1], 0) != 0) {
+		RTE_LOG(INFO, PIPELINE, "%s: Failed to create table actions\n",
+			__func__);
+		goto end;
+	}
+
+	if (t[0].params.f_action_hit == NULL ||
+		t[1].params.f_action_hit == NULL ||
+		t[0].params.f_action_hit == t[1].params.f_action_hit) {
+		RTE_LOG(INFO, PIPELINE, "%s: Fused profile did not get its own "
+			"hit handler\n", __func__);
+		goto end;
+	}
+
+	pipeline = rte_pipeline_create(&pipeline_params);
+	if (pipeline == NULL) {
+		RTE_LOG(INFO, PIPELINE, "%s: Failed to configure pipeline\n",
+			__func__);
+		goto end;
+	}
+
+	for (r = 0; r < RTE_DIM(masks); r++) {
+		struct rte_mbuf *pkts[2][FUSED_N_PKTS] = {{NULL}};
+		struct rte_pipeline_table_entry *entries[2][FUSED_N_PKTS];
+		int ok = 1;
+
+		for (k = 0; k < 2; k++)
+			for (i = 0; i < FUSED_N_PKTS; i++) {
+				pkts[k][i] = fused_test_pkt_create(i);
+				if (pkts[k][i] == NULL)
+					ok = 0;
+				entries[k][i] = t[k].entries[i % FUSED_N_RULES];
+			}
+
+		for (k = 0; ok && k < 2; k++)
+			t[k].params.f_action_hit(pipeline, pkts[k], masks[r],
+				entries[k], t[k].params.arg_ah);
+
+		for (i = 0; ok && i < FUSED_N_PKTS; i++) {
+			struct rte_mbuf *m0 = pkts[0][i], *m1 = pkts[1][i];
+			struct rte_ipv4_hdr *ip = (struct rte_ipv4_hdr *)
+				RTE_MBUF_METADATA_UINT8_PTR(m0, FUSED_IP_OFFSET);
+			uint32_t rule = i % FUSED_N_RULES;
+			uint32_t src_addr = (masks[r] & (1LLU << i)) ?
+				RTE_IPV4(10, 0, 0, 1 + rule) :
+				RTE_IPV4(192, 168, 0, 1 + i);
+
+			if (m0->data_off != m1->data_off ||
+				m0->pkt_len != m1->pkt_len ||
+				m0->data_len != m1->data_len ||
+				memcmp(rte_pktmbuf_mtod(m0, void *),
+					rte_pktmbuf_mtod(m1, void *),
+					m0->data_len) != 0) {
+				RTE_LOG(INFO, PIPELINE, "%s: Packet %u of burst "
+					"%u differs\n", __func__, i, r);
+				ok = 0;
+			} else if (ip->src_addr != rte_cpu_to_be_32(src_addr)) {
+				RTE_LOG(INFO, PIPELINE, "%s: Packet %u of burst "
+					"%u has wrong NAT state\n",
+					__func__, i, r);
+				ok = 0;
+			}
+
+			if (masks[r] & (1LLU << i)) {
+				n_pkts[rule]++;
+				n_bytes[rule] += sizeof(struct rte_ipv4_hdr) +
+					sizeof(struct rte_tcp_hdr) + 16 + 5 * i;
+				n_ttl_drops[rule] += (i % 3) ? 0 : 1;
+			}
+		}
+
+		for (k = 0; k < 2; k++)
+			for (i = 0; i < FUSED_N_PKTS; i++)
+				rte_pktmbuf_free(pkts[k][i]);
+
+		if (!ok)
+			goto end;
+	}
+
+	for (i = 0; i < FUSED_N_RULES; i++) {
+		struct rte_table_action_stats_counters stats[2];
+		struct rte_table_action_ttl_counters ttl[2];
+
+		for (k = 0; k < 2; k++)
+			if (rte_table_action_stats_read(t[k].action,
+					t[k].entries[i], &stats[k], 1) != 0 ||
+				rte_table_action_ttl_read(t[k].action,
+					t[k].entries[i], &ttl[k], 1) != 0)
+				goto end;
+
+		if (stats[0].n_packets != n_pkts[i] ||
+			stats[1].n_packets != n_pkts[i] ||
+			stats[0].n_bytes != n_bytes[i] ||
+			stats[1].n_bytes != n_bytes[i] ||
+			ttl[0].n_packets != n_ttl_drops[i] ||
+			ttl[1].n_packets != n_ttl_drops[i]) {
+			RTE_LOG(INFO, PIPELINE, "%s: Counters of rule %u "
+				"differ\n", __func__, i);
+			goto end;
+		}
+	}
+
+	ret = 0;
+end:
+	if (pipeline != NULL)
+		rte_pipeline_free(pipeline);
+	fused_test_action_free(&t[1]);
+	fused_test_action_free(&t[0]);
+	return ret;
+}
+
 int
 test_table_pipeline(void)
 {
@@ -567,5 +887,11 @@ test_table_pipeline(void)
 		return -1;
 	}
 
+	if (test_table_action_fused() < 0) {
+		RTE_LOG(INFO, PIPELINE, "%s: Fused table action test "
+			"failed.\n", __func__);
+		return -1;
+	}
+
 	return 0;
 }
@@ -7,6 +7,11 @@
 #include <rte_table_lpm_ipv6.h>
 #include <rte_lru.h>
 #include <rte_cycles.h>
+#include <rte_malloc.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_pause.h>
+#include <rte_rcu_qsbr.h>
 #include "test_table_tables.h"
 #include "test_table.h"
 
@@ -18,6 +23,7 @@ table_test table_tests[] = {
 	test_table_hash_lru,
 	test_table_hash_ext,
 	test_table_hash_cuckoo,
+	test_table_rcu,
 };
 
 #define PREPARE_PACKET(mbuf, value) do {				\
@@ -1051,3 +1057,424 @@ test_table_hash_cuckoo(void)
 
 	return 0;
 }
+
+static int
+test_table_hash_rcu_generic(struct rte_table_ops *ops, struct rte_rcu_qsbr *qsv)
+{
+	int status, i;
+	uint64_t expected_mask = 0, result_mask;
+	struct rte_mbuf *mbufs[RTE_PORT_IN_BURST_SIZE_MAX];
+	void *table;
+	char *entries[RTE_PORT_IN_BURST_SIZE_MAX];
+	char entry;
+	void *entry_ptr, *entry_ptr_old;
+	int key_found;
+
+	/* Initialize params and create tables */
+	struct rte_table_hash_params hash_params = {
+		.name = "TABLE",
+		.key_size = 32,
+		.key_offset = APP_METADATA_OFFSET(32),
+		.key_mask = NULL,
+		.n_keys = 1 << 10,
+		.n_buckets = 1 << 10,
+		.f_hash = pipeline_test_hash,
+		.seed = 0,
+		.qsv = qsv,
+	};
+
+	table = ops->f_create(&hash_params, 0, 1);
+	if (table == NULL)
+		return -1;
+
+	/* Add */
+	uint8_t key[32];
+	uint32_t *k32 = (uint32_t *) &key;
+
+	memset(key, 0, 32);
+	k32[0] = rte_be_to_cpu_32(0xadadadad);
+
+	entry = 'A';
+	status = ops->f_add(table, &key, &entry, &key_found, &entry_ptr);
+	if (status != 0 || key_found != 0)
+		return -2;
+
+	/* Update: the entry is relocated */
+	entry_ptr_old = entry_ptr;
+	entry = 'B';
+	status = ops->f_add(table, &key, &entry, &key_found, &entry_ptr);
+	if (status != 0 || key_found != 1 || entry_ptr == entry_ptr_old ||
+		*(char *)entry_ptr != 'B')
+		return -3;
+
+	/* Traffic flow */
+	for (i = 0; i < RTE_PORT_IN_BURST_SIZE_MAX; i++)
+		if (i % 2 == 0) {
+			expected_mask |= (uint64_t)1 << i;
+			PREPARE_PACKET(mbufs[i], 0xadadadad);
+		} else
+			PREPARE_PACKET(mbufs[i], 0xadadadab);
+
+	ops->f_lookup(table, mbufs, -1, &result_mask, (void **)entries);
+	if (result_mask != expected_mask)
+		return -4;
+
+	for (i = 0; i < RTE_PORT_IN_BURST_SIZE_MAX; i += 2)
+		if (*entries[i] != 'B')
+			return -5;
+
+	/* Delete */
+	status = ops->f_delete(table, &key, &key_found, &entry);
+	if (status != 0 || key_found != 1 || entry != 'B')
+		return -6;
+
+	ops->f_lookup(table, mbufs, -1, &result_mask, (void **)entries);
+	if (result_mask != 0)
+		return -7;
+
+	/* Free resources */
+	for (i = 0; i < RTE_PORT_IN_BURST_SIZE_MAX; i++)
+		rte_pktmbuf_free(mbufs[i]);
+
+	status = ops->f_free(table);
+
+	return 0;
+}
+
+static int
+test_table_array_rcu(struct rte_rcu_qsbr *qsv)
+{
+	int status, i;
+	uint64_t result_mask;
+	struct rte_mbuf *mbufs[RTE_PORT_IN_BURST_SIZE_MAX];
+	void *table;
+	char *entries[RTE_PORT_IN_BURST_SIZE_MAX];
+	char entry;
+	void *entry_ptr, *entry_ptr_old;
+	int key_found;
+
+	struct rte_table_array_params array_params = {
+		.n_entries = 1 << 10,
+		.offset = APP_METADATA_OFFSET(32),
+		.qsv = qsv,
+	};
+	struct rte_table_array_key array_key = {
+		.pos = 10,
+	};
+
+	table = rte_table_array_ops.f_create(&array_params, 0, 1);
+	if (table == NULL)
+		return -1;
+
+	entry = 'A';
+	status = rte_table_array_ops.f_add(table, (void *) &array_key,
+		&entry, &key_found, &entry_ptr);
+	if (status != 0)
+		return -2;
+
+	/* Update: the entry is relocated */
+	entry_ptr_old = entry_ptr;
+	entry = 'B';
+	status = rte_table_array_ops.f_add(table, (void *) &array_key,
+		&entry, &key_found, &entry_ptr);
+	if (status != 0 || entry_ptr == entry_ptr_old)
+		return -3;
+
+	for (i = 0; i < RTE_PORT_IN_BURST_SIZE_MAX; i++)
+		PREPARE_PACKET(mbufs[i], (i % 2 == 0) ? 10 : 20);
+
+	rte_table_array_ops.f_lookup(table, mbufs, -1,
+		&result_mask, (void **)entries);
+
+	for (i = 0; i < RTE_PORT_IN_BURST_SIZE_MAX; i++)
+		if (i % 2 == 0 && *entries[i] != 'B')
+			return -4;
+		else
+			if (i % 2 == 1 && *entries[i] != 0)
+				return -4;
+
+	/* Free resources */
+	for (i = 0; i < RTE_PORT_IN_BURST_SIZE_MAX; i++)
+		rte_pktmbuf_free(mbufs[i]);
+
+	status = rte_table_array_ops.f_free(table);
+
+	return 0;
+}
+
+/*
+ * Concurrent RCU test: one reader lcore runs the lookup and reports its
+ * quiescent states while the control thread adds, updates and deletes the
+ * keys. Every entry word holds the key id and the entry version, so that the
+ * reader can detect a torn entry or an entry recycled for another key.
+ */
+#define RCU_TEST_N_KEYS RTE_PORT_IN_BURST_SIZE_MAX
+#define RCU_TEST_N_ROUNDS 64
+#define RCU_TEST_ENTRY_WORDS 4
+
+struct rcu_test_entry {
+	uint64_t w[RCU_TEST_ENTRY_WORDS];
+};
+
+struct rcu_test_reader {
+	struct rte_rcu_qsbr *qsv;
+	struct rte_table_ops *ops;
+	void *table;
+	int be_keys;
+	volatile int ready;
+	volatile int stop;
+	volatile uint64_t n_writes;
+	volatile uint64_t n_lookups;
+	uint64_t n_errors;
+};
+
+static uint32_t
+rcu_test_key(uint32_t key_id, int be_keys)
+{
+	return be_keys ? rte_cpu_to_be_32(key_id) : key_id;
+}
+
+static int
+rcu_test_reader_main(void *arg)
+{
+	struct rcu_test_reader *r = arg;
+	struct rte_mbuf *mbufs[RCU_TEST_N_KEYS];
+	struct rcu_test_entry *entries[RCU_TEST_N_KEYS];
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t result_mask, n_writes, hold_end;
+	uint32_t i, j;
+
+	for (i = 0; i < RCU_TEST_N_KEYS; i++)
+		PREPARE_PACKET(mbufs[i], rcu_test_key(i, r->be_keys));
+
+	rte_rcu_qsbr_thread_register(r->qsv, lcore_id);
+	rte_rcu_qsbr_thread_online(r->qsv, lcore_id);
+	r->ready = 1;
+
+	while (r->stop == 0) {
+		r->ops->f_lookup(r->table, mbufs, RTE_LEN2MASK(RCU_TEST_N_KEYS,
+			uint64_t), &result_mask, (void **)entries);
+
+		/* Hold the entries while the writer makes progress: without
+		 * the RCU protection, it would recycle them for other keys
+		 */
+		n_writes = r->n_writes;
+		hold_end = rte_get_timer_cycles() + rte_get_timer_hz() / 200;
+		while (r->n_writes - n_writes < RCU_TEST_N_KEYS &&
+			rte_get_timer_cycles() < hold_end)
+			rte_pause();
+
+		for (i = 0; i < RCU_TEST_N_KEYS; i++) {
+			struct rcu_test_entry *e = entries[i];
+			uint64_t w0;
+
+			if ((result_mask & (1LLU << i)) == 0)
+				continue;
+
+			/* Never added array entries are zero */
+			w0 = e->w[0];
+			if (w0 == 0)
+				continue;
+
+			if ((w0 >> 32) != i)
+				r->n_errors++;
+			for (j = 1; j < RCU_TEST_ENTRY_WORDS; j++)
+				if (e->w[j] != w0)
+					r->n_errors++;
+		}
+
+		r->n_lookups++;
+		rte_rcu_qsbr_quiescent(r->qsv, lcore_id);
+	}
+
+	rte_rcu_qsbr_thread_offline(r->qsv, lcore_id);
+	rte_rcu_qsbr_thread_unregister(r->qsv, lcore_id);
+
+	for (i = 0; i < RCU_TEST_N_KEYS; i++)
+		rte_pktmbuf_free(mbufs[i]);
+
+	return 0;
+}
+
+static int
+rcu_test_entry_add(struct rte_table_ops *ops, void *table, uint32_t key_id,
+	int be_keys, uint32_t version)
+{
+	struct rcu_test_entry entry;
+	struct rte_table_array_key array_key;
+	uint8_t key[32];
+	void *key_ptr, *entry_ptr;
+	int key_found, status;
+	uint32_t j;
+
+	memset(key, 0, sizeof(key));
+	*(uint32_t *)key = rcu_test_key(key_id, be_keys);
+	array_key.pos = key_id;
+	key_ptr = be_keys ? (void *)key : (void *)&array_key;
+
+	for (j = 0; j < RCU_TEST_ENTRY_WORDS; j++)
+		entry.w[j] = ((uint64_t)key_id << 32) | version;
+
+	status = ops->f_add(table, key_ptr, &entry, &key_found, &entry_ptr);
+	if (status != 0 ||
+		memcmp(entry_ptr, &entry, sizeof(entry)) != 0)
+		return -1;
+
+	return 0;
+}
+
+static int
+test_table_rcu_concurrent(struct rte_table_ops *ops, void *table_params,
+	int be_keys, struct rte_rcu_qsbr *qsv)
+{
+	struct rcu_test_reader reader;
+	unsigned int lcore_id;
+	uint64_t n_lookups;
+	uint32_t round, i;
+	int status = 0;
+
+	lcore_id = rte_get_next_lcore(-1, 1, 0);
+	if (lcore_id >= RTE_MAX_LCORE) {
+		printf("Not enough lcores, skipping concurrent RCU test\n");
+		return 0;
+	}
+
+	memset(&reader, 0, sizeof(reader));
+	reader.qsv = qsv;
+	reader.ops = ops;
+	reader.be_keys = be_keys;
+	reader.table = ops->f_create(table_params, 0,
+		sizeof(struct rcu_test_entry));
+	if (reader.table == NULL)
+		return -1;
+
+	rte_eal_remote_launch(rcu_test_reader_main, &reader, lcore_id);
+	while (reader.ready == 0)
+		rte_pause();
+
+	for (round = 1; round <= RCU_TEST_N_ROUNDS && status == 0; round++) {
+		/* Let the reader look the keys up between the rounds */
+		n_lookups = reader.n_lookups;
+		while (reader.n_lookups == n_lookups)
+			rte_pause();
+
+		for (i = 0; i < RCU_TEST_N_KEYS; i++) {
+			uint8_t key[32];
+			int key_found;
+
+			/* Add or update the key */
+			if (rcu_test_entry_add(ops, reader.table, i, be_keys,
+				round) != 0) {
+				status = -2;
+				break;
+			}
+			reader.n_writes++;
+
+			/* Delete a different half of the keys every round */
+			if (ops->f_delete == NULL || (i + round) % 2 == 0)
+				continue;
+
+			memset(key, 0, sizeof(key));
+			*(uint32_t *)key = rcu_test_key(i, be_keys);
+			if (ops->f_delete(reader.table, key, &key_found,
+				NULL) != 0) {
+				status = -3;
+				break;
+			}
+			reader.n_writes++;
+		}
+	}
+
+	reader.stop = 1;
+	rte_eal_wait_lcore(lcore_id);
+
+	ops->f_free(reader.table);
+
+	if (status != 0)
+		return status;
+	if (reader.n_lookups == 0 || reader.n_errors != 0)
+		return -4;
+
+	return 0;
+}
+
+int
+test_table_rcu(void)
+{
+	struct rte_rcu_qsbr *qsv;
+	size_t sz;
+	void *table;
+	int status;
+
+	/* QSBR variable without any registered reader */
+	sz = rte_rcu_qsbr_get_memsize(RTE_MAX_LCORE);
+	qsv = rte_zmalloc(NULL, sz, RTE_CACHE_LINE_SIZE);
+	if (qsv == NULL)
+		return -1;
+	rte_rcu_qsbr_init(qsv, RTE_MAX_LCORE);
+
+	/* Single key size tables do not support RCU */
+	struct rte_table_hash_params hash_params = {
+		.name = "TABLE",
+		.key_size = 8,
+		.key_offset = APP_METADATA_OFFSET(32),
+		.key_mask = NULL,
+		.n_keys = 1 << 10,
+		.n_buckets = 1 << 10,
+		.f_hash = pipeline_test_hash,
+		.seed = 0,
+		.qsv = qsv,
+	};
+
+	table = rte_table_hash_key8_ext_ops.f_create(&hash_params, 0, 1);
+	if (table != NULL) {
+		status = -2;
+		goto exit;
+	}
+
+	status = test_table_hash_rcu_generic(&rte_table_hash_ext_ops, qsv);
+	if (status < 0)
+		goto exit;
+
+	status = test_table_hash_rcu_generic(&rte_table_hash_lru_ops, qsv);
+	if (status < 0)
+		goto exit;
+
+	status = test_table_array_rcu(qsv);
+	if (status < 0)
+		goto exit;
+
+	/* Concurrent lookup, more keys than buckets */
+	hash_params.key_size = 32;
+	hash_params.n_keys = RCU_TEST_N_KEYS;
+	hash_params.n_buckets = RCU_TEST_N_KEYS / 8;
+
+	status = test_table_rcu_concurrent(&rte_table_hash_ext_ops,
+		&hash_params, 1, qsv);
+	if (status < 0) {
+		status -= 10;
+		goto exit;
+	}
+
+	status = test_table_rcu_concurrent(&rte_table_hash_lru_ops,
+		&hash_params, 1, qsv);
+	if (status < 0) {
+		status -= 20;
+		goto exit;
+	}
+
+	struct rte_table_array_params array_params = {
+		.n_entries = RCU_TEST_N_KEYS,
+		.offset = APP_METADATA_OFFSET(32),
+		.qsv = qsv,
+	};
+
+	status = test_table_rcu_concurrent(&rte_table_array_ops,
+		&array_params, 0, qsv);
+	if (status < 0)
+		status -= 30;
+
+exit:
+	rte_free(qsv);
+	return status;
+}
@@ -3,8 +3,13 @@
  */
 
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_eal.h>
 #include <rte_ip.h>
+#include <rte_udp.h>
+#include <rte_ether.h>
+#include <rte_mbuf.h>
+#include <rte_random.h>
 
 #include "test.h"
 
@@ -74,8 +79,12 @@ uint8_t default_rss_key[] = {
 0x6a, 0x42, 0xb7, 0x3b, 0xbe, 0xac, 0x01, 0xfa,
 };
 
+#define THASH_RAND_TESTS	1024
+#define THASH_PERF_TUPLES	256
+#define THASH_PERF_ITERS	4096
+
 static int
-test_thash(void)
+test_thash_softrss(void)
 {
 	uint32_t i, j;
 	union rte_thash_tuple tuple;
@@ -140,4 +149,281 @@ test_thash(void)
 	return 0;
 }
 
+static int
+test_thash_ctx_vectors(struct rte_thash_ctx *ctx)
+{
+	union rte_thash_tuple tuple[RTE_DIM(v4_tbl) + RTE_DIM(v6_tbl)];
+	const uint32_t *tuple_ptr[RTE_DIM(tuple)];
+	uint32_t hash[RTE_DIM(tuple)];
+	struct rte_ipv6_hdr ipv6_hdr;
+	uint32_t i, j, n;
+
+	for (i = 0; i < RTE_DIM(v4_tbl); i++) {
+		tuple[i].v4.src_addr = v4_tbl[i].src_ip;
+		tuple[i].v4.dst_addr = v4_tbl[i].dst_ip;
+		tuple[i].v4.sport = v4_tbl[i].src_port;
+		tuple[i].v4.dport = v4_tbl[i].dst_port;
+		tuple_ptr[i] = (const uint32_t *)&tuple[i];
+		if (rte_thash_hash(ctx, tuple_ptr[i], RTE_THASH_V4_L3_LEN) !=
+				v4_tbl[i].hash_l3 ||
+				rte_thash_hash(ctx, tuple_ptr[i],
+				RTE_THASH_V4_L4_LEN) != v4_tbl[i].hash_l3l4)
+			return -1;
+	}
+	rte_thash_hash_bulk(ctx, tuple_ptr, RTE_THASH_V4_L4_LEN, hash,
+		RTE_DIM(v4_tbl));
+	for (i = 0; i < RTE_DIM(v4_tbl); i++)
+		if (hash[i] != v4_tbl[i].hash_l3l4)
+			return -1;
+
+	n = RTE_DIM(v4_tbl);
+	for (i = 0; i < RTE_DIM(v6_tbl); i++) {
+		for (j = 0; j < RTE_DIM(ipv6_hdr.src_addr); j++)
+			ipv6_hdr.src_addr[j] = v6_tbl[i].src_ip[j];
+		for (j = 0; j < RTE_DIM(ipv6_hdr.dst_addr); j++)
+			ipv6_hdr.dst_addr[j] = v6_tbl[i].dst_ip[j];
+		rte_thash_load_v6_addrs(&ipv6_hdr, &tuple[n + i]);
+		tuple[n + i].v6.sport = v6_tbl[i].src_port;
+		tuple[n + i].v6.dport = v6_tbl[i].dst_port;
+		tuple_ptr[n + i] = (const uint32_t *)&tuple[n + i];
+		if (rte_thash_hash(ctx, tuple_ptr[n + i],
+				RTE_THASH_V6_L3_LEN) != v6_tbl[i].hash_l3 ||
+				rte_thash_hash(ctx, tuple_ptr[n + i],
+				RTE_THASH_V6_L4_LEN) != v6_tbl[i].hash_l3l4)
+			return -1;
+	}
+	rte_thash_hash_bulk(ctx, &tuple_ptr[n], RTE_THASH_V6_L3_LEN, hash,
+		RTE_DIM(v6_tbl));
+	for (i = 0; i < RTE_DIM(v6_tbl); i++)
+		if (hash[i] != v6_tbl[i].hash_l3)
+			return -1;
+
+	return 0;
+}
+
+/* the hashes must be the ones of rte_softrss() for any key and tuple */
+static int
+test_thash_ctx_random(enum rte_thash_alg alg)
+{
+	uint8_t key[52];
+	uint32_t tuple[RTE_DIM(key) / 4];
+	struct rte_thash_ctx *ctx;
+	uint32_t i, j, len;
+
+	for (i = 0; i < THASH_RAND_TESTS; i++) {
+		for (j = 0; j < RTE_DIM(key); j++)
+			key[j] = rte_rand();
+		for (j = 0; j < RTE_DIM(tuple); j++)
+			tuple[j] = rte_rand();
+		len = 1 + i % (RTE_DIM(tuple) - 1);
+
+		ctx = rte_thash_ctx_create(key, RTE_DIM(key), SOCKET_ID_ANY);
+		if (ctx == NULL)
+			return -1;
+		if (rte_thash_ctx_set_alg(ctx, alg) != 0 ||
+				rte_thash_hash(ctx, tuple, len) !=
+				rte_softrss(tuple, len, key)) {
+			rte_thash_ctx_free(ctx);
+			return -1;
+		}
+		rte_thash_ctx_free(ctx);
+	}
+
+	return 0;
+}
+
+static int
+test_thash_mbuf(struct rte_thash_ctx *ctx)
+{
+	struct rte_mempool *mp;
+	struct rte_mbuf *m;
+	struct rte_ether_hdr *eth_hdr;
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_udp_hdr *udp_hdr;
+	int ret = -1;
+
+	mp = rte_pktmbuf_pool_create("thash_pool", 7, 0, 0,
+		RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (mp == NULL)
+		return -1;
+	m = rte_pktmbuf_alloc(mp);
+	if (m == NULL)
+		goto out;
+
+	eth_hdr = (struct rte_ether_hdr *)rte_pktmbuf_append(m,
+		sizeof(*eth_hdr) + sizeof(*ipv4_hdr) + sizeof(*udp_hdr));
+	if (eth_hdr == NULL)
+		goto out;
+	memset(eth_hdr, 0, rte_pktmbuf_data_len(m));
+	eth_hdr->ether_type = rte_cpu_to_be_16(RTE_ETHER_TYPE_IPV4);
+	ipv4_hdr = (struct rte_ipv4_hdr *)(eth_hdr + 1);
+	ipv4_hdr->version_ihl = RTE_IPV4_VHL_DEF;
+	ipv4_hdr->next_proto_id = IPPROTO_UDP;
+	ipv4_hdr->total_length = rte_cpu_to_be_16(sizeof(*ipv4_hdr) +
+		sizeof(*udp_hdr));
+	ipv4_hdr->src_addr = rte_cpu_to_be_32(v4_tbl[0].src_ip);
+	ipv4_hdr->dst_addr = rte_cpu_to_be_32(v4_tbl[0].dst_ip);
+	udp_hdr = (struct rte_udp_hdr *)(ipv4_hdr + 1);
+	udp_hdr->src_port = rte_cpu_to_be_16(v4_tbl[0].src_port);
+	udp_hdr->dst_port = rte_cpu_to_be_16(v4_tbl[0].dst_port);
+
+	if (rte_thash_mbuf(ctx, m, 0) != v4_tbl[0].hash_l3 ||
+			rte_thash_mbuf(ctx, m, 1) != v4_tbl[0].hash_l3l4)
+		goto out;
+
+	/* no ports in fragments */
+	ipv4_hdr->fragment_offset = rte_cpu_to_be_16(RTE_IPV4_HDR_MF_FLAG);
+	if (rte_thash_mbuf(ctx, m, 1) != v4_tbl[0].hash_l3)
+		goto out;
+
+	ret = 0;
+out:
+	rte_pktmbuf_free(m);
+	rte_mempool_free(mp);
+	return ret;
+}
+
+static int
+test_thash(void)
+{
+	static const enum rte_thash_alg algs[] = {
+		RTE_THASH_ALG_LUT, RTE_THASH_ALG_GFNI,
+	};
+	struct rte_thash_ctx *ctx;
+	unsigned int i;
+	int ret;
+
+	if (test_thash_softrss() < 0) {
+		printf("Toeplitz hash with rte_softrss failed\n");
+		return -1;
+	}
+
+	ctx = rte_thash_ctx_create(default_rss_key, RTE_DIM(default_rss_key),
+		SOCKET_ID_ANY);
+	if (ctx == NULL) {
+		printf("Cannot create Toeplitz hash context\n");
+		return -1;
+	}
+
+	for (i = 0; i < RTE_DIM(algs); i++) {
+		if (rte_thash_ctx_set_alg(ctx, algs[i]) != 0) {
+			printf("Toeplitz hash algorithm %u not supported\n",
+				algs[i]);
+			continue;
+		}
+		ret = test_thash_ctx_vectors(ctx);
+		if (ret == 0)
+			ret = test_thash_mbuf(ctx);
+		if (ret == 0)
+			ret = test_thash_ctx_random(algs[i]);
+		if (ret < 0) {
+			printf("Toeplitz hash algorithm %u failed\n",
+				algs[i]);
+			rte_thash_ctx_free(ctx);
+			return -1;
+		}
+	}
+
+	rte_thash_ctx_free(ctx);
+	return 0;
+}
+
 REGISTER_TEST_COMMAND(thash_autotest, test_thash);
+
+static void
+test_thash_perf_tuples(struct rte_thash_ctx *ctx, const char *name,
+		uint32_t tuple_len, const uint32_t * const tuple_ptr[])
+{
+	static const char * const alg_names[] = {
+		[RTE_THASH_ALG_LUT] = "lut",
+		[RTE_THASH_ALG_GFNI] = "gfni",
+	};
+	uint32_t hash[THASH_PERF_TUPLES];
+	uint8_t rss_key_be[RTE_DIM(default_rss_key)];
+	uint64_t tsc;
+	uint32_t i, j, sum = 0;
+	unsigned int alg;
+
+	rte_convert_rss_key((uint32_t *)&default_rss_key,
+		(uint32_t *)rss_key_be, RTE_DIM(default_rss_key));
+
+	tsc = rte_rdtsc_precise();
+	for (j = 0; j < THASH_PERF_ITERS; j++)
+		for (i = 0; i < THASH_PERF_TUPLES; i++)
+			sum += rte_softrss((uint32_t *)(uintptr_t)tuple_ptr[i],
+				tuple_len, default_rss_key);
+	tsc = rte_rdtsc_precise() - tsc;
+	printf("%s rte_softrss: %.1f cycles/tuple\n", name,
+		(double)tsc / (THASH_PERF_ITERS * THASH_PERF_TUPLES));
+
+	tsc = rte_rdtsc_precise();
+	for (j = 0; j < THASH_PERF_ITERS; j++)
+		for (i = 0; i < THASH_PERF_TUPLES; i++)
+			sum += rte_softrss_be(
+				(uint32_t *)(uintptr_t)tuple_ptr[i],
+				tuple_len, rss_key_be);
+	tsc = rte_rdtsc_precise() - tsc;
+	printf("%s rte_softrss_be: %.1f cycles/tuple\n", name,
+		(double)tsc / (THASH_PERF_ITERS * THASH_PERF_TUPLES));
+
+	for (alg = RTE_THASH_ALG_LUT; alg <= RTE_THASH_ALG_GFNI; alg++) {
+		if (rte_thash_ctx_set_alg(ctx, alg) != 0)
+			continue;
+
+		tsc = rte_rdtsc_precise();
+		for (j = 0; j < THASH_PERF_ITERS; j++)
+			for (i = 0; i < THASH_PERF_TUPLES; i++)
+				sum += rte_thash_hash(ctx, tuple_ptr[i],
+					tuple_len);
+		tsc = rte_rdtsc_precise() - tsc;
+		printf("%s rte_thash_hash (%s): %.1f cycles/tuple\n", name,
+			alg_names[alg], (double)tsc /
+			(THASH_PERF_ITERS * THASH_PERF_TUPLES));
+
+		tsc = rte_rdtsc_precise();
+		for (j = 0; j < THASH_PERF_ITERS; j++)
+			rte_thash_hash_bulk(ctx, tuple_ptr, tuple_len, hash,
+				THASH_PERF_TUPLES);
+		tsc = rte_rdtsc_precise() - tsc;
+		printf("%s rte_thash_hash_bulk (%s): %.1f cycles/tuple\n",
+			name, alg_names[alg], (double)tsc /
+			(THASH_PERF_ITERS * THASH_PERF_TUPLES));
+		sum += hash[0];
+	}
+
+	/* keep the computations */
+	if (sum == 0)
+		printf("\n");
+}
+
+static int
+test_thash_perf(void)
+{
+	static union rte_thash_tuple tuple[THASH_PERF_TUPLES];
+	const uint32_t *tuple_ptr[THASH_PERF_TUPLES];
+	struct rte_thash_ctx *ctx;
+	uint32_t i, j;
+
+	ctx = rte_thash_ctx_create(default_rss_key, RTE_DIM(default_rss_key),
+		SOCKET_ID_ANY);
+	if (ctx == NULL) {
+		printf("Cannot create Toeplitz hash context\n");
+		return -1;
+	}
+
+	for (i = 0; i < THASH_PERF_TUPLES; i++) {
+		for (j = 0; j < RTE_THASH_V6_L4_LEN; j++)
+			((uint32_t *)&tuple[i])[j] = rte_rand();
+		tuple_ptr[i] = (const uint32_t *)&tuple[i];
+	}
+
+	test_thash_perf_tuples(ctx, "IPv4 L4", RTE_THASH_V4_L4_LEN,
+		tuple_ptr);
+	test_thash_perf_tuples(ctx, "IPv6 L4", RTE_THASH_V6_L4_LEN,
+		tuple_ptr);
+
+	rte_thash_ctx_free(ctx);
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(thash_perf_autotest, test_thash_perf);
@@ -17,6 +17,9 @@
 
 #define MAX_ITERATIONS 1000000
 
+/* timers of the backend comparison expire within this window */
+#define BACKEND_WINDOW_MS 100
+
 int outstanding_count = 0;
 
 static void
@@ -33,6 +36,128 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #define do_delay() rte_pause()
 #endif
 
+static unsigned int backend_expired;
+static unsigned int backend_early;
+
+static void
+backend_expire_cb(struct rte_timer *tim)
+{
+	if (tim->expire > rte_get_timer_cycles())
+		backend_early++;
+	backend_expired++;
+}
+
+/* arm, re-arm, stop and expire nb_timers timers of a timer data instance */
+static int
+test_timer_perf_backend(const char *name, uint32_t data_id,
+		struct rte_timer *tms, unsigned int nb_timers)
+{
+	const uint64_t window = rte_get_timer_hz() * BACKEND_WINDOW_MS /
+		MS_PER_S;
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t start_tsc, arm, rearm, stop, expire, deadline;
+	unsigned int i, last_expired;
+
+	for (i = 0; i < nb_timers; i++)
+		rte_timer_init(&tms[i]);
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < nb_timers; i++)
+		rte_timer_alt_reset(data_id, &tms[i],
+			window + rte_rand() % window, SINGLE, lcore_id,
+			NULL, NULL);
+	arm = rte_rdtsc() - start_tsc;
+
+	/* move the pending timers, as when refreshing a connection */
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < nb_timers; i++)
+		rte_timer_alt_reset(data_id, &tms[i],
+			window + rte_rand() % window, SINGLE, lcore_id,
+			NULL, NULL);
+	rearm = rte_rdtsc() - start_tsc;
+
+	start_tsc = rte_rdtsc();
+	for (i = 0; i < nb_timers; i++)
+		rte_timer_alt_stop(data_id, &tms[i]);
+	stop = rte_rdtsc() - start_tsc;
+
+	for (i = 0; i < nb_timers; i++)
+		rte_timer_alt_reset(data_id, &tms[i], rte_rand() % window,
+			SINGLE, lcore_id, NULL, NULL);
+
+	/*
+	 * Manage until all timers expired, idle calls included. Give up
+	 * when none expired for a while.
+	 */
+	backend_expired = 0;
+	backend_early = 0;
+	last_expired = 0;
+	expire = 0;
+	deadline = rte_get_timer_cycles() + 10 * window;
+	while (backend_expired < nb_timers &&
+			rte_get_timer_cycles() < deadline) {
+		start_tsc = rte_rdtsc();
+		rte_timer_alt_manage(data_id, NULL, 0, backend_expire_cb);
+		expire += rte_rdtsc() - start_tsc;
+		if (backend_expired != last_expired) {
+			last_expired = backend_expired;
+			deadline = rte_get_timer_cycles() + 10 * window;
+		}
+	}
+
+	printf("%s, %u timers: arm %"PRIu64", re-arm %"PRIu64", stop %"PRIu64
+		", expire %"PRIu64" cycles/timer\n", name, nb_timers,
+		arm / nb_timers, rearm / nb_timers, stop / nb_timers,
+		expire / nb_timers);
+
+	if (backend_expired != nb_timers || backend_early != 0) {
+		printf("Error: %u of %u timers expired, %u early\n",
+			backend_expired, nb_timers, backend_early);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* compare the skiplist and timer wheel backends */
+static int
+test_timer_perf_backends(void)
+{
+	static const unsigned int nb_timers[] = { 1000000, 10000000 };
+	uint32_t skiplist_id, wheel_id;
+	struct rte_timer *tms;
+	unsigned int i;
+	int ret = 0;
+
+	if (rte_timer_data_alloc(&skiplist_id) != 0)
+		return -1;
+	if (rte_timer_data_alloc_wheel(&wheel_id, 0) != 0) {
+		rte_timer_data_dealloc(skiplist_id);
+		return -1;
+	}
+
+	for (i = 0; i < RTE_DIM(nb_timers) && ret == 0; i++) {
+		tms = rte_malloc(NULL, sizeof(*tms) * nb_timers[i], 0);
+		if (tms == NULL) {
+			printf("Not enough memory for %u timers, skipped\n",
+				nb_timers[i]);
+			continue;
+		}
+
+		ret = test_timer_perf_backend("skiplist", skiplist_id, tms,
+				nb_timers[i]);
+		if (ret == 0)
+			ret = test_timer_perf_backend("wheel", wheel_id, tms,
+					nb_timers[i]);
+
+		rte_free(tms);
+	}
+
+	rte_timer_data_dealloc(wheel_id);
+	rte_timer_data_dealloc(skiplist_id);
+	return ret;
+}
+
 static int
 test_timer_perf(void)
 {
@@ -127,8 +252,11 @@ test_timer_perf(void)
 	printf("Time per rte_timer_manage with zero callbacks: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
+	rte_timer_stop_sync(&tms[0]);
 	rte_free(tms);
-	return 0;
+
+	printf("\n");
+	return test_timer_perf_backends();
 }
 
 REGISTER_TEST_COMMAND(timer_perf_autotest, test_timer_perf);
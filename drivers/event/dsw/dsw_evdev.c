@@ -3,10 +3,12 @@
  */
 
 #include <stdbool.h>
+#include <stdlib.h>
 
 #include <rte_cycles.h>
 #include <rte_eventdev_pmd.h>
 #include <rte_eventdev_pmd_vdev.h>
+#include <rte_kvargs.h>
 #include <rte_random.h>
 #include <rte_ring_elem.h>
 
@@ -14,13 +16,17 @@
 
 #define EVENTDEV_NAME_DSW_PMD event_dsw
 
+#define MIGRATION_INTERVAL_ARG "migration_interval"
+#define MIN_SOURCE_LOAD_ARG "min_source_load"
+#define MAX_TARGET_LOAD_ARG "max_target_load"
+
 static int
 dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	       const struct rte_event_port_conf *conf)
 {
 	struct dsw_evdev *dsw = dsw_pmd_priv(dev);
 	struct dsw_port *port;
-	struct rte_event_ring *in_ring;
+	struct rte_ring *in_ring;
 	struct rte_ring *ctl_in_ring;
 	char ring_name[RTE_RING_NAMESIZE];
 
@@ -37,9 +43,9 @@ dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	snprintf(ring_name, sizeof(ring_name), "dsw%d_p%u", dev->data->dev_id,
 		 port_id);
 
-	in_ring = rte_event_ring_create(ring_name, DSW_IN_RING_SIZE,
-					dev->data->socket_id,
-					RING_F_SC_DEQ|RING_F_EXACT_SZ);
+	in_ring = rte_ring_create_elem(ring_name, sizeof(struct rte_event),
+				       DSW_IN_RING_SIZE, dev->data->socket_id,
+				       RING_F_SC_DEQ|RING_F_EXACT_SZ);
 
 	if (in_ring == NULL)
 		return -ENOMEM;
@@ -54,7 +60,7 @@ dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 					   RING_F_SC_DEQ|RING_F_EXACT_SZ);
 
 	if (ctl_in_ring == NULL) {
-		rte_event_ring_free(in_ring);
+		rte_ring_free(in_ring);
 		return -ENOMEM;
 	}
 
@@ -64,10 +70,15 @@ dsw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 	rte_atomic16_init(&port->load);
 
 	port->load_update_interval =
-		(DSW_LOAD_UPDATE_INTERVAL * rte_get_timer_hz()) / US_PER_S;
+		(DSW_LOAD_UPDATE_INTERVAL(dsw->migration_interval) *
+		 rte_get_timer_hz()) / US_PER_S;
 
 	port->migration_interval =
-		(DSW_MIGRATION_INTERVAL * rte_get_timer_hz()) / US_PER_S;
+		(dsw->migration_interval * rte_get_timer_hz()) / US_PER_S;
+
+	port->migration_latency_bucket =
+		(DSW_MIGRATION_LATENCY_BUCKET_US * rte_get_timer_hz()) /
+		US_PER_S;
 
 	dev->data->ports[port_id] = port;
 
@@ -91,7 +102,7 @@ dsw_port_release(void *p)
 {
 	struct dsw_port *port = p;
 
-	rte_event_ring_free(port->in_ring);
+	rte_ring_free(port->in_ring);
 	rte_ring_free(port->ctl_in_ring);
 }
 
@@ -323,7 +334,7 @@ dsw_port_drain_in_ring(uint8_t dev_id, struct dsw_port *port,
 {
 	struct rte_event ev;
 
-	while (rte_event_ring_dequeue_burst(port->in_ring, &ev, 1, NULL))
+	while (rte_ring_dequeue_elem(port->in_ring, &ev, sizeof(ev)) == 0)
 		flush(dev_id, ev, flush_arg);
 }
 
@@ -371,6 +382,15 @@ dsw_close(struct rte_eventdev *dev)
 	return 0;
 }
 
+static int
+dsw_eth_rx_adapter_caps_get(const struct rte_eventdev *dev __rte_unused,
+			    const struct rte_eth_dev *eth_dev __rte_unused,
+			    uint32_t *caps)
+{
+	*caps = RTE_EVENT_ETH_RX_ADAPTER_SW_CAP;
+	return 0;
+}
+
 static struct rte_eventdev_ops dsw_evdev_ops = {
 	.port_setup = dsw_port_setup,
 	.port_def_conf = dsw_port_def_conf,
@@ -387,18 +407,111 @@ static struct rte_eventdev_ops dsw_evdev_ops = {
 	.dev_close = dsw_close,
 	.xstats_get = dsw_xstats_get,
 	.xstats_get_names = dsw_xstats_get_names,
-	.xstats_get_by_name = dsw_xstats_get_by_name
+	.xstats_get_by_name = dsw_xstats_get_by_name,
+	.eth_rx_adapter_caps_get = dsw_eth_rx_adapter_caps_get
 };
 
+static int
+set_migration_interval(const char *key __rte_unused, const char *value,
+		       void *opaque)
+{
+	int *interval = opaque;
+	*interval = atoi(value);
+	if (*interval < DSW_MIN_MIGRATION_INTERVAL ||
+	    *interval > DSW_MAX_MIGRATION_INTERVAL)
+		return -1;
+	return 0;
+}
+
+static int
+set_load_percent(const char *key __rte_unused, const char *value,
+		 void *opaque)
+{
+	int *percent = opaque;
+	*percent = atoi(value);
+	if (*percent < 0 || *percent > 100)
+		return -1;
+	return 0;
+}
+
+static int
+dsw_parse_args(const char *name, const char *params, int *migration_interval,
+	       int *min_source_load, int *max_target_load)
+{
+	static const char *const args[] = {
+		MIGRATION_INTERVAL_ARG,
+		MIN_SOURCE_LOAD_ARG,
+		MAX_TARGET_LOAD_ARG,
+		NULL
+	};
+	struct rte_kvargs *kvlist;
+	int ret;
+
+	if (params == NULL || params[0] == '\0')
+		return 0;
+
+	kvlist = rte_kvargs_parse(params, args);
+	if (kvlist == NULL) {
+		RTE_EDEV_LOG_ERR("%s: Error parsing parameters '%s'", name,
+				 params);
+		return -EINVAL;
+	}
+
+	ret = rte_kvargs_process(kvlist, MIGRATION_INTERVAL_ARG,
+				 set_migration_interval, migration_interval);
+	if (ret != 0) {
+		RTE_EDEV_LOG_ERR("%s: Invalid %s parameter", name,
+				 MIGRATION_INTERVAL_ARG);
+		goto out;
+	}
+
+	ret = rte_kvargs_process(kvlist, MIN_SOURCE_LOAD_ARG,
+				 set_load_percent, min_source_load);
+	if (ret != 0) {
+		RTE_EDEV_LOG_ERR("%s: Invalid %s parameter", name,
+				 MIN_SOURCE_LOAD_ARG);
+		goto out;
+	}
+
+	ret = rte_kvargs_process(kvlist, MAX_TARGET_LOAD_ARG,
+				 set_load_percent, max_target_load);
+	if (ret != 0) {
+		RTE_EDEV_LOG_ERR("%s: Invalid %s parameter", name,
+				 MAX_TARGET_LOAD_ARG);
+		goto out;
+	}
+
+	if (*min_source_load > *max_target_load) {
+		RTE_EDEV_LOG_ERR("%s: %s must not exceed %s", name,
+				 MIN_SOURCE_LOAD_ARG, MAX_TARGET_LOAD_ARG);
+		ret = -EINVAL;
+	}
+
+out:
+	rte_kvargs_free(kvlist);
+
+	return ret != 0 ? -EINVAL : 0;
+}
+
 static int
 dsw_probe(struct rte_vdev_device *vdev)
 {
 	const char *name;
 	struct rte_eventdev *dev;
 	struct dsw_evdev *dsw;
+	int migration_interval = DSW_MIGRATION_INTERVAL;
+	int min_source_load = DSW_MIN_SOURCE_LOAD_FOR_MIGRATION;
+	int max_target_load = DSW_MAX_TARGET_LOAD_FOR_MIGRATION;
+	int rc;
 
 	name = rte_vdev_device_name(vdev);
 
+	rc = dsw_parse_args(name, rte_vdev_device_args(vdev),
+			    &migration_interval, &min_source_load,
+			    &max_target_load);
+	if (rc < 0)
+		return rc;
+
 	dev = rte_event_pmd_vdev_init(name, sizeof(struct dsw_evdev),
 				      rte_socket_id());
 	if (dev == NULL)
@@ -417,6 +530,9 @@ dsw_probe(struct rte_vdev_device *vdev)
 
 	dsw = dev->data->dev_private;
 	dsw->data = dev->data;
+	dsw->migration_interval = migration_interval;
+	dsw->min_source_load = DSW_LOAD_FROM_PERCENT(min_source_load);
+	dsw->max_target_load = DSW_LOAD_FROM_PERCENT(max_target_load);
 
 	return 0;
 }
@@ -439,3 +555,7 @@ static struct rte_vdev_driver evdev_dsw_pmd_drv = {
 };
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_DSW_PMD, evdev_dsw_pmd_drv);
+RTE_PMD_REGISTER_PARAM_STRING(EVENTDEV_NAME_DSW_PMD,
+			      MIGRATION_INTERVAL_ARG "=<int> "
+			      MIN_SOURCE_LOAD_ARG "=<int> "
+			      MAX_TARGET_LOAD_ARG "=<int>");
@@ -5,8 +5,8 @@
 #ifndef _DSW_EVDEV_H_
 #define _DSW_EVDEV_H_
 
-#include <rte_event_ring.h>
 #include <rte_eventdev.h>
+#include <rte_ring.h>
 
 #define DSW_PMD_NAME RTE_STR(event_dsw)
 
@@ -69,18 +69,38 @@
  * source ports, to be migrated too quickly to a lightly loaded port -
  * in particular since this might cause the system to oscillate.
  */
-#define DSW_LOAD_UPDATE_INTERVAL (DSW_MIGRATION_INTERVAL/4)
+#define DSW_LOAD_UPDATE_INTERVAL(migration_interval) ((migration_interval)/4)
 #define DSW_OLD_LOAD_WEIGHT (1)
 
-/* The minimum time (in us) between two flow migrations. What puts an
- * upper limit on the actual migration rate is primarily the pace in
- * which the ports send and receive control messages, which in turn is
- * largely a function of how much cycles are spent the processing of
- * an event burst.
+/* The default minimum time (in us) between two flow migrations. What
+ * puts an upper limit on the actual migration rate is primarily the
+ * pace in which the ports send and receive control messages, which in
+ * turn is largely a function of how much cycles are spent the
+ * processing of an event burst.
+ *
+ * The interval and the load thresholds (in percent) may be changed
+ * with the "migration_interval", "min_source_load" and
+ * "max_target_load" devargs.
  */
 #define DSW_MIGRATION_INTERVAL (1000)
-#define DSW_MIN_SOURCE_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(70))
-#define DSW_MAX_TARGET_LOAD_FOR_MIGRATION (DSW_LOAD_FROM_PERCENT(95))
+#define DSW_MIN_MIGRATION_INTERVAL (10)
+#define DSW_MAX_MIGRATION_INTERVAL (1000000)
+#define DSW_MIN_SOURCE_LOAD_FOR_MIGRATION (70)
+#define DSW_MAX_TARGET_LOAD_FOR_MIGRATION (95)
+
+/* Migration latencies are recorded in a histogram, where bucket n
+ * holds the migrations which took less than
+ * DSW_MIGRATION_LATENCY_BUCKET_US << n us, and the last bucket all
+ * migrations slower than that.
+ */
+#define DSW_MIGRATION_LATENCY_BUCKETS (12)
+#define DSW_MIGRATION_LATENCY_BUCKET_US (4)
+
+/* Upper limit on the number of control messages processed per
+ * background task, so that a port doesn't stall on a burst of
+ * migration requests.
+ */
+#define DSW_MAX_CTL_MSGS_PER_BG_TASK (8)
 
 #define DSW_MAX_EVENTS_RECORDED (128)
 
@@ -157,6 +177,8 @@ struct dsw_port {
 	uint64_t migration_start;
 	uint64_t migrations;
 	uint64_t migration_latency;
+	uint64_t migration_latency_bucket;
+	uint64_t migration_latency_hist[DSW_MIGRATION_LATENCY_BUCKETS];
 
 	uint8_t migration_target_port_id;
 	struct dsw_queue_flow migration_target_qf;
@@ -193,7 +215,8 @@ struct dsw_port {
 	 */
 	struct rte_event in_buffer[DSW_MAX_EVENTS];
 
-	struct rte_event_ring *in_ring __rte_cache_aligned;
+	/* Ring of struct rte_event elements. */
+	struct rte_ring *in_ring __rte_cache_aligned;
 
 	struct rte_ring *ctl_in_ring __rte_cache_aligned;
 
@@ -218,6 +241,11 @@ struct dsw_evdev {
 	uint8_t num_queues;
 	int32_t max_inflight;
 
+	/* Flow migration tuning, from the devargs. */
+	uint32_t migration_interval;
+	int16_t min_source_load;
+	int16_t max_target_load;
+
 	rte_atomic32_t credits_on_loan __rte_cache_aligned;
 };
 
@@ -15,6 +15,7 @@
 #include <rte_cycles.h>
 #include <rte_memcpy.h>
 #include <rte_random.h>
+#include <rte_ring_elem.h>
 
 static bool
 dsw_port_acquire_credits(struct dsw_evdev *dsw, struct dsw_port *port,
@@ -461,10 +462,11 @@ dsw_port_transmit_buffered(struct dsw_evdev *dsw, struct dsw_port *source_port,
 	 */
 	do {
 		enqueued +=
-			rte_event_ring_enqueue_burst(dest_port->in_ring,
-						     buffer+enqueued,
-						     *buffer_len-enqueued,
-						     NULL);
+			rte_ring_enqueue_burst_elem(dest_port->in_ring,
+						    buffer+enqueued,
+						    sizeof(struct rte_event),
+						    *buffer_len-enqueued,
+						    NULL);
 	} while (unlikely(enqueued != *buffer_len));
 
 	(*buffer_len) = 0;
@@ -602,9 +604,20 @@ dsw_port_migration_stats(struct dsw_port *port)
 {
 	uint64_t migration_latency;
 
+	uint16_t bucket;
+
 	migration_latency = (rte_get_timer_cycles() - port->migration_start);
 	port->migration_latency += migration_latency;
 	port->migrations++;
+
+	for (bucket = 0; bucket < DSW_MIGRATION_LATENCY_BUCKETS - 1; bucket++) {
+		uint64_t limit = port->migration_latency_bucket << bucket;
+
+		if (migration_latency < limit)
+			break;
+	}
+
+	port->migration_latency_hist[bucket]++;
 }
 
 static void
@@ -673,11 +686,11 @@ dsw_port_consider_migration(struct dsw_evdev *dsw,
 	}
 
 	source_port_load = rte_atomic16_read(&source_port->load);
-	if (source_port_load < DSW_MIN_SOURCE_LOAD_FOR_MIGRATION) {
+	if (source_port_load < dsw->min_source_load) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 				"Load %d is below threshold level %d.\n",
 				DSW_LOAD_TO_PERCENT(source_port_load),
-		       DSW_LOAD_TO_PERCENT(DSW_MIN_SOURCE_LOAD_FOR_MIGRATION));
+				DSW_LOAD_TO_PERCENT(dsw->min_source_load));
 		return;
 	}
 
@@ -686,7 +699,7 @@ dsw_port_consider_migration(struct dsw_evdev *dsw,
 	 */
 	any_port_below_limit =
 		dsw_retrieve_port_loads(dsw, port_loads,
-					DSW_MAX_TARGET_LOAD_FOR_MIGRATION);
+					dsw->max_target_load);
 	if (!any_port_below_limit) {
 		DSW_LOG_DP_PORT(DEBUG, source_port->id,
 				"Candidate target ports are all too highly "
@@ -723,13 +736,13 @@ dsw_port_consider_migration(struct dsw_evdev *dsw,
 	 */
 	if (!dsw_select_migration_target(dsw, source_port, bursts, num_bursts,
 					 port_loads,
-					 DSW_MIN_SOURCE_LOAD_FOR_MIGRATION,
+					 dsw->min_source_load,
 					 &source_port->migration_target_qf,
 					 &source_port->migration_target_port_id)
 	    &&
 	    !dsw_select_migration_target(dsw, source_port, bursts, num_bursts,
 					 port_loads,
-					 DSW_MAX_TARGET_LOAD_FOR_MIGRATION,
+					 dsw->max_target_load,
 					 &source_port->migration_target_qf,
 				       &source_port->migration_target_port_id))
 		return;
@@ -814,7 +827,7 @@ dsw_port_handle_unpause_flow(struct dsw_evdev *dsw, struct dsw_port *port,
 
 static void
 dsw_port_forward_migrated_flow(struct dsw_port *source_port,
-			       struct rte_event_ring *dest_ring,
+			       struct rte_ring *dest_ring,
 			       uint8_t queue_id,
 			       uint16_t flow_hash)
 {
@@ -825,38 +838,49 @@ dsw_port_forward_migrated_flow(struct dsw_port *source_port,
 	 */
 	rte_smp_rmb();
 
-	events_left = rte_event_ring_count(source_port->in_ring);
+	events_left = rte_ring_count(source_port->in_ring);
 
 	while (events_left > 0) {
 		uint16_t in_burst_size =
 			RTE_MIN(FORWARD_BURST_SIZE, events_left);
 		struct rte_event in_burst[in_burst_size];
+		struct rte_event out_burst[in_burst_size];
 		uint16_t in_len;
+		uint16_t out_len = 0;
+		uint16_t enqueued = 0;
 		uint16_t i;
 
-		in_len = rte_event_ring_dequeue_burst(source_port->in_ring,
-						      in_burst,
-						      in_burst_size, NULL);
-		/* No need to care about bursting forwarded events (to
-		 * the destination port's in_ring), since migration
-		 * doesn't happen very often, and also the majority of
-		 * the dequeued events will likely *not* be forwarded.
-		 */
+		in_len = rte_ring_dequeue_burst_elem(source_port->in_ring,
+						     in_burst,
+						     sizeof(struct rte_event),
+						     in_burst_size, NULL);
+
 		for (i = 0; i < in_len; i++) {
 			struct rte_event *e = &in_burst[i];
 			if (e->queue_id == queue_id &&
-			    dsw_flow_id_hash(e->flow_id) == flow_hash) {
-				while (rte_event_ring_enqueue_burst(dest_ring,
-								    e, 1,
-								    NULL) != 1)
-					rte_pause();
-			} else {
+			    dsw_flow_id_hash(e->flow_id) == flow_hash)
+				out_burst[out_len++] = *e;
+			else {
 				uint16_t last_idx = source_port->in_buffer_len;
 				source_port->in_buffer[last_idx] = *e;
 				source_port->in_buffer_len++;
 			}
 		}
 
+		/* The forwarded events are passed in one burst per
+		 * dequeued burst, to keep the time the flow is paused
+		 * short.
+		 */
+		while (enqueued != out_len) {
+			enqueued +=
+				rte_ring_enqueue_burst_elem(dest_ring,
+						    out_burst+enqueued,
+						    sizeof(struct rte_event),
+						    out_len-enqueued, NULL);
+			if (unlikely(enqueued != out_len))
+				rte_pause();
+		}
+
 		events_left -= in_len;
 	}
 }
@@ -917,13 +941,21 @@ static void
 dsw_port_ctl_process(struct dsw_evdev *dsw, struct dsw_port *port)
 {
 	struct dsw_ctl_msg msg;
+	uint16_t i;
 
-	/* So any table loads happens before the ring dequeue, in the
-	 * case of a 'paus' message.
-	 */
-	rte_smp_rmb();
+	for (i = 0; i < DSW_MAX_CTL_MSGS_PER_BG_TASK; i++) {
+		/* So any table loads happens before the ring dequeue,
+		 * in the case of a 'paus' message.
+		 */
+		rte_smp_rmb();
+
+		/* Serving all pending messages, rather than one per
+		 * call, shortens the time flows stay paused when
+		 * several ports are migrating at the same time.
+		 */
+		if (dsw_port_ctl_dequeue(port, &msg) != 0)
+			break;
 
-	if (dsw_port_ctl_dequeue(port, &msg) == 0) {
 		switch (msg.type) {
 		case DSW_CTL_PAUS_REQ:
 			dsw_port_handle_pause_flow(dsw, port,
@@ -955,16 +987,20 @@ dsw_port_note_op(struct dsw_port *port, uint16_t num_events)
 static void
 dsw_port_bg_process(struct dsw_evdev *dsw, struct dsw_port *port)
 {
-	if (unlikely(port->migration_state == DSW_MIGRATION_STATE_FORWARDING &&
-		     port->pending_releases == 0))
-		dsw_port_move_migrating_flow(dsw, port);
-
 	/* Polling the control ring is relatively inexpensive, and
 	 * polling it often helps bringing down migration latency, so
 	 * do this for every iteration.
 	 */
 	dsw_port_ctl_process(dsw, port);
 
+	/* Done after the control ring processing, so the flow is
+	 * moved in the same call as the last pause confirmation
+	 * arrived.
+	 */
+	if (unlikely(port->migration_state == DSW_MIGRATION_STATE_FORWARDING &&
+		     port->pending_releases == 0))
+		dsw_port_move_migrating_flow(dsw, port);
+
 	/* To avoid considering migration and flushing output buffers
 	 * on every dequeue/enqueue call, the scheduler only performs
 	 * such 'background' tasks every nth
@@ -1202,7 +1238,8 @@ dsw_port_dequeue_burst(struct dsw_port *port, struct rte_event *events,
 		return dequeued;
 	}
 
-	return rte_event_ring_dequeue_burst(port->in_ring, events, num, NULL);
+	return rte_ring_dequeue_burst_elem(port->in_ring, events,
+					   sizeof(struct rte_event), num, NULL);
 }
 
 uint16_t
@@ -37,12 +37,18 @@ struct dsw_xstat_dev {
 
 typedef
 uint64_t (*dsw_xstats_port_get_value_fn)(struct dsw_evdev *dsw,
-					 uint8_t port_id, uint8_t queue_id);
+					 uint8_t port_id, uint8_t param);
+
+enum dsw_xstats_port_param {
+	DSW_XSTATS_PORT_PARAM_NONE,
+	DSW_XSTATS_PORT_PARAM_QUEUE,
+	DSW_XSTATS_PORT_PARAM_LATENCY_BUCKET
+};
 
 struct dsw_xstats_port {
 	const char *name_fmt;
 	dsw_xstats_port_get_value_fn get_value_fn;
-	bool per_queue;
+	enum dsw_xstats_port_param param;
 };
 
 static uint64_t
@@ -96,6 +102,13 @@ dsw_xstats_port_get_migration_latency(struct dsw_evdev *dsw, uint8_t port_id,
 	return num_migrations > 0 ? total_latency / num_migrations : 0;
 }
 
+static uint64_t
+dsw_xstats_port_get_migration_latency_hist(struct dsw_evdev *dsw,
+					   uint8_t port_id, uint8_t bucket)
+{
+	return dsw->ports[port_id].migration_latency_hist[bucket];
+}
+
 static uint64_t
 dsw_xstats_port_get_event_proc_latency(struct dsw_evdev *dsw, uint8_t port_id,
 				       uint8_t queue_id __rte_unused)
@@ -125,29 +138,32 @@ DSW_GEN_PORT_ACCESS_FN(last_bg)
 
 static struct dsw_xstats_port dsw_port_xstats[] = {
 	{ "port_%u_new_enqueued", dsw_xstats_port_get_new_enqueued,
-	  false },
+	  DSW_XSTATS_PORT_PARAM_NONE },
 	{ "port_%u_forward_enqueued", dsw_xstats_port_get_forward_enqueued,
-	  false },
+	  DSW_XSTATS_PORT_PARAM_NONE },
 	{ "port_%u_release_enqueued", dsw_xstats_port_get_release_enqueued,
-	  false },
+	  DSW_XSTATS_PORT_PARAM_NONE },
 	{ "port_%u_queue_%u_enqueued", dsw_xstats_port_get_queue_enqueued,
-	  true },
+	  DSW_XSTATS_PORT_PARAM_QUEUE },
 	{ "port_%u_dequeued", dsw_xstats_port_get_dequeued,
-	  false },
+	  DSW_XSTATS_PORT_PARAM_NONE },
 	{ "port_%u_queue_%u_dequeued", dsw_xstats_port_get_queue_dequeued,
-	  true },
+	  DSW_XSTATS_PORT_PARAM_QUEUE },
 	{ "port_%u_migrations", dsw_xstats_port_get_migrations,
-	  false },
+	  DSW_XSTATS_PORT_PARAM_NONE },
 	{ "port_%u_migration_latency", dsw_xstats_port_get_migration_latency,
-	  false },
+	  DSW_XSTATS_PORT_PARAM_NONE },
+	{ "port_%u_migration_latency_hist_%u",
+	  dsw_xstats_port_get_migration_latency_hist,
+	  DSW_XSTATS_PORT_PARAM_LATENCY_BUCKET },
 	{ "port_%u_event_proc_latency", dsw_xstats_port_get_event_proc_latency,
-	  false },
+	  DSW_XSTATS_PORT_PARAM_NONE },
 	{ "port_%u_inflight_credits", dsw_xstats_port_get_inflight_credits,
-	  false },
+	  DSW_XSTATS_PORT_PARAM_NONE },
 	{ "port_%u_load", dsw_xstats_port_get_load,
-	  false },
+	  DSW_XSTATS_PORT_PARAM_NONE },
 	{ "port_%u_last_bg", dsw_xstats_port_get_last_bg,
-	  false }
+	  DSW_XSTATS_PORT_PARAM_NONE }
 };
 
 typedef
@@ -166,25 +182,42 @@ dsw_xstats_dev_foreach(dsw_xstats_foreach_fn fn, void *fn_data)
 		   i, fn_data);
 }
 
+static unsigned int
+dsw_xstats_port_num_params(struct dsw_evdev *dsw,
+			   const struct dsw_xstats_port *xstat)
+{
+	switch (xstat->param) {
+	case DSW_XSTATS_PORT_PARAM_QUEUE:
+		return dsw->num_queues;
+	case DSW_XSTATS_PORT_PARAM_LATENCY_BUCKET:
+		return DSW_MIGRATION_LATENCY_BUCKETS;
+	default:
+		return 0;
+	}
+}
+
 static void
 dsw_xstats_port_foreach(struct dsw_evdev *dsw, uint8_t port_id,
 			dsw_xstats_foreach_fn fn, void *fn_data)
 {
-	uint8_t queue_id;
+	uint8_t param;
 	unsigned int stat_idx;
 
-	for (stat_idx = 0, queue_id = 0;
+	for (stat_idx = 0, param = 0;
 	     stat_idx < RTE_DIM(dsw_port_xstats);) {
 		struct dsw_xstats_port *xstat = &dsw_port_xstats[stat_idx];
 		char xstats_name[RTE_EVENT_DEV_XSTATS_NAME_SIZE];
+		unsigned int num_params;
 		unsigned int xstats_id;
 
-		if (xstat->per_queue) {
-			xstats_id = DSW_XSTATS_ID_CREATE(stat_idx, queue_id);
+		num_params = dsw_xstats_port_num_params(dsw, xstat);
+
+		if (xstat->param != DSW_XSTATS_PORT_PARAM_NONE) {
+			xstats_id = DSW_XSTATS_ID_CREATE(stat_idx, param);
 			snprintf(xstats_name, sizeof(xstats_name),
 				 dsw_port_xstats[stat_idx].name_fmt, port_id,
-				 queue_id);
-			queue_id++;
+				 param);
+			param++;
 		} else {
 			xstats_id = stat_idx;
 			snprintf(xstats_name, sizeof(xstats_name),
@@ -194,9 +227,9 @@ dsw_xstats_port_foreach(struct dsw_evdev *dsw, uint8_t port_id,
 		fn(xstats_name, RTE_EVENT_DEV_XSTATS_PORT, port_id,
 		   xstats_id, fn_data);
 
-		if (!(xstat->per_queue && queue_id < dsw->num_queues)) {
+		if (param >= num_params) {
 			stat_idx++;
-			queue_id = 0;
+			param = 0;
 		}
 	}
 }
@@ -284,12 +317,12 @@ dsw_xstats_port_get(const struct rte_eventdev *dev, uint8_t port_id,
 		unsigned int id = ids[i];
 		unsigned int stat_idx = DSW_XSTATS_ID_GET_STAT(id);
 		struct dsw_xstats_port *xstat = &dsw_port_xstats[stat_idx];
-		uint8_t queue_id = 0;
+		uint8_t param = 0;
 
-		if (xstat->per_queue)
-			queue_id = DSW_XSTATS_ID_GET_PARAM(id);
+		if (xstat->param != DSW_XSTATS_PORT_PARAM_NONE)
+			param = DSW_XSTATS_ID_GET_PARAM(id);
 
-		values[i] = xstat->get_value_fn(dsw, port_id, queue_id);
+		values[i] = xstat->get_value_fn(dsw, port_id, param);
 	}
 	return n;
 }
@@ -19,6 +19,7 @@
 #define NUMA_NODE_ARG "numa_node"
 #define SCHED_QUANTA_ARG "sched_quanta"
 #define CREDIT_QUANTA_ARG "credit_quanta"
+#define SCHED_SHARDS_ARG "sched_shards"
 
 static void
 sw_info_get(struct rte_eventdev *dev, struct rte_event_dev_info *info);
@@ -114,6 +115,10 @@ sw_port_unlink(struct rte_eventdev *dev, void *port, uint8_t queues[],
 		}
 	}
 
+	/* every shard has to ack the unlinks */
+	if (unlinked && sw->nb_shards > 1)
+		__atomic_or_fetch(&p->unlink_shards, (1 << sw->nb_shards) - 1,
+				__ATOMIC_RELEASE);
 	p->unlinks_in_progress += unlinked;
 	rte_smp_mb();
 
@@ -128,14 +133,46 @@ sw_port_unlinks_in_progress(struct rte_eventdev *dev, void *port)
 	return p->unlinks_in_progress;
 }
 
+static struct rte_event_ring *
+sw_port_ring_create(struct rte_eventdev *dev, uint8_t port_id, uint32_t shard,
+		const char *type, unsigned int count)
+{
+	char buf[RTE_RING_NAMESIZE];
+	struct rte_event_ring *existing_ring;
+
+	/* check to see if rings exists - port_setup() can be called multiple
+	 * times legally (assuming device is stopped). If ring exists, free it
+	 * to so it gets re-created with the correct size
+	 */
+	snprintf(buf, sizeof(buf), "sw%d_p%u_s%u_%s", dev->data->dev_id,
+			port_id, shard, type);
+	existing_ring = rte_event_ring_lookup(buf);
+	if (existing_ring)
+		rte_event_ring_free(existing_ring);
+
+	return rte_event_ring_create(buf, count, dev->data->socket_id,
+			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
+}
+
+static void
+sw_port_free_rings(struct sw_port *p)
+{
+	unsigned int i;
+
+	for (i = 0; i < SW_SCHED_SHARDS_MAX; i++) {
+		rte_event_ring_free(p->rx_worker_ring[i]);
+		rte_event_ring_free(p->cq_worker_ring[i]);
+	}
+	rte_free(p->rel_shard);
+}
+
 static int
 sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		const struct rte_event_port_conf *conf)
 {
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 	struct sw_port *p = &sw->ports[port_id];
-	char buf[RTE_RING_NAMESIZE];
-	unsigned int i;
+	unsigned int i, s;
 
 	struct rte_event_dev_info info;
 	sw_info_get(dev, &info);
@@ -147,58 +184,66 @@ sw_port_setup(struct rte_eventdev *dev, uint8_t port_id,
 		 * available in the port (p->inflight_credits). We must return
 		 * the sum to no leak credits
 		 */
-		int possible_inflights = p->inflight_credits + p->inflights;
+		int possible_inflights = p->inflight_credits;
+		for (s = 0; s < sw->nb_shards; s++)
+			possible_inflights +=
+				sw->shards[s].ports[port_id].inflights;
 		rte_atomic32_sub(&sw->inflights, possible_inflights);
+		rte_free(p->rel_shard);
 	}
 
 	*p = (struct sw_port){0}; /* zero entire structure */
 	p->id = port_id;
 	p->sw = sw;
 
-	/* check to see if rings exists - port_setup() can be called multiple
-	 * times legally (assuming device is stopped). If ring exists, free it
-	 * to so it gets re-created with the correct size
-	 */
-	snprintf(buf, sizeof(buf), "sw%d_p%u_%s", dev->data->dev_id,
-			port_id, "rx_worker_ring");
-	struct rte_event_ring *existing_ring = rte_event_ring_lookup(buf);
-	if (existing_ring)
-		rte_event_ring_free(existing_ring);
-
-	p->rx_worker_ring = rte_event_ring_create(buf, MAX_SW_PROD_Q_DEPTH,
-			dev->data->socket_id,
-			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
-	if (p->rx_worker_ring == NULL) {
-		SW_LOG_ERR("Error creating RX worker ring for port %d\n",
-				port_id);
-		return -1;
-	}
-
 	p->inflight_max = conf->new_event_threshold;
 	p->implicit_release = !conf->disable_implicit_release;
 
-	/* check if ring exists, same as rx_worker above */
-	snprintf(buf, sizeof(buf), "sw%d_p%u, %s", dev->data->dev_id,
-			port_id, "cq_worker_ring");
-	existing_ring = rte_event_ring_lookup(buf);
-	if (existing_ring)
-		rte_event_ring_free(existing_ring);
+	/* one pair of rings for each shard to schedule the port */
+	for (s = 0; s < sw->nb_shards; s++) {
+		struct sw_shard *sh = &sw->shards[s];
+		struct sw_port_sched *ps = &sh->ports[port_id];
+
+		p->rx_worker_ring[s] = sw_port_ring_create(dev, port_id, s,
+				"rx_worker_ring", MAX_SW_PROD_Q_DEPTH);
+		if (p->rx_worker_ring[s] == NULL) {
+			sw_port_free_rings(p);
+			SW_LOG_ERR("Error creating RX worker ring for port %d\n",
+					port_id);
+			return -1;
+		}
 
-	p->cq_worker_ring = rte_event_ring_create(buf, conf->dequeue_depth,
-			dev->data->socket_id,
-			RING_F_SP_ENQ | RING_F_SC_DEQ | RING_F_EXACT_SZ);
-	if (p->cq_worker_ring == NULL) {
-		rte_event_ring_free(p->rx_worker_ring);
-		SW_LOG_ERR("Error creating CQ worker ring for port %d\n",
-				port_id);
-		return -1;
+		p->cq_worker_ring[s] = sw_port_ring_create(dev, port_id, s,
+				"cq_worker_ring", conf->dequeue_depth);
+		if (p->cq_worker_ring[s] == NULL) {
+			sw_port_free_rings(p);
+			SW_LOG_ERR("Error creating CQ worker ring for port %d\n",
+					port_id);
+			return -1;
+		}
+		sh->cq_ring_space[port_id] = conf->dequeue_depth;
+
+		/* set hist list contents to empty */
+		memset(ps, 0, sizeof(*ps));
+		for (i = 0; i < SW_PORT_HIST_LIST; i++) {
+			ps->hist_list[i].fid = -1;
+			ps->hist_list[i].qid = -1;
+		}
 	}
-	sw->cq_ring_space[port_id] = conf->dequeue_depth;
 
-	/* set hist list contents to empty */
-	for (i = 0; i < SW_PORT_HIST_LIST; i++) {
-		p->hist_list[i].fid = -1;
-		p->hist_list[i].qid = -1;
+	if (sw->nb_shards > 1) {
+		uint32_t size = rte_align32pow2(sw->nb_shards *
+				SW_PORT_HIST_LIST);
+
+		p->rel_shard = rte_zmalloc_socket(NULL, size, 0,
+				dev->data->socket_id);
+		if (p->rel_shard == NULL) {
+			sw_port_free_rings(p);
+			SW_LOG_ERR("Error allocating release list for port %d\n",
+					port_id);
+			return -1;
+		}
+		p->rel_shard_mask = size - 1;
 	}
 	dev->data->ports[port_id] = p;
 
@@ -214,8 +259,7 @@ sw_port_release(void *port)
 	if (p == NULL)
 		return;
 
-	rte_event_ring_free(p->rx_worker_ring);
-	rte_event_ring_free(p->cq_worker_ring);
+	sw_port_free_rings(p);
 	memset(p, 0, sizeof(*p));
 }
 
@@ -369,7 +413,7 @@ sw_init_qid_iqs(struct sw_evdev *sw)
 			continue;
 
 		for (j = 0; j < SW_IQS_MAX; j++)
-			iq_init(sw, &qid->iq[j]);
+			iq_init(&sw->shards[sw->qid_shard[i]], &qid->iq[j]);
 	}
 }
 
@@ -391,11 +435,21 @@ sw_qids_empty(struct sw_evdev *sw)
 static int
 sw_ports_empty(struct sw_evdev *sw)
 {
-	unsigned int i;
+	unsigned int i, s;
 
 	for (i = 0; i < sw->port_count; i++) {
-		if ((rte_event_ring_count(sw->ports[i].rx_worker_ring)) ||
-		     rte_event_ring_count(sw->ports[i].cq_worker_ring))
+		for (s = 0; s < sw->nb_shards; s++) {
+			if ((rte_event_ring_count(
+					sw->ports[i].rx_worker_ring[s])) ||
+			     rte_event_ring_count(
+					sw->ports[i].cq_worker_ring[s]))
+				return 0;
+		}
+	}
+
+	for (s = 0; s < sw->nb_shards; s++) {
+		if (sw->shards[s].fwd_ring &&
+		    rte_event_ring_count(sw->shards[s].fwd_ring))
 			return 0;
 	}
 
@@ -429,9 +483,9 @@ sw_drain_ports(struct rte_eventdev *dev)
 }
 
 static void
-sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
+sw_drain_queue(struct rte_eventdev *dev, struct sw_shard *sh,
+		struct sw_iq *iq)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
 	eventdev_stop_flush_t flush;
 	uint8_t dev_id;
 	void *arg;
@@ -443,7 +497,7 @@ sw_drain_queue(struct rte_eventdev *dev, struct sw_iq *iq)
 	while (iq_count(iq) > 0) {
 		struct rte_event ev;
 
-		iq_dequeue_burst(sw, iq, &ev, 1);
+		iq_dequeue_burst(sh, iq, &ev, 1);
 
 		if (flush)
 			flush(dev_id, ev, arg);
@@ -458,7 +512,8 @@ sw_drain_queues(struct rte_eventdev *dev)
 
 	for (i = 0; i < sw->qid_count; i++) {
 		for (j = 0; j < SW_IQS_MAX; j++)
-			sw_drain_queue(dev, &sw->qids[i].iq[j]);
+			sw_drain_queue(dev, &sw->shards[sw->qid_shard[i]],
+					&sw->qids[i].iq[j]);
 	}
 }
 
@@ -475,7 +530,8 @@ sw_clean_qid_iqs(struct rte_eventdev *dev)
 		for (j = 0; j < SW_IQS_MAX; j++) {
 			if (!qid->iq[j].head)
 				continue;
-			iq_free_chunk_list(sw, qid->iq[j].head);
+			iq_free_chunk_list(&sw->shards[sw->qid_shard[i]],
+					qid->iq[j].head);
 			qid->iq[j].head = NULL;
 		}
 	}
@@ -518,13 +574,16 @@ sw_dev_configure(const struct rte_eventdev *dev)
 	const struct rte_eventdev_data *data = dev->data;
 	const struct rte_event_dev_config *conf = &data->dev_conf;
 	int num_chunks, i;
+	uint32_t s;
 
 	sw->qid_count = conf->nb_event_queues;
 	sw->port_count = conf->nb_event_ports;
 	sw->nb_events_limit = conf->nb_events_limit;
 	rte_atomic32_set(&sw->inflights, 0);
 
-	/* Number of chunks sized for worst-case spread of events across IQs */
+	/* Number of chunks sized for worst-case spread of events across IQs,
+	 * for each shard as all of the events may end up in one of them.
+	 */
 	num_chunks = ((SW_INFLIGHT_EVENTS_TOTAL/SW_EVS_PER_Q_CHUNK)+1) +
 			sw->qid_count*SW_IQS_MAX*2;
 
@@ -537,15 +596,19 @@ sw_dev_configure(const struct rte_eventdev *dev)
 
 	sw->chunks = rte_malloc_socket(NULL,
 				       sizeof(struct sw_queue_chunk) *
-				       num_chunks,
+				       num_chunks * sw->nb_shards,
 				       0,
 				       sw->data->socket_id);
 	if (!sw->chunks)
 		return -ENOMEM;
 
-	sw->chunk_list_head = NULL;
-	for (i = 0; i < num_chunks; i++)
-		iq_free_chunk(sw, &sw->chunks[i]);
+	for (s = 0; s < sw->nb_shards; s++) {
+		struct sw_shard *sh = &sw->shards[s];
+
+		sh->chunk_list_head = NULL;
+		for (i = 0; i < num_chunks; i++)
+			iq_free_chunk(sh, &sw->chunks[s * num_chunks + i]);
+	}
 
 	if (conf->event_dev_cfg & RTE_EVENT_DEV_CFG_PER_DEQUEUE_TIMEOUT)
 		return -ENOTSUP;
@@ -629,16 +692,29 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	static const char * const q_type_strings[] = {
 			"Ordered", "Atomic", "Parallel", "Directed"
 	};
-	uint32_t i;
-	fprintf(f, "EventDev %s: ports %d, qids %d\n", "todo-fix-name",
-			sw->port_count, sw->qid_count);
-
-	fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64"\n\ttx   %"PRIu64"\n",
-		sw->stats.rx_pkts, sw->stats.rx_dropped, sw->stats.tx_pkts);
-	fprintf(f, "\tsched calls: %"PRIu64"\n", sw->sched_called);
-	fprintf(f, "\tsched cq/qid call: %"PRIu64"\n", sw->sched_cq_qid_called);
-	fprintf(f, "\tsched no IQ enq: %"PRIu64"\n", sw->sched_no_iq_enqueues);
-	fprintf(f, "\tsched no CQ enq: %"PRIu64"\n", sw->sched_no_cq_enqueues);
+	uint32_t i, s;
+	fprintf(f, "EventDev %s: ports %d, qids %d, shards %d\n",
+			"todo-fix-name", sw->port_count, sw->qid_count,
+			sw->nb_shards);
+
+	for (s = 0; s < sw->nb_shards; s++) {
+		const struct sw_shard *sh = &sw->shards[s];
+
+		fprintf(f, "  Shard %d: qids %d\n", s, sh->qid_count);
+		fprintf(f, "\trx   %"PRIu64"\n\tdrop %"PRIu64
+			"\n\ttx   %"PRIu64"\n", sh->stats.rx_pkts,
+			sh->stats.rx_dropped, sh->stats.tx_pkts);
+		fprintf(f, "\tsched calls: %"PRIu64"\n", sh->sched_called);
+		fprintf(f, "\tsched cq/qid call: %"PRIu64"\n",
+			sh->sched_cq_qid_called);
+		fprintf(f, "\tsched no IQ enq: %"PRIu64"\n",
+			sh->sched_no_iq_enqueues);
+		fprintf(f, "\tsched no CQ enq: %"PRIu64"\n",
+			sh->sched_no_cq_enqueues);
+		if (sh->fwd_ring)
+			fprintf(f, "\tforward ring used: %u\n",
+				rte_event_ring_count(sh->fwd_ring));
+	}
 	uint32_t inflights = rte_atomic32_read(&sw->inflights);
 	uint32_t credits = sw->nb_events_limit - inflights;
 	fprintf(f, "\tinflight %d, credits: %d\n", inflights, credits);
@@ -649,20 +725,29 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 	for (i = 0; i < sw->port_count; i++) {
 		int max, j;
 		const struct sw_port *p = &sw->ports[i];
+		uint64_t rx = 0, tx = 0;
+		uint32_t inflights = 0;
 		if (!p->initialized) {
 			fprintf(f, "  %sPort %d not initialized.%s\n",
 				COL_RED, i, COL_RESET);
 			continue;
 		}
+		for (s = 0; s < sw->nb_shards; s++) {
+			const struct sw_port_sched *ps =
+				&sw->shards[s].ports[i];
+
+			rx += ps->stats.rx_pkts;
+			tx += ps->stats.tx_pkts;
+			inflights += ps->inflights;
+		}
 		fprintf(f, "  Port %d %s\n", i,
 			p->is_directed ? " (SingleCons)" : "");
 		fprintf(f, "\trx   %"PRIu64"\tdrop %"PRIu64"\ttx   %"PRIu64
-			"\t%sinflight %d%s\n", sw->ports[i].stats.rx_pkts,
-			sw->ports[i].stats.rx_dropped,
-			sw->ports[i].stats.tx_pkts,
-			(p->inflights == p->inflight_max) ?
+			"\t%sinflight %d%s\n", rx,
+			sw->ports[i].stats.rx_dropped, tx,
+			(inflights == p->inflight_max) ?
 				COL_RED : COL_RESET,
-			sw->ports[i].inflights, COL_RESET);
+			inflights, COL_RESET);
 
 		fprintf(f, "\tMax New: %u"
 			"\tAvg cycles PP: %"PRIu64"\tCredits: %u\n",
@@ -688,25 +773,38 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 		}
 		fprintf(f, "\n");
 
-		if (p->rx_worker_ring) {
-			uint64_t used = rte_event_ring_count(p->rx_worker_ring);
-			uint64_t space = rte_event_ring_free_count(
-					p->rx_worker_ring);
-			const char *col = (space == 0) ? COL_RED : COL_RESET;
-			fprintf(f, "\t%srx ring used: %4"PRIu64"\tfree: %4"
-					PRIu64 COL_RESET"\n", col, used, space);
-		} else
-			fprintf(f, "\trx ring not initialized.\n");
-
-		if (p->cq_worker_ring) {
-			uint64_t used = rte_event_ring_count(p->cq_worker_ring);
-			uint64_t space = rte_event_ring_free_count(
-					p->cq_worker_ring);
-			const char *col = (space == 0) ? COL_RED : COL_RESET;
-			fprintf(f, "\t%scq ring used: %4"PRIu64"\tfree: %4"
-					PRIu64 COL_RESET"\n", col, used, space);
-		} else
-			fprintf(f, "\tcq ring not initialized.\n");
+		for (s = 0; s < sw->nb_shards; s++) {
+			const struct rte_event_ring *rx_ring =
+				p->rx_worker_ring[s];
+			const struct rte_event_ring *cq_ring =
+				p->cq_worker_ring[s];
+
+			if (rx_ring) {
+				uint64_t used = rte_event_ring_count(rx_ring);
+				uint64_t space =
+					rte_event_ring_free_count(rx_ring);
+				const char *col = (space == 0) ?
+					COL_RED : COL_RESET;
+				fprintf(f, "\t%srx ring %d used: %4"PRIu64
+					"\tfree: %4"PRIu64 COL_RESET"\n",
+					col, s, used, space);
+			} else
+				fprintf(f, "\trx ring %d not initialized.\n",
+					s);
+
+			if (cq_ring) {
+				uint64_t used = rte_event_ring_count(cq_ring);
+				uint64_t space =
+					rte_event_ring_free_count(cq_ring);
+				const char *col = (space == 0) ?
+					COL_RED : COL_RESET;
+				fprintf(f, "\t%scq ring %d used: %4"PRIu64
+					"\tfree: %4"PRIu64 COL_RESET"\n",
+					col, s, used, space);
+			} else
+				fprintf(f, "\tcq ring %d not initialized.\n",
+					s);
+		}
 	}
 
 	for (i = 0; i < sw->qid_count; i++) {
@@ -719,7 +817,8 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 		int affinities_per_port[SW_PORTS_MAX] = {0};
 		uint32_t inflights = 0;
 
-		fprintf(f, "  Queue %d (%s)\n", i, q_type_strings[qid->type]);
+		fprintf(f, "  Queue %d (%s), shard %d\n", i,
+			q_type_strings[qid->type], sw->qid_shard[i]);
 		fprintf(f, "\trx   %"PRIu64"\tdrop %"PRIu64"\ttx   %"PRIu64"\n",
 			qid->stats.rx_pkts, qid->stats.rx_dropped,
 			qid->stats.tx_pkts);
@@ -773,7 +872,7 @@ sw_dump(struct rte_eventdev *dev, FILE *f)
 static int
 sw_start(struct rte_eventdev *dev)
 {
-	unsigned int i, j;
+	unsigned int i, j, s;
 	struct sw_evdev *sw = sw_pmd_priv(dev);
 
 	rte_service_component_runstate_set(sw->service_id, 1);
@@ -787,7 +886,7 @@ sw_start(struct rte_eventdev *dev)
 
 	/* check all ports are set up */
 	for (i = 0; i < sw->port_count; i++)
-		if (sw->ports[i].rx_worker_ring == NULL) {
+		if (sw->ports[i].rx_worker_ring[0] == NULL) {
 			SW_LOG_ERR("Port %d not configured\n", i);
 			return -ESTALE;
 		}
@@ -800,18 +899,21 @@ sw_start(struct rte_eventdev *dev)
 			return -ENOLINK;
 		}
 
-	/* build up our prioritized array of qids */
+	/* build up the prioritized array of qids of each shard */
 	/* We don't use qsort here, as if all/multiple entries have the same
 	 * priority, the result is non-deterministic. From "man 3 qsort":
 	 * "If two members compare as equal, their order in the sorted
 	 * array is undefined."
 	 */
-	uint32_t qidx = 0;
+	for (s = 0; s < sw->nb_shards; s++)
+		sw->shards[s].qid_count = 0;
 	for (j = 0; j <= RTE_EVENT_DEV_PRIORITY_LOWEST; j++) {
 		for (i = 0; i < sw->qid_count; i++) {
 			if (sw->qids[i].priority == j) {
-				sw->qids_prioritized[qidx] = &sw->qids[i];
-				qidx++;
+				struct sw_shard *sh =
+					&sw->shards[sw->qid_shard[i]];
+				sh->qids_prioritized[sh->qid_count++] =
+					&sw->qids[i];
 			}
 		}
 	}
@@ -871,11 +973,15 @@ sw_close(struct rte_eventdev *dev)
 		sw_port_release(&sw->ports[i]);
 	sw->port_count = 0;
 
-	memset(&sw->stats, 0, sizeof(sw->stats));
-	sw->sched_called = 0;
-	sw->sched_no_iq_enqueues = 0;
-	sw->sched_no_cq_enqueues = 0;
-	sw->sched_cq_qid_called = 0;
+	for (i = 0; i < sw->nb_shards; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+
+		memset(&sh->stats, 0, sizeof(sh->stats));
+		sh->sched_called = 0;
+		sh->sched_no_iq_enqueues = 0;
+		sh->sched_no_cq_enqueues = 0;
+		sh->sched_cq_qid_called = 0;
+	}
 
 	return 0;
 }
@@ -910,6 +1016,15 @@ set_credit_quanta(const char *key __rte_unused, const char *value, void *opaque)
 	return 0;
 }
 
+static int
+set_sched_shards(const char *key __rte_unused, const char *value, void *opaque)
+{
+	int *shards = opaque;
+	*shards = atoi(value);
+	if (*shards < 1 || *shards > SW_SCHED_SHARDS_MAX)
+		return -1;
+	return 0;
+}
 
 static int32_t sw_sched_service_func(void *args)
 {
@@ -918,6 +1033,91 @@ static int32_t sw_sched_service_func(void *args)
 	return 0;
 }
 
+/* With several shards the service is multi-thread safe: each call schedules
+ * the first shard which no other service core is busy with.
+ */
+static int32_t sw_sched_shards_service_func(void *args)
+{
+	struct rte_eventdev *dev = args;
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	uint32_t start = __atomic_fetch_add(&sw->next_shard, 1,
+			__ATOMIC_RELAXED);
+	uint32_t i;
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		struct sw_shard *sh = &sw->shards[(start + i) % sw->nb_shards];
+
+		if (!rte_spinlock_trylock(&sh->lock))
+			continue;
+		sw_event_schedule_shard(sh);
+		rte_spinlock_unlock(&sh->lock);
+		break;
+	}
+	return 0;
+}
+
+static void
+sw_shards_free(struct sw_shard *shards, uint32_t nb_shards)
+{
+	uint32_t i;
+
+	if (shards == NULL)
+		return;
+
+	for (i = 0; i < nb_shards; i++)
+		rte_event_ring_free(shards[i].fwd_ring);
+	rte_free(shards);
+}
+
+static int
+sw_shards_init(struct sw_evdev *sw, uint32_t nb_shards, int socket_id)
+{
+	char buf[RTE_RING_NAMESIZE];
+	uint32_t i;
+
+	sw->shards = rte_zmalloc_socket(NULL,
+			sizeof(sw->shards[0]) * nb_shards,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (sw->shards == NULL)
+		return -ENOMEM;
+	sw->nb_shards = nb_shards;
+
+	for (i = 0; i < nb_shards; i++) {
+		struct sw_shard *sh = &sw->shards[i];
+
+		sh->sw = sw;
+		sh->id = i;
+		rte_spinlock_init(&sh->lock);
+		if (nb_shards == 1)
+			break;
+
+		/* sized for all the events of the device, so that the other
+		 * shards never fail to pass events on
+		 */
+		snprintf(buf, sizeof(buf), "sw%d_s%u_fwd_ring",
+				sw->data->dev_id, i);
+		struct rte_event_ring *existing_ring =
+			rte_event_ring_lookup(buf);
+		if (existing_ring)
+			rte_event_ring_free(existing_ring);
+
+		sh->fwd_ring = rte_event_ring_create(buf,
+				SW_INFLIGHT_EVENTS_TOTAL, socket_id,
+				RING_F_SC_DEQ | RING_F_EXACT_SZ);
+		if (sh->fwd_ring == NULL) {
+			sw_shards_free(sw->shards, nb_shards);
+			sw->shards = NULL;
+			return -ENOMEM;
+		}
+	}
+
+	/* spread the queues over the shards */
+	for (i = 0; i < RTE_EVENT_MAX_QUEUES_PER_DEV; i++)
+		sw->qid_shard[i] = i % nb_shards;
+
+	return 0;
+}
+
 static int
 sw_probe(struct rte_vdev_device *vdev)
 {
@@ -957,6 +1157,7 @@ sw_probe(struct rte_vdev_device *vdev)
 		NUMA_NODE_ARG,
 		SCHED_QUANTA_ARG,
 		CREDIT_QUANTA_ARG,
+		SCHED_SHARDS_ARG,
 		NULL
 	};
 	const char *name;
@@ -966,6 +1167,7 @@ sw_probe(struct rte_vdev_device *vdev)
 	int socket_id = rte_socket_id();
 	int sched_quanta  = SW_DEFAULT_SCHED_QUANTA;
 	int credit_quanta = SW_DEFAULT_CREDIT_QUANTA;
+	int sched_shards = 1;
 
 	name = rte_vdev_device_name(vdev);
 	params = rte_vdev_device_args(vdev);
@@ -1007,13 +1209,24 @@ sw_probe(struct rte_vdev_device *vdev)
 				return ret;
 			}
 
+			ret = rte_kvargs_process(kvlist, SCHED_SHARDS_ARG,
+					set_sched_shards, &sched_shards);
+			if (ret != 0) {
+				SW_LOG_ERR(
+					"%s: Error parsing sched shards parameter",
+					name);
+				rte_kvargs_free(kvlist);
+				return ret;
+			}
+
 			rte_kvargs_free(kvlist);
 		}
 	}
 
 	SW_LOG_INFO(
-			"Creating eventdev sw device %s, numa_node=%d, sched_quanta=%d, credit_quanta=%d\n",
-			name, socket_id, sched_quanta, credit_quanta);
+			"Creating eventdev sw device %s, numa_node=%d, sched_quanta=%d, credit_quanta=%d, sched_shards=%d\n",
+			name, socket_id, sched_quanta, credit_quanta,
+			sched_shards);
 
 	dev = rte_event_pmd_vdev_init(name,
 			sizeof(struct sw_evdev), socket_id);
@@ -1039,6 +1252,11 @@ sw_probe(struct rte_vdev_device *vdev)
 	sw->credit_update_quanta = credit_quanta;
 	sw->sched_quanta = sched_quanta;
 
+	if (sw_shards_init(sw, sched_shards, socket_id) < 0) {
+		SW_LOG_ERR("scheduler shards init failed");
+		return -ENOMEM;
+	}
+
 	/* register service with EAL */
 	struct rte_service_spec service;
 	memset(&service, 0, sizeof(struct rte_service_spec));
@@ -1048,10 +1266,16 @@ sw_probe(struct rte_vdev_device *vdev)
 	service.socket_id = socket_id;
 	service.callback = sw_sched_service_func;
 	service.callback_userdata = (void *)dev;
+	if (sw->nb_shards > 1) {
+		service.callback = sw_sched_shards_service_func;
+		service.capabilities = RTE_SERVICE_CAP_MT_SAFE;
+	}
 
 	int32_t ret = rte_service_component_register(&service, &sw->service_id);
 	if (ret) {
 		SW_LOG_ERR("service register() failed");
+		sw_shards_free(sw->shards, sw->nb_shards);
+		sw->shards = NULL;
 		return -ENOEXEC;
 	}
 
@@ -1064,7 +1288,11 @@ sw_probe(struct rte_vdev_device *vdev)
 static int
 sw_remove(struct rte_vdev_device *vdev)
 {
+	struct rte_eventdev *dev;
+	struct sw_shard *shards = NULL;
+	uint32_t nb_shards = 0;
 	const char *name;
+	int ret;
 
 	name = rte_vdev_device_name(vdev);
 	if (name == NULL)
@@ -1072,7 +1300,17 @@ sw_remove(struct rte_vdev_device *vdev)
 
 	SW_LOG_INFO("Closing eventdev sw device %s\n", name);
 
-	return rte_event_pmd_vdev_uninit(name);
+	dev = rte_event_pmd_get_named_dev(name);
+	if (dev != NULL && rte_eal_process_type() == RTE_PROC_PRIMARY) {
+		shards = sw_pmd_priv(dev)->shards;
+		nb_shards = sw_pmd_priv(dev)->nb_shards;
+	}
+
+	ret = rte_event_pmd_vdev_uninit(name);
+	if (ret == 0)
+		sw_shards_free(shards, nb_shards);
+
+	return ret;
 }
 
 static struct rte_vdev_driver evdev_sw_pmd_drv = {
@@ -1082,7 +1320,8 @@ static struct rte_vdev_driver evdev_sw_pmd_drv = {
 
 RTE_PMD_REGISTER_VDEV(EVENTDEV_NAME_SW_PMD, evdev_sw_pmd_drv);
 RTE_PMD_REGISTER_PARAM_STRING(event_sw, NUMA_NODE_ARG "=<int> "
-		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int>");
+		SCHED_QUANTA_ARG "=<int>" CREDIT_QUANTA_ARG "=<int> "
+		SCHED_SHARDS_ARG "=<int>");
 
 /* declared extern in header, for access from other .c files */
 int eventdev_sw_log_level;
@@ -9,6 +9,7 @@
 #include <rte_eventdev.h>
 #include <rte_eventdev_pmd_vdev.h>
 #include <rte_atomic.h>
+#include <rte_spinlock.h>
 
 #define SW_DEFAULT_CREDIT_QUANTA 32
 #define SW_DEFAULT_SCHED_QUANTA 128
@@ -21,6 +22,7 @@
 /* allow for lots of over-provisioning */
 #define MAX_SW_PROD_Q_DEPTH 4096
 #define SW_FRAGMENTS_MAX 16
+#define SW_SCHED_SHARDS_MAX 8
 
 /* Should be power-of-two minus one, to leave room for the next pointer */
 #define SW_EVS_PER_Q_CHUNK 255
@@ -137,6 +139,24 @@ struct sw_hist_list_entry {
 
 struct sw_evdev;
 
+/* Scheduler state of a port, one instance per scheduler shard */
+struct sw_port_sched {
+	/* History list structs, containing info on pkts egressed to worker */
+	uint16_t hist_head __rte_cache_aligned;
+	uint16_t hist_tail;
+	uint16_t inflights;
+	struct sw_hist_list_entry hist_list[SW_PORT_HIST_LIST];
+
+	/* track packets in and out of this port */
+	struct sw_point_stats stats;
+
+	uint32_t pp_buf_start;
+	uint32_t pp_buf_count;
+	uint16_t cq_buf_count;
+	struct rte_event pp_buf[SCHED_DEQUEUE_BURST_SIZE];
+	struct rte_event cq_buf[MAX_SW_CONS_Q_DEPTH];
+};
+
 struct sw_port {
 	/* new enqueue / dequeue API doesn't have an instance pointer, only the
 	 * pointer to the port being enqueue/dequeued from
@@ -155,6 +175,8 @@ struct sw_port {
 	 * the port - hence the scheduler core can just assign zero.
 	 */
 	uint8_t unlinks_in_progress;
+	/* Scheduler shards which have not acked the unlinks yet */
+	uint32_t unlink_shards;
 
 	int16_t is_directed; /** Takes from a single directed QID */
 	/**
@@ -163,12 +185,20 @@ struct sw_port {
 	 */
 	int16_t num_ordered_qids;
 
-	/** Ring and buffer for pulling events from workers for scheduling */
-	struct rte_event_ring *rx_worker_ring __rte_cache_aligned;
-	/** Ring and buffer for pushing packets to workers after scheduling */
-	struct rte_event_ring *cq_worker_ring;
+	/** Rings for pulling events from workers for scheduling, per shard */
+	struct rte_event_ring *rx_worker_ring[SW_SCHED_SHARDS_MAX]
+		__rte_cache_aligned;
+	/** Rings for pushing packets to workers after scheduling, per shard */
+	struct rte_event_ring *cq_worker_ring[SW_SCHED_SHARDS_MAX];
 
-	/* hole */
+	/* Shards the outstanding events were dequeued from, in order, when
+	 * the device has several scheduler shards
+	 */
+	uint8_t *rel_shard;
+	uint32_t rel_shard_mask;
+	uint32_t rel_shard_head;
+	uint32_t rel_shard_tail;
+	uint32_t deq_shard; /* shard to dequeue from first */
 
 	/* num releases yet to be completed on this port */
 	uint16_t outstanding_releases __rte_cache_aligned;
@@ -184,23 +214,46 @@ struct sw_port {
 	uint32_t poll_buckets[SW_NUM_POLL_BUCKETS];
 		/* bucket values in 4s for shorter reporting */
 
-	/* History list structs, containing info on pkts egressed to worker */
-	uint16_t hist_head __rte_cache_aligned;
-	uint16_t hist_tail;
-	uint16_t inflights;
-	struct sw_hist_list_entry hist_list[SW_PORT_HIST_LIST];
-
-	/* track packets in and out of this port */
+	/* packets dropped on enqueue by this port */
 	struct sw_point_stats stats;
 
+	uint8_t num_qids_mapped;
+};
 
-	uint32_t pp_buf_start;
-	uint32_t pp_buf_count;
-	uint16_t cq_buf_count;
-	struct rte_event pp_buf[SCHED_DEQUEUE_BURST_SIZE];
-	struct rte_event cq_buf[MAX_SW_CONS_Q_DEPTH];
+/*
+ * A scheduler shard owns a subset of the QIDs: it alone moves events into
+ * and out of their IQs, reorders them and tracks the flows pinned to the
+ * ports. Each shard has its own rings to and from every port, so several
+ * shards can be scheduled concurrently by different service cores.
+ */
+struct sw_shard {
+	struct sw_evdev *sw;
+	uint32_t id;
+	rte_spinlock_t lock; /* taken when there are several shards */
 
-	uint8_t num_qids_mapped;
+	/* Array of pointers to the owned QIDs sorted by priority level */
+	uint32_t qid_count;
+	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
+
+	/* Events sent to the owned QIDs by the other shards */
+	struct rte_event_ring *fwd_ring;
+	/* Events to send to the other shards, flushed in bursts */
+	uint16_t fwd_buf_count[SW_SCHED_SHARDS_MAX];
+	struct rte_event fwd_buf[SW_SCHED_SHARDS_MAX][SCHED_DEQUEUE_BURST_SIZE];
+
+	struct sw_queue_chunk *chunk_list_head;
+
+	/* Cache how many packets are in each cq */
+	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
+
+	/* Stats */
+	struct sw_point_stats stats __rte_cache_aligned;
+	uint64_t sched_called;
+	uint64_t sched_no_iq_enqueues;
+	uint64_t sched_no_cq_enqueues;
+	uint64_t sched_cq_qid_called;
+
+	struct sw_port_sched ports[SW_PORTS_MAX] __rte_cache_aligned;
 };
 
 struct sw_evdev {
@@ -227,22 +280,15 @@ struct sw_evdev {
 
 	/* Internal queues - one per logical queue */
 	struct sw_qid qids[RTE_EVENT_MAX_QUEUES_PER_DEV] __rte_cache_aligned;
-	struct sw_queue_chunk *chunk_list_head;
 	struct sw_queue_chunk *chunks;
 
-	/* Cache how many packets are in each cq */
-	uint16_t cq_ring_space[SW_PORTS_MAX] __rte_cache_aligned;
+	/* Scheduler shards, and the one owning each QID */
+	uint32_t nb_shards;
+	uint32_t next_shard;
+	struct sw_shard *shards;
+	uint8_t qid_shard[RTE_EVENT_MAX_QUEUES_PER_DEV];
 
-	/* Array of pointers to load-balanced QIDs sorted by priority level */
-	struct sw_qid *qids_prioritized[RTE_EVENT_MAX_QUEUES_PER_DEV];
-
-	/* Stats */
-	struct sw_point_stats stats __rte_cache_aligned;
-	uint64_t sched_called;
 	int32_t sched_quanta;
-	uint64_t sched_no_iq_enqueues;
-	uint64_t sched_no_cq_enqueues;
-	uint64_t sched_cq_qid_called;
 
 	uint8_t started;
 	uint32_t credit_update_quanta;
@@ -278,6 +324,7 @@ uint16_t sw_event_dequeue(void *port, struct rte_event *ev, uint64_t wait);
 uint16_t sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 			uint64_t wait);
 void sw_event_schedule(struct rte_eventdev *dev);
+void sw_event_schedule_shard(struct sw_shard *sh);
 int sw_xstats_init(struct sw_evdev *dev);
 int sw_xstats_uninit(struct sw_evdev *dev);
 int sw_xstats_get_names(const struct rte_eventdev *dev,
@@ -27,9 +27,10 @@
 #define SW_HASH_FLOWID(f) (((f) ^ (f >> 10)) & FLOWID_MASK)
 
 static inline uint32_t
-sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
+sw_schedule_atomic_to_cq(struct sw_shard *sh, struct sw_qid * const qid,
 		uint32_t iq_num, unsigned int count)
 {
+	struct sw_evdev *sw = sh->sw;
 	struct rte_event qes[MAX_PER_IQ_DEQUEUE]; /* count <= MAX */
 	struct rte_event blocked_qes[MAX_PER_IQ_DEQUEUE];
 	uint32_t nb_blocked = 0;
@@ -43,7 +44,7 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	 */
 	uint32_t qid_id = qid->id;
 
-	iq_dequeue_burst(sw, &qid->iq[iq_num], qes, count);
+	iq_dequeue_burst(sh, &qid->iq[iq_num], qes, count);
 	for (i = 0; i < count; i++) {
 		const struct rte_event *qe = &qes[i];
 		const uint16_t flow_id = SW_HASH_FLOWID(qes[i].flow_id);
@@ -59,11 +60,11 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			cq = qid->cq_map[cq_idx];
 
 			/* find least used */
-			int cq_free_cnt = sw->cq_ring_space[cq];
+			int cq_free_cnt = sh->cq_ring_space[cq];
 			for (cq_idx = 0; cq_idx < qid->cq_num_mapped_cqs;
 					cq_idx++) {
 				int test_cq = qid->cq_map[cq_idx];
-				int test_cq_free = sw->cq_ring_space[test_cq];
+				int test_cq_free = sh->cq_ring_space[test_cq];
 				if (test_cq_free > cq_free_cnt) {
 					cq = test_cq;
 					cq_free_cnt = test_cq_free;
@@ -73,19 +74,19 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			fid->cq = cq; /* this pins early */
 		}
 
-		if (sw->cq_ring_space[cq] == 0 ||
-				sw->ports[cq].inflights == SW_PORT_HIST_LIST) {
+		if (sh->cq_ring_space[cq] == 0 ||
+				sh->ports[cq].inflights == SW_PORT_HIST_LIST) {
 			blocked_qes[nb_blocked++] = *qe;
 			continue;
 		}
 
-		struct sw_port *p = &sw->ports[cq];
+		struct sw_port_sched *p = &sh->ports[cq];
 
 		/* at this point we can queue up the packet on the cq_buf */
 		fid->pcount++;
 		p->cq_buf[p->cq_buf_count++] = *qe;
 		p->inflights++;
-		sw->cq_ring_space[cq]--;
+		sh->cq_ring_space[cq]--;
 
 		int head = (p->hist_head++ & (SW_PORT_HIST_LIST-1));
 		p->hist_list[head].fid = flow_id;
@@ -96,23 +97,25 @@ sw_schedule_atomic_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 		qid->to_port[cq]++;
 
 		/* if we just filled in the last slot, flush the buffer */
-		if (sw->cq_ring_space[cq] == 0) {
-			struct rte_event_ring *worker = p->cq_worker_ring;
+		if (sh->cq_ring_space[cq] == 0) {
+			struct rte_event_ring *worker =
+				sw->ports[cq].cq_worker_ring[sh->id];
 			rte_event_ring_enqueue_burst(worker, p->cq_buf,
 					p->cq_buf_count,
-					&sw->cq_ring_space[cq]);
+					&sh->cq_ring_space[cq]);
 			p->cq_buf_count = 0;
 		}
 	}
-	iq_put_back(sw, &qid->iq[iq_num], blocked_qes, nb_blocked);
+	iq_put_back(sh, &qid->iq[iq_num], blocked_qes, nb_blocked);
 
 	return count - nb_blocked;
 }
 
 static inline uint32_t
-sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
+sw_schedule_parallel_to_cq(struct sw_shard *sh, struct sw_qid * const qid,
 		uint32_t iq_num, unsigned int count, int keep_order)
 {
+	struct sw_evdev *sw = sh->sw;
 	uint32_t i;
 	uint32_t cq_idx = qid->cq_next_tx;
 
@@ -147,15 +150,15 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			cq = qid->cq_map[cq_idx++];
 
 		} while (rte_event_ring_free_count(
-				sw->ports[cq].cq_worker_ring) == 0 ||
-				sw->ports[cq].inflights == SW_PORT_HIST_LIST);
+				sw->ports[cq].cq_worker_ring[sh->id]) == 0 ||
+				sh->ports[cq].inflights == SW_PORT_HIST_LIST);
 
-		struct sw_port *p = &sw->ports[cq];
-		if (sw->cq_ring_space[cq] == 0 ||
+		struct sw_port_sched *p = &sh->ports[cq];
+		if (sh->cq_ring_space[cq] == 0 ||
 				p->inflights == SW_PORT_HIST_LIST)
 			break;
 
-		sw->cq_ring_space[cq]--;
+		sh->cq_ring_space[cq]--;
 
 		qid->stats.tx_pkts++;
 
@@ -167,8 +170,8 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 			rte_ring_sc_dequeue(qid->reorder_buffer_freelist,
 					(void *)&p->hist_list[head].rob_entry);
 
-		sw->ports[cq].cq_buf[sw->ports[cq].cq_buf_count++] = *qe;
-		iq_pop(sw, &qid->iq[iq_num]);
+		p->cq_buf[p->cq_buf_count++] = *qe;
+		iq_pop(sh, &qid->iq[iq_num]);
 
 		rte_compiler_barrier();
 		p->inflights++;
@@ -181,20 +184,20 @@ sw_schedule_parallel_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 }
 
 static uint32_t
-sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
+sw_schedule_dir_to_cq(struct sw_shard *sh, struct sw_qid * const qid,
 		uint32_t iq_num, unsigned int count __rte_unused)
 {
 	uint32_t cq_id = qid->cq_map[0];
-	struct sw_port *port = &sw->ports[cq_id];
+	struct sw_port_sched *port = &sh->ports[cq_id];
 
 	/* get max burst enq size for cq_ring */
-	uint32_t count_free = sw->cq_ring_space[cq_id];
+	uint32_t count_free = sh->cq_ring_space[cq_id];
 	if (count_free == 0)
 		return 0;
 
 	/* burst dequeue from the QID IQ ring */
 	struct sw_iq *iq = &qid->iq[iq_num];
-	uint32_t ret = iq_dequeue_burst(sw, iq,
+	uint32_t ret = iq_dequeue_burst(sh, iq,
 			&port->cq_buf[port->cq_buf_count], count_free);
 	port->cq_buf_count += ret;
 
@@ -203,21 +206,21 @@ sw_schedule_dir_to_cq(struct sw_evdev *sw, struct sw_qid * const qid,
 	port->stats.tx_pkts += ret;
 
 	/* Subtract credits from cached value */
-	sw->cq_ring_space[cq_id] -= ret;
+	sh->cq_ring_space[cq_id] -= ret;
 
 	return ret;
 }
 
 static uint32_t
-sw_schedule_qid_to_cq(struct sw_evdev *sw)
+sw_schedule_qid_to_cq(struct sw_shard *sh)
 {
 	uint32_t pkts = 0;
 	uint32_t qid_idx;
 
-	sw->sched_cq_qid_called++;
+	sh->sched_cq_qid_called++;
 
-	for (qid_idx = 0; qid_idx < sw->qid_count; qid_idx++) {
-		struct sw_qid *qid = sw->qids_prioritized[qid_idx];
+	for (qid_idx = 0; qid_idx < sh->qid_count; qid_idx++) {
+		struct sw_qid *qid = sh->qids_prioritized[qid_idx];
 
 		int type = qid->type;
 		int iq_num = PKT_MASK_TO_IQ(qid->iq_pkt_mask);
@@ -231,13 +234,13 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 
 		if (count > 0) {
 			if (type == SW_SCHED_TYPE_DIRECT)
-				pkts_done += sw_schedule_dir_to_cq(sw, qid,
+				pkts_done += sw_schedule_dir_to_cq(sh, qid,
 						iq_num, count);
 			else if (type == RTE_SCHED_TYPE_ATOMIC)
-				pkts_done += sw_schedule_atomic_to_cq(sw, qid,
+				pkts_done += sw_schedule_atomic_to_cq(sh, qid,
 						iq_num, count);
 			else
-				pkts_done += sw_schedule_parallel_to_cq(sw, qid,
+				pkts_done += sw_schedule_parallel_to_cq(sh, qid,
 						iq_num, count,
 						type == RTE_SCHED_TYPE_ORDERED);
 		}
@@ -254,19 +257,44 @@ sw_schedule_qid_to_cq(struct sw_evdev *sw)
 	return pkts;
 }
 
+/* Events headed to a QID owned by another shard are buffered per destination
+ * and handed over through the forward ring of the owner. The forward rings
+ * hold as many events as the device allows inflight, so the enqueue cannot
+ * fail.
+ */
+static __rte_always_inline void
+sw_shard_fwd_flush(struct sw_shard *sh, uint32_t dst)
+{
+	struct rte_event_ring *ring = sh->sw->shards[dst].fwd_ring;
+
+	rte_event_ring_enqueue_burst(ring, sh->fwd_buf[dst],
+			sh->fwd_buf_count[dst], NULL);
+	sh->fwd_buf_count[dst] = 0;
+}
+
+static __rte_always_inline void
+sw_shard_fwd(struct sw_shard *sh, uint32_t dst, const struct rte_event *qe)
+{
+	sh->fwd_buf[dst][sh->fwd_buf_count[dst]++] = *qe;
+	if (sh->fwd_buf_count[dst] == SCHED_DEQUEUE_BURST_SIZE)
+		sw_shard_fwd_flush(sh, dst);
+}
+
 /* This function will perform re-ordering of packets, and injecting into
- * the appropriate QID IQ. As LB and DIR QIDs are in the same array, but *NOT*
- * contiguous in that array, this function accepts a "range" of QIDs to scan.
+ * the appropriate QID IQ. Only the ordered QIDs owned by the shard are
+ * scanned, as the reorder buffer of a QID is tracked by its owner.
  */
 static uint16_t
-sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
+sw_schedule_reorder(struct sw_shard *sh)
 {
 	/* Perform egress reordering */
+	struct sw_evdev *sw = sh->sw;
 	struct rte_event *qe;
 	uint32_t pkts_iter = 0;
+	uint32_t qid_idx;
 
-	for (; qid_start < qid_end; qid_start++) {
-		struct sw_qid *qid = &sw->qids[qid_start];
+	for (qid_idx = 0; qid_idx < sh->qid_count; qid_idx++) {
+		struct sw_qid *qid = sh->qids_prioritized[qid_idx];
 		int i, num_entries_in_use;
 
 		if (qid->type != RTE_SCHED_TYPE_ORDERED)
@@ -287,6 +315,7 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 			for (j = 0; j < entry->num_fragments; j++) {
 				uint16_t dest_qid;
 				uint16_t dest_iq;
+				uint8_t dest_shard;
 
 				int idx = entry->fragment_index + j;
 				qe = &entry->fragments[idx];
@@ -295,7 +324,13 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 				dest_iq  = PRIO_TO_IQ(qe->priority);
 
 				if (dest_qid >= sw->qid_count) {
-					sw->stats.rx_dropped++;
+					sh->stats.rx_dropped++;
+					continue;
+				}
+
+				dest_shard = sw->qid_shard[dest_qid];
+				if (dest_shard != sh->id) {
+					sw_shard_fwd(sh, dest_shard, qe);
 					continue;
 				}
 
@@ -307,7 +342,7 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 				/* we checked for space above, so enqueue must
 				 * succeed
 				 */
-				iq_enqueue(sw, iq, qe);
+				iq_enqueue(sh, iq, qe);
 				q->iq_pkt_mask |= (1 << (dest_iq));
 				q->iq_pkt_count[dest_iq]++;
 				q->stats.rx_pkts++;
@@ -333,25 +368,27 @@ sw_schedule_reorder(struct sw_evdev *sw, int qid_start, int qid_end)
 }
 
 static __rte_always_inline void
-sw_refill_pp_buf(struct sw_evdev *sw, struct sw_port *port)
+sw_refill_pp_buf(struct sw_shard *sh, uint32_t port_id)
 {
-	RTE_SET_USED(sw);
-	struct rte_event_ring *worker = port->rx_worker_ring;
+	struct sw_port_sched *port = &sh->ports[port_id];
+	struct rte_event_ring *worker =
+		sh->sw->ports[port_id].rx_worker_ring[sh->id];
 	port->pp_buf_start = 0;
 	port->pp_buf_count = rte_event_ring_dequeue_burst(worker, port->pp_buf,
 			RTE_DIM(port->pp_buf), NULL);
 }
 
 static __rte_always_inline uint32_t
-__pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
+__pull_port_lb(struct sw_shard *sh, uint32_t port_id, int allow_reorder)
 {
 	static struct reorder_buffer_entry dummy_rob;
+	struct sw_evdev *sw = sh->sw;
 	uint32_t pkts_iter = 0;
-	struct sw_port *port = &sw->ports[port_id];
+	struct sw_port_sched *port = &sh->ports[port_id];
 
 	/* If shadow ring has 0 pkts, pull from worker ring */
 	if (port->pp_buf_count == 0)
-		sw_refill_pp_buf(sw, port);
+		sw_refill_pp_buf(sh, port_id);
 
 	while (port->pp_buf_count) {
 		const struct rte_event *qe = &port->pp_buf[port->pp_buf_start];
@@ -422,7 +459,7 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				 */
 				int num_frag = rob_entry->num_fragments;
 				if (num_frag == SW_FRAGMENTS_MAX)
-					sw->stats.rx_dropped++;
+					sh->stats.rx_dropped++;
 				else {
 					int idx = rob_entry->num_fragments++;
 					rob_entry->fragments[idx] = *qe;
@@ -430,12 +467,21 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 				goto end_qe;
 			}
 
+			/* Completions come back to the shard which scheduled
+			 * the event, pass it on if the next QID is not ours.
+			 */
+			const uint8_t dest_shard = sw->qid_shard[qe->queue_id];
+			if (unlikely(dest_shard != sh->id)) {
+				sw_shard_fwd(sh, dest_shard, qe);
+				goto end_qe;
+			}
+
 			/* Use the iq_num from above to push the QE
 			 * into the qid at the right priority
 			 */
 
 			qid->iq_pkt_mask |= (1 << (iq_num));
-			iq_enqueue(sw, &qid->iq[iq_num], qe);
+			iq_enqueue(sh, &qid->iq[iq_num], qe);
 			qid->iq_pkt_count[iq_num]++;
 			qid->stats.rx_pkts++;
 			pkts_iter++;
@@ -450,26 +496,27 @@ __pull_port_lb(struct sw_evdev *sw, uint32_t port_id, int allow_reorder)
 }
 
 static uint32_t
-sw_schedule_pull_port_lb(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_lb(struct sw_shard *sh, uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 1);
+	return __pull_port_lb(sh, port_id, 1);
 }
 
 static uint32_t
-sw_schedule_pull_port_no_reorder(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_no_reorder(struct sw_shard *sh, uint32_t port_id)
 {
-	return __pull_port_lb(sw, port_id, 0);
+	return __pull_port_lb(sh, port_id, 0);
 }
 
 static uint32_t
-sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
+sw_schedule_pull_port_dir(struct sw_shard *sh, uint32_t port_id)
 {
+	struct sw_evdev *sw = sh->sw;
 	uint32_t pkts_iter = 0;
-	struct sw_port *port = &sw->ports[port_id];
+	struct sw_port_sched *port = &sh->ports[port_id];
 
 	/* If shadow ring has 0 pkts, pull from worker ring */
 	if (port->pp_buf_count == 0)
-		sw_refill_pp_buf(sw, port);
+		sw_refill_pp_buf(sh, port_id);
 
 	while (port->pp_buf_count) {
 		const struct rte_event *qe = &port->pp_buf[port->pp_buf_start];
@@ -484,11 +531,17 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 
 		port->stats.rx_pkts++;
 
+		const uint8_t dest_shard = sw->qid_shard[qe->queue_id];
+		if (unlikely(dest_shard != sh->id)) {
+			sw_shard_fwd(sh, dest_shard, qe);
+			goto end_qe;
+		}
+
 		/* Use the iq_num from above to push the QE
 		 * into the qid at the right priority
 		 */
 		qid->iq_pkt_mask |= (1 << (iq_num));
-		iq_enqueue(sw, iq, qe);
+		iq_enqueue(sh, iq, qe);
 		qid->iq_pkt_count[iq_num]++;
 		qid->stats.rx_pkts++;
 		pkts_iter++;
@@ -501,16 +554,58 @@ sw_schedule_pull_port_dir(struct sw_evdev *sw, uint32_t port_id)
 	return pkts_iter;
 }
 
+/* Pull the events the other shards have passed on to our QIDs */
+static uint32_t
+sw_schedule_pull_fwd(struct sw_shard *sh)
+{
+	struct sw_evdev *sw = sh->sw;
+	struct rte_event qes[SCHED_DEQUEUE_BURST_SIZE];
+	uint32_t i, n;
+
+	n = rte_event_ring_dequeue_burst(sh->fwd_ring, qes, RTE_DIM(qes),
+			NULL);
+	for (i = 0; i < n; i++) {
+		const struct rte_event *qe = &qes[i];
+		uint32_t iq_num = PRIO_TO_IQ(qe->priority);
+		struct sw_qid *qid = &sw->qids[qe->queue_id];
+
+		qid->iq_pkt_mask |= (1 << (iq_num));
+		iq_enqueue(sh, &qid->iq[iq_num], qe);
+		qid->iq_pkt_count[iq_num]++;
+		qid->stats.rx_pkts++;
+	}
+
+	return n;
+}
+
+static __rte_always_inline void
+sw_shard_ack_unlinks(struct sw_shard *sh, struct sw_port *p)
+{
+	const uint32_t bit = 1 << sh->id;
+
+	if (sh->sw->nb_shards == 1) {
+		p->unlinks_in_progress = 0;
+		return;
+	}
+
+	/* the unlinks are done once every shard has seen them */
+	if (!(__atomic_load_n(&p->unlink_shards, __ATOMIC_ACQUIRE) & bit))
+		return;
+	if (__atomic_and_fetch(&p->unlink_shards, ~bit, __ATOMIC_ACQ_REL) == 0)
+		p->unlinks_in_progress = 0;
+}
+
 void
-sw_event_schedule(struct rte_eventdev *dev)
+sw_event_schedule_shard(struct sw_shard *sh)
 {
-	struct sw_evdev *sw = sw_pmd_priv(dev);
+	struct sw_evdev *sw = sh->sw;
 	uint32_t in_pkts, out_pkts;
 	uint32_t out_pkts_total = 0, in_pkts_total = 0;
 	int32_t sched_quanta = sw->sched_quanta;
+	const int sharded = sw->nb_shards > 1;
 	uint32_t i;
 
-	sw->sched_called++;
+	sh->sched_called++;
 	if (unlikely(!sw->started))
 		return;
 
@@ -523,24 +618,31 @@ sw_event_schedule(struct rte_eventdev *dev)
 			for (i = 0; i < sw->port_count; i++) {
 				/* ack the unlinks in progress as done */
 				if (sw->ports[i].unlinks_in_progress)
-					sw->ports[i].unlinks_in_progress = 0;
+					sw_shard_ack_unlinks(sh, &sw->ports[i]);
 
 				if (sw->ports[i].is_directed)
-					in_pkts += sw_schedule_pull_port_dir(sw, i);
+					in_pkts += sw_schedule_pull_port_dir(sh, i);
 				else if (sw->ports[i].num_ordered_qids > 0)
-					in_pkts += sw_schedule_pull_port_lb(sw, i);
+					in_pkts += sw_schedule_pull_port_lb(sh, i);
 				else
-					in_pkts += sw_schedule_pull_port_no_reorder(sw, i);
+					in_pkts += sw_schedule_pull_port_no_reorder(sh, i);
 			}
 
 			/* QID scan for re-ordered */
-			in_pkts += sw_schedule_reorder(sw, 0,
-					sw->qid_count);
+			in_pkts += sw_schedule_reorder(sh);
+
+			/* exchange events with the other shards */
+			if (sharded) {
+				for (i = 0; i < sw->nb_shards; i++)
+					if (sh->fwd_buf_count[i])
+						sw_shard_fwd_flush(sh, i);
+				in_pkts += sw_schedule_pull_fwd(sh);
+			}
 			in_pkts_this_iteration += in_pkts;
 		} while (in_pkts > 4 &&
 				(int)in_pkts_this_iteration < sched_quanta);
 
-		out_pkts = sw_schedule_qid_to_cq(sw);
+		out_pkts = sw_schedule_qid_to_cq(sh);
 		out_pkts_total += out_pkts;
 		in_pkts_total += in_pkts_this_iteration;
 
@@ -548,21 +650,33 @@ sw_event_schedule(struct rte_eventdev *dev)
 			break;
 	} while ((int)out_pkts_total < sched_quanta);
 
-	sw->stats.tx_pkts += out_pkts_total;
-	sw->stats.rx_pkts += in_pkts_total;
+	sh->stats.tx_pkts += out_pkts_total;
+	sh->stats.rx_pkts += in_pkts_total;
 
-	sw->sched_no_iq_enqueues += (in_pkts_total == 0);
-	sw->sched_no_cq_enqueues += (out_pkts_total == 0);
+	sh->sched_no_iq_enqueues += (in_pkts_total == 0);
+	sh->sched_no_cq_enqueues += (out_pkts_total == 0);
 
 	/* push all the internal buffered QEs in port->cq_ring to the
 	 * worker cores: aka, do the ring transfers batched.
 	 */
 	for (i = 0; i < sw->port_count; i++) {
-		struct rte_event_ring *worker = sw->ports[i].cq_worker_ring;
-		rte_event_ring_enqueue_burst(worker, sw->ports[i].cq_buf,
-				sw->ports[i].cq_buf_count,
-				&sw->cq_ring_space[i]);
-		sw->ports[i].cq_buf_count = 0;
+		struct sw_port_sched *port = &sh->ports[i];
+		struct rte_event_ring *worker =
+			sw->ports[i].cq_worker_ring[sh->id];
+		rte_event_ring_enqueue_burst(worker, port->cq_buf,
+				port->cq_buf_count,
+				&sh->cq_ring_space[i]);
+		port->cq_buf_count = 0;
 	}
 
 }
+
+void
+sw_event_schedule(struct rte_eventdev *dev)
+{
+	struct sw_evdev *sw = sw_pmd_priv(dev);
+	uint32_t i;
+
+	for (i = 0; i < sw->nb_shards; i++)
+		sw_event_schedule_shard(&sw->shards[i]);
+}
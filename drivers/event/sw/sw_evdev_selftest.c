@@ -2951,6 +2951,274 @@ dev_stop_flush(struct test *t) /* test to check we can properly flush events */
 	return -1;
 }
 
+#define SHARDED_NUM_EVENTS 2048
+#define SHARDED_NUM_FLOWS 8
+
+static int
+sharded_pipeline(struct test *t)
+{
+	/* run events through an atomic, an ordered, an atomic and a directed
+	 * stage on a device with two scheduler shards, so that every stage
+	 * hands the events over to the other shard, and check each flow
+	 * comes out in order
+	 */
+	const char *eventdev_name = "event_sw_shards";
+	const int saved_evdev = evdev;
+	const uint8_t lb_qids[] = {0, 1, 2};
+	uint32_t next_seq[SHARDED_NUM_FLOWS];
+	uint32_t sent = 0, rcvd = 0, loops = 0;
+	int ret = -1;
+	int i, j;
+
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0) {
+		if (rte_vdev_init(eventdev_name, "sched_shards=2") < 0) {
+			printf("%d: Error creating eventdev\n", __LINE__);
+			evdev = saved_evdev;
+			return -1;
+		}
+		evdev = rte_event_dev_get_dev_id(eventdev_name);
+	}
+
+	if (init(t, 4, 4) < 0 ||
+			create_ports(t, 4) < 0 ||
+			create_atomic_qids(t, 1) < 0 ||
+			create_ordered_qids(t, 1) < 0 ||
+			create_atomic_qids(t, 1) < 0 ||
+			create_directed_qids(t, 1, &t->port[2]) < 0) {
+		printf("%d: Error initializing device\n", __LINE__);
+		goto out;
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (rte_event_port_link(evdev, t->port[i], lb_qids, NULL,
+				RTE_DIM(lb_qids)) != RTE_DIM(lb_qids)) {
+			printf("%d: Error linking port %d\n", __LINE__, i);
+			goto err;
+		}
+	}
+
+	if (rte_event_dev_service_id_get(evdev, &t->service_id) < 0) {
+		printf("%d: Error getting the service id\n", __LINE__);
+		goto err;
+	}
+	rte_service_runstate_set(t->service_id, 1);
+	rte_service_set_runstate_mapped_check(t->service_id, 0);
+
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto err;
+	}
+
+	for (i = 0; i < SHARDED_NUM_FLOWS; i++)
+		next_seq[i] = i;
+
+	while (rcvd < SHARDED_NUM_EVENTS) {
+		struct rte_event evs[2][DEQUEUE_DEPTH];
+		uint16_t nb_evs[2];
+
+		if (++loops > 100000) {
+			printf("%d: Events stuck, %u sent, %u received\n",
+					__LINE__, sent, rcvd);
+			goto err;
+		}
+
+		if (sent < SHARDED_NUM_EVENTS) {
+			const uint16_t n = RTE_MIN(SHARDED_NUM_EVENTS - sent,
+					16u);
+
+			for (j = 0; j < n; j++) {
+				evs[0][j] = (struct rte_event){
+					.op = RTE_EVENT_OP_NEW,
+					.queue_id = t->qid[0],
+					.flow_id = (sent + j) %
+						SHARDED_NUM_FLOWS,
+				};
+				evs[0][j].u64 = sent + j;
+			}
+			sent += rte_event_enqueue_burst(evdev, t->port[3],
+					evs[0], n);
+		}
+
+		for (i = 0; i < 4; i++)
+			rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+		/* forward to the next stage, the second worker first so the
+		 * ordered stage has something to reorder
+		 */
+		for (i = 0; i < 2; i++)
+			nb_evs[i] = rte_event_dequeue_burst(evdev, t->port[i],
+					evs[i], 32, 0);
+		for (i = 1; i >= 0; i--) {
+			for (j = 0; j < nb_evs[i]; j++) {
+				evs[i][j].op = RTE_EVENT_OP_FORWARD;
+				evs[i][j].queue_id++;
+			}
+			if (rte_event_enqueue_burst(evdev, t->port[i], evs[i],
+					nb_evs[i]) != nb_evs[i]) {
+				printf("%d: Error forwarding events\n",
+						__LINE__);
+				goto err;
+			}
+		}
+
+		nb_evs[0] = rte_event_dequeue_burst(evdev, t->port[2], evs[0],
+				32, 0);
+		for (j = 0; j < nb_evs[0]; j++) {
+			const struct rte_event *ev = &evs[0][j];
+
+			if (ev->u64 != next_seq[ev->flow_id]) {
+				printf("%d: Flow %u out of order, got %"PRIu64
+						" expected %u\n", __LINE__,
+						ev->flow_id, ev->u64,
+						next_seq[ev->flow_id]);
+				goto err;
+			}
+			next_seq[ev->flow_id] += SHARDED_NUM_FLOWS;
+		}
+		rcvd += nb_evs[0];
+	}
+
+	ret = 0;
+	goto out_cleanup;
+err:
+	rte_event_dev_dump(evdev, stdout);
+out_cleanup:
+	cleanup(t);
+out:
+	rte_vdev_uninit(eventdev_name);
+	evdev = saved_evdev;
+	return ret;
+}
+
+static int
+sharded_enqueue_retry(struct test *t)
+{
+	/* forward an event while the port's ring to its shard is full, then
+	 * retry once the ring drained: the retried forward must still
+	 * complete the event dequeued before, releasing its atomic flow
+	 */
+	const char *eventdev_name = "event_sw_shards";
+	const int saved_evdev = evdev;
+	struct rte_event ev, junk[64];
+	uint64_t pinned;
+	unsigned int sent;
+	int ret = -1;
+	int i;
+
+	evdev = rte_event_dev_get_dev_id(eventdev_name);
+	if (evdev < 0) {
+		if (rte_vdev_init(eventdev_name, "sched_shards=2") < 0) {
+			printf("%d: Error creating eventdev\n", __LINE__);
+			evdev = saved_evdev;
+			return -1;
+		}
+		evdev = rte_event_dev_get_dev_id(eventdev_name);
+	}
+
+	if (init(t, 1, 2) < 0 ||
+			create_ports(t, 2) < 0 ||
+			create_atomic_qids(t, 1) < 0) {
+		printf("%d: Error initializing device\n", __LINE__);
+		goto out;
+	}
+
+	if (rte_event_port_link(evdev, t->port[0], &t->qid[0], NULL, 1) != 1) {
+		printf("%d: Error linking port 0\n", __LINE__);
+		goto err;
+	}
+
+	if (rte_event_dev_service_id_get(evdev, &t->service_id) < 0) {
+		printf("%d: Error getting the service id\n", __LINE__);
+		goto err;
+	}
+	rte_service_runstate_set(t->service_id, 1);
+	rte_service_set_runstate_mapped_check(t->service_id, 0);
+
+	if (rte_event_dev_start(evdev) < 0) {
+		printf("%d: Error with start call\n", __LINE__);
+		goto err;
+	}
+
+	ev = (struct rte_event){
+		.op = RTE_EVENT_OP_NEW,
+		.queue_id = t->qid[0],
+		.flow_id = 1,
+	};
+	if (rte_event_enqueue_burst(evdev, t->port[1], &ev, 1) != 1) {
+		printf("%d: Error enqueuing new event\n", __LINE__);
+		goto err;
+	}
+	for (i = 0; i < 4; i++)
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+	/* fill the ring of port 0 with releases of nothing, before the
+	 * dequeue so they don't complete the event
+	 */
+	for (i = 0; i < (int)RTE_DIM(junk); i++)
+		junk[i] = (struct rte_event){ .op = RTE_EVENT_OP_RELEASE };
+	do {
+		sent = rte_event_enqueue_burst(evdev, t->port[0], junk,
+				RTE_DIM(junk));
+	} while (sent == RTE_DIM(junk));
+
+	if (rte_event_dequeue_burst(evdev, t->port[0], &ev, 1, 0) != 1) {
+		printf("%d: Error dequeuing event\n", __LINE__);
+		goto err;
+	}
+
+	ev.op = RTE_EVENT_OP_FORWARD;
+	if (rte_event_enqueue_burst(evdev, t->port[0], &ev, 1) != 0) {
+		printf("%d: Forward not refused on a full ring\n", __LINE__);
+		goto err;
+	}
+
+	for (i = 0; i < 1000 &&
+			rte_event_enqueue_burst(evdev, t->port[0], &ev, 1) == 0;
+			i++)
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+	if (i == 1000) {
+		printf("%d: Forward retry not enqueued\n", __LINE__);
+		goto err;
+	}
+
+	/* the forwarded event is the only one holding the flow */
+	for (i = 0; i < 1000 &&
+			rte_event_dequeue_burst(evdev, t->port[0], &ev, 1, 0) == 0;
+			i++)
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+	if (i == 1000) {
+		printf("%d: Error dequeuing forwarded event\n", __LINE__);
+		goto err;
+	}
+	ev.op = RTE_EVENT_OP_RELEASE;
+	if (rte_event_enqueue_burst(evdev, t->port[0], &ev, 1) != 1) {
+		printf("%d: Error releasing event\n", __LINE__);
+		goto err;
+	}
+	for (i = 0; i < 4; i++)
+		rte_service_run_iter_on_app_lcore(t->service_id, 1);
+
+	pinned = rte_event_dev_xstats_by_name_get(evdev,
+			"qid_0_port_0_pinned_flows", NULL);
+	if (pinned != 0) {
+		printf("%d: Flow still pinned after its release, %"PRIu64
+				" pinned flows\n", __LINE__, pinned);
+		goto err;
+	}
+
+	ret = 0;
+	goto out_cleanup;
+err:
+	rte_event_dev_dump(evdev, stdout);
+out_cleanup:
+	cleanup(t);
+out:
+	rte_vdev_uninit(eventdev_name);
+	evdev = saved_evdev;
+	return ret;
+}
+
 static int
 worker_loopback_worker_fn(void *arg)
 {
@@ -3367,6 +3635,18 @@ test_sw_eventdev(void)
 		printf("ERROR - Stop Flush test FAILED.\n");
 		goto test_fail;
 	}
+	printf("*** Running Sharded Pipeline test...\n");
+	ret = sharded_pipeline(t);
+	if (ret != 0) {
+		printf("ERROR - Sharded Pipeline test FAILED.\n");
+		goto test_fail;
+	}
+	printf("*** Running Sharded Enqueue Retry test...\n");
+	ret = sharded_enqueue_retry(t);
+	if (ret != 0) {
+		printf("ERROR - Sharded Enqueue Retry test FAILED.\n");
+		goto test_fail;
+	}
 	if (rte_lcore_count() >= 3) {
 		printf("*** Running Worker loopback test...\n");
 		ret = worker_loopback(t, 0);
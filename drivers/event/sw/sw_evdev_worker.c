@@ -23,8 +23,14 @@ sw_event_release(struct sw_port *p, uint8_t index)
 	struct rte_event ev;
 	ev.op = sw_qe_flag_map[RTE_EVENT_OP_RELEASE];
 
+	/* the release goes to the shard the event was scheduled by */
+	uint32_t shard = 0;
+	if (p->rel_shard != NULL)
+		shard = p->rel_shard[p->rel_shard_tail++ & p->rel_shard_mask];
+
 	uint16_t free_count;
-	rte_event_ring_enqueue_burst(p->rx_worker_ring, &ev, 1, &free_count);
+	rte_event_ring_enqueue_burst(p->rx_worker_ring[shard], &ev, 1,
+			&free_count);
 
 	/* each release returns one credit */
 	p->outstanding_releases--;
@@ -49,11 +55,95 @@ enqueue_burst_with_ops(struct rte_event_ring *r, const struct rte_event *events,
 	return rte_event_ring_enqueue_burst(r, tmp_evs, n, NULL);
 }
 
+/*
+ * Pick the scheduler shard an event enqueued on a port has to go to, when
+ * the device has several: completions go back to the shard the event was
+ * dequeued from, so it can release the flow and reorder the event, while
+ * new events go straight to the shard owning the destination QID.
+ */
+static __rte_always_inline uint8_t
+sw_event_shard(const struct sw_evdev *sw, struct sw_port *p,
+		const struct rte_event *ev, uint8_t *op, int outstanding)
+{
+	if ((*op & QE_FLAG_COMPLETE) && outstanding)
+		return p->rel_shard[p->rel_shard_tail++ & p->rel_shard_mask];
+
+	/* nothing to complete, don't let a shard release another event */
+	*op &= ~QE_FLAG_COMPLETE;
+	if (*op & QE_FLAG_VALID)
+		return sw->qid_shard[ev->queue_id];
+	return 0;
+}
+
+/* enqueue runs of events going to the same shard on that shard's ring */
+static inline unsigned int
+enqueue_burst_sharded(struct sw_port *p, const struct rte_event *events,
+		unsigned int n, uint8_t *ops, const uint8_t *shards)
+{
+	unsigned int start = 0;
+
+	while (start < n) {
+		unsigned int end = start + 1;
+		unsigned int enq;
+
+		while (end < n && shards[end] == shards[start])
+			end++;
+
+		enq = enqueue_burst_with_ops(p->rx_worker_ring[shards[start]],
+				&events[start], end - start, &ops[start]);
+		start += enq;
+		if (start != end)
+			break;
+	}
+
+	return start;
+}
+
+/* dequeue from the shard rings in turn, remembering where each event came
+ * from so its completion can be routed back
+ */
+static inline uint16_t
+dequeue_burst_sharded(struct sw_port *p, struct rte_event *ev, uint16_t num)
+{
+	const uint32_t nb_shards = p->sw->nb_shards;
+	const uint16_t depth =
+		rte_event_ring_get_capacity(p->cq_worker_ring[0]);
+	uint32_t shard = p->deq_shard;
+	uint16_t ndeq = 0;
+	uint32_t i;
+
+	/* bursts are bounded by the dequeue depth, as with a single ring */
+	if (num > depth)
+		num = depth;
+
+	for (i = 0; i < nb_shards && ndeq < num; i++) {
+		uint16_t n, j;
+
+		n = rte_event_ring_dequeue_burst(p->cq_worker_ring[shard],
+				&ev[ndeq], num - ndeq, NULL);
+		for (j = 0; j < n; j++)
+			p->rel_shard[p->rel_shard_head++ &
+					p->rel_shard_mask] = shard;
+		ndeq += n;
+
+		if (++shard == nb_shards)
+			shard = 0;
+	}
+
+	/* start from the next shard on the next call */
+	if (++p->deq_shard == nb_shards)
+		p->deq_shard = 0;
+
+	return ndeq;
+}
+
 uint16_t
 sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 {
 	int32_t i;
 	uint8_t new_ops[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint8_t shards[PORT_ENQUEUE_MAX_BURST_SIZE];
+	uint8_t completes[PORT_ENQUEUE_MAX_BURST_SIZE];
 	struct sw_port *p = port;
 	struct sw_evdev *sw = (void *)p->sw;
 	uint32_t sw_inflights = rte_atomic32_read(&sw->inflights);
@@ -95,12 +185,15 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 		new_ops[i] = sw_qe_flag_map[op];
 		new_ops[i] &= ~(invalid_qid << QE_FLAG_VALID_SHIFT);
 
+		shards[i] = p->rel_shard == NULL ? 0 :
+			sw_event_shard(sw, p, &ev[i], &new_ops[i], outstanding);
+
 		/* FWD and RELEASE packets will both resolve to taken (assuming
 		 * correct usage of the API), providing very high correct
 		 * prediction rate.
 		 */
-		if ((new_ops[i] & QE_FLAG_COMPLETE) && outstanding)
-			p->outstanding_releases--;
+		completes[i] = (new_ops[i] & QE_FLAG_COMPLETE) && outstanding;
+		p->outstanding_releases -= completes[i];
 
 		/* error case: branch to avoid touching p->stats */
 		if (unlikely(invalid_qid && op != RTE_EVENT_OP_RELEASE)) {
@@ -110,8 +203,33 @@ sw_event_enqueue_burst(void *port, const struct rte_event ev[], uint16_t num)
 	}
 
 	/* returns number of events actually enqueued */
-	uint32_t enq = enqueue_burst_with_ops(p->rx_worker_ring, ev, i,
+	uint32_t enq;
+	if (p->rel_shard == NULL)
+		enq = enqueue_burst_with_ops(p->rx_worker_ring[0], ev, i,
 					     new_ops);
+	else
+		enq = enqueue_burst_sharded(p, ev, i, new_ops, shards);
+
+	/* a full ring left events behind: give back what they took, so
+	 * that their retry still completes the events dequeued before
+	 */
+	while (unlikely(i > (int32_t)enq)) {
+		int op = ev[--i].op;
+
+		if (completes[i]) {
+			p->outstanding_releases++;
+			if (p->rel_shard != NULL)
+				p->rel_shard_tail--;
+		}
+		p->inflight_credits += (op == RTE_EVENT_OP_NEW);
+		p->inflight_credits -= (op == RTE_EVENT_OP_RELEASE) *
+					completes[i];
+		if (unlikely(ev[i].queue_id >= sw->qid_count &&
+				op != RTE_EVENT_OP_RELEASE)) {
+			p->stats.rx_dropped--;
+			p->inflight_credits--;
+		}
+	}
 	if (p->outstanding_releases == 0 && p->last_dequeue_burst_sz != 0) {
 		uint64_t burst_ticks = rte_get_timer_cycles() -
 				p->last_dequeue_ticks;
@@ -143,7 +261,6 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 {
 	RTE_SET_USED(wait);
 	struct sw_port *p = (void *)port;
-	struct rte_event_ring *ring = p->cq_worker_ring;
 
 	/* check that all previous dequeues have been released */
 	if (p->implicit_release) {
@@ -162,7 +279,12 @@ sw_event_dequeue_burst(void *port, struct rte_event *ev, uint16_t num,
 	}
 
 	/* returns number of events actually dequeued */
-	uint16_t ndeq = rte_event_ring_dequeue_burst(ring, ev, num, NULL);
+	uint16_t ndeq;
+	if (p->rel_shard == NULL)
+		ndeq = rte_event_ring_dequeue_burst(p->cq_worker_ring[0], ev,
+				num, NULL);
+	else
+		ndeq = dequeue_burst_sharded(p, ev, num);
 	if (unlikely(ndeq == 0)) {
 		p->zero_polls++;
 		p->total_polls++;
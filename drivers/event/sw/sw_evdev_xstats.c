@@ -50,15 +50,59 @@ static uint64_t
 get_dev_stat(const struct sw_evdev *sw, uint16_t obj_idx __rte_unused,
 		enum xstats_type type, int extra_arg __rte_unused)
 {
-	switch (type) {
-	case rx: return sw->stats.rx_pkts;
-	case tx: return sw->stats.tx_pkts;
-	case dropped: return sw->stats.rx_dropped;
-	case calls: return sw->sched_called;
-	case no_iq_enq: return sw->sched_no_iq_enqueues;
-	case no_cq_enq: return sw->sched_no_cq_enqueues;
-	default: return -1;
+	uint64_t val = 0;
+	uint32_t i;
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		const struct sw_shard *sh = &sw->shards[i];
+
+		switch (type) {
+		case rx: val += sh->stats.rx_pkts; break;
+		case tx: val += sh->stats.tx_pkts; break;
+		case dropped: val += sh->stats.rx_dropped; break;
+		case calls: val += sh->sched_called; break;
+		case no_iq_enq: val += sh->sched_no_iq_enqueues; break;
+		case no_cq_enq: val += sh->sched_no_cq_enqueues; break;
+		default: return -1;
+		}
+	}
+
+	return val;
+}
+
+/* port stats kept by the scheduler, summed over the shards */
+static uint64_t
+get_port_sched_stat(const struct sw_evdev *sw, uint16_t obj_idx,
+		enum xstats_type type)
+{
+	const struct sw_port *p = &sw->ports[obj_idx];
+	uint64_t val = 0;
+	uint32_t i;
+
+	for (i = 0; i < sw->nb_shards; i++) {
+		const struct sw_port_sched *ps = &sw->shards[i].ports[obj_idx];
+
+		switch (type) {
+		case rx: val += ps->stats.rx_pkts; break;
+		case tx: val += ps->stats.tx_pkts; break;
+		case inflight: val += ps->inflights; break;
+		case rx_used:
+			val += rte_event_ring_count(p->rx_worker_ring[i]);
+			break;
+		case rx_free:
+			val += rte_event_ring_free_count(p->rx_worker_ring[i]);
+			break;
+		case tx_used:
+			val += rte_event_ring_count(p->cq_worker_ring[i]);
+			break;
+		case tx_free:
+			val += rte_event_ring_free_count(p->cq_worker_ring[i]);
+			break;
+		default: return -1;
+		}
 	}
+
+	return val;
 }
 
 static uint64_t
@@ -68,18 +112,19 @@ get_port_stat(const struct sw_evdev *sw, uint16_t obj_idx,
 	const struct sw_port *p = &sw->ports[obj_idx];
 
 	switch (type) {
-	case rx: return p->stats.rx_pkts;
-	case tx: return p->stats.tx_pkts;
+	case rx:
+	case tx:
+	case inflight:
+	case rx_used:
+	case rx_free:
+	case tx_used:
+	case tx_free:
+		return get_port_sched_stat(sw, obj_idx, type);
 	case dropped: return p->stats.rx_dropped;
-	case inflight: return p->inflights;
 	case pkt_cycles: return p->avg_pkt_ticks;
 	case calls: return p->total_polls;
 	case credits: return p->inflight_credits;
 	case poll_return: return p->zero_polls;
-	case rx_used: return rte_event_ring_count(p->rx_worker_ring);
-	case rx_free: return rte_event_ring_free_count(p->rx_worker_ring);
-	case tx_used: return rte_event_ring_count(p->cq_worker_ring);
-	case tx_free: return rte_event_ring_free_count(p->cq_worker_ring);
 	default: return -1;
 	}
 }
@@ -289,7 +334,7 @@ sw_xstats_init(struct sw_evdev *sw)
 		}
 
 		for (bkt = 0; bkt < (rte_event_ring_get_capacity(
-				sw->ports[port].cq_worker_ring) >>
+				sw->ports[port].cq_worker_ring[0]) >>
 					SW_DEQ_STAT_BUCKET_SHIFT) + 1; bkt++) {
 			for (i = 0; i < RTE_DIM(port_bucket_stats); i++) {
 				sw->xstats[stat] = (struct sw_xstats_entry){
@@ -253,74 +253,6 @@ tun_alloc(struct pmd_internals *pmd, int is_keepalive)
 	return -1;
 }
 
-static void
-tap_verify_csum(struct rte_mbuf *mbuf)
-{
-	uint32_t l2 = mbuf->packet_type & RTE_PTYPE_L2_MASK;
-	uint32_t l3 = mbuf->packet_type & RTE_PTYPE_L3_MASK;
-	uint32_t l4 = mbuf->packet_type & RTE_PTYPE_L4_MASK;
-	unsigned int l2_len = sizeof(struct rte_ether_hdr);
-	unsigned int l3_len;
-	uint16_t cksum = 0;
-	void *l3_hdr;
-	void *l4_hdr;
-
-	if (l2 == RTE_PTYPE_L2_ETHER_VLAN)
-		l2_len += 4;
-	else if (l2 == RTE_PTYPE_L2_ETHER_QINQ)
-		l2_len += 8;
-	/* Don't verify checksum for packets with discontinuous L2 header */
-	if (unlikely(l2_len + sizeof(struct rte_ipv4_hdr) >
-		     rte_pktmbuf_data_len(mbuf)))
-		return;
-	l3_hdr = rte_pktmbuf_mtod_offset(mbuf, void *, l2_len);
-	if (l3 == RTE_PTYPE_L3_IPV4 || l3 == RTE_PTYPE_L3_IPV4_EXT) {
-		struct rte_ipv4_hdr *iph = l3_hdr;
-
-		/* ihl contains the number of 4-byte words in the header */
-		l3_len = 4 * (iph->version_ihl & 0xf);
-		if (unlikely(l2_len + l3_len > rte_pktmbuf_data_len(mbuf)))
-			return;
-		/* check that the total length reported by header is not
-		 * greater than the total received size
-		 */
-		if (l2_len + rte_be_to_cpu_16(iph->total_length) >
-				rte_pktmbuf_data_len(mbuf))
-			return;
-
-		cksum = ~rte_raw_cksum(iph, l3_len);
-		mbuf->ol_flags |= cksum ?
-			PKT_RX_IP_CKSUM_BAD :
-			PKT_RX_IP_CKSUM_GOOD;
-	} else if (l3 == RTE_PTYPE_L3_IPV6) {
-		struct rte_ipv6_hdr *iph = l3_hdr;
-
-		l3_len = sizeof(struct rte_ipv6_hdr);
-		/* check that the total length reported by header is not
-		 * greater than the total received size
-		 */
-		if (l2_len + l3_len + rte_be_to_cpu_16(iph->payload_len) >
-				rte_pktmbuf_data_len(mbuf))
-			return;
-	} else {
-		/* IPv6 extensions are not supported */
-		return;
-	}
-	if (l4 == RTE_PTYPE_L4_UDP || l4 == RTE_PTYPE_L4_TCP) {
-		l4_hdr = rte_pktmbuf_mtod_offset(mbuf, void *, l2_len + l3_len);
-		/* Don't verify checksum for multi-segment packets. */
-		if (mbuf->nb_segs > 1)
-			return;
-		if (l3 == RTE_PTYPE_L3_IPV4)
-			cksum = ~rte_ipv4_udptcp_cksum(l3_hdr, l4_hdr);
-		else if (l3 == RTE_PTYPE_L3_IPV6)
-			cksum = ~rte_ipv6_udptcp_cksum(l3_hdr, l4_hdr);
-		mbuf->ol_flags |= cksum ?
-			PKT_RX_L4_CKSUM_BAD :
-			PKT_RX_L4_CKSUM_GOOD;
-	}
-}
-
 static uint64_t
 tap_rx_offload_get_port_capa(void)
 {
@@ -359,6 +291,7 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 		struct rte_mbuf *mbuf = rxq->pool;
 		struct rte_mbuf *seg = NULL;
 		struct rte_mbuf *new_tail = NULL;
+		struct rte_net_hdr_lens hdr_lens = { 0 };
 		uint16_t data_off = rte_pktmbuf_headroom(mbuf);
 		int len;
 
@@ -418,16 +351,19 @@ pmd_rx_burst(void *queue, struct rte_mbuf **bufs, uint16_t nb_pkts)
 			data_off = 0;
 		}
 		seg->next = NULL;
-		mbuf->packet_type = rte_net_get_ptype(mbuf, NULL,
+		mbuf->packet_type = rte_net_get_ptype(mbuf, &hdr_lens,
 						      RTE_PTYPE_ALL_MASK);
-		if (rxq->rxmode->offloads & DEV_RX_OFFLOAD_CHECKSUM)
-			tap_verify_csum(mbuf);
+		mbuf->l2_len = hdr_lens.l2_len;
+		mbuf->l3_len = hdr_lens.l3_len;
 
 		/* account for the receive frame */
 		bufs[num_rx++] = mbuf;
 		num_rx_bytes += mbuf->pkt_len;
 	}
 end:
+	if (rxq->rxmode->offloads & DEV_RX_OFFLOAD_CHECKSUM)
+		rte_net_cksum_verify_burst(bufs, num_rx);
+
 	rxq->stats.ipackets += num_rx;
 	rxq->stats.ibytes += num_rx_bytes;
 
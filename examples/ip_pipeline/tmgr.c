@@ -104,6 +104,8 @@ tmgr_port_create(const char *name, struct tmgr_port_params *params)
 	p.frame_overhead = params->frame_overhead;
 	p.n_subports_per_port = params->n_subports_per_port;
 	p.n_pipes_per_subport = TMGR_PIPE_SUBPORT_MAX;
+	p.n_queues_per_pipe = RTE_SCHED_QUEUES_PER_PIPE;
+	p.n_be_queues_per_pipe = RTE_SCHED_BE_QUEUES_PER_PIPE;
 
 	s = rte_sched_port_config(&p);
 	if (s == NULL)
@@ -7,6 +7,7 @@
 
 #include <rte_eal.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_errno.h>
 #include <rte_ethdev.h>
 #include <rte_lcore.h>
@@ -21,6 +22,7 @@
 
 #define MAX_PKTS_BURST 32
 #define REORDER_BUFFER_SIZE 8192
+#define REORDER_MP_TIMEOUT_US 100
 #define MBUF_PER_POOL 65535
 #define MBUF_POOL_CACHE_SIZE 250
 
@@ -31,6 +33,7 @@
 
 unsigned int portmask;
 unsigned int disable_reorder;
+unsigned int mp_reorder;
 unsigned int insight_worker;
 volatile uint8_t quit_signal;
 
@@ -41,11 +44,13 @@ static struct rte_eth_conf port_conf_default;
 struct worker_thread_args {
 	struct rte_ring *ring_in;
 	struct rte_ring *ring_out;
+	struct rte_reorder_mp_buffer *mp_buffer;
 };
 
 struct send_thread_args {
 	struct rte_ring *ring_in;
 	struct rte_reorder_buffer *buffer;
+	struct rte_reorder_mp_buffer *mp_buffer;
 };
 
 volatile struct app_stats {
@@ -129,8 +134,11 @@ pktmbuf_free_bulk(struct rte_mbuf *mbuf_table[], unsigned n)
 static void
 print_usage(const char *prgname)
 {
-	printf("%s [EAL options] -- -p PORTMASK\n"
-			"  -p PORTMASK: hexadecimal bitmask of ports to configure\n",
+	printf("%s [EAL options] -- -p PORTMASK [--disable-reorder]"
+			" [--insight-worker] [--mp-reorder]\n"
+			"  -p PORTMASK: hexadecimal bitmask of ports to configure\n"
+			"  --mp-reorder: workers insert packets in a"
+			" multi-producer reorder buffer\n",
 			prgname);
 }
 
@@ -162,6 +170,7 @@ parse_args(int argc, char **argv)
 	static struct option lgopts[] = {
 		{"disable-reorder", 0, 0, 0},
 		{"insight-worker", 0, 0, 0},
+		{"mp-reorder", 0, 0, 0},
 		{NULL, 0, 0, 0}
 	};
 
@@ -190,6 +199,10 @@ parse_args(int argc, char **argv)
 				printf("print all worker statistics\n");
 				insight_worker = 1;
 			}
+			if (!strcmp(lgopts[option_index].name, "mp-reorder")) {
+				printf("multi-producer reorder enabled\n");
+				mp_reorder = 1;
+			}
 			break;
 		default:
 			print_usage(prgname);
@@ -471,6 +484,32 @@ rx_thread(struct rte_ring *ring_out)
 	return 0;
 }
 
+/**
+ * Insert the mbufs processed by a worker in the multi-producer reorder
+ * buffer, waiting for the early ones to fit in the window.
+ */
+static void
+mp_reorder_insert(struct rte_reorder_mp_buffer *buffer,
+		struct rte_mbuf **mbufs, uint16_t nb_mbufs, unsigned int core_id)
+{
+	uint16_t i, ret;
+
+	for (i = 0; i < nb_mbufs; i += ret) {
+		ret = rte_reorder_mp_insert_burst(buffer, &mbufs[i],
+				nb_mbufs - i);
+		wkr_stats[core_id].enq_pkts += ret;
+		if (i + ret == nb_mbufs)
+			break;
+
+		if (rte_errno == ERANGE || quit_signal) {
+			/* Late pkts, whose seqn was skipped, are dropped */
+			wkr_stats[core_id].enq_failed_pkts++;
+			rte_pktmbuf_free(mbufs[i + ret]);
+			ret++;
+		}
+	}
+}
+
 /**
  * This thread takes bursts of packets from the rx_to_workers ring and
  * Changes the input port value to output port value. And feds it to
@@ -509,6 +548,12 @@ worker_thread(void *args_ptr)
 		for (i = 0; i < burst_size;)
 			burst_buffer[i++]->port ^= xor_val;
 
+		if (args->mp_buffer != NULL) {
+			mp_reorder_insert(args->mp_buffer, burst_buffer,
+					burst_size, core_id);
+			continue;
+		}
+
 		/* enqueue the modified mbufs to workers_to_tx ring */
 		ret = rte_ring_enqueue_burst(ring_out, (void *)burst_buffer,
 				burst_size, NULL);
@@ -544,6 +589,14 @@ send_thread(struct send_thread_args *args)
 
 	while (!quit_signal) {
 
+		if (args->mp_buffer != NULL) {
+			/* the workers insert the mbufs themselves */
+			dret = rte_reorder_mp_drain(args->mp_buffer, rombufs,
+					MAX_PKTS_BURST);
+			app_stats.tx.dequeue_pkts += dret;
+			goto transmit;
+		}
+
 		/* deque the mbufs from workers_to_tx ring */
 		nb_dq_mbufs = rte_ring_dequeue_burst(args->ring_in,
 				(void *)mbufs, MAX_PKTS_BURST, NULL);
@@ -585,6 +638,7 @@ send_thread(struct send_thread_args *args)
 		 * mbufs for transmit
 		 */
 		dret = rte_reorder_drain(args->buffer, rombufs, MAX_PKTS_BURST);
+transmit:
 		for (i = 0; i < dret; i++) {
 
 			struct rte_eth_dev_tx_buffer *outbuf;
@@ -664,8 +718,8 @@ main(int argc, char **argv)
 	unsigned int lcore_id, last_lcore_id, master_lcore_id;
 	uint16_t port_id;
 	uint16_t nb_ports_available;
-	struct worker_thread_args worker_args = {NULL, NULL};
-	struct send_thread_args send_args = {NULL, NULL};
+	struct worker_thread_args worker_args = {NULL, NULL, NULL};
+	struct send_thread_args send_args = {NULL, NULL, NULL};
 	struct rte_ring *rx_to_workers;
 	struct rte_ring *workers_to_tx;
 
@@ -740,7 +794,14 @@ main(int argc, char **argv)
 	if (workers_to_tx == NULL)
 		rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
 
-	if (!disable_reorder) {
+	if (!disable_reorder && mp_reorder) {
+		send_args.mp_buffer = rte_reorder_mp_create("PKT_RO",
+				rte_socket_id(), REORDER_BUFFER_SIZE,
+				rte_get_timer_hz() * REORDER_MP_TIMEOUT_US / US_PER_S);
+		if (send_args.mp_buffer == NULL)
+			rte_exit(EXIT_FAILURE, "%s\n", rte_strerror(rte_errno));
+		worker_args.mp_buffer = send_args.mp_buffer;
+	} else if (!disable_reorder) {
 		send_args.buffer = rte_reorder_create("PKT_RO", rte_socket_id(),
 				REORDER_BUFFER_SIZE);
 		if (send_args.buffer == NULL)
@@ -140,29 +140,48 @@ app_set_pkt_color(uint8_t *pkt_data, enum policer_action color)
 	pkt_data[APP_PKT_COLOR_POS] = (uint8_t)color;
 }
 
-static inline int
-app_pkt_handle(struct rte_mbuf *pkt, uint64_t time)
+static inline void
+app_pkt_burst_handle(struct rte_mbuf **pkts, uint32_t n_pkts, uint64_t time)
 {
-	uint8_t input_color, output_color;
-	uint8_t *pkt_data = rte_pktmbuf_mtod(pkt, uint8_t *);
-	uint32_t pkt_len = rte_pktmbuf_pkt_len(pkt) -
-		sizeof(struct rte_ether_hdr);
-	uint8_t flow_id = (uint8_t)(pkt_data[APP_PKT_FLOW_POS] & (APP_FLOWS_MAX - 1));
-	input_color = pkt_data[APP_PKT_COLOR_POS];
-	enum policer_action action;
+	FLOW_METER *flows[PKT_RX_BURST_MAX];
+	FLOW_PROFILE *profiles[PKT_RX_BURST_MAX];
+	uint64_t times[PKT_RX_BURST_MAX];
+	uint32_t pkt_lens[PKT_RX_BURST_MAX];
+	uint8_t input_colors[PKT_RX_BURST_MAX];
+	enum rte_color colors[PKT_RX_BURST_MAX];
+	uint32_t i;
+
+	for (i = 0; i < n_pkts; i++) {
+		uint8_t *pkt_data = rte_pktmbuf_mtod(pkts[i], uint8_t *);
+		uint8_t flow_id = (uint8_t)(pkt_data[APP_PKT_FLOW_POS] &
+			(APP_FLOWS_MAX - 1));
+
+		flows[i] = &app_flows[flow_id];
+		profiles[i] = &PROFILE;
+		times[i] = time;
+		pkt_lens[i] = rte_pktmbuf_pkt_len(pkts[i]) -
+			sizeof(struct rte_ether_hdr);
+		input_colors[i] = pkt_data[APP_PKT_COLOR_POS];
+		colors[i] = (enum rte_color)input_colors[i];
+	}
 
 	/* color input is not used for blind modes */
-	output_color = (uint8_t) FUNC_METER(&app_flows[flow_id],
-		&PROFILE,
-		time,
-		pkt_len,
-		(enum rte_color) input_color);
+	FUNC_METER_BULK(flows, profiles, times, pkt_lens, colors, n_pkts);
 
-	/* Apply policing and set the output color */
-	action = policer_table[input_color][output_color];
-	app_set_pkt_color(pkt_data, action);
+	for (i = 0; i < n_pkts; i++) {
+		struct rte_mbuf *pkt = pkts[i];
+		uint8_t *pkt_data = rte_pktmbuf_mtod(pkt, uint8_t *);
+		enum policer_action action;
 
-	return action;
+		/* Apply policing and set the output color */
+		action = policer_table[input_colors[i]][colors[i]];
+		app_set_pkt_color(pkt_data, action);
+
+		if (action == DROP)
+			rte_pktmbuf_free(pkt);
+		else
+			rte_eth_tx_buffer(port_tx, NIC_TX_QUEUE, tx_buffer, pkt);
+	}
 }
 
 
@@ -176,7 +195,7 @@ main_loop(__attribute__((unused)) void *dummy)
 
 	while (1) {
 		uint64_t time_diff;
-		int i, nb_rx;
+		int nb_rx;
 
 		/* Mechanism to avoid stale packets in the output buffer */
 		current_time = rte_rdtsc();
@@ -191,15 +210,7 @@ main_loop(__attribute__((unused)) void *dummy)
 		nb_rx = rte_eth_rx_burst(port_rx, NIC_RX_QUEUE, pkts_rx, PKT_RX_BURST_MAX);
 
 		/* Handle packets */
-		for (i = 0; i < nb_rx; i ++) {
-			struct rte_mbuf *pkt = pkts_rx[i];
-
-			/* Handle current packet */
-			if (app_pkt_handle(pkt, current_time) == DROP)
-				rte_pktmbuf_free(pkt);
-			else
-				rte_eth_tx_buffer(port_tx, NIC_TX_QUEUE, tx_buffer, pkt);
-		}
+		app_pkt_burst_handle(pkts_rx, nb_rx, current_time);
 	}
 }
 
@@ -21,48 +21,50 @@ enum policer_action policer_table[RTE_COLORS][RTE_COLORS] =
 
 #if APP_MODE == APP_MODE_FWD
 
-#define FUNC_METER(m, p, time, pkt_len, pkt_color)	\
-({							\
-	void *mp = m;					\
-	void *pp = p;					\
-	mp = mp;					\
-	pp = pp;					\
-	time = time;					\
-	pkt_len = pkt_len;				\
-	pkt_color;					\
-})
+#define FUNC_METER_BULK(m, p, time, pkt_len, pkt_color, n_pkts)	\
+do {								\
+	RTE_SET_USED(m);					\
+	RTE_SET_USED(p);					\
+	RTE_SET_USED(time);					\
+	RTE_SET_USED(pkt_len);					\
+	RTE_SET_USED(pkt_color);				\
+	RTE_SET_USED(n_pkts);					\
+} while (0)
 #define FUNC_CONFIG(a, b) 0
 #define FLOW_METER int
+#define FLOW_PROFILE struct rte_meter_srtcm_profile
 #define PROFILE	app_srtcm_profile
 
 #elif APP_MODE == APP_MODE_SRTCM_COLOR_BLIND
 
-#define FUNC_METER(m, p, time, pkt_len, pkt_color)	\
-	rte_meter_srtcm_color_blind_check(m, p, time, pkt_len)
+#define FUNC_METER_BULK rte_meter_srtcm_color_blind_check_bulk
 #define FUNC_CONFIG   rte_meter_srtcm_config
 #define FLOW_METER    struct rte_meter_srtcm
+#define FLOW_PROFILE  struct rte_meter_srtcm_profile
 #define PROFILE       app_srtcm_profile
 
 #elif (APP_MODE == APP_MODE_SRTCM_COLOR_AWARE)
 
-#define FUNC_METER    rte_meter_srtcm_color_aware_check
+#define FUNC_METER_BULK rte_meter_srtcm_color_aware_check_bulk
 #define FUNC_CONFIG   rte_meter_srtcm_config
 #define FLOW_METER    struct rte_meter_srtcm
+#define FLOW_PROFILE  struct rte_meter_srtcm_profile
 #define PROFILE       app_srtcm_profile
 
 #elif (APP_MODE == APP_MODE_TRTCM_COLOR_BLIND)
 
-#define FUNC_METER(m, p, time, pkt_len, pkt_color)	\
-	rte_meter_trtcm_color_blind_check(m, p, time, pkt_len)
+#define FUNC_METER_BULK rte_meter_trtcm_color_blind_check_bulk
 #define FUNC_CONFIG  rte_meter_trtcm_config
 #define FLOW_METER   struct rte_meter_trtcm
+#define FLOW_PROFILE struct rte_meter_trtcm_profile
 #define PROFILE      app_trtcm_profile
 
 #elif (APP_MODE == APP_MODE_TRTCM_COLOR_AWARE)
 
-#define FUNC_METER rte_meter_trtcm_color_aware_check
+#define FUNC_METER_BULK rte_meter_trtcm_color_aware_check_bulk
 #define FUNC_CONFIG  rte_meter_trtcm_config
 #define FLOW_METER   struct rte_meter_trtcm
+#define FLOW_PROFILE struct rte_meter_trtcm_profile
 #define PROFILE      app_trtcm_profile
 
 #else
@@ -58,11 +58,29 @@ get_pkt_sched(struct rte_mbuf *m, uint32_t *subport, uint32_t *pipe,
 	return 0;
 }
 
+static inline void
+app_rx_ring_enqueue(struct thread_conf *conf, struct rte_ring *ring,
+		struct rte_mbuf **mbufs, uint32_t n)
+{
+	uint32_t i;
+
+	if (unlikely(rte_ring_sp_enqueue_bulk(ring,
+			(void **)mbufs, n, NULL) == 0)) {
+		for(i = 0; i < n; i++) {
+			rte_pktmbuf_free(mbufs[i]);
+
+			APP_STATS_ADD(conf->stat.nb_drop, 1);
+		}
+	}
+}
+
 void
 app_rx_thread(struct thread_conf **confs)
 {
 	uint32_t i, nb_rx;
 	struct rte_mbuf *rx_mbufs[burst_conf.rx_burst] __rte_cache_aligned;
+	struct rte_mbuf *wt_mbufs[MAX_WT_LCORES][burst_conf.rx_burst];
+	uint32_t nb_wt[MAX_WT_LCORES];
 	struct thread_conf *conf;
 	int conf_idx = 0;
 
@@ -79,6 +97,8 @@ app_rx_thread(struct thread_conf **confs)
 		if (likely(nb_rx != 0)) {
 			APP_STATS_ADD(conf->stat.nb_rx, nb_rx);
 
+			memset(nb_wt, 0, sizeof(nb_wt));
+
 			for(i = 0; i < nb_rx; i++) {
 				get_pkt_sched(rx_mbufs[i],
 						&subport, &pipe, &traffic_class, &queue, &color);
@@ -87,16 +107,24 @@ app_rx_thread(struct thread_conf **confs)
 						subport, pipe,
 						traffic_class, queue,
 						(enum rte_color) color);
-			}
 
-			if (unlikely(rte_ring_sp_enqueue_bulk(conf->rx_ring,
-					(void **)rx_mbufs, nb_rx, NULL) == 0)) {
-				for(i = 0; i < nb_rx; i++) {
-					rte_pktmbuf_free(rx_mbufs[i]);
+				/* Send each packet to the worker of its subport */
+				if (conf->n_wt > 1) {
+					uint32_t wt = conf->subport_wt[subport];
 
-					APP_STATS_ADD(conf->stat.nb_drop, 1);
+					wt_mbufs[wt][nb_wt[wt]++] = rx_mbufs[i];
 				}
 			}
+
+			if (conf->n_wt == 1)
+				app_rx_ring_enqueue(conf, conf->rx_ring, rx_mbufs,
+						nb_rx);
+			else
+				for (i = 0; i < conf->n_wt; i++)
+					if (nb_wt[i])
+						app_rx_ring_enqueue(conf,
+							conf->wt_rings[i],
+							wt_mbufs[i], nb_wt[i]);
 		}
 		conf_idx++;
 		if (confs[conf_idx] == NULL)
@@ -213,7 +241,7 @@ app_worker_thread(struct thread_conf **confs)
 		nb_pkt = rte_sched_port_dequeue(conf->sched_port, mbufs,
 					burst_conf.qos_dequeue);
 		if (likely(nb_pkt > 0))
-			while (rte_ring_sp_enqueue_bulk(conf->tx_ring,
+			while (rte_ring_enqueue_bulk(conf->tx_ring,
 					(void **)mbufs, nb_pkt, NULL) == 0)
 				; /* empty body */
 
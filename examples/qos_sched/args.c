@@ -39,6 +39,9 @@ static const char usage[] =
 	"           multiple pfc can be configured in command line                      \n"
 	"                                                                               \n"
 	"Application optional parameters:                                               \n"
+	"    --wt \"WT LCORE, ...\" : Additional worker lcores for the previous pfc,     \n"
+	"           which then requires a TX LCORE. The subports of the port are split \n"
+	"           between the worker lcores, each one scheduling its own subports    \n"
         "    --i     : run in interactive mode (default value is %u)                    \n"
 	"    --mst I : master core index (default value is %u)                          \n"
 	"    --rsz \"A, B, C\" :   Ring sizes                                           \n"
@@ -231,6 +234,9 @@ app_parse_flow_conf(const char *conf_str)
 	else
 		pconf->tx_core = pconf->wt_core;
 
+	pconf->n_wt_cores = 1;
+	pconf->wt_cores[0] = pconf->wt_core;
+
 	if (pconf->rx_core == pconf->wt_core) {
 		RTE_LOG(ERR, APP, "pfc %u: rx thread and worker thread cannot share same core\n", nb_pfc);
 		return -1;
@@ -279,6 +285,49 @@ app_parse_flow_conf(const char *conf_str)
 	return 0;
 }
 
+static int
+app_parse_wt_conf(const char *conf_str)
+{
+	int ret, i;
+	uint32_t vals[MAX_OPT_VALUES];
+	struct flow_conf *pconf;
+
+	if (nb_pfc == 0) {
+		RTE_LOG(ERR, APP, "worker lcores must follow a pfc\n");
+		return -1;
+	}
+
+	pconf = &qos_conf[nb_pfc - 1];
+
+	ret = app_parse_opt_vals(conf_str, ',', MAX_OPT_VALUES, vals);
+	if (ret <= 0)
+		return -1;
+
+	if (pconf->tx_core == pconf->wt_core) {
+		RTE_LOG(ERR, APP, "pfc %u: several worker lcores require a tx lcore\n",
+				nb_pfc - 1);
+		return -1;
+	}
+
+	if (pconf->n_wt_cores + ret > MAX_WT_LCORES) {
+		RTE_LOG(ERR, APP, "pfc %u: too many worker lcores\n", nb_pfc - 1);
+		return -1;
+	}
+
+	for (i = 0; i < ret; i++) {
+		if ((vals[i] == pconf->rx_core) || (vals[i] == pconf->tx_core)) {
+			RTE_LOG(ERR, APP, "pfc %u: worker lcore %u cannot be used for rx or tx\n",
+					nb_pfc - 1, vals[i]);
+			return -1;
+		}
+
+		pconf->wt_cores[pconf->n_wt_cores++] = vals[i];
+		app_used_core_mask |= 1lu << vals[i];
+	}
+
+	return 0;
+}
+
 static int
 app_parse_burst_conf(const char *conf_str)
 {
@@ -308,10 +357,11 @@ app_parse_args(int argc, char **argv)
 	int option_index;
 	const char *optname;
 	char *prgname = argv[0];
-	uint32_t i, nb_lcores;
+	uint32_t i, j, nb_lcores;
 
 	static struct option lgopts[] = {
 		{ "pfc", 1, 0, 0 },
+		{ "wt", 1, 0, 0 },
 		{ "mst", 1, 0, 0 },
 		{ "rsz", 1, 0, 0 },
 		{ "bsz", 1, 0, 0 },
@@ -352,6 +402,14 @@ app_parse_args(int argc, char **argv)
 					}
 					break;
 				}
+				if (str_is(optname, "wt")) {
+					ret = app_parse_wt_conf(optarg);
+					if (ret) {
+						RTE_LOG(ERR, APP, "Invalid worker configuration %s\n", optarg);
+						return -1;
+					}
+					break;
+				}
 				if (str_is(optname, "mst")) {
 					app_master_core = (uint32_t)atoi(optarg);
 					break;
@@ -446,10 +504,18 @@ app_parse_args(int argc, char **argv)
 			return -1;
 		}
 		uint32_t rx_sock = rte_lcore_to_socket_id(qos_conf[i].rx_core);
-		uint32_t wt_sock = rte_lcore_to_socket_id(qos_conf[i].wt_core);
-		if (rx_sock != wt_sock) {
-			RTE_LOG(ERR, APP, "pfc %u: RX and WT must be on the same socket\n", i + 1);
-			return -1;
+		for (j = 0; j < qos_conf[i].n_wt_cores; j++) {
+			uint32_t wt_core = qos_conf[i].wt_cores[j];
+
+			if (wt_core >= nb_lcores) {
+				RTE_LOG(ERR, APP, "pfc %u: invalid WT lcore index %u\n", i + 1,
+						wt_core);
+				return -1;
+			}
+			if (rx_sock != rte_lcore_to_socket_id(wt_core)) {
+				RTE_LOG(ERR, APP, "pfc %u: RX and WT must be on the same socket\n", i + 1);
+				return -1;
+			}
 		}
 		app_numa_mask |= 1 << rte_lcore_to_socket_id(qos_conf[i].rx_core);
 	}
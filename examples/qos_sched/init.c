@@ -343,6 +343,42 @@ app_init_sched_port(uint32_t portid, uint32_t socketid)
 	return port;
 }
 
+/* Split the port subports between the worker lcores of the flow */
+static void
+app_init_sched_partitions(struct flow_conf *flow)
+{
+	uint32_t n_subports = port_params.n_subports_per_port;
+	uint32_t n_wt = flow->n_wt_cores;
+	uint32_t wt, subport;
+
+	if (n_wt == 1) {
+		flow->wt_sched_ports[0] = flow->sched_port;
+		return;
+	}
+
+	if (n_subports < n_wt)
+		rte_exit(EXIT_FAILURE, "Unable to split %u subports between %u "
+				"worker lcores\n", n_subports, n_wt);
+
+	for (wt = 0; wt < n_wt; wt++) {
+		uint32_t first = wt * n_subports / n_wt;
+		uint32_t last = (wt + 1) * n_subports / n_wt;
+
+		flow->wt_sched_ports[wt] = rte_sched_port_partition_create(
+				flow->sched_port, first, last - first);
+		if (flow->wt_sched_ports[wt] == NULL)
+			rte_exit(EXIT_FAILURE, "Unable to create sched port "
+					"partition for subports %u to %u\n",
+					first, last - 1);
+
+		for (subport = first; subport < last; subport++)
+			flow->subport_wt[subport] = wt;
+
+		RTE_LOG(INFO, APP, "lcore %u scheduling subports %u to %u\n",
+				flow->wt_cores[wt], first, last - 1);
+	}
+}
+
 static int
 app_load_cfg_profile(const char *profile)
 {
@@ -378,6 +414,7 @@ int app_init(void)
 	for(i = 0; i < nb_pfc; i++) {
 		uint32_t socket = rte_lcore_to_socket_id(qos_conf[i].rx_core);
 		struct rte_ring *ring;
+		uint32_t j;
 
 		snprintf(ring_name, MAX_NAME_LEN, "ring-%u-%u", i, qos_conf[i].rx_core);
 		ring = rte_ring_lookup(ring_name);
@@ -387,11 +424,25 @@ int app_init(void)
 		else
 			qos_conf[i].rx_ring = ring;
 
+		qos_conf[i].wt_rings[0] = qos_conf[i].rx_ring;
+		for (j = 1; j < qos_conf[i].n_wt_cores; j++) {
+			snprintf(ring_name, MAX_NAME_LEN, "ring-%u-%u-%u", i,
+				qos_conf[i].rx_core, qos_conf[i].wt_cores[j]);
+			qos_conf[i].wt_rings[j] = rte_ring_create(ring_name,
+				ring_conf.ring_size, socket,
+				RING_F_SP_ENQ | RING_F_SC_DEQ);
+			if (qos_conf[i].wt_rings[j] == NULL)
+				rte_exit(EXIT_FAILURE, "Cannot create ring %s\n",
+					ring_name);
+		}
+
+		/* several worker lcores write to the same tx ring */
 		snprintf(ring_name, MAX_NAME_LEN, "ring-%u-%u", i, qos_conf[i].tx_core);
 		ring = rte_ring_lookup(ring_name);
 		if (ring == NULL)
 			qos_conf[i].tx_ring = rte_ring_create(ring_name, ring_conf.ring_size,
-				socket, RING_F_SP_ENQ | RING_F_SC_DEQ);
+				socket, (qos_conf[i].n_wt_cores > 1) ? RING_F_SC_DEQ :
+				RING_F_SP_ENQ | RING_F_SC_DEQ);
 		else
 			qos_conf[i].tx_ring = ring;
 
@@ -409,6 +460,7 @@ int app_init(void)
 		app_init_port(qos_conf[i].tx_port, qos_conf[i].mbuf_pool);
 
 		qos_conf[i].sched_port = app_init_sched_port(qos_conf[i].tx_port, socket);
+		app_init_sched_partitions(&qos_conf[i]);
 	}
 
 	RTE_LOG(INFO, APP, "time stamp clock running at %" PRIu64 " Hz\n",
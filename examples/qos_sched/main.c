@@ -32,7 +32,7 @@ static int
 app_main_loop(__attribute__((unused))void *dummy)
 {
 	uint32_t lcore_id;
-	uint32_t i, mode;
+	uint32_t i, j, mode;
 	uint32_t rx_idx = 0;
 	uint32_t wt_idx = 0;
 	uint32_t tx_idx = 0;
@@ -56,6 +56,9 @@ app_main_loop(__attribute__((unused))void *dummy)
 			flow->rx_thread.rx_ring =  flow->rx_ring;
 			flow->rx_thread.rx_queue = flow->rx_queue;
 			flow->rx_thread.sched_port = flow->sched_port;
+			flow->rx_thread.wt_rings = flow->wt_rings;
+			flow->rx_thread.subport_wt = flow->subport_wt;
+			flow->rx_thread.n_wt = flow->n_wt_cores;
 
 			rx_confs[rx_idx++] = &flow->rx_thread;
 
@@ -70,13 +73,18 @@ app_main_loop(__attribute__((unused))void *dummy)
 
 			mode |= APP_TX_MODE;
 		}
-		if (flow->wt_core == lcore_id) {
-			flow->wt_thread.rx_ring =  flow->rx_ring;
-			flow->wt_thread.tx_ring =  flow->tx_ring;
-			flow->wt_thread.tx_port =  flow->tx_port;
-			flow->wt_thread.sched_port =  flow->sched_port;
+		for (j = 0; j < flow->n_wt_cores; j++) {
+			struct thread_conf *wt_thread = &flow->wt_thread[j];
 
-			wt_confs[wt_idx++] = &flow->wt_thread;
+			if (flow->wt_cores[j] != lcore_id)
+				continue;
+
+			wt_thread->rx_ring =  flow->wt_rings[j];
+			wt_thread->tx_ring =  flow->tx_ring;
+			wt_thread->tx_port =  flow->tx_port;
+			wt_thread->sched_port =  flow->wt_sched_ports[j];
+
+			wt_confs[wt_idx++] = wt_thread;
 
 			mode |= APP_WT_MODE;
 		}
@@ -146,7 +154,7 @@ app_main_loop(__attribute__((unused))void *dummy)
 void
 app_stat(void)
 {
-	uint32_t i;
+	uint32_t i, j;
 	struct rte_eth_stats stats;
 	static struct rte_eth_stats rx_stats[MAX_DATA_STREAMS];
 	static struct rte_eth_stats tx_stats[MAX_DATA_STREAMS];
@@ -172,6 +180,15 @@ app_stat(void)
 		memcpy(&tx_stats[i], &stats, sizeof(stats));
 
 #if APP_COLLECT_STAT
+		struct thread_stat wt_stat = {0};
+
+		for (j = 0; j < flow->n_wt_cores; j++) {
+			wt_stat.nb_rx += flow->wt_thread[j].stat.nb_rx;
+			wt_stat.nb_drop += flow->wt_thread[j].stat.nb_drop;
+			memset(&flow->wt_thread[j].stat, 0,
+				sizeof(struct thread_stat));
+		}
+
 		printf("-------+------------+------------+\n");
 		printf("       |  received  |   dropped  |\n");
 		printf("-------+------------+------------+\n");
@@ -179,13 +196,12 @@ app_stat(void)
 			flow->rx_thread.stat.nb_rx,
 			flow->rx_thread.stat.nb_drop);
 		printf("QOS+TX | %10" PRIu64 " | %10" PRIu64 " |   pps: %"PRIu64 " \n",
-			flow->wt_thread.stat.nb_rx,
-			flow->wt_thread.stat.nb_drop,
-			flow->wt_thread.stat.nb_rx - flow->wt_thread.stat.nb_drop);
+			wt_stat.nb_rx,
+			wt_stat.nb_drop,
+			wt_stat.nb_rx - wt_stat.nb_drop);
 		printf("-------+------------+------------+\n");
 
 		memset(&flow->rx_thread.stat, 0, sizeof(struct thread_stat));
-		memset(&flow->wt_thread.stat, 0, sizeof(struct thread_stat));
 #endif
 	}
 }
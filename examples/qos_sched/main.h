@@ -51,6 +51,7 @@ extern "C" {
 #define MAX_SCHED_SUBPORTS		8
 #define MAX_SCHED_PIPES		4096
 #define MAX_SCHED_PIPE_PROFILES		256
+#define MAX_WT_LCORES		MAX_SCHED_SUBPORTS
 
 #ifndef APP_COLLECT_STAT
 #define APP_COLLECT_STAT		1
@@ -86,6 +87,11 @@ struct thread_conf
 	struct rte_ring *tx_ring;
 	struct rte_sched_port *sched_port;
 
+	/* RX thread: worker rings, selected by the subport of each packet */
+	struct rte_ring **wt_rings;
+	uint8_t *subport_wt;
+	uint32_t n_wt;
+
 #if APP_COLLECT_STAT
 	struct thread_stat stat;
 #endif
@@ -106,8 +112,17 @@ struct flow_conf
 	struct rte_sched_port *sched_port;
 	struct rte_mempool *mbuf_pool;
 
+	/* Worker lcores, each one scheduling its own range of subports through
+	 * a partition of the port. Worker 0 is wt_core, reading from rx_ring.
+	 */
+	uint32_t n_wt_cores;
+	uint32_t wt_cores[MAX_WT_LCORES];
+	struct rte_ring *wt_rings[MAX_WT_LCORES];
+	struct rte_sched_port *wt_sched_ports[MAX_WT_LCORES];
+	uint8_t subport_wt[MAX_SCHED_SUBPORTS];
+
 	struct thread_conf rx_thread;
-	struct thread_conf wt_thread;
+	struct thread_conf wt_thread[MAX_WT_LCORES];
 	struct thread_conf tx_thread;
 };
 
@@ -32,6 +32,7 @@ extern "C" {
 #define RTE_DISTRIB_GET_BUF (1)    /**< worker requests a buffer, returns old */
 #define RTE_DISTRIB_RETURN_BUF (2) /**< worker returns a buffer, no request */
 #define RTE_DISTRIB_VALID_BUF (4)  /**< set if bufptr contains ptr */
+#define RTE_DISTRIB_EXIT_BUF (8)   /**< worker returns, requests no more */
 
 #define RTE_DISTRIB_BACKLOG_SIZE 8
 #define RTE_DISTRIB_BACKLOG_MASK (RTE_DISTRIB_BACKLOG_SIZE - 1)
@@ -48,6 +49,25 @@ extern "C" {
 
 #define RTE_DISTRIBUTOR_NAMESIZE 32 /**< Length of name for instance */
 
+/*
+ * Number of slots new flows are hashed to when flow affinity is enabled,
+ * each slot being assigned to a worker.
+ */
+#define RTE_DISTRIB_FLOW_SLOTS 1024
+#define RTE_DISTRIB_FLOW_SLOTS_MASK (RTE_DISTRIB_FLOW_SLOTS - 1)
+
+/*
+ * Number of workers checked for one that is ready to take a new burst,
+ * before new flows are assigned to a worker.
+ */
+#define RTE_DISTRIB_WKR_SCAN 4
+
+/*
+ * Number of packets of exited workers waiting to be given to the other
+ * workers.
+ */
+#define RTE_DISTRIB_PENDING_SIZE 512
+
 /**
  * Buffer structure used to pass the pointer data between cores. This is cache
  * line aligned, but to improve performance and prevent adjacent cache-line
@@ -105,6 +125,7 @@ struct rte_distributor_single {
 enum rte_distributor_match_function {
 	RTE_DIST_MATCH_SCALAR = 0,
 	RTE_DIST_MATCH_VECTOR,
+	RTE_DIST_MATCH_AVX512,
 	RTE_DIST_NUM_MATCH_FNS
 };
 
@@ -155,6 +176,23 @@ struct rte_distributor {
 	enum rte_distributor_match_function dist_match_fn;
 
 	struct rte_distributor_single *d_single;
+
+	uint64_t active_workers;
+		/**< on/off bits for the workers new flows can be assigned to */
+	uint64_t exited_workers;
+		/**< on/off bits for the workers which stopped requesting packets */
+	unsigned int next_wkr;  /**< Next worker to assign new flows to */
+	int flow_affinity;      /**< Assign new flows by their flow slot */
+
+	uint16_t flow_slots[RTE_DISTRIB_MAX_WORKERS];
+		/**< Number of flow slots assigned to each worker */
+	uint8_t flow_wkr[RTE_DISTRIB_FLOW_SLOTS];
+		/**< Worker assigned to each flow slot */
+
+	unsigned int pending_count;
+		/**< Number of packets in pending */
+	struct rte_mbuf *pending[RTE_DISTRIB_PENDING_SIZE];
+		/**< Packets of exited workers, distributed before new ones */
 };
 
 void
@@ -167,6 +205,11 @@ find_match_vec(struct rte_distributor *d,
 			uint16_t *data_ptr,
 			uint16_t *output_ptr);
 
+void
+find_match_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr);
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,6 +7,7 @@
 #include <string.h>
 #include <rte_mbuf.h>
 #include <rte_memory.h>
+#include <rte_cpuflags.h>
 #include <rte_cycles.h>
 #include <rte_memzone.h>
 #include <rte_errno.h>
@@ -37,6 +38,7 @@ rte_distributor_request_pkt(struct rte_distributor *d,
 {
 	struct rte_distributor_buffer *buf = &(d->bufs[worker_id]);
 	unsigned int i;
+	int64_t ret;
 
 	volatile int64_t *retptr64;
 
@@ -47,6 +49,15 @@ rte_distributor_request_pkt(struct rte_distributor *d,
 	}
 
 	retptr64 = &(buf->retptr64[0]);
+	/* Requesting again cancels a return the distributor hasn't handled
+	 * yet, so that it doesn't take the worker for exited.
+	 */
+	ret = __atomic_load_n(retptr64, __ATOMIC_ACQUIRE);
+	if (unlikely(ret & RTE_DISTRIB_EXIT_BUF))
+		__atomic_compare_exchange_n(retptr64, &ret,
+				ret & ~RTE_DISTRIB_EXIT_BUF, 0,
+				__ATOMIC_RELEASE, __ATOMIC_RELAXED);
+
 	/* Spin while handshake bits are set (scheduler clears it).
 	 * Sync with worker on GET_BUF flag.
 	 */
@@ -179,11 +190,13 @@ rte_distributor_return_pkt(struct rte_distributor *d,
 		buf->retptr64[i] = (((int64_t)(uintptr_t)oldpkt[i]) <<
 			RTE_DISTRIB_FLAG_BITS) | RTE_DISTRIB_RETURN_BUF;
 
-	/* set the GET_BUF but even if we got no returns.
+	/* set the GET_BUF but even if we got no returns, and tell the
+	 * distributor not to give this worker packets any more.
 	 * Sync with distributor on GET_BUF flag. Release retptrs.
 	 */
 	__atomic_store_n(&(buf->retptr64[0]),
-		buf->retptr64[0] | RTE_DISTRIB_GET_BUF, __ATOMIC_RELEASE);
+		buf->retptr64[0] | RTE_DISTRIB_GET_BUF | RTE_DISTRIB_EXIT_BUF,
+		__ATOMIC_RELEASE);
 
 	return 0;
 }
@@ -234,13 +247,13 @@ find_match_scalar(struct rte_distributor *d,
 
 		for (j = 0; j < RTE_DIST_BURST_SIZE ; j++)
 			for (w = 0; w < RTE_DIST_BURST_SIZE; w++)
-				if (d->in_flight_tags[i][j] == data_ptr[w]) {
+				if (d->in_flight_tags[i][w] == data_ptr[j]) {
 					output_ptr[j] = i+1;
 					break;
 				}
 		for (j = 0; j < RTE_DIST_BURST_SIZE; j++)
 			for (w = 0; w < RTE_DIST_BURST_SIZE; w++)
-				if (bl->tags[j] == data_ptr[w]) {
+				if (bl->tags[w] == data_ptr[j]) {
 					output_ptr[j] = i+1;
 					break;
 				}
@@ -272,6 +285,12 @@ handle_returns(struct rte_distributor *d, unsigned int wkr)
 	/* Sync on GET_BUF flag. Acquire retptrs. */
 	if (__atomic_load_n(&(buf->retptr64[0]), __ATOMIC_ACQUIRE)
 		& RTE_DISTRIB_GET_BUF) {
+		/* returning without a request, or requesting again */
+		if (buf->retptr64[0] & RTE_DISTRIB_EXIT_BUF)
+			d->exited_workers |= 1ULL << wkr;
+		else
+			d->exited_workers &= ~(1ULL << wkr);
+
 		for (i = 0; i < RTE_DIST_BURST_SIZE; i++) {
 			if (buf->retptr64[i] & RTE_DISTRIB_RETURN_BUF) {
 				oldbuf = ((uintptr_t)(buf->retptr64[i] >>
@@ -292,6 +311,51 @@ handle_returns(struct rte_distributor *d, unsigned int wkr)
 	return count;
 }
 
+/*
+ * Move the packets of a worker which returned without requesting more
+ * packets to the pending packets, which the process loop gives to the
+ * other workers: the burst released to it that it didn't take, and its
+ * backlog. Returns 0 if there is no other worker to take them, or no room
+ * for them.
+ */
+static int
+handle_worker_exit(struct rte_distributor *d, unsigned int wkr)
+{
+	struct rte_distributor_buffer *buf = &(d->bufs[wkr]);
+	uint64_t others;
+	unsigned int i;
+
+	others = ~d->exited_workers & ~(1ULL << wkr) &
+			RTE_LEN2MASK(d->num_workers, uint64_t);
+	if (others == 0 || d->pending_count >
+			RTE_DISTRIB_PENDING_SIZE - RTE_DIST_BURST_SIZE * 2)
+		return 0;
+
+	/* Sync with worker on GET_BUF flag. Acquire bufptrs. */
+	if (!(__atomic_load_n(&(buf->bufptr64[0]), __ATOMIC_ACQUIRE)
+			& RTE_DISTRIB_GET_BUF)) {
+		for (i = 0; i < RTE_DIST_BURST_SIZE; i++)
+			if (buf->bufptr64[i] & RTE_DISTRIB_VALID_BUF)
+				d->pending[d->pending_count++] =
+					(struct rte_mbuf *)((uintptr_t)
+					(buf->bufptr64[i] >>
+					RTE_DISTRIB_FLAG_BITS));
+		/* the worker gets a new burst if it requests again */
+		__atomic_store_n(&(buf->bufptr64[0]), RTE_DISTRIB_GET_BUF,
+				__ATOMIC_RELEASE);
+	}
+
+	for (i = 0; i < d->backlog[wkr].count; i++)
+		d->pending[d->pending_count++] = (struct rte_mbuf *)((uintptr_t)
+			(d->backlog[wkr].pkts[i] >> RTE_DISTRIB_FLAG_BITS));
+	d->backlog[wkr].count = 0;
+
+	/* clear both the inflight and the backlog tags */
+	memset(d->in_flight_tags[wkr], 0, sizeof(d->in_flight_tags[wkr]));
+
+	return 1;
+}
+
 /*
  * This function releases a burst (cache line) to a worker.
  * It is called from the process function when a cacheline is
@@ -307,10 +371,20 @@ release(struct rte_distributor *d, unsigned int wkr)
 	struct rte_distributor_buffer *buf = &(d->bufs[wkr]);
 	unsigned int i;
 
+	handle_returns(d, wkr);
+	if (unlikely(d->exited_workers & (1ULL << wkr)) &&
+			handle_worker_exit(d, wkr))
+		return 0;
+
 	/* Sync with worker on GET_BUF flag */
 	while (!(__atomic_load_n(&(d->bufs[wkr].bufptr64[0]), __ATOMIC_ACQUIRE)
-		& RTE_DISTRIB_GET_BUF))
+		& RTE_DISTRIB_GET_BUF)) {
+		handle_returns(d, wkr);
+		if (unlikely(d->exited_workers & (1ULL << wkr)) &&
+				handle_worker_exit(d, wkr))
+			return 0;
 		rte_pause();
+	}
 
 	handle_returns(d, wkr);
 
@@ -338,6 +412,87 @@ release(struct rte_distributor *d, unsigned int wkr)
 
 }
 
+/*
+ * Select the worker that new flows are assigned to, starting from the one
+ * after the last selected. A worker that has taken its last burst and has
+ * room in its backlog is preferred, so that releasing a burst to it
+ * doesn't wait for it to finish its current one.
+ */
+static unsigned int
+next_worker(struct rte_distributor *d)
+{
+	uint64_t candidates = d->active_workers & ~d->exited_workers;
+	unsigned int wkr = d->next_wkr;
+	unsigned int first = RTE_DISTRIB_MAX_WORKERS;
+	unsigned int i, scanned = 0;
+
+	/* removed workers still take packets rather than exited ones */
+	if (unlikely(candidates == 0))
+		candidates = ~d->exited_workers &
+				RTE_LEN2MASK(d->num_workers, uint64_t);
+	if (unlikely(candidates == 0))
+		return wkr;
+
+	for (i = 0; i < d->num_workers; i++) {
+		if (candidates & (1ULL << wkr)) {
+			if (first == RTE_DISTRIB_MAX_WORKERS)
+				first = wkr;
+
+			/* Sync with worker on GET_BUF flag. */
+			if (d->backlog[wkr].count < RTE_DIST_BURST_SIZE &&
+					(__atomic_load_n(
+					&(d->bufs[wkr].bufptr64[0]),
+					__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF))
+				return wkr;
+
+			if (++scanned == RTE_DISTRIB_WKR_SCAN)
+				break;
+		}
+		if (++wkr == d->num_workers)
+			wkr = 0;
+	}
+
+	/* all busy, keep going round-robin */
+	return first;
+}
+
+/* Take back the workers which requested packets again after exiting */
+static inline void
+update_exited(struct rte_distributor *d)
+{
+	uint64_t exited;
+
+	for (exited = d->exited_workers; unlikely(exited != 0);
+			exited &= exited - 1)
+		handle_returns(d, rte_bsf64(exited));
+}
+
+/*
+ * Select the worker for a packet of a flow of exited worker wkr. New
+ * packets are queued after the packets of the worker, which are pending
+ * for the other workers, so that the flow keeps its order. Pending
+ * packets go to a worker taking new flows. Returns
+ * RTE_DISTRIB_MAX_WORKERS if the packet was queued, or wkr if no other
+ * worker can take it.
+ */
+static unsigned int
+redirect_exited(struct rte_distributor *d, unsigned int wkr,
+		struct rte_mbuf *mb, int pending)
+{
+	/* the worker may have requested again since */
+	handle_returns(d, wkr);
+	if (!(d->exited_workers & (1ULL << wkr)) ||
+			!handle_worker_exit(d, wkr))
+		return wkr;
+
+	if (pending)
+		return next_worker(d);
+
+	if (d->pending_count == RTE_DISTRIB_PENDING_SIZE)
+		return wkr;
+	d->pending[d->pending_count++] = mb;
+	return RTE_DISTRIB_MAX_WORKERS;
+}
 
 /* process a set of packets to distribute them to workers */
 int
@@ -345,7 +500,7 @@ rte_distributor_process(struct rte_distributor *d,
 		struct rte_mbuf **mbufs, unsigned int num_mbufs)
 {
 	unsigned int next_idx = 0;
-	static unsigned int wkr;
+	unsigned int wkr;
 	struct rte_mbuf *next_mb = NULL;
 	int64_t next_value = 0;
 	uint16_t new_tag = 0;
@@ -358,6 +513,9 @@ rte_distributor_process(struct rte_distributor *d,
 			mbufs, num_mbufs);
 	}
 
+	/* Workers which returned and requested again take new flows */
+	update_exited(d);
+
 	if (unlikely(num_mbufs == 0)) {
 		/* Flush out all non-full cache-lines to workers. */
 		for (wid = 0 ; wid < d->num_workers; wid++) {
@@ -367,28 +525,58 @@ rte_distributor_process(struct rte_distributor *d,
 				release(d, wid);
 				handle_returns(d, wid);
 			}
+			/* the worker exited, leaving its packets pending */
+			if (unlikely(d->pending_count > 0))
+				goto distribute;
 		}
 		return 0;
 	}
 
-	while (next_idx < num_mbufs) {
+	/*
+	 * The packets of workers which exited while releasing bursts are
+	 * pending, distributed in a later pass of the loop or after the
+	 * flush that released them.
+	 */
+distribute:
+	while (next_idx < num_mbufs || d->pending_count > 0) {
 		uint16_t matches[RTE_DIST_BURST_SIZE];
+		struct rte_mbuf *pending_mbufs[RTE_DIST_BURST_SIZE];
+		struct rte_mbuf **burst;
 		unsigned int pkts;
+		int pending;
+
+		/* The packets of exited workers go first */
+		pending = d->pending_count > 0;
+		if (unlikely(pending)) {
+			update_exited(d);
+			pkts = RTE_MIN(d->pending_count,
+					(unsigned int)RTE_DIST_BURST_SIZE);
+			memcpy(pending_mbufs, d->pending,
+					pkts * sizeof(pending_mbufs[0]));
+			d->pending_count -= pkts;
+			memmove(d->pending, &d->pending[pkts],
+					d->pending_count * sizeof(d->pending[0]));
+			burst = pending_mbufs;
+		} else {
+			if ((num_mbufs - next_idx) < RTE_DIST_BURST_SIZE)
+				pkts = num_mbufs - next_idx;
+			else
+				pkts = RTE_DIST_BURST_SIZE;
+			burst = &mbufs[next_idx];
+			next_idx += pkts;
+		}
+
+		wkr = next_worker(d);
 
 		/* Sync with worker on GET_BUF flag. */
 		if (__atomic_load_n(&(d->bufs[wkr].bufptr64[0]),
 			__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF)
 			d->bufs[wkr].count = 0;
 
-		if ((num_mbufs - next_idx) < RTE_DIST_BURST_SIZE)
-			pkts = num_mbufs - next_idx;
-		else
-			pkts = RTE_DIST_BURST_SIZE;
-
 		for (i = 0; i < pkts; i++) {
-			if (mbufs[next_idx + i]) {
+			if (burst[i]) {
 				/* flows have to be non-zero */
-				flows[i] = mbufs[next_idx + i]->hash.usr | 1;
+				flows[i] = burst[i]->hash.usr | 1;
 			} else
 				flows[i] = 0;
 		}
@@ -399,6 +587,11 @@ rte_distributor_process(struct rte_distributor *d,
 		case RTE_DIST_MATCH_VECTOR:
 			find_match_vec(d, &flows[0], &matches[0]);
 			break;
+#ifdef CC_AVX512_SUPPORT
+		case RTE_DIST_MATCH_AVX512:
+			find_match_avx512(d, &flows[0], &matches[0]);
+			break;
+#endif
 		default:
 			find_match_scalar(d, &flows[0], &matches[0]);
 		}
@@ -410,8 +603,10 @@ rte_distributor_process(struct rte_distributor *d,
 		 */
 
 		for (j = 0; j < pkts; j++) {
+			struct rte_distributor_backlog *bl;
+			unsigned int idx;
 
-			next_mb = mbufs[next_idx++];
+			next_mb = burst[j];
 			next_value = (((int64_t)(uintptr_t)next_mb) <<
 					RTE_DISTRIB_FLAG_BITS);
 			/*
@@ -431,54 +626,77 @@ rte_distributor_process(struct rte_distributor *d,
 			/* matches[j] = 0; */
 
 			if (matches[j]) {
-				struct rte_distributor_backlog *bl =
-						&d->backlog[matches[j]-1];
-				if (unlikely(bl->count ==
-						RTE_DIST_BURST_SIZE)) {
-					release(d, matches[j]-1);
-				}
-
 				/* Add to worker that already has flow */
-				unsigned int idx = bl->count++;
-
-				bl->tags[idx] = new_tag;
-				bl->pkts[idx] = next_value;
-
+				wid = matches[j] - 1;
 			} else {
-				struct rte_distributor_backlog *bl =
-						&d->backlog[wkr];
-				if (unlikely(bl->count ==
-						RTE_DIST_BURST_SIZE)) {
-					release(d, wkr);
+				/*
+				 * Add to current worker, or with flow
+				 * affinity to the worker of its flow slot.
+				 */
+				wid = wkr;
+				if (d->flow_affinity) {
+					w = d->flow_wkr[next_mb->hash.usr &
+						RTE_DISTRIB_FLOW_SLOTS_MASK];
+					if (likely(w < d->num_workers &&
+							!(d->exited_workers &
+							(1ULL << w))))
+						wid = w;
 				}
+			}
 
-				/* Add to current worker worker */
-				unsigned int idx = bl->count++;
+			/*
+			 * The worker may have exited, or exit while its
+			 * full backlog is released.
+			 */
+			for (;;) {
+				if (unlikely(d->exited_workers &
+						(1ULL << wid))) {
+					wid = redirect_exited(d, wid, next_mb,
+							pending);
+					if (wid == RTE_DISTRIB_MAX_WORKERS)
+						break;
+				}
+				bl = &d->backlog[wid];
+				if (likely(bl->count < RTE_DIST_BURST_SIZE))
+					break;
+				release(d, wid);
+			}
+			if (unlikely(wid == RTE_DISTRIB_MAX_WORKERS))
+				continue;
 
-				bl->tags[idx] = new_tag;
-				bl->pkts[idx] = next_value;
-				/*
-				 * Now that we've just added an unpinned flow
-				 * to a worker, we need to ensure that all
-				 * other packets with that same flow will go
-				 * to the same worker in this burst.
-				 */
+			idx = bl->count++;
+			bl->tags[idx] = new_tag;
+			bl->pkts[idx] = next_value;
+
+			/*
+			 * Now that we've just added an unpinned or moved flow
+			 * to a worker, we need to ensure that all other
+			 * packets with that same flow will go to the same
+			 * worker in this burst.
+			 */
+			if (matches[j] != wid + 1)
 				for (w = j; w < pkts; w++)
 					if (flows[w] == new_tag)
-						matches[w] = wkr+1;
-			}
+						matches[w] = wid + 1;
 		}
-		wkr++;
-		if (wkr >= d->num_workers)
-			wkr = 0;
+		d->next_wkr = wkr + 1;
+		if (d->next_wkr >= d->num_workers)
+			d->next_wkr = 0;
 	}
 
 	/* Flush out all non-full cache-lines to workers. */
-	for (wid = 0 ; wid < d->num_workers; wid++)
+	for (wid = 0 ; wid < d->num_workers; wid++) {
 		/* Sync with worker on GET_BUF flag. */
 		if ((__atomic_load_n(&(d->bufs[wid].bufptr64[0]),
 			__ATOMIC_ACQUIRE) & RTE_DISTRIB_GET_BUF))
 			release(d, wid);
+		/*
+		 * The worker exited, its packets go to the other workers
+		 * before they are flushed, in case they exit as well.
+		 */
+		if (unlikely(d->pending_count > 0))
+			goto distribute;
+	}
 
 	return num_mbufs;
 }
@@ -638,6 +856,23 @@ rte_distributor_create(const char *name,
 #if defined(RTE_ARCH_X86)
 	d->dist_match_fn = RTE_DIST_MATCH_VECTOR;
 #endif
+#ifdef CC_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		d->dist_match_fn = RTE_DIST_MATCH_AVX512;
+#endif
+
+	/* all the workers get new flows, the flow slots are spread evenly */
+	d->active_workers = RTE_LEN2MASK(num_workers, uint64_t);
+	d->exited_workers = 0;
+	d->pending_count = 0;
+	d->next_wkr = 0;
+	d->flow_affinity = 0;
+	memset(d->flow_slots, 0, sizeof(d->flow_slots));
+	for (i = 0; i < RTE_DISTRIB_FLOW_SLOTS; i++) {
+		d->flow_wkr[i] = i % num_workers;
+		d->flow_slots[i % num_workers]++;
+	}
 
 	/*
 	 * Set up the backlog tags so they're pointing at the second cache
@@ -656,3 +891,97 @@ rte_distributor_create(const char *name,
 
 	return d;
 }
+
+/*
+ * Reassign the flow slots after a worker has been added or removed: the
+ * slots of the removed worker, or a share of the slots of the others for
+ * the added worker, move. The other flows keep their worker.
+ */
+static void
+flow_slots_rebalance(struct rte_distributor *d)
+{
+	uint16_t quota[RTE_DISTRIB_MAX_WORKERS];
+	unsigned int nb_active, share, extra;
+	unsigned int i, wkr;
+	uint8_t owner;
+
+	nb_active = __builtin_popcountll(d->active_workers);
+	share = RTE_DISTRIB_FLOW_SLOTS / nb_active;
+	extra = RTE_DISTRIB_FLOW_SLOTS % nb_active;
+
+	for (wkr = 0; wkr < d->num_workers; wkr++) {
+		quota[wkr] = 0;
+		if (d->active_workers & (1ULL << wkr)) {
+			quota[wkr] = share + (extra != 0);
+			extra -= (extra != 0);
+		}
+	}
+
+	/* release the slots of removed workers and over their quota */
+	for (i = 0; i < RTE_DISTRIB_FLOW_SLOTS; i++) {
+		owner = d->flow_wkr[i];
+		if (d->flow_slots[owner] > quota[owner]) {
+			d->flow_slots[owner]--;
+			d->flow_wkr[i] = UINT8_MAX;
+		}
+	}
+
+	/* give the released slots to the workers under their quota */
+	wkr = 0;
+	for (i = 0; i < RTE_DISTRIB_FLOW_SLOTS; i++) {
+		if (d->flow_wkr[i] != UINT8_MAX)
+			continue;
+		while (d->flow_slots[wkr] == quota[wkr])
+			wkr++;
+		d->flow_wkr[i] = wkr;
+		d->flow_slots[wkr]++;
+	}
+}
+
+int
+rte_distributor_flow_affinity_set(struct rte_distributor *d, int enable)
+{
+	if (d->alg_type == RTE_DIST_ALG_SINGLE)
+		return -ENOTSUP;
+
+	d->flow_affinity = !!enable;
+	return 0;
+}
+
+int
+rte_distributor_worker_remove(struct rte_distributor *d,
+		unsigned int worker_id)
+{
+	if (d->alg_type == RTE_DIST_ALG_SINGLE)
+		return -ENOTSUP;
+
+	if (worker_id >= d->num_workers ||
+			!(d->active_workers & (1ULL << worker_id)))
+		return -EINVAL;
+
+	/* new flows need a worker */
+	if (d->active_workers == (1ULL << worker_id))
+		return -EBUSY;
+
+	d->active_workers &= ~(1ULL << worker_id);
+	flow_slots_rebalance(d);
+
+	return 0;
+}
+
+int
+rte_distributor_worker_add(struct rte_distributor *d,
+		unsigned int worker_id)
+{
+	if (d->alg_type == RTE_DIST_ALG_SINGLE)
+		return -ENOTSUP;
+
+	if (worker_id >= d->num_workers ||
+			(d->active_workers & (1ULL << worker_id)))
+		return -EINVAL;
+
+	d->active_workers |= 1ULL << worker_id;
+	flow_slots_rebalance(d);
+
+	return 0;
+}
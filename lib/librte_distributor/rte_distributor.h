@@ -13,6 +13,8 @@
  * one-at-a-time to workers, with dynamic load balancing.
  */
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -234,6 +236,79 @@ int
 rte_distributor_poll_pkt(struct rte_distributor *d,
 		unsigned int worker_id, struct rte_mbuf **mbufs);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Enable or disable flow affinity on a burst distributor.
+ *
+ * By default, the flows that are not in flight on a worker are given to the
+ * next worker ready to take packets. With flow affinity, they are given to
+ * the worker the flow tag hashes to, so that a flow keeps going to the same
+ * worker, and its state stays in the cache of that worker, as long as the
+ * workers don't change. When a worker is added or removed, only the flows
+ * that hash to the slots moving to or from it change worker.
+ *
+ * This function must be called on the distributor lcore.
+ *
+ * @param d
+ *   The distributor instance to be used
+ * @param enable
+ *   Non-zero to enable flow affinity, zero to disable it
+ * @return
+ *   0 on success, -ENOTSUP for a single packet distributor
+ */
+__rte_experimental
+int
+rte_distributor_flow_affinity_set(struct rte_distributor *d, int enable);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Stop giving new flows to a worker of a burst distributor.
+ *
+ * The worker still gets the packets of the flows in flight on it. It can
+ * stop requesting packets when it gets none, after all its flows ended.
+ *
+ * This function must be called on the distributor lcore.
+ *
+ * @param d
+ *   The distributor instance to be used
+ * @param worker_id
+ *   The worker to remove
+ * @return
+ *   0 on success, -EINVAL if the worker is invalid or already removed,
+ *   -EBUSY if it is the last worker new flows can be given to,
+ *   -ENOTSUP for a single packet distributor
+ */
+__rte_experimental
+int
+rte_distributor_worker_remove(struct rte_distributor *d,
+		unsigned int worker_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Give new flows again to a worker removed with
+ * rte_distributor_worker_remove().
+ *
+ * This function must be called on the distributor lcore.
+ *
+ * @param d
+ *   The distributor instance to be used
+ * @param worker_id
+ *   The worker to add
+ * @return
+ *   0 on success, -EINVAL if the worker is invalid or not removed,
+ *   -ENOTSUP for a single packet distributor
+ */
+__rte_experimental
+int
+rte_distributor_worker_add(struct rte_distributor *d,
+		unsigned int worker_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <rte_mbuf.h>
+#include "rte_distributor.h"
+#include "distributor_private.h"
+#include "immintrin.h"
+
+
+void
+find_match_avx512(struct rte_distributor *d,
+			uint16_t *data_ptr,
+			uint16_t *output_ptr)
+{
+	__m512i incoming_fids[RTE_DIST_BURST_SIZE];
+	__m512i wkr_fids;
+	__mmask32 lanes;
+	__mmask32 mask[RTE_DIST_BURST_SIZE];
+	__mmask32 any;
+	unsigned int i, j;
+
+	/*
+	 * Function overview:
+	 * 1. Broadcast each incoming flow id to a zmm reg
+	 * 2. Loop through the worker ID's, two at a time
+	 *  2a. Load the inflights and backlogs of both workers into a zmm reg:
+	 *      the 16 tags of a worker make up half of a cache line
+	 *  2b. Compare them to each incoming flow id
+	 *  2c. Set the output of the incoming flow ids that matched
+	 */
+
+	for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+		incoming_fids[j] = _mm512_set1_epi16(data_ptr[j]);
+		output_ptr[j] = 0;
+	}
+
+	for (i = 0; i < d->num_workers; i += 2) {
+		/* with an odd number of workers, ignore the last half */
+		lanes = (i + 1 < d->num_workers) ? 0xffffffff : 0xffff;
+
+		wkr_fids = _mm512_load_si512((void *)d->in_flight_tags[i]);
+
+		/*
+		 * The low 16 bits of each mask are set where a tag of worker
+		 * i matches, the high 16 bits where one of worker i+1 does.
+		 */
+		any = 0;
+		for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+			mask[j] = _mm512_mask_cmpeq_epi16_mask(lanes, wkr_fids,
+					incoming_fids[j]);
+			any |= mask[j];
+		}
+		if (any == 0)
+			continue;
+
+		for (j = 0; j < RTE_DIST_BURST_SIZE; j++) {
+			if (mask[j] != 0)
+				output_ptr[j] = (mask[j] >> 16) ? i + 2 : i + 1;
+		}
+	}
+
+	/*
+	 * At this stage, the output contains 8 16-bit values, with
+	 * each non-zero value containing the worker ID on which the
+	 * corresponding flow is pinned to.
+	 */
+}
@@ -113,6 +113,17 @@ enum rte_cpu_flag_t {
 	/* (EAX 80000007h) EDX features */
 	RTE_CPUFLAG_INVTSC,                 /**< INVTSC */
 
+	/* (EAX 07h, ECX 0h) EBX features, AVX512 extensions */
+	RTE_CPUFLAG_AVX512DQ,               /**< AVX512 Doubleword and Quadword */
+	RTE_CPUFLAG_AVX512CD,               /**< AVX512 Conflict Detection */
+	RTE_CPUFLAG_AVX512BW,               /**< AVX512 Byte and Word */
+	RTE_CPUFLAG_AVX512VL,               /**< AVX512 Vector Length */
+
+	/* (EAX 07h, ECX 0h) ECX features */
+	RTE_CPUFLAG_AVX512VBMI,             /**< AVX512 Vector Byte Manipulation */
+	RTE_CPUFLAG_GFNI,                   /**< Galois Field New Instructions */
+	RTE_CPUFLAG_VPCLMULQDQ,             /**< Vector PCLMULQDQ */
+
 	/* The last item */
 	RTE_CPUFLAG_NUMFLAGS,               /**< This should always be the last! */
 };
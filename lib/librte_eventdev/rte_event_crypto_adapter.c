@@ -6,6 +6,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <rte_common.h>
+#include <rte_cycles.h>
 #include <rte_dev.h>
 #include <rte_errno.h>
 #include <rte_cryptodev.h>
@@ -29,12 +30,25 @@
  */
 #define CRYPTO_ENQ_FLUSH_THRESHOLD 1024
 
+/* Size of the buffer of the completion events enqueued to the event device */
+#define CRYPTO_ADAPTER_EVENT_BUF_SIZE (2 * BATCH_SIZE)
+
+/* Completion events pending enqueue to the event device */
+struct crypto_event_buffer {
+	/* Count of events in this buffer */
+	uint16_t count;
+	/* Array of events in this buffer */
+	struct rte_event events[CRYPTO_ADAPTER_EVENT_BUF_SIZE];
+};
+
 struct rte_event_crypto_adapter {
 	/* Event device identifier */
 	uint8_t eventdev_id;
 	/* Event port identifier */
 	uint8_t event_port_id;
-	/* Store event device's implicit release capability */
+	/* Completions are forwarded events: set when the adapter dequeues
+	 * the requests from a port with implicit release disabled
+	 */
 	uint8_t implicit_release_disabled;
 	/* Max crypto ops processed in any service function invocation */
 	uint32_t max_nb;
@@ -48,6 +62,14 @@ struct rte_event_crypto_adapter {
 	uint16_t transmit_loop_count;
 	/* Per instance stats structure */
 	struct rte_event_crypto_adapter_stats crypto_stats;
+	/* Crypto ops buffered in the queue pairs */
+	uint32_t nb_buffered;
+	/* Shortest queue pair flush timeout, in TSC cycles */
+	uint64_t flush_tmo_ticks;
+	/* Timestamp of the last queue pair flush timeout check */
+	uint64_t prev_flush_ts;
+	/* Completion events buffer */
+	struct crypto_event_buffer ebuf;
 	/* Configuration callback for rte_service configuration */
 	rte_event_crypto_adapter_conf_cb conf_cb;
 	/* Configuration callback argument */
@@ -95,7 +117,13 @@ struct crypto_queue_pair_info {
 	/* Pointer to hold rte_crypto_ops for batching */
 	struct rte_crypto_op **op_buffer;
 	/* No of crypto ops accumulated */
-	uint8_t len;
+	uint16_t len;
+	/* No of crypto ops that triggers an enqueue to the queue pair */
+	uint16_t batch_size;
+	/* Flush timeout of the buffered crypto ops, in TSC cycles */
+	uint64_t flush_tmo_ticks;
+	/* Timestamp of the oldest buffered crypto op */
+	uint64_t ts;
 } __rte_cache_aligned;
 
 static struct rte_event_crypto_adapter **event_crypto_adapter;
@@ -188,6 +216,11 @@ eca_default_config_cb(uint8_t id, uint8_t dev_id,
 
 	conf->event_port_id = port_id;
 	conf->max_nb = DEFAULT_MAX_NB;
+	/* Requests dequeued from a port with implicit release are released
+	 * by the next dequeue, their completions are new events
+	 */
+	if (!port_conf->disable_implicit_release)
+		adapter->implicit_release_disabled = 0;
 	if (started)
 		ret = rte_event_dev_start(dev_id);
 
@@ -243,7 +276,10 @@ rte_event_crypto_adapter_create_ext(uint8_t id, uint8_t dev_id,
 		return ret;
 	}
 
-	adapter->implicit_release_disabled = (dev_info.event_dev_cap &
+	/* In OP_NEW mode the adapter dequeues no request event to forward */
+	adapter->implicit_release_disabled =
+		mode == RTE_EVENT_CRYPTO_ADAPTER_OP_FORWARD &&
+		(dev_info.event_dev_cap &
 			RTE_EVENT_DEV_CAP_IMPLICIT_RELEASE_DISABLE);
 	adapter->eventdev_id = dev_id;
 	adapter->socket_id = socket_id;
@@ -297,10 +333,18 @@ rte_event_crypto_adapter_create(uint8_t id, uint8_t dev_id,
 	return ret;
 }
 
+static inline void
+eca_crypto_op_drop(struct rte_crypto_op *op)
+{
+	rte_pktmbuf_free(op->sym->m_src);
+	rte_crypto_op_free(op);
+}
+
 int
 rte_event_crypto_adapter_free(uint8_t id)
 {
 	struct rte_event_crypto_adapter *adapter;
+	uint16_t i;
 
 	EVENT_CRYPTO_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
 
@@ -314,6 +358,9 @@ rte_event_crypto_adapter_free(uint8_t id)
 		return -EBUSY;
 	}
 
+	for (i = 0; i < adapter->ebuf.count; i++)
+		eca_crypto_op_drop(adapter->ebuf.events[i].event_ptr);
+
 	if (adapter->default_cb_arg)
 		rte_free(adapter->conf_arg);
 	rte_free(adapter->cdevs);
@@ -323,6 +370,47 @@ rte_event_crypto_adapter_free(uint8_t id)
 	return 0;
 }
 
+/* Locate the request/response metadata of a crypto op */
+static inline union rte_event_crypto_metadata *
+eca_crypto_op_metadata(struct rte_crypto_op *op)
+{
+	if (op->sess_type == RTE_CRYPTO_OP_WITH_SESSION)
+		return rte_cryptodev_sym_session_get_user_data(
+				op->sym->session);
+
+	if (op->sess_type == RTE_CRYPTO_OP_SESSIONLESS &&
+	    op->private_data_offset)
+		return (union rte_event_crypto_metadata *)
+			((uint8_t *)op + op->private_data_offset);
+
+	return NULL;
+}
+
+/* Enqueue the crypto ops buffered for a queue pair to the cryptodev */
+static inline unsigned int
+eca_qp_flush(struct rte_event_crypto_adapter *adapter, uint8_t cdev_id,
+	     uint16_t qp_id, struct crypto_queue_pair_info *qp_info)
+{
+	struct rte_event_crypto_adapter_stats *stats = &adapter->crypto_stats;
+	struct rte_crypto_op **op_buffer = qp_info->op_buffer;
+	uint16_t len = qp_info->len;
+	uint16_t ret;
+
+	if (len == 0)
+		return 0;
+
+	ret = rte_cryptodev_enqueue_burst(cdev_id, qp_id, op_buffer, len);
+	stats->crypto_enq_count += ret;
+	stats->crypto_enq_fail += len - ret;
+	while (ret < len)
+		eca_crypto_op_drop(op_buffer[--len]);
+
+	adapter->nb_buffered -= qp_info->len;
+	qp_info->len = 0;
+
+	return ret;
+}
+
 static inline unsigned int
 eca_enq_to_cryptodev(struct rte_event_crypto_adapter *adapter,
 		 struct rte_event *ev, unsigned int cnt)
@@ -330,13 +418,12 @@ eca_enq_to_cryptodev(struct rte_event_crypto_adapter *adapter,
 	struct rte_event_crypto_adapter_stats *stats = &adapter->crypto_stats;
 	union rte_event_crypto_metadata *m_data = NULL;
 	struct crypto_queue_pair_info *qp_info = NULL;
+	struct rte_cryptodev_sym_session *sess = NULL;
 	struct rte_crypto_op *crypto_op;
 	unsigned int i, n;
-	uint16_t qp_id, len, ret;
+	uint16_t qp_id;
 	uint8_t cdev_id;
 
-	len = 0;
-	ret = 0;
 	n = 0;
 	stats->event_deq_count += cnt;
 
@@ -344,116 +431,81 @@ eca_enq_to_cryptodev(struct rte_event_crypto_adapter *adapter,
 		crypto_op = ev[i].event_ptr;
 		if (crypto_op == NULL)
 			continue;
-		if (crypto_op->sess_type == RTE_CRYPTO_OP_WITH_SESSION) {
-			m_data = rte_cryptodev_sym_session_get_user_data(
-					crypto_op->sym->session);
-			if (m_data == NULL) {
-				rte_pktmbuf_free(crypto_op->sym->m_src);
-				rte_crypto_op_free(crypto_op);
-				continue;
-			}
 
-			cdev_id = m_data->request_info.cdev_id;
-			qp_id = m_data->request_info.queue_pair_id;
-			qp_info = &adapter->cdevs[cdev_id].qpairs[qp_id];
-			if (!qp_info->qp_enabled) {
-				rte_pktmbuf_free(crypto_op->sym->m_src);
-				rte_crypto_op_free(crypto_op);
-				continue;
-			}
-			len = qp_info->len;
-			qp_info->op_buffer[len] = crypto_op;
-			len++;
-		} else if (crypto_op->sess_type == RTE_CRYPTO_OP_SESSIONLESS &&
-				crypto_op->private_data_offset) {
-			m_data = (union rte_event_crypto_metadata *)
-				 ((uint8_t *)crypto_op +
-					crypto_op->private_data_offset);
-			cdev_id = m_data->request_info.cdev_id;
-			qp_id = m_data->request_info.queue_pair_id;
-			qp_info = &adapter->cdevs[cdev_id].qpairs[qp_id];
-			if (!qp_info->qp_enabled) {
-				rte_pktmbuf_free(crypto_op->sym->m_src);
-				rte_crypto_op_free(crypto_op);
-				continue;
-			}
-			len = qp_info->len;
-			qp_info->op_buffer[len] = crypto_op;
-			len++;
-		} else {
-			rte_pktmbuf_free(crypto_op->sym->m_src);
-			rte_crypto_op_free(crypto_op);
+		/* Consecutive ops of a session share its metadata, the others
+		 * look theirs up: a NULL session doesn't match the NULL key
+		 * left by a sessionless op.
+		 */
+		if (crypto_op->sess_type != RTE_CRYPTO_OP_WITH_SESSION ||
+		    crypto_op->sym->session == NULL ||
+		    crypto_op->sym->session != sess) {
+			m_data = eca_crypto_op_metadata(crypto_op);
+			sess = crypto_op->sess_type ==
+				RTE_CRYPTO_OP_WITH_SESSION ?
+				crypto_op->sym->session : NULL;
+		}
+		if (m_data == NULL) {
+			eca_crypto_op_drop(crypto_op);
 			continue;
 		}
 
-		if (len == BATCH_SIZE) {
-			struct rte_crypto_op **op_buffer = qp_info->op_buffer;
-			ret = rte_cryptodev_enqueue_burst(cdev_id,
-							  qp_id,
-							  op_buffer,
-							  BATCH_SIZE);
-
-			stats->crypto_enq_count += ret;
-
-			while (ret < len) {
-				struct rte_crypto_op *op;
-				op = op_buffer[ret++];
-				stats->crypto_enq_fail++;
-				rte_pktmbuf_free(op->sym->m_src);
-				rte_crypto_op_free(op);
-			}
-
-			len = 0;
+		cdev_id = m_data->request_info.cdev_id;
+		qp_id = m_data->request_info.queue_pair_id;
+		qp_info = &adapter->cdevs[cdev_id].qpairs[qp_id];
+		if (!qp_info->qp_enabled) {
+			eca_crypto_op_drop(crypto_op);
+			continue;
 		}
 
-		if (qp_info)
-			qp_info->len = len;
-		n += ret;
+		if (qp_info->len == 0 && qp_info->flush_tmo_ticks)
+			qp_info->ts = rte_get_tsc_cycles();
+		qp_info->op_buffer[qp_info->len++] = crypto_op;
+		adapter->nb_buffered++;
+
+		if (qp_info->len >= qp_info->batch_size)
+			n += eca_qp_flush(adapter, cdev_id, qp_id, qp_info);
 	}
 
 	return n;
 }
 
+/* Enqueue the buffers of the queue pairs without a flush timeout, or only
+ * the expired buffers of the queue pairs with one
+ */
 static unsigned int
-eca_crypto_enq_flush(struct rte_event_crypto_adapter *adapter)
+eca_crypto_enq_flush(struct rte_event_crypto_adapter *adapter, bool expired)
 {
-	struct rte_event_crypto_adapter_stats *stats = &adapter->crypto_stats;
 	struct crypto_device_info *curr_dev;
 	struct crypto_queue_pair_info *curr_queue;
-	struct rte_crypto_op **op_buffer;
 	struct rte_cryptodev *dev;
 	uint8_t cdev_id;
 	uint16_t qp;
-	uint16_t ret;
+	unsigned int ret;
+	uint64_t now;
 	uint16_t num_cdev = rte_cryptodev_count();
 
 	ret = 0;
+	now = expired ? rte_get_tsc_cycles() : 0;
 	for (cdev_id = 0; cdev_id < num_cdev; cdev_id++) {
 		curr_dev = &adapter->cdevs[cdev_id];
 		dev = curr_dev->dev;
-		if (dev == NULL)
+		if (dev == NULL || curr_dev->qpairs == NULL)
 			continue;
 		for (qp = 0; qp < dev->data->nb_queue_pairs; qp++) {
 
 			curr_queue = &curr_dev->qpairs[qp];
-			if (!curr_queue->qp_enabled)
+			if (!curr_queue->qp_enabled || curr_queue->len == 0)
 				continue;
 
-			op_buffer = curr_queue->op_buffer;
-			ret = rte_cryptodev_enqueue_burst(cdev_id,
-							  qp,
-							  op_buffer,
-							  curr_queue->len);
-			stats->crypto_enq_count += ret;
-
-			while (ret < curr_queue->len) {
-				struct rte_crypto_op *op;
-				op = op_buffer[ret++];
-				stats->crypto_enq_fail++;
-				rte_pktmbuf_free(op->sym->m_src);
-				rte_crypto_op_free(op);
+			if (curr_queue->flush_tmo_ticks == 0) {
+				if (expired)
+					continue;
+			} else if (!expired || now - curr_queue->ts <
+				   curr_queue->flush_tmo_ticks) {
+				continue;
 			}
-			curr_queue->len = 0;
+
+			ret += eca_qp_flush(adapter, cdev_id, qp, curr_queue);
 		}
 	}
 
@@ -486,49 +538,89 @@ eca_crypto_adapter_enq_run(struct rte_event_crypto_adapter *adapter,
 		nb_enqueued += eca_enq_to_cryptodev(adapter, ev, n);
 	}
 
+	if (adapter->nb_buffered == 0)
+		return nb_enqueued;
+
+	if (adapter->flush_tmo_ticks) {
+		uint64_t now = rte_get_tsc_cycles();
+
+		if (now - adapter->prev_flush_ts >= adapter->flush_tmo_ticks) {
+			adapter->prev_flush_ts = now;
+			nb_enqueued += eca_crypto_enq_flush(adapter, true);
+		}
+	}
+
 	if ((++adapter->transmit_loop_count &
 		(CRYPTO_ENQ_FLUSH_THRESHOLD - 1)) == 0) {
-		nb_enqueued += eca_crypto_enq_flush(adapter);
+		nb_enqueued += eca_crypto_enq_flush(adapter, false);
 	}
 
 	return nb_enqueued;
 }
 
-static inline void
-eca_ops_enqueue_burst(struct rte_event_crypto_adapter *adapter,
-		  struct rte_crypto_op **ops, uint16_t num)
+/* Enqueue the buffered completion events to the event device */
+static void
+eca_event_buffer_flush(struct rte_event_crypto_adapter *adapter)
 {
 	struct rte_event_crypto_adapter_stats *stats = &adapter->crypto_stats;
-	union rte_event_crypto_metadata *m_data = NULL;
+	struct crypto_event_buffer *ebuf = &adapter->ebuf;
 	uint8_t event_dev_id = adapter->eventdev_id;
 	uint8_t event_port_id = adapter->event_port_id;
-	struct rte_event events[BATCH_SIZE];
 	uint16_t nb_enqueued, nb_ev;
 	uint8_t retry;
-	uint8_t i;
+	uint16_t i;
 
-	nb_ev = 0;
+	nb_ev = ebuf->count;
 	retry = 0;
 	nb_enqueued = 0;
+	do {
+		nb_enqueued += rte_event_enqueue_burst(event_dev_id,
+						  event_port_id,
+						  &ebuf->events[nb_enqueued],
+						  nb_ev - nb_enqueued);
+	} while (retry++ < CRYPTO_ADAPTER_MAX_EV_ENQ_RETRIES &&
+		 nb_enqueued < nb_ev);
+
+	/* Keep the events the event device did not take, the crypto
+	 * devices are not dequeued until they are enqueued
+	 */
+	for (i = nb_enqueued; i < nb_ev; i++)
+		ebuf->events[i - nb_enqueued] = ebuf->events[i];
+
+	stats->event_enq_fail_count += nb_ev - nb_enqueued;
+	stats->event_enq_count += nb_enqueued;
+	stats->event_enq_retry_count += retry - 1;
+	ebuf->count = nb_ev - nb_enqueued;
+}
+
+/* Add the completion events of crypto ops to the event buffer */
+static inline void
+eca_ops_enqueue_burst(struct rte_event_crypto_adapter *adapter,
+		  struct rte_crypto_op **ops, uint16_t num)
+{
+	struct crypto_event_buffer *ebuf = &adapter->ebuf;
+	union rte_event_crypto_metadata *m_data = NULL;
+	struct rte_cryptodev_sym_session *sess = NULL;
+	uint16_t i;
+
 	num = RTE_MIN(num, BATCH_SIZE);
 	for (i = 0; i < num; i++) {
-		struct rte_event *ev = &events[nb_ev++];
-		if (ops[i]->sess_type == RTE_CRYPTO_OP_WITH_SESSION) {
-			m_data = rte_cryptodev_sym_session_get_user_data(
-					ops[i]->sym->session);
-		} else if (ops[i]->sess_type == RTE_CRYPTO_OP_SESSIONLESS &&
-				ops[i]->private_data_offset) {
-			m_data = (union rte_event_crypto_metadata *)
-				 ((uint8_t *)ops[i] +
-				  ops[i]->private_data_offset);
+		struct rte_event *ev;
+
+		/* Consecutive ops of a session share its metadata */
+		if (ops[i]->sess_type != RTE_CRYPTO_OP_WITH_SESSION ||
+		    ops[i]->sym->session != sess) {
+			m_data = eca_crypto_op_metadata(ops[i]);
+			sess = ops[i]->sess_type ==
+				RTE_CRYPTO_OP_WITH_SESSION ?
+				ops[i]->sym->session : NULL;
 		}
-
 		if (unlikely(m_data == NULL)) {
-			rte_pktmbuf_free(ops[i]->sym->m_src);
-			rte_crypto_op_free(ops[i]);
+			eca_crypto_op_drop(ops[i]);
 			continue;
 		}
 
+		ev = &ebuf->events[ebuf->count++];
 		rte_memcpy(ev, &m_data->response_info, sizeof(*ev));
 		ev->event_ptr = ops[i];
 		ev->event_type = RTE_EVENT_TYPE_CRYPTODEV;
@@ -538,24 +630,11 @@ eca_ops_enqueue_burst(struct rte_event_crypto_adapter *adapter,
 			ev->op = RTE_EVENT_OP_NEW;
 	}
 
-	do {
-		nb_enqueued += rte_event_enqueue_burst(event_dev_id,
-						  event_port_id,
-						  &events[nb_enqueued],
-						  nb_ev - nb_enqueued);
-	} while (retry++ < CRYPTO_ADAPTER_MAX_EV_ENQ_RETRIES &&
-		 nb_enqueued < nb_ev);
-
-	/* Free mbufs and rte_crypto_ops for failed events */
-	for (i = nb_enqueued; i < nb_ev; i++) {
-		struct rte_crypto_op *op = events[i].event_ptr;
-		rte_pktmbuf_free(op->sym->m_src);
-		rte_crypto_op_free(op);
-	}
-
-	stats->event_enq_fail_count += nb_ev - nb_enqueued;
-	stats->event_enq_count += nb_enqueued;
-	stats->event_enq_retry_count += retry - 1;
+	/* Less than BATCH_SIZE events remain buffered, so that the next
+	 * burst of ops always fits in the buffer
+	 */
+	if (ebuf->count >= BATCH_SIZE)
+		eca_event_buffer_flush(adapter);
 }
 
 static inline unsigned int
@@ -573,6 +652,10 @@ eca_crypto_adapter_deq_run(struct rte_event_crypto_adapter *adapter,
 	bool done;
 	uint16_t num_cdev = rte_cryptodev_count();
 
+	/* Retry the events the event device did not take */
+	if (adapter->ebuf.count)
+		eca_event_buffer_flush(adapter);
+
 	nb_deq = 0;
 	do {
 		uint16_t queues = 0;
@@ -594,6 +677,10 @@ eca_crypto_adapter_deq_run(struct rte_event_crypto_adapter *adapter,
 				if (!curr_queue->qp_enabled)
 					continue;
 
+				/* Back pressure from the event device */
+				if (adapter->ebuf.count > BATCH_SIZE)
+					return nb_deq;
+
 				n = rte_cryptodev_dequeue_burst(cdev_id, qp,
 					ops, BATCH_SIZE);
 				if (!n)
@@ -613,11 +700,17 @@ eca_crypto_adapter_deq_run(struct rte_event_crypto_adapter *adapter,
 					curr_dev->next_queue_pair_id = (qp + 1)
 						% dev->data->nb_queue_pairs;
 
+					if (adapter->ebuf.count)
+						eca_event_buffer_flush(adapter);
 					return nb_deq;
 				}
 			}
 		}
 	} while (done == false);
+
+	if (adapter->ebuf.count)
+		eca_event_buffer_flush(adapter);
+
 	return nb_deq;
 }
 
@@ -723,6 +816,46 @@ eca_update_qp_info(struct rte_event_crypto_adapter *adapter,
 	}
 }
 
+static void
+eca_free_qpairs(struct crypto_device_info *dev_info)
+{
+	uint16_t i;
+
+	for (i = 0; i < dev_info->dev->data->nb_queue_pairs; i++)
+		rte_free(dev_info->qpairs[i].op_buffer);
+	rte_free(dev_info->qpairs);
+	dev_info->qpairs = NULL;
+}
+
+/* Recompute the interval of the queue pair flush timeout checks */
+static void
+eca_update_flush_tmo(struct rte_event_crypto_adapter *adapter)
+{
+	struct crypto_device_info *dev_info;
+	uint64_t tmo_ticks = 0;
+	uint16_t i, qp;
+
+	for (i = 0; i < rte_cryptodev_count(); i++) {
+		dev_info = &adapter->cdevs[i];
+		if (dev_info->dev == NULL || dev_info->qpairs == NULL)
+			continue;
+		for (qp = 0; qp < dev_info->dev->data->nb_queue_pairs; qp++) {
+			struct crypto_queue_pair_info *qp_info =
+				&dev_info->qpairs[qp];
+
+			if (!qp_info->qp_enabled || !qp_info->flush_tmo_ticks)
+				continue;
+			if (tmo_ticks == 0 || qp_info->flush_tmo_ticks < tmo_ticks)
+				tmo_ticks = qp_info->flush_tmo_ticks;
+		}
+	}
+
+	/* Check the timeouts twice per the shortest timeout */
+	adapter->flush_tmo_ticks = tmo_ticks >> 1;
+	if (tmo_ticks && adapter->flush_tmo_ticks == 0)
+		adapter->flush_tmo_ticks = 1;
+}
+
 static int
 eca_add_queue_pair(struct rte_event_crypto_adapter *adapter,
 		uint8_t cdev_id,
@@ -730,25 +863,30 @@ eca_add_queue_pair(struct rte_event_crypto_adapter *adapter,
 {
 	struct crypto_device_info *dev_info = &adapter->cdevs[cdev_id];
 	struct crypto_queue_pair_info *qpairs;
+	uint16_t nb_qps = dev_info->dev->data->nb_queue_pairs;
 	uint32_t i;
 
 	if (dev_info->qpairs == NULL) {
 		dev_info->qpairs =
 		    rte_zmalloc_socket(adapter->mem_name,
-					dev_info->dev->data->nb_queue_pairs *
+					nb_qps *
 					sizeof(struct crypto_queue_pair_info),
 					0, adapter->socket_id);
 		if (dev_info->qpairs == NULL)
 			return -ENOMEM;
 
 		qpairs = dev_info->qpairs;
-		qpairs->op_buffer = rte_zmalloc_socket(adapter->mem_name,
-					BATCH_SIZE *
+		for (i = 0; i < nb_qps; i++) {
+			qpairs[i].batch_size = BATCH_SIZE;
+			qpairs[i].op_buffer = rte_zmalloc_socket(
+					adapter->mem_name,
+					RTE_EVENT_CRYPTO_ADAPTER_MAX_BATCH_SIZE *
 					sizeof(struct rte_crypto_op *),
 					0, adapter->socket_id);
-		if (!qpairs->op_buffer) {
-			rte_free(qpairs);
-			return -ENOMEM;
+			if (qpairs[i].op_buffer == NULL) {
+				eca_free_qpairs(dev_info);
+				return -ENOMEM;
+			}
 		}
 	}
 
@@ -929,16 +1067,24 @@ rte_event_crypto_adapter_queue_pair_del(uint8_t id, uint8_t cdev_id,
 					&adapter->cdevs[cdev_id],
 					queue_pair_id,
 					0);
-			if (dev_info->num_qpairs == 0) {
-				rte_free(dev_info->qpairs);
-				dev_info->qpairs = NULL;
-			}
+			if (dev_info->num_qpairs == 0)
+				eca_free_qpairs(dev_info);
 		}
 	} else {
 		if (adapter->nb_qps == 0)
 			return 0;
 
 		rte_spinlock_lock(&adapter->lock);
+		if (dev_info->qpairs != NULL) {
+			for (i = 0; i < dev_info->dev->data->nb_queue_pairs;
+				i++) {
+				if (queue_pair_id != -1 && i != queue_pair_id)
+					continue;
+				eca_qp_flush(adapter, cdev_id, i,
+					     &dev_info->qpairs[i]);
+			}
+		}
+
 		if (queue_pair_id == -1) {
 			for (i = 0; i < dev_info->dev->data->nb_queue_pairs;
 				i++)
@@ -949,10 +1095,9 @@ rte_event_crypto_adapter_queue_pair_del(uint8_t id, uint8_t cdev_id,
 						(uint16_t)queue_pair_id, 0);
 		}
 
-		if (dev_info->num_qpairs == 0) {
-			rte_free(dev_info->qpairs);
-			dev_info->qpairs = NULL;
-		}
+		if (dev_info->num_qpairs == 0)
+			eca_free_qpairs(dev_info);
+		eca_update_flush_tmo(adapter);
 
 		rte_spinlock_unlock(&adapter->lock);
 		rte_service_component_runstate_set(adapter->service_id,
@@ -1128,3 +1273,75 @@ rte_event_crypto_adapter_event_port_get(uint8_t id, uint8_t *event_port_id)
 
 	return 0;
 }
+
+int
+rte_event_crypto_adapter_queue_pair_batch_config(uint8_t id, uint8_t cdev_id,
+	int32_t queue_pair_id,
+	const struct rte_event_crypto_adapter_queue_pair_batch_conf *conf)
+{
+	struct rte_event_crypto_adapter *adapter;
+	struct crypto_queue_pair_info *qp_info;
+	struct crypto_device_info *dev_info;
+	uint64_t tmo_ticks;
+	uint16_t nb_qps;
+	uint16_t i;
+	int ret;
+
+	EVENT_CRYPTO_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+
+	if (!rte_cryptodev_pmd_is_valid_dev(cdev_id)) {
+		RTE_EDEV_LOG_ERR("Invalid dev_id=%" PRIu8, cdev_id);
+		return -EINVAL;
+	}
+
+	adapter = eca_id_to_adapter(id);
+	if (adapter == NULL || conf == NULL)
+		return -EINVAL;
+
+	if (conf->batch_size == 0 ||
+	    conf->batch_size > RTE_EVENT_CRYPTO_ADAPTER_MAX_BATCH_SIZE) {
+		RTE_EDEV_LOG_ERR("Invalid batch size %" PRIu16,
+				 conf->batch_size);
+		return -EINVAL;
+	}
+
+	dev_info = &adapter->cdevs[cdev_id];
+	nb_qps = dev_info->dev->data->nb_queue_pairs;
+	if (queue_pair_id != -1 && (uint16_t)queue_pair_id >= nb_qps) {
+		RTE_EDEV_LOG_ERR("Invalid queue_pair_id %" PRIu16,
+				 (uint16_t)queue_pair_id);
+		return -EINVAL;
+	}
+
+	tmo_ticks = (conf->flush_timeout_ns * rte_get_tsc_hz()) / NS_PER_S;
+	if (conf->flush_timeout_ns && tmo_ticks == 0)
+		tmo_ticks = 1;
+
+	ret = -EINVAL;
+	rte_spinlock_lock(&adapter->lock);
+	if (dev_info->qpairs == NULL)
+		goto unlock;
+
+	for (i = 0; i < nb_qps; i++) {
+		if (queue_pair_id != -1 && i != queue_pair_id)
+			continue;
+
+		qp_info = &dev_info->qpairs[i];
+		if (!qp_info->qp_enabled)
+			continue;
+		if (qp_info->op_buffer == NULL) {
+			ret = -ENOTSUP;
+			goto unlock;
+		}
+
+		eca_qp_flush(adapter, cdev_id, i, qp_info);
+		qp_info->batch_size = conf->batch_size;
+		qp_info->flush_tmo_ticks = tmo_ticks;
+		ret = 0;
+	}
+	eca_update_flush_tmo(adapter);
+
+unlock:
+	rte_spinlock_unlock(&adapter->lock);
+	return ret;
+}
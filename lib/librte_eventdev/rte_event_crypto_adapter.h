@@ -138,6 +138,7 @@
  *  - rte_event_crypto_adapter_stop()
  *  - rte_event_crypto_adapter_stats_get()
  *  - rte_event_crypto_adapter_stats_reset()
+ *  - rte_event_crypto_adapter_queue_pair_batch_config()
 
  * The application creates an instance using rte_event_crypto_adapter_create()
  * or rte_event_crypto_adapter_create_ext().
@@ -162,6 +163,15 @@
  * The rte_crypto_op::private_data_offset provides an offset to locate the
  * request/response information in the rte_crypto_op. This offset is counted
  * from the start of the rte_crypto_op including initialization vector (IV).
+ *
+ * In RTE_EVENT_CRYPTO_ADAPTER_OP_FORWARD mode, the SW adapter buffers the
+ * crypto operations dequeued from the event device per cryptodev queue pair,
+ * and enqueues the buffer of a queue pair to the cryptodev once it holds a
+ * batch of operations, or once its oldest operation has waited for the flush
+ * timeout of the queue pair. Both are set with
+ * rte_event_crypto_adapter_queue_pair_batch_config(). The completed
+ * operations dequeued from all the queue pairs are enqueued to the event
+ * device together, in bursts.
  */
 
 #ifdef __cplusplus
@@ -406,6 +416,60 @@ rte_event_crypto_adapter_queue_pair_add(uint8_t id,
 			int32_t queue_pair_id,
 			const struct rte_event *event);
 
+/** Maximum batch size of a queue pair of the SW adapter */
+#define RTE_EVENT_CRYPTO_ADAPTER_MAX_BATCH_SIZE 128
+
+/**
+ * A structure used to configure the buffering of the crypto operations
+ * enqueued by the SW adapter to a cryptodev queue pair.
+ */
+struct rte_event_crypto_adapter_queue_pair_batch_conf {
+	uint16_t batch_size;
+	/**< Number of buffered crypto operations that triggers their enqueue
+	 * to the queue pair, from 1 to
+	 * RTE_EVENT_CRYPTO_ADAPTER_MAX_BATCH_SIZE. The default is 32.
+	 */
+	uint64_t flush_timeout_ns;
+	/**< Maximum time in nanoseconds a crypto operation waits in the buffer
+	 * of the queue pair before the buffer is enqueued to the queue pair.
+	 * Zero, the default, flushes the buffers of the adapter every 1024
+	 * service function iterations instead.
+	 */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Configure the buffering of the crypto operations enqueued by the SW
+ * adapter to a cryptodev queue pair in RTE_EVENT_CRYPTO_ADAPTER_OP_FORWARD
+ * mode. The queue pair must have been added to the adapter. Crypto
+ * operations already buffered for the queue pair are enqueued to it first.
+ *
+ * @param id
+ *  Adapter identifier.
+ *
+ * @param cdev_id
+ *  Cryptodev identifier.
+ *
+ * @param queue_pair_id
+ *  Cryptodev queue pair identifier. If queue_pair_id is set -1,
+ *  all the queue pairs of the cryptodev added to the adapter are configured.
+ *
+ * @param conf
+ *  Batch configuration of the queue pair.
+ *
+ * @return
+ *  - 0: Success, queue pair configured correctly.
+ *  - -EINVAL: Invalid parameters or queue pair not added to the adapter.
+ *  - -ENOTSUP: The queue pair is not serviced by the SW adapter.
+ */
+__rte_experimental
+int
+rte_event_crypto_adapter_queue_pair_batch_config(uint8_t id, uint8_t cdev_id,
+	int32_t queue_pair_id,
+	const struct rte_event_crypto_adapter_queue_pair_batch_conf *conf);
+
 /**
  * Delete a queue pair from an event crypto adapter.
  *
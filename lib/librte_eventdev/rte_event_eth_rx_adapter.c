@@ -5,6 +5,7 @@
 #if defined(LINUX)
 #include <sys/epoll.h>
 #endif
+#include <sys/queue.h>
 #include <unistd.h>
 
 #include <rte_cycles.h>
@@ -30,6 +31,23 @@
 #define ETH_RX_ADAPTER_MEM_NAME_LEN	32
 
 #define RSS_KEY_SIZE	40
+
+/* Event vector limits of the SW adapter */
+#define RXA_VECTOR_MIN_SZ		4
+#define RXA_VECTOR_MAX_SZ		1024
+#define RXA_VECTOR_MIN_TIMEOUT_NS	(10 * 1000ULL)
+#define RXA_VECTOR_MAX_TIMEOUT_NS	(1000 * 1000 * 1000ULL)
+/* Adaptive polling: maximum log2 of the bursts of a busy Rx queue per turn
+ * and of the rounds an idle Rx queue is skipped for
+ */
+#define RXA_ADAPTIVE_MAX_BURST_SHIFT	4
+#define RXA_ADAPTIVE_MAX_IDLE_SHIFT	6
+/* Adaptive polling: maximum rounds an idle Rx queue is skipped for */
+#define RXA_ADAPTIVE_MAX_SKIP		(1U << RXA_ADAPTIVE_MAX_IDLE_SHIFT)
+
+/* Flow id of the vectors of an Rx queue without an application flow id */
+#define RXA_VECTOR_FLOW_ID(port, queue)	\
+	((((port) & 0xff) << 12) | ((queue) & 0xfff))
 /* value written to intr thread pipe to signal thread exit */
 #define ETH_BRIDGE_INTR_THREAD_EXIT	1
 /* Sentinel value to detect initialized file handle */
@@ -56,8 +74,39 @@ struct eth_rx_poll_entry {
 	uint16_t eth_dev_id;
 	/* Eth rx queue to poll */
 	uint16_t eth_rx_qid;
+	/* Adaptive polling: log2 of the bursts allowed per turn */
+	uint8_t burst_shift;
+	/* Adaptive polling: log2 of the rounds skipped after an empty poll */
+	uint8_t idle_shift;
+	/* Adaptive polling: round of the next turn of the queue */
+	uint32_t next_round;
 };
 
+/*
+ * Event vector being filled for a vectorized Rx queue, linked in the
+ * adapter vector list while it holds mbufs
+ */
+struct eth_rx_vector_data {
+	TAILQ_ENTRY(eth_rx_vector_data) next;
+	/* Eth port and Rx queue of the vector mbufs */
+	uint16_t port;
+	uint16_t queue;
+	/* Number of mbufs that completes a vector */
+	uint16_t max_vector_count;
+	/* Event template of the vector events */
+	uint64_t event;
+	/* Timestamp of the first mbuf of the vector */
+	uint64_t ts;
+	/* Vector timeout in TSC cycles */
+	uint64_t vector_timeout_ticks;
+	/* Pool the vectors are allocated from */
+	struct rte_mempool *vector_pool;
+	/* Vector being filled, NULL if none */
+	struct rte_event_vector *vector_ev;
+} __rte_cache_aligned;
+
+TAILQ_HEAD(eth_rx_vector_data_list, eth_rx_vector_data);
+
 /* Instance per adapter */
 struct rte_eth_event_enqueue_buffer {
 	/* Count of events in this buffer */
@@ -89,8 +138,20 @@ struct rte_event_eth_rx_adapter {
 	uint32_t wrr_len;
 	/* Next entry in wrr[] to begin polling */
 	uint32_t wrr_pos;
+	/* Rx queue polling mode */
+	enum rte_event_eth_rx_adapter_poll_mode poll_mode;
+	/* Adaptive polling: next entry in eth_rx_poll[] to begin polling */
+	uint16_t poll_pos;
+	/* Adaptive polling: count of rounds over eth_rx_poll[] */
+	uint32_t poll_round;
 	/* Event burst buffer */
 	struct rte_eth_event_enqueue_buffer event_enqueue_buffer;
+	/* Vectors holding mbufs, in the order they were started */
+	struct eth_rx_vector_data_list vector_list;
+	/* Interval between vector timeout checks, in TSC cycles */
+	uint64_t vector_tmo_ticks;
+	/* Timestamp of the last vector timeout check */
+	uint64_t prev_expiry_ts;
 	/* Per adapter stats */
 	struct rte_event_eth_rx_adapter_stats stats;
 	/* Block count, counts up to BLOCK_CNT_THRESHOLD */
@@ -200,6 +261,10 @@ struct eth_rx_queue_info {
 	uint16_t wt;		/* Polling weight */
 	uint32_t flow_id_mask;	/* Set to ~0 if app provides flow id else 0 */
 	uint64_t event;
+	int vector_flag;	/* Added with the EVENT_VECTOR flag */
+	int ena_vector;		/* Event vectorization configured */
+	struct rte_event_eth_rx_adapter_queue_stats stats;
+	struct eth_rx_vector_data vector_data;
 };
 
 static struct rte_event_eth_rx_adapter **event_eth_rx_adapter;
@@ -589,6 +654,8 @@ rxa_calc_wrr_sequence(struct rte_event_eth_rx_adapter *rx_adapter,
 			wt = queue_info->wt;
 			rx_poll[poll_q].eth_dev_id = d;
 			rx_poll[poll_q].eth_rx_qid = q;
+			/* Due for polling in the current adaptive round */
+			rx_poll[poll_q].next_round = rx_adapter->poll_round;
 			max_wrr_pos += wt;
 			dev_info->wrr_len += wt;
 			max_wt = RTE_MAX(max_wt, wt);
@@ -741,6 +808,129 @@ rxa_flush_event_buffer(struct rte_event_eth_rx_adapter *rx_adapter)
 	return n;
 }
 
+static inline void
+rxa_init_vector(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_vector_data *vec)
+{
+	vec->vector_ev->nb_elem = 0;
+	vec->vector_ev->port = vec->port;
+	vec->vector_ev->queue = vec->queue;
+	vec->vector_ev->attr_valid = 1;
+	vec->ts = rte_get_tsc_cycles();
+	TAILQ_INSERT_TAIL(&rx_adapter->vector_list, vec, next);
+}
+
+/* Turn the vector being filled into an event */
+static inline void
+rxa_vector_to_event(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_vector_data *vec,
+		struct rte_event *ev)
+{
+	ev->event = vec->event;
+	ev->vec = vec->vector_ev;
+	vec->vector_ev = NULL;
+	TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
+}
+
+/* Add mbufs to the vector of an Rx queue, returns the number of
+ * completed vector events written to ev
+ */
+static inline uint16_t
+rxa_create_event_vector(struct rte_event_eth_rx_adapter *rx_adapter,
+			struct eth_rx_queue_info *queue_info,
+			struct rte_event *ev,
+			struct rte_mbuf **mbufs,
+			uint16_t num)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	uint16_t filled = 0;
+
+	while (num) {
+		struct rte_event_vector *v;
+		uint16_t sz;
+
+		if (vec->vector_ev == NULL) {
+			if (unlikely(rte_mempool_get(vec->vector_pool,
+					(void **)&vec->vector_ev) < 0)) {
+				vec->vector_ev = NULL;
+				rte_pktmbuf_free_bulk(mbufs, num);
+				rx_adapter->stats.rx_dropped += num;
+				break;
+			}
+			rxa_init_vector(rx_adapter, vec);
+		}
+
+		v = vec->vector_ev;
+		sz = RTE_MIN(num, (uint16_t)(vec->max_vector_count -
+					v->nb_elem));
+		memcpy(&v->mbufs[v->nb_elem], mbufs,
+			sz * sizeof(struct rte_mbuf *));
+		v->nb_elem += sz;
+		mbufs += sz;
+		num -= sz;
+
+		if (v->nb_elem == vec->max_vector_count)
+			rxa_vector_to_event(rx_adapter, vec, &ev[filled++]);
+	}
+
+	return filled;
+}
+
+/* Enqueue the vectors that have waited for their timeout */
+static void
+rxa_vector_expire(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct rte_eth_event_enqueue_buffer *buf =
+					&rx_adapter->event_enqueue_buffer;
+	struct eth_rx_vector_data *vec;
+	struct eth_rx_vector_data *next;
+	uint64_t now;
+
+	now = rte_get_tsc_cycles();
+	if (now - rx_adapter->prev_expiry_ts < rx_adapter->vector_tmo_ticks)
+		return;
+	rx_adapter->prev_expiry_ts = now;
+
+	for (vec = TAILQ_FIRST(&rx_adapter->vector_list); vec != NULL;
+			vec = next) {
+		next = TAILQ_NEXT(vec, next);
+
+		if (now - vec->ts < vec->vector_timeout_ticks)
+			continue;
+
+		if (buf->count == ETH_EVENT_BUFFER_SIZE) {
+			rxa_flush_event_buffer(rx_adapter);
+			if (buf->count == ETH_EVENT_BUFFER_SIZE)
+				break;
+		}
+
+		rxa_vector_to_event(rx_adapter, vec,
+				&buf->events[buf->count]);
+		buf->count++;
+	}
+
+	if (buf->count > 0)
+		rxa_flush_event_buffer(rx_adapter);
+}
+
+/* Drop the vector being filled for an Rx queue, if any */
+static void
+rxa_vector_free(struct rte_event_eth_rx_adapter *rx_adapter,
+		struct eth_rx_queue_info *queue_info)
+{
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+
+	if (vec->vector_ev != NULL) {
+		rx_adapter->stats.rx_dropped += vec->vector_ev->nb_elem;
+		rte_pktmbuf_free_bulk(vec->vector_ev->mbufs,
+				vec->vector_ev->nb_elem);
+		rte_mempool_put(vec->vector_pool, vec->vector_ev);
+		vec->vector_ev = NULL;
+		TAILQ_REMOVE(&rx_adapter->vector_list, vec, next);
+	}
+	queue_info->ena_vector = 0;
+}
+
 static inline void
 rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		uint16_t eth_dev_id,
@@ -780,20 +970,27 @@ rxa_buffer_mbufs(struct rte_event_eth_rx_adapter *rx_adapter,
 		}
 	}
 
-	for (i = 0; i < num; i++) {
-		m = mbufs[i];
+	if (eth_rx_queue_info->ena_vector) {
+		num = rxa_create_event_vector(rx_adapter, eth_rx_queue_info,
+					ev, mbufs, num);
+	} else {
+		struct rte_event *e = ev;
+
+		for (i = 0; i < num; i++) {
+			m = mbufs[i];
 
-		rss = do_rss ?
-			rxa_do_softrss(m, rx_adapter->rss_key_be) :
-			m->hash.rss;
-		ev->event = event;
-		ev->flow_id = (rss & ~flow_id_mask) |
-				(ev->flow_id & flow_id_mask);
-		ev->mbuf = m;
-		ev++;
+			rss = do_rss ?
+				rxa_do_softrss(m, rx_adapter->rss_key_be) :
+				m->hash.rss;
+			e->event = event;
+			e->flow_id = (rss & ~flow_id_mask) |
+					(e->flow_id & flow_id_mask);
+			e->mbuf = m;
+			e++;
+		}
 	}
 
-	if (dev_info->cb_fn) {
+	if (num && dev_info->cb_fn) {
 
 		dropped = 0;
 		nb_cb = dev_info->cb_fn(eth_dev_id, rx_queue_id,
@@ -825,6 +1022,8 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 					&rx_adapter->event_enqueue_buffer;
 	struct rte_event_eth_rx_adapter_stats *stats =
 					&rx_adapter->stats;
+	struct rte_event_eth_rx_adapter_queue_stats *q_stats =
+		&rx_adapter->eth_devices[port_id].rx_queue[queue_id].stats;
 	uint16_t n;
 	uint32_t nb_rx = 0;
 
@@ -838,8 +1037,10 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 			rxa_flush_event_buffer(rx_adapter);
 
 		stats->rx_poll_count++;
+		q_stats->rx_poll_count++;
 		n = rte_eth_rx_burst(port_id, queue_id, mbufs, BATCH_SIZE);
 		if (unlikely(!n)) {
+			q_stats->rx_empty_poll_count++;
 			if (rxq_empty)
 				*rxq_empty = 1;
 			break;
@@ -849,6 +1050,7 @@ rxa_eth_rx(struct rte_event_eth_rx_adapter *rx_adapter,
 		if (rx_count + nb_rx > max_rx)
 			break;
 	}
+	q_stats->rx_packets += nb_rx;
 
 	if (buf->count > 0)
 		rxa_flush_event_buffer(rx_adapter);
@@ -1134,6 +1336,103 @@ rxa_poll(struct rte_event_eth_rx_adapter *rx_adapter)
 	return nb_rx;
 }
 
+/*
+ * Polls the Rx queues in turn, each for as many bursts as its adaptive
+ * credit allows. A queue left with packets at the end of its turn doubles
+ * its credit, an empty queue is skipped for an exponentially growing
+ * number of rounds, so that the service cost follows the busy queues
+ * rather than the number of queues.
+ */
+static uint32_t
+rxa_poll_adaptive(struct rte_event_eth_rx_adapter *rx_adapter)
+{
+	struct rte_eth_event_enqueue_buffer *buf;
+	uint32_t num_queue;
+	uint32_t nb_rx = 0;
+	uint32_t max_nb_rx;
+	uint32_t round;
+	uint16_t nb_polled;
+	uint16_t pos;
+
+	pos = rx_adapter->poll_pos;
+	round = rx_adapter->poll_round;
+	nb_polled = rx_adapter->num_rx_polled;
+	max_nb_rx = rx_adapter->max_nb_rx;
+	buf = &rx_adapter->event_enqueue_buffer;
+
+	/* The poll array may have shrunk since the last call */
+	if (pos >= nb_polled)
+		pos = 0;
+
+	for (num_queue = 0; num_queue < nb_polled; num_queue++) {
+		struct eth_rx_poll_entry *pe = &rx_adapter->eth_rx_poll[pos];
+		struct eth_rx_queue_info *queue_info;
+		uint32_t skip;
+		uint32_t n;
+		int empty;
+
+		/* Skipped while its next turn is at most one skip ahead, a
+		 * bounded window that is immune to the round counter wrapping
+		 */
+		if ((uint32_t)(pe->next_round - round - 1) <=
+				RXA_ADAPTIVE_MAX_SKIP)
+			goto next_queue;
+
+		/* Don't do a batch dequeue from the rx queue if there isn't
+		 * enough space in the enqueue buffer.
+		 */
+		if (buf->count >= BATCH_SIZE)
+			rxa_flush_event_buffer(rx_adapter);
+		if (BATCH_SIZE > (ETH_EVENT_BUFFER_SIZE - buf->count))
+			break;
+
+		n = rxa_eth_rx(rx_adapter, pe->eth_dev_id, pe->eth_rx_qid,
+			nb_rx, RTE_MIN(max_nb_rx,
+				nb_rx + (BATCH_SIZE << pe->burst_shift) - 1),
+			&empty);
+		nb_rx += n;
+
+		if (n == 0) {
+			/* Idle queue, back off */
+			queue_info = &rx_adapter->eth_devices[pe->eth_dev_id]
+					.rx_queue[pe->eth_rx_qid];
+			skip = 1U << pe->idle_shift;
+			queue_info->stats.rx_skip_count += skip;
+			pe->next_round = round + 1 + skip;
+			pe->burst_shift = 0;
+			if (pe->idle_shift < RXA_ADAPTIVE_MAX_IDLE_SHIFT)
+				pe->idle_shift++;
+		} else if (!empty) {
+			/* Packets left after the turn, boost the queue */
+			pe->idle_shift = 0;
+			if (pe->burst_shift < RXA_ADAPTIVE_MAX_BURST_SHIFT)
+				pe->burst_shift++;
+		} else {
+			pe->idle_shift = 0;
+			if (pe->burst_shift > 0)
+				pe->burst_shift--;
+		}
+
+		if (nb_rx > max_nb_rx) {
+			if (++pos == nb_polled) {
+				pos = 0;
+				round++;
+			}
+			break;
+		}
+
+next_queue:
+		if (++pos == nb_polled) {
+			pos = 0;
+			round++;
+		}
+	}
+
+	rx_adapter->poll_pos = pos;
+	rx_adapter->poll_round = round;
+	return nb_rx;
+}
+
 static int
 rxa_service_func(void *args)
 {
@@ -1149,7 +1448,12 @@ rxa_service_func(void *args)
 
 	stats = &rx_adapter->stats;
 	stats->rx_packets += rxa_intr_ring_dequeue(rx_adapter);
-	stats->rx_packets += rxa_poll(rx_adapter);
+	if (rx_adapter->poll_mode == RTE_EVENT_ETH_RX_ADAPTER_POLL_ADAPTIVE)
+		stats->rx_packets += rxa_poll_adaptive(rx_adapter);
+	else
+		stats->rx_packets += rxa_poll(rx_adapter);
+	if (!TAILQ_EMPTY(&rx_adapter->vector_list))
+		rxa_vector_expire(rx_adapter);
 	rte_spinlock_unlock(&rx_adapter->rx_lock);
 	return 0;
 }
@@ -1676,6 +1980,8 @@ rxa_sw_del(struct rte_event_eth_rx_adapter *rx_adapter,
 	pollq = rxa_polled_queue(dev_info, rx_queue_id);
 	intrq = rxa_intr_queue(dev_info, rx_queue_id);
 	sintrq = rxa_shared_intr(dev_info, rx_queue_id);
+	rxa_vector_free(rx_adapter, &dev_info->rx_queue[rx_queue_id]);
+	dev_info->rx_queue[rx_queue_id].vector_flag = 0;
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 0);
 	rx_adapter->num_rx_polled -= pollq;
 	dev_info->nb_rx_poll -= pollq;
@@ -1713,6 +2019,7 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 
 	queue_info = &dev_info->rx_queue[rx_queue_id];
 	queue_info->wt = conf->servicing_weight;
+	memset(&queue_info->stats, 0, sizeof(queue_info->stats));
 
 	qi_ev = (struct rte_event *)&queue_info->event;
 	qi_ev->event = ev->event;
@@ -1726,6 +2033,11 @@ rxa_add_queue(struct rte_event_eth_rx_adapter *rx_adapter,
 	} else
 		qi_ev->flow_id = 0;
 
+	/* The vector parameters have to be configured again */
+	rxa_vector_free(rx_adapter, queue_info);
+	queue_info->vector_flag = !!(conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR);
+
 	rxa_update_queue(rx_adapter, dev_info, rx_queue_id, 1);
 	if (rxa_polled_queue(dev_info, rx_queue_id)) {
 		rx_adapter->num_rx_polled += !pollq;
@@ -1977,6 +2289,7 @@ rte_event_eth_rx_adapter_create_ext(uint8_t id, uint8_t dev_id,
 	rx_adapter->conf_cb = conf_cb;
 	rx_adapter->conf_arg = conf_arg;
 	rx_adapter->id = id;
+	TAILQ_INIT(&rx_adapter->vector_list);
 	strcpy(rx_adapter->mem_name, mem_name);
 	rx_adapter->eth_devices = rte_zmalloc_socket(rx_adapter->mem_name,
 					RTE_MAX_ETHPORTS *
@@ -2088,6 +2401,15 @@ rte_event_eth_rx_adapter_queue_add(uint8_t id,
 		return -EINVAL;
 	}
 
+	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR) == 0 &&
+		(queue_conf->rx_queue_flags &
+			RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR)) {
+		RTE_EDEV_LOG_ERR("Event vectorization is not supported,"
+				" eth port: %" PRIu16 " adapter id: %" PRIu8,
+				eth_dev_id, id);
+		return -EINVAL;
+	}
+
 	if ((cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ) == 0 &&
 		(rx_queue_id != -1)) {
 		RTE_EDEV_LOG_ERR("Rx queues can only be connected to single "
@@ -2409,3 +2731,248 @@ rte_event_eth_rx_adapter_cb_register(uint8_t id,
 
 	return 0;
 }
+
+static void
+rxa_sw_event_vector_configure(
+	struct rte_event_eth_rx_adapter *rx_adapter, uint16_t eth_dev_id,
+	int rx_queue_id,
+	const struct rte_event_eth_rx_adapter_event_vector_config *config)
+{
+	struct eth_device_info *dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	struct eth_rx_queue_info *queue_info = &dev_info->rx_queue[rx_queue_id];
+	struct eth_rx_vector_data *vec = &queue_info->vector_data;
+	struct rte_event *qi_ev;
+	uint64_t tmo_ticks;
+
+	rxa_vector_free(rx_adapter, queue_info);
+
+	vec->event = queue_info->event;
+	qi_ev = (struct rte_event *)&vec->event;
+	qi_ev->event_type = RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR;
+	if (queue_info->flow_id_mask == 0)
+		qi_ev->flow_id = RXA_VECTOR_FLOW_ID(eth_dev_id, rx_queue_id);
+
+	vec->port = eth_dev_id;
+	vec->queue = rx_queue_id;
+	vec->max_vector_count = config->vector_sz;
+	vec->vector_pool = config->vector_mp;
+	vec->vector_timeout_ticks = (config->vector_timeout_ns *
+				rte_get_tsc_hz()) / NS_PER_S;
+
+	/* Check the vector timeouts twice per the shortest timeout */
+	tmo_ticks = vec->vector_timeout_ticks >> 1;
+	rx_adapter->vector_tmo_ticks = rx_adapter->vector_tmo_ticks ?
+		RTE_MIN(tmo_ticks, rx_adapter->vector_tmo_ticks) : tmo_ticks;
+
+	queue_info->ena_vector = 1;
+}
+
+int
+rte_event_eth_rx_adapter_vector_limits_get(
+	uint8_t dev_id, uint16_t eth_port_id,
+	struct rte_event_eth_rx_adapter_vector_limits *limits)
+{
+	uint32_t cap;
+	int ret;
+
+	RTE_EVENTDEV_VALID_DEVID_OR_ERR_RET(dev_id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_port_id, -EINVAL);
+
+	if (limits == NULL)
+		return -EINVAL;
+
+	ret = rte_event_eth_rx_adapter_caps_get(dev_id, eth_port_id, &cap);
+	if (ret) {
+		RTE_EDEV_LOG_ERR("Failed to get adapter caps edev %" PRIu8
+			"eth port %" PRIu16, dev_id, eth_port_id);
+		return ret;
+	}
+
+	if (cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_INTERNAL_PORT)
+		return -ENOTSUP;
+
+	limits->min_sz = RXA_VECTOR_MIN_SZ;
+	limits->max_sz = RXA_VECTOR_MAX_SZ;
+	limits->log2_sz = 0;
+	limits->min_timeout_ns = RXA_VECTOR_MIN_TIMEOUT_NS;
+	limits->max_timeout_ns = RXA_VECTOR_MAX_TIMEOUT_NS;
+
+	return 0;
+}
+
+int
+rte_event_eth_rx_adapter_queue_event_vector_config(
+	uint8_t id, uint16_t eth_dev_id, int32_t rx_queue_id,
+	struct rte_event_eth_rx_adapter_event_vector_config *config)
+{
+	struct rte_event_eth_rx_adapter_vector_limits limits;
+	struct rte_event_eth_rx_adapter *rx_adapter;
+	struct eth_device_info *dev_info;
+	uint32_t cap;
+	uint16_t i;
+	int ret;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if ((rx_adapter == NULL) || (config == NULL))
+		return -EINVAL;
+
+	ret = rte_event_eth_rx_adapter_caps_get(rx_adapter->eventdev_id,
+						eth_dev_id, &cap);
+	if (ret) {
+		RTE_EDEV_LOG_ERR("Failed to get adapter caps edev %" PRIu8
+			"eth port %" PRIu16, id, eth_dev_id);
+		return ret;
+	}
+
+	if (!(cap & RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR)) {
+		RTE_EDEV_LOG_ERR("Event vectorization is not supported,"
+				" eth port: %" PRIu16 " adapter id: %" PRIu8,
+				eth_dev_id, id);
+		return -ENOTSUP;
+	}
+
+	ret = rte_event_eth_rx_adapter_vector_limits_get(
+		rx_adapter->eventdev_id, eth_dev_id, &limits);
+	if (ret) {
+		RTE_EDEV_LOG_ERR("Failed to get vector limits edev %" PRIu8
+				"eth port %" PRIu16,
+				rx_adapter->eventdev_id, eth_dev_id);
+		return ret;
+	}
+
+	if (config->vector_sz < limits.min_sz ||
+	    config->vector_sz > limits.max_sz ||
+	    config->vector_timeout_ns < limits.min_timeout_ns ||
+	    config->vector_timeout_ns > limits.max_timeout_ns ||
+	    config->vector_mp == NULL) {
+		RTE_EDEV_LOG_ERR("Invalid event vector configuration,"
+				" eth port: %" PRIu16 " adapter id: %" PRIu8,
+				eth_dev_id, id);
+		return -EINVAL;
+	}
+
+	if (config->vector_mp->elt_size < (sizeof(struct rte_event_vector) +
+			(sizeof(uintptr_t) * config->vector_sz))) {
+		RTE_EDEV_LOG_ERR("Vector pool elements too small for %" PRIu16
+				" mbufs, eth port: %" PRIu16
+				" adapter id: %" PRIu8,
+				config->vector_sz, eth_dev_id, id);
+		return -EINVAL;
+	}
+
+	dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	if (dev_info->rx_queue == NULL)
+		return -EINVAL;
+
+	if (rx_queue_id != -1 && (uint16_t)rx_queue_id >=
+			dev_info->dev->data->nb_rx_queues) {
+		RTE_EDEV_LOG_ERR("Invalid rx queue_id %" PRIu16,
+			 (uint16_t)rx_queue_id);
+		return -EINVAL;
+	}
+
+	rte_spinlock_lock(&rx_adapter->rx_lock);
+	if (rx_queue_id == -1) {
+		for (i = 0; i < dev_info->dev->data->nb_rx_queues; i++)
+			if (dev_info->rx_queue[i].vector_flag)
+				rxa_sw_event_vector_configure(rx_adapter,
+						eth_dev_id, i, config);
+	} else if (dev_info->rx_queue[rx_queue_id].vector_flag) {
+		rxa_sw_event_vector_configure(rx_adapter, eth_dev_id,
+					      rx_queue_id, config);
+	} else {
+		RTE_EDEV_LOG_ERR("Rx queue %" PRIu16 " not added with the"
+				" event vector flag", (uint16_t)rx_queue_id);
+		ret = -EINVAL;
+	}
+	rte_spinlock_unlock(&rx_adapter->rx_lock);
+
+	return ret;
+}
+
+int
+rte_event_eth_rx_adapter_poll_mode_set(uint8_t id,
+				enum rte_event_eth_rx_adapter_poll_mode mode)
+{
+	struct rte_event_eth_rx_adapter *rx_adapter;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if (rx_adapter == NULL)
+		return -EINVAL;
+
+	if (mode != RTE_EVENT_ETH_RX_ADAPTER_POLL_WRR &&
+	    mode != RTE_EVENT_ETH_RX_ADAPTER_POLL_ADAPTIVE)
+		return -EINVAL;
+
+	rte_spinlock_lock(&rx_adapter->rx_lock);
+	rx_adapter->poll_mode = mode;
+	rte_spinlock_unlock(&rx_adapter->rx_lock);
+
+	return 0;
+}
+
+static int
+rxa_queue_stats_info(uint8_t id, uint16_t eth_dev_id, uint16_t rx_queue_id,
+		     struct eth_rx_queue_info **queue_info)
+{
+	struct rte_event_eth_rx_adapter *rx_adapter;
+	struct eth_device_info *dev_info;
+
+	RTE_EVENT_ETH_RX_ADAPTER_ID_VALID_OR_ERR_RET(id, -EINVAL);
+	RTE_ETH_VALID_PORTID_OR_ERR_RET(eth_dev_id, -EINVAL);
+
+	rx_adapter = rxa_id_to_adapter(id);
+	if (rx_adapter == NULL)
+		return -EINVAL;
+
+	dev_info = &rx_adapter->eth_devices[eth_dev_id];
+	if (dev_info->rx_queue == NULL ||
+	    rx_queue_id >= dev_info->dev->data->nb_rx_queues ||
+	    !dev_info->rx_queue[rx_queue_id].queue_enabled)
+		return -EINVAL;
+
+	if (dev_info->internal_event_port)
+		return -ENOTSUP;
+
+	*queue_info = &dev_info->rx_queue[rx_queue_id];
+	return 0;
+}
+
+int
+rte_event_eth_rx_adapter_queue_stats_get(uint8_t id,
+			uint16_t eth_dev_id, uint16_t rx_queue_id,
+			struct rte_event_eth_rx_adapter_queue_stats *stats)
+{
+	struct eth_rx_queue_info *queue_info;
+	int ret;
+
+	if (stats == NULL)
+		return -EINVAL;
+
+	ret = rxa_queue_stats_info(id, eth_dev_id, rx_queue_id, &queue_info);
+	if (ret)
+		return ret;
+
+	*stats = queue_info->stats;
+	return 0;
+}
+
+int
+rte_event_eth_rx_adapter_queue_stats_reset(uint8_t id,
+			uint16_t eth_dev_id, uint16_t rx_queue_id)
+{
+	struct eth_rx_queue_info *queue_info;
+	int ret;
+
+	ret = rxa_queue_stats_info(id, eth_dev_id, rx_queue_id, &queue_info);
+	if (ret)
+		return ret;
+
+	memset(&queue_info->stats, 0, sizeof(queue_info->stats));
+	return 0;
+}
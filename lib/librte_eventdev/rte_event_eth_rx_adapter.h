@@ -37,6 +37,11 @@
  *  - rte_event_eth_rx_adapter_stop()
  *  - rte_event_eth_rx_adapter_stats_get()
  *  - rte_event_eth_rx_adapter_stats_reset()
+ *  - rte_event_eth_rx_adapter_vector_limits_get()
+ *  - rte_event_eth_rx_adapter_queue_event_vector_config()
+ *  - rte_event_eth_rx_adapter_poll_mode_set()
+ *  - rte_event_eth_rx_adapter_queue_stats_get()
+ *  - rte_event_eth_rx_adapter_queue_stats_reset()
  *
  * The application creates an ethernet to event adapter using
  * rte_event_eth_rx_adapter_create_ext() or rte_event_eth_rx_adapter_create()
@@ -77,6 +82,15 @@
  * allows the application to register a callback that selects which packets are
  * enqueued to the event device by the SW adapter. The callback interface is
  * event based so the callback can also modify the event data if it needs to.
+ *
+ * When the RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR capability is set, an
+ * Rx queue may be added with the RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR
+ * flag and configured with the
+ * rte_event_eth_rx_adapter_queue_event_vector_config() function. The adapter
+ * then aggregates the mbufs received on the queue into event vectors of up to
+ * the configured size, and enqueues a vector event once it is full or once
+ * its oldest mbuf has waited for the configured timeout, which amortizes the
+ * event device cost over the mbufs of the vector.
  */
 
 #ifdef __cplusplus
@@ -96,6 +110,10 @@ extern "C" {
 /**< This flag indicates the flow identifier is valid
  * @see rte_event_eth_rx_adapter_queue_conf::rx_queue_flags
  */
+#define RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR	0x2
+/**< This flag indicates that mbufs arriving on the queue need to be vectorized
+ * @see rte_event_eth_rx_adapter_queue_event_vector_config()
+ */
 
 /**
  * Adapter configuration structure that the adapter configuration callback
@@ -173,6 +191,57 @@ struct rte_event_eth_rx_adapter_queue_conf {
 	 */
 };
 
+/**
+ * Rx queue event vector configuration structure
+ */
+struct rte_event_eth_rx_adapter_event_vector_config {
+	uint16_t vector_sz;
+	/**< Indicates the maximum number for mbufs to combine and form a vector.
+	 * Should be within
+	 * @see rte_event_eth_rx_adapter_vector_limits::min_vector_sz
+	 * @see rte_event_eth_rx_adapter_vector_limits::max_vector_sz
+	 */
+	uint64_t vector_timeout_ns;
+	/**<
+	 * Indicates the maximum number of nanoseconds to wait for receiving
+	 * mbufs. Should be within vectorization limits of the
+	 * adapter
+	 * @see rte_event_eth_rx_adapter_vector_limits::min_vector_timeout_ns
+	 * @see rte_event_eth_rx_adapter_vector_limits::max_vector_timeout_ns
+	 */
+	struct rte_mempool *vector_mp;
+	/**< Indicates the mempool that should be used for allocating
+	 * rte_event_vector container.
+	 * Should be created by using `rte_event_vector_pool_create`.
+	 */
+};
+
+/**
+ * A structure used to retrieve event vector limits of an adapter
+ */
+struct rte_event_eth_rx_adapter_vector_limits {
+	uint16_t min_sz;
+	/**< Minimum vector limit configurable.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_sz
+	 */
+	uint16_t max_sz;
+	/**< Maximum vector limit configurable.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_sz
+	 */
+	uint8_t log2_sz;
+	/**< True if the size configured should be in log2.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_sz
+	 */
+	uint64_t min_timeout_ns;
+	/**< Minimum vector timeout configurable.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_timeout_ns
+	 */
+	uint64_t max_timeout_ns;
+	/**< Maximum vector timeout configurable.
+	 * @see rte_event_eth_rx_adapter_event_vector_config::vector_timeout_ns
+	 */
+};
+
 /**
  * A structure used to retrieve statistics for an eth rx adapter instance.
  */
@@ -203,6 +272,39 @@ struct rte_event_eth_rx_adapter_stats {
 	/**< Received packet count for interrupt mode Rx queues */
 };
 
+/**
+ * Rx queue polling mode of the SW adapter service function.
+ */
+enum rte_event_eth_rx_adapter_poll_mode {
+	RTE_EVENT_ETH_RX_ADAPTER_POLL_WRR,
+	/**< Poll the Rx queues in a weighted round robin sequence built from
+	 * their servicing weights. This is the default mode.
+	 */
+	RTE_EVENT_ETH_RX_ADAPTER_POLL_ADAPTIVE,
+	/**< Poll the Rx queues in turn, ignoring their servicing weights.
+	 * A queue found empty is skipped for an exponentially growing
+	 * number of rounds over the Rx queues, and a queue left with packets
+	 * after its turn is allowed more bursts on its next turns.
+	 */
+};
+
+/**
+ * A structure used to retrieve the statistics of an Rx queue of an eth rx
+ * adapter instance using a SW service function.
+ */
+struct rte_event_eth_rx_adapter_queue_stats {
+	uint64_t rx_packets;
+	/**< Received packet count */
+	uint64_t rx_poll_count;
+	/**< Receive queue poll count */
+	uint64_t rx_empty_poll_count;
+	/**< Count of the receive queue polls which returned no packet */
+	uint64_t rx_skip_count;
+	/**< Count of the turns of the receive queue skipped by the
+	 * RTE_EVENT_ETH_RX_ADAPTER_POLL_ADAPTIVE polling mode
+	 */
+};
+
 /**
  *
  * Callback function invoked by the SW adapter before it continues
@@ -471,6 +573,141 @@ int rte_event_eth_rx_adapter_cb_register(uint8_t id, uint16_t eth_dev_id,
 					 rte_event_eth_rx_adapter_cb_fn cb_fn,
 					 void *cb_arg);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the event vector limits of the adapter for an ethernet device.
+ * Vectorization is supported for SW based packet transfers only.
+ *
+ * @param dev_id
+ *  Event device identifier.
+ * @param eth_port_id
+ *  Port identifier of the ethernet device.
+ * @param [out] limits
+ *  A pointer to rte_event_eth_rx_adapter_vector_limits structure that has to
+ *  be filled.
+ *
+ * @return
+ *  - 0: Success.
+ *  - -EINVAL: Invalid parameters.
+ *  - -ENOTSUP: The event device transfers the packets of the ethernet device
+ *    with an internal port.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_vector_limits_get(
+	uint8_t dev_id, uint16_t eth_port_id,
+	struct rte_event_eth_rx_adapter_vector_limits *limits);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Configure event vectorization for a given ethernet device queue, that has
+ * been added to the adapter with the
+ * RTE_EVENT_ETH_RX_ADAPTER_QUEUE_EVENT_VECTOR flag set.
+ *
+ * The adapter enqueues events of type RTE_EVENT_TYPE_ETH_RX_ADAPTER_VECTOR
+ * for the queue once it is configured. All the mbufs of a vector come from
+ * the same ethernet port and queue, which are set in the vector attributes,
+ * and share the flow identifier of the event. If the
+ * RTE_EVENT_ETH_RX_ADAPTER_QUEUE_FLOW_ID_VALID flag is not set, the flow
+ * identifier is derived from the ethernet port and queue identifiers.
+ *
+ * The consumer of the vector events is responsible for returning the vectors
+ * to their mempool.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param eth_dev_id
+ *  Port identifier of Ethernet device.
+ * @param rx_queue_id
+ *  Ethernet device receive queue index.
+ *  If rx_queue_id is -1, then all Rx queues configured for the ethernet device
+ *  are configured with the event vectorization parameters.
+ * @param config
+ *  Event vector configuration structure.
+ *
+ * @return
+ *  - 0: Success, Receive queue configured correctly.
+ *  - <0: Error code on failure.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_queue_event_vector_config(
+	uint8_t id, uint16_t eth_dev_id, int32_t rx_queue_id,
+	struct rte_event_eth_rx_adapter_event_vector_config *config);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Set the Rx queue polling mode of the adapter service function. The
+ * mode does not apply to the Rx queues added in interrupt mode, or to the
+ * ethernet devices transferring packets with an internal event port.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param mode
+ *  Rx queue polling mode.
+ *
+ * @return
+ *  - 0: Success.
+ *  - -EINVAL: Invalid adapter identifier or polling mode.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_poll_mode_set(uint8_t id,
+				enum rte_event_eth_rx_adapter_poll_mode mode);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve the statistics of an Rx queue polled by the adapter service
+ * function. The statistics are reset when the queue is added to the
+ * adapter.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param eth_dev_id
+ *  Port identifier of Ethernet device.
+ * @param rx_queue_id
+ *  Ethernet device receive queue index.
+ * @param [out] stats
+ *  A pointer to structure used to retrieve statistics for the queue.
+ *
+ * @return
+ *  - 0: Success, retrieved successfully.
+ *  - -EINVAL: Invalid parameters or queue not added to the adapter.
+ *  - -ENOTSUP: The queue is not serviced by the adapter service function.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_queue_stats_get(uint8_t id,
+			uint16_t eth_dev_id, uint16_t rx_queue_id,
+			struct rte_event_eth_rx_adapter_queue_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reset the statistics of an Rx queue polled by the adapter service
+ * function.
+ *
+ * @param id
+ *  Adapter identifier.
+ * @param eth_dev_id
+ *  Port identifier of Ethernet device.
+ * @param rx_queue_id
+ *  Ethernet device receive queue index.
+ *
+ * @return
+ *  - 0: Success, statistics reset successfully.
+ *  - -EINVAL: Invalid parameters or queue not added to the adapter.
+ *  - -ENOTSUP: The queue is not serviced by the adapter service function.
+ */
+__rte_experimental
+int rte_event_eth_rx_adapter_queue_stats_reset(uint8_t id,
+			uint16_t eth_dev_id, uint16_t rx_queue_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -509,6 +509,51 @@ txa_service_buffer_retry(struct rte_mbuf **pkts, uint16_t unsent,
 	stats->tx_dropped += unsent - sent;
 }
 
+/* Transmit the mbufs of an event vector and free the vector */
+static uint16_t
+txa_service_tx_vector(struct txa_service_data *txa,
+		struct rte_event_vector *vec)
+{
+	struct txa_service_queue_info *tqi;
+	struct rte_mbuf *m;
+	uint16_t nb_tx;
+	uint16_t port;
+	uint16_t queue;
+	uint16_t i;
+
+	nb_tx = 0;
+	tqi = NULL;
+	port = vec->port;
+	queue = vec->queue;
+	if (vec->attr_valid) {
+		tqi = txa_service_queue(txa, port, queue);
+		if (unlikely(tqi == NULL || !tqi->added)) {
+			rte_pktmbuf_free_bulk(vec->mbufs, vec->nb_elem);
+			goto out;
+		}
+	}
+
+	for (i = 0; i < vec->nb_elem; i++) {
+		m = vec->mbufs[i];
+
+		if (!vec->attr_valid) {
+			port = m->port;
+			queue = rte_event_eth_tx_adapter_txq_get(m);
+			tqi = txa_service_queue(txa, port, queue);
+			if (unlikely(tqi == NULL || !tqi->added)) {
+				rte_pktmbuf_free(m);
+				continue;
+			}
+		}
+
+		nb_tx += rte_eth_tx_buffer(port, queue, tqi->tx_buf, m);
+	}
+
+out:
+	rte_mempool_put(rte_mempool_from_obj(vec), vec);
+	return nb_tx;
+}
+
 static void
 txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
 	uint32_t n)
@@ -526,6 +571,11 @@ txa_service_tx(struct txa_service_data *txa, struct rte_event *ev,
 		uint16_t queue;
 		struct txa_service_queue_info *tqi;
 
+		if (ev[i].event_type & RTE_EVENT_TYPE_VECTOR) {
+			nb_tx += txa_service_tx_vector(txa, ev[i].vec);
+			continue;
+		}
+
 		m = ev[i].mbuf;
 		port = m->port;
 		queue = rte_event_eth_tx_adapter_txq_get(m);
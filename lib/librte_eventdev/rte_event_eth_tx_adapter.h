@@ -68,6 +68,13 @@
  * and rte_event_eth_tx_adapter_txq_get() functions to access the transmit
  * queue index, using these macros will help with minimizing application
  * impact due to a change in how the transmit queue index is specified.
+ *
+ * The common implementation also transmits the mbufs of events of type
+ * RTE_EVENT_TYPE_VECTOR. If the rte_event_vector::attr_valid bit of the
+ * vector is set, all its mbufs are transmitted on the port and queue of
+ * the vector, otherwise the port and queue are taken from each mbuf as
+ * above. The vector is returned to its mempool once its mbufs have been
+ * buffered for transmission.
  */
 
 #ifdef __cplusplus
@@ -19,6 +19,9 @@
 #include <rte_timer.h>
 #include <rte_service_component.h>
 #include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_prefetch.h>
+#include <rte_spinlock.h>
 
 #include "rte_eventdev.h"
 #include "rte_eventdev_pmd.h"
@@ -35,6 +38,7 @@ static int evtim_buffer_logtype;
 static struct rte_event_timer_adapter adapters[RTE_EVENT_TIMER_ADAPTER_NUM_MAX];
 
 static const struct rte_event_timer_adapter_ops swtim_ops;
+static const struct rte_event_timer_adapter_ops swtim_batched_ops;
 
 #define EVTIM_LOG(level, logtype, ...) \
 	rte_log(RTE_LOG_ ## level, logtype, \
@@ -211,7 +215,9 @@ rte_event_timer_adapter_create_ext(
 	 * implementation.
 	 */
 	if (adapter->ops == NULL)
-		adapter->ops = &swtim_ops;
+		adapter->ops = adapter->data->conf.flags &
+			RTE_EVENT_TIMER_ADAPTER_F_BATCHED ?
+			&swtim_batched_ops : &swtim_ops;
 
 	/* Allow driver to do some setup */
 	FUNC_PTR_OR_NULL_RET_WITH_ERRNO(adapter->ops->init, ENOTSUP);
@@ -340,7 +346,9 @@ rte_event_timer_adapter_lookup(uint16_t adapter_id)
 	 * implementation.
 	 */
 	if (adapter->ops == NULL)
-		adapter->ops = &swtim_ops;
+		adapter->ops = adapter->data->conf.flags &
+			RTE_EVENT_TIMER_ADAPTER_F_BATCHED ?
+			&swtim_batched_ops : &swtim_ops;
 
 	/* Set fast-path function pointers */
 	adapter->arm_burst = adapter->ops->arm_burst;
@@ -476,7 +484,7 @@ event_buffer_add(struct event_buffer *bufp, struct rte_event *eventp)
 
 static void
 event_buffer_flush(struct event_buffer *bufp, uint8_t dev_id, uint8_t port_id,
-		   uint16_t *nb_events_flushed,
+		   uint16_t batch_sz, uint16_t *nb_events_flushed,
 		   uint16_t *nb_events_inv)
 {
 	struct rte_event *events = bufp->events;
@@ -503,7 +511,7 @@ event_buffer_flush(struct event_buffer *bufp, uint8_t dev_id, uint8_t port_id,
 		return;
 	}
 
-	n = RTE_MIN(EVENT_BUFFER_BATCHSZ, n);
+	n = RTE_MIN(batch_sz, n);
 	*nb_events_inv = 0;
 
 	*nb_events_flushed = rte_event_enqueue_burst(dev_id, port_id,
@@ -524,6 +532,55 @@ event_buffer_flush(struct event_buffer *bufp, uint8_t dev_id, uint8_t port_id,
 	bufp->tail = bufp->tail + *nb_events_flushed + *nb_events_inv;
 }
 
+/*
+ * Batched software event timer adapter: the lcores arming event timers
+ * hand them to the service through a ring of their own, and the service
+ * keeps them in a wheel of adapter ticks. Each bucket of the wheel holds
+ * the event timers expiring in a tick, or a multiple of the wheel size
+ * later, in chunks of entries. Canceling an event timer only clears its
+ * expiry tick, and the service drops the stale entries.
+ */
+#define SWTIM_RING_MAX_SZ (64 * 1024)
+#define SWTIM_DRAIN_BURST 64U
+#define SWTIM_CHUNK_SZ 63
+#define SWTIM_WHEEL_MAX_BUCKETS 4096
+#define SWTIM_PREFETCH_OFFSET 4
+
+struct swtim_entry {
+	struct rte_event_timer *evtim;
+	/* Expiry tick the event timer was armed with */
+	uint64_t tick;
+};
+
+struct swtim_chunk {
+	struct swtim_chunk *next;
+	uint32_t nb_entries;
+	struct swtim_entry entries[SWTIM_CHUNK_SZ];
+};
+
+struct swtim_wheel {
+	/* Timer cycles per adapter tick */
+	uint64_t cycles_per_tick;
+	/* Next tick to process */
+	uint64_t now;
+	/* Number of buckets minus one, the number being a power of 2 */
+	uint64_t mask;
+	/* Arm rings of the lcores, the last one for non-EAL threads */
+	struct rte_ring *rings[RTE_MAX_LCORE + 1];
+	/* Serializes the non-EAL threads arming event timers */
+	rte_spinlock_t any_lock;
+	/* Rings to drain, and their number */
+	struct rte_ring *poll_rings[RTE_MAX_LCORE + 1];
+	unsigned int nb_rings;
+	/* Free chunks, and their number */
+	struct swtim_chunk *free_chunks;
+	unsigned int nb_free_chunks;
+	/* Memory of the chunks */
+	struct swtim_chunk *chunks;
+	/* Chunk being filled of each bucket, followed by the full ones */
+	struct swtim_chunk *buckets[];
+};
+
 /*
  * Software event timer adapter implementation
  */
@@ -560,6 +617,8 @@ struct swtim {
 	struct rte_timer *expired_timers[EXP_TIM_BUF_SZ];
 	/* The number of timers that can be returned to a mempool */
 	size_t n_expired_timers;
+	/* Wheel of the batched adapter, NULL when using rte_timer */
+	struct swtim_wheel *wheel;
 };
 
 static inline struct swtim *
@@ -626,6 +685,7 @@ swtim_callback(struct rte_timer *tim)
 		event_buffer_flush(&sw->buffer,
 				   adapter->data->event_dev_id,
 				   adapter->data->event_port_id,
+				   EVENT_BUFFER_BATCHSZ,
 				   &nb_evs_flushed,
 				   &nb_evs_invalid);
 
@@ -735,6 +795,7 @@ swtim_service_func(void *arg)
 		event_buffer_flush(&sw->buffer,
 				   adapter->data->event_dev_id,
 				   adapter->data->event_port_id,
+				   EVENT_BUFFER_BATCHSZ,
 				   &nb_evs_flushed,
 				   &nb_evs_invalid);
 
@@ -746,6 +807,274 @@ swtim_service_func(void *arg)
 	return 0;
 }
 
+static inline void
+swtim_chunk_free(struct swtim_wheel *w, struct swtim_chunk *chunk)
+{
+	chunk->next = w->free_chunks;
+	w->free_chunks = chunk;
+	w->nb_free_chunks++;
+}
+
+/* Add an entry to the bucket of its tick, the current one if past */
+static inline void
+swtim_wheel_insert(struct swtim_wheel *w, struct rte_event_timer *evtim,
+		   uint64_t tick)
+{
+	struct swtim_chunk **bucket;
+	struct swtim_chunk *chunk;
+
+	bucket = &w->buckets[RTE_MAX(tick, w->now) & w->mask];
+	chunk = *bucket;
+	if (chunk == NULL || chunk->nb_entries == SWTIM_CHUNK_SZ) {
+		chunk = w->free_chunks;
+		w->free_chunks = chunk->next;
+		w->nb_free_chunks--;
+
+		chunk->nb_entries = 0;
+		chunk->next = *bucket;
+		*bucket = chunk;
+	}
+
+	chunk->entries[chunk->nb_entries].evtim = evtim;
+	chunk->entries[chunk->nb_entries].tick = tick;
+	chunk->nb_entries++;
+}
+
+/* Move the event timers armed since the last call to the wheel */
+static void
+swtim_wheel_drain(struct swtim_wheel *w)
+{
+	struct rte_event_timer *evtims[SWTIM_DRAIN_BURST];
+	unsigned int i, j, n;
+	uint64_t tick;
+
+	for (i = 0; i < w->nb_rings; i++) {
+		do {
+			/* an entry takes at most one more chunk */
+			n = rte_ring_sc_dequeue_burst(w->poll_rings[i],
+				(void **)evtims,
+				RTE_MIN(w->nb_free_chunks, SWTIM_DRAIN_BURST),
+				NULL);
+
+			for (j = 0; j < n; j++)
+				rte_prefetch0(&evtims[j]->impl_opaque[0]);
+
+			for (j = 0; j < n; j++) {
+				tick = __atomic_load_n(
+					&evtims[j]->impl_opaque[0],
+					__ATOMIC_ACQUIRE);
+				/* zero if already canceled */
+				if (tick != 0)
+					swtim_wheel_insert(w, evtims[j], tick);
+			}
+		} while (n == SWTIM_DRAIN_BURST);
+	}
+}
+
+/* Expire the entries of the bucket of a tick due at tick cur. Return -1
+ * if the event buffer filled up before the end of the bucket.
+ */
+static int
+swtim_wheel_expire(struct swtim *sw, uint64_t tick, uint64_t cur)
+{
+	struct swtim_wheel *w = sw->wheel;
+	struct swtim_chunk **bucket = &w->buckets[tick & w->mask];
+	struct swtim_chunk *chunk, *next_chunk;
+	struct rte_event_timer *evtim;
+	struct swtim_entry *e;
+	uint32_t i, nb_kept;
+	uint64_t expected;
+	int ret = 0;
+
+	chunk = *bucket;
+	*bucket = NULL;
+	for (; chunk != NULL; chunk = next_chunk) {
+		next_chunk = chunk->next;
+		nb_kept = 0;
+
+		for (i = 0; i < chunk->nb_entries; i++) {
+			e = &chunk->entries[i];
+			if (i + SWTIM_PREFETCH_OFFSET < chunk->nb_entries)
+				rte_prefetch0(chunk->entries[i +
+					SWTIM_PREFETCH_OFFSET].evtim);
+
+			/* Keep the entries of the next rounds of the wheel,
+			 * and these the event buffer cannot take for now.
+			 */
+			if (e->tick > cur || event_buffer_full(&sw->buffer)) {
+				if (e->tick <= cur)
+					ret = -1;
+				chunk->entries[nb_kept++] = *e;
+				continue;
+			}
+
+			/* Clearing the expiry tick claims the event timer,
+			 * unless it was canceled or armed again since.
+			 */
+			evtim = e->evtim;
+			expected = e->tick;
+			if (!__atomic_compare_exchange_n(&evtim->impl_opaque[0],
+					&expected, 0, false, __ATOMIC_ACQUIRE,
+					__ATOMIC_RELAXED))
+				continue;
+
+			event_buffer_add(&sw->buffer, &evtim->ev);
+			__atomic_store_n(&evtim->state,
+					 RTE_EVENT_TIMER_NOT_ARMED,
+					 __ATOMIC_RELEASE);
+			sw->stats.evtim_exp_count++;
+		}
+
+		if (nb_kept == 0) {
+			swtim_chunk_free(w, chunk);
+		} else {
+			chunk->nb_entries = nb_kept;
+			chunk->next = *bucket;
+			*bucket = chunk;
+		}
+	}
+
+	return ret;
+}
+
+/* Enqueue the buffered expiry events in bursts as large as the event
+ * device takes them.
+ */
+static void
+swtim_batched_flush(struct rte_event_timer_adapter *adapter,
+		    struct swtim *sw)
+{
+	uint16_t nb_evs_flushed, nb_evs_invalid;
+
+	do {
+		nb_evs_flushed = 0;
+		nb_evs_invalid = 0;
+		event_buffer_flush(&sw->buffer,
+				   adapter->data->event_dev_id,
+				   adapter->data->event_port_id,
+				   EVENT_BUFFER_SZ,
+				   &nb_evs_flushed,
+				   &nb_evs_invalid);
+
+		sw->stats.ev_enq_count += nb_evs_flushed;
+		sw->stats.ev_inv_count += nb_evs_invalid;
+	} while (nb_evs_flushed + nb_evs_invalid > 0);
+}
+
+static int
+swtim_batched_service_func(void *arg)
+{
+	struct rte_event_timer_adapter *adapter = arg;
+	struct swtim *sw = swtim_pmd_priv(adapter);
+	struct swtim_wheel *w = sw->wheel;
+	uint64_t cur, next, nb_ticks, i;
+
+	/* Expiry events the event device could not take come first */
+	swtim_batched_flush(adapter, sw);
+
+	swtim_wheel_drain(w);
+
+	cur = rte_get_timer_cycles() / w->cycles_per_tick;
+	if (cur < w->now)
+		return 0;
+
+	/* Past a revolution, every bucket is due at tick cur */
+	nb_ticks = RTE_MIN(cur - w->now + 1, w->mask + 1);
+	for (i = 0; i < nb_ticks; i++)
+		if (swtim_wheel_expire(sw, w->now + i, cur) < 0)
+			break;
+
+	next = i == nb_ticks ? cur + 1 : w->now + i;
+	sw->stats.adapter_tick_count += next - w->now;
+	w->now = next;
+
+	swtim_batched_flush(adapter, sw);
+
+	return 0;
+}
+
+static void
+swtim_wheel_free(struct swtim *sw)
+{
+	struct swtim_wheel *w = sw->wheel;
+	unsigned int i;
+
+	for (i = 0; i < w->nb_rings; i++)
+		rte_free(w->poll_rings[i]);
+	rte_free(w->chunks);
+	rte_free(w);
+	sw->wheel = NULL;
+}
+
+static int
+swtim_wheel_create(struct rte_event_timer_adapter *adapter, struct swtim *sw)
+{
+	const struct rte_event_timer_adapter_conf *conf = &adapter->data->conf;
+	int socket_id = adapter->data->socket_id;
+	char name[RTE_RING_NAMESIZE];
+	uint64_t nb_buckets, nb_chunks, i;
+	struct swtim_wheel *w;
+	struct rte_ring *r;
+	unsigned int lcore_id, ring_cnt;
+	ssize_t ring_sz;
+
+	/* One bucket per tick up to the maximum timeout, if not too many */
+	nb_buckets = rte_align64pow2(conf->max_tmo_ns / conf->timer_tick_ns +
+				     1);
+	nb_buckets = RTE_MIN(nb_buckets, (uint64_t)SWTIM_WHEEL_MAX_BUCKETS);
+
+	w = rte_zmalloc_socket("swtim_wheel",
+			sizeof(*w) + nb_buckets * sizeof(w->buckets[0]),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (w == NULL)
+		return -ENOMEM;
+	sw->wheel = w;
+
+	w->mask = nb_buckets - 1;
+	w->cycles_per_tick = RTE_MAX((uint64_t)(sw->timer_tick_ns *
+		rte_get_timer_hz() / NSECPERSEC), UINT64_C(1));
+	w->now = rte_get_timer_cycles() / w->cycles_per_tick;
+	rte_spinlock_init(&w->any_lock);
+
+	/* Room for the timers, and a chunk being filled per bucket */
+	nb_chunks = conf->nb_timers / SWTIM_CHUNK_SZ + 2 * nb_buckets;
+	w->chunks = rte_malloc_socket("swtim_chunks",
+			nb_chunks * sizeof(w->chunks[0]),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (w->chunks == NULL)
+		goto free_wheel;
+	for (i = 0; i < nb_chunks; i++)
+		swtim_chunk_free(w, &w->chunks[i]);
+
+	/* A ring takes a burst of all the timers, if not too many */
+	ring_cnt = RTE_MIN(rte_align64pow2(conf->nb_timers + 1),
+			   (uint64_t)SWTIM_RING_MAX_SZ);
+	ring_sz = rte_ring_get_memsize(ring_cnt);
+	for (lcore_id = 0; lcore_id <= RTE_MAX_LCORE; lcore_id++) {
+		if (lcore_id < RTE_MAX_LCORE &&
+		    rte_eal_lcore_role(lcore_id) == ROLE_OFF)
+			continue;
+
+		r = rte_zmalloc_socket("swtim_ring", ring_sz,
+				RTE_CACHE_LINE_SIZE, socket_id);
+		if (r == NULL)
+			goto free_wheel;
+		snprintf(name, sizeof(name), "swtim_%"PRIu8"_%u",
+			 adapter->data->id, lcore_id);
+		rte_ring_init(r, name, ring_cnt,
+			      RING_F_SP_ENQ | RING_F_SC_DEQ);
+
+		w->rings[lcore_id] = r;
+		w->poll_rings[w->nb_rings++] = r;
+	}
+
+	return 0;
+
+free_wheel:
+	swtim_wheel_free(sw);
+	return -ENOMEM;
+}
+
 /* The adapter initialization function rounds the mempool size up to the next
  * power of 2, so we can take the difference between that value and what the
  * user requested, and use the space for caches.  This avoids a scenario where a
@@ -804,6 +1133,16 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 	sw->timer_tick_ns = adapter->data->conf.timer_tick_ns;
 	sw->max_tmo_ns = adapter->data->conf.max_tmo_ns;
 
+	if (adapter->data->conf.flags & RTE_EVENT_TIMER_ADAPTER_F_BATCHED) {
+		ret = swtim_wheel_create(adapter, sw);
+		if (ret < 0) {
+			EVTIM_LOG_ERR("failed to create timer wheel");
+			rte_errno = -ret;
+			goto free_alloc;
+		}
+		goto init_buffer;
+	}
+
 	/* Create a timer pool */
 	char pool_name[SWTIM_NAMESIZE];
 	snprintf(pool_name, SWTIM_NAMESIZE, "swtim_pool_%"PRIu8,
@@ -844,6 +1183,7 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 		goto free_mempool;
 	}
 
+init_buffer:
 	/* Initialize timer event buffer */
 	event_buffer_init(&sw->buffer);
 
@@ -854,7 +1194,8 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 	snprintf(service.name, RTE_SERVICE_NAME_MAX,
 		 "swtim_svc_%"PRIu8, adapter->data->id);
 	service.socket_id = adapter->data->socket_id;
-	service.callback = swtim_service_func;
+	service.callback = sw->wheel != NULL ? swtim_batched_service_func :
+		swtim_service_func;
 	service.callback_userdata = adapter;
 	service.capabilities &= ~(RTE_SERVICE_CAP_MT_SAFE);
 	ret = rte_service_component_register(&service, &sw->service_id);
@@ -875,7 +1216,10 @@ swtim_init(struct rte_event_timer_adapter *adapter)
 
 	return 0;
 free_mempool:
-	rte_mempool_free(sw->tim_pool);
+	if (sw->wheel != NULL)
+		swtim_wheel_free(sw);
+	else
+		rte_mempool_free(sw->tim_pool);
 free_alloc:
 	rte_free(sw);
 	return -1;
@@ -899,11 +1243,12 @@ swtim_uninit(struct rte_event_timer_adapter *adapter)
 	struct swtim *sw = swtim_pmd_priv(adapter);
 
 	/* Free outstanding timers */
-	rte_timer_stop_all(sw->timer_data_id,
-			   sw->poll_lcores,
-			   sw->n_poll_lcores,
-			   swtim_free_tim,
-			   sw);
+	if (sw->wheel == NULL)
+		rte_timer_stop_all(sw->timer_data_id,
+				   sw->poll_lcores,
+				   sw->n_poll_lcores,
+				   swtim_free_tim,
+				   sw);
 
 	ret = rte_service_component_unregister(sw->service_id);
 	if (ret < 0) {
@@ -911,7 +1256,10 @@ swtim_uninit(struct rte_event_timer_adapter *adapter)
 		return ret;
 	}
 
-	rte_mempool_free(sw->tim_pool);
+	if (sw->wheel != NULL)
+		swtim_wheel_free(sw);
+	else
+		rte_mempool_free(sw->tim_pool);
 	rte_free(sw);
 	adapter->data->adapter_priv = NULL;
 
@@ -1184,6 +1532,172 @@ static const struct rte_event_timer_adapter_ops swtim_ops = {
 	.cancel_burst		= swtim_cancel_burst,
 };
 
+static uint16_t
+__swtim_batched_arm_burst(const struct rte_event_timer_adapter *adapter,
+			  struct rte_event_timer **evtims,
+			  uint16_t nb_evtims)
+{
+	struct swtim *sw = swtim_pmd_priv(adapter);
+	struct swtim_wheel *w = sw->wheel;
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t now_tick;
+	struct rte_ring *r;
+	uint16_t i, n;
+	int ret;
+
+#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
+	/* Check that the service is running. */
+	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+#endif
+
+	/* Non-EAL threads share the last ring */
+	if (lcore_id == LCORE_ID_ANY || w->rings[lcore_id] == NULL) {
+		rte_spinlock_lock(&w->any_lock);
+		r = w->rings[RTE_MAX_LCORE];
+	} else
+		r = w->rings[lcore_id];
+
+	/* Single producer: all the room is ours */
+	n = RTE_MIN(nb_evtims, rte_ring_free_count(r));
+	if (n < nb_evtims)
+		rte_errno = ENOSPC;
+
+	/* Round up, not to expire early */
+	now_tick = (rte_get_timer_cycles() + w->cycles_per_tick - 1) /
+		w->cycles_per_tick;
+
+	for (i = 0; i < n; i++) {
+		/* Don't modify the event timer state in these cases */
+		if (evtims[i]->state == RTE_EVENT_TIMER_ARMED) {
+			rte_errno = EALREADY;
+			break;
+		} else if (!(evtims[i]->state == RTE_EVENT_TIMER_NOT_ARMED ||
+			     evtims[i]->state == RTE_EVENT_TIMER_CANCELED)) {
+			rte_errno = EINVAL;
+			break;
+		}
+
+		ret = check_timeout(evtims[i], adapter);
+		if (unlikely(ret == -1)) {
+			evtims[i]->state = RTE_EVENT_TIMER_ERROR_TOOLATE;
+			rte_errno = EINVAL;
+			break;
+		} else if (unlikely(ret == -2)) {
+			evtims[i]->state = RTE_EVENT_TIMER_ERROR_TOOEARLY;
+			rte_errno = EINVAL;
+			break;
+		}
+
+		if (unlikely(check_destination_event_queue(evtims[i],
+							   adapter) < 0)) {
+			evtims[i]->state = RTE_EVENT_TIMER_ERROR;
+			rte_errno = EINVAL;
+			break;
+		}
+
+		evtims[i]->impl_opaque[1] = (uintptr_t)adapter;
+		evtims[i]->state = RTE_EVENT_TIMER_ARMED;
+		/* A non-zero expiry tick makes the event timer pending */
+		__atomic_store_n(&evtims[i]->impl_opaque[0],
+				 now_tick + evtims[i]->timeout_ticks,
+				 __ATOMIC_RELEASE);
+	}
+
+	rte_ring_sp_enqueue_burst(r, (void * const *)evtims, i, NULL);
+
+	if (r == w->rings[RTE_MAX_LCORE])
+		rte_spinlock_unlock(&w->any_lock);
+
+	return i;
+}
+
+static uint16_t
+swtim_batched_arm_burst(const struct rte_event_timer_adapter *adapter,
+			struct rte_event_timer **evtims,
+			uint16_t nb_evtims)
+{
+	return __swtim_batched_arm_burst(adapter, evtims, nb_evtims);
+}
+
+static uint16_t
+swtim_batched_arm_tmo_tick_burst(const struct rte_event_timer_adapter *adapter,
+				 struct rte_event_timer **evtims,
+				 uint64_t timeout_ticks,
+				 uint16_t nb_evtims)
+{
+	int i;
+
+	for (i = 0; i < nb_evtims; i++)
+		evtims[i]->timeout_ticks = timeout_ticks;
+
+	return __swtim_batched_arm_burst(adapter, evtims, nb_evtims);
+}
+
+static uint16_t
+swtim_batched_cancel_burst(const struct rte_event_timer_adapter *adapter,
+			   struct rte_event_timer **evtims,
+			   uint16_t nb_evtims)
+{
+	uint64_t tick;
+	int i;
+
+#ifdef RTE_LIBRTE_EVENTDEV_DEBUG
+	/* Check that the service is running. */
+	if (rte_service_runstate_get(adapter->data->service_id) != 1) {
+		rte_errno = EINVAL;
+		return 0;
+	}
+#else
+	RTE_SET_USED(adapter);
+#endif
+
+	for (i = 0; i < nb_evtims; i++) {
+		/* Don't modify the event timer state in these cases */
+		if (evtims[i]->state == RTE_EVENT_TIMER_CANCELED) {
+			rte_errno = EALREADY;
+			break;
+		} else if (evtims[i]->state != RTE_EVENT_TIMER_ARMED) {
+			rte_errno = EINVAL;
+			break;
+		}
+
+		/* Clear the expiry tick before the service claims it */
+		tick = __atomic_load_n(&evtims[i]->impl_opaque[0],
+				       __ATOMIC_RELAXED);
+		if (tick == 0 ||
+		    !__atomic_compare_exchange_n(&evtims[i]->impl_opaque[0],
+				&tick, 0, false, __ATOMIC_RELAXED,
+				__ATOMIC_RELAXED)) {
+			/* Timer is expiring */
+			rte_errno = EAGAIN;
+			break;
+		}
+
+		evtims[i]->state = RTE_EVENT_TIMER_CANCELED;
+		evtims[i]->impl_opaque[1] = 0;
+
+		rte_smp_wmb();
+	}
+
+	return i;
+}
+
+static const struct rte_event_timer_adapter_ops swtim_batched_ops = {
+	.init			= swtim_init,
+	.uninit			= swtim_uninit,
+	.start			= swtim_start,
+	.stop			= swtim_stop,
+	.get_info		= swtim_get_info,
+	.stats_get		= swtim_stats_get,
+	.stats_reset		= swtim_stats_reset,
+	.arm_burst		= swtim_batched_arm_burst,
+	.arm_tmo_tick_burst	= swtim_batched_arm_tmo_tick_burst,
+	.cancel_burst		= swtim_batched_cancel_burst,
+};
+
 RTE_INIT(event_timer_adapter_init_log)
 {
 	evtim_logtype = rte_log_register("lib.eventdev.adapter.timer");
@@ -149,6 +149,19 @@ enum rte_event_timer_adapter_clk_src {
  *
  * @see struct rte_event_timer_adapter_conf::flags
  */
+#define RTE_EVENT_TIMER_ADAPTER_F_BATCHED	(1ULL << 2)
+/**< @warning @b EXPERIMENTAL: this flag may change without prior notice
+ *
+ * Use the batched variant of the software event timer adapter, when the
+ * event device provides no timer adapter of its own. Each lcore hands the
+ * event timers it arms to the adapter service through a ring of its own,
+ * without taking a lock, and the service enqueues the expiry events in
+ * large bursts. Canceled event timers are dropped lazily, so the memory of
+ * an event timer must remain valid while the adapter runs, e.g. by
+ * allocating event timers from a mempool.
+ *
+ * @see struct rte_event_timer_adapter_conf::flags
+ */
 
 /**
  * Timer adapter configuration structure
@@ -68,7 +68,8 @@ extern "C" {
 
 #define RTE_EVENT_ETH_RX_ADAPTER_SW_CAP \
 		((RTE_EVENT_ETH_RX_ADAPTER_CAP_OVERRIDE_FLOW_ID) | \
-			(RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ))
+			(RTE_EVENT_ETH_RX_ADAPTER_CAP_MULTI_EVENTQ) | \
+			(RTE_EVENT_ETH_RX_ADAPTER_CAP_EVENT_VECTOR))
 
 #define RTE_EVENT_CRYPTO_ADAPTER_SW_CAP \
 		RTE_EVENT_CRYPTO_ADAPTER_CAP_SESSION_PRIVATE_DATA
@@ -16,7 +16,7 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 {
 	struct gro_tcp4_tbl *tbl;
 	size_t size;
-	uint32_t entries_num, i;
+	uint32_t entries_num, buckets_num;
 
 	entries_num = max_flow_num * max_item_per_flow;
 	entries_num = RTE_MIN(entries_num, GRO_TCP4_TBL_MAX_ITEM_NUM);
@@ -52,14 +52,55 @@ gro_tcp4_tbl_create(uint16_t socket_id,
 		rte_free(tbl);
 		return NULL;
 	}
-	/* INVALID_ARRAY_INDEX indicates an empty flow */
-	for (i = 0; i < entries_num; i++)
-		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
 
+	/* one hash bucket per flow, at least */
+	buckets_num = rte_align32pow2(entries_num);
+	size = sizeof(uint32_t) * buckets_num;
+	tbl->flow_hash = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->flow_hash == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->flow_hash_mask = buckets_num - 1;
+
+	gro_tcp4_tbl_reset(tbl);
+
 	return tbl;
 }
 
+void
+gro_tcp4_tbl_reset(struct gro_tcp4_tbl *tbl)
+{
+	uint32_t i;
+
+	/* chain all items and flows into the empty lists */
+	for (i = 0; i < tbl->max_item_num; i++) {
+		tbl->items[i].firstseg = NULL;
+		tbl->items[i].next_pkt_idx = i + 1;
+	}
+	tbl->items[tbl->max_item_num - 1].next_pkt_idx = INVALID_ARRAY_INDEX;
+	tbl->free_item_idx = 0;
+	tbl->item_num = 0;
+
+	/* INVALID_ARRAY_INDEX indicates an empty flow */
+	for (i = 0; i < tbl->max_flow_num; i++) {
+		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
+		tbl->flows[i].next_flow_idx = i + 1;
+	}
+	tbl->flows[tbl->max_flow_num - 1].next_flow_idx = INVALID_ARRAY_INDEX;
+	tbl->free_flow_idx = 0;
+	tbl->flow_num = 0;
+
+	for (i = 0; i <= tbl->flow_hash_mask; i++)
+		tbl->flow_hash[i] = INVALID_ARRAY_INDEX;
+}
+
 void
 gro_tcp4_tbl_destroy(void *tbl)
 {
@@ -68,6 +109,7 @@ gro_tcp4_tbl_destroy(void *tbl)
 	if (tcp_tbl) {
 		rte_free(tcp_tbl->items);
 		rte_free(tcp_tbl->flows);
+		rte_free(tcp_tbl->flow_hash);
 	}
 	rte_free(tcp_tbl);
 }
@@ -75,25 +117,21 @@ gro_tcp4_tbl_destroy(void *tbl)
 static inline uint32_t
 find_an_empty_item(struct gro_tcp4_tbl *tbl)
 {
-	uint32_t i;
-	uint32_t max_item_num = tbl->max_item_num;
+	uint32_t item_idx = tbl->free_item_idx;
 
-	for (i = 0; i < max_item_num; i++)
-		if (tbl->items[i].firstseg == NULL)
-			return i;
-	return INVALID_ARRAY_INDEX;
+	if (item_idx != INVALID_ARRAY_INDEX)
+		tbl->free_item_idx = tbl->items[item_idx].next_pkt_idx;
+	return item_idx;
 }
 
 static inline uint32_t
 find_an_empty_flow(struct gro_tcp4_tbl *tbl)
 {
-	uint32_t i;
-	uint32_t max_flow_num = tbl->max_flow_num;
+	uint32_t flow_idx = tbl->free_flow_idx;
 
-	for (i = 0; i < max_flow_num; i++)
-		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
-			return i;
-	return INVALID_ARRAY_INDEX;
+	if (flow_idx != INVALID_ARRAY_INDEX)
+		tbl->free_flow_idx = tbl->flows[flow_idx].next_flow_idx;
+	return flow_idx;
 }
 
 static inline uint32_t
@@ -139,6 +177,8 @@ delete_item(struct gro_tcp4_tbl *tbl, uint32_t item_idx,
 
 	/* NULL indicates an empty item */
 	tbl->items[item_idx].firstseg = NULL;
+	tbl->items[item_idx].next_pkt_idx = tbl->free_item_idx;
+	tbl->free_item_idx = item_idx;
 	tbl->item_num--;
 	if (prev_item_idx != INVALID_ARRAY_INDEX)
 		tbl->items[prev_item_idx].next_pkt_idx = next_idx;
@@ -149,8 +189,10 @@ delete_item(struct gro_tcp4_tbl *tbl, uint32_t item_idx,
 static inline uint32_t
 insert_new_flow(struct gro_tcp4_tbl *tbl,
 		struct tcp4_flow_key *src,
+		uint32_t hash,
 		uint32_t item_idx)
 {
+	uint32_t *bucket;
 	struct tcp4_flow_key *dst;
 	uint32_t flow_idx;
 
@@ -169,11 +211,53 @@ insert_new_flow(struct gro_tcp4_tbl *tbl,
 	dst->dst_port = src->dst_port;
 
 	tbl->flows[flow_idx].start_index = item_idx;
+	tbl->flows[flow_idx].hash = hash;
 	tbl->flow_num++;
 
+	/* add the flow to the head of its hash bucket */
+	bucket = &tbl->flow_hash[hash & tbl->flow_hash_mask];
+	tbl->flows[flow_idx].next_flow_idx = *bucket;
+	*bucket = flow_idx;
+
 	return flow_idx;
 }
 
+static inline void
+delete_flow(struct gro_tcp4_tbl *tbl, uint32_t flow_idx)
+{
+	struct gro_tcp4_flow *flows = tbl->flows;
+	uint32_t *idx = &tbl->flow_hash[flows[flow_idx].hash &
+		tbl->flow_hash_mask];
+
+	/* unlink the flow from its hash bucket */
+	while (*idx != flow_idx)
+		idx = &flows[*idx].next_flow_idx;
+	*idx = flows[flow_idx].next_flow_idx;
+
+	/* INVALID_ARRAY_INDEX indicates an empty flow */
+	flows[flow_idx].start_index = INVALID_ARRAY_INDEX;
+	flows[flow_idx].next_flow_idx = tbl->free_flow_idx;
+	tbl->free_flow_idx = flow_idx;
+	tbl->flow_num--;
+}
+
+static inline uint32_t
+find_flow(struct gro_tcp4_tbl *tbl,
+		struct tcp4_flow_key *key,
+		uint32_t hash)
+{
+	struct gro_tcp4_flow *flows = tbl->flows;
+	uint32_t i = tbl->flow_hash[hash & tbl->flow_hash_mask];
+
+	while (i != INVALID_ARRAY_INDEX) {
+		if (flows[i].hash == hash &&
+				is_same_tcp4_flow(flows[i].key, *key))
+			break;
+		i = flows[i].next_flow_idx;
+	}
+	return i;
+}
+
 /*
  * update the packet length for the flushed packet.
  */
@@ -204,9 +288,8 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	struct tcp4_flow_key key;
 	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, hash;
 	int cmp;
-	uint8_t find;
 
 	/*
 	 * Don't process the packet whose TCP header length is greater
@@ -252,30 +335,20 @@ gro_tcp4_reassemble(struct rte_mbuf *pkt,
 	key.recv_ack = tcp_hdr->recv_ack;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
-	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
-		}
-	}
+	hash = tcp4_flow_hash(&key);
+	i = find_flow(tbl, &key, hash);
 
 	/*
 	 * Fail to find a matched flow. Insert a new flow and store the
 	 * packet into the flow.
 	 */
-	if (find == 0) {
+	if (i == INVALID_ARRAY_INDEX) {
 		item_idx = insert_new_item(tbl, pkt, start_time,
 				INVALID_ARRAY_INDEX, sent_seq, ip_id,
 				is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, hash, item_idx) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so delete the
@@ -351,7 +424,7 @@ gro_tcp4_tbl_timeout_flush(struct gro_tcp4_tbl *tbl,
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
 				if (j == INVALID_ARRAY_INDEX)
-					tbl->flow_num--;
+					delete_flow(tbl, i);
 
 				if (unlikely(k == nb_out))
 					return k;
@@ -8,6 +8,7 @@
 #include <rte_ip.h>
 #include <rte_tcp.h>
 #include <rte_vxlan.h>
+#include <rte_jhash.h>
 
 #define INVALID_ARRAY_INDEX 0xffffffffUL
 #define GRO_TCP4_TBL_MAX_ITEM_NUM (1024UL * 1024UL)
@@ -42,6 +43,13 @@ struct gro_tcp4_flow {
 	 * INVALID_ARRAY_INDEX indicates an empty flow.
 	 */
 	uint32_t start_index;
+	/*
+	 * The next flow in the same hash bucket, or the next empty
+	 * flow if the flow is empty.
+	 */
+	uint32_t next_flow_idx;
+	/* The hash value of the flow key */
+	uint32_t hash;
 };
 
 struct gro_tcp4_item {
@@ -61,7 +69,8 @@ struct gro_tcp4_item {
 	/*
 	 * next_pkt_idx is used to chain the packets that
 	 * are in the same flow but can't be merged together
-	 * (e.g. caused by packet reordering).
+	 * (e.g. caused by packet reordering). For an empty
+	 * item, it's the index of the next empty item.
 	 */
 	uint32_t next_pkt_idx;
 	/* TCP sequence number of the packet */
@@ -90,6 +99,14 @@ struct gro_tcp4_tbl {
 	uint32_t max_item_num;
 	/* flow array size */
 	uint32_t max_flow_num;
+	/* the first flow of each hash bucket */
+	uint32_t *flow_hash;
+	/* hash bucket number - 1, the bucket number is a power of 2 */
+	uint32_t flow_hash_mask;
+	/* the first empty item */
+	uint32_t free_item_idx;
+	/* the first empty flow */
+	uint32_t free_flow_idx;
 };
 
 /**
@@ -110,6 +127,15 @@ void *gro_tcp4_tbl_create(uint16_t socket_id,
 		uint16_t max_flow_num,
 		uint16_t max_item_per_flow);
 
+/**
+ * This function empties a TCP/IPv4 reassembly table, whose item, flow
+ * and hash bucket arrays and their sizes are set.
+ *
+ * @param tbl
+ *  Pointer pointing to the TCP/IPv4 reassembly table.
+ */
+void gro_tcp4_tbl_reset(struct gro_tcp4_tbl *tbl);
+
 /**
  * This function destroys a TCP/IPv4 reassembly table.
  *
@@ -197,6 +223,18 @@ is_same_tcp4_flow(struct tcp4_flow_key k1, struct tcp4_flow_key k2)
 			(k1.dst_port == k2.dst_port));
 }
 
+/*
+ * Calculate the hash value of a TCP/IPv4 flow key. The Ethernet
+ * addresses are left out, as they rarely tell flows apart.
+ */
+static inline uint32_t
+tcp4_flow_hash(const struct tcp4_flow_key *key)
+{
+	return rte_jhash_3words(key->ip_src_addr, key->ip_dst_addr,
+			((uint32_t)key->src_port << 16) | key->dst_port,
+			key->recv_ack);
+}
+
 /*
  * Merge two TCP/IPv4 packets without updating checksums.
  * If cmp is larger than 0, append the new packet to the
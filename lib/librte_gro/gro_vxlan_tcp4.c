@@ -17,7 +17,7 @@ gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 {
 	struct gro_vxlan_tcp4_tbl *tbl;
 	size_t size;
-	uint32_t entries_num, i;
+	uint32_t entries_num, buckets_num;
 
 	entries_num = max_flow_num * max_item_per_flow;
 	entries_num = RTE_MIN(entries_num, GRO_VXLAN_TCP4_TBL_MAX_ITEM_NUM);
@@ -53,14 +53,56 @@ gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 		rte_free(tbl);
 		return NULL;
 	}
-
-	for (i = 0; i < entries_num; i++)
-		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
 
+	/* one hash bucket per flow, at least */
+	buckets_num = rte_align32pow2(entries_num);
+	size = sizeof(uint32_t) * buckets_num;
+	tbl->flow_hash = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->flow_hash == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->flow_hash_mask = buckets_num - 1;
+
+	gro_vxlan_tcp4_tbl_reset(tbl);
+
 	return tbl;
 }
 
+void
+gro_vxlan_tcp4_tbl_reset(struct gro_vxlan_tcp4_tbl *tbl)
+{
+	uint32_t i;
+
+	/* chain all items and flows into the empty lists */
+	for (i = 0; i < tbl->max_item_num; i++) {
+		tbl->items[i].inner_item.firstseg = NULL;
+		tbl->items[i].inner_item.next_pkt_idx = i + 1;
+	}
+	tbl->items[tbl->max_item_num - 1].inner_item.next_pkt_idx =
+		INVALID_ARRAY_INDEX;
+	tbl->free_item_idx = 0;
+	tbl->item_num = 0;
+
+	/* INVALID_ARRAY_INDEX indicates an empty flow */
+	for (i = 0; i < tbl->max_flow_num; i++) {
+		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
+		tbl->flows[i].next_flow_idx = i + 1;
+	}
+	tbl->flows[tbl->max_flow_num - 1].next_flow_idx = INVALID_ARRAY_INDEX;
+	tbl->free_flow_idx = 0;
+	tbl->flow_num = 0;
+
+	for (i = 0; i <= tbl->flow_hash_mask; i++)
+		tbl->flow_hash[i] = INVALID_ARRAY_INDEX;
+}
+
 void
 gro_vxlan_tcp4_tbl_destroy(void *tbl)
 {
@@ -69,6 +111,7 @@ gro_vxlan_tcp4_tbl_destroy(void *tbl)
 	if (vxlan_tbl) {
 		rte_free(vxlan_tbl->items);
 		rte_free(vxlan_tbl->flows);
+		rte_free(vxlan_tbl->flow_hash);
 	}
 	rte_free(vxlan_tbl);
 }
@@ -76,23 +119,22 @@ gro_vxlan_tcp4_tbl_destroy(void *tbl)
 static inline uint32_t
 find_an_empty_item(struct gro_vxlan_tcp4_tbl *tbl)
 {
-	uint32_t max_item_num = tbl->max_item_num, i;
+	uint32_t item_idx = tbl->free_item_idx;
 
-	for (i = 0; i < max_item_num; i++)
-		if (tbl->items[i].inner_item.firstseg == NULL)
-			return i;
-	return INVALID_ARRAY_INDEX;
+	if (item_idx != INVALID_ARRAY_INDEX)
+		tbl->free_item_idx =
+			tbl->items[item_idx].inner_item.next_pkt_idx;
+	return item_idx;
 }
 
 static inline uint32_t
 find_an_empty_flow(struct gro_vxlan_tcp4_tbl *tbl)
 {
-	uint32_t max_flow_num = tbl->max_flow_num, i;
+	uint32_t flow_idx = tbl->free_flow_idx;
 
-	for (i = 0; i < max_flow_num; i++)
-		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
-			return i;
-	return INVALID_ARRAY_INDEX;
+	if (flow_idx != INVALID_ARRAY_INDEX)
+		tbl->free_flow_idx = tbl->flows[flow_idx].next_flow_idx;
+	return flow_idx;
 }
 
 static inline uint32_t
@@ -143,6 +185,8 @@ delete_item(struct gro_vxlan_tcp4_tbl *tbl,
 
 	/* NULL indicates an empty item. */
 	tbl->items[item_idx].inner_item.firstseg = NULL;
+	tbl->items[item_idx].inner_item.next_pkt_idx = tbl->free_item_idx;
+	tbl->free_item_idx = item_idx;
 	tbl->item_num--;
 	if (prev_item_idx != INVALID_ARRAY_INDEX)
 		tbl->items[prev_item_idx].inner_item.next_pkt_idx = next_idx;
@@ -153,9 +197,11 @@ delete_item(struct gro_vxlan_tcp4_tbl *tbl,
 static inline uint32_t
 insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 		struct vxlan_tcp4_flow_key *src,
+		uint32_t hash,
 		uint32_t item_idx)
 {
 	struct vxlan_tcp4_flow_key *dst;
+	uint32_t *bucket;
 	uint32_t flow_idx;
 
 	flow_idx = find_an_empty_flow(tbl);
@@ -184,11 +230,47 @@ insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 	dst->outer_dst_port = src->outer_dst_port;
 
 	tbl->flows[flow_idx].start_index = item_idx;
+	tbl->flows[flow_idx].hash = hash;
 	tbl->flow_num++;
 
+	/* add the flow to the head of its hash bucket */
+	bucket = &tbl->flow_hash[hash & tbl->flow_hash_mask];
+	tbl->flows[flow_idx].next_flow_idx = *bucket;
+	*bucket = flow_idx;
+
 	return flow_idx;
 }
 
+static inline void
+delete_flow(struct gro_vxlan_tcp4_tbl *tbl, uint32_t flow_idx)
+{
+	struct gro_vxlan_tcp4_flow *flows = tbl->flows;
+	uint32_t *idx = &tbl->flow_hash[flows[flow_idx].hash &
+		tbl->flow_hash_mask];
+
+	/* unlink the flow from its hash bucket */
+	while (*idx != flow_idx)
+		idx = &flows[*idx].next_flow_idx;
+	*idx = flows[flow_idx].next_flow_idx;
+
+	/* INVALID_ARRAY_INDEX indicates an empty flow */
+	flows[flow_idx].start_index = INVALID_ARRAY_INDEX;
+	flows[flow_idx].next_flow_idx = tbl->free_flow_idx;
+	tbl->free_flow_idx = flow_idx;
+	tbl->flow_num--;
+}
+
+/*
+ * Calculate the hash value of a VxLAN flow key from the inner flow
+ * and the VNI. The outer headers rarely tell flows apart.
+ */
+static inline uint32_t
+vxlan_tcp4_flow_hash(const struct vxlan_tcp4_flow_key *key)
+{
+	return rte_jhash_1word(key->vxlan_hdr.vx_vni,
+			tcp4_flow_hash(&key->inner_key));
+}
+
 static inline int
 is_same_vxlan_tcp4_flow(struct vxlan_tcp4_flow_key k1,
 		struct vxlan_tcp4_flow_key k2)
@@ -206,6 +288,23 @@ is_same_vxlan_tcp4_flow(struct vxlan_tcp4_flow_key k1,
 			is_same_tcp4_flow(k1.inner_key, k2.inner_key));
 }
 
+static inline uint32_t
+find_flow(struct gro_vxlan_tcp4_tbl *tbl,
+		struct vxlan_tcp4_flow_key *key,
+		uint32_t hash)
+{
+	struct gro_vxlan_tcp4_flow *flows = tbl->flows;
+	uint32_t i = tbl->flow_hash[hash & tbl->flow_hash_mask];
+
+	while (i != INVALID_ARRAY_INDEX) {
+		if (flows[i].hash == hash &&
+				is_same_vxlan_tcp4_flow(flows[i].key, *key))
+			break;
+		i = flows[i].next_flow_idx;
+	}
+	return i;
+}
+
 static inline int
 check_vxlan_seq_option(struct gro_vxlan_tcp4_item *item,
 		struct rte_tcp_hdr *tcp_hdr,
@@ -302,10 +401,9 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	struct vxlan_tcp4_flow_key key;
 	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, hash;
 	int cmp;
 	uint16_t hdr_len;
-	uint8_t find;
 
 	/*
 	 * Don't process the packet whose TCP header length is greater
@@ -376,30 +474,20 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 	key.outer_dst_port = udp_hdr->dst_port;
 
 	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
-	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_vxlan_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
-		}
-	}
+	hash = vxlan_tcp4_flow_hash(&key);
+	i = find_flow(tbl, &key, hash);
 
 	/*
 	 * Can't find a matched flow. Insert a new flow and store the
 	 * packet into the flow.
 	 */
-	if (find == 0) {
+	if (i == INVALID_ARRAY_INDEX) {
 		item_idx = insert_new_item(tbl, pkt, start_time,
 				INVALID_ARRAY_INDEX, sent_seq, outer_ip_id,
 				ip_id, outer_is_atomic, is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, hash, item_idx) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so
@@ -477,7 +565,7 @@ gro_vxlan_tcp4_tbl_timeout_flush(struct gro_vxlan_tcp4_tbl *tbl,
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
 				if (j == INVALID_ARRAY_INDEX)
-					tbl->flow_num--;
+					delete_flow(tbl, i);
 
 				if (unlikely(k == nb_out))
 					return k;
@@ -33,6 +33,13 @@ struct gro_vxlan_tcp4_flow {
 	 * indicates an empty flow.
 	 */
 	uint32_t start_index;
+	/*
+	 * The next flow in the same hash bucket, or the next empty
+	 * flow if the flow is empty.
+	 */
+	uint32_t next_flow_idx;
+	/* The hash value of the flow key */
+	uint32_t hash;
 };
 
 struct gro_vxlan_tcp4_item {
@@ -60,6 +67,14 @@ struct gro_vxlan_tcp4_tbl {
 	uint32_t max_item_num;
 	/* the maximum flow number */
 	uint32_t max_flow_num;
+	/* the first flow of each hash bucket */
+	uint32_t *flow_hash;
+	/* hash bucket number - 1, the bucket number is a power of 2 */
+	uint32_t flow_hash_mask;
+	/* the first empty item */
+	uint32_t free_item_idx;
+	/* the first empty flow */
+	uint32_t free_flow_idx;
 };
 
 /**
@@ -81,6 +96,15 @@ void *gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 		uint16_t max_flow_num,
 		uint16_t max_item_per_flow);
 
+/**
+ * This function empties a VxLAN reassembly table, whose item, flow and
+ * hash bucket arrays and their sizes are set.
+ *
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ */
+void gro_vxlan_tcp4_tbl_reset(struct gro_vxlan_tcp4_tbl *tbl);
+
 /**
  * This function destroys a VxLAN reassembly table.
  *
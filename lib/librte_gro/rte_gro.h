@@ -23,7 +23,7 @@ extern "C" {
  */
 #define RTE_GRO_TYPE_MAX_NUM 64
 /**< the max number of supported GRO types */
-#define RTE_GRO_TYPE_SUPPORT_NUM 2
+#define RTE_GRO_TYPE_SUPPORT_NUM 4
 /**< the number of currently supported GRO types */
 
 #define RTE_GRO_TCP_IPV4_INDEX 0
@@ -32,6 +32,12 @@ extern "C" {
 #define RTE_GRO_IPV4_VXLAN_TCP_IPV4_INDEX 1
 #define RTE_GRO_IPV4_VXLAN_TCP_IPV4 (1ULL << RTE_GRO_IPV4_VXLAN_TCP_IPV4_INDEX)
 /**< VxLAN GRO flag. */
+#define RTE_GRO_TCP_IPV6_INDEX 2
+#define RTE_GRO_TCP_IPV6 (1ULL << RTE_GRO_TCP_IPV6_INDEX)
+/**< TCP/IPv6 GRO flag */
+#define RTE_GRO_UDP_IPV4_INDEX 3
+#define RTE_GRO_UDP_IPV4 (1ULL << RTE_GRO_UDP_IPV4_INDEX)
+/**< UDP/IPv4 fragment GRO flag */
 
 /**
  * Structure used to create GRO context objects or used to pass
@@ -84,8 +90,9 @@ void rte_gro_ctx_destroy(void *ctx);
  * packets at a time. It doesn't check if input packets have correct
  * checksums and doesn't re-calculate checksums for merged packets.
  * It assumes the packets are complete (i.e., MF==0 && frag_off==0),
- * when IP fragmentation is possible (i.e., DF==0). The GROed packets
- * are returned as soon as the function finishes.
+ * when IP fragmentation is possible (i.e., DF==0), except for UDP/IPv4
+ * GRO, which merges the fragments of UDP/IPv4 datagrams. The GROed
+ * packets are returned as soon as the function finishes.
  *
  * @param pkts
  *  Pointer array pointing to the packets to reassemble. Besides, it
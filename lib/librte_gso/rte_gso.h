@@ -56,7 +56,7 @@ struct rte_gso_ctx {
 	 * gso_types.
 	 *
 	 * For example, if applications want to segment TCP/IPv4
-	 * packets, set DEV_TX_OFFLOAD_TCP_TSO in gso_types.
+	 * or TCP/IPv6 packets, set DEV_TX_OFFLOAD_TCP_TSO in gso_types.
 	 */
 	uint16_t gso_size;
 	/**< maximum size of an output GSO segment, including packet
@@ -75,6 +75,9 @@ struct rte_gso_ctx {
  * output GSO segments. Additionally, it doesn't process IP fragment
  * packets.
  *
+ * TCP/IPv4, TCP/IPv6, UDP/IPv4, and VxLAN and GRE packets with an outer
+ * IPv4 header and an inner TCP/IPv4 packet, are supported.
+ *
  * Before calling rte_gso_segment(), applications must set proper ol_flags
  * for the packet. The GSO library uses the same macros as that of TSO.
  * For example, set PKT_TX_TCP_SEG and PKT_TX_IPV4 in ol_flags to segment
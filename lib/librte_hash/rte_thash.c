@@ -0,0 +1,259 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_byteorder.h>
+#include <rte_cpuflags.h>
+#include <rte_errno.h>
+#include <rte_log.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_net.h>
+
+#include "rte_thash.h"
+#include "thash_private.h"
+
+/* 32 bits of the key from bit pos, bit 0 being the MSB of its first byte */
+static uint32_t
+thash_key_window(const uint8_t *key, uint32_t key_len, uint32_t pos)
+{
+	uint64_t w = 0;
+	uint32_t i, b = pos / 8;
+
+	for (i = 0; i < 8; i++)
+		w = (w << 8) | (b + i < key_len ? key[b + i] : 0);
+
+	return (uint32_t)((w << (pos % 8)) >> 32);
+}
+
+static void
+thash_lut_init(struct rte_thash_ctx *ctx, const uint8_t *key)
+{
+	uint32_t k[CHAR_BIT];
+	uint32_t i, u, v;
+
+	for (i = 0; i < ctx->max_tuple_len * 4; i++) {
+		for (u = 0; u < CHAR_BIT; u++)
+			k[u] = thash_key_window(key, ctx->key_len, i * 8 + u);
+
+		/* bit u from the MSB of the byte brings key window u */
+		ctx->lut[i][0] = 0;
+		for (v = 1; v < 256; v++)
+			ctx->lut[i][v] = ctx->lut[i][v & (v - 1)] ^
+				k[CHAR_BIT - 1 - rte_bsf32(v)];
+	}
+}
+
+static void
+thash_gfni_init(struct rte_thash_ctx *ctx, const uint8_t *key)
+{
+	uint32_t m, o, a;
+	uint16_t w;
+	int i;
+
+	/*
+	 * Byte a of matrix m gives bit a from the MSB of the output byte:
+	 * the 8 key bits from bit a of key byte m.
+	 */
+	for (m = 0; m < ctx->key_len; m++) {
+		w = key[m] << 8;
+		if (m + 1 < ctx->key_len)
+			w |= key[m + 1];
+		ctx->mtrx[m] = 0;
+		for (a = 0; a < CHAR_BIT; a++)
+			ctx->mtrx[m] |= (uint64_t)(uint8_t)(w >> (8 - a)) <<
+				(a * 8);
+	}
+
+	/*
+	 * Tuple byte i, in network order, is byte i ^ 3 of the CPU order
+	 * dwords. Index 63 is beyond the longest tuple, so reads zero.
+	 */
+	for (m = 0; m < THASH_KEY_MAX_LEN; m++) {
+		for (o = 0; o < CHAR_BIT; o++) {
+			i = (int)m - (int)o;
+			ctx->perm[m / 8][(m % 8) * 8 + o] =
+				(o < sizeof(uint32_t) && i >= 0) ? (i ^ 3) : 63;
+		}
+	}
+}
+
+static void
+thash_lut_bulk(const struct rte_thash_ctx *ctx,
+		const uint32_t * const tuple[], uint32_t tuple_len,
+		uint32_t hash[], uint32_t num)
+{
+	const uint32_t (*lut)[256];
+	uint32_t i, j, w, h;
+
+	for (i = 0; i < num; i++) {
+		lut = ctx->lut;
+		h = 0;
+		for (j = 0; j < tuple_len; j++, lut += 4) {
+			w = tuple[i][j];
+			h ^= lut[0][w >> 24] ^ lut[1][(w >> 16) & 0xff] ^
+				lut[2][(w >> 8) & 0xff] ^ lut[3][w & 0xff];
+		}
+		hash[i] = h;
+	}
+}
+
+#ifdef CC_GFNI_SUPPORT
+static int
+thash_gfni_supported(void)
+{
+	return rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW) &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512VBMI) &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_GFNI);
+}
+#endif
+
+struct rte_thash_ctx *
+rte_thash_ctx_create(const uint8_t *rss_key, uint32_t key_len,
+		int socket_id)
+{
+	struct rte_thash_ctx *ctx;
+	uint32_t max_tuple_len;
+
+	if (rss_key == NULL || key_len < 8 || key_len > THASH_KEY_MAX_LEN ||
+			key_len % 4 != 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	/* the hash of the last dword needs the next dword of the key */
+	max_tuple_len = key_len / 4 - 1;
+
+	ctx = rte_zmalloc_socket("THASH_CTX", sizeof(*ctx) +
+			max_tuple_len * 4 * sizeof(ctx->lut[0]),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (ctx == NULL) {
+		RTE_LOG(ERR, HASH, "Failed to allocate thash context\n");
+		rte_errno = ENOMEM;
+		return NULL;
+	}
+
+	ctx->key_len = key_len;
+	ctx->max_tuple_len = max_tuple_len;
+	thash_lut_init(ctx, rss_key);
+	thash_gfni_init(ctx, rss_key);
+
+	ctx->hash_bulk = thash_lut_bulk;
+#ifdef CC_GFNI_SUPPORT
+	if (thash_gfni_supported())
+		ctx->hash_bulk = thash_gfni_bulk;
+#endif
+
+	return ctx;
+}
+
+void
+rte_thash_ctx_free(struct rte_thash_ctx *ctx)
+{
+	rte_free(ctx);
+}
+
+int
+rte_thash_ctx_set_alg(struct rte_thash_ctx *ctx, enum rte_thash_alg alg)
+{
+	switch (alg) {
+	case RTE_THASH_ALG_LUT:
+		ctx->hash_bulk = thash_lut_bulk;
+		return 0;
+#ifdef CC_GFNI_SUPPORT
+	case RTE_THASH_ALG_GFNI:
+		if (!thash_gfni_supported())
+			return -ENOTSUP;
+		ctx->hash_bulk = thash_gfni_bulk;
+		return 0;
+#endif
+	default:
+		return -ENOTSUP;
+	}
+}
+
+uint32_t
+rte_thash_hash(const struct rte_thash_ctx *ctx, const uint32_t *tuple,
+		uint32_t tuple_len)
+{
+	uint32_t hash;
+
+	ctx->hash_bulk(ctx, &tuple, tuple_len, &hash, 1);
+
+	return hash;
+}
+
+void
+rte_thash_hash_bulk(const struct rte_thash_ctx *ctx,
+		const uint32_t * const tuple[], uint32_t tuple_len,
+		uint32_t hash[], uint32_t num)
+{
+	ctx->hash_bulk(ctx, tuple, tuple_len, hash, num);
+}
+
+uint32_t
+rte_thash_mbuf(const struct rte_thash_ctx *ctx, const struct rte_mbuf *m,
+		int l4)
+{
+	union rte_thash_tuple tuple;
+	struct rte_net_hdr_lens hdr_lens;
+	const rte_be16_t *ports;
+	rte_be16_t ports_copy[2];
+	uint32_t ptype, len;
+
+	ptype = rte_net_get_ptype(m, &hdr_lens,
+		RTE_PTYPE_L2_MASK | RTE_PTYPE_L3_MASK | RTE_PTYPE_L4_MASK);
+
+	if (RTE_ETH_IS_IPV4_HDR(ptype)) {
+		const struct rte_ipv4_hdr *ipv4_hdr;
+		struct rte_ipv4_hdr ipv4_copy;
+
+		ipv4_hdr = rte_pktmbuf_read(m, hdr_lens.l2_len,
+			sizeof(*ipv4_hdr), &ipv4_copy);
+		if (unlikely(ipv4_hdr == NULL))
+			return 0;
+		tuple.v4.src_addr = rte_be_to_cpu_32(ipv4_hdr->src_addr);
+		tuple.v4.dst_addr = rte_be_to_cpu_32(ipv4_hdr->dst_addr);
+		len = RTE_THASH_V4_L3_LEN;
+	} else if (RTE_ETH_IS_IPV6_HDR(ptype)) {
+		const struct rte_ipv6_hdr *ipv6_hdr;
+		struct rte_ipv6_hdr ipv6_copy;
+
+		ipv6_hdr = rte_pktmbuf_read(m, hdr_lens.l2_len,
+			sizeof(*ipv6_hdr), &ipv6_copy);
+		if (unlikely(ipv6_hdr == NULL))
+			return 0;
+		rte_thash_load_v6_addrs(ipv6_hdr, &tuple);
+		len = RTE_THASH_V6_L3_LEN;
+	} else
+		return 0;
+
+	/* the ports follow the L3 addresses in the tuple */
+	if (l4 && ((ptype & RTE_PTYPE_L4_MASK) == RTE_PTYPE_L4_TCP ||
+			(ptype & RTE_PTYPE_L4_MASK) == RTE_PTYPE_L4_UDP)) {
+		ports = rte_pktmbuf_read(m, hdr_lens.l2_len + hdr_lens.l3_len,
+			sizeof(ports_copy), ports_copy);
+		if (likely(ports != NULL)) {
+			if (RTE_ETH_IS_IPV4_HDR(ptype)) {
+				tuple.v4.sport = rte_be_to_cpu_16(ports[0]);
+				tuple.v4.dport = rte_be_to_cpu_16(ports[1]);
+			} else {
+				tuple.v6.sport = rte_be_to_cpu_16(ports[0]);
+				tuple.v6.dport = rte_be_to_cpu_16(ports[1]);
+			}
+			len++;
+		}
+	}
+
+	if (unlikely(len > ctx->max_tuple_len))
+		return 0;
+
+	return rte_thash_hash(ctx, (const uint32_t *)&tuple, len);
+}
@@ -27,6 +27,7 @@ extern "C" {
 #include <rte_config.h>
 #include <rte_ip.h>
 #include <rte_common.h>
+#include <rte_compat.h>
 
 #if defined(RTE_ARCH_X86) || defined(RTE_MACHINE_CPUFLAG_NEON)
 #include <rte_vect.h>
@@ -222,6 +223,143 @@ rte_softrss_be(uint32_t *input_tuple, uint32_t input_len,
 	return ret;
 }
 
+struct rte_mbuf;
+
+/** Toeplitz hash context, built from an RSS key */
+struct rte_thash_ctx;
+
+/** Toeplitz hash implementations */
+enum rte_thash_alg {
+	RTE_THASH_ALG_LUT = 0,	/**< Lookup table per tuple byte */
+	RTE_THASH_ALG_GFNI,	/**< AVX512 Galois field affine transforms */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a Toeplitz hash context for an RSS key. The hash of a tuple
+ * is then computed from tables built from the key, or with GFNI
+ * instructions when the CPU supports them, instead of bit by bit.
+ *
+ * @param rss_key
+ *   Pointer to the original RSS key, as given to the NIC
+ * @param key_len
+ *   RSS key length in bytes, a multiple of 4 from 8 to 64. The tuples
+ *   hashed can be up to key_len - 4 bytes long.
+ * @param socket_id
+ *   Socket to allocate the context on
+ * @return
+ *   Pointer to the context, or NULL with rte_errno set:
+ *   - EINVAL - invalid parameter
+ *   - ENOMEM - no memory for the context
+ */
+__rte_experimental
+struct rte_thash_ctx *
+rte_thash_ctx_create(const uint8_t *rss_key, uint32_t key_len,
+		int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free a Toeplitz hash context.
+ *
+ * @param ctx
+ *   Pointer to the context, can be NULL
+ */
+__rte_experimental
+void
+rte_thash_ctx_free(struct rte_thash_ctx *ctx);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Select the implementation a Toeplitz hash context uses. The fastest
+ * one supported by the CPU is selected at creation.
+ *
+ * @param ctx
+ *   Pointer to the context
+ * @param alg
+ *   Implementation to use
+ * @return
+ *   0 on success, -ENOTSUP if the implementation is not supported by
+ *   the CPU or the build
+ */
+__rte_experimental
+int
+rte_thash_ctx_set_alg(struct rte_thash_ctx *ctx, enum rte_thash_alg alg);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Compute the Toeplitz hash of a tuple, the same as rte_softrss() with
+ * the key of the context.
+ *
+ * @param ctx
+ *   Pointer to the context
+ * @param tuple
+ *   Pointer to the input tuple
+ * @param tuple_len
+ *   Length of the tuple in 4-bytes chunks, up to the key length in
+ *   4-bytes chunks minus one
+ * @return
+ *   Calculated hash value.
+ */
+__rte_experimental
+uint32_t
+rte_thash_hash(const struct rte_thash_ctx *ctx, const uint32_t *tuple,
+		uint32_t tuple_len);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Compute the Toeplitz hashes of a burst of tuples of the same length.
+ *
+ * @param ctx
+ *   Pointer to the context
+ * @param tuple
+ *   Array of pointers to the input tuples
+ * @param tuple_len
+ *   Length of the tuples in 4-bytes chunks, up to the key length in
+ *   4-bytes chunks minus one
+ * @param hash
+ *   Array where the hash values are stored
+ * @param num
+ *   Number of tuples
+ */
+__rte_experimental
+void
+rte_thash_hash_bulk(const struct rte_thash_ctx *ctx,
+		const uint32_t * const tuple[], uint32_t tuple_len,
+		uint32_t hash[], uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Compute the Toeplitz hash of the outer IPv4 or IPv6 addresses of a
+ * packet, and of its TCP or UDP ports if asked, found at the offsets
+ * given by rte_net_get_ptype().
+ *
+ * @param ctx
+ *   Pointer to the context
+ * @param m
+ *   Pointer to the packet
+ * @param l4
+ *   If non-zero, include the ports of unfragmented TCP and UDP packets
+ * @return
+ *   Calculated hash value, or 0 if the packet is not IP or its tuple is
+ *   too long for the key of the context.
+ */
+__rte_experimental
+uint32_t
+rte_thash_mbuf(const struct rte_thash_ctx *ctx, const struct rte_mbuf *m,
+		int l4);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_byteorder.h>
+#include <rte_vect.h>
+
+#include "rte_thash.h"
+#include "thash_private.h"
+
+/*
+ * Computes the hash of a tuple from the products of its bytes by the
+ * matrices, vector v holding the products for matrices 8v to 8v + 7.
+ */
+static __rte_always_inline uint32_t
+thash_gfni(const struct rte_thash_ctx *ctx, const uint32_t *tuple,
+		__mmask64 load_mask, uint32_t nb_vecs)
+{
+	__m512i in, acc, v;
+	__m256i acc256;
+	__m128i acc128;
+	uint64_t acc64;
+	uint32_t i;
+
+	in = _mm512_maskz_loadu_epi8(load_mask, tuple);
+
+	acc = _mm512_setzero_si512();
+	for (i = 0; i < nb_vecs; i++) {
+		v = _mm512_permutexvar_epi8(
+			_mm512_load_si512((const void *)ctx->perm[i]), in);
+		v = _mm512_gf2p8affine_epi64_epi8(v,
+			_mm512_load_si512((const void *)&ctx->mtrx[i * 8]), 0);
+		acc = _mm512_xor_si512(acc, v);
+	}
+
+	/* xor the qwords, their first 4 bytes are the hash bytes */
+	acc256 = _mm256_xor_si256(_mm512_castsi512_si256(acc),
+		_mm512_extracti64x4_epi64(acc, 1));
+	acc128 = _mm_xor_si128(_mm256_castsi256_si128(acc256),
+		_mm256_extracti128_si256(acc256, 1));
+	acc64 = _mm_cvtsi128_si64(acc128) ^ _mm_extract_epi64(acc128, 1);
+
+	return rte_be_to_cpu_32((uint32_t)acc64);
+}
+
+void
+thash_gfni_bulk(const struct rte_thash_ctx *ctx,
+		const uint32_t * const tuple[], uint32_t tuple_len,
+		uint32_t hash[], uint32_t num)
+{
+	uint32_t len = tuple_len * sizeof(uint32_t);
+	/* tuple bytes i reach matrix i + 3 */
+	uint32_t nb_vecs = (len + 3 + 7) / 8;
+	__mmask64 load_mask = (1ULL << len) - 1;
+	uint32_t i;
+
+	for (i = 0; i < num; i++)
+		hash[i] = thash_gfni(ctx, tuple[i], load_mask, nb_vecs);
+}
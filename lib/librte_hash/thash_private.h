@@ -0,0 +1,59 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#ifndef _THASH_PRIVATE_H_
+#define _THASH_PRIVATE_H_
+
+#include <stdint.h>
+
+#include <rte_common.h>
+
+struct rte_thash_ctx;
+
+/** Longest RSS key supported, in bytes */
+#define THASH_KEY_MAX_LEN	64
+
+/** Number of 64-byte vectors the GFNI implementation spans */
+#define THASH_GFNI_VECS		(THASH_KEY_MAX_LEN / 8)
+
+typedef void (*thash_bulk_fn)(const struct rte_thash_ctx *ctx,
+		const uint32_t * const tuple[], uint32_t tuple_len,
+		uint32_t hash[], uint32_t num);
+
+/**
+ * Toeplitz hash context.
+ *
+ * The hash of a tuple is the xor of the contributions of its bytes, each
+ * being a linear function of the byte value and of the key bits from its
+ * position on. These functions are either tabulated, one table per byte
+ * of the tuple, or turned into the 8x8 bit matrices of the GF2P8AFFINEQB
+ * instruction: output byte o of the contribution of tuple byte i only
+ * depends on the key bits from byte i + o on, so it is the product of the
+ * tuple byte by matrix i + o.
+ */
+struct rte_thash_ctx {
+	uint32_t key_len;		/**< Length of the key, in bytes */
+	uint32_t max_tuple_len;		/**< Longest tuple, in dwords */
+	thash_bulk_fn hash_bulk;	/**< Bulk implementation */
+
+	/** GF2P8AFFINEQB matrices, one per key byte */
+	uint64_t mtrx[THASH_KEY_MAX_LEN] __rte_aligned(RTE_CACHE_LINE_SIZE);
+	/**
+	 * VPERMB indexes placing tuple byte m - o in byte o of qword m, zero
+	 * in the other bytes.
+	 */
+	uint8_t perm[THASH_GFNI_VECS][64] __rte_aligned(RTE_CACHE_LINE_SIZE);
+
+	/** Contribution of each value of each tuple byte to the hash */
+	uint32_t lut[][256] __rte_aligned(RTE_CACHE_LINE_SIZE);
+};
+
+#ifdef CC_GFNI_SUPPORT
+void
+thash_gfni_bulk(const struct rte_thash_ctx *ctx,
+		const uint32_t * const tuple[], uint32_t tuple_len,
+		uint32_t hash[], uint32_t num);
+#endif
+
+#endif /* _THASH_PRIVATE_H_ */
@@ -5,6 +5,8 @@
 #ifndef _IP_FRAG_COMMON_H_
 #define _IP_FRAG_COMMON_H_
 
+#include <rte_spinlock.h>
+
 #include "rte_ip_frag.h"
 
 /* logging macros. */
@@ -20,6 +22,9 @@
 /* helper macros */
 #define	IP_FRAG_MBUF2DR(dr, mb)	((dr)->row[(dr)->cnt++] = (mb))
 
+/* max number of mbufs put on death row while processing one fragment */
+#define	IP_FRAG_DEATH_ROW_PKT_MAX	(2 * (IP_MAX_FRAG_NUM + 1))
+
 #define IPv6_KEY_BYTES(key) \
 	(key)[0], (key)[1], (key)[2], (key)[3]
 #define IPv6_KEY_BYTES_FMT \
@@ -44,11 +49,31 @@ struct ip_frag_pkt * ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	const struct ip_frag_key *key, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
 
+struct ip_frag_pkt * ip_frag_find_hash(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, const struct ip_frag_key *key,
+	uint64_t tms, uint32_t sig1, uint32_t sig2);
+
+void ip_frag_key_hash(const struct ip_frag_key *key,
+	uint32_t *sig1, uint32_t *sig2);
+
+void ip_frag_prefetch(const struct rte_ip_frag_tbl *tbl,
+	uint32_t sig1, uint32_t sig2);
+
 /* these functions need to be declared here as ip_frag_process relies on them */
 struct rte_mbuf *ipv4_frag_reassemble(struct ip_frag_pkt *fp);
 struct rte_mbuf *ipv6_frag_reassemble(struct ip_frag_pkt *fp);
 
-
+/* shard of a shared fragmentation table */
+struct ip_frag_shard {
+	rte_spinlock_t lock;          /* protects the table */
+	struct rte_ip_frag_tbl *tbl;  /* fragmentation table */
+} __rte_cache_aligned;
+
+/* shared fragmentation table */
+struct rte_ip_frag_shared_tbl {
+	uint32_t nb_shards;           /* number of shards */
+	__extension__ struct ip_frag_shard shard[0]; /* shards */
+};
 
 /*
  * misc frag key functions
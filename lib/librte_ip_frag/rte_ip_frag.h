@@ -110,6 +110,12 @@ struct rte_ip_frag_tbl {
 	__extension__ struct ip_frag_pkt pkt[0]; /**< hash table. */
 };
 
+/**
+ * Fragmentation table shared by several lcores, made of shards that are
+ * fragmentation tables with their own locks.
+ */
+struct rte_ip_frag_shared_tbl;
+
 /** IPv6 fragment extension header */
 #define	RTE_IPV6_EHDR_MF_SHIFT			0
 #define	RTE_IPV6_EHDR_MF_MASK			1
@@ -196,6 +202,52 @@ rte_ipv6_fragment_packet(struct rte_mbuf *pkt_in,
 		struct rte_mempool *pool_direct,
 		struct rte_mempool *pool_indirect);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * IPv6 fragmentation of a burst of packets.
+ *
+ * It fragments the packets the same way as rte_ipv6_fragment_packet(),
+ * but it allocates the direct and indirect mbufs of the fragments of each
+ * packet in bulk, and builds the IPv6 and fragment headers of its
+ * fragments from a template made once per packet. The fragments reference
+ * the payload of the input packets, which isn't copied.
+ *
+ * The packets are processed in order, until a packet can't be
+ * fragmented. The input packets which are fragmented can be freed by the
+ * caller, as the fragments hold references to their segments.
+ *
+ * @param pkts_in
+ *   The input packets.
+ * @param nb_pkts_in
+ *   Number of input packets.
+ * @param pkts_out
+ *   Array storing the output fragments.
+ * @param nb_pkts_out
+ *   Number of fragments pkts_out can hold.
+ * @param mtu_size
+ *   Size in bytes of the Maximum Transfer Unit (MTU) for the outgoing IPv6
+ *   datagrams. This value includes the size of the IPv6 header.
+ * @param pool_direct
+ *   MBUF pool used for allocating direct buffers for the output fragments.
+ * @param pool_indirect
+ *   MBUF pool used for allocating indirect buffers for the output fragments.
+ * @param nb_frags
+ *   Set to the number of fragments placed in the pkts_out array.
+ * @return
+ *   Number of input packets fragmented. If it is less than nb_pkts_in,
+ *   rte_errno is set to the error of the first packet not fragmented:
+ *   - EINVAL: pkts_out is too small for its fragments.
+ *   - ENOMEM: mbuf allocation failed.
+ */
+__rte_experimental
+uint16_t
+rte_ipv6_fragment_bulk(struct rte_mbuf **pkts_in, uint16_t nb_pkts_in,
+	struct rte_mbuf **pkts_out, uint16_t nb_pkts_out, uint16_t mtu_size,
+	struct rte_mempool *pool_direct, struct rte_mempool *pool_indirect,
+	uint16_t *nb_frags);
+
 /**
  * This function implements reassembly of fragmented IPv6 packets.
  * Incoming mbuf should have its l2_len/l3_len fields setup correctly.
@@ -272,6 +324,53 @@ int32_t rte_ipv4_fragment_packet(struct rte_mbuf *pkt_in,
 			struct rte_mempool *pool_direct,
 			struct rte_mempool *pool_indirect);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * IPv4 fragmentation of a burst of packets.
+ *
+ * It fragments the packets the same way as rte_ipv4_fragment_packet(),
+ * but it allocates the direct and indirect mbufs of the fragments of each
+ * packet in bulk, and builds the IPv4 header of its fragments from a
+ * template made once per packet. The fragments reference the payload of
+ * the input packets, which isn't copied.
+ *
+ * The packets are processed in order, until a packet can't be
+ * fragmented. The input packets which are fragmented can be freed by the
+ * caller, as the fragments hold references to their segments.
+ *
+ * @param pkts_in
+ *   The input packets.
+ * @param nb_pkts_in
+ *   Number of input packets.
+ * @param pkts_out
+ *   Array storing the output fragments.
+ * @param nb_pkts_out
+ *   Number of fragments pkts_out can hold.
+ * @param mtu_size
+ *   Size in bytes of the Maximum Transfer Unit (MTU) for the outgoing IPv4
+ *   datagrams. This value includes the size of the IPv4 header.
+ * @param pool_direct
+ *   MBUF pool used for allocating direct buffers for the output fragments.
+ * @param pool_indirect
+ *   MBUF pool used for allocating indirect buffers for the output fragments.
+ * @param nb_frags
+ *   Set to the number of fragments placed in the pkts_out array.
+ * @return
+ *   Number of input packets fragmented. If it is less than nb_pkts_in,
+ *   rte_errno is set to the error of the first packet not fragmented:
+ *   - ENOTSUP: the Don't Fragment flag is set.
+ *   - EINVAL: pkts_out is too small for its fragments.
+ *   - ENOMEM: mbuf allocation failed.
+ */
+__rte_experimental
+uint16_t
+rte_ipv4_fragment_bulk(struct rte_mbuf **pkts_in, uint16_t nb_pkts_in,
+	struct rte_mbuf **pkts_out, uint16_t nb_pkts_out, uint16_t mtu_size,
+	struct rte_mempool *pool_direct, struct rte_mempool *pool_indirect,
+	uint16_t *nb_frags);
+
 /**
  * This function implements reassembly of fragmented IPv4 packets.
  * Incoming mbufs should have its l2_len/l3_len fields setup correctly.
@@ -353,6 +452,139 @@ void
 rte_frag_table_del_expired_entries(struct rte_ip_frag_tbl *tbl,
 	struct rte_ip_frag_death_row *dr, uint64_t tms);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reassemble a burst of IPv4 and IPv6 packets.
+ * Incoming mbufs should have their l2_len/l3_len fields setup correctly.
+ *
+ * The keys of a number of fragments are hashed and their table buckets
+ * are prefetched before the fragments are looked up, which hides the
+ * memory latency of the lookups. The IP version of each packet is taken
+ * from its IP header. Packets that are not fragments are returned as is.
+ * The death row is freed when it can't hold the mbufs which processing
+ * a fragment may release.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to
+ * @param pkts
+ *   Incoming mbufs.
+ * @param nb_pkts
+ *   Number of mbufs in pkts.
+ * @param tms
+ *   Fragments arrival timestamp.
+ * @param out
+ *   Array storing the packets that are not fragments and the reassembled
+ *   packets. It can be the same array as pkts.
+ * @return
+ *   Number of packets placed in the out array.
+ */
+__rte_experimental
+uint16_t
+rte_ip_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **pkts,
+	uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new IP fragmentation table that can be used by several lcores
+ * at the same time. It is made of shards, which are fragmentation tables
+ * with their own locks. The shard of a fragmented packet is selected by
+ * the hash of its key, so the fragments of a packet received by different
+ * lcores are reassembled.
+ *
+ * @param nb_shards
+ *   Number of shards, e.g. the number of lcores using the table.
+ * @param bucket_num
+ *   Number of buckets in the hash table of each shard.
+ * @param bucket_entries
+ *   Number of entries per bucket (e.g. hash associativity).
+ *   Should be power of two.
+ * @param max_entries
+ *   Maximum number of entries that could be stored in each shard.
+ *   The value should be less or equal then bucket_num * bucket_entries.
+ * @param max_cycles
+ *   Maximum TTL in cycles for each fragmented packet.
+ * @param socket_id
+ *   The *socket_id* argument is the socket identifier in the case of
+ *   NUMA. The value can be *SOCKET_ID_ANY* if there is no NUMA constraints.
+ * @return
+ *   The pointer to the new allocated table, on success. NULL on error.
+ */
+__rte_experimental
+struct rte_ip_frag_shared_tbl *
+rte_ip_frag_shared_table_create(uint32_t nb_shards, uint32_t bucket_num,
+	uint32_t bucket_entries, uint32_t max_entries, uint64_t max_cycles,
+	int socket_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free allocated shared IP fragmentation table.
+ *
+ * @param tbl
+ *   Shared fragmentation table to free.
+ */
+__rte_experimental
+void
+rte_ip_frag_shared_table_destroy(struct rte_ip_frag_shared_tbl *tbl);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reassemble a burst of IPv4 and IPv6 packets with a shared table.
+ * It is the same as rte_ip_frag_reassemble_bulk(), except that it can be
+ * called by several lcores at the same time. Each lcore should use its
+ * own death row.
+ *
+ * @param tbl
+ *   Shared table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to
+ * @param pkts
+ *   Incoming mbufs.
+ * @param nb_pkts
+ *   Number of mbufs in pkts.
+ * @param tms
+ *   Fragments arrival timestamp.
+ * @param out
+ *   Array storing the packets that are not fragments and the reassembled
+ *   packets. It can be the same array as pkts.
+ * @return
+ *   Number of packets placed in the out array.
+ */
+__rte_experimental
+uint16_t
+rte_ip_frag_shared_reassemble_bulk(struct rte_ip_frag_shared_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **pkts,
+	uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete expired fragments from a shared table.
+ * Shards locked by other lcores are skipped.
+ *
+ * @param tbl
+ *   Shared table to delete expired fragments from
+ * @param dr
+ *   Death row to free buffers to
+ * @param tms
+ *   Current timestamp
+ */
+__rte_experimental
+void
+rte_ip_frag_shared_table_del_expired_entries(struct rte_ip_frag_shared_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, uint64_t tms);
+
 #ifdef __cplusplus
 }
 #endif
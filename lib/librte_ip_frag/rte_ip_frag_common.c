@@ -142,3 +142,74 @@ rte_frag_table_del_expired_entries(struct rte_ip_frag_tbl *tbl,
 		} else
 			return;
 }
+
+/* create shared fragmentation table */
+struct rte_ip_frag_shared_tbl *
+rte_ip_frag_shared_table_create(uint32_t nb_shards, uint32_t bucket_num,
+	uint32_t bucket_entries, uint32_t max_entries, uint64_t max_cycles,
+	int socket_id)
+{
+	struct rte_ip_frag_shared_tbl *tbl;
+	size_t sz;
+	uint32_t i;
+
+	if (nb_shards == 0) {
+		RTE_LOG(ERR, USER1, "%s: invalid input parameter\n", __func__);
+		return NULL;
+	}
+
+	sz = sizeof(*tbl) + nb_shards * sizeof(tbl->shard[0]);
+	tbl = rte_zmalloc_socket(__func__, sz, RTE_CACHE_LINE_SIZE, socket_id);
+	if (tbl == NULL) {
+		RTE_LOG(ERR, USER1,
+			"%s: allocation of %zu bytes at socket %d failed\n",
+			__func__, sz, socket_id);
+		return NULL;
+	}
+
+	for (i = 0; i != nb_shards; i++) {
+		tbl->shard[i].tbl = rte_ip_frag_table_create(bucket_num,
+			bucket_entries, max_entries, max_cycles, socket_id);
+		if (tbl->shard[i].tbl == NULL) {
+			tbl->nb_shards = i;
+			rte_ip_frag_shared_table_destroy(tbl);
+			return NULL;
+		}
+		rte_spinlock_init(&tbl->shard[i].lock);
+	}
+
+	tbl->nb_shards = nb_shards;
+	return tbl;
+}
+
+/* delete shared fragmentation table */
+void
+rte_ip_frag_shared_table_destroy(struct rte_ip_frag_shared_tbl *tbl)
+{
+	uint32_t i;
+
+	if (tbl == NULL)
+		return;
+
+	for (i = 0; i != tbl->nb_shards; i++)
+		rte_ip_frag_table_destroy(tbl->shard[i].tbl);
+
+	rte_free(tbl);
+}
+
+/* Delete expired fragments from a shared table */
+void
+rte_ip_frag_shared_table_del_expired_entries(struct rte_ip_frag_shared_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, uint64_t tms)
+{
+	struct ip_frag_shard *sh;
+	uint32_t i;
+
+	for (i = 0; i != tbl->nb_shards; i++) {
+		sh = &tbl->shard[i];
+		if (rte_spinlock_trylock(&sh->lock) == 0)
+			continue;
+		rte_frag_table_del_expired_entries(sh->tbl, dr, tms);
+		rte_spinlock_unlock(&sh->lock);
+	}
+}
@@ -0,0 +1,351 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stddef.h>
+#include <errno.h>
+
+#include <rte_errno.h>
+#include <rte_memcpy.h>
+
+#include "ip_frag_common.h"
+
+/* max number of indirect mbufs of an input packet fragmented in bulk */
+#define IP_FRAG_BULK_SEG_MAX	128
+
+/*
+ * Return the number of indirect mbufs needed to split the payload of a
+ * packet, which starts hdr_len bytes into it, into fragments of
+ * frag_size bytes.
+ */
+static inline uint32_t
+ip_frag_bulk_nb_segs(const struct rte_mbuf *pkt, uint32_t hdr_len,
+	uint32_t frag_size)
+{
+	const struct rte_mbuf *seg;
+	uint32_t n, pos, len, ofs;
+
+	if (pkt->nb_segs == 1)
+		return (pkt->pkt_len - hdr_len + frag_size - 1) / frag_size;
+
+	n = 0;
+	pos = 0;
+	ofs = hdr_len;
+	for (seg = pkt; seg != NULL; seg = seg->next) {
+		len = seg->data_len - ofs;
+		ofs = 0;
+		if (len == 0)
+			continue;
+
+		/* number of fragments the segment data spans */
+		n += (pos + len - 1) / frag_size - pos / frag_size + 1;
+		pos += len;
+	}
+
+	return n;
+}
+
+/*
+ * Check if an input segment is only referenced by the packet being
+ * fragmented. As the fragments aren't visible to other lcores until they
+ * are returned, the reference counter of such a segment doesn't need
+ * atomic updates while its payload is attached to the fragments.
+ */
+static inline int
+ip_frag_bulk_seg_exclusive(const struct rte_mbuf *seg)
+{
+	return RTE_MBUF_DIRECT(seg) && rte_mbuf_refcnt_read(seg) == 1;
+}
+
+/*
+ * Chain the payload of the input packet to the direct mbufs of its
+ * fragments, through indirect mbufs attached to the input segments.
+ * The first hdr_out_len bytes of each direct mbuf are left for the
+ * fragment header.
+ */
+static inline void
+ip_frag_bulk_chain(struct rte_mbuf *pkt_in, uint32_t hdr_len,
+	uint32_t frag_size, struct rte_mbuf **frags, uint32_t nb_frags,
+	struct rte_mbuf **segs, uint32_t hdr_out_len)
+{
+	struct rte_mbuf *in_seg, *out_pkt, *out_seg, *prev;
+	uint32_t i, k, in_pos, len, remaining;
+	uint16_t nb_attached;
+	int exclusive;
+
+	in_seg = pkt_in;
+	in_pos = hdr_len;
+	exclusive = ip_frag_bulk_seg_exclusive(in_seg);
+	nb_attached = 0;
+	k = 0;
+
+	for (i = 0; i != nb_frags; i++) {
+		out_pkt = frags[i];
+		out_pkt->data_len = hdr_out_len;
+		out_pkt->pkt_len = hdr_out_len;
+		prev = out_pkt;
+		remaining = frag_size;
+
+		while (remaining != 0 && in_seg != NULL) {
+			len = RTE_MIN(remaining,
+				(uint32_t)in_seg->data_len - in_pos);
+			if (len != 0) {
+				out_seg = segs[k++];
+
+				/*
+				 * Keep the reference counter of an exclusive
+				 * segment at 1, so that attaching updates it
+				 * without atomics, and set it once done.
+				 */
+				if (exclusive)
+					rte_mbuf_refcnt_set(in_seg, 1);
+				rte_pktmbuf_attach(out_seg, in_seg);
+				nb_attached++;
+
+				out_seg->data_off = in_seg->data_off + in_pos;
+				out_seg->data_len = (uint16_t)len;
+				prev->next = out_seg;
+				prev = out_seg;
+				out_pkt->pkt_len += len;
+				out_pkt->nb_segs++;
+				in_pos += len;
+				remaining -= len;
+			}
+
+			/* Current input segment done ? */
+			if (in_pos == in_seg->data_len) {
+				if (exclusive)
+					rte_mbuf_refcnt_set(in_seg,
+						1 + nb_attached);
+				in_seg = in_seg->next;
+				in_pos = 0;
+				nb_attached = 0;
+				if (in_seg != NULL)
+					exclusive =
+					    ip_frag_bulk_seg_exclusive(in_seg);
+			}
+		}
+	}
+}
+
+/*
+ * Allocate the direct and indirect mbufs of the fragments of a packet,
+ * all or none of them.
+ */
+static inline int
+ip_frag_bulk_alloc(struct rte_mbuf **frags, uint32_t nb_frags,
+	struct rte_mbuf **segs, uint32_t nb_segs,
+	struct rte_mempool *pool_direct, struct rte_mempool *pool_indirect)
+{
+	if (unlikely(rte_pktmbuf_alloc_bulk(pool_direct, frags,
+			nb_frags) != 0))
+		return -ENOMEM;
+
+	if (unlikely(rte_pktmbuf_alloc_bulk(pool_indirect, segs,
+			nb_segs) != 0)) {
+		rte_pktmbuf_free_bulk(frags, nb_frags);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+/*
+ * Fragment one IPv4 packet. The header of the input packet is turned
+ * into a template once, which is copied into each fragment with only
+ * its length and offset updated.
+ */
+static inline int32_t
+ipv4_frag_bulk_one(struct rte_mbuf *pkt_in, struct rte_mbuf **pkts_out,
+	uint16_t nb_pkts_out, uint16_t mtu_size, uint32_t frag_size,
+	struct rte_mempool *pool_direct, struct rte_mempool *pool_indirect)
+{
+	struct rte_mbuf *segs[IP_FRAG_BULK_SEG_MAX];
+	struct rte_ipv4_hdr tmpl, *out_hdr;
+	uint32_t i, nb_frags, nb_segs, mf;
+	uint16_t flag_offset, fragment_offset;
+	int ret;
+
+	rte_memcpy(&tmpl, rte_pktmbuf_mtod(pkt_in, struct rte_ipv4_hdr *),
+		sizeof(tmpl));
+	flag_offset = rte_be_to_cpu_16(tmpl.fragment_offset);
+
+	/* If Don't Fragment flag is set */
+	if (unlikely((flag_offset & RTE_IPV4_HDR_DF_FLAG) != 0))
+		return -ENOTSUP;
+
+	nb_frags = (pkt_in->pkt_len - sizeof(struct rte_ipv4_hdr) +
+		frag_size - 1) / frag_size;
+
+	/* Check that pkts_out is big enough to hold all fragments */
+	if (unlikely(nb_frags > nb_pkts_out))
+		return -EINVAL;
+
+	nb_segs = ip_frag_bulk_nb_segs(pkt_in, sizeof(struct rte_ipv4_hdr),
+		frag_size);
+
+	/* leave packets without payload or with many segments as is */
+	if (unlikely(nb_frags == 0 || nb_segs > IP_FRAG_BULK_SEG_MAX))
+		return rte_ipv4_fragment_packet(pkt_in, pkts_out, nb_pkts_out,
+			mtu_size, pool_direct, pool_indirect);
+
+	ret = ip_frag_bulk_alloc(pkts_out, nb_frags, segs, nb_segs,
+		pool_direct, pool_indirect);
+	if (unlikely(ret != 0))
+		return ret;
+
+	ip_frag_bulk_chain(pkt_in, sizeof(struct rte_ipv4_hdr), frag_size,
+		pkts_out, nb_frags, segs, sizeof(struct rte_ipv4_hdr));
+
+	tmpl.hdr_checksum = 0;
+	fragment_offset = 0;
+
+	for (i = 0; i != nb_frags; i++) {
+		mf = (i != nb_frags - 1);
+		out_hdr = rte_pktmbuf_mtod(pkts_out[i], struct rte_ipv4_hdr *);
+		rte_memcpy(out_hdr, &tmpl, sizeof(tmpl));
+		out_hdr->fragment_offset = rte_cpu_to_be_16((uint16_t)
+			((flag_offset + fragment_offset /
+			RTE_IPV4_HDR_OFFSET_UNITS) |
+			(mf << RTE_IPV4_HDR_MF_SHIFT)));
+		out_hdr->total_length = rte_cpu_to_be_16(
+			(uint16_t)pkts_out[i]->pkt_len);
+		pkts_out[i]->l3_len = sizeof(struct rte_ipv4_hdr);
+
+		fragment_offset = (uint16_t)(fragment_offset +
+			pkts_out[i]->pkt_len - sizeof(struct rte_ipv4_hdr));
+	}
+
+	return nb_frags;
+}
+
+/*
+ * Fragment one IPv6 packet, with a template of the IPv6 header and the
+ * fragment extension header.
+ */
+static inline int32_t
+ipv6_frag_bulk_one(struct rte_mbuf *pkt_in, struct rte_mbuf **pkts_out,
+	uint16_t nb_pkts_out, uint16_t mtu_size, uint32_t frag_size,
+	struct rte_mempool *pool_direct, struct rte_mempool *pool_indirect)
+{
+	struct rte_mbuf *segs[IP_FRAG_BULK_SEG_MAX];
+	struct {
+		struct rte_ipv6_hdr ip;
+		struct ipv6_extension_fragment fh;
+	} __attribute__((__packed__)) tmpl, *out_hdr;
+	const struct rte_ipv6_hdr *in_hdr;
+	uint32_t i, nb_frags, nb_segs, mf;
+	uint16_t fragment_offset;
+	int ret;
+
+	nb_frags = (pkt_in->pkt_len - sizeof(struct rte_ipv6_hdr) +
+		frag_size - 1) / frag_size;
+
+	/* Check that pkts_out is big enough to hold all fragments */
+	if (unlikely(nb_frags > nb_pkts_out))
+		return -EINVAL;
+
+	nb_segs = ip_frag_bulk_nb_segs(pkt_in, sizeof(struct rte_ipv6_hdr),
+		frag_size);
+
+	/* leave packets without payload or with many segments as is */
+	if (unlikely(nb_frags == 0 || nb_segs > IP_FRAG_BULK_SEG_MAX))
+		return rte_ipv6_fragment_packet(pkt_in, pkts_out, nb_pkts_out,
+			mtu_size, pool_direct, pool_indirect);
+
+	ret = ip_frag_bulk_alloc(pkts_out, nb_frags, segs, nb_segs,
+		pool_direct, pool_indirect);
+	if (unlikely(ret != 0))
+		return ret;
+
+	ip_frag_bulk_chain(pkt_in, sizeof(struct rte_ipv6_hdr), frag_size,
+		pkts_out, nb_frags, segs, sizeof(tmpl));
+
+	in_hdr = rte_pktmbuf_mtod(pkt_in, const struct rte_ipv6_hdr *);
+	rte_memcpy(&tmpl.ip, in_hdr, sizeof(tmpl.ip));
+	tmpl.ip.proto = IPPROTO_FRAGMENT;
+	tmpl.fh.next_header = in_hdr->proto;
+	tmpl.fh.reserved = 0;
+	tmpl.fh.id = 0;
+	fragment_offset = 0;
+
+	for (i = 0; i != nb_frags; i++) {
+		mf = (i != nb_frags - 1);
+		out_hdr = rte_pktmbuf_mtod(pkts_out[i], void *);
+		rte_memcpy(out_hdr, &tmpl, sizeof(tmpl));
+		out_hdr->ip.payload_len = rte_cpu_to_be_16((uint16_t)
+			(pkts_out[i]->pkt_len - sizeof(struct rte_ipv6_hdr)));
+		out_hdr->fh.frag_data = rte_cpu_to_be_16(
+			RTE_IPV6_SET_FRAG_DATA(fragment_offset, mf));
+
+		fragment_offset = (uint16_t)(fragment_offset +
+			pkts_out[i]->pkt_len - sizeof(tmpl));
+	}
+
+	return nb_frags;
+}
+
+uint16_t
+rte_ipv4_fragment_bulk(struct rte_mbuf **pkts_in, uint16_t nb_pkts_in,
+	struct rte_mbuf **pkts_out, uint16_t nb_pkts_out, uint16_t mtu_size,
+	struct rte_mempool *pool_direct, struct rte_mempool *pool_indirect,
+	uint16_t *nb_frags)
+{
+	uint32_t i, frag_size, out_pos;
+	int32_t ret;
+
+	/*
+	 * Ensure the IP payload length of all fragments is aligned to a
+	 * multiple of 8 bytes as per RFC791 section 2.3.
+	 */
+	frag_size = RTE_ALIGN_FLOOR((mtu_size - sizeof(struct rte_ipv4_hdr)),
+		RTE_IPV4_HDR_OFFSET_UNITS);
+
+	out_pos = 0;
+	for (i = 0; i != nb_pkts_in; i++) {
+		ret = ipv4_frag_bulk_one(pkts_in[i], pkts_out + out_pos,
+			nb_pkts_out - out_pos, mtu_size, frag_size,
+			pool_direct, pool_indirect);
+		if (unlikely(ret < 0)) {
+			rte_errno = -ret;
+			break;
+		}
+		out_pos += ret;
+	}
+
+	*nb_frags = out_pos;
+	return i;
+}
+
+uint16_t
+rte_ipv6_fragment_bulk(struct rte_mbuf **pkts_in, uint16_t nb_pkts_in,
+	struct rte_mbuf **pkts_out, uint16_t nb_pkts_out, uint16_t mtu_size,
+	struct rte_mempool *pool_direct, struct rte_mempool *pool_indirect,
+	uint16_t *nb_frags)
+{
+	uint32_t i, frag_size, out_pos;
+	int32_t ret;
+
+	/*
+	 * Ensure the IP payload length of all fragments (except the
+	 * the last fragment) are a multiple of 8 bytes per RFC2460.
+	 */
+	frag_size = mtu_size - sizeof(struct rte_ipv6_hdr) -
+		sizeof(struct ipv6_extension_fragment);
+	frag_size = RTE_ALIGN_FLOOR(frag_size, RTE_IPV6_EHDR_FO_ALIGN);
+
+	out_pos = 0;
+	for (i = 0; i != nb_pkts_in; i++) {
+		ret = ipv6_frag_bulk_one(pkts_in[i], pkts_out + out_pos,
+			nb_pkts_out - out_pos, mtu_size, frag_size,
+			pool_direct, pool_indirect);
+		if (unlikely(ret < 0)) {
+			rte_errno = -ret;
+			break;
+		}
+		out_pos += ret;
+	}
+
+	*nb_frags = out_pos;
+	return i;
+}
@@ -0,0 +1,202 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stddef.h>
+
+#include <rte_memcpy.h>
+
+#include "ip_frag_common.h"
+
+/* number of fragments hashed and prefetched at once */
+#define IP_FRAG_BULK_SIZE	32
+
+/* number of mbufs prefetched while freeing death row */
+#define IP_FRAG_BULK_DR_PREFETCH	3
+
+/* parsed fragment */
+struct ip_frag_bulk_ent {
+	struct ip_frag_key key;  /* fragmentation key */
+	uint32_t sig1;           /* primary hash value of the key */
+	uint32_t sig2;           /* secondary hash value of the key */
+	int32_t len;             /* length of fragment */
+	uint16_t ofs;            /* offset into the packet */
+	uint16_t more_frags;     /* more fragments follow */
+};
+
+/*
+ * Fill the key and the offset/length of a fragment.
+ * Return 0 if the packet isn't an IPv4 or IPv6 fragment.
+ */
+static inline int
+ip_frag_bulk_parse(struct rte_mbuf *mb, struct ip_frag_bulk_ent *ent)
+{
+	struct rte_ipv4_hdr *ipv4_hdr;
+	struct rte_ipv6_hdr *ipv6_hdr;
+	struct ipv6_extension_fragment *frag_hdr;
+	const unaligned_uint64_t *psd;
+	uint16_t flag_offset;
+
+	ipv4_hdr = rte_pktmbuf_mtod_offset(mb, struct rte_ipv4_hdr *,
+			mb->l2_len);
+
+	switch (ipv4_hdr->version_ihl >> 4) {
+	case 4:
+		if (!rte_ipv4_frag_pkt_is_fragmented(ipv4_hdr))
+			return 0;
+
+		psd = (unaligned_uint64_t *)&ipv4_hdr->src_addr;
+		/* use first 8 bytes only */
+		ent->key.src_dst[0] = psd[0];
+		ent->key.id = ipv4_hdr->packet_id;
+		ent->key.key_len = IPV4_KEYLEN;
+
+		flag_offset = rte_be_to_cpu_16(ipv4_hdr->fragment_offset);
+		ent->ofs = (uint16_t)(flag_offset & RTE_IPV4_HDR_OFFSET_MASK) *
+			RTE_IPV4_HDR_OFFSET_UNITS;
+		ent->more_frags = (uint16_t)(flag_offset & RTE_IPV4_HDR_MF_FLAG);
+		ent->len = rte_be_to_cpu_16(ipv4_hdr->total_length) -
+			mb->l3_len;
+		return 1;
+	case 6:
+		ipv6_hdr = (struct rte_ipv6_hdr *)ipv4_hdr;
+		frag_hdr = rte_ipv6_frag_get_ipv6_fragment_header(ipv6_hdr);
+		if (frag_hdr == NULL)
+			return 0;
+
+		rte_memcpy(&ent->key.src_dst[0], ipv6_hdr->src_addr, 16);
+		rte_memcpy(&ent->key.src_dst[2], ipv6_hdr->dst_addr, 16);
+		ent->key.id = frag_hdr->id;
+		ent->key.key_len = IPV6_KEYLEN;
+
+		flag_offset = rte_be_to_cpu_16(frag_hdr->frag_data);
+		ent->ofs = RTE_IPV6_GET_FO(flag_offset) * 8;
+		ent->more_frags = RTE_IPV6_GET_MF(flag_offset);
+		/* only the fragment header is supported, as for single packets */
+		ent->len = rte_be_to_cpu_16(ipv6_hdr->payload_len) -
+			sizeof(*frag_hdr);
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * Process a parsed fragment, the same way as
+ * rte_ipv4_frag_reassemble_packet() and rte_ipv6_frag_reassemble_packet().
+ */
+static inline struct rte_mbuf *
+ip_frag_bulk_process(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf *mb,
+	const struct ip_frag_bulk_ent *ent, uint64_t tms)
+{
+	struct ip_frag_pkt *fp;
+
+	/* check that fragment length is greater then zero. */
+	if (ent->len <= 0) {
+		IP_FRAG_MBUF2DR(dr, mb);
+		return NULL;
+	}
+
+	/* try to find/add entry into the fragment's table. */
+	fp = ip_frag_find_hash(tbl, dr, &ent->key, tms, ent->sig1, ent->sig2);
+	if (fp == NULL) {
+		IP_FRAG_MBUF2DR(dr, mb);
+		return NULL;
+	}
+
+	/* process the fragmented packet. */
+	mb = ip_frag_process(fp, dr, mb, ent->ofs, ent->len, ent->more_frags);
+	ip_frag_inuse(tbl, fp);
+
+	return mb;
+}
+
+/* select the shard of a fragment by the hash value of its key */
+static inline struct ip_frag_shard *
+ip_frag_bulk_shard(struct rte_ip_frag_shared_tbl *stbl, uint32_t sig)
+{
+	return &stbl->shard[((uint64_t)sig * stbl->nb_shards) >> 32];
+}
+
+/*
+ * Reassemble a burst with either a private table (tbl) or a shared
+ * table (stbl). Up to IP_FRAG_BULK_SIZE fragments are parsed, hashed and
+ * have their buckets prefetched before they are processed one by one.
+ */
+static inline uint16_t
+ip_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_shared_tbl *stbl, struct rte_ip_frag_death_row *dr,
+	struct rte_mbuf **pkts, uint16_t nb_pkts, uint64_t tms,
+	struct rte_mbuf **out)
+{
+	struct ip_frag_bulk_ent ent[IP_FRAG_BULK_SIZE];
+	uint8_t is_frag[IP_FRAG_BULK_SIZE];
+	struct ip_frag_shard *sh;
+	struct rte_mbuf *mb;
+	uint32_t i, j, n;
+	uint16_t nb_out;
+
+	nb_out = 0;
+
+	for (i = 0; i < nb_pkts; i += n) {
+		n = RTE_MIN(nb_pkts - i, (uint32_t)IP_FRAG_BULK_SIZE);
+
+		for (j = 0; j != n; j++) {
+			is_frag[j] = ip_frag_bulk_parse(pkts[i + j], &ent[j]);
+			if (is_frag[j] == 0)
+				continue;
+
+			ip_frag_key_hash(&ent[j].key, &ent[j].sig1,
+					&ent[j].sig2);
+			if (stbl != NULL)
+				tbl = ip_frag_bulk_shard(stbl, ent[j].sig1)->tbl;
+			ip_frag_prefetch(tbl, ent[j].sig1, ent[j].sig2);
+		}
+
+		for (j = 0; j != n; j++) {
+			mb = pkts[i + j];
+			if (is_frag[j] == 0) {
+				out[nb_out++] = mb;
+				continue;
+			}
+
+			/* make room for the mbufs the fragment may release */
+			if (IP_FRAG_DEATH_ROW_MBUF_LEN - dr->cnt <
+					IP_FRAG_DEATH_ROW_PKT_MAX)
+				rte_ip_frag_free_death_row(dr,
+						IP_FRAG_BULK_DR_PREFETCH);
+
+			if (stbl != NULL) {
+				sh = ip_frag_bulk_shard(stbl, ent[j].sig1);
+				rte_spinlock_lock(&sh->lock);
+				mb = ip_frag_bulk_process(sh->tbl, dr, mb,
+						&ent[j], tms);
+				rte_spinlock_unlock(&sh->lock);
+			} else
+				mb = ip_frag_bulk_process(tbl, dr, mb,
+						&ent[j], tms);
+
+			if (mb != NULL)
+				out[nb_out++] = mb;
+		}
+	}
+
+	return nb_out;
+}
+
+uint16_t
+rte_ip_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **pkts,
+	uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out)
+{
+	return ip_frag_reassemble_bulk(tbl, NULL, dr, pkts, nb_pkts, tms, out);
+}
+
+uint16_t
+rte_ip_frag_shared_reassemble_bulk(struct rte_ip_frag_shared_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, struct rte_mbuf **pkts,
+	uint16_t nb_pkts, uint64_t tms, struct rte_mbuf **out)
+{
+	return ip_frag_reassemble_bulk(NULL, tbl, dr, pkts, nb_pkts, tms, out);
+}
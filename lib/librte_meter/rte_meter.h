@@ -23,6 +23,9 @@ extern "C" {
 
 #include <stdint.h>
 
+#include <rte_common.h>
+#include <rte_prefetch.h>
+
 #include "rte_compat.h"
 
 /*
@@ -327,6 +330,136 @@ rte_meter_trtcm_rfc4115_color_aware_check(
 	uint32_t pkt_len,
 	enum rte_color pkt_color);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * srTCM color blind traffic metering for a burst of packets
+ *
+ * The meter run-time contexts are prefetched ahead of use. The packets are
+ * metered in array order, so the same meter can be used by several packets
+ * of the burst.
+ *
+ * @param m
+ *    Array of handles to srTCM instances, one per packet
+ * @param p
+ *    Array of srTCM profiles specified at srTCM object creation time, one per
+ *    packet
+ * @param time
+ *    Array of current CPU time stamps (measured in CPU cycles), one per packet
+ * @param pkt_len
+ *    Array of lengths of the IP packets (measured in bytes)
+ * @param color
+ *    Array to be filled with the colors assigned to the packets
+ * @param n_pkts
+ *    Number of packets
+ */
+static inline void
+rte_meter_srtcm_color_blind_check_bulk(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * srTCM color aware traffic metering for a burst of packets
+ *
+ * The meter run-time contexts are prefetched ahead of use. The packets are
+ * metered in array order, so the same meter can be used by several packets
+ * of the burst.
+ *
+ * @param m
+ *    Array of handles to srTCM instances, one per packet
+ * @param p
+ *    Array of srTCM profiles specified at srTCM object creation time, one per
+ *    packet
+ * @param time
+ *    Array of current CPU time stamps (measured in CPU cycles), one per packet
+ * @param pkt_len
+ *    Array of lengths of the IP packets (measured in bytes)
+ * @param color
+ *    Array of input colors of the packets, overwritten with the colors
+ *    assigned to the packets
+ * @param n_pkts
+ *    Number of packets
+ */
+static inline void
+rte_meter_srtcm_color_aware_check_bulk(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM color blind traffic metering for a burst of packets
+ *
+ * The meter run-time contexts are prefetched ahead of use. The packets are
+ * metered in array order, so the same meter can be used by several packets
+ * of the burst.
+ *
+ * @param m
+ *    Array of handles to trTCM instances, one per packet
+ * @param p
+ *    Array of trTCM profiles specified at trTCM object creation time, one per
+ *    packet
+ * @param time
+ *    Array of current CPU time stamps (measured in CPU cycles), one per packet
+ * @param pkt_len
+ *    Array of lengths of the IP packets (measured in bytes)
+ * @param color
+ *    Array to be filled with the colors assigned to the packets
+ * @param n_pkts
+ *    Number of packets
+ */
+static inline void
+rte_meter_trtcm_color_blind_check_bulk(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * trTCM color aware traffic metering for a burst of packets
+ *
+ * The meter run-time contexts are prefetched ahead of use. The packets are
+ * metered in array order, so the same meter can be used by several packets
+ * of the burst.
+ *
+ * @param m
+ *    Array of handles to trTCM instances, one per packet
+ * @param p
+ *    Array of trTCM profiles specified at trTCM object creation time, one per
+ *    packet
+ * @param time
+ *    Array of current CPU time stamps (measured in CPU cycles), one per packet
+ * @param pkt_len
+ *    Array of lengths of the IP packets (measured in bytes)
+ * @param color
+ *    Array of input colors of the packets, overwritten with the colors
+ *    assigned to the packets
+ * @param n_pkts
+ *    Number of packets
+ */
+static inline void
+rte_meter_trtcm_color_aware_check_bulk(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts);
+
 /*
  * Inline implementation of run-time methods
  *
@@ -666,6 +799,191 @@ rte_meter_trtcm_rfc4115_color_aware_check(
 	return RTE_COLOR_RED;
 }
 
+/*
+ * Bulk run-time methods
+ *
+ * The token bucket division is skipped when the bucket is not due for update,
+ * which is the common case for the packets of the same burst, and the color
+ * is computed from the bucket compare results without branches.
+ *
+ ***/
+
+#ifndef RTE_METER_BULK_PREFETCH
+#define RTE_METER_BULK_PREFETCH      8
+#endif
+
+static inline uint64_t
+__rte_meter_n_periods(uint64_t time_diff, uint64_t period)
+{
+	if (time_diff < period)
+		return 0;
+
+	return time_diff / period;
+}
+
+static inline void
+__rte_meter_bulk_prefetch(void **m, uint32_t n_pkts)
+{
+	uint32_t i;
+
+	for (i = 0; i < RTE_METER_BULK_PREFETCH && i < n_pkts; i++)
+		rte_prefetch0(m[i]);
+}
+
+static __rte_always_inline enum rte_color
+__rte_meter_srtcm_check(struct rte_meter_srtcm *m,
+	struct rte_meter_srtcm_profile *p,
+	uint64_t time,
+	uint64_t pkt_len,
+	uint64_t green_ok,
+	uint64_t yellow_ok)
+{
+	uint64_t n_periods, tc, te, c_ok, e_ok;
+
+	/* Bucket update */
+	n_periods = __rte_meter_n_periods(time - m->time, p->cir_period);
+	m->time += n_periods * p->cir_period;
+
+	/* Put the tokens overflowing from tc into te bucket */
+	tc = m->tc + n_periods * p->cir_bytes_per_period;
+	te = m->te;
+	if (tc > p->cbs) {
+		te += (tc - p->cbs);
+		if (te > p->ebs)
+			te = p->ebs;
+		tc = p->cbs;
+	}
+
+	/* Color logic */
+	c_ok = green_ok & (tc >= pkt_len);
+	e_ok = yellow_ok & (c_ok ^ 1) & (te >= pkt_len);
+	m->tc = tc - (pkt_len & -c_ok);
+	m->te = te - (pkt_len & -e_ok);
+
+	return (enum rte_color)(RTE_COLOR_RED - 2 * c_ok - e_ok);
+}
+
+static __rte_always_inline enum rte_color
+__rte_meter_trtcm_check(struct rte_meter_trtcm *m,
+	struct rte_meter_trtcm_profile *p,
+	uint64_t time,
+	uint64_t pkt_len,
+	uint64_t green_ok,
+	uint64_t yellow_ok)
+{
+	uint64_t n_periods_tc, n_periods_tp, tc, tp, c_ok, p_ok;
+
+	/* Bucket update */
+	n_periods_tc = __rte_meter_n_periods(time - m->time_tc, p->cir_period);
+	n_periods_tp = __rte_meter_n_periods(time - m->time_tp, p->pir_period);
+	m->time_tc += n_periods_tc * p->cir_period;
+	m->time_tp += n_periods_tp * p->pir_period;
+
+	tc = m->tc + n_periods_tc * p->cir_bytes_per_period;
+	if (tc > p->cbs)
+		tc = p->cbs;
+
+	tp = m->tp + n_periods_tp * p->pir_bytes_per_period;
+	if (tp > p->pbs)
+		tp = p->pbs;
+
+	/* Color logic */
+	p_ok = yellow_ok & (tp >= pkt_len);
+	c_ok = green_ok & p_ok & (tc >= pkt_len);
+	m->tc = tc - (pkt_len & -c_ok);
+	m->tp = tp - (pkt_len & -p_ok);
+
+	return (enum rte_color)(RTE_COLOR_RED - c_ok - p_ok);
+}
+
+static inline void
+rte_meter_srtcm_color_blind_check_bulk(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	__rte_meter_bulk_prefetch((void **)m, n_pkts);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH]);
+
+		color[i] = __rte_meter_srtcm_check(m[i], p[i], time[i],
+			pkt_len[i], 1, 1);
+	}
+}
+
+static inline void
+rte_meter_srtcm_color_aware_check_bulk(struct rte_meter_srtcm **m,
+	struct rte_meter_srtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	__rte_meter_bulk_prefetch((void **)m, n_pkts);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH]);
+
+		color[i] = __rte_meter_srtcm_check(m[i], p[i], time[i],
+			pkt_len[i],
+			color[i] == RTE_COLOR_GREEN,
+			color[i] != RTE_COLOR_RED);
+	}
+}
+
+static inline void
+rte_meter_trtcm_color_blind_check_bulk(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	__rte_meter_bulk_prefetch((void **)m, n_pkts);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH]);
+
+		color[i] = __rte_meter_trtcm_check(m[i], p[i], time[i],
+			pkt_len[i], 1, 1);
+	}
+}
+
+static inline void
+rte_meter_trtcm_color_aware_check_bulk(struct rte_meter_trtcm **m,
+	struct rte_meter_trtcm_profile **p,
+	const uint64_t *time,
+	const uint32_t *pkt_len,
+	enum rte_color *color,
+	uint32_t n_pkts)
+{
+	uint32_t i;
+
+	__rte_meter_bulk_prefetch((void **)m, n_pkts);
+
+	for (i = 0; i < n_pkts; i++) {
+		if (i + RTE_METER_BULK_PREFETCH < n_pkts)
+			rte_prefetch0(m[i + RTE_METER_BULK_PREFETCH]);
+
+		color[i] = __rte_meter_trtcm_check(m[i], p[i], time[i],
+			pkt_len[i],
+			color[i] == RTE_COLOR_GREEN,
+			color[i] != RTE_COLOR_RED);
+	}
+}
+
 
 #ifdef __cplusplus
 }
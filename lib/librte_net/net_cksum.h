@@ -0,0 +1,21 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#ifndef _NET_CKSUM_H_
+#define _NET_CKSUM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Raw checksum implementations built in their own object file, with the
+ * compiler flags of the instruction set they use. Like __rte_raw_cksum(),
+ * they add the 16-bit words of the buffer to sum, without reducing it.
+ */
+
+/* AVX2 implementation */
+uint32_t
+net_raw_cksum_avx2(const void *buf, size_t len, uint32_t sum);
+
+#endif /* _NET_CKSUM_H_ */
@@ -0,0 +1,70 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdint.h>
+
+#include <rte_common.h>
+#include <rte_ip.h>
+#include <rte_vect.h>
+
+#include "net_cksum.h"
+
+/*
+ * Each 32-bit lane of an accumulator gets two 16-bit words per 32-byte
+ * vector, so it cannot overflow before 2^15 vectors: flush the
+ * accumulators to the 64-bit sum every 8192 blocks of 64 bytes.
+ */
+#define CKSUM_AVX2_FLUSH_BLOCKS	8192
+
+static inline uint64_t
+cksum_avx2_hsum(__m256i v)
+{
+	uint32_t w[8] __rte_aligned(32);
+	uint64_t sum = 0;
+	uint32_t i;
+
+	_mm256_store_si256((__m256i *)w, v);
+	for (i = 0; i != RTE_DIM(w); i++)
+		sum += w[i];
+
+	return sum;
+}
+
+uint32_t
+net_raw_cksum_avx2(const void *buf, size_t len, uint32_t sum)
+{
+	const __m256i mask = _mm256_set1_epi32(0xffff);
+	const uint8_t *p = buf;
+	__m256i acc0, acc1, v0, v1;
+	uint64_t total = sum;
+	size_t n, i, blk;
+
+	/* the lanes hold the words in CPU order, as the scalar sum */
+	for (n = len / 64; n != 0; n -= blk) {
+		blk = RTE_MIN(n, (size_t)CKSUM_AVX2_FLUSH_BLOCKS);
+		acc0 = _mm256_setzero_si256();
+		acc1 = _mm256_setzero_si256();
+		for (i = 0; i != blk; i++, p += 64) {
+			v0 = _mm256_loadu_si256((const __m256i *)p);
+			v1 = _mm256_loadu_si256((const __m256i *)(p + 32));
+			acc0 = _mm256_add_epi32(acc0,
+				_mm256_and_si256(v0, mask));
+			acc1 = _mm256_add_epi32(acc1,
+				_mm256_and_si256(v1, mask));
+			acc0 = _mm256_add_epi32(acc0,
+				_mm256_srli_epi32(v0, 16));
+			acc1 = _mm256_add_epi32(acc1,
+				_mm256_srli_epi32(v1, 16));
+		}
+		total += cksum_avx2_hsum(_mm256_add_epi32(acc0, acc1));
+	}
+
+	total += __rte_raw_cksum(p, len % 64, 0);
+
+	/* fold with end around carry, as 2^32 is 1 modulo 0xffff */
+	total = (total >> 32) + (total & UINT32_MAX);
+	total = (total >> 32) + (total & UINT32_MAX);
+
+	return (uint32_t)total;
+}
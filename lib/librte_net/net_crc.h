@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#ifndef _NET_CRC_H_
+#define _NET_CRC_H_
+
+#include <stdint.h>
+
+/*
+ * Handlers of the CRC implementations built in their own object file,
+ * with the compiler flags of the instruction set they use.
+ */
+
+/* AVX512 VPCLMULQDQ handlers */
+void
+rte_net_crc_avx512_init(void);
+
+uint32_t
+rte_crc16_ccitt_avx512_handler(const uint8_t *data, uint32_t data_len);
+
+uint32_t
+rte_crc32_eth_avx512_handler(const uint8_t *data, uint32_t data_len);
+
+uint32_t
+rte_crc32c_avx512_handler(const uint8_t *data, uint32_t data_len);
+
+void
+rte_crc16_ccitt_avx512_bulk_handler(const uint8_t * const data[],
+	const uint32_t data_len[], uint32_t crc[], uint32_t nb);
+
+void
+rte_crc32_eth_avx512_bulk_handler(const uint8_t * const data[],
+	const uint32_t data_len[], uint32_t crc[], uint32_t nb);
+
+void
+rte_crc32c_avx512_bulk_handler(const uint8_t * const data[],
+	const uint32_t data_len[], uint32_t crc[], uint32_t nb);
+
+#endif /* _NET_CRC_H_ */
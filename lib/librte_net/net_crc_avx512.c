@@ -0,0 +1,505 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <string.h>
+
+#include <rte_common.h>
+#include <rte_branch_prediction.h>
+
+#include <x86intrin.h>
+
+#include "net_crc.h"
+
+/** VPCLMULQDQ CRC computation context structure */
+struct crc_vpclmulqdq_ctx {
+	__m512i fold_4x512;	/**< rk1 and rk2 to fold by 2048 bits */
+	__m512i fold_1x512;	/**< rk1 and rk2 to fold by 512 bits */
+	__m512i fold_3x128;	/**< rk1 and rk2 to fold lanes 0-2 on lane 3 */
+	__m128i rk1_rk2;	/**< rk1 and rk2 to fold by 128 bits */
+	__m128i rk5_rk6;
+	__m128i rk7_rk8;
+};
+
+static struct crc_vpclmulqdq_ctx crc32_eth_vpclmulqdq __rte_aligned(64);
+static struct crc_vpclmulqdq_ctx crc16_ccitt_vpclmulqdq __rte_aligned(64);
+static struct crc_vpclmulqdq_ctx crc32c_vpclmulqdq __rte_aligned(64);
+
+/* number of buffers the bulk handlers process in parallel, one per lane */
+#define CRC_BULK_LANES 4
+
+/**
+ * Performs one folding round of the four 128-bit lanes of a zmm register,
+ * the same way as crcr32_folding_round().
+ */
+static __rte_always_inline __m512i
+crcr32_folding_round_512(__m512i data_block, __m512i precomp, __m512i fold)
+{
+	__m512i tmp0 = _mm512_clmulepi64_epi128(fold, precomp, 0x01);
+	__m512i tmp1 = _mm512_clmulepi64_epi128(fold, precomp, 0x10);
+
+	/* tmp0 ^ tmp1 ^ data_block */
+	return _mm512_ternarylogic_epi64(tmp0, tmp1, data_block, 0x96);
+}
+
+/**
+ * Performs one folding round
+ *
+ * @param data_block
+ *   16 byte data block
+ * @param precomp
+ *   Precomputed rk1 constant
+ * @param fold
+ *   Current16 byte folded data
+ *
+ * @return
+ *   New 16 byte folded data
+ */
+static __rte_always_inline __m128i
+crcr32_folding_round(__m128i data_block, __m128i precomp, __m128i fold)
+{
+	__m128i tmp0 = _mm_clmulepi64_si128(fold, precomp, 0x01);
+	__m128i tmp1 = _mm_clmulepi64_si128(fold, precomp, 0x10);
+
+	return _mm_xor_si128(tmp1, _mm_xor_si128(data_block, tmp0));
+}
+
+/**
+ * Performs reduction from 128 bits to 64 bits
+ */
+static __rte_always_inline __m128i
+crcr32_reduce_128_to_64(__m128i data128, __m128i precomp)
+{
+	__m128i tmp0, tmp1, tmp2;
+
+	/* 64b fold */
+	tmp0 = _mm_clmulepi64_si128(data128, precomp, 0x00);
+	tmp1 = _mm_srli_si128(data128, 8);
+	tmp0 = _mm_xor_si128(tmp0, tmp1);
+
+	/* 32b fold */
+	tmp2 = _mm_slli_si128(tmp0, 4);
+	tmp1 = _mm_clmulepi64_si128(tmp2, precomp, 0x10);
+
+	return _mm_xor_si128(tmp1, tmp0);
+}
+
+/**
+ * Performs Barret's reduction from 64 bits to 32 bits
+ */
+static __rte_always_inline uint32_t
+crcr32_reduce_64_to_32(__m128i data64, __m128i precomp)
+{
+	static const uint32_t mask1[4] __rte_aligned(16) = {
+		0xffffffff, 0xffffffff, 0x00000000, 0x00000000
+	};
+
+	static const uint32_t mask2[4] __rte_aligned(16) = {
+		0x00000000, 0xffffffff, 0xffffffff, 0xffffffff
+	};
+	__m128i tmp0, tmp1, tmp2;
+
+	tmp0 = _mm_and_si128(data64, _mm_load_si128((const __m128i *)mask2));
+
+	tmp1 = _mm_clmulepi64_si128(tmp0, precomp, 0x00);
+	tmp1 = _mm_xor_si128(tmp1, tmp0);
+	tmp1 = _mm_and_si128(tmp1, _mm_load_si128((const __m128i *)mask1));
+
+	tmp2 = _mm_clmulepi64_si128(tmp1, precomp, 0x10);
+	tmp2 = _mm_xor_si128(tmp2, tmp1);
+	tmp2 = _mm_xor_si128(tmp2, tmp0);
+
+	return _mm_extract_epi32(tmp2, 2);
+}
+
+static const uint8_t crc_xmm_shift_tab[48] __rte_aligned(16) = {
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+/**
+ * Shifts left 128 bit register by specified number of bytes
+ */
+static __rte_always_inline __m128i
+xmm_shift_left(__m128i reg, const unsigned int num)
+{
+	const __m128i *p = (const __m128i *)(crc_xmm_shift_tab + 16 - num);
+
+	return _mm_shuffle_epi8(reg, _mm_loadu_si128(p));
+}
+
+/**
+ * Folds the data from offset n, 16 bytes at a time, into the 16 byte fold
+ * of the first n bytes, and reduces the result to the 32-bit CRC.
+ * Assumes: data_len >= 16, n >= 16, n is a multiple of 16 and n <= data_len
+ */
+static __rte_always_inline uint32_t
+crc32_eth_fold_tail_vpclmulqdq(const uint8_t *data,
+	uint32_t data_len,
+	uint32_t n,
+	__m128i fold,
+	const struct crc_vpclmulqdq_ctx *params)
+{
+	__m128i temp, k;
+
+	k = params->rk1_rk2;
+	for (; (n + 16) <= data_len; n += 16) {
+		temp = _mm_loadu_si128((const __m128i *)&data[n]);
+		fold = crcr32_folding_round(temp, k, fold);
+	}
+
+	if (likely(n < data_len)) {
+
+		const uint32_t mask3[4] __rte_aligned(16) = {
+			0x80808080, 0x80808080, 0x80808080, 0x80808080
+		};
+
+		const uint8_t shf_table[32] __rte_aligned(16) = {
+			0x00, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+			0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+			0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+			0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+		};
+
+		__m128i last16, a, b;
+
+		last16 = _mm_loadu_si128((const __m128i *)&data[data_len - 16]);
+
+		temp = _mm_loadu_si128((const __m128i *)
+			&shf_table[data_len & 15]);
+		a = _mm_shuffle_epi8(fold, temp);
+
+		temp = _mm_xor_si128(temp,
+			_mm_load_si128((const __m128i *)mask3));
+		b = _mm_shuffle_epi8(fold, temp);
+		b = _mm_blendv_epi8(b, last16, temp);
+
+		/* k = rk1 & rk2 */
+		temp = _mm_clmulepi64_si128(a, k, 0x01);
+		fold = _mm_clmulepi64_si128(a, k, 0x10);
+
+		fold = _mm_xor_si128(fold, temp);
+		fold = _mm_xor_si128(fold, b);
+	}
+
+	/** Reduction 128 -> 32 Assumes: fold holds 128bit folded data */
+	fold = crcr32_reduce_128_to_64(fold, params->rk5_rk6);
+
+	return crcr32_reduce_64_to_32(fold, params->rk7_rk8);
+}
+
+/**
+ * Computes the CRC of less than 16 bytes.
+ */
+static __rte_always_inline uint32_t
+crc32_eth_calc_short_vpclmulqdq(const uint8_t *data,
+	uint32_t data_len,
+	__m128i temp,
+	const struct crc_vpclmulqdq_ctx *params)
+{
+	uint8_t buffer[16] __rte_aligned(16);
+	__m128i fold;
+
+	memset(buffer, 0, sizeof(buffer));
+	memcpy(buffer, data, data_len);
+
+	fold = _mm_load_si128((const __m128i *)buffer);
+	fold = _mm_xor_si128(fold, temp);
+	if (unlikely(data_len < 4)) {
+		fold = xmm_shift_left(fold, 8 - data_len);
+		return crcr32_reduce_64_to_32(fold, params->rk7_rk8);
+	}
+	fold = xmm_shift_left(fold, 16 - data_len);
+	fold = crcr32_reduce_128_to_64(fold, params->rk5_rk6);
+
+	return crcr32_reduce_64_to_32(fold, params->rk7_rk8);
+}
+
+/**
+ * Folds 512 bits of the four 128-bit lanes of fold into its last lane.
+ */
+static __rte_always_inline __m128i
+crcr32_reduce_512_to_128(__m512i fold, __m512i precomp)
+{
+	__m512i tmp0 = _mm512_clmulepi64_epi128(fold, precomp, 0x01);
+	__m512i tmp1 = _mm512_clmulepi64_epi128(fold, precomp, 0x10);
+	__m128i res;
+
+	/* the constants of the last lane are zero */
+	tmp0 = _mm512_xor_si512(tmp0, tmp1);
+	res = _mm_xor_si128(_mm512_extracti32x4_epi32(tmp0, 0),
+		_mm512_extracti32x4_epi32(tmp0, 1));
+	res = _mm_xor_si128(res, _mm512_extracti32x4_epi32(tmp0, 2));
+
+	return _mm_xor_si128(res, _mm512_extracti32x4_epi32(fold, 3));
+}
+
+static __rte_always_inline uint32_t
+crc32_eth_calc_vpclmulqdq(
+	const uint8_t *data,
+	uint32_t data_len,
+	uint32_t crc,
+	const struct crc_vpclmulqdq_ctx *params)
+{
+	__m512i x0, x1, x2, x3, k;
+	__m128i temp, fold;
+	uint32_t n;
+
+	/* Get CRC init value */
+	temp = _mm_cvtsi32_si128(crc);
+
+	if (unlikely(data_len < 16))
+		return crc32_eth_calc_short_vpclmulqdq(data, data_len, temp,
+			params);
+
+	/* Less than 4 x 512 bits, fold 128 bits at a time */
+	if (data_len < 256) {
+		fold = _mm_loadu_si128((const __m128i *)data);
+		fold = _mm_xor_si128(fold, temp);
+		return crc32_eth_fold_tail_vpclmulqdq(data, data_len, 16,
+			fold, params);
+	}
+
+	/* Apply CRC initial value to the first 4 x 512 bits */
+	x0 = _mm512_loadu_si512((const void *)data);
+	x1 = _mm512_loadu_si512((const void *)(data + 64));
+	x2 = _mm512_loadu_si512((const void *)(data + 128));
+	x3 = _mm512_loadu_si512((const void *)(data + 192));
+	x0 = _mm512_xor_si512(x0,
+		_mm512_inserti32x4(_mm512_setzero_si512(), temp, 0));
+
+	/* Main folding loop, 4 x 512 bits at a time */
+	k = params->fold_4x512;
+	for (n = 256; (n + 256) <= data_len; n += 256) {
+		x0 = crcr32_folding_round_512(_mm512_loadu_si512(
+			(const void *)&data[n]), k, x0);
+		x1 = crcr32_folding_round_512(_mm512_loadu_si512(
+			(const void *)&data[n + 64]), k, x1);
+		x2 = crcr32_folding_round_512(_mm512_loadu_si512(
+			(const void *)&data[n + 128]), k, x2);
+		x3 = crcr32_folding_round_512(_mm512_loadu_si512(
+			(const void *)&data[n + 192]), k, x3);
+	}
+
+	/* Fold the 4 x 512 bits into 512 bits, then the rest 512 bits */
+	k = params->fold_1x512;
+	x0 = crcr32_folding_round_512(x1, k, x0);
+	x0 = crcr32_folding_round_512(x2, k, x0);
+	x0 = crcr32_folding_round_512(x3, k, x0);
+	for (; (n + 64) <= data_len; n += 64)
+		x0 = crcr32_folding_round_512(_mm512_loadu_si512(
+			(const void *)&data[n]), k, x0);
+
+	/* Fold 512 bits into 128 bits, then the rest 128 bits */
+	fold = crcr32_reduce_512_to_128(x0, params->fold_3x128);
+
+	return crc32_eth_fold_tail_vpclmulqdq(data, data_len, n, fold, params);
+}
+
+/*
+ * Computes the CRC of the buffers, CRC_BULK_LANES at a time: their first
+ * bytes, up to the shortest length, are folded in the lanes of a zmm
+ * register, then each lane is folded with the rest of its buffer.
+ */
+static __rte_always_inline void
+crc32_eth_calc_bulk_vpclmulqdq(
+	const uint8_t * const data[],
+	const uint32_t data_len[],
+	uint32_t crc_out[],
+	uint32_t nb,
+	uint32_t crc,
+	const struct crc_vpclmulqdq_ctx *params)
+{
+	const uint8_t *d0, *d1, *d2, *d3;
+	__m512i x, blk, k;
+	uint32_t i, n, len;
+
+	k = _mm512_broadcast_i32x4(params->rk1_rk2);
+
+	for (i = 0; i + CRC_BULK_LANES <= nb; i += CRC_BULK_LANES) {
+		len = RTE_MIN(RTE_MIN(data_len[i], data_len[i + 1]),
+			RTE_MIN(data_len[i + 2], data_len[i + 3]));
+		len &= ~15;
+		/*
+		 * A single buffer of 256 bytes or more is folded faster in
+		 * four zmm registers.
+		 */
+		if (len < 32 || len >= 256) {
+			for (n = i; n < i + CRC_BULK_LANES; n++)
+				crc_out[n] = crc32_eth_calc_vpclmulqdq(data[n],
+					data_len[n], crc, params);
+			continue;
+		}
+
+		d0 = data[i];
+		d1 = data[i + 1];
+		d2 = data[i + 2];
+		d3 = data[i + 3];
+
+		/* Apply CRC initial value to the first 128 bits of each */
+		x = _mm512_castsi128_si512(_mm_loadu_si128((const void *)d0));
+		x = _mm512_inserti32x4(x, _mm_loadu_si128((const void *)d1), 1);
+		x = _mm512_inserti32x4(x, _mm_loadu_si128((const void *)d2), 2);
+		x = _mm512_inserti32x4(x, _mm_loadu_si128((const void *)d3), 3);
+		x = _mm512_xor_si512(x, _mm512_broadcast_i32x4(
+			_mm_cvtsi32_si128(crc)));
+
+		for (n = 16; n < len; n += 16) {
+			blk = _mm512_castsi128_si512(
+				_mm_loadu_si128((const void *)(d0 + n)));
+			blk = _mm512_inserti32x4(blk,
+				_mm_loadu_si128((const void *)(d1 + n)), 1);
+			blk = _mm512_inserti32x4(blk,
+				_mm_loadu_si128((const void *)(d2 + n)), 2);
+			blk = _mm512_inserti32x4(blk,
+				_mm_loadu_si128((const void *)(d3 + n)), 3);
+			x = crcr32_folding_round_512(blk, k, x);
+		}
+
+		crc_out[i] = crc32_eth_fold_tail_vpclmulqdq(d0,
+			data_len[i], len, _mm512_extracti32x4_epi32(x, 0),
+			params);
+		crc_out[i + 1] = crc32_eth_fold_tail_vpclmulqdq(d1,
+			data_len[i + 1], len, _mm512_extracti32x4_epi32(x, 1),
+			params);
+		crc_out[i + 2] = crc32_eth_fold_tail_vpclmulqdq(d2,
+			data_len[i + 2], len, _mm512_extracti32x4_epi32(x, 2),
+			params);
+		crc_out[i + 3] = crc32_eth_fold_tail_vpclmulqdq(d3,
+			data_len[i + 3], len, _mm512_extracti32x4_epi32(x, 3),
+			params);
+	}
+
+	/* last buffers */
+	for (; i < nb; i++)
+		crc_out[i] = crc32_eth_calc_vpclmulqdq(data[i], data_len[i],
+			crc, params);
+}
+
+static void
+crc_vpclmulqdq_ctx_init(struct crc_vpclmulqdq_ctx *ctx,
+	const uint64_t rk[12], const uint64_t k5k6[2], const uint64_t k7k8[2])
+{
+	/* rk: 2048, 512, 384, 256, 128 bits fold constants, then 0 0 */
+	ctx->fold_4x512 = _mm512_broadcast_i32x4(
+		_mm_set_epi64x(rk[1], rk[0]));
+	ctx->fold_1x512 = _mm512_broadcast_i32x4(
+		_mm_set_epi64x(rk[3], rk[2]));
+	ctx->fold_3x128 = _mm512_set_epi64(rk[11], rk[10], rk[9], rk[8],
+		rk[7], rk[6], rk[5], rk[4]);
+	ctx->rk1_rk2 = _mm_set_epi64x(rk[9], rk[8]);
+	ctx->rk5_rk6 = _mm_set_epi64x(k5k6[1], k5k6[0]);
+	ctx->rk7_rk8 = _mm_set_epi64x(k7k8[1], k7k8[0]);
+}
+
+void
+rte_net_crc_avx512_init(void)
+{
+	static const uint64_t ccitt_rk[12] = {
+		0x19208LLU, 0x2df8LLU,		/* 2048 bits */
+		0x14ff2LLU, 0x19a3cLLU,		/* 512 bits */
+		0xe3aLLU, 0x4d7aLLU,		/* 384 bits */
+		0x5b44LLU, 0x7762LLU,		/* 256 bits */
+		0x189aeLLU, 0x8e10LLU,		/* 128 bits */
+		0, 0
+	};
+	static const uint64_t ccitt_k5_k6[2] = {0x189aeLLU, 0x114aaLLU};
+	static const uint64_t ccitt_k7_k8[2] = {0x11c581910LLU, 0x10811LLU};
+
+	static const uint64_t eth_rk[12] = {
+		0x1322d1430LLU, 0x11542778aLLU,	/* 2048 bits */
+		0x1c6e41596LLU, 0x154442bd4LLU,	/* 512 bits */
+		0x174359406LLU, 0x3db1ecdcLLU,	/* 384 bits */
+		0x15a546366LLU, 0xf1da05aaLLU,	/* 256 bits */
+		0xccaa009eLLU, 0x1751997d0LLU,	/* 128 bits */
+		0, 0
+	};
+	static const uint64_t eth_k5_k6[2] = {0xccaa009eLLU, 0x163cd6124LLU};
+	static const uint64_t eth_k7_k8[2] = {0x1f7011640LLU, 0x1db710641LLU};
+
+	static const uint64_t crc32c_rk[12] = {
+		0xb9e02b86LLU, 0xdcb17aa4LLU,	/* 2048 bits */
+		0x9e4addf8LLU, 0x740eef02LLU,	/* 512 bits */
+		0x1d82c63daLLU, 0x1c291d04LLU,	/* 384 bits */
+		0xba4fc28eLLU, 0x1384aa63aLLU,	/* 256 bits */
+		0x14cd00bd6LLU, 0xf20c0dfeLLU,	/* 128 bits */
+		0, 0
+	};
+	static const uint64_t crc32c_k5_k6[2] = {0x14cd00bd6LLU, 0xdd45aab8LLU};
+	static const uint64_t crc32c_k7_k8[2] = {0xdea713f0LLU, 0x105ec76f1LLU};
+
+	crc_vpclmulqdq_ctx_init(&crc16_ccitt_vpclmulqdq, ccitt_rk,
+		ccitt_k5_k6, ccitt_k7_k8);
+	crc_vpclmulqdq_ctx_init(&crc32_eth_vpclmulqdq, eth_rk,
+		eth_k5_k6, eth_k7_k8);
+	crc_vpclmulqdq_ctx_init(&crc32c_vpclmulqdq, crc32c_rk,
+		crc32c_k5_k6, crc32c_k7_k8);
+}
+
+uint32_t
+rte_crc16_ccitt_avx512_handler(const uint8_t *data, uint32_t data_len)
+{
+	/** return 16-bit CRC value */
+	return (uint16_t)~crc32_eth_calc_vpclmulqdq(data,
+		data_len,
+		0xffff,
+		&crc16_ccitt_vpclmulqdq);
+}
+
+uint32_t
+rte_crc32_eth_avx512_handler(const uint8_t *data, uint32_t data_len)
+{
+	return ~crc32_eth_calc_vpclmulqdq(data,
+		data_len,
+		0xffffffffUL,
+		&crc32_eth_vpclmulqdq);
+}
+
+uint32_t
+rte_crc32c_avx512_handler(const uint8_t *data, uint32_t data_len)
+{
+	return ~crc32_eth_calc_vpclmulqdq(data,
+		data_len,
+		0xffffffffUL,
+		&crc32c_vpclmulqdq);
+}
+
+void
+rte_crc16_ccitt_avx512_bulk_handler(const uint8_t * const data[],
+	const uint32_t data_len[], uint32_t crc[], uint32_t nb)
+{
+	uint32_t i;
+
+	crc32_eth_calc_bulk_vpclmulqdq(data, data_len, crc, nb, 0xffff,
+		&crc16_ccitt_vpclmulqdq);
+	for (i = 0; i < nb; i++)
+		crc[i] = (uint16_t)~crc[i];
+}
+
+void
+rte_crc32_eth_avx512_bulk_handler(const uint8_t * const data[],
+	const uint32_t data_len[], uint32_t crc[], uint32_t nb)
+{
+	uint32_t i;
+
+	crc32_eth_calc_bulk_vpclmulqdq(data, data_len, crc, nb, 0xffffffffUL,
+		&crc32_eth_vpclmulqdq);
+	for (i = 0; i < nb; i++)
+		crc[i] = ~crc[i];
+}
+
+void
+rte_crc32c_avx512_bulk_handler(const uint8_t * const data[],
+	const uint32_t data_len[], uint32_t crc[], uint32_t nb)
+{
+	uint32_t i;
+
+	crc32_eth_calc_bulk_vpclmulqdq(data, data_len, crc, nb, 0xffffffffUL,
+		&crc32c_vpclmulqdq);
+	for (i = 0; i < nb; i++)
+		crc[i] = ~crc[i];
+}
@@ -23,6 +23,7 @@ struct crc_pmull_ctx {
 
 struct crc_pmull_ctx crc32_eth_pmull __rte_aligned(16);
 struct crc_pmull_ctx crc16_ccitt_pmull __rte_aligned(16);
+struct crc_pmull_ctx crc32c_pmull __rte_aligned(16);
 
 /**
  * @brief Performs one folding round
@@ -231,6 +232,11 @@ rte_net_crc_neon_init(void)
 	uint64_t eth_k5_k6[2] = {0xccaa009eLLU, 0x163cd6124LLU};
 	uint64_t eth_k7_k8[2] = {0x1f7011640LLU, 0x1db710641LLU};
 
+	/* Initialize CRC32C data */
+	uint64_t crc32c_k1_k2[2] = {0x14cd00bd6LLU, 0xf20c0dfeLLU};
+	uint64_t crc32c_k5_k6[2] = {0x14cd00bd6LLU, 0xdd45aab8LLU};
+	uint64_t crc32c_k7_k8[2] = {0xdea713f0LLU, 0x105ec76f1LLU};
+
 	/** Save the params in context structure */
 	crc16_ccitt_pmull.rk1_rk2 = vld1q_u64(ccitt_k1_k2);
 	crc16_ccitt_pmull.rk5_rk6 = vld1q_u64(ccitt_k5_k6);
@@ -240,6 +246,11 @@ rte_net_crc_neon_init(void)
 	crc32_eth_pmull.rk1_rk2 = vld1q_u64(eth_k1_k2);
 	crc32_eth_pmull.rk5_rk6 = vld1q_u64(eth_k5_k6);
 	crc32_eth_pmull.rk7_rk8 = vld1q_u64(eth_k7_k8);
+
+	/** Save the params in context structure */
+	crc32c_pmull.rk1_rk2 = vld1q_u64(crc32c_k1_k2);
+	crc32c_pmull.rk5_rk6 = vld1q_u64(crc32c_k5_k6);
+	crc32c_pmull.rk7_rk8 = vld1q_u64(crc32c_k7_k8);
 }
 
 static inline uint32_t
@@ -262,6 +273,16 @@ rte_crc32_eth_neon_handler(const uint8_t *data,
 		&crc32_eth_pmull);
 }
 
+static inline uint32_t
+rte_crc32c_neon_handler(const uint8_t *data,
+	uint32_t data_len)
+{
+	return ~crc32_eth_calc_pmull(data,
+		data_len,
+		0xffffffffUL,
+		&crc32c_pmull);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,7 @@ struct crc_pclmulqdq_ctx {
 
 static struct crc_pclmulqdq_ctx crc32_eth_pclmulqdq __rte_aligned(16);
 static struct crc_pclmulqdq_ctx crc16_ccitt_pclmulqdq __rte_aligned(16);
+static struct crc_pclmulqdq_ctx crc32c_pclmulqdq __rte_aligned(16);
 /**
  * @brief Performs one folding round
  *
@@ -298,6 +299,22 @@ rte_net_crc_sse42_init(void)
 	crc32_eth_pclmulqdq.rk7_rk8 =
 		_mm_setr_epi64(_mm_cvtsi64_m64(q), _mm_cvtsi64_m64(p));
 
+	/** Initialize CRC32C data */
+	k1 = 0x14cd00bd6LLU;
+	k2 = 0xf20c0dfeLLU;
+	k5 = 0x14cd00bd6LLU;
+	k6 = 0xdd45aab8LLU;
+	q =  0xdea713f0LLU;
+	p =  0x105ec76f1LLU;
+
+	/** Save the params in context structure */
+	crc32c_pclmulqdq.rk1_rk2 =
+		_mm_setr_epi64(_mm_cvtsi64_m64(k1), _mm_cvtsi64_m64(k2));
+	crc32c_pclmulqdq.rk5_rk6 =
+		_mm_setr_epi64(_mm_cvtsi64_m64(k5), _mm_cvtsi64_m64(k6));
+	crc32c_pclmulqdq.rk7_rk8 =
+		_mm_setr_epi64(_mm_cvtsi64_m64(q), _mm_cvtsi64_m64(p));
+
 	/**
 	 * Reset the register as following calculation may
 	 * use other data types such as float, double, etc.
@@ -327,6 +344,16 @@ rte_crc32_eth_sse42_handler(const uint8_t *data,
 		&crc32_eth_pclmulqdq);
 }
 
+static inline uint32_t
+rte_crc32c_sse42_handler(const uint8_t *data,
+	uint32_t data_len)
+{
+	return ~crc32_eth_calc_pclmulqdq(data,
+		data_len,
+		0xffffffffUL,
+		&crc32c_pclmulqdq);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -90,6 +90,75 @@ rte_net_skip_ip6_ext(uint16_t proto, const struct rte_mbuf *m, uint32_t *off,
 uint32_t rte_net_get_ptype(const struct rte_mbuf *m,
 	struct rte_net_hdr_lens *hdr_lens, uint32_t layers);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Process the non-complemented checksum of a buffer.
+ *
+ * Same as rte_raw_cksum(), but long buffers are summed with vector
+ * instructions when the CPU supports them.
+ *
+ * @param buf
+ *   Pointer to the buffer.
+ * @param len
+ *   Length of the buffer.
+ * @return
+ *   The non-complemented checksum.
+ */
+__rte_experimental
+uint16_t
+rte_net_raw_cksum(const void *buf, size_t len);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Compute in software the checksums requested by the Tx offload flags of
+ * a burst of packets.
+ *
+ * The IPv4 header checksum is set for PKT_TX_IP_CKSUM, the TCP or UDP
+ * checksum, pseudo header included, for PKT_TX_TCP_CKSUM or
+ * PKT_TX_UDP_CKSUM. The headers are located with the l2_len and l3_len
+ * fields, and the outer header lengths for PKT_TX_OUTER_IPV4 or
+ * PKT_TX_OUTER_IPV6. They must be in the first segment, the L4 payload may
+ * span several segments. The offload flags are left untouched.
+ *
+ * @param pkts
+ *   The packets to process.
+ * @param nb_pkts
+ *   The number of packets.
+ * @return
+ *   The number of packets processed. If less than nb_pkts, rte_errno is
+ *   set to EINVAL: the flags or headers of the next packet are invalid,
+ *   or it requests TCP segmentation.
+ */
+__rte_experimental
+uint16_t
+rte_net_cksum_fill_burst(struct rte_mbuf **pkts, uint16_t nb_pkts);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Verify in software the IPv4 header and TCP or UDP checksums of a burst
+ * of received packets.
+ *
+ * The headers are located with the packet_type, l2_len and l3_len fields,
+ * as filled by rte_net_get_ptype(). The PKT_RX_IP_CKSUM and PKT_RX_L4_CKSUM
+ * flags of each packet are set to GOOD or BAD, or left untouched when the
+ * checksum cannot be verified: unsupported packet type, IP header not in
+ * the first segment, or packet shorter than its IP length.
+ *
+ * @param pkts
+ *   The packets to verify.
+ * @param nb_pkts
+ *   The number of packets.
+ */
+__rte_experimental
+void
+rte_net_cksum_verify_burst(struct rte_mbuf **pkts, uint16_t nb_pkts);
+
 /**
  * Prepare pseudo header checksum
  *
@@ -0,0 +1,340 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#include <stdint.h>
+#include <errno.h>
+
+#include <rte_common.h>
+#include <rte_byteorder.h>
+#include <rte_cpuflags.h>
+#include <rte_errno.h>
+#include <rte_mbuf.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+
+#include "rte_net.h"
+#include "net_cksum.h"
+
+/* shortest buffer for which the vector sum beats the scalar one */
+#define NET_CKSUM_VEC_MIN_LEN	128
+
+typedef uint32_t (*net_raw_cksum_t)(const void *buf, size_t len,
+		uint32_t sum);
+
+static net_raw_cksum_t net_raw_cksum_vec;
+
+static inline uint32_t
+net_raw_cksum(const void *buf, size_t len, uint32_t sum)
+{
+	if (len >= NET_CKSUM_VEC_MIN_LEN && net_raw_cksum_vec != NULL)
+		return net_raw_cksum_vec(buf, len, sum);
+	return __rte_raw_cksum(buf, len, sum);
+}
+
+/* reduce a 64-bit sum of 16-bit words to the 16-bit checksum */
+static inline uint16_t
+net_cksum_reduce(uint64_t sum)
+{
+	sum = (sum >> 32) + (sum & UINT32_MAX);
+	sum = (sum >> 32) + (sum & UINT32_MAX);
+	return __rte_raw_cksum_reduce((uint32_t)sum);
+}
+
+/* non-complemented checksum of an IPv4 header, without options first */
+static inline uint16_t
+net_ipv4_hdr_cksum(const struct rte_ipv4_hdr *ipv4_hdr, uint32_t len)
+{
+	const unaligned_uint32_t *w = (const unaligned_uint32_t *)ipv4_hdr;
+
+	if (likely(len == sizeof(*ipv4_hdr)))
+		return net_cksum_reduce((uint64_t)w[0] + w[1] + w[2] +
+			w[3] + w[4]);
+	return rte_raw_cksum(ipv4_hdr, len);
+}
+
+/* pseudo header sum of an L4 segment of len bytes and protocol proto */
+static inline uint64_t
+net_phdr_cksum(const void *l3_hdr, int ipv4, uint8_t proto, uint32_t len)
+{
+	uint64_t sum;
+
+	if (ipv4) {
+		const struct rte_ipv4_hdr *ipv4_hdr = l3_hdr;
+
+		sum = __rte_raw_cksum(&ipv4_hdr->src_addr,
+			2 * sizeof(ipv4_hdr->src_addr), 0);
+	} else {
+		const struct rte_ipv6_hdr *ipv6_hdr = l3_hdr;
+
+		sum = __rte_raw_cksum(ipv6_hdr->src_addr,
+			2 * sizeof(ipv6_hdr->src_addr), 0);
+	}
+
+	return sum + rte_cpu_to_be_16(proto) + rte_cpu_to_be_16(len);
+}
+
+/*
+ * Sum of len bytes of a packet from offset off, in the byte order of the
+ * packet data. Return -1 if they are not all in the packet.
+ */
+static int
+net_cksum_mbuf(const struct rte_mbuf *m, uint32_t off, uint32_t len,
+	uint64_t *cksum)
+{
+	const struct rte_mbuf *seg = m;
+	uint32_t seglen, done, tmp;
+	uint64_t sum;
+
+	if (unlikely(len > rte_pktmbuf_pkt_len(m) ||
+			off > rte_pktmbuf_pkt_len(m) - len))
+		return -1;
+
+	/* all in the first segment */
+	if (likely(off + len <= rte_pktmbuf_data_len(m))) {
+		*cksum = net_raw_cksum(rte_pktmbuf_mtod_offset(m, const char *,
+			off), len, 0);
+		return 0;
+	}
+
+	while (off >= rte_pktmbuf_data_len(seg)) {
+		off -= rte_pktmbuf_data_len(seg);
+		seg = seg->next;
+	}
+
+	sum = 0;
+	done = 0;
+	for (;;) {
+		seglen = RTE_MIN(rte_pktmbuf_data_len(seg) - off, len - done);
+		tmp = net_raw_cksum(rte_pktmbuf_mtod_offset(seg, const char *,
+			off), seglen, 0);
+		/* the words of a segment at an odd offset are swapped */
+		if (done & 1)
+			tmp = rte_bswap16(__rte_raw_cksum_reduce(tmp));
+		sum += tmp;
+		done += seglen;
+		if (done == len)
+			break;
+		seg = seg->next;
+		off = 0;
+	}
+
+	*cksum = sum;
+	return 0;
+}
+
+/* length of the L4 segment following an IP header of l3_len bytes */
+static inline uint32_t
+net_l4_len(const void *l3_hdr, int ipv4, uint32_t l3_len)
+{
+	uint32_t len;
+
+	if (ipv4) {
+		const struct rte_ipv4_hdr *ipv4_hdr = l3_hdr;
+
+		len = rte_be_to_cpu_16(ipv4_hdr->total_length);
+	} else {
+		const struct rte_ipv6_hdr *ipv6_hdr = l3_hdr;
+
+		len = rte_be_to_cpu_16(ipv6_hdr->payload_len) +
+			sizeof(*ipv6_hdr);
+	}
+
+	return len >= l3_len ? len - l3_len : UINT32_MAX;
+}
+
+uint16_t
+rte_net_raw_cksum(const void *buf, size_t len)
+{
+	return __rte_raw_cksum_reduce(net_raw_cksum(buf, len, 0));
+}
+
+static int
+net_cksum_fill(struct rte_mbuf *m)
+{
+	uint64_t ol_flags = m->ol_flags;
+	uint64_t l4_flags = ol_flags & PKT_TX_L4_MASK;
+	uint32_t l3_off, l4_off, l4_len;
+	uint16_t *l4_cksum;
+	uint64_t sum, phdr;
+	uint8_t proto;
+	void *l3_hdr;
+	int ipv4;
+
+	if (!(ol_flags & (PKT_TX_IP_CKSUM | PKT_TX_L4_MASK)))
+		return 0;
+
+	if (ol_flags & PKT_TX_TCP_SEG)
+		return -1;
+
+	ipv4 = !!(ol_flags & PKT_TX_IPV4);
+	if (ipv4 == !!(ol_flags & PKT_TX_IPV6))
+		return -1;
+
+	l3_off = m->l2_len;
+	if (ol_flags & (PKT_TX_OUTER_IPV4 | PKT_TX_OUTER_IPV6))
+		l3_off += m->outer_l2_len + m->outer_l3_len;
+
+	/* the headers must be in the first segment */
+	l4_off = l3_off + m->l3_len;
+	if (unlikely(l4_off > rte_pktmbuf_data_len(m)))
+		return -1;
+	l3_hdr = rte_pktmbuf_mtod_offset(m, void *, l3_off);
+
+	if (ol_flags & PKT_TX_IP_CKSUM) {
+		struct rte_ipv4_hdr *ipv4_hdr = l3_hdr;
+
+		if (!ipv4 || m->l3_len < sizeof(*ipv4_hdr))
+			return -1;
+		ipv4_hdr->hdr_checksum = 0;
+		ipv4_hdr->hdr_checksum =
+			~net_ipv4_hdr_cksum(ipv4_hdr, m->l3_len);
+	}
+
+	if (l4_flags == PKT_TX_TCP_CKSUM) {
+		struct rte_tcp_hdr *tcp_hdr;
+
+		if (unlikely(l4_off + sizeof(*tcp_hdr) >
+				rte_pktmbuf_data_len(m)))
+			return -1;
+		tcp_hdr = rte_pktmbuf_mtod_offset(m, struct rte_tcp_hdr *,
+			l4_off);
+		l4_cksum = &tcp_hdr->cksum;
+		proto = IPPROTO_TCP;
+	} else if (l4_flags == PKT_TX_UDP_CKSUM) {
+		struct rte_udp_hdr *udp_hdr;
+
+		if (unlikely(l4_off + sizeof(*udp_hdr) >
+				rte_pktmbuf_data_len(m)))
+			return -1;
+		udp_hdr = rte_pktmbuf_mtod_offset(m, struct rte_udp_hdr *,
+			l4_off);
+		l4_cksum = &udp_hdr->dgram_cksum;
+		proto = IPPROTO_UDP;
+	} else if (l4_flags == 0) {
+		return 0;
+	} else {
+		return -1;
+	}
+
+	l4_len = net_l4_len(l3_hdr, ipv4, m->l3_len);
+	*l4_cksum = 0;
+	if (net_cksum_mbuf(m, l4_off, l4_len, &sum) < 0)
+		return -1;
+	phdr = net_phdr_cksum(l3_hdr, ipv4, proto, l4_len);
+	*l4_cksum = ~net_cksum_reduce(sum + phdr);
+	/* a zero UDP checksum means no checksum, use its other form */
+	if (*l4_cksum == 0)
+		*l4_cksum = 0xffff;
+
+	return 0;
+}
+
+uint16_t
+rte_net_cksum_fill_burst(struct rte_mbuf **pkts, uint16_t nb_pkts)
+{
+	uint16_t i;
+
+	for (i = 0; i != nb_pkts; i++) {
+		if (i + 1 != nb_pkts)
+			rte_prefetch0(rte_pktmbuf_mtod(pkts[i + 1], void *));
+		if (unlikely(net_cksum_fill(pkts[i]) < 0)) {
+			rte_errno = EINVAL;
+			break;
+		}
+	}
+
+	return i;
+}
+
+static void
+net_cksum_verify(struct rte_mbuf *m)
+{
+	uint32_t ptype = m->packet_type;
+	uint32_t l4 = ptype & RTE_PTYPE_L4_MASK;
+	uint32_t l3_off, l4_off, l4_len;
+	uint64_t sum, flags;
+	uint8_t proto;
+	void *l3_hdr;
+	int ipv4;
+
+	if (RTE_ETH_IS_IPV4_HDR(ptype))
+		ipv4 = 1;
+	else if (RTE_ETH_IS_IPV6_HDR(ptype))
+		ipv4 = 0;
+	else
+		return;
+
+	/* the IP header must be in the first segment */
+	l3_off = m->l2_len;
+	l4_off = l3_off + m->l3_len;
+	if (unlikely(l4_off > rte_pktmbuf_data_len(m)))
+		return;
+	l3_hdr = rte_pktmbuf_mtod_offset(m, void *, l3_off);
+
+	if (ipv4) {
+		const struct rte_ipv4_hdr *ipv4_hdr = l3_hdr;
+
+		if (unlikely(m->l3_len < sizeof(*ipv4_hdr) ||
+				m->l3_len != (ipv4_hdr->version_ihl &
+				RTE_IPV4_HDR_IHL_MASK) *
+				RTE_IPV4_IHL_MULTIPLIER))
+			return;
+		flags = net_ipv4_hdr_cksum(ipv4_hdr, m->l3_len) == 0xffff ?
+			PKT_RX_IP_CKSUM_GOOD : PKT_RX_IP_CKSUM_BAD;
+		m->ol_flags = (m->ol_flags & ~PKT_RX_IP_CKSUM_MASK) | flags;
+	} else if (unlikely(m->l3_len < sizeof(struct rte_ipv6_hdr))) {
+		return;
+	}
+
+	if (l4 == RTE_PTYPE_L4_TCP) {
+		proto = IPPROTO_TCP;
+		if (unlikely(l4_off + sizeof(struct rte_tcp_hdr) >
+				rte_pktmbuf_data_len(m)))
+			return;
+	} else if (l4 == RTE_PTYPE_L4_UDP) {
+		const struct rte_udp_hdr *udp_hdr;
+
+		proto = IPPROTO_UDP;
+		if (unlikely(l4_off + sizeof(*udp_hdr) >
+				rte_pktmbuf_data_len(m)))
+			return;
+		udp_hdr = rte_pktmbuf_mtod_offset(m,
+			const struct rte_udp_hdr *, l4_off);
+		/* no checksum to verify */
+		if (ipv4 && udp_hdr->dgram_cksum == 0)
+			return;
+	} else {
+		return;
+	}
+
+	/* leave the flags unknown for a packet shorter than its headers say */
+	l4_len = net_l4_len(l3_hdr, ipv4, m->l3_len);
+	if (net_cksum_mbuf(m, l4_off, l4_len, &sum) < 0)
+		return;
+	sum += net_phdr_cksum(l3_hdr, ipv4, proto, l4_len);
+	flags = net_cksum_reduce(sum) == 0xffff ?
+		PKT_RX_L4_CKSUM_GOOD : PKT_RX_L4_CKSUM_BAD;
+	m->ol_flags = (m->ol_flags & ~PKT_RX_L4_CKSUM_MASK) | flags;
+}
+
+void
+rte_net_cksum_verify_burst(struct rte_mbuf **pkts, uint16_t nb_pkts)
+{
+	uint16_t i;
+
+	for (i = 0; i != nb_pkts; i++) {
+		if (i + 1 != nb_pkts)
+			rte_prefetch0(rte_pktmbuf_mtod(pkts[i + 1], void *));
+		net_cksum_verify(pkts[i]);
+	}
+}
+
+#ifdef CC_AVX2_SUPPORT
+RTE_INIT(rte_net_cksum_init)
+{
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+		net_raw_cksum_vec = net_raw_cksum_avx2;
+}
+#endif
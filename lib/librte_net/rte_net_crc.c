@@ -22,15 +22,21 @@
 #include <net_crc_neon.h>
 #endif
 
+#ifdef CC_AVX512_SUPPORT
+#include "net_crc.h"
+#endif
+
 /** CRC polynomials */
 #define CRC32_ETH_POLYNOMIAL 0x04c11db7UL
 #define CRC16_CCITT_POLYNOMIAL 0x1021U
+#define CRC32C_POLYNOMIAL 0x1edc6f41UL
 
 #define CRC_LUT_SIZE 256
 
 /* crc tables */
 static uint32_t crc32_eth_lut[CRC_LUT_SIZE];
 static uint32_t crc16_ccitt_lut[CRC_LUT_SIZE];
+static uint32_t crc32c_lut[CRC_LUT_SIZE];
 
 static uint32_t
 rte_crc16_ccitt_handler(const uint8_t *data, uint32_t data_len);
@@ -38,26 +44,61 @@ rte_crc16_ccitt_handler(const uint8_t *data, uint32_t data_len);
 static uint32_t
 rte_crc32_eth_handler(const uint8_t *data, uint32_t data_len);
 
+static uint32_t
+rte_crc32c_handler(const uint8_t *data, uint32_t data_len);
+
 typedef uint32_t
 (*rte_net_crc_handler)(const uint8_t *data, uint32_t data_len);
 
+typedef void
+(*rte_net_crc_bulk_handler)(const uint8_t * const data[],
+	const uint32_t data_len[], uint32_t crc[], uint32_t nb);
+
 static rte_net_crc_handler *handlers;
 
+/* NULL if the algorithm doesn't compute several CRCs in parallel */
+static rte_net_crc_bulk_handler *bulk_handlers;
+
 static rte_net_crc_handler handlers_scalar[] = {
 	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_handler,
 	[RTE_NET_CRC32_ETH] = rte_crc32_eth_handler,
+	[RTE_NET_CRC32C] = rte_crc32c_handler,
 };
 
 #ifdef X86_64_SSE42_PCLMULQDQ
 static rte_net_crc_handler handlers_sse42[] = {
 	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_sse42_handler,
 	[RTE_NET_CRC32_ETH] = rte_crc32_eth_sse42_handler,
+	[RTE_NET_CRC32C] = rte_crc32c_sse42_handler,
 };
 #elif defined ARM64_NEON_PMULL
 static rte_net_crc_handler handlers_neon[] = {
 	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_neon_handler,
 	[RTE_NET_CRC32_ETH] = rte_crc32_eth_neon_handler,
+	[RTE_NET_CRC32C] = rte_crc32c_neon_handler,
+};
+#endif
+
+#ifdef CC_AVX512_SUPPORT
+static rte_net_crc_handler handlers_avx512[] = {
+	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_avx512_handler,
+	[RTE_NET_CRC32_ETH] = rte_crc32_eth_avx512_handler,
+	[RTE_NET_CRC32C] = rte_crc32c_avx512_handler,
+};
+
+static rte_net_crc_bulk_handler bulk_handlers_avx512[] = {
+	[RTE_NET_CRC16_CCITT] = rte_crc16_ccitt_avx512_bulk_handler,
+	[RTE_NET_CRC32_ETH] = rte_crc32_eth_avx512_bulk_handler,
+	[RTE_NET_CRC32C] = rte_crc32c_avx512_bulk_handler,
 };
+
+static int
+rte_net_crc_avx512_supported(void)
+{
+	return rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_VPCLMULQDQ) &&
+		rte_cpu_get_flag_enabled(RTE_CPUFLAG_PCLMULQDQ);
+}
 #endif
 
 /**
@@ -120,6 +161,9 @@ rte_net_crc_scalar_init(void)
 
 	/* 16-bit CRC init */
 	crc32_eth_init_lut(CRC16_CCITT_POLYNOMIAL << 16, crc16_ccitt_lut);
+
+	/* 32-bit Castagnoli crc init */
+	crc32_eth_init_lut(CRC32C_POLYNOMIAL, crc32c_lut);
 }
 
 static inline uint32_t
@@ -142,11 +186,32 @@ rte_crc32_eth_handler(const uint8_t *data, uint32_t data_len)
 		crc32_eth_lut);
 }
 
+static inline uint32_t
+rte_crc32c_handler(const uint8_t *data, uint32_t data_len)
+{
+	/* return 32-bit CRC value */
+	return ~crc32_eth_calc_lut(data,
+		data_len,
+		0xffffffffUL,
+		crc32c_lut);
+}
+
 void
 rte_net_crc_set_alg(enum rte_net_crc_alg alg)
 {
+	bulk_handlers = NULL;
+
 	switch (alg) {
 #ifdef X86_64_SSE42_PCLMULQDQ
+	case RTE_NET_CRC_AVX512:
+#ifdef CC_AVX512_SUPPORT
+		if (rte_net_crc_avx512_supported()) {
+			handlers = handlers_avx512;
+			bulk_handlers = bulk_handlers_avx512;
+			break;
+		}
+#endif
+		/* fall-through */
 	case RTE_NET_CRC_SSE42:
 		handlers = handlers_sse42;
 		break;
@@ -181,6 +246,27 @@ rte_net_crc_calc(const void *data,
 	return ret;
 }
 
+void
+rte_net_crc_calc_bulk(const void * const data[],
+	const uint32_t data_len[],
+	uint32_t crc[],
+	uint32_t nb,
+	enum rte_net_crc_type type)
+{
+	rte_net_crc_handler f_handle;
+	uint32_t i;
+
+	if (bulk_handlers != NULL) {
+		bulk_handlers[type]((const uint8_t * const *)data, data_len,
+			crc, nb);
+		return;
+	}
+
+	f_handle = handlers[type];
+	for (i = 0; i < nb; i++)
+		crc[i] = f_handle(data[i], data_len[i]);
+}
+
 /* Select highest available crc algorithm as default one */
 RTE_INIT(rte_net_crc_init)
 {
@@ -191,6 +277,12 @@ RTE_INIT(rte_net_crc_init)
 #ifdef X86_64_SSE42_PCLMULQDQ
 	alg = RTE_NET_CRC_SSE42;
 	rte_net_crc_sse42_init();
+#ifdef CC_AVX512_SUPPORT
+	if (rte_net_crc_avx512_supported()) {
+		alg = RTE_NET_CRC_AVX512;
+		rte_net_crc_avx512_init();
+	}
+#endif
 #elif defined ARM64_NEON_PMULL
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_PMULL)) {
 		alg = RTE_NET_CRC_NEON;
@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,6 +17,7 @@ extern "C" {
 enum rte_net_crc_type {
 	RTE_NET_CRC16_CCITT = 0,
 	RTE_NET_CRC32_ETH,
+	RTE_NET_CRC32C,
 	RTE_NET_CRC_REQS
 };
 
@@ -23,6 +26,7 @@ enum rte_net_crc_alg {
 	RTE_NET_CRC_SCALAR = 0,
 	RTE_NET_CRC_SSE42,
 	RTE_NET_CRC_NEON,
+	RTE_NET_CRC_AVX512,
 };
 
 /**
@@ -35,6 +39,8 @@ enum rte_net_crc_alg {
  *   - RTE_NET_CRC_SCALAR
  *   - RTE_NET_CRC_SSE42 (Use 64-bit SSE4.2 intrinsic)
  *   - RTE_NET_CRC_NEON (Use ARM Neon intrinsic)
+ *   - RTE_NET_CRC_AVX512 (Use 512-bit AVX512 VPCLMULQDQ intrinsic, if
+ *     not supported by the CPU, falls back to RTE_NET_CRC_SSE42)
  */
 void
 rte_net_crc_set_alg(enum rte_net_crc_alg alg);
@@ -57,6 +63,34 @@ rte_net_crc_calc(const void *data,
 	uint32_t data_len,
 	enum rte_net_crc_type type);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * CRC compute API for several buffers
+ *
+ * Computes the CRCs of the buffers in parallel when the selected CRC
+ * algorithm supports it, or one buffer after the other.
+ *
+ * @param data
+ *   Array of pointers to the packet data for CRC computation
+ * @param data_len
+ *   Array of the data lengths for CRC computation
+ * @param crc
+ *   Array where the CRC values are stored
+ * @param nb
+ *   Number of buffers
+ * @param type
+ *   CRC type (enum rte_net_crc_type)
+ */
+__rte_experimental
+void
+rte_net_crc_calc_bulk(const void * const data[],
+	const uint32_t data_len[],
+	uint32_t crc[],
+	uint32_t nb,
+	enum rte_net_crc_type type);
+
 #ifdef __cplusplus
 }
 #endif
@@ -102,6 +102,8 @@ struct rte_table {
 
 #define RTE_PIPELINE_MAX_NAME_SZ                           124
 
+typedef int (*rte_pipeline_run_t)(struct rte_pipeline *p);
+
 struct rte_pipeline {
 	/* Input parameters */
 	char name[RTE_PIPELINE_MAX_NAME_SZ];
@@ -122,6 +124,9 @@ struct rte_pipeline {
 	uint64_t enabled_port_in_mask;
 	struct rte_port_in *port_in_next;
 
+	/* Run function specialized for the current pipeline configuration */
+	rte_pipeline_run_t f_run;
+
 	/* Pipeline run structures */
 	struct rte_mbuf *pkts[RTE_PORT_IN_BURST_SIZE_MAX];
 	struct rte_pipeline_table_entry *entries[RTE_PORT_IN_BURST_SIZE_MAX];
@@ -157,6 +162,9 @@ rte_pipeline_port_in_free(struct rte_port_in *port);
 static void
 rte_pipeline_port_out_free(struct rte_port_out *port);
 
+static void
+rte_pipeline_run_select(struct rte_pipeline *p);
+
 /*
  * Pipeline
  *
@@ -226,6 +234,7 @@ rte_pipeline_create(struct rte_pipeline_params *params)
 	p->port_in_next = NULL;
 	p->pkts_mask = 0;
 	p->n_pkts_ah_drop = 0;
+	rte_pipeline_run_select(p);
 
 	return p;
 }
@@ -383,6 +392,8 @@ rte_pipeline_table_create(struct rte_pipeline *p,
 	table->table_next_id = 0;
 	table->table_next_id_valid = 0;
 
+	rte_pipeline_run_select(p);
+
 	return 0;
 }
 
@@ -842,6 +853,8 @@ rte_pipeline_port_in_create(struct rte_pipeline *p,
 	port->h_port = h_port;
 	port->next = NULL;
 
+	rte_pipeline_run_select(p);
+
 	return 0;
 }
 
@@ -889,6 +902,8 @@ rte_pipeline_port_out_create(struct rte_pipeline *p,
 	/* Initialize port internal data structure */
 	port->h_port = h_port;
 
+	rte_pipeline_run_select(p);
+
 	return 0;
 }
 
@@ -1115,16 +1130,16 @@ rte_pipeline_compute_masks(struct rte_pipeline *p, uint64_t pkts_mask)
 	}
 }
 
-static inline void
+static __rte_always_inline void
 rte_pipeline_action_handler_port_bulk(struct rte_pipeline *p,
-	uint64_t pkts_mask, uint32_t port_id)
+	uint64_t pkts_mask, uint32_t port_id, const int port_out_ah)
 {
 	struct rte_port_out *port_out = &p->ports_out[port_id];
 
 	p->pkts_mask = pkts_mask;
 
 	/* Output port user actions */
-	if (port_out->f_action != NULL) {
+	if (port_out_ah && (port_out->f_action != NULL)) {
 		port_out->f_action(p, p->pkts, pkts_mask, port_out->arg_ah);
 
 		RTE_PIPELINE_STATS_AH_DROP_READ(p,
@@ -1138,8 +1153,9 @@ rte_pipeline_action_handler_port_bulk(struct rte_pipeline *p,
 			p->pkts_mask);
 }
 
-static inline void
-rte_pipeline_action_handler_port(struct rte_pipeline *p, uint64_t pkts_mask)
+static __rte_always_inline void
+rte_pipeline_action_handler_port(struct rte_pipeline *p, uint64_t pkts_mask,
+	const int port_out_ah)
 {
 	p->pkts_mask = pkts_mask;
 
@@ -1154,7 +1170,8 @@ rte_pipeline_action_handler_port(struct rte_pipeline *p, uint64_t pkts_mask)
 				&p->ports_out[port_out_id];
 
 			/* Output port user actions */
-			if (port_out->f_action == NULL) /* Output port TX */
+			if (!port_out_ah || (port_out->f_action == NULL))
+				/* Output port TX */
 				port_out->ops.f_tx(port_out->h_port, pkt);
 			else {
 				uint64_t pkt_mask = 1LLU << i;
@@ -1190,7 +1207,8 @@ rte_pipeline_action_handler_port(struct rte_pipeline *p, uint64_t pkts_mask)
 			port_out = &p->ports_out[port_out_id];
 
 			/* Output port user actions */
-			if (port_out->f_action == NULL) /* Output port TX */
+			if (!port_out_ah || (port_out->f_action == NULL))
+				/* Output port TX */
 				port_out->ops.f_tx(port_out->h_port, pkt);
 			else {
 				port_out->f_action(p,
@@ -1210,9 +1228,9 @@ rte_pipeline_action_handler_port(struct rte_pipeline *p, uint64_t pkts_mask)
 	}
 }
 
-static inline void
+static __rte_always_inline void
 rte_pipeline_action_handler_port_meta(struct rte_pipeline *p,
-	uint64_t pkts_mask)
+	uint64_t pkts_mask, const int port_out_ah)
 {
 	p->pkts_mask = pkts_mask;
 
@@ -1229,7 +1247,8 @@ rte_pipeline_action_handler_port_meta(struct rte_pipeline *p,
 				port_out_id];
 
 			/* Output port user actions */
-			if (port_out->f_action == NULL) /* Output port TX */
+			if (!port_out_ah || (port_out->f_action == NULL))
+				/* Output port TX */
 				port_out->ops.f_tx(port_out->h_port, pkt);
 			else {
 				uint64_t pkt_mask = 1LLU << i;
@@ -1266,7 +1285,8 @@ rte_pipeline_action_handler_port_meta(struct rte_pipeline *p,
 			port_out = &p->ports_out[port_out_id];
 
 			/* Output port user actions */
-			if (port_out->f_action == NULL) /* Output port TX */
+			if (!port_out_ah || (port_out->f_action == NULL))
+				/* Output port TX */
 				port_out->ops.f_tx(port_out->h_port, pkt);
 			else {
 				port_out->f_action(p,
@@ -1309,8 +1329,18 @@ rte_pipeline_action_handler_drop(struct rte_pipeline *p, uint64_t pkts_mask)
 	}
 }
 
-int
-rte_pipeline_run(struct rte_pipeline *p)
+/*
+ * Pipeline run
+ *
+ * The run function is instantiated for each combination of user action
+ * handler presence (input ports, tables and output ports), so that the
+ * checks and indirect calls for the handlers that are not configured are
+ * compiled out. The variant matching the pipeline configuration is selected
+ * each time a port or a table is added to the pipeline.
+ */
+static __rte_always_inline int
+rte_pipeline_run_inline(struct rte_pipeline *p, const int port_in_ah,
+	const int table_ah, const int port_out_ah)
 {
 	struct rte_port_in *port_in = p->port_in_next;
 	uint32_t n_pkts, table_id;
@@ -1333,7 +1363,7 @@ rte_pipeline_run(struct rte_pipeline *p)
 	p->action_mask0[RTE_PIPELINE_ACTION_TABLE] = 0;
 
 	/* Input port user actions */
-	if (port_in->f_action != NULL) {
+	if (port_in_ah && (port_in->f_action != NULL)) {
 		port_in->f_action(p, p->pkts, n_pkts, port_in->arg_ah);
 
 		RTE_PIPELINE_STATS_AH_DROP_READ(p,
@@ -1359,7 +1389,7 @@ rte_pipeline_run(struct rte_pipeline *p)
 			p->pkts_mask = lookup_miss_mask;
 
 			/* Table user actions */
-			if (table->f_action_miss != NULL) {
+			if (table_ah && (table->f_action_miss != NULL)) {
 				table->f_action_miss(p,
 					p->pkts,
 					lookup_miss_mask,
@@ -1375,7 +1405,8 @@ rte_pipeline_run(struct rte_pipeline *p)
 				(p->pkts_mask != 0))
 				rte_pipeline_action_handler_port_bulk(p,
 					p->pkts_mask,
-					default_entry->port_id);
+					default_entry->port_id,
+					port_out_ah);
 			else {
 				uint32_t pos = default_entry->action;
 
@@ -1393,7 +1424,7 @@ rte_pipeline_run(struct rte_pipeline *p)
 			p->pkts_mask = lookup_hit_mask;
 
 			/* Table user actions */
-			if (table->f_action_hit != NULL) {
+			if (table_ah && (table->f_action_hit != NULL)) {
 				table->f_action_hit(p,
 					p->pkts,
 					lookup_hit_mask,
@@ -1432,11 +1463,11 @@ rte_pipeline_run(struct rte_pipeline *p)
 
 	/* Table reserved action PORT */
 	rte_pipeline_action_handler_port(p,
-		p->action_mask0[RTE_PIPELINE_ACTION_PORT]);
+		p->action_mask0[RTE_PIPELINE_ACTION_PORT], port_out_ah);
 
 	/* Table reserved action PORT META */
 	rte_pipeline_action_handler_port_meta(p,
-		p->action_mask0[RTE_PIPELINE_ACTION_PORT_META]);
+		p->action_mask0[RTE_PIPELINE_ACTION_PORT_META], port_out_ah);
 
 	/* Table reserved action DROP */
 	rte_pipeline_action_handler_drop(p,
@@ -1448,6 +1479,61 @@ rte_pipeline_run(struct rte_pipeline *p)
 	return (int) n_pkts;
 }
 
+#define RTE_PIPELINE_RUN_VARIANT(port_in_ah, table_ah, port_out_ah)	\
+static int								\
+rte_pipeline_run_##port_in_ah##table_ah##port_out_ah(struct rte_pipeline *p)\
+{									\
+	return rte_pipeline_run_inline(p, port_in_ah, table_ah, port_out_ah);\
+}
+
+RTE_PIPELINE_RUN_VARIANT(0, 0, 0)
+RTE_PIPELINE_RUN_VARIANT(0, 0, 1)
+RTE_PIPELINE_RUN_VARIANT(0, 1, 0)
+RTE_PIPELINE_RUN_VARIANT(0, 1, 1)
+RTE_PIPELINE_RUN_VARIANT(1, 0, 0)
+RTE_PIPELINE_RUN_VARIANT(1, 0, 1)
+RTE_PIPELINE_RUN_VARIANT(1, 1, 0)
+RTE_PIPELINE_RUN_VARIANT(1, 1, 1)
+
+/* Indexed by [port_in_ah][table_ah][port_out_ah] */
+static const rte_pipeline_run_t rte_pipeline_run_variants[2][2][2] = {
+	{
+		{rte_pipeline_run_000, rte_pipeline_run_001},
+		{rte_pipeline_run_010, rte_pipeline_run_011},
+	},
+	{
+		{rte_pipeline_run_100, rte_pipeline_run_101},
+		{rte_pipeline_run_110, rte_pipeline_run_111},
+	},
+};
+
+static void
+rte_pipeline_run_select(struct rte_pipeline *p)
+{
+	uint32_t port_in_ah = 0, table_ah = 0, port_out_ah = 0, i;
+
+	for (i = 0; i < p->num_ports_in; i++)
+		if (p->ports_in[i].f_action != NULL)
+			port_in_ah = 1;
+
+	for (i = 0; i < p->num_tables; i++)
+		if ((p->tables[i].f_action_hit != NULL) ||
+			(p->tables[i].f_action_miss != NULL))
+			table_ah = 1;
+
+	for (i = 0; i < p->num_ports_out; i++)
+		if (p->ports_out[i].f_action != NULL)
+			port_out_ah = 1;
+
+	p->f_run = rte_pipeline_run_variants[port_in_ah][table_ah][port_out_ah];
+}
+
+int
+rte_pipeline_run(struct rte_pipeline *p)
+{
+	return p->f_run(p);
+}
+
 int
 rte_pipeline_flush(struct rte_pipeline *p)
 {
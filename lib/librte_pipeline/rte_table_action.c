@@ -342,6 +342,79 @@ pkt_work_mtr(struct rte_mbuf *mbuf,
 	return drop_mask;
 }
 
+static __rte_always_inline void
+pkt4_work_mtr_data(struct mtr_trtcm_data **data,
+	struct rte_meter_trtcm **trtcm,
+	struct rte_meter_trtcm_profile **profile,
+	enum rte_color *color,
+	struct dscp_table_data *dscp_table,
+	struct meter_profile_data *mp,
+	uint32_t pos,
+	uint32_t dscp)
+{
+	struct dscp_table_entry_data *dscp_entry = &dscp_table->entry[dscp];
+
+	data[pos] += dscp_entry->tc;
+	trtcm[pos] = &data[pos]->trtcm;
+	profile[pos] = &mp[MTR_TRTCM_DATA_METER_PROFILE_ID_GET(data[pos])].profile;
+	color[pos] = dscp_entry->color;
+}
+
+static __rte_always_inline uint64_t
+pkt4_work_mtr(struct rte_mbuf **mbufs,
+	struct mtr_trtcm_data **data,
+	struct dscp_table_data *dscp_table,
+	struct meter_profile_data *mp,
+	uint64_t time,
+	uint32_t dscp0,
+	uint32_t dscp1,
+	uint32_t dscp2,
+	uint32_t dscp3,
+	uint16_t total_length0,
+	uint16_t total_length1,
+	uint16_t total_length2,
+	uint16_t total_length3)
+{
+	struct rte_meter_trtcm *trtcm[4];
+	struct rte_meter_trtcm_profile *profile[4];
+	uint64_t time_pkt[4] = {time, time, time, time};
+	uint32_t pkt_len[4] = {total_length0, total_length1, total_length2,
+		total_length3};
+	enum rte_color color[4];
+	uint64_t drop_mask = 0;
+	uint32_t i;
+
+	pkt4_work_mtr_data(data, trtcm, profile, color, dscp_table, mp, 0, dscp0);
+	pkt4_work_mtr_data(data, trtcm, profile, color, dscp_table, mp, 1, dscp1);
+	pkt4_work_mtr_data(data, trtcm, profile, color, dscp_table, mp, 2, dscp2);
+	pkt4_work_mtr_data(data, trtcm, profile, color, dscp_table, mp, 3, dscp3);
+
+	/* Meter */
+	rte_meter_trtcm_color_aware_check_bulk(trtcm,
+		profile,
+		time_pkt,
+		pkt_len,
+		color,
+		4);
+
+	for (i = 0; i < 4; i++) {
+		enum rte_color color_policer;
+
+		/* Stats */
+		MTR_TRTCM_DATA_STATS_INC(data[i], color[i]);
+
+		/* Police */
+		drop_mask |= MTR_TRTCM_DATA_POLICER_ACTION_DROP_GET(data[i],
+			color[i]) << i;
+		color_policer =
+			MTR_TRTCM_DATA_POLICER_ACTION_COLOR_GET(data[i], color[i]);
+		rte_mbuf_sched_color_set(mbufs[i], (uint8_t)color_policer);
+	}
+
+	/* Bit i is the drop flag of packet i */
+	return drop_mask;
+}
+
 /**
  * RTE_TABLE_ACTION_TM
  */
@@ -3104,46 +3177,26 @@ pkt4_work(struct rte_mbuf **mbufs,
 	}
 
 	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_MTR)) {
-		void *data0 =
-			action_data_get(table_entry0, action, RTE_TABLE_ACTION_MTR);
-		void *data1 =
-			action_data_get(table_entry1, action, RTE_TABLE_ACTION_MTR);
-		void *data2 =
-			action_data_get(table_entry2, action, RTE_TABLE_ACTION_MTR);
-		void *data3 =
-			action_data_get(table_entry3, action, RTE_TABLE_ACTION_MTR);
-
-		drop_mask0 |= pkt_work_mtr(mbuf0,
-			data0,
-			&action->dscp_table,
-			action->mp,
-			time,
-			dscp0,
-			total_length0);
-
-		drop_mask1 |= pkt_work_mtr(mbuf1,
-			data1,
-			&action->dscp_table,
-			action->mp,
-			time,
-			dscp1,
-			total_length1);
-
-		drop_mask2 |= pkt_work_mtr(mbuf2,
-			data2,
+		struct mtr_trtcm_data *data[4] = {
+			action_data_get(table_entry0, action, RTE_TABLE_ACTION_MTR),
+			action_data_get(table_entry1, action, RTE_TABLE_ACTION_MTR),
+			action_data_get(table_entry2, action, RTE_TABLE_ACTION_MTR),
+			action_data_get(table_entry3, action, RTE_TABLE_ACTION_MTR),
+		};
+		uint64_t drop_mask;
+
+		drop_mask = pkt4_work_mtr(mbufs,
+			data,
 			&action->dscp_table,
 			action->mp,
 			time,
-			dscp2,
-			total_length2);
+			dscp0, dscp1, dscp2, dscp3,
+			total_length0, total_length1, total_length2, total_length3);
 
-		drop_mask3 |= pkt_work_mtr(mbuf3,
-			data3,
-			&action->dscp_table,
-			action->mp,
-			time,
-			dscp3,
-			total_length3);
+		drop_mask0 |= drop_mask & 1;
+		drop_mask1 |= (drop_mask >> 1) & 1;
+		drop_mask2 |= (drop_mask >> 2) & 1;
+		drop_mask3 |= (drop_mask >> 3) & 1;
 	}
 
 	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TM)) {
@@ -3356,13 +3409,212 @@ pkt4_work(struct rte_mbuf **mbufs,
 		(drop_mask3 << 3);
 }
 
+/**
+ * Fused actions
+ *
+ * For IPv4 profiles made only of the FWD, ENCAP, NAT, TTL and STATS actions,
+ * all the actions are applied to one packet before moving to the next one,
+ * instead of one action at a time for the whole burst. The IP header is read
+ * once per packet and the NAT and TTL actions share the same IP header
+ * checksum update.
+ */
+#define AP_FUSED_ACTION_MASK                               \
+	((1LLU << RTE_TABLE_ACTION_FWD) |                      \
+	(1LLU << RTE_TABLE_ACTION_ENCAP) |                     \
+	(1LLU << RTE_TABLE_ACTION_NAT) |                       \
+	(1LLU << RTE_TABLE_ACTION_TTL) |                       \
+	(1LLU << RTE_TABLE_ACTION_STATS))
+
+static int
+ap_fused(struct ap_config *cfg)
+{
+	return cfg->common.ip_version &&
+		((cfg->action_mask & ~AP_FUSED_ACTION_MASK) == 0);
+}
+
+static __rte_always_inline uint64_t
+pkt_ipv4_work_nat_ttl(struct rte_ipv4_hdr *ip,
+	struct nat_ipv4_data *nat_data,
+	struct ttl_data *ttl_data,
+	struct rte_table_action_nat_config *cfg)
+{
+	uint16_t ip_cksum = ip->hdr_checksum;
+	uint64_t drop = 0;
+
+	if (nat_data) {
+		uint32_t addr0 = (cfg->source_nat) ? ip->src_addr : ip->dst_addr;
+		uint32_t addr1 = nat_data->addr;
+		uint16_t port1 = nat_data->port;
+
+		ip_cksum = nat_ipv4_checksum_update(ip_cksum, addr0, addr1);
+
+		if (cfg->proto == 0x6) {
+			struct rte_tcp_hdr *tcp = (struct rte_tcp_hdr *) &ip[1];
+			uint16_t port0 = (cfg->source_nat) ?
+				tcp->src_port : tcp->dst_port;
+
+			tcp->cksum = nat_ipv4_tcp_udp_checksum_update(tcp->cksum,
+				addr0,
+				addr1,
+				port0,
+				port1);
+
+			if (cfg->source_nat)
+				tcp->src_port = port1;
+			else
+				tcp->dst_port = port1;
+		} else {
+			struct rte_udp_hdr *udp = (struct rte_udp_hdr *) &ip[1];
+			uint16_t port0 = (cfg->source_nat) ?
+				udp->src_port : udp->dst_port;
+
+			if (udp->dgram_cksum)
+				udp->dgram_cksum = nat_ipv4_tcp_udp_checksum_update(
+					udp->dgram_cksum,
+					addr0,
+					addr1,
+					port0,
+					port1);
+
+			if (cfg->source_nat)
+				udp->src_port = port1;
+			else
+				udp->dst_port = port1;
+		}
+
+		if (cfg->source_nat)
+			ip->src_addr = addr1;
+		else
+			ip->dst_addr = addr1;
+	}
+
+	if (ttl_data) {
+		uint8_t ttl_diff = TTL_DEC_GET(ttl_data);
+		uint8_t ttl = ip->time_to_live - ttl_diff;
+
+		ip_cksum += ttl_diff;
+		ip->time_to_live = ttl;
+
+		drop = (ttl == 0) ? 1 : 0;
+		TTL_STATS_ADD(ttl_data, drop);
+	}
+
+	ip->hdr_checksum = ip_cksum;
+
+	return drop;
+}
+
+static __rte_always_inline uint64_t
+pkt_work_fused(struct rte_mbuf *mbuf,
+	struct rte_pipeline_table_entry *table_entry,
+	struct rte_ipv4_hdr *ip,
+	uint16_t total_length,
+	struct rte_table_action *action,
+	struct ap_config *cfg)
+{
+	struct nat_ipv4_data *nat_data = NULL;
+	struct ttl_data *ttl_data = NULL;
+	uint64_t drop_mask = 0;
+
+	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_ENCAP)) {
+		void *data =
+			action_data_get(table_entry, action, RTE_TABLE_ACTION_ENCAP);
+
+		pkt_work_encap(mbuf,
+			data,
+			&cfg->encap,
+			ip,
+			total_length,
+			cfg->common.ip_offset);
+	}
+
+	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_NAT))
+		nat_data =
+			action_data_get(table_entry, action, RTE_TABLE_ACTION_NAT);
+
+	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_TTL))
+		ttl_data =
+			action_data_get(table_entry, action, RTE_TABLE_ACTION_TTL);
+
+	if (nat_data || ttl_data)
+		drop_mask = pkt_ipv4_work_nat_ttl(ip,
+			nat_data,
+			ttl_data,
+			&cfg->nat);
+
+	if (cfg->action_mask & (1LLU << RTE_TABLE_ACTION_STATS)) {
+		void *data =
+			action_data_get(table_entry, action, RTE_TABLE_ACTION_STATS);
+
+		pkt_work_stats(data, total_length);
+	}
+
+	return drop_mask;
+}
+
+static __rte_always_inline uint64_t
+pkt4_work_fused(struct rte_mbuf **mbufs,
+	struct rte_pipeline_table_entry **table_entries,
+	struct rte_table_action *action,
+	struct ap_config *cfg)
+{
+	uint64_t drop_mask0, drop_mask1, drop_mask2, drop_mask3;
+
+	uint32_t ip_offset = cfg->common.ip_offset;
+	struct rte_ipv4_hdr *ip0 = (struct rte_ipv4_hdr *)
+		RTE_MBUF_METADATA_UINT8_PTR(mbufs[0], ip_offset);
+	struct rte_ipv4_hdr *ip1 = (struct rte_ipv4_hdr *)
+		RTE_MBUF_METADATA_UINT8_PTR(mbufs[1], ip_offset);
+	struct rte_ipv4_hdr *ip2 = (struct rte_ipv4_hdr *)
+		RTE_MBUF_METADATA_UINT8_PTR(mbufs[2], ip_offset);
+	struct rte_ipv4_hdr *ip3 = (struct rte_ipv4_hdr *)
+		RTE_MBUF_METADATA_UINT8_PTR(mbufs[3], ip_offset);
+
+	uint16_t total_length0 = rte_ntohs(ip0->total_length);
+	uint16_t total_length1 = rte_ntohs(ip1->total_length);
+	uint16_t total_length2 = rte_ntohs(ip2->total_length);
+	uint16_t total_length3 = rte_ntohs(ip3->total_length);
+
+	drop_mask0 = pkt_work_fused(mbufs[0], table_entries[0],
+		ip0, total_length0, action, cfg);
+	drop_mask1 = pkt_work_fused(mbufs[1], table_entries[1],
+		ip1, total_length1, action, cfg);
+	drop_mask2 = pkt_work_fused(mbufs[2], table_entries[2],
+		ip2, total_length2, action, cfg);
+	drop_mask3 = pkt_work_fused(mbufs[3], table_entries[3],
+		ip3, total_length3, action, cfg);
+
+	return drop_mask0 |
+		(drop_mask1 << 1) |
+		(drop_mask2 << 2) |
+		(drop_mask3 << 3);
+}
+
+static __rte_always_inline uint64_t
+pkt1_work_fused(struct rte_mbuf *mbuf,
+	struct rte_pipeline_table_entry *table_entry,
+	struct rte_table_action *action,
+	struct ap_config *cfg)
+{
+	struct rte_ipv4_hdr *ip = (struct rte_ipv4_hdr *)
+		RTE_MBUF_METADATA_UINT8_PTR(mbuf, cfg->common.ip_offset);
+
+	return pkt_work_fused(mbuf,
+		table_entry,
+		ip,
+		rte_ntohs(ip->total_length),
+		action,
+		cfg);
+}
+
 static __rte_always_inline int
 ah(struct rte_pipeline *p,
 	struct rte_mbuf **pkts,
 	uint64_t pkts_mask,
 	struct rte_pipeline_table_entry **entries,
 	struct rte_table_action *action,
-	struct ap_config *cfg)
+	struct ap_config *cfg,
+	const int fused)
 {
 	uint64_t pkts_drop_mask = 0;
 	uint64_t time = 0;
@@ -3378,11 +3630,17 @@ ah(struct rte_pipeline *p,
 		for (i = 0; i < (n_pkts & (~0x3LLU)); i += 4) {
 			uint64_t drop_mask;
 
-			drop_mask = pkt4_work(&pkts[i],
-				&entries[i],
-				time,
-				action,
-				cfg);
+			if (fused)
+				drop_mask = pkt4_work_fused(&pkts[i],
+					&entries[i],
+					action,
+					cfg);
+			else
+				drop_mask = pkt4_work(&pkts[i],
+					&entries[i],
+					time,
+					action,
+					cfg);
 
 			pkts_drop_mask |= drop_mask << i;
 		}
@@ -3390,11 +3648,17 @@ ah(struct rte_pipeline *p,
 		for ( ; i < n_pkts; i++) {
 			uint64_t drop_mask;
 
-			drop_mask = pkt_work(pkts[i],
-				entries[i],
-				time,
-				action,
-				cfg);
+			if (fused)
+				drop_mask = pkt1_work_fused(pkts[i],
+					entries[i],
+					action,
+					cfg);
+			else
+				drop_mask = pkt_work(pkts[i],
+					entries[i],
+					time,
+					action,
+					cfg);
 
 			pkts_drop_mask |= drop_mask << i;
 		}
@@ -3404,11 +3668,17 @@ ah(struct rte_pipeline *p,
 			uint64_t pkt_mask = 1LLU << pos;
 			uint64_t drop_mask;
 
-			drop_mask = pkt_work(pkts[pos],
-				entries[pos],
-				time,
-				action,
-				cfg);
+			if (fused)
+				drop_mask = pkt1_work_fused(pkts[pos],
+					entries[pos],
+					action,
+					cfg);
+			else
+				drop_mask = pkt_work(pkts[pos],
+					entries[pos],
+					time,
+					action,
+					cfg);
 
 			pkts_mask &= ~pkt_mask;
 			pkts_drop_mask |= drop_mask << pos;
@@ -3433,7 +3703,26 @@ ah_default(struct rte_pipeline *p,
 		pkts_mask,
 		entries,
 		action,
-		&action->cfg);
+		&action->cfg,
+		0);
+}
+
+static int
+ah_fused(struct rte_pipeline *p,
+	struct rte_mbuf **pkts,
+	uint64_t pkts_mask,
+	struct rte_pipeline_table_entry **entries,
+	void *arg)
+{
+	struct rte_table_action *action = arg;
+
+	return ah(p,
+		pkts,
+		pkts_mask,
+		entries,
+		action,
+		&action->cfg,
+		1);
 }
 
 static rte_pipeline_table_action_handler_hit
@@ -3442,6 +3731,9 @@ ah_selector(struct rte_table_action *action)
 	if (action->cfg.action_mask == (1LLU << RTE_TABLE_ACTION_FWD))
 		return NULL;
 
+	if (ap_fused(&action->cfg))
+		return ah_fused;
+
 	return ah_default;
 }
 
@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2020 agent
+ */
+
+#ifndef _RTE_RCU_QSBR_PVT_H_
+#define _RTE_RCU_QSBR_PVT_H_
+
+/**
+ * This file is private to the RCU library. It should not be included
+ * by the user of this library.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_ring_elem.h>
+#include <rte_spinlock.h>
+
+#include "rte_rcu_qsbr.h"
+
+/* Size of the token stored ahead of each resource on the defer queue */
+#define __RTE_QSBR_TOKEN_SIZE sizeof(uint64_t)
+
+/* Defer queue element: the token followed by the resource data */
+struct __rte_rcu_qsbr_dq_elem {
+	uint64_t token;
+	/**< Token */
+	uint8_t elem[0];
+	/**< Pointer to the resource data */
+};
+
+/* Number of elements dequeued from the ring at a time while reclaiming */
+#define __RTE_RCU_QSBR_DQ_BURST 32
+
+struct rte_rcu_qsbr_dq {
+	struct rte_rcu_qsbr *v; /**< RCU QSBR variable used by this queue.*/
+	struct rte_ring *r;     /**< RCU QSBR defer queue. */
+	uint32_t size;
+	/**< Number of elements in the defer queue */
+	uint32_t esize;
+	/**< Size (in bytes) of data, including the token, stored on the
+	 *   defer queue.
+	 */
+	uint32_t trigger_reclaim_limit;
+	/**< Trigger automatic reclamation after the defer queue
+	 *   has at least these many resources waiting.
+	 */
+	uint32_t max_reclaim_size;
+	/**< Reclaim at the max these many resources during auto
+	 *   reclamation.
+	 */
+	uint32_t flags;
+	/**< Flags to control API behaviors (RTE_RCU_QSBR_DQ_*) */
+	rte_rcu_qsbr_free_resource_t free_fn;
+	/**< Function to call to free the resource. */
+	void *p;
+	/**< Pointer passed to the free function. */
+
+	rte_spinlock_t lock;
+	/**< Serializes the reclaimers, unless RTE_RCU_QSBR_DQ_MT_UNSAFE */
+	uint32_t nb_held;
+	/**< Number of elements dequeued from the ring by the last burst */
+	uint32_t held_idx;
+	/**< Index of the first held element not freed yet */
+	uint64_t *held_tokens;
+	/**< Tokens of the held elements */
+	uint8_t *held_elems;
+	/**< Resource data of the held elements, stored contiguously */
+	uint8_t *burst;
+	/**< Dequeue buffer of __RTE_RCU_QSBR_DQ_BURST ring elements */
+} __rte_cache_aligned;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RCU_QSBR_PVT_H_ */
@@ -20,6 +20,7 @@
 #include <rte_errno.h>
 
 #include "rte_rcu_qsbr.h"
+#include "rcu_qsbr_pvt.h"
 
 /* Get the memory size of QSBR variable */
 size_t
@@ -270,6 +271,268 @@ rte_rcu_qsbr_dump(FILE *f, struct rte_rcu_qsbr *v)
 	return 0;
 }
 
+/* Create a queue used to store the data structure elements that can
+ * be freed later. This queue is referred to as 'defer queue'.
+ */
+struct rte_rcu_qsbr_dq *
+rte_rcu_qsbr_dq_create(const struct rte_rcu_qsbr_dq_parameters *params)
+{
+	struct rte_rcu_qsbr_dq *dq;
+	uint32_t esize, elem_sz;
+	unsigned int flags;
+	char rcu_dq_name[RTE_RING_NAMESIZE];
+
+	if (params == NULL || params->free_fn == NULL ||
+		params->v == NULL || params->name == NULL ||
+		params->size == 0 || params->esize == 0 ||
+		(params->esize % 4 != 0) ||
+		params->trigger_reclaim_limit > params->size) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter\n", __func__);
+		rte_errno = EINVAL;
+
+		return NULL;
+	}
+	if (params->trigger_reclaim_limit != 0 &&
+			params->max_reclaim_size == 0) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter, size = %u, trigger_reclaim_limit = %u, max_reclaim_size = %u\n",
+			__func__, params->size, params->trigger_reclaim_limit,
+			params->max_reclaim_size);
+		rte_errno = EINVAL;
+
+		return NULL;
+	}
+
+	/* Add token size to ring element size */
+	esize = __RTE_QSBR_TOKEN_SIZE + params->esize;
+	elem_sz = params->esize;
+
+	dq = rte_zmalloc(NULL, sizeof(*dq) +
+			__RTE_RCU_QSBR_DQ_BURST * (sizeof(uint64_t) +
+			elem_sz + esize), RTE_CACHE_LINE_SIZE);
+	if (dq == NULL) {
+		rte_errno = ENOMEM;
+
+		return NULL;
+	}
+
+	/* The reclaimers are serialized, so the ring has a single consumer */
+	flags = RING_F_SC_DEQ | RING_F_EXACT_SZ;
+	if (params->flags & RTE_RCU_QSBR_DQ_MT_UNSAFE)
+		flags |= RING_F_SP_ENQ;
+	snprintf(rcu_dq_name, sizeof(rcu_dq_name), "RCU_DQ_%s", params->name);
+	dq->r = rte_ring_create_elem(rcu_dq_name, esize, params->size,
+			SOCKET_ID_ANY, flags);
+	if (dq->r == NULL) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): defer queue create failed\n", __func__);
+		rte_free(dq);
+		return NULL;
+	}
+
+	dq->v = params->v;
+	dq->size = params->size;
+	dq->esize = esize;
+	dq->trigger_reclaim_limit = params->trigger_reclaim_limit;
+	dq->max_reclaim_size = params->max_reclaim_size;
+	dq->flags = params->flags;
+	dq->free_fn = params->free_fn;
+	dq->p = params->p;
+	rte_spinlock_init(&dq->lock);
+
+	dq->held_tokens = (uint64_t *)(dq + 1);
+	dq->held_elems = (uint8_t *)(dq->held_tokens +
+			__RTE_RCU_QSBR_DQ_BURST);
+	dq->burst = dq->held_elems + __RTE_RCU_QSBR_DQ_BURST * elem_sz;
+
+	return dq;
+}
+
+/* Free the resources whose grace period is over, in the enqueue order.
+ * The caller serializes the reclaimers.
+ */
+static unsigned int
+__rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n)
+{
+	const uint32_t elem_sz = dq->esize - __RTE_QSBR_TOKEN_SIZE;
+	struct __rte_rcu_qsbr_dq_elem *e;
+	unsigned int cnt = 0;
+	uint32_t first, lim, i;
+
+	while (cnt < n) {
+		/* Refill the held elements from the ring, splitting the
+		 * tokens from the resource data so that consecutive
+		 * resources can be freed by a single call.
+		 */
+		if (dq->held_idx == dq->nb_held) {
+			dq->nb_held = rte_ring_sc_dequeue_burst_elem(dq->r,
+					dq->burst, dq->esize,
+					__RTE_RCU_QSBR_DQ_BURST, NULL);
+			dq->held_idx = 0;
+			if (dq->nb_held == 0)
+				break;
+			for (i = 0; i < dq->nb_held; i++) {
+				e = (struct __rte_rcu_qsbr_dq_elem *)
+					(dq->burst + i * dq->esize);
+				dq->held_tokens[i] = e->token;
+				memcpy(dq->held_elems + i * elem_sz, e->elem,
+					elem_sz);
+			}
+		}
+
+		first = dq->held_idx;
+		lim = first + RTE_MIN(dq->nb_held - first, n - cnt);
+		while (dq->held_idx < lim && rte_rcu_qsbr_check(dq->v,
+				dq->held_tokens[dq->held_idx], false) == 1)
+			dq->held_idx++;
+
+		if (dq->held_idx != first) {
+			dq->free_fn(dq->p, dq->held_elems + first * elem_sz,
+				dq->held_idx - first);
+			cnt += dq->held_idx - first;
+		}
+
+		/* Later resources can not be quiescent either */
+		if (dq->held_idx < lim)
+			break;
+	}
+
+	return cnt;
+}
+
+/* Enqueue one resource to the defer queue to free after the grace
+ * period is over.
+ */
+int
+rte_rcu_qsbr_dq_enqueue(struct rte_rcu_qsbr_dq *dq, void *e)
+{
+	struct __rte_rcu_qsbr_dq_elem *dq_elem;
+	int mt_safe;
+
+	if (dq == NULL || e == NULL) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter\n", __func__);
+		rte_errno = EINVAL;
+
+		return 1;
+	}
+
+	uint64_t data[dq->esize / sizeof(uint64_t) + 1];
+	mt_safe = !(dq->flags & RTE_RCU_QSBR_DQ_MT_UNSAFE);
+
+	/* Reclaim resources if the queue size has hit the reclaim
+	 * limit. This helps the queue from growing too large and
+	 * allows time for reader threads to report their quiescent state.
+	 * Another thread already reclaiming is as good.
+	 */
+	if (dq->trigger_reclaim_limit != 0 &&
+			rte_ring_count(dq->r) >= dq->trigger_reclaim_limit)
+		rte_rcu_qsbr_dq_reclaim(dq, dq->max_reclaim_size,
+			NULL, NULL, NULL);
+
+	/* Start the grace period */
+	dq_elem = (struct __rte_rcu_qsbr_dq_elem *)data;
+	dq_elem->token = rte_rcu_qsbr_start(dq->v);
+	memcpy(dq_elem->elem, e, dq->esize - __RTE_QSBR_TOKEN_SIZE);
+
+	/* Enqueue the token and resource. Generating the token and
+	 * enqueuing (token + resource) on the queue is not an
+	 * atomic operation. When the defer queue is shared by multiple
+	 * writers, this might result in tokens enqueued out of order
+	 * on the queue. So, some tokens might wait longer than they
+	 * are required to be reclaimed.
+	 */
+	if (rte_ring_enqueue_elem(dq->r, data, dq->esize) == 0)
+		return 0;
+
+	/* The queue is full, make room for the resource */
+	if (mt_safe)
+		rte_spinlock_lock(&dq->lock);
+	__rcu_qsbr_dq_reclaim(dq, dq->max_reclaim_size != 0 ?
+		dq->max_reclaim_size : __RTE_RCU_QSBR_DQ_BURST);
+	if (mt_safe)
+		rte_spinlock_unlock(&dq->lock);
+
+	if (rte_ring_enqueue_elem(dq->r, data, dq->esize) != 0) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Enqueue failed\n", __func__);
+		rte_errno = ENOSPC;
+
+		return 1;
+	}
+
+	return 0;
+}
+
+/* Reclaim resources from the defer queue. */
+int
+rte_rcu_qsbr_dq_reclaim(struct rte_rcu_qsbr_dq *dq, unsigned int n,
+			unsigned int *freed, unsigned int *pending,
+			unsigned int *available)
+{
+	unsigned int cnt;
+	int mt_safe;
+
+	if (dq == NULL || n == 0) {
+		rte_log(RTE_LOG_ERR, rte_rcu_log_type,
+			"%s(): Invalid input parameter\n", __func__);
+		rte_errno = EINVAL;
+
+		return 1;
+	}
+
+	mt_safe = !(dq->flags & RTE_RCU_QSBR_DQ_MT_UNSAFE);
+
+	if (mt_safe && !rte_spinlock_trylock(&dq->lock)) {
+		rte_errno = EAGAIN;
+
+		return 1;
+	}
+
+	cnt = __rcu_qsbr_dq_reclaim(dq, n);
+
+	if (pending != NULL)
+		*pending = rte_ring_count(dq->r) + dq->nb_held - dq->held_idx;
+	if (available != NULL)
+		*available = rte_ring_free_count(dq->r);
+
+	if (mt_safe)
+		rte_spinlock_unlock(&dq->lock);
+
+	if (freed != NULL)
+		*freed = cnt;
+
+	return 0;
+}
+
+/* Delete a defer queue. */
+int
+rte_rcu_qsbr_dq_delete(struct rte_rcu_qsbr_dq *dq)
+{
+	unsigned int pending;
+
+	if (dq == NULL) {
+		rte_log(RTE_LOG_DEBUG, rte_rcu_log_type,
+			"%s(): Invalid input parameter\n", __func__);
+
+		return 0;
+	}
+
+	/* Reclaim all the resources */
+	if (rte_rcu_qsbr_dq_reclaim(dq, ~0, NULL, &pending, NULL) != 0 ||
+			pending != 0) {
+		rte_errno = EAGAIN;
+
+		return 1;
+	}
+
+	rte_ring_free(dq->r);
+	rte_free(dq);
+
+	return 0;
+}
+
 int rte_rcu_log_type;
 
 RTE_INIT(rte_rcu_register)
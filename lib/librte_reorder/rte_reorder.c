@@ -6,6 +6,7 @@
 #include <string.h>
 
 #include <rte_string_fns.h>
+#include <rte_cycles.h>
 #include <rte_log.h>
 #include <rte_mbuf.h>
 #include <rte_eal_memconfig.h>
@@ -22,6 +23,11 @@ static struct rte_tailq_elem rte_reorder_tailq = {
 };
 EAL_REGISTER_TAILQ(rte_reorder_tailq)
 
+static struct rte_tailq_elem rte_reorder_mp_tailq = {
+	.name = "RTE_REORDER_MP",
+};
+EAL_REGISTER_TAILQ(rte_reorder_mp_tailq)
+
 #define NO_FLAGS 0
 #define RTE_REORDER_PREFIX "RO_"
 #define RTE_REORDER_NAMESIZE 32
@@ -48,6 +54,19 @@ struct rte_reorder_buffer {
 	int is_initialized;
 } __rte_cache_aligned;
 
+/* The multi-producer reorder buffer data structure */
+struct rte_reorder_mp_buffer {
+	char name[RTE_REORDER_NAMESIZE];
+	unsigned int size;   /**< Number of entries that can be stored */
+	unsigned int mask;   /**< [size - 1]: used for wrap-around */
+	uint64_t timeout;    /**< cycles a gap may block the drain */
+	struct rte_mbuf **entries; /**< entries indexed by seq. number */
+
+	/* written by the draining thread only */
+	uint32_t head __rte_cache_aligned; /**< next seq. number to drain */
+	uint64_t gap_tsc;    /**< time the drain was blocked on a gap */
+} __rte_cache_aligned;
+
 static void
 rte_reorder_free_mbufs(struct rte_reorder_buffer *b);
 
@@ -375,6 +394,7 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 	/* Try to fetch requested number of mbufs from ready buffer */
 	while ((drain_cnt < max_mbufs) && (ready_buf->tail != ready_buf->head)) {
 		mbufs[drain_cnt++] = ready_buf->entries[ready_buf->tail];
+		ready_buf->entries[ready_buf->tail] = NULL;
 		ready_buf->tail = (ready_buf->tail + 1) & ready_buf->mask;
 	}
 
@@ -392,3 +412,250 @@ rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 
 	return drain_cnt;
 }
+
+struct rte_reorder_mp_buffer *
+rte_reorder_mp_create(const char *name, unsigned int socket_id,
+		unsigned int size, uint64_t timeout)
+{
+	struct rte_reorder_mp_buffer *b = NULL;
+	struct rte_tailq_entry *te;
+	struct rte_reorder_list *reorder_list;
+	const unsigned int bufsize = sizeof(struct rte_reorder_mp_buffer) +
+					(size * sizeof(struct rte_mbuf *));
+
+	reorder_list = RTE_TAILQ_CAST(rte_reorder_mp_tailq.head,
+			rte_reorder_list);
+
+	/* Check user arguments. */
+	if (!rte_is_power_of_2(size) || size > (1U << 31)) {
+		RTE_LOG(ERR, REORDER, "Invalid reorder buffer size"
+				" - Not a power of 2\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	if (name == NULL) {
+		RTE_LOG(ERR, REORDER, "Invalid reorder buffer name ptr:"
+					" NULL\n");
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	rte_mcfg_tailq_write_lock();
+
+	/* guarantee there's no existing */
+	TAILQ_FOREACH(te, reorder_list, next) {
+		b = (struct rte_reorder_mp_buffer *) te->data;
+		if (strncmp(name, b->name, RTE_REORDER_NAMESIZE) == 0)
+			break;
+	}
+	if (te != NULL) {
+		RTE_LOG(ERR, REORDER, "Reorder buffer %s already exists\n",
+				name);
+		rte_errno = EEXIST;
+		b = NULL;
+		goto exit;
+	}
+
+	/* allocate tailq entry */
+	te = rte_zmalloc("REORDER_MP_TAILQ_ENTRY", sizeof(*te), 0);
+	if (te == NULL) {
+		RTE_LOG(ERR, REORDER, "Failed to allocate tailq entry\n");
+		rte_errno = ENOMEM;
+		b = NULL;
+		goto exit;
+	}
+
+	/* Allocate memory to store the reorder buffer structure. */
+	b = rte_zmalloc_socket("REORDER_MP_BUFFER", bufsize, 0, socket_id);
+	if (b == NULL) {
+		RTE_LOG(ERR, REORDER, "Memzone allocation failed\n");
+		rte_errno = ENOMEM;
+		rte_free(te);
+	} else {
+		strlcpy(b->name, name, sizeof(b->name));
+		b->size = size;
+		b->mask = size - 1;
+		b->timeout = timeout;
+		b->entries = (void *)&b[1];
+		te->data = (void *)b;
+		TAILQ_INSERT_TAIL(reorder_list, te, next);
+	}
+
+exit:
+	rte_mcfg_tailq_write_unlock();
+	return b;
+}
+
+void
+rte_reorder_mp_free(struct rte_reorder_mp_buffer *b)
+{
+	struct rte_reorder_list *reorder_list;
+	struct rte_tailq_entry *te;
+	unsigned int i;
+
+	/* Check user arguments. */
+	if (b == NULL)
+		return;
+
+	reorder_list = RTE_TAILQ_CAST(rte_reorder_mp_tailq.head,
+			rte_reorder_list);
+
+	rte_mcfg_tailq_write_lock();
+
+	/* find our tailq entry */
+	TAILQ_FOREACH(te, reorder_list, next) {
+		if (te->data == (void *) b)
+			break;
+	}
+	if (te == NULL) {
+		rte_mcfg_tailq_write_unlock();
+		return;
+	}
+
+	TAILQ_REMOVE(reorder_list, te, next);
+
+	rte_mcfg_tailq_write_unlock();
+
+	for (i = 0; i < b->size; i++)
+		rte_pktmbuf_free(b->entries[i]);
+
+	rte_free(b);
+	rte_free(te);
+}
+
+static inline unsigned int
+reorder_mp_insert(struct rte_reorder_mp_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int nb_mbufs)
+{
+	struct rte_mbuf *expected;
+	uint32_t head, offset;
+	unsigned int i;
+
+	/*
+	 * The drain cursor is read once: it only moves forward, so an mbuf
+	 * inside the window seen here is inside it or late by now. A late
+	 * mbuf that makes it in is returned by the next drain call.
+	 */
+	head = __atomic_load_n(&b->head, __ATOMIC_ACQUIRE);
+
+	for (i = 0; i != nb_mbufs; i++) {
+		/* the subtraction takes care of the sequence number wrapping */
+		offset = mbufs[i]->seqn - head;
+		if (offset >= b->size) {
+			rte_errno = ((int32_t)offset < 0) ? ERANGE : ENOSPC;
+			break;
+		}
+
+		/*
+		 * The entry may still hold a late mbuf of a previous
+		 * window: don't overwrite it.
+		 */
+		expected = NULL;
+		if (!__atomic_compare_exchange_n(
+				&b->entries[mbufs[i]->seqn & b->mask],
+				&expected, mbufs[i], 0, __ATOMIC_RELEASE,
+				__ATOMIC_RELAXED)) {
+			rte_errno = ENOSPC;
+			break;
+		}
+	}
+
+	return i;
+}
+
+int
+rte_reorder_mp_insert(struct rte_reorder_mp_buffer *b, struct rte_mbuf *mbuf)
+{
+	if (b == NULL || mbuf == NULL) {
+		rte_errno = EINVAL;
+		return -1;
+	}
+
+	return reorder_mp_insert(b, &mbuf, 1) == 1 ? 0 : -1;
+}
+
+unsigned int
+rte_reorder_mp_insert_burst(struct rte_reorder_mp_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs)
+{
+	return reorder_mp_insert(b, mbufs, nb_mbufs);
+}
+
+/*
+ * Move the drain cursor past the gap it is blocked on, if the gap has
+ * lasted for longer than the timeout or, without timeout, if the window
+ * is full.
+ * Return the number of sequence numbers skipped.
+ */
+static uint32_t
+rte_reorder_mp_skip_gap(struct rte_reorder_mp_buffer *b, uint32_t head)
+{
+	uint64_t now;
+	uint32_t i;
+
+	if (b->timeout == 0) {
+		if (__atomic_load_n(&b->entries[(head + b->mask) & b->mask],
+				__ATOMIC_RELAXED) == NULL)
+			return 0;
+	} else {
+		now = rte_get_timer_cycles();
+		if (b->gap_tsc == 0) {
+			b->gap_tsc = now;
+			return 0;
+		}
+		if (now - b->gap_tsc < b->timeout)
+			return 0;
+	}
+
+	/* skip to the next mbuf in the window */
+	for (i = 1; i != b->size; i++) {
+		if (__atomic_load_n(&b->entries[(head + i) & b->mask],
+				__ATOMIC_RELAXED) != NULL)
+			break;
+	}
+
+	/* nothing but gaps, restart the timeout */
+	if (i == b->size) {
+		b->gap_tsc = b->timeout != 0 ? rte_get_timer_cycles() : 0;
+		return 0;
+	}
+
+	b->gap_tsc = 0;
+	return i;
+}
+
+unsigned int
+rte_reorder_mp_drain(struct rte_reorder_mp_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs)
+{
+	struct rte_mbuf **entry;
+	unsigned int drain_cnt = 0;
+	uint32_t head, skip;
+
+	head = b->head;
+
+	while (drain_cnt < max_mbufs) {
+		entry = &b->entries[head & b->mask];
+		mbufs[drain_cnt] = __atomic_load_n(entry, __ATOMIC_ACQUIRE);
+		if (mbufs[drain_cnt] == NULL) {
+			skip = rte_reorder_mp_skip_gap(b, head);
+			if (skip == 0)
+				break;
+			head += skip;
+			continue;
+		}
+
+		__atomic_store_n(entry, NULL, __ATOMIC_RELEASE);
+		b->gap_tsc = 0;
+
+		/* a late mbuf doesn't take the place of the expected one */
+		if (mbufs[drain_cnt]->seqn == head)
+			head++;
+		drain_cnt++;
+	}
+
+	/* release the emptied entries to the producers */
+	__atomic_store_n(&b->head, head, __ATOMIC_RELEASE);
+
+	return drain_cnt;
+}
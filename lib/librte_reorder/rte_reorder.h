@@ -15,6 +15,7 @@
  *
  */
 
+#include <rte_compat.h>
 #include <rte_mbuf.h>
 
 #ifdef __cplusplus
@@ -22,6 +23,7 @@ extern "C" {
 #endif
 
 struct rte_reorder_buffer;
+struct rte_reorder_mp_buffer;
 
 /**
  * Create a new reorder buffer instance
@@ -146,6 +148,133 @@ unsigned int
 rte_reorder_drain(struct rte_reorder_buffer *b, struct rte_mbuf **mbufs,
 		unsigned max_mbufs);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create a new multi-producer reorder buffer instance
+ *
+ * Unlike a reorder buffer created with rte_reorder_create(), mbufs can be
+ * inserted in a multi-producer reorder buffer by several lcores at the
+ * same time, while one lcore drains it. Each mbuf is stored directly at the
+ * entry of its sequence number. The window of sequence numbers that can be
+ * inserted starts at 0 and moves forward as mbufs are drained.
+ *
+ * @param name
+ *   The name to be given to the reorder buffer instance.
+ * @param socket_id
+ *   The NUMA node on which the memory for the reorder buffer
+ *   instance is to be reserved.
+ * @param size
+ *   Max number of elements that can be stored in the reorder buffer,
+ *   which is the width of the window of sequence numbers.
+ * @param timeout
+ *   Number of timer cycles (see rte_get_timer_hz()) after which the drain
+ *   skips a missing mbuf that later mbufs are waiting for. If 0, a missing
+ *   mbuf is skipped when the window is full instead.
+ * @return
+ *   The initialized reorder buffer instance, or NULL on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ *    - EINVAL - invalid parameters
+ *    - EEXIST - a multi-producer reorder buffer with the same name exists
+ */
+__rte_experimental
+struct rte_reorder_mp_buffer *
+rte_reorder_mp_create(const char *name, unsigned int socket_id,
+		unsigned int size, uint64_t timeout);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free a multi-producer reorder buffer instance and the mbufs it holds.
+ *
+ * @param b
+ *   reorder buffer instance
+ */
+__rte_experimental
+void
+rte_reorder_mp_free(struct rte_reorder_mp_buffer *b);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Insert given mbuf in a multi-producer reorder buffer
+ *
+ * This function is multi-thread safe with regard to other inserts and to
+ * rte_reorder_mp_drain().
+ *
+ * @param b
+ *   Reorder buffer where the mbuf has to be inserted.
+ * @param mbuf
+ *   mbuf of packet that needs to be inserted in reorder buffer.
+ * @return
+ *   0 on success
+ *   -1 on error
+ *   On error case, rte_errno will be set appropriately:
+ *    - EINVAL - invalid parameters
+ *    - ENOSPC - Early mbuf, beyond the window or whose entry is not drained
+ *      yet. It can be inserted again once the buffer has been drained.
+ *    - ERANGE - Late mbuf, whose sequence number has already been drained
+ *      or skipped, which should be handled without reordering.
+ */
+__rte_experimental
+int
+rte_reorder_mp_insert(struct rte_reorder_mp_buffer *b, struct rte_mbuf *mbuf);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Insert a burst of mbufs in a multi-producer reorder buffer
+ *
+ * Same as rte_reorder_mp_insert(), for several mbufs. The insertion stops
+ * at the first mbuf that can't be inserted.
+ *
+ * @param b
+ *   Reorder buffer where the mbufs have to be inserted.
+ * @param mbufs
+ *   Array of the mbufs to insert.
+ * @param nb_mbufs
+ *   Number of mbufs in the array.
+ * @return
+ *   Number of mbufs inserted. If it is less than nb_mbufs, rte_errno is set
+ *   as by rte_reorder_mp_insert() for the first mbuf not inserted.
+ */
+__rte_experimental
+unsigned int
+rte_reorder_mp_insert_burst(struct rte_reorder_mp_buffer *b,
+		struct rte_mbuf **mbufs, unsigned int nb_mbufs);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Fetch reordered buffers from a multi-producer reorder buffer
+ *
+ * Returns a set of in-order buffers. Only one lcore at a time may drain
+ * a given reorder buffer. A missing mbuf blocks the drain until it is
+ * inserted or until it is skipped, as set by the timeout given at
+ * creation. Late mbufs that were
+ * inserted while their sequence number was being skipped are returned
+ * out of order.
+ *
+ * @param b
+ *   Reorder buffer instance from which packets are to be drained
+ * @param mbufs
+ *   array of mbufs where reordered packets will be inserted from reorder buffer
+ * @param max_mbufs
+ *   the number of elements in the mbufs array.
+ * @return
+ *   number of mbuf pointers written to mbufs. 0 <= N <= max_mbufs.
+ */
+__rte_experimental
+unsigned int
+rte_reorder_mp_drain(struct rte_reorder_mp_buffer *b, struct rte_mbuf **mbufs,
+		unsigned int max_mbufs);
+
 #ifdef __cplusplus
 }
 #endif
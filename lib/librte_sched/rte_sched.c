@@ -38,7 +38,8 @@
 #define RTE_SCHED_TB_RATE_CONFIG_ERR          (1e-7)
 #define RTE_SCHED_WRR_SHIFT                   3
 #define RTE_SCHED_MAX_QUEUES_PER_TC           RTE_SCHED_BE_QUEUES_PER_PIPE
-#define RTE_SCHED_GRINDER_PCACHE_SIZE         (64 / RTE_SCHED_QUEUES_PER_PIPE)
+#define RTE_SCHED_MIN_QUEUES_PER_PIPE         4
+#define RTE_SCHED_GRINDER_PCACHE_SIZE         (64 / RTE_SCHED_MIN_QUEUES_PER_PIPE)
 #define RTE_SCHED_PIPE_INVALID                UINT32_MAX
 #define RTE_SCHED_BMP_POS_INVALID             UINT32_MAX
 
@@ -47,6 +48,14 @@
  */
 #define RTE_SCHED_TIME_SHIFT		      8
 
+/* Size of the port token bucket shared by the port partitions, in MTU sized
+ * frames.
+ */
+#define RTE_SCHED_PORT_TB_SIZE_MTUS           256
+
+/* Number of packets handled together by each stage of the enqueue pipeline */
+#define RTE_SCHED_ENQUEUE_BATCH               8
+
 struct rte_sched_pipe_profile {
 	/* Token bucket (TB) */
 	uint64_t tb_period;
@@ -175,6 +184,10 @@ struct rte_sched_subport {
 	/* Pipe queues size */
 	uint16_t qsize[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 
+	/* Pipe layout, same as for the port */
+	uint32_t n_queues_per_pipe_log2;
+	uint32_t n_be_queues_per_pipe;
+
 #ifdef RTE_SCHED_RED
 	struct rte_red_config red_config[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE][RTE_COLORS];
 #endif
@@ -209,6 +222,9 @@ struct rte_sched_port {
 	uint32_t n_subports_per_port;
 	uint32_t n_pipes_per_subport;
 	uint32_t n_pipes_per_subport_log2;
+	uint32_t n_queues_per_pipe_log2;
+	uint32_t n_be_queues_per_pipe;
+	uint32_t subport_qmask;
 	uint16_t pipe_queue[RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE];
 	uint8_t pipe_tc[RTE_SCHED_QUEUES_PER_PIPE];
 	uint8_t tc_queue[RTE_SCHED_QUEUES_PER_PIPE];
@@ -217,6 +233,9 @@ struct rte_sched_port {
 	uint32_t frame_overhead;
 	int socket;
 
+	/* RED enabled on at least one subport queue */
+	uint32_t red;
+
 	/* Timing */
 	uint64_t time_cpu_cycles;     /* Current CPU time measured in CPU cyles */
 	uint64_t time_cpu_bytes;      /* Current CPU time measured in bytes */
@@ -228,10 +247,30 @@ struct rte_sched_port {
 	uint32_t n_pkts_out;
 	uint32_t subport_id;
 
+	/* Subports scheduled by this handle: [subport_id_begin, subport_id_end) */
+	uint32_t subport_id_begin;
+	uint32_t subport_id_end;
+
+	/* Port partition: parent port and port TB credits taken from it */
+	struct rte_sched_port *parent;
+	uint64_t tb_credits;
+
+	/* Port TB shared by the port partitions (parent port only) */
+	uint64_t tb_time __rte_cache_aligned; /* time of TB depletion */
+	uint64_t tb_size;
+
 	/* Large data structures */
 	struct rte_sched_subport *subports[0] __rte_cache_aligned;
 } __rte_cache_aligned;
 
+/* Enqueue pipeline state of a batch of packets */
+struct rte_sched_enqueue_batch {
+	struct rte_mbuf **pkts;
+	uint32_t qindex[RTE_SCHED_ENQUEUE_BATCH];
+	struct rte_sched_subport *subport[RTE_SCHED_ENQUEUE_BATCH];
+	struct rte_mbuf **qbase[RTE_SCHED_ENQUEUE_BATCH];
+};
+
 enum rte_sched_subport_array {
 	e_RTE_SCHED_SUBPORT_ARRAY_PIPE = 0,
 	e_RTE_SCHED_SUBPORT_ARRAY_QUEUE,
@@ -245,24 +284,45 @@ enum rte_sched_subport_array {
 static inline uint32_t
 rte_sched_subport_pipe_queues(struct rte_sched_subport *subport)
 {
-	return RTE_SCHED_QUEUES_PER_PIPE * subport->n_pipes_per_subport_enabled;
+	return subport->n_pipes_per_subport_enabled <<
+		subport->n_queues_per_pipe_log2;
 }
 
 static inline struct rte_mbuf **
 rte_sched_subport_pipe_qbase(struct rte_sched_subport *subport, uint32_t qindex)
 {
-	uint32_t pindex = qindex >> 4;
-	uint32_t qpos = qindex & (RTE_SCHED_QUEUES_PER_PIPE - 1);
+	uint32_t pindex = qindex >> subport->n_queues_per_pipe_log2;
+	uint32_t qpos = qindex & ((1 << subport->n_queues_per_pipe_log2) - 1);
 
 	return (subport->queue_array + pindex *
 		subport->qsize_sum + subport->qsize_add[qpos]);
 }
 
+static inline uint32_t
+rte_sched_port_pipe_qpos(struct rte_sched_port *port, uint32_t qindex)
+{
+	return qindex & ((1 << port->n_queues_per_pipe_log2) - 1);
+}
+
+static inline uint32_t
+rte_sched_port_subport_qshift(struct rte_sched_port *port)
+{
+	return port->n_pipes_per_subport_log2 + port->n_queues_per_pipe_log2;
+}
+
+static inline uint8_t
+rte_sched_port_pipe_tc(struct rte_sched_port *port, uint32_t qindex)
+{
+	uint8_t pipe_tc = port->pipe_tc[rte_sched_port_pipe_qpos(port, qindex)];
+
+	return pipe_tc;
+}
+
 static inline uint16_t
 rte_sched_subport_pipe_qsize(struct rte_sched_port *port,
 struct rte_sched_subport *subport, uint32_t qindex)
 {
-	uint32_t tc = port->pipe_tc[qindex & (RTE_SCHED_QUEUES_PER_PIPE - 1)];
+	uint32_t tc = rte_sched_port_pipe_tc(port, qindex);
 
 	return subport->qsize[tc];
 }
@@ -286,25 +346,17 @@ rte_sched_port_pipe_queue(struct rte_sched_port *port, uint32_t traffic_class)
 	return pipe_queue;
 }
 
-static inline uint8_t
-rte_sched_port_pipe_tc(struct rte_sched_port *port, uint32_t qindex)
-{
-	uint8_t pipe_tc = port->pipe_tc[qindex & (RTE_SCHED_QUEUES_PER_PIPE - 1)];
-
-	return pipe_tc;
-}
-
 static inline uint8_t
 rte_sched_port_tc_queue(struct rte_sched_port *port, uint32_t qindex)
 {
-	uint8_t tc_queue = port->tc_queue[qindex & (RTE_SCHED_QUEUES_PER_PIPE - 1)];
+	uint8_t tc_queue = port->tc_queue[rte_sched_port_pipe_qpos(port, qindex)];
 
 	return tc_queue;
 }
 
 static int
 pipe_profile_check(struct rte_sched_pipe_params *params,
-	uint32_t rate, uint16_t *qsize)
+	uint32_t rate, uint16_t *qsize, uint32_t n_be_queues)
 {
 	uint32_t i;
 
@@ -363,7 +415,7 @@ pipe_profile_check(struct rte_sched_pipe_params *params,
 	}
 
 	/* Queue WRR weights: non-zero */
-	for (i = 0; i < RTE_SCHED_BE_QUEUES_PER_PIPE; i++) {
+	for (i = 0; i < n_be_queues; i++) {
 		if (params->wrr_weights[i] == 0) {
 			RTE_LOG(ERR, SCHED,
 				"%s: Incorrect value for wrr weight\n", __func__);
@@ -374,6 +426,20 @@ pipe_profile_check(struct rte_sched_pipe_params *params,
 	return 0;
 }
 
+static inline uint32_t
+rte_sched_port_params_queues(struct rte_sched_port_params *params)
+{
+	return params->n_queues_per_pipe ?
+		params->n_queues_per_pipe : RTE_SCHED_QUEUES_PER_PIPE;
+}
+
+static inline uint32_t
+rte_sched_port_params_be_queues(struct rte_sched_port_params *params)
+{
+	return params->n_be_queues_per_pipe ?
+		params->n_be_queues_per_pipe : RTE_SCHED_BE_QUEUES_PER_PIPE;
+}
+
 static int
 rte_sched_port_check_params(struct rte_sched_port_params *params)
 {
@@ -421,16 +487,51 @@ rte_sched_port_check_params(struct rte_sched_port_params *params)
 		return -EINVAL;
 	}
 
+	/* n_queues_per_pipe: 0 (default) or power of 2 between
+	 * RTE_SCHED_MIN_QUEUES_PER_PIPE and RTE_SCHED_QUEUES_PER_PIPE
+	 */
+	if (params->n_queues_per_pipe != 0 &&
+	    (params->n_queues_per_pipe < RTE_SCHED_MIN_QUEUES_PER_PIPE ||
+	     params->n_queues_per_pipe > RTE_SCHED_QUEUES_PER_PIPE ||
+	     !rte_is_power_of_2(params->n_queues_per_pipe))) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for queues per pipe\n", __func__);
+		return -EINVAL;
+	}
+
+	/* n_be_queues_per_pipe: 0 (default) or power of 2, not more than
+	 * RTE_SCHED_BE_QUEUES_PER_PIPE, one queue per strict priority TC left
+	 */
+	if (params->n_be_queues_per_pipe != 0 &&
+	    (params->n_be_queues_per_pipe > RTE_SCHED_BE_QUEUES_PER_PIPE ||
+	     !rte_is_power_of_2(params->n_be_queues_per_pipe))) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for best-effort queues per pipe\n",
+			__func__);
+		return -EINVAL;
+	}
+
+	if (rte_sched_port_params_queues(params) <
+	    rte_sched_port_params_be_queues(params) ||
+	    rte_sched_port_params_queues(params) -
+	    rte_sched_port_params_be_queues(params) >
+	    RTE_SCHED_TRAFFIC_CLASS_BE) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect pipe layout\n", __func__);
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
 static uint32_t
 rte_sched_subport_get_array_base(struct rte_sched_subport_params *params,
+	uint32_t n_queues_per_pipe, uint32_t n_be_queues_per_pipe,
 	enum rte_sched_subport_array array)
 {
 	uint32_t n_pipes_per_subport = params->n_pipes_per_subport_enabled;
 	uint32_t n_subport_pipe_queues =
-		RTE_SCHED_QUEUES_PER_PIPE * n_pipes_per_subport;
+		n_queues_per_pipe * n_pipes_per_subport;
 
 	uint32_t size_pipe = n_pipes_per_subport * sizeof(struct rte_sched_pipe);
 	uint32_t size_queue =
@@ -451,7 +552,7 @@ rte_sched_subport_get_array_base(struct rte_sched_subport_params *params,
 			size_per_pipe_queue_array +=
 				params->qsize[i] * sizeof(struct rte_mbuf *);
 		else
-			size_per_pipe_queue_array += RTE_SCHED_MAX_QUEUES_PER_TC *
+			size_per_pipe_queue_array += n_be_queues_per_pipe *
 				params->qsize[i] * sizeof(struct rte_mbuf *);
 	}
 	size_queue_array = n_pipes_per_subport * size_per_pipe_queue_array;
@@ -486,29 +587,21 @@ rte_sched_subport_get_array_base(struct rte_sched_subport_params *params,
 }
 
 static void
-rte_sched_subport_config_qsize(struct rte_sched_subport *subport)
+rte_sched_subport_config_qsize(struct rte_sched_port *port,
+	struct rte_sched_subport *subport)
 {
+	uint32_t n_queues = 1 << port->n_queues_per_pipe_log2;
 	uint32_t i;
 
+	/* Strict priority traffic classes first, then best-effort queues */
 	subport->qsize_add[0] = 0;
 
-	/* Strict prority traffic class */
-	for (i = 1; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
-		subport->qsize_add[i] = subport->qsize_add[i-1] + subport->qsize[i-1];
+	for (i = 1; i < n_queues; i++)
+		subport->qsize_add[i] = subport->qsize_add[i - 1] +
+			subport->qsize[port->pipe_tc[i - 1]];
 
-	/* Best-effort traffic class */
-	subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 1] =
-		subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE] +
-		subport->qsize[RTE_SCHED_TRAFFIC_CLASS_BE];
-	subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 2] =
-		subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 1] +
-		subport->qsize[RTE_SCHED_TRAFFIC_CLASS_BE];
-	subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 3] =
-		subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 2] +
-		subport->qsize[RTE_SCHED_TRAFFIC_CLASS_BE];
-
-	subport->qsize_sum = subport->qsize_add[RTE_SCHED_TRAFFIC_CLASS_BE + 3] +
-		subport->qsize[RTE_SCHED_TRAFFIC_CLASS_BE];
+	subport->qsize_sum = subport->qsize_add[n_queues - 1] +
+		subport->qsize[port->pipe_tc[n_queues - 1]];
 }
 
 static void
@@ -601,11 +694,12 @@ rte_sched_pipe_profile_convert(struct rte_sched_subport *subport,
 
 	dst->tc_ov_weight = src->tc_ov_weight;
 
-	/* WRR queues */
-	wrr_cost[0] = src->wrr_weights[0];
-	wrr_cost[1] = src->wrr_weights[1];
-	wrr_cost[2] = src->wrr_weights[2];
-	wrr_cost[3] = src->wrr_weights[3];
+	/* WRR queues, the weights of the queues the pipe does not have are
+	 * ignored
+	 */
+	for (i = 0; i < RTE_SCHED_BE_QUEUES_PER_PIPE; i++)
+		wrr_cost[i] = (i < subport->n_be_queues_per_pipe) ?
+			src->wrr_weights[i] : src->wrr_weights[0];
 
 	lcd1 = rte_get_lcd(wrr_cost[0], wrr_cost[1]);
 	lcd2 = rte_get_lcd(wrr_cost[2], wrr_cost[3]);
@@ -649,7 +743,9 @@ rte_sched_subport_config_pipe_profile_table(struct rte_sched_subport *subport,
 static int
 rte_sched_subport_check_params(struct rte_sched_subport_params *params,
 	uint32_t n_max_pipes_per_subport,
-	uint64_t rate)
+	uint64_t rate,
+	uint32_t n_queues_per_pipe,
+	uint32_t n_be_queues_per_pipe)
 {
 	uint32_t i;
 
@@ -705,6 +801,16 @@ rte_sched_subport_check_params(struct rte_sched_subport_params *params,
 		return -EINVAL;
 	}
 
+	/* Strict priority traffic classes without a queue in the pipe */
+	for (i = n_queues_per_pipe - n_be_queues_per_pipe;
+	     i < RTE_SCHED_TRAFFIC_CLASS_BE; i++)
+		if (params->qsize[i] != 0) {
+			RTE_LOG(ERR, SCHED,
+				"%s: Incorrect qsize for traffic class %u, "
+				"no queue in the pipe\n", __func__, i);
+			return -EINVAL;
+		}
+
 	if (params->tc_period == 0) {
 		RTE_LOG(ERR, SCHED,
 			"%s: Incorrect value for tc period\n", __func__);
@@ -734,7 +840,8 @@ rte_sched_subport_check_params(struct rte_sched_subport_params *params,
 		struct rte_sched_pipe_params *p = params->pipe_profiles + i;
 		int status;
 
-		status = pipe_profile_check(p, rate, &params->qsize[0]);
+		status = pipe_profile_check(p, rate, &params->qsize[0],
+			n_be_queues_per_pipe);
 		if (status != 0) {
 			RTE_LOG(ERR, SCHED,
 				"%s: Pipe profile check failed(%d)\n", __func__, status);
@@ -766,7 +873,9 @@ rte_sched_port_get_memory_footprint(struct rte_sched_port_params *port_params,
 
 		status = rte_sched_subport_check_params(sp,
 				port_params->n_pipes_per_subport,
-				port_params->rate);
+				port_params->rate,
+				rte_sched_port_params_queues(port_params),
+				rte_sched_port_params_be_queues(port_params));
 		if (status != 0) {
 			RTE_LOG(ERR, SCHED,
 				"%s: Port scheduler subport params check failed (%d)\n",
@@ -782,6 +891,8 @@ rte_sched_port_get_memory_footprint(struct rte_sched_port_params *port_params,
 		struct rte_sched_subport_params *sp = subport_params[i];
 
 		size1 += rte_sched_subport_get_array_base(sp,
+					rte_sched_port_params_queues(port_params),
+					rte_sched_port_params_be_queues(port_params),
 					e_RTE_SCHED_SUBPORT_ARRAY_TOTAL);
 	}
 
@@ -794,6 +905,7 @@ rte_sched_port_config(struct rte_sched_port_params *params)
 	struct rte_sched_port *port = NULL;
 	uint32_t size0, size1;
 	uint32_t cycles_per_byte;
+	uint32_t n_sp_tcs;
 	uint32_t i, j;
 	int status;
 
@@ -822,22 +934,29 @@ rte_sched_port_config(struct rte_sched_port_params *params)
 	port->n_pipes_per_subport = params->n_pipes_per_subport;
 	port->n_pipes_per_subport_log2 =
 			__builtin_ctz(params->n_pipes_per_subport);
+	port->n_queues_per_pipe_log2 =
+			__builtin_ctz(rte_sched_port_params_queues(params));
+	port->n_be_queues_per_pipe = rte_sched_port_params_be_queues(params);
+	port->subport_qmask =
+		(1 << rte_sched_port_subport_qshift(port)) - 1;
 	port->socket = params->socket;
 
-	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
-		port->pipe_queue[i] = i;
-
-	for (i = 0, j = 0; i < RTE_SCHED_QUEUES_PER_PIPE; i++) {
-		port->pipe_tc[i] = j;
+	/* Pipe layout: one queue for each of the first n_sp_tcs strict
+	 * priority TCs, then the best-effort TC queues. The strict priority
+	 * TCs without a queue are mapped to the best-effort TC.
+	 */
+	n_sp_tcs = rte_sched_port_params_queues(params) -
+		port->n_be_queues_per_pipe;
 
-		if (j < RTE_SCHED_TRAFFIC_CLASS_BE)
-			j++;
-	}
+	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASSES_PER_PIPE; i++)
+		port->pipe_queue[i] = RTE_MIN(i, n_sp_tcs);
 
-	for (i = 0, j = 0; i < RTE_SCHED_QUEUES_PER_PIPE; i++) {
+	for (i = 0, j = 0; i < rte_sched_port_params_queues(params); i++) {
+		port->pipe_tc[i] = (i < n_sp_tcs) ?
+			i : RTE_SCHED_TRAFFIC_CLASS_BE;
 		port->tc_queue[i] = j;
 
-		if (i >= RTE_SCHED_TRAFFIC_CLASS_BE)
+		if (i >= n_sp_tcs)
 			j++;
 	}
 	port->rate = params->rate;
@@ -857,10 +976,81 @@ rte_sched_port_config(struct rte_sched_port_params *params)
 	port->pkts_out = NULL;
 	port->n_pkts_out = 0;
 	port->subport_id = 0;
+	port->subport_id_begin = 0;
+	port->subport_id_end = params->n_subports_per_port;
+
+	/* Port TB */
+	port->parent = NULL;
+	port->tb_credits = UINT64_MAX;
+	port->tb_time = 0;
+	port->tb_size = (uint64_t)port->mtu * RTE_SCHED_PORT_TB_SIZE_MTUS;
 
 	return port;
 }
 
+struct rte_sched_port *
+rte_sched_port_partition_create(struct rte_sched_port *port,
+	uint32_t subport_id,
+	uint32_t n_subports)
+{
+	struct rte_sched_port *partition;
+	uint32_t size, i;
+
+	/* Check user parameters */
+	if (port == NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for parameter port\n", __func__);
+		return NULL;
+	}
+
+	if (port->parent != NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Port is already a port partition\n", __func__);
+		return NULL;
+	}
+
+	if ((n_subports == 0) ||
+		(subport_id >= port->n_subports_per_port) ||
+		(n_subports > port->n_subports_per_port - subport_id)) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Incorrect value for subport range\n", __func__);
+		return NULL;
+	}
+
+	for (i = subport_id; i < subport_id + n_subports; i++)
+		if (port->subports[i] == NULL) {
+			RTE_LOG(ERR, SCHED,
+				"%s: Subport %u is not configured\n", __func__, i);
+			return NULL;
+		}
+
+	size = sizeof(struct rte_sched_port) +
+		port->n_subports_per_port * sizeof(struct rte_sched_subport *);
+
+	partition = rte_zmalloc_socket("qos_params", size, RTE_CACHE_LINE_SIZE,
+		port->socket);
+	if (partition == NULL) {
+		RTE_LOG(ERR, SCHED, "%s: Memory allocation fails\n", __func__);
+		return NULL;
+	}
+
+	/* The partition shares the parameters, time reference and subports of
+	 * the parent port.
+	 */
+	memcpy(partition, port, size);
+
+	partition->pkts_out = NULL;
+	partition->n_pkts_out = 0;
+	partition->subport_id = subport_id;
+	partition->subport_id_begin = subport_id;
+	partition->subport_id_end = subport_id + n_subports;
+
+	partition->parent = port;
+	partition->tb_credits = 0;
+
+	return partition;
+}
+
 static inline void
 rte_sched_subport_free(struct rte_sched_port *port,
 	struct rte_sched_subport *subport)
@@ -900,6 +1090,12 @@ rte_sched_port_free(struct rte_sched_port *port)
 	if (port == NULL)
 		return;
 
+	/* Port partitions do not own their subports */
+	if (port->parent != NULL) {
+		rte_free(port);
+		return;
+	}
+
 	for (i = 0; i < port->n_subports_per_port; i++)
 		rte_sched_subport_free(port, port->subports[i]);
 
@@ -980,6 +1176,13 @@ rte_sched_subport_config(struct rte_sched_port *port,
 		return 0;
 	}
 
+	if (port->parent != NULL) {
+		RTE_LOG(ERR, SCHED,
+			"%s: Subports cannot be configured on a port partition\n",
+			__func__);
+		return -EINVAL;
+	}
+
 	if (subport_id >= port->n_subports_per_port) {
 		RTE_LOG(ERR, SCHED,
 			"%s: Incorrect value for subport id\n", __func__);
@@ -990,7 +1193,9 @@ rte_sched_subport_config(struct rte_sched_port *port,
 
 	status = rte_sched_subport_check_params(params,
 		port->n_pipes_per_subport,
-		port->rate);
+		port->rate,
+		1 << port->n_queues_per_pipe_log2,
+		port->n_be_queues_per_pipe);
 	if (status != 0) {
 		RTE_LOG(NOTICE, SCHED,
 			"%s: Port scheduler params check failed (%d)\n",
@@ -1003,6 +1208,8 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	/* Determine the amount of memory to allocate */
 	size0 = sizeof(struct rte_sched_subport);
 	size1 = rte_sched_subport_get_array_base(params,
+				1 << port->n_queues_per_pipe_log2,
+				port->n_be_queues_per_pipe,
 				e_RTE_SCHED_SUBPORT_ARRAY_TOTAL);
 
 	/* Allocate memory to store the data structures */
@@ -1057,6 +1264,8 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	/* User parameters */
 	s->n_pipes_per_subport_enabled = params->n_pipes_per_subport_enabled;
 	memcpy(s->qsize, params->qsize, sizeof(params->qsize));
+	s->n_queues_per_pipe_log2 = port->n_queues_per_pipe_log2;
+	s->n_be_queues_per_pipe = port->n_be_queues_per_pipe;
 	s->n_pipe_profiles = params->n_pipe_profiles;
 	s->n_max_pipe_profiles = params->n_max_pipe_profiles;
 
@@ -1082,6 +1291,8 @@ rte_sched_subport_config(struct rte_sched_port *port,
 				"%s: RED configuration init fails\n", __func__);
 				return -EINVAL;
 			}
+
+			port->red = 1;
 		}
 	}
 #endif
@@ -1094,25 +1305,31 @@ rte_sched_subport_config(struct rte_sched_port *port,
 	s->busy_grinders = 0;
 
 	/* Queue base calculation */
-	rte_sched_subport_config_qsize(s);
+	rte_sched_subport_config_qsize(port, s);
 
 	/* Large data structures */
 	s->pipe = (struct rte_sched_pipe *)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		1 << port->n_queues_per_pipe_log2, port->n_be_queues_per_pipe,
 		e_RTE_SCHED_SUBPORT_ARRAY_PIPE));
 	s->queue = (struct rte_sched_queue *)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		1 << port->n_queues_per_pipe_log2, port->n_be_queues_per_pipe,
 		e_RTE_SCHED_SUBPORT_ARRAY_QUEUE));
 	s->queue_extra = (struct rte_sched_queue_extra *)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		1 << port->n_queues_per_pipe_log2, port->n_be_queues_per_pipe,
 		e_RTE_SCHED_SUBPORT_ARRAY_QUEUE_EXTRA));
 	s->pipe_profiles = (struct rte_sched_pipe_profile *)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		1 << port->n_queues_per_pipe_log2, port->n_be_queues_per_pipe,
 		e_RTE_SCHED_SUBPORT_ARRAY_PIPE_PROFILES));
 	s->bmp_array =  s->memory + rte_sched_subport_get_array_base(params,
+		1 << port->n_queues_per_pipe_log2, port->n_be_queues_per_pipe,
 		e_RTE_SCHED_SUBPORT_ARRAY_BMP_ARRAY);
 	s->queue_array = (struct rte_mbuf **)
 		(s->memory + rte_sched_subport_get_array_base(params,
+		1 << port->n_queues_per_pipe_log2, port->n_be_queues_per_pipe,
 		e_RTE_SCHED_SUBPORT_ARRAY_QUEUE_ARRAY));
 
 	/* Pipe profile table */
@@ -1305,7 +1522,8 @@ rte_sched_subport_pipe_profile_add(struct rte_sched_port *port,
 	}
 
 	/* Pipe params */
-	status = pipe_profile_check(params, port->rate, &s->qsize[0]);
+	status = pipe_profile_check(params, port->rate, &s->qsize[0],
+		s->n_be_queues_per_pipe);
 	if (status != 0) {
 		RTE_LOG(ERR, SCHED,
 			"%s: Pipe profile check failed(%d)\n", __func__, status);
@@ -1343,11 +1561,12 @@ rte_sched_port_qindex(struct rte_sched_port *port,
 	uint32_t queue)
 {
 	return ((subport & (port->n_subports_per_port - 1)) <<
-		(port->n_pipes_per_subport_log2 + 4)) |
+		rte_sched_port_subport_qshift(port)) |
 		((pipe &
-		(port->subports[subport]->n_pipes_per_subport_enabled - 1)) << 4) |
-		((rte_sched_port_pipe_queue(port, traffic_class) + queue) &
-		(RTE_SCHED_QUEUES_PER_PIPE - 1));
+		(port->subports[subport]->n_pipes_per_subport_enabled - 1)) <<
+		port->n_queues_per_pipe_log2) |
+		rte_sched_port_pipe_qpos(port,
+		rte_sched_port_pipe_queue(port, traffic_class) + queue);
 }
 
 void
@@ -1371,8 +1590,8 @@ rte_sched_port_pkt_read_tree_path(struct rte_sched_port *port,
 {
 	uint32_t queue_id = rte_mbuf_sched_queue_get(pkt);
 
-	*subport = queue_id >> (port->n_pipes_per_subport_log2 + 4);
-	*pipe = (queue_id >> 4) &
+	*subport = queue_id >> rte_sched_port_subport_qshift(port);
+	*pipe = (queue_id >> port->n_queues_per_pipe_log2) &
 		(port->subports[*subport]->n_pipes_per_subport_enabled - 1);
 	*traffic_class = rte_sched_port_pipe_tc(port, queue_id);
 	*queue = rte_sched_port_tc_queue(port, queue_id);
@@ -1464,7 +1683,7 @@ rte_sched_queue_read_stats(struct rte_sched_port *port,
 			"%s: Incorrect value for parameter qlen\n", __func__);
 		return -EINVAL;
 	}
-	subport_qmask = port->n_pipes_per_subport_log2 + 4;
+	subport_qmask = rte_sched_port_subport_qshift(port);
 	subport_id = (queue_id >> subport_qmask) & (port->n_subports_per_port - 1);
 
 	s = port->subports[subport_id];
@@ -1656,35 +1875,103 @@ debug_check_queue_slab(struct rte_sched_subport *subport, uint32_t bmp_pos,
 
 #endif /* RTE_SCHED_DEBUG */
 
-static inline struct rte_sched_subport *
-rte_sched_port_subport(struct rte_sched_port *port,
-	struct rte_mbuf *pkt)
+#ifdef SCHED_VECTOR_SSE4
+
+static inline void
+rte_sched_port_enqueue_qindex8(struct rte_sched_port *port,
+	const uint32_t *queue_id, uint32_t *subport_id, uint32_t *qindex)
 {
-	uint32_t queue_id = rte_mbuf_sched_queue_get(pkt);
-	uint32_t subport_id = queue_id >> (port->n_pipes_per_subport_log2 + 4);
+	__m128i shift = _mm_cvtsi32_si128(rte_sched_port_subport_qshift(port));
+	__m128i qmask = _mm_set1_epi32(port->subport_qmask);
+	__m128i q0 = _mm_loadu_si128((const __m128i *)queue_id);
+	__m128i q1 = _mm_loadu_si128((const __m128i *)(queue_id + 4));
 
-	return port->subports[subport_id];
+	_mm_storeu_si128((__m128i *)subport_id, _mm_srl_epi32(q0, shift));
+	_mm_storeu_si128((__m128i *)(subport_id + 4), _mm_srl_epi32(q1, shift));
+	_mm_storeu_si128((__m128i *)qindex, _mm_and_si128(q0, qmask));
+	_mm_storeu_si128((__m128i *)(qindex + 4), _mm_and_si128(q1, qmask));
 }
 
-static inline uint32_t
-rte_sched_port_enqueue_qptrs_prefetch0(struct rte_sched_subport *subport,
-	struct rte_mbuf *pkt, uint32_t subport_qmask)
+#elif defined(SCHED_VECTOR_NEON)
+
+static inline void
+rte_sched_port_enqueue_qindex8(struct rte_sched_port *port,
+	const uint32_t *queue_id, uint32_t *subport_id, uint32_t *qindex)
 {
-	struct rte_sched_queue *q;
-#ifdef RTE_SCHED_COLLECT_STATS
-	struct rte_sched_queue_extra *qe;
-#endif
-	uint32_t qindex = rte_mbuf_sched_queue_get(pkt);
-	uint32_t subport_queue_id = subport_qmask & qindex;
+	int32x4_t shift =
+		vdupq_n_s32(-(int32_t)rte_sched_port_subport_qshift(port));
+	uint32x4_t qmask = vdupq_n_u32(port->subport_qmask);
+	uint32x4_t q0 = vld1q_u32(queue_id);
+	uint32x4_t q1 = vld1q_u32(queue_id + 4);
+
+	vst1q_u32(subport_id, vshlq_u32(q0, shift));
+	vst1q_u32(subport_id + 4, vshlq_u32(q1, shift));
+	vst1q_u32(qindex, vandq_u32(q0, qmask));
+	vst1q_u32(qindex + 4, vandq_u32(q1, qmask));
+}
+
+#else
+
+static inline void
+rte_sched_port_enqueue_qindex8(struct rte_sched_port *port,
+	const uint32_t *queue_id, uint32_t *subport_id, uint32_t *qindex)
+{
+	uint32_t shift = rte_sched_port_subport_qshift(port);
+	uint32_t i;
+
+	for (i = 0; i < RTE_SCHED_ENQUEUE_BATCH; i++) {
+		subport_id[i] = queue_id[i] >> shift;
+		qindex[i] = queue_id[i] & port->subport_qmask;
+	}
+}
+
+#endif /* RTE_SCHED_VECTOR */
+
+/*
+ * Stage 1 of the enqueue pipeline: read the queue ID of each packet, split
+ * it into subport ID and subport queue index, find the base of the queue
+ * array and prefetch the queue structure.
+ */
+static __rte_always_inline void
+rte_sched_port_enqueue_qptrs_prefetch0(struct rte_sched_port *port,
+	struct rte_sched_enqueue_batch *b, uint32_t n, const int red)
+{
+	uint32_t queue_id[RTE_SCHED_ENQUEUE_BATCH];
+	uint32_t subport_id[RTE_SCHED_ENQUEUE_BATCH];
+	uint32_t i;
+
+	for (i = 0; i < n; i++)
+		queue_id[i] = rte_mbuf_sched_queue_get(b->pkts[i]);
+
+	if (n == RTE_SCHED_ENQUEUE_BATCH) {
+		rte_sched_port_enqueue_qindex8(port, queue_id, subport_id,
+			b->qindex);
+	} else {
+		uint32_t shift = rte_sched_port_subport_qshift(port);
+
+		for (i = 0; i < n; i++) {
+			subport_id[i] = queue_id[i] >> shift;
+			b->qindex[i] = queue_id[i] & port->subport_qmask;
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		struct rte_sched_subport *subport =
+			port->subports[subport_id[i]];
+		uint32_t qindex = b->qindex[i];
+
+		b->subport[i] = subport;
+		b->qbase[i] = rte_sched_subport_pipe_qbase(subport, qindex);
 
-	q = subport->queue + subport_queue_id;
-	rte_prefetch0(q);
+		rte_prefetch0(subport->queue + qindex);
 #ifdef RTE_SCHED_COLLECT_STATS
-	qe = subport->queue_extra + subport_queue_id;
-	rte_prefetch0(qe);
+		RTE_SET_USED(red);
+		rte_prefetch0(subport->queue_extra + qindex);
+#else
+		if (red)
+			rte_prefetch0(subport->queue_extra + qindex);
 #endif
-
-	return subport_queue_id;
+	}
 }
 
 static inline void
@@ -1705,12 +1992,13 @@ rte_sched_port_enqueue_qwa_prefetch0(struct rte_sched_port *port,
 	rte_bitmap_prefetch0(subport->bmp, qindex);
 }
 
-static inline int
+static __rte_always_inline int
 rte_sched_port_enqueue_qwa(struct rte_sched_port *port,
 	struct rte_sched_subport *subport,
 	uint32_t qindex,
 	struct rte_mbuf **qbase,
-	struct rte_mbuf *pkt)
+	struct rte_mbuf *pkt,
+	const int red)
 {
 	struct rte_sched_queue *q;
 	uint16_t qsize;
@@ -1721,7 +2009,8 @@ rte_sched_port_enqueue_qwa(struct rte_sched_port *port,
 	qlen = q->qw - q->qr;
 
 	/* Drop the packet (and update drop stats) when queue is full */
-	if (unlikely(rte_sched_port_red_drop(port, subport, pkt, qindex, qlen) ||
+	if (unlikely((red &&
+		      rte_sched_port_red_drop(port, subport, pkt, qindex, qlen)) ||
 		     (qlen >= qsize))) {
 		rte_pktmbuf_free(pkt);
 #ifdef RTE_SCHED_COLLECT_STATS
@@ -1749,218 +2038,115 @@ rte_sched_port_enqueue_qwa(struct rte_sched_port *port,
 	return 1;
 }
 
+static __rte_always_inline void
+rte_sched_port_enqueue_batch_prefetch0(struct rte_sched_enqueue_batch *b,
+	struct rte_mbuf **pkts, uint32_t n)
+{
+	uint32_t i;
+
+	b->pkts = pkts;
+	for (i = 0; i < n; i++)
+		rte_prefetch0(pkts[i]);
+}
+
+static __rte_always_inline void
+rte_sched_port_enqueue_batch_qwa_prefetch0(struct rte_sched_port *port,
+	struct rte_sched_enqueue_batch *b, uint32_t n)
+{
+	uint32_t i;
+
+	for (i = 0; i < n; i++)
+		rte_sched_port_enqueue_qwa_prefetch0(port, b->subport[i],
+			b->qindex[i], b->qbase[i]);
+}
+
+static __rte_always_inline uint32_t
+rte_sched_port_enqueue_batch_qwa(struct rte_sched_port *port,
+	struct rte_sched_enqueue_batch *b, uint32_t n, const int red)
+{
+	uint32_t result = 0, i;
+
+	for (i = 0; i < n; i++)
+		result += rte_sched_port_enqueue_qwa(port, b->subport[i],
+			b->qindex[i], b->qbase[i], b->pkts[i], red);
+
+	return result;
+}
 
 /*
  * The enqueue function implements a 4-level pipeline with each stage
- * processing two different packets. The purpose of using a pipeline
- * is to hide the latency of prefetching the data structures. The
- * naming convention is presented in the diagram below:
+ * processing a batch of RTE_SCHED_ENQUEUE_BATCH packets. The purpose of
+ * using a pipeline is to hide the latency of prefetching the data
+ * structures:
  *
- *   p00  _______   p10  _______   p20  _______   p30  _______
- * ----->|       |----->|       |----->|       |----->|       |----->
- *       |   0   |      |   1   |      |   2   |      |   3   |
- * ----->|_______|----->|_______|----->|_______|----->|_______|----->
- *   p01            p11            p21            p31
+ *   stage 0: prefetch the mbuf of each packet;
+ *   stage 1: compute the queue index and the queue array base of each
+ *            packet, prefetch the queue structure;
+ *   stage 2: prefetch the queue write location and the bitmap slab;
+ *   stage 3: write each packet to its queue or drop it.
  *
+ * The drop decision is taken in stage 3 one packet at a time, as packets of
+ * the same batch may go to the same queue. The packets left after the last
+ * full batch go through the same stages without pipelining.
  */
-int
-rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
-		       uint32_t n_pkts)
+static __rte_always_inline uint32_t
+rte_sched_port_enqueue_burst(struct rte_sched_port *port,
+	struct rte_mbuf **pkts, uint32_t n_pkts, const int red)
 {
-	struct rte_mbuf *pkt00, *pkt01, *pkt10, *pkt11, *pkt20, *pkt21,
-		*pkt30, *pkt31, *pkt_last;
-	struct rte_mbuf **q00_base, **q01_base, **q10_base, **q11_base,
-		**q20_base, **q21_base, **q30_base, **q31_base, **q_last_base;
-	struct rte_sched_subport *subport00, *subport01, *subport10, *subport11,
-		*subport20, *subport21, *subport30, *subport31, *subport_last;
-	uint32_t q00, q01, q10, q11, q20, q21, q30, q31, q_last;
-	uint32_t r00, r01, r10, r11, r20, r21, r30, r31, r_last;
-	uint32_t subport_qmask;
-	uint32_t result, i;
+	struct rte_sched_enqueue_batch batch[4];
+	uint32_t n_batches, n_last, result, i;
 
+	n_batches = n_pkts / RTE_SCHED_ENQUEUE_BATCH;
+	n_last = n_pkts % RTE_SCHED_ENQUEUE_BATCH;
 	result = 0;
-	subport_qmask = (1 << (port->n_pipes_per_subport_log2 + 4)) - 1;
 
-	/*
-	 * Less then 6 input packets available, which is not enough to
-	 * feed the pipeline
-	 */
-	if (unlikely(n_pkts < 6)) {
-		struct rte_sched_subport *subports[5];
-		struct rte_mbuf **q_base[5];
-		uint32_t q[5];
-
-		/* Prefetch the mbuf structure of each packet */
-		for (i = 0; i < n_pkts; i++)
-			rte_prefetch0(pkts[i]);
-
-		/* Prefetch the subport structure for each packet */
-		for (i = 0; i < n_pkts; i++)
-			subports[i] = rte_sched_port_subport(port, pkts[i]);
-
-		/* Prefetch the queue structure for each queue */
-		for (i = 0; i < n_pkts; i++)
-			q[i] = rte_sched_port_enqueue_qptrs_prefetch0(subports[i],
-					pkts[i], subport_qmask);
-
-		/* Prefetch the write pointer location of each queue */
-		for (i = 0; i < n_pkts; i++) {
-			q_base[i] = rte_sched_subport_pipe_qbase(subports[i], q[i]);
-			rte_sched_port_enqueue_qwa_prefetch0(port, subports[i],
-				q[i], q_base[i]);
-		}
+	for (i = 0; i < n_batches + 3; i++) {
+		if (i < n_batches)
+			rte_sched_port_enqueue_batch_prefetch0(&batch[i & 3],
+				pkts + i * RTE_SCHED_ENQUEUE_BATCH,
+				RTE_SCHED_ENQUEUE_BATCH);
 
-		/* Write each packet to its queue */
-		for (i = 0; i < n_pkts; i++)
-			result += rte_sched_port_enqueue_qwa(port, subports[i],
-						q[i], q_base[i], pkts[i]);
+		if (i >= 1 && i - 1 < n_batches)
+			rte_sched_port_enqueue_qptrs_prefetch0(port,
+				&batch[(i - 1) & 3], RTE_SCHED_ENQUEUE_BATCH,
+				red);
 
-		return result;
+		if (i >= 2 && i - 2 < n_batches)
+			rte_sched_port_enqueue_batch_qwa_prefetch0(port,
+				&batch[(i - 2) & 3], RTE_SCHED_ENQUEUE_BATCH);
+
+		if (i >= 3)
+			result += rte_sched_port_enqueue_batch_qwa(port,
+				&batch[(i - 3) & 3], RTE_SCHED_ENQUEUE_BATCH,
+				red);
 	}
 
-	/* Feed the first 3 stages of the pipeline (6 packets needed) */
-	pkt20 = pkts[0];
-	pkt21 = pkts[1];
-	rte_prefetch0(pkt20);
-	rte_prefetch0(pkt21);
-
-	pkt10 = pkts[2];
-	pkt11 = pkts[3];
-	rte_prefetch0(pkt10);
-	rte_prefetch0(pkt11);
-
-	subport20 = rte_sched_port_subport(port, pkt20);
-	subport21 = rte_sched_port_subport(port, pkt21);
-	q20 = rte_sched_port_enqueue_qptrs_prefetch0(subport20,
-			pkt20, subport_qmask);
-	q21 = rte_sched_port_enqueue_qptrs_prefetch0(subport21,
-			pkt21, subport_qmask);
-
-	pkt00 = pkts[4];
-	pkt01 = pkts[5];
-	rte_prefetch0(pkt00);
-	rte_prefetch0(pkt01);
-
-	subport10 = rte_sched_port_subport(port, pkt10);
-	subport11 = rte_sched_port_subport(port, pkt11);
-	q10 = rte_sched_port_enqueue_qptrs_prefetch0(subport10,
-			pkt10, subport_qmask);
-	q11 = rte_sched_port_enqueue_qptrs_prefetch0(subport11,
-			pkt11, subport_qmask);
-
-	q20_base = rte_sched_subport_pipe_qbase(subport20, q20);
-	q21_base = rte_sched_subport_pipe_qbase(subport21, q21);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport20, q20, q20_base);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport21, q21, q21_base);
-
-	/* Run the pipeline */
-	for (i = 6; i < (n_pkts & (~1)); i += 2) {
-		/* Propagate stage inputs */
-		pkt30 = pkt20;
-		pkt31 = pkt21;
-		pkt20 = pkt10;
-		pkt21 = pkt11;
-		pkt10 = pkt00;
-		pkt11 = pkt01;
-		q30 = q20;
-		q31 = q21;
-		q20 = q10;
-		q21 = q11;
-		subport30 = subport20;
-		subport31 = subport21;
-		subport20 = subport10;
-		subport21 = subport11;
-		q30_base = q20_base;
-		q31_base = q21_base;
-
-		/* Stage 0: Get packets in */
-		pkt00 = pkts[i];
-		pkt01 = pkts[i + 1];
-		rte_prefetch0(pkt00);
-		rte_prefetch0(pkt01);
-
-		/* Stage 1: Prefetch subport and queue structure storing queue pointers */
-		subport10 = rte_sched_port_subport(port, pkt10);
-		subport11 = rte_sched_port_subport(port, pkt11);
-		q10 = rte_sched_port_enqueue_qptrs_prefetch0(subport10,
-				pkt10, subport_qmask);
-		q11 = rte_sched_port_enqueue_qptrs_prefetch0(subport11,
-				pkt11, subport_qmask);
-
-		/* Stage 2: Prefetch queue write location */
-		q20_base = rte_sched_subport_pipe_qbase(subport20, q20);
-		q21_base = rte_sched_subport_pipe_qbase(subport21, q21);
-		rte_sched_port_enqueue_qwa_prefetch0(port, subport20, q20, q20_base);
-		rte_sched_port_enqueue_qwa_prefetch0(port, subport21, q21, q21_base);
-
-		/* Stage 3: Write packet to queue and activate queue */
-		r30 = rte_sched_port_enqueue_qwa(port, subport30,
-				q30, q30_base, pkt30);
-		r31 = rte_sched_port_enqueue_qwa(port, subport31,
-				q31, q31_base, pkt31);
-		result += r30 + r31;
-	}
-
-	/*
-	 * Drain the pipeline (exactly 6 packets).
-	 * Handle the last packet in the case
-	 * of an odd number of input packets.
-	 */
-	pkt_last = pkts[n_pkts - 1];
-	rte_prefetch0(pkt_last);
-
-	subport00 = rte_sched_port_subport(port, pkt00);
-	subport01 = rte_sched_port_subport(port, pkt01);
-	q00 = rte_sched_port_enqueue_qptrs_prefetch0(subport00,
-			pkt00, subport_qmask);
-	q01 = rte_sched_port_enqueue_qptrs_prefetch0(subport01,
-			pkt01, subport_qmask);
-
-	q10_base = rte_sched_subport_pipe_qbase(subport10, q10);
-	q11_base = rte_sched_subport_pipe_qbase(subport11, q11);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport10, q10, q10_base);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport11, q11, q11_base);
-
-	r20 = rte_sched_port_enqueue_qwa(port, subport20,
-			q20, q20_base, pkt20);
-	r21 = rte_sched_port_enqueue_qwa(port, subport21,
-			q21, q21_base, pkt21);
-	result += r20 + r21;
-
-	subport_last = rte_sched_port_subport(port, pkt_last);
-	q_last = rte_sched_port_enqueue_qptrs_prefetch0(subport_last,
-				pkt_last, subport_qmask);
-
-	q00_base = rte_sched_subport_pipe_qbase(subport00, q00);
-	q01_base = rte_sched_subport_pipe_qbase(subport01, q01);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport00, q00, q00_base);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport01, q01, q01_base);
-
-	r10 = rte_sched_port_enqueue_qwa(port, subport10, q10,
-			q10_base, pkt10);
-	r11 = rte_sched_port_enqueue_qwa(port, subport11, q11,
-			q11_base, pkt11);
-	result += r10 + r11;
-
-	q_last_base = rte_sched_subport_pipe_qbase(subport_last, q_last);
-	rte_sched_port_enqueue_qwa_prefetch0(port, subport_last,
-		q_last, q_last_base);
-
-	r00 = rte_sched_port_enqueue_qwa(port, subport00, q00,
-			q00_base, pkt00);
-	r01 = rte_sched_port_enqueue_qwa(port, subport01, q01,
-			q01_base, pkt01);
-	result += r00 + r01;
-
-	if (n_pkts & 1) {
-		r_last = rte_sched_port_enqueue_qwa(port, subport_last,
-					q_last,	q_last_base, pkt_last);
-		result += r_last;
+	if (n_last) {
+		rte_sched_port_enqueue_batch_prefetch0(&batch[0],
+			pkts + n_batches * RTE_SCHED_ENQUEUE_BATCH, n_last);
+		rte_sched_port_enqueue_qptrs_prefetch0(port, &batch[0],
+			n_last, red);
+		rte_sched_port_enqueue_batch_qwa_prefetch0(port, &batch[0],
+			n_last);
+		result += rte_sched_port_enqueue_batch_qwa(port, &batch[0],
+			n_last, red);
 	}
 
 	return result;
 }
 
+int
+rte_sched_port_enqueue(struct rte_sched_port *port, struct rte_mbuf **pkts,
+		       uint32_t n_pkts)
+{
+#ifdef RTE_SCHED_RED
+	if (port->red)
+		return rte_sched_port_enqueue_burst(port, pkts, n_pkts, 1);
+#endif
+
+	return rte_sched_port_enqueue_burst(port, pkts, n_pkts, 0);
+}
+
 #ifndef RTE_SCHED_SUBPORT_TC_OV
 
 static inline void
@@ -2193,11 +2379,13 @@ grinder_schedule(struct rte_sched_port *port,
 	uint32_t pkt_len = pkt->pkt_len + port->frame_overhead;
 	uint32_t be_tc_active;
 
-	if (!grinder_credits_check(port, subport, pos))
+	if (unlikely(pkt_len > port->tb_credits) ||
+		!grinder_credits_check(port, subport, pos))
 		return 0;
 
 	/* Advance port time */
 	port->time += pkt_len;
+	port->tb_credits -= pkt_len;
 
 	/* Send packet */
 	port->pkts_out[port->n_pkts_out++] = pkt;
@@ -2290,6 +2478,26 @@ grinder_pcache_populate(struct rte_sched_subport *subport,
 	grinder->pcache_w = 0;
 	grinder->pcache_r = 0;
 
+	/* Smaller pipes: only visit the pipes with active queues */
+	if (unlikely(subport->n_queues_per_pipe_log2 !=
+			__builtin_ctz(RTE_SCHED_QUEUES_PER_PIPE))) {
+		uint32_t n_queues = 1 << subport->n_queues_per_pipe_log2;
+		uint64_t qmask = (1LLU << n_queues) - 1;
+
+		while (bmp_slab) {
+			uint32_t i = __builtin_ctzll(bmp_slab) & ~(n_queues - 1);
+
+			grinder->pcache_qmask[grinder->pcache_w] =
+				(uint16_t) ((bmp_slab >> i) & qmask);
+			grinder->pcache_qindex[grinder->pcache_w] = bmp_pos + i;
+			grinder->pcache_w++;
+
+			bmp_slab &= ~(qmask << i);
+		}
+
+		return;
+	}
+
 	w[0] = (uint16_t) bmp_slab;
 	w[1] = (uint16_t) (bmp_slab >> 16);
 	w[2] = (uint16_t) (bmp_slab >> 32);
@@ -2319,20 +2527,22 @@ grinder_tccache_populate(struct rte_sched_subport *subport,
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	uint8_t b, i;
 
+	uint32_t n_sp_tcs = (1 << subport->n_queues_per_pipe_log2) -
+		subport->n_be_queues_per_pipe;
+
 	grinder->tccache_w = 0;
 	grinder->tccache_r = 0;
 
-	for (i = 0; i < RTE_SCHED_TRAFFIC_CLASS_BE; i++) {
+	for (i = 0; i < n_sp_tcs; i++) {
 		b = (uint8_t) ((qmask >> i) & 0x1);
 		grinder->tccache_qmask[grinder->tccache_w] = b;
 		grinder->tccache_qindex[grinder->tccache_w] = qindex + i;
 		grinder->tccache_w += (b != 0);
 	}
 
-	b = (uint8_t) (qmask >> (RTE_SCHED_TRAFFIC_CLASS_BE));
+	b = (uint8_t) (qmask >> n_sp_tcs);
 	grinder->tccache_qmask[grinder->tccache_w] = b;
-	grinder->tccache_qindex[grinder->tccache_w] = qindex +
-		RTE_SCHED_TRAFFIC_CLASS_BE;
+	grinder->tccache_qindex[grinder->tccache_w] = qindex + n_sp_tcs;
 	grinder->tccache_w += (b != 0);
 }
 
@@ -2342,7 +2552,7 @@ grinder_next_tc(struct rte_sched_port *port,
 {
 	struct rte_sched_grinder *grinder = subport->grinder + pos;
 	struct rte_mbuf **qbase;
-	uint32_t qindex;
+	uint32_t qindex, be_qmask;
 	uint16_t qsize;
 
 	if (grinder->tccache_r == grinder->tccache_w)
@@ -2365,20 +2575,25 @@ grinder_next_tc(struct rte_sched_port *port,
 		return 1;
 	}
 
+	/* The WRR slots beyond the best-effort queues of the pipe are never
+	 * selected (their qmask bit is zero), point them to the first queue.
+	 */
+	be_qmask = subport->n_be_queues_per_pipe - 1;
+
 	grinder->queue[0] = subport->queue + qindex;
-	grinder->queue[1] = subport->queue + qindex + 1;
-	grinder->queue[2] = subport->queue + qindex + 2;
-	grinder->queue[3] = subport->queue + qindex + 3;
+	grinder->queue[1] = subport->queue + qindex + (1 & be_qmask);
+	grinder->queue[2] = subport->queue + qindex + (2 & be_qmask);
+	grinder->queue[3] = subport->queue + qindex + (3 & be_qmask);
 
 	grinder->qbase[0] = qbase;
-	grinder->qbase[1] = qbase + qsize;
-	grinder->qbase[2] = qbase + 2 * qsize;
-	grinder->qbase[3] = qbase + 3 * qsize;
+	grinder->qbase[1] = qbase + (1 & be_qmask) * qsize;
+	grinder->qbase[2] = qbase + (2 & be_qmask) * qsize;
+	grinder->qbase[3] = qbase + (3 & be_qmask) * qsize;
 
 	grinder->qindex[0] = qindex;
-	grinder->qindex[1] = qindex + 1;
-	grinder->qindex[2] = qindex + 2;
-	grinder->qindex[3] = qindex + 3;
+	grinder->qindex[1] = qindex + (1 & be_qmask);
+	grinder->qindex[2] = qindex + (2 & be_qmask);
+	grinder->qindex[3] = qindex + (3 & be_qmask);
 
 	grinder->tccache_r++;
 	return 1;
@@ -2424,7 +2639,7 @@ grinder_next_pipe(struct rte_sched_port *port,
 	}
 
 	/* Install new pipe in the grinder */
-	grinder->pindex = pipe_qindex >> 4;
+	grinder->pindex = pipe_qindex >> subport->n_queues_per_pipe_log2;
 	grinder->subport = subport;
 	grinder->pipe = subport->pipe + grinder->pindex;
 	grinder->pipe_params = NULL; /* to be set after the pipe structure is prefetched */
@@ -2688,10 +2903,50 @@ rte_sched_port_time_resync(struct rte_sched_port *port)
 		port->time = port->time_cpu_bytes;
 
 	/* Reset pipe loop detection */
-	for (i = 0; i < port->n_subports_per_port; i++)
+	for (i = port->subport_id_begin; i < port->subport_id_end; i++)
 		port->subports[i]->pipe_loop = RTE_SCHED_PIPE_INVALID;
 }
 
+/* Take credits for up to n_pkts MTU sized frames from the port TB shared by
+ * the port partitions. The TB is kept as the time at which it gets empty, so
+ * taking credits is a single compare-and-swap.
+ */
+static inline void
+rte_sched_port_tb_get(struct rte_sched_port *port, uint32_t n_pkts)
+{
+	struct rte_sched_port *parent = port->parent;
+	uint64_t time = port->time_cpu_bytes;
+	uint64_t tb_time_max = time + parent->tb_size;
+	uint64_t tb_time, tb_time_new, credits;
+
+	tb_time = __atomic_load_n(&parent->tb_time, __ATOMIC_RELAXED);
+	do {
+		uint64_t tb_time_min = RTE_MAX(tb_time, time);
+
+		if (tb_time_min >= tb_time_max)
+			return;
+
+		credits = RTE_MIN((uint64_t)n_pkts * port->mtu,
+			tb_time_max - tb_time_min);
+		tb_time_new = tb_time_min + credits;
+	} while (__atomic_compare_exchange_n(&parent->tb_time, &tb_time,
+		tb_time_new, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED) == 0);
+
+	port->tb_credits = credits;
+}
+
+/* Give the unused credits back to the port TB */
+static inline void
+rte_sched_port_tb_put(struct rte_sched_port *port)
+{
+	if (port->tb_credits == 0)
+		return;
+
+	__atomic_fetch_sub(&port->parent->tb_time, port->tb_credits,
+		__ATOMIC_RELAXED);
+	port->tb_credits = 0;
+}
+
 static inline int
 rte_sched_port_exceptions(struct rte_sched_subport *subport, int second_pass)
 {
@@ -2719,6 +2974,15 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 
 	rte_sched_port_time_resync(port);
 
+	if (port->parent != NULL) {
+		rte_sched_port_tb_get(port, n_pkts);
+		if (port->tb_credits < port->mtu) {
+			rte_sched_port_tb_put(port);
+			return 0;
+		}
+	} else
+		port->tb_credits = UINT64_MAX;
+
 	/* Take each queue in the grinder one step further */
 	for (i = 0, count = 0; ; i++)  {
 		subport = port->subports[subport_id];
@@ -2726,11 +2990,12 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 		count += grinder_handle(port, subport,
 				i & (RTE_SCHED_PORT_N_GRINDERS - 1));
 
-		if (count == n_pkts) {
+		if ((count == n_pkts) ||
+			unlikely(port->tb_credits < port->mtu)) {
 			subport_id++;
 
-			if (subport_id == port->n_subports_per_port)
-				subport_id = 0;
+			if (subport_id == port->subport_id_end)
+				subport_id = port->subport_id_begin;
 
 			port->subport_id = subport_id;
 			break;
@@ -2742,14 +3007,17 @@ rte_sched_port_dequeue(struct rte_sched_port *port, struct rte_mbuf **pkts, uint
 			n_subports++;
 		}
 
-		if (subport_id == port->n_subports_per_port)
-			subport_id = 0;
+		if (subport_id == port->subport_id_end)
+			subport_id = port->subport_id_begin;
 
-		if (n_subports == port->n_subports_per_port) {
+		if (n_subports == port->subport_id_end - port->subport_id_begin) {
 			port->subport_id = subport_id;
 			break;
 		}
 	}
 
+	if (port->parent != NULL)
+		rte_sched_port_tb_put(port);
+
 	return count;
 }
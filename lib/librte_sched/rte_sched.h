@@ -70,14 +70,15 @@ extern "C" {
  * Note that the multiple queues (power of 2) can only be assigned to
  * lowest priority (best-effort) traffic class. Other higher priority traffic
  * classes can only have one queue.
- * Can not change.
+ * Can not change, but ports can be configured with smaller pipes.
  *
  * @see struct rte_sched_port_params
  */
 #define RTE_SCHED_QUEUES_PER_PIPE    16
 
-/** Number of WRR queues for best-effort traffic class per pipe.
+/** Maximum number of WRR queues for best-effort traffic class per pipe.
  *
+ * @see struct rte_sched_port_params
  * @see struct rte_sched_pipe_params
  */
 #define RTE_SCHED_BE_QUEUES_PER_PIPE    4
@@ -260,6 +261,25 @@ struct rte_sched_port_params {
 	 * the subports of the same port.
 	 */
 	uint32_t n_pipes_per_subport;
+
+	/** Number of queues per pipe: 4, 8 or 16, zero selects
+	 * RTE_SCHED_QUEUES_PER_PIPE. This parameter sets the number of bits
+	 * in struct rte_mbuf::sched.queue_id for the queue within the pipe,
+	 * as well as the size of the per queue data structures.
+	 * The maximum is RTE_SCHED_QUEUES_PER_PIPE (16) queues: the traffic
+	 * class and best-effort queue arrays of the subport and pipe
+	 * parameters have a fixed size, so larger pipes are rejected.
+	 */
+	uint32_t n_queues_per_pipe;
+
+	/** Number of best-effort traffic class queues per pipe: 1, 2 or 4,
+	 * zero selects RTE_SCHED_BE_QUEUES_PER_PIPE. The other queues of the
+	 * pipe are assigned one per strict priority traffic class, starting
+	 * with traffic class 0. The queue size and rate of the strict priority
+	 * traffic classes without a queue must be zero, and the WRR weights of
+	 * the best-effort queues beyond this number are ignored.
+	 */
+	uint32_t n_be_queues_per_pipe;
 };
 
 /*
@@ -287,6 +307,38 @@ rte_sched_port_config(struct rte_sched_port_params *params);
 void
 rte_sched_port_free(struct rte_sched_port *port);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Hierarchical scheduler port partition create
+ *
+ * Creates a handle to run the enqueue and dequeue operations of a port for a
+ * range of its subports only, so that disjoint ranges of subports of the same
+ * port can be scheduled by different lcores. The port rate is shared by all
+ * the partitions of the port through a port level token bucket.
+ *
+ * The partition shares the subports and pipes of the port, which have to be
+ * configured before the partition is created. Packets enqueued through the
+ * partition must belong to its range of subports. Stats can be read through
+ * either the port or the partition. The partitions have to be freed with
+ * rte_sched_port_free() before the port itself is freed.
+ *
+ * @param port
+ *   Handle to port scheduler instance
+ * @param subport_id
+ *   First subport ID of the partition
+ * @param n_subports
+ *   Number of subports of the partition
+ * @return
+ *   Handle to port partition on success, NULL otherwise
+ */
+__rte_experimental
+struct rte_sched_port *
+rte_sched_port_partition_create(struct rte_sched_port *port,
+	uint32_t subport_id,
+	uint32_t n_subports);
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice.
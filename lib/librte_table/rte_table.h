@@ -83,9 +83,11 @@ typedef int (*rte_table_op_free)(void *table);
  *   entry containing the data associated with the current key. This handle can
  *   be used to perform further read-write accesses to this entry. This handle
  *   is valid until the key is deleted from the table or the same key is
- *   re-added to the table, typically to associate it with different data. This
- *   pointer has to be set to a valid memory location before the function is
- *   called.
+ *   re-added to the table, typically to associate it with different data. For
+ *   the tables protected by RCU, re-adding a key moves its data, and the memory
+ *   behind the previous handle is recycled for other keys once the lookup
+ *   threads have reported a quiescent state. This pointer has to be set to a
+ *   valid memory location before the function is called.
  * @return
  *   0 on success, error code otherwise
  */
@@ -147,9 +149,11 @@ typedef int (*rte_table_op_entry_delete)(
  *   table entry containing the data associated with every key. This handle can
  *   be used to perform further read-write accesses to this entry. This handle
  *   is valid until the key is deleted from the table or the same key is
- *   re-added to the table, typically to associate it with different data. This
- *   pointer has to be set to a valid memory location before the function is
- *   called.
+ *   re-added to the table, typically to associate it with different data. For
+ *   the tables protected by RCU, re-adding a key moves its data, and the memory
+ *   behind the previous handle is recycled for other keys once the lookup
+ *   threads have reported a quiescent state. This pointer has to be set to a
+ *   valid memory location before the function is called.
  * @return
  *   0 on success, error code otherwise
  */
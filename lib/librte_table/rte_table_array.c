@@ -10,9 +10,20 @@
 #include <rte_memory.h>
 #include <rte_malloc.h>
 #include <rte_log.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+#include <rte_rcu_qsbr.h>
 
 #include "rte_table_array.h"
 
+/*
+ * Number of spare entries in RCU mode. An update writes the new entry data
+ * to a spare entry, while the entry it replaces goes through the defer queue
+ * until the readers are done with it. Updates only wait for the readers when
+ * all the spare entries are still waiting for their grace period.
+ */
+#define RCU_SPARE_ENTRIES 32
+
 #ifdef RTE_TABLE_STATS_COLLECT
 
 #define RTE_TABLE_ARRAY_STATS_PKTS_IN_ADD(table, val) \
@@ -34,20 +45,40 @@ struct rte_table_array {
 	uint32_t entry_size;
 	uint32_t n_entries;
 	uint32_t offset;
+	struct rte_rcu_qsbr *qsv;
 
 	/* Internal fields */
 	uint32_t entry_pos_mask;
 
+	/* RCU mode: per position entry pointer and spare entries */
+	uint8_t **entry_ref;
+	uint8_t **spare_stack;
+	uint32_t spare_stack_tos;
+	struct rte_rcu_qsbr_dq *dq;
+
 	/* Internal table */
 	uint8_t array[0] __rte_cache_aligned;
 } __rte_cache_aligned;
 
+/* Defer queue callback: the readers are done with these entries */
+static void
+rte_table_array_spare_free(void *p, void *e, unsigned int n)
+{
+	struct rte_table_array *t = p;
+	uint8_t **entries = e;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		t->spare_stack[t->spare_stack_tos++] = entries[i];
+}
+
 static void *
 rte_table_array_create(void *params, int socket_id, uint32_t entry_size)
 {
 	struct rte_table_array_params *p = params;
 	struct rte_table_array *t;
-	uint32_t total_cl_size, total_size;
+	uint32_t total_cl_size, total_size, n_entries, array_cl_size, i;
+	uint32_t n_spares;
 
 	/* Check input parameters */
 	if ((p == NULL) ||
@@ -55,10 +86,22 @@ rte_table_array_create(void *params, int socket_id, uint32_t entry_size)
 		(!rte_is_power_of_2(p->n_entries)))
 		return NULL;
 
+	/*
+	 * In RCU mode, the array has spare entries and is followed by the
+	 * table of entry pointers used by the lookup operation and by the
+	 * stack of free spare entries.
+	 */
+	n_spares = (p->qsv != NULL) ? RCU_SPARE_ENTRIES : 0;
+	n_entries = p->n_entries + n_spares;
+
 	/* Memory allocation */
 	total_cl_size = (sizeof(struct rte_table_array) +
 			RTE_CACHE_LINE_SIZE) / RTE_CACHE_LINE_SIZE;
-	total_cl_size += (p->n_entries * entry_size +
+	array_cl_size = (n_entries * entry_size +
+			RTE_CACHE_LINE_SIZE) / RTE_CACHE_LINE_SIZE;
+	total_cl_size += array_cl_size;
+	if (p->qsv != NULL)
+		total_cl_size += (n_entries * sizeof(uint8_t *) +
 			RTE_CACHE_LINE_SIZE) / RTE_CACHE_LINE_SIZE;
 	total_size = total_cl_size * RTE_CACHE_LINE_SIZE;
 	t = rte_zmalloc_socket("TABLE", total_size, RTE_CACHE_LINE_SIZE, socket_id);
@@ -73,8 +116,42 @@ rte_table_array_create(void *params, int socket_id, uint32_t entry_size)
 	t->entry_size = entry_size;
 	t->n_entries = p->n_entries;
 	t->offset = p->offset;
+	t->qsv = p->qsv;
 	t->entry_pos_mask = t->n_entries - 1;
 
+	if (t->qsv != NULL) {
+		struct rte_rcu_qsbr_dq_parameters dq_params;
+		char dq_name[RTE_RING_NAMESIZE];
+
+		t->entry_ref = (uint8_t **)
+			&t->array[array_cl_size * RTE_CACHE_LINE_SIZE];
+		for (i = 0; i < t->n_entries; i++)
+			t->entry_ref[i] = &t->array[i * entry_size];
+		t->spare_stack = &t->entry_ref[t->n_entries];
+		for (i = 0; i < n_spares; i++)
+			t->spare_stack[i] =
+				&t->array[(t->n_entries + i) * entry_size];
+		t->spare_stack_tos = n_spares;
+
+		snprintf(dq_name, sizeof(dq_name), "TBL_%p", t);
+		memset(&dq_params, 0, sizeof(dq_params));
+		dq_params.name = dq_name;
+		dq_params.flags = RTE_RCU_QSBR_DQ_MT_UNSAFE;
+		dq_params.size = n_spares;
+		dq_params.esize = sizeof(uint8_t *);
+		dq_params.free_fn = rte_table_array_spare_free;
+		dq_params.p = t;
+		dq_params.v = t->qsv;
+		t->dq = rte_rcu_qsbr_dq_create(&dq_params);
+		if (t->dq == NULL) {
+			RTE_LOG(ERR, TABLE,
+				"%s: Cannot create the RCU defer queue\n",
+				__func__);
+			rte_free(t);
+			return NULL;
+		}
+	}
+
 	return t;
 }
 
@@ -90,11 +167,29 @@ rte_table_array_free(void *table)
 	}
 
 	/* Free previously allocated resources */
+	if (t->dq != NULL && rte_rcu_qsbr_dq_delete(t->dq) != 0)
+		RTE_LOG(ERR, TABLE,
+			"%s: RCU defer queue not empty, readers still active\n",
+			__func__);
 	rte_free(t);
 
 	return 0;
 }
 
+static uint8_t *
+rte_table_array_spare_get(struct rte_table_array *t)
+{
+	/* Wait for the readers only when no spare entry is left */
+	while (t->spare_stack_tos == 0) {
+		rte_rcu_qsbr_dq_reclaim(t->dq, RCU_SPARE_ENTRIES, NULL, NULL,
+			NULL);
+		if (t->spare_stack_tos == 0)
+			rte_pause();
+	}
+
+	return t->spare_stack[--t->spare_stack_tos];
+}
+
 static int
 rte_table_array_entry_add(
 	void *table,
@@ -131,14 +226,54 @@ rte_table_array_entry_add(
 		return -EINVAL;
 	}
 
-	table_entry = &t->array[k->pos * t->entry_size];
-	memcpy(table_entry, entry, t->entry_size);
+	if (t->qsv != NULL) {
+		uint8_t **ref = &t->entry_ref[k->pos & t->entry_pos_mask];
+		uint8_t *old_entry = *ref;
+
+		/* Publish the new entry data through a spare entry, then
+		 * recycle the old one once the readers are done with it.
+		 */
+		table_entry = rte_table_array_spare_get(t);
+		memcpy(table_entry, entry, t->entry_size);
+		__atomic_store_n(ref, table_entry, __ATOMIC_RELEASE);
+
+		/* Cannot fail: at most RCU_SPARE_ENTRIES are queued */
+		rte_rcu_qsbr_dq_enqueue(t->dq, &old_entry);
+	} else {
+		table_entry = &t->array[k->pos * t->entry_size];
+		memcpy(table_entry, entry, t->entry_size);
+	}
+
 	*key_found = 1;
 	*entry_ptr = (void *) table_entry;
 
 	return 0;
 }
 
+static int
+rte_table_array_lookup_rcu(
+	struct rte_table_array *t,
+	struct rte_mbuf **pkts,
+	uint64_t pkts_mask,
+	void **entries)
+{
+	uint8_t **entry_ref = t->entry_ref;
+
+	for ( ; pkts_mask; ) {
+		uint32_t pkt_index = __builtin_ctzll(pkts_mask);
+		uint64_t pkt_mask = 1LLU << pkt_index;
+		struct rte_mbuf *pkt = pkts[pkt_index];
+		uint32_t entry_pos = RTE_MBUF_METADATA_UINT32(pkt,
+			t->offset) & t->entry_pos_mask;
+
+		entries[pkt_index] = (void *) __atomic_load_n(
+			&entry_ref[entry_pos], __ATOMIC_ACQUIRE);
+		pkts_mask &= ~pkt_mask;
+	}
+
+	return 0;
+}
+
 static int
 rte_table_array_lookup(
 	void *table,
@@ -152,6 +287,9 @@ rte_table_array_lookup(
 	RTE_TABLE_ARRAY_STATS_PKTS_IN_ADD(t, n_pkts_in);
 	*lookup_hit_mask = pkts_mask;
 
+	if (t->entry_ref != NULL)
+		return rte_table_array_lookup_rcu(t, pkts, pkts_mask, entries);
+
 	if ((pkts_mask & (pkts_mask + 1)) == 0) {
 		uint64_t n_pkts = __builtin_popcountll(pkts_mask);
 		uint32_t i;
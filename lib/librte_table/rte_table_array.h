@@ -21,6 +21,8 @@ extern "C" {
 
 #include "rte_table.h"
 
+struct rte_rcu_qsbr;
+
 /** Array table parameters */
 struct rte_table_array_params {
 	/** Number of array entries. Has to be a power of two. */
@@ -29,6 +31,18 @@ struct rte_table_array_params {
 	/** Byte offset within input packet meta-data where lookup key (i.e. the
 	    array entry index) is located. */
 	uint32_t offset;
+
+	/** RCU QSBR variable used to make the entry add operation safe against
+	    concurrent lookup. When set, each array entry is accessed through an
+	    indirection, so that the add operation can write the new entry data
+	    to a spare entry and switch to it atomically. The previous entry data
+	    is recycled through a defer queue once all the lookup threads
+	    registered with this variable have reported a quiescent state, so
+	    the entry handle returned by a previous add of the same key must not
+	    be used any more. The add operation only waits for the lookup
+	    threads when all the spare entries are waiting to be recycled. Set
+	    to NULL to disable. */
+	struct rte_rcu_qsbr *qsv;
 };
 
 /** Array table key format */
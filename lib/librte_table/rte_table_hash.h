@@ -46,12 +46,24 @@ extern "C" {
  * 2. Key size:
  *     a. Configurable key size
  *     b. Single key size (8-byte, 16-byte or 32-byte key size)
+ * 3. Concurrent update: The configurable key size tables (rte_table_hash_ext_ops
+ *    and rte_table_hash_lru_ops) can optionally be protected by an RCU QSBR
+ *    variable. In this mode, a single control thread can add and delete keys
+ *    while other threads keep running the lookup operation, without any lock
+ *    on the lookup path. Table memory that might still be referenced by the
+ *    lookup threads (key and data slots, bucket extensions) is only recycled
+ *    after all the lookup threads registered with the QSBR variable have
+ *    reported a quiescent state. As a consequence, a key update relocates the
+ *    key data to a new slot, so the entry pointer returned by the add
+ *    operation must be used instead of any previously returned one.
  *
  ***/
 #include <stdint.h>
 
 #include "rte_table.h"
 
+struct rte_rcu_qsbr;
+
 /** Hash function */
 typedef uint64_t (*rte_table_hash_op_hash)(
 	void *key,
@@ -84,6 +96,18 @@ struct rte_table_hash_params {
 
 	/** Seed value for the hash function */
 	uint64_t seed;
+
+	/** RCU QSBR variable used to make the key add and delete operations
+	 * safe against concurrent lookup. The lookup threads must be registered
+	 * with this variable and report their quiescent states, e.g. between
+	 * successive rte_pipeline_run() calls. The freed key slots and bucket
+	 * extensions are recycled through a defer queue, so the add and delete
+	 * operations only wait for the readers when all the spare key slots
+	 * are waiting to be recycled. They must not be called from a lookup
+	 * thread. Only supported by the configurable key size tables. Set to
+	 * NULL to disable.
+	 */
+	struct rte_rcu_qsbr *qsv;
 };
 
 /** Extendable bucket hash table operations */
@@ -10,6 +10,9 @@
 #include <rte_memory.h>
 #include <rte_malloc.h>
 #include <rte_log.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+#include <rte_rcu_qsbr.h>
 
 #include "rte_table_hash.h"
 
@@ -31,9 +34,9 @@ struct bucket {
 	((bucket)->next & 1LU)
 
 #define BUCKET_NEXT_SET(bucket, bucket_next)				\
-do									\
-	(bucket)->next = (((uintptr_t) ((void *) (bucket_next))) | 1LU);\
-while (0)
+	__atomic_store_n(&(bucket)->next,				\
+		((uintptr_t) ((void *) (bucket_next))) | 1LU,		\
+		__ATOMIC_RELEASE)
 
 #define BUCKET_NEXT_SET_NULL(bucket)					\
 do									\
@@ -41,9 +44,8 @@ do									\
 while (0)
 
 #define BUCKET_NEXT_COPY(bucket, bucket2)				\
-do									\
-	(bucket)->next = (bucket2)->next;				\
-while (0)
+	__atomic_store_n(&(bucket)->next, (bucket2)->next,		\
+		__ATOMIC_RELEASE)
 
 #ifdef RTE_TABLE_STATS_COLLECT
 
@@ -59,6 +61,23 @@ while (0)
 
 #endif
 
+/*
+ * RCU mode: number of spare key slots, so that a key update can find a free
+ * slot without waiting for the readers most of the time, even in a full table
+ */
+#define RCU_KEYS_RSVD 32
+
+/* RCU mode: maximum number of resources waiting on the defer queue */
+#define RCU_DQ_SIZE 1024u
+
+/* RCU mode: key slot and bucket extension waiting for the readers */
+struct rcu_defer_elem {
+	uint32_t key_index;
+	uint32_t bkt_ext_index;
+};
+
+#define BKT_EXT_NONE UINT32_MAX
+
 struct grinder {
 	struct bucket *bkt;
 	uint64_t sig;
@@ -78,13 +97,19 @@ struct rte_table_hash {
 	rte_table_hash_op_hash f_hash;
 	uint64_t seed;
 	uint32_t key_offset;
+	struct rte_rcu_qsbr *qsv;
 
 	/* Internal */
 	uint64_t bucket_mask;
 	uint32_t key_size_shl;
 	uint32_t data_size_shl;
 	uint32_t key_stack_tos;
+	uint32_t key_stack_rsvd;
 	uint32_t bkt_ext_stack_tos;
+	uint32_t n_keys_deferred;
+	uint32_t dq_size;
+	uint32_t n_bkt_ext_deferred;
+	struct rte_rcu_qsbr_dq *dq;
 
 	/* Grinder */
 	struct grinder grinders[RTE_PORT_IN_BURST_SIZE_MAX];
@@ -163,6 +188,98 @@ check_params_create(struct rte_table_hash_params *params)
 	return 0;
 }
 
+/* Allocate a free key slot. In RCU mode, the caller checked that a key slot
+ * is free or waiting on the defer queue: wait for the readers to release one
+ * only when none is on the stack.
+ */
+static uint32_t
+rte_table_hash_ext_key_alloc(struct rte_table_hash *t)
+{
+	while (t->key_stack_tos == 0) {
+		rte_rcu_qsbr_dq_reclaim(t->dq, RCU_DQ_SIZE, NULL, NULL, NULL);
+		if (t->key_stack_tos == 0)
+			rte_pause();
+	}
+
+	return t->key_stack[--t->key_stack_tos];
+}
+
+/* Same for the bucket extensions */
+static uint32_t
+rte_table_hash_ext_bkt_ext_alloc(struct rte_table_hash *t)
+{
+	while (t->bkt_ext_stack_tos == 0) {
+		rte_rcu_qsbr_dq_reclaim(t->dq, RCU_DQ_SIZE, NULL, NULL, NULL);
+		if (t->bkt_ext_stack_tos == 0)
+			rte_pause();
+	}
+
+	return t->bkt_ext_stack[--t->bkt_ext_stack_tos];
+}
+
+static void
+rte_table_hash_ext_key_free(struct rte_table_hash *t, uint32_t key_index,
+	uint32_t bkt_ext_index)
+{
+	/* Free key */
+	t->key_stack[t->key_stack_tos++] = key_index;
+
+	if (bkt_ext_index != BKT_EXT_NONE) {
+		/* Clear bucket */
+		memset(&t->buckets_ext[bkt_ext_index], 0,
+			sizeof(struct bucket));
+
+		/* Free bucket back to buckets ext */
+		t->bkt_ext_stack[t->bkt_ext_stack_tos++] = bkt_ext_index;
+	}
+}
+
+/* Defer queue callback: the readers are done with these resources */
+static void
+rte_table_hash_ext_rcu_free(void *p, void *e, unsigned int n)
+{
+	struct rte_table_hash *t = p;
+	struct rcu_defer_elem *elems = e;
+	unsigned int i;
+
+	for (i = 0; i < n; i++) {
+		rte_table_hash_ext_key_free(t, elems[i].key_index,
+			elems[i].bkt_ext_index);
+		t->n_keys_deferred--;
+		t->n_bkt_ext_deferred -=
+			(elems[i].bkt_ext_index != BKT_EXT_NONE);
+	}
+}
+
+/* Free a key slot and possibly a bucket extension, once no reader can
+ * reference them any more in RCU mode
+ */
+static void
+rte_table_hash_ext_key_defer(struct rte_table_hash *t, uint32_t key_index,
+	uint32_t bkt_ext_index)
+{
+	struct rcu_defer_elem e = {
+		.key_index = key_index,
+		.bkt_ext_index = bkt_ext_index,
+	};
+
+	if (t->dq == NULL) {
+		rte_table_hash_ext_key_free(t, key_index, bkt_ext_index);
+		return;
+	}
+
+	/* Wait for the readers only when the defer queue is full */
+	while (t->n_keys_deferred == t->dq_size) {
+		rte_rcu_qsbr_dq_reclaim(t->dq, RCU_DQ_SIZE, NULL, NULL, NULL);
+		if (t->n_keys_deferred == t->dq_size)
+			rte_pause();
+	}
+
+	t->n_keys_deferred++;
+	t->n_bkt_ext_deferred += (bkt_ext_index != BKT_EXT_NONE);
+	rte_rcu_qsbr_dq_enqueue(t->dq, &e);
+}
+
 static void *
 rte_table_hash_ext_create(void *params, int socket_id, uint32_t entry_size)
 {
@@ -172,7 +289,7 @@ rte_table_hash_ext_create(void *params, int socket_id, uint32_t entry_size)
 	uint64_t key_stack_sz, bkt_ext_stack_sz, data_sz, total_size;
 	uint64_t key_mask_offset, bucket_offset, bucket_ext_offset, key_offset;
 	uint64_t key_stack_offset, bkt_ext_stack_offset, data_offset;
-	uint32_t n_buckets_ext, i;
+	uint32_t n_buckets_ext, n_keys_rsvd, n_key_slots, i;
 
 	/* Check input parameters */
 	if ((check_params_create(p) != 0) ||
@@ -198,17 +315,26 @@ rte_table_hash_ext_create(void *params, int socket_id, uint32_t entry_size)
 	 */
 	n_buckets_ext = p->n_keys / KEYS_PER_BUCKET + KEYS_PER_BUCKET - 1;
 
+	/*
+	 * With RCU protection, a key update cannot overwrite the key data that
+	 * is possibly being read by the lookup threads. Some key slots are
+	 * reserved so that an update can always succeed, even when the table
+	 * is full.
+	 */
+	n_keys_rsvd = (p->qsv != NULL) ? RCU_KEYS_RSVD : 0;
+	n_key_slots = p->n_keys + n_keys_rsvd;
+
 	/* Memory allocation */
 	table_meta_sz = RTE_CACHE_LINE_ROUNDUP(sizeof(struct rte_table_hash));
 	key_mask_sz = RTE_CACHE_LINE_ROUNDUP(p->key_size);
 	bucket_sz = RTE_CACHE_LINE_ROUNDUP(p->n_buckets * sizeof(struct bucket));
 	bucket_ext_sz =
 		RTE_CACHE_LINE_ROUNDUP(n_buckets_ext * sizeof(struct bucket));
-	key_sz = RTE_CACHE_LINE_ROUNDUP(p->n_keys * p->key_size);
-	key_stack_sz = RTE_CACHE_LINE_ROUNDUP(p->n_keys * sizeof(uint32_t));
+	key_sz = RTE_CACHE_LINE_ROUNDUP(n_key_slots * p->key_size);
+	key_stack_sz = RTE_CACHE_LINE_ROUNDUP(n_key_slots * sizeof(uint32_t));
 	bkt_ext_stack_sz =
 		RTE_CACHE_LINE_ROUNDUP(n_buckets_ext * sizeof(uint32_t));
-	data_sz = RTE_CACHE_LINE_ROUNDUP(p->n_keys * entry_size);
+	data_sz = RTE_CACHE_LINE_ROUNDUP(n_key_slots * entry_size);
 	total_size = table_meta_sz + key_mask_sz + bucket_sz + bucket_ext_sz +
 		key_sz + key_stack_sz + bkt_ext_stack_sz + data_sz;
 
@@ -242,11 +368,13 @@ rte_table_hash_ext_create(void *params, int socket_id, uint32_t entry_size)
 	t->f_hash = p->f_hash;
 	t->seed = p->seed;
 	t->key_offset = p->key_offset;
+	t->qsv = p->qsv;
 
 	/* Internal */
 	t->bucket_mask = t->n_buckets - 1;
 	t->key_size_shl = __builtin_ctzl(p->key_size);
 	t->data_size_shl = __builtin_ctzl(entry_size);
+	t->key_stack_rsvd = n_keys_rsvd;
 
 	/* Tables */
 	key_mask_offset = 0;
@@ -272,15 +400,39 @@ rte_table_hash_ext_create(void *params, int socket_id, uint32_t entry_size)
 		memcpy(t->key_mask, p->key_mask, p->key_size);
 
 	/* Key stack */
-	for (i = 0; i < t->n_keys; i++)
-		t->key_stack[i] = t->n_keys - 1 - i;
-	t->key_stack_tos = t->n_keys;
+	for (i = 0; i < n_key_slots; i++)
+		t->key_stack[i] = n_key_slots - 1 - i;
+	t->key_stack_tos = n_key_slots;
 
 	/* Bucket ext stack */
 	for (i = 0; i < t->n_buckets_ext; i++)
 		t->bkt_ext_stack[i] = t->n_buckets_ext - 1 - i;
 	t->bkt_ext_stack_tos = t->n_buckets_ext;
 
+	/* Defer queue of the key slots and bucket extensions to recycle */
+	if (t->qsv != NULL) {
+		struct rte_rcu_qsbr_dq_parameters dq_params;
+		char dq_name[RTE_RING_NAMESIZE];
+
+		snprintf(dq_name, sizeof(dq_name), "TBL_%p", t);
+		memset(&dq_params, 0, sizeof(dq_params));
+		dq_params.name = dq_name;
+		dq_params.flags = RTE_RCU_QSBR_DQ_MT_UNSAFE;
+		t->dq_size = RTE_MIN(n_key_slots, RCU_DQ_SIZE);
+		dq_params.size = t->dq_size;
+		dq_params.esize = sizeof(struct rcu_defer_elem);
+		dq_params.free_fn = rte_table_hash_ext_rcu_free;
+		dq_params.p = t;
+		dq_params.v = t->qsv;
+		t->dq = rte_rcu_qsbr_dq_create(&dq_params);
+		if (t->dq == NULL) {
+			RTE_LOG(ERR, TABLE, "%s: Cannot create the RCU defer "
+				"queue for hash table %s\n", __func__, p->name);
+			rte_free(t);
+			return NULL;
+		}
+	}
+
 	return t;
 }
 
@@ -293,10 +445,41 @@ rte_table_hash_ext_free(void *table)
 	if (t == NULL)
 		return -EINVAL;
 
+	if (t->dq != NULL && rte_rcu_qsbr_dq_delete(t->dq) != 0)
+		RTE_LOG(ERR, TABLE,
+			"%s: RCU defer queue not empty, readers still active\n",
+			__func__);
 	rte_free(t);
 	return 0;
 }
 
+static int
+rte_table_hash_ext_entry_update_rcu(struct rte_table_hash *t,
+	struct bucket *bkt, uint32_t pos, void *entry, void **entry_ptr)
+{
+	uint32_t bkt_key_index = bkt->key_pos[pos];
+	uint32_t new_key_index;
+	uint8_t *data;
+
+	/* Allocate new key, one of the reserved ones is free or deferred */
+	new_key_index = rte_table_hash_ext_key_alloc(t);
+
+	/* Fill in the new key, then switch the readers over to it */
+	memcpy(&t->key_mem[new_key_index << t->key_size_shl],
+		&t->key_mem[bkt_key_index << t->key_size_shl],
+		t->key_size);
+	data = &t->data_mem[new_key_index << t->data_size_shl];
+	memcpy(data, entry, t->entry_size);
+
+	__atomic_store_n(&bkt->key_pos[pos], new_key_index, __ATOMIC_RELEASE);
+
+	/* Free old key once no reader can reference it any more */
+	rte_table_hash_ext_key_defer(t, bkt_key_index, BKT_EXT_NONE);
+
+	*entry_ptr = (void *) data;
+	return 0;
+}
+
 static int
 rte_table_hash_ext_entry_add(void *table, void *key, void *entry,
 	int *key_found, void **entry_ptr)
@@ -324,8 +507,12 @@ rte_table_hash_ext_entry_add(void *table, void *key, void *entry,
 				uint8_t *data = &t->data_mem[bkt_key_index <<
 					t->data_size_shl];
 
-				memcpy(data, entry, t->entry_size);
 				*key_found = 1;
+				if (t->qsv != NULL)
+					return rte_table_hash_ext_entry_update_rcu(t,
+						bkt, i, entry, entry_ptr);
+
+				memcpy(data, entry, t->entry_size);
 				*entry_ptr = (void *) data;
 				return 0;
 			}
@@ -342,22 +529,27 @@ rte_table_hash_ext_entry_add(void *table, void *key, void *entry,
 				uint8_t *bkt_key, *data;
 
 				/* Allocate new key */
-				if (t->key_stack_tos == 0) /* No free keys */
-					return -ENOSPC;
+				if (t->key_stack_tos + t->n_keys_deferred <=
+					t->key_stack_rsvd)
+					return -ENOSPC; /* No free keys */
 
-				bkt_key_index = t->key_stack[
-					--t->key_stack_tos];
+				bkt_key_index = rte_table_hash_ext_key_alloc(t);
 
-				/* Install new key */
+				/* Install new key. Readers of a key deleted
+				 * from this position can still read key_pos,
+				 * so it is set once the key is written.
+				 */
 				bkt_key = &t->key_mem[bkt_key_index <<
 					t->key_size_shl];
 				data = &t->data_mem[bkt_key_index <<
 					t->data_size_shl];
 
-				bkt->sig[i] = (uint16_t) sig;
-				bkt->key_pos[i] = bkt_key_index;
 				keycpy(bkt_key, key, t->key_mask, t->key_size);
 				memcpy(data, entry, t->entry_size);
+				__atomic_store_n(&bkt->key_pos[i],
+					bkt_key_index, __ATOMIC_RELEASE);
+				__atomic_store_n(&bkt->sig[i], (uint16_t) sig,
+					__ATOMIC_RELEASE);
 
 				*key_found = 0;
 				*entry_ptr = (void *) data;
@@ -366,20 +558,17 @@ rte_table_hash_ext_entry_add(void *table, void *key, void *entry,
 		}
 
 	/* Bucket full: extend bucket */
-	if ((t->bkt_ext_stack_tos > 0) && (t->key_stack_tos > 0)) {
+	if ((t->bkt_ext_stack_tos + t->n_bkt_ext_deferred > 0) &&
+		(t->key_stack_tos + t->n_keys_deferred > t->key_stack_rsvd)) {
 		uint32_t bkt_key_index;
 		uint8_t *bkt_key, *data;
 
 		/* Allocate new bucket ext */
-		bkt_index = t->bkt_ext_stack[--t->bkt_ext_stack_tos];
+		bkt_index = rte_table_hash_ext_bkt_ext_alloc(t);
 		bkt = &t->buckets_ext[bkt_index];
 
-		/* Chain the new bucket ext */
-		BUCKET_NEXT_SET(bkt_prev, bkt);
-		BUCKET_NEXT_SET_NULL(bkt);
-
 		/* Allocate new key */
-		bkt_key_index = t->key_stack[--t->key_stack_tos];
+		bkt_key_index = rte_table_hash_ext_key_alloc(t);
 		bkt_key = &t->key_mem[bkt_key_index << t->key_size_shl];
 
 		data = &t->data_mem[bkt_key_index << t->data_size_shl];
@@ -390,6 +579,10 @@ rte_table_hash_ext_entry_add(void *table, void *key, void *entry,
 		keycpy(bkt_key, key, t->key_mask, t->key_size);
 		memcpy(data, entry, t->entry_size);
 
+		/* Chain the new bucket ext once it is fully initialized */
+		BUCKET_NEXT_SET_NULL(bkt);
+		BUCKET_NEXT_SET(bkt_prev, bkt);
+
 		*key_found = 0;
 		*entry_ptr = (void *) data;
 		return 0;
@@ -406,6 +599,7 @@ void *entry)
 	struct bucket *bkt0, *bkt, *bkt_prev;
 	uint64_t sig;
 	uint32_t bkt_index, i;
+	int bkt_unused;
 
 	sig = t->f_hash(key, t->key_mask, t->key_size, t->seed);
 	bkt_index = sig & t->bucket_mask;
@@ -427,30 +621,27 @@ void *entry)
 					t->data_size_shl];
 
 				/* Uninstall key from bucket */
-				bkt->sig[i] = 0;
+				__atomic_store_n(&bkt->sig[i], 0,
+					__ATOMIC_RELAXED);
 				*key_found = 1;
 				if (entry)
 					memcpy(entry, data, t->entry_size);
 
-				/* Free key */
-				t->key_stack[t->key_stack_tos++] =
-					bkt_key_index;
-
 				/*Check if bucket is unused */
-				if ((bkt_prev != NULL) &&
+				bkt_unused = (bkt_prev != NULL) &&
 				    (bkt->sig[0] == 0) && (bkt->sig[1] == 0) &&
-				    (bkt->sig[2] == 0) && (bkt->sig[3] == 0)) {
-					/* Unchain bucket */
-					BUCKET_NEXT_COPY(bkt_prev, bkt);
+				    (bkt->sig[2] == 0) && (bkt->sig[3] == 0);
 
-					/* Clear bucket */
-					memset(bkt, 0, sizeof(struct bucket));
+				/* Unchain bucket */
+				if (bkt_unused)
+					BUCKET_NEXT_COPY(bkt_prev, bkt);
 
-					/* Free bucket back to buckets ext */
-					bkt_index = bkt - t->buckets_ext;
-					t->bkt_ext_stack[t->bkt_ext_stack_tos++]
-						= bkt_index;
-				}
+				/* Free key and bucket once no reader can
+				 * reference them any more
+				 */
+				rte_table_hash_ext_key_defer(t, bkt_key_index,
+					bkt_unused ? (uint32_t)(bkt -
+					t->buckets_ext) : BKT_EXT_NONE);
 
 				return 0;
 			}
@@ -496,12 +687,20 @@ static int rte_table_hash_ext_lookup_unoptimized(
 		for (bkt = bkt0; bkt != NULL; bkt = BUCKET_NEXT(bkt))
 			for (i = 0; i < KEYS_PER_BUCKET; i++) {
 				uint64_t bkt_sig = (uint64_t) bkt->sig[i];
-				uint32_t bkt_key_index = bkt->key_pos[i];
-				uint8_t *bkt_key = &t->key_mem[bkt_key_index <<
+				uint32_t bkt_key_index;
+				uint8_t *bkt_key;
+
+				if (sig != bkt_sig)
+					continue;
+
+				/* Read key after signature */
+				rte_smp_rmb();
+				bkt_key_index = bkt->key_pos[i];
+				bkt_key = &t->key_mem[bkt_key_index <<
 					t->key_size_shl];
 
-				if ((sig == bkt_sig) && (keycmp(bkt_key, key,
-					t->key_mask, t->key_size) == 0)) {
+				if (keycmp(bkt_key, key, t->key_mask,
+					t->key_size) == 0) {
 					uint8_t *data = &t->data_mem[
 					bkt_key_index << t->data_size_shl];
 
@@ -762,6 +961,7 @@ static int rte_table_hash_ext_lookup_unoptimized(
 	bkt20 = g20->bkt;						\
 	sig20 = (sig20 >> 16) | 1LLU;					\
 	lookup_cmp_sig(sig20, bkt20, match20, match_many20, match_pos20);\
+	rte_smp_rmb();							\
 	match20 <<= pkt20_index;					\
 	match_many20 |= BUCKET_NEXT_VALID(bkt20);			\
 	match_many20 <<= pkt20_index;					\
@@ -773,6 +973,7 @@ static int rte_table_hash_ext_lookup_unoptimized(
 	bkt21 = g21->bkt;						\
 	sig21 = (sig21 >> 16) | 1LLU;					\
 	lookup_cmp_sig(sig21, bkt21, match21, match_many21, match_pos21);\
+	rte_smp_rmb();							\
 	match21 <<= pkt21_index;					\
 	match_many21 |= BUCKET_NEXT_VALID(bkt21);			\
 	match_many21 <<= pkt21_index;					\
@@ -117,6 +117,13 @@ check_params_create(struct rte_table_hash_params *params)
 		return -EINVAL;
 	}
 
+	/* qsv */
+	if (params->qsv != NULL) {
+		RTE_LOG(ERR, TABLE, "%s: RCU protection not supported\n",
+			__func__);
+		return -EINVAL;
+	}
+
 	return 0;
 }
 
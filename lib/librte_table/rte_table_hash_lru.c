@@ -10,6 +10,9 @@
 #include <rte_memory.h>
 #include <rte_malloc.h>
 #include <rte_log.h>
+#include <rte_pause.h>
+#include <rte_ring.h>
+#include <rte_rcu_qsbr.h>
 
 #include "rte_table_hash.h"
 #include "rte_lru.h"
@@ -39,6 +42,15 @@ struct bucket {
 	uint32_t key_pos[KEYS_PER_BUCKET];
 };
 
+/*
+ * RCU mode: number of spare key slots, so that a key update can find a free
+ * slot without waiting for the readers most of the time, even in a full table
+ */
+#define RCU_KEYS_RSVD 32
+
+/* RCU mode: maximum number of key slots waiting on the defer queue */
+#define RCU_DQ_SIZE 1024u
+
 struct grinder {
 	struct bucket *bkt;
 	uint64_t sig;
@@ -58,12 +70,17 @@ struct rte_table_hash {
 	rte_table_hash_op_hash f_hash;
 	uint64_t seed;
 	uint32_t key_offset;
+	struct rte_rcu_qsbr *qsv;
 
 	/* Internal */
 	uint64_t bucket_mask;
 	uint32_t key_size_shl;
 	uint32_t data_size_shl;
 	uint32_t key_stack_tos;
+	uint32_t key_stack_rsvd;
+	uint32_t n_keys_deferred;
+	uint32_t dq_size;
+	struct rte_rcu_qsbr_dq *dq;
 
 	/* Grinder */
 	struct grinder grinders[RTE_PORT_IN_BURST_SIZE_MAX];
@@ -140,6 +157,55 @@ check_params_create(struct rte_table_hash_params *params)
 	return 0;
 }
 
+/* Allocate a free key slot. In RCU mode, the caller checked that a key slot
+ * is free or waiting on the defer queue: wait for the readers to release one
+ * only when none is on the stack.
+ */
+static uint32_t
+rte_table_hash_lru_key_alloc(struct rte_table_hash *t)
+{
+	while (t->key_stack_tos == 0) {
+		rte_rcu_qsbr_dq_reclaim(t->dq, RCU_DQ_SIZE, NULL, NULL, NULL);
+		if (t->key_stack_tos == 0)
+			rte_pause();
+	}
+
+	return t->key_stack[--t->key_stack_tos];
+}
+
+/* Defer queue callback: the readers are done with these key slots */
+static void
+rte_table_hash_lru_rcu_free(void *p, void *e, unsigned int n)
+{
+	struct rte_table_hash *t = p;
+	uint32_t *key_index = e;
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		t->key_stack[t->key_stack_tos++] = key_index[i];
+	t->n_keys_deferred -= n;
+}
+
+/* Free a key slot, once no reader can reference it any more in RCU mode */
+static void
+rte_table_hash_lru_key_defer(struct rte_table_hash *t, uint32_t key_index)
+{
+	if (t->dq == NULL) {
+		t->key_stack[t->key_stack_tos++] = key_index;
+		return;
+	}
+
+	/* Wait for the readers only when the defer queue is full */
+	while (t->n_keys_deferred == t->dq_size) {
+		rte_rcu_qsbr_dq_reclaim(t->dq, RCU_DQ_SIZE, NULL, NULL, NULL);
+		if (t->n_keys_deferred == t->dq_size)
+			rte_pause();
+	}
+
+	t->n_keys_deferred++;
+	rte_rcu_qsbr_dq_enqueue(t->dq, &key_index);
+}
+
 static void *
 rte_table_hash_lru_create(void *params, int socket_id, uint32_t entry_size)
 {
@@ -149,7 +215,7 @@ rte_table_hash_lru_create(void *params, int socket_id, uint32_t entry_size)
 	uint64_t data_sz, total_size;
 	uint64_t key_mask_offset, bucket_offset, key_offset, key_stack_offset;
 	uint64_t data_offset;
-	uint32_t n_buckets, i;
+	uint32_t n_buckets, n_keys_rsvd, n_key_slots, i;
 
 	/* Check input parameters */
 	if ((check_params_create(p) != 0) ||
@@ -178,13 +244,22 @@ rte_table_hash_lru_create(void *params, int socket_id, uint32_t entry_size)
 		(p->n_keys + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET);
 	n_buckets = RTE_MAX(n_buckets, p->n_buckets);
 
+	/*
+	 * With RCU protection, the key data that is possibly being read by the
+	 * lookup threads cannot be overwritten in place on key update or on
+	 * bucket full. Some key slots are reserved so that these operations
+	 * can always succeed, even when all the other keys are in use.
+	 */
+	n_keys_rsvd = (p->qsv != NULL) ? RCU_KEYS_RSVD : 0;
+	n_key_slots = p->n_keys + n_keys_rsvd;
+
 	/* Memory allocation */
 	table_meta_sz = RTE_CACHE_LINE_ROUNDUP(sizeof(struct rte_table_hash));
 	key_mask_sz = RTE_CACHE_LINE_ROUNDUP(p->key_size);
 	bucket_sz = RTE_CACHE_LINE_ROUNDUP(n_buckets * sizeof(struct bucket));
-	key_sz = RTE_CACHE_LINE_ROUNDUP(p->n_keys * p->key_size);
-	key_stack_sz = RTE_CACHE_LINE_ROUNDUP(p->n_keys * sizeof(uint32_t));
-	data_sz = RTE_CACHE_LINE_ROUNDUP(p->n_keys * entry_size);
+	key_sz = RTE_CACHE_LINE_ROUNDUP(n_key_slots * p->key_size);
+	key_stack_sz = RTE_CACHE_LINE_ROUNDUP(n_key_slots * sizeof(uint32_t));
+	data_sz = RTE_CACHE_LINE_ROUNDUP(n_key_slots * entry_size);
 	total_size = table_meta_sz + key_mask_sz + bucket_sz + key_sz +
 		key_stack_sz + data_sz;
 
@@ -219,11 +294,13 @@ rte_table_hash_lru_create(void *params, int socket_id, uint32_t entry_size)
 	t->f_hash = p->f_hash;
 	t->seed = p->seed;
 	t->key_offset = p->key_offset;
+	t->qsv = p->qsv;
 
 	/* Internal */
 	t->bucket_mask = t->n_buckets - 1;
 	t->key_size_shl = __builtin_ctzl(p->key_size);
 	t->data_size_shl = __builtin_ctzl(entry_size);
+	t->key_stack_rsvd = n_keys_rsvd;
 
 	/* Tables */
 	key_mask_offset = 0;
@@ -245,9 +322,9 @@ rte_table_hash_lru_create(void *params, int socket_id, uint32_t entry_size)
 		memcpy(t->key_mask, p->key_mask, p->key_size);
 
 	/* Key stack */
-	for (i = 0; i < t->n_keys; i++)
-		t->key_stack[i] = t->n_keys - 1 - i;
-	t->key_stack_tos = t->n_keys;
+	for (i = 0; i < n_key_slots; i++)
+		t->key_stack[i] = n_key_slots - 1 - i;
+	t->key_stack_tos = n_key_slots;
 
 	/* LRU */
 	for (i = 0; i < t->n_buckets; i++) {
@@ -256,6 +333,30 @@ rte_table_hash_lru_create(void *params, int socket_id, uint32_t entry_size)
 		lru_init(bkt);
 	}
 
+	/* Defer queue of the key slots to recycle */
+	if (t->qsv != NULL) {
+		struct rte_rcu_qsbr_dq_parameters dq_params;
+		char dq_name[RTE_RING_NAMESIZE];
+
+		snprintf(dq_name, sizeof(dq_name), "TBL_%p", t);
+		memset(&dq_params, 0, sizeof(dq_params));
+		dq_params.name = dq_name;
+		dq_params.flags = RTE_RCU_QSBR_DQ_MT_UNSAFE;
+		t->dq_size = RTE_MIN(n_key_slots, RCU_DQ_SIZE);
+		dq_params.size = t->dq_size;
+		dq_params.esize = sizeof(uint32_t);
+		dq_params.free_fn = rte_table_hash_lru_rcu_free;
+		dq_params.p = t;
+		dq_params.v = t->qsv;
+		t->dq = rte_rcu_qsbr_dq_create(&dq_params);
+		if (t->dq == NULL) {
+			RTE_LOG(ERR, TABLE, "%s: Cannot create the RCU defer "
+				"queue for hash table %s\n", __func__, p->name);
+			rte_free(t);
+			return NULL;
+		}
+	}
+
 	return t;
 }
 
@@ -268,10 +369,43 @@ rte_table_hash_lru_free(void *table)
 	if (t == NULL)
 		return -EINVAL;
 
+	if (t->dq != NULL && rte_rcu_qsbr_dq_delete(t->dq) != 0)
+		RTE_LOG(ERR, TABLE,
+			"%s: RCU defer queue not empty, readers still active\n",
+			__func__);
 	rte_free(t);
 	return 0;
 }
 
+static int
+rte_table_hash_lru_entry_replace_rcu(struct rte_table_hash *t,
+	struct bucket *bkt, uint32_t pos, uint16_t sig, void *key, void *entry,
+	void **entry_ptr)
+{
+	uint32_t bkt_key_index = bkt->key_pos[pos];
+	uint32_t new_key_index;
+	uint8_t *data;
+
+	/* Allocate new key, one of the reserved ones is free or deferred */
+	new_key_index = rte_table_hash_lru_key_alloc(t);
+
+	/* Fill in the new key, then switch the readers over to it */
+	keycpy(&t->key_mem[new_key_index << t->key_size_shl], key,
+		t->key_mask, t->key_size);
+	data = &t->data_mem[new_key_index << t->data_size_shl];
+	memcpy(data, entry, t->entry_size);
+
+	__atomic_store_n(&bkt->key_pos[pos], new_key_index, __ATOMIC_RELEASE);
+	__atomic_store_n(&bkt->sig[pos], sig, __ATOMIC_RELEASE);
+	lru_update(bkt, pos);
+
+	/* Free old key once no reader can reference it any more */
+	rte_table_hash_lru_key_defer(t, bkt_key_index);
+
+	*entry_ptr = (void *) data;
+	return 0;
+}
+
 static int
 rte_table_hash_lru_entry_add(void *table, void *key, void *entry,
 	int *key_found, void **entry_ptr)
@@ -298,9 +432,14 @@ rte_table_hash_lru_entry_add(void *table, void *key, void *entry,
 			uint8_t *data = &t->data_mem[bkt_key_index <<
 				t->data_size_shl];
 
+			*key_found = 1;
+			if (t->qsv != NULL)
+				return rte_table_hash_lru_entry_replace_rcu(t,
+					bkt, i, (uint16_t) sig, key, entry,
+					entry_ptr);
+
 			memcpy(data, entry, t->entry_size);
 			lru_update(bkt, i);
-			*key_found = 1;
 			*entry_ptr = (void *) data;
 			return 0;
 		}
@@ -315,20 +454,26 @@ rte_table_hash_lru_entry_add(void *table, void *key, void *entry,
 			uint8_t *bkt_key, *data;
 
 			/* Allocate new key */
-			if (t->key_stack_tos == 0) {
+			if (t->key_stack_tos + t->n_keys_deferred <=
+				t->key_stack_rsvd) {
 				/* No keys available */
 				return -ENOSPC;
 			}
-			bkt_key_index = t->key_stack[--t->key_stack_tos];
+			bkt_key_index = rte_table_hash_lru_key_alloc(t);
 
-			/* Install new key */
+			/* Install new key. Readers of a key deleted from this
+			 * position can still read key_pos, so it is set once
+			 * the key is written.
+			 */
 			bkt_key = &t->key_mem[bkt_key_index << t->key_size_shl];
 			data = &t->data_mem[bkt_key_index << t->data_size_shl];
 
-			bkt->sig[i] = (uint16_t) sig;
-			bkt->key_pos[i] = bkt_key_index;
 			keycpy(bkt_key, key, t->key_mask, t->key_size);
 			memcpy(data, entry, t->entry_size);
+			__atomic_store_n(&bkt->key_pos[i], bkt_key_index,
+				__ATOMIC_RELEASE);
+			__atomic_store_n(&bkt->sig[i], (uint16_t) sig,
+				__ATOMIC_RELEASE);
 			lru_update(bkt, i);
 
 			*key_found = 0;
@@ -338,6 +483,11 @@ rte_table_hash_lru_entry_add(void *table, void *key, void *entry,
 	}
 
 	/* Bucket full */
+	*key_found = 0;
+	if (t->qsv != NULL)
+		return rte_table_hash_lru_entry_replace_rcu(t, bkt, lru_pos(bkt),
+			(uint16_t) sig, key, entry, entry_ptr);
+
 	{
 		uint64_t pos = lru_pos(bkt);
 		uint32_t bkt_key_index = bkt->key_pos[pos];
@@ -350,7 +500,6 @@ rte_table_hash_lru_entry_add(void *table, void *key, void *entry,
 		memcpy(data, entry, t->entry_size);
 		lru_update(bkt, pos);
 
-		*key_found = 0;
 		*entry_ptr = (void *) data;
 		return 0;
 	}
@@ -382,11 +531,13 @@ rte_table_hash_lru_entry_delete(void *table, void *key, int *key_found,
 			uint8_t *data = &t->data_mem[bkt_key_index <<
 				t->data_size_shl];
 
-			bkt->sig[i] = 0;
-			t->key_stack[t->key_stack_tos++] = bkt_key_index;
+			__atomic_store_n(&bkt->sig[i], 0, __ATOMIC_RELAXED);
 			*key_found = 1;
 			if (entry)
 				memcpy(entry, data, t->entry_size);
+
+			/* Free key once no reader can reference it any more */
+			rte_table_hash_lru_key_defer(t, bkt_key_index);
 			return 0;
 		}
 	}
@@ -431,12 +582,18 @@ static int rte_table_hash_lru_lookup_unoptimized(
 		/* Key is present in the bucket */
 		for (i = 0; i < KEYS_PER_BUCKET; i++) {
 			uint64_t bkt_sig = (uint64_t) bkt->sig[i];
-			uint32_t bkt_key_index = bkt->key_pos[i];
-			uint8_t *bkt_key = &t->key_mem[bkt_key_index <<
-				t->key_size_shl];
+			uint32_t bkt_key_index;
+			uint8_t *bkt_key;
+
+			if (sig != bkt_sig)
+				continue;
+
+			/* Read key after signature */
+			rte_smp_rmb();
+			bkt_key_index = bkt->key_pos[i];
+			bkt_key = &t->key_mem[bkt_key_index << t->key_size_shl];
 
-			if ((sig == bkt_sig) && (keycmp(bkt_key, key, t->key_mask,
-				t->key_size) == 0)) {
+			if (keycmp(bkt_key, key, t->key_mask, t->key_size) == 0) {
 				uint8_t *data = &t->data_mem[bkt_key_index <<
 					t->data_size_shl];
 
@@ -700,6 +857,7 @@ static int rte_table_hash_lru_lookup_unoptimized(
 	bkt20 = g20->bkt;					\
 	sig20 = (sig20 >> 16) | 1LLU;				\
 	lookup_cmp_sig(sig20, bkt20, match20, match_many20, match_pos20);\
+	rte_smp_rmb();						\
 	match20 <<= pkt20_index;				\
 	match_many20 <<= pkt20_index;				\
 	key20_index = bkt20->key_pos[match_pos20];		\
@@ -710,6 +868,7 @@ static int rte_table_hash_lru_lookup_unoptimized(
 	bkt21 = g21->bkt;					\
 	sig21 = (sig21 >> 16) | 1LLU;				\
 	lookup_cmp_sig(sig21, bkt21, match21, match_many21, match_pos21);\
+	rte_smp_rmb();						\
 	match21 <<= pkt21_index;				\
 	match_many21 <<= pkt21_index;				\
 	key21_index = bkt21->key_pos[match_pos21];		\
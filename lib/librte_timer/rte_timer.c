@@ -29,6 +29,40 @@
 
 #include "rte_timer.h"
 
+/* number of levels of a timer wheel, and number of slots per level */
+#define WHEEL_LEVELS		4
+#define WHEEL_LEVEL_BITS	8
+#define WHEEL_LEVEL_SLOTS	(1 << WHEEL_LEVEL_BITS)
+#define WHEEL_SLOTS		(WHEEL_LEVELS * WHEEL_LEVEL_SLOTS)
+
+/*
+ * A wheel links its timers through their skiplist pointers: the next and
+ * previous timers of the slot, and the index of the slot.
+ */
+#define WHEEL_NEXT		0
+#define WHEEL_PREV		1
+#define WHEEL_SLOT		2
+#define WHEEL_NO_SLOT		UINT32_MAX /**< Timer removed from the wheel */
+
+/**
+ * Hierarchical timing wheel.
+ *
+ * The expiry times are counted in ticks of 2^shift timer cycles. Slot i of
+ * level l holds the timers expiring in a tick whose bits [8 * l, 8 * l + 8)
+ * are i, less than 256^(l + 1) ticks after the next tick to process when
+ * they were added. When the next tick to process enters a new slot of
+ * level l, the timers of this slot are moved down to the lower levels.
+ */
+struct timer_wheel {
+	uint64_t now;		/**< Next tick to process */
+	uint32_t shift;		/**< log2 of the timer cycles per tick */
+	uint32_t nb_timers;	/**< Number of timers in the wheel */
+	/** Non-empty slots */
+	uint64_t bitmap[WHEEL_SLOTS / 64];
+	/** First timer of each slot */
+	struct rte_timer *slots[WHEEL_SLOTS];
+} __rte_cache_aligned;
+
 /**
  * Per-lcore info for timers.
  */
@@ -48,6 +82,9 @@ struct priv_timer {
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
+	/** timer wheel holding the pending timers, NULL for the skiplist */
+	struct timer_wheel *wheel;
+
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 	/** per-lcore statistics */
 	struct rte_timer_debug_stats stats;
@@ -116,12 +153,62 @@ rte_timer_data_alloc(uint32_t *id_ptr)
 	return -ENOSPC;
 }
 
+int
+rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t resolution)
+{
+	struct rte_timer_data *data;
+	struct timer_wheel *wheels;
+	uint32_t id, shift;
+	uint64_t now;
+	int lcore_id, ret;
+
+	if (!rte_timer_subsystem_initialized)
+		return -ENOMEM;
+
+	if (resolution == 0)
+		resolution = rte_get_timer_hz() / US_PER_S;
+	shift = resolution > 1 ? rte_bsf64(rte_align64prevpow2(resolution)) :
+		0;
+
+	wheels = rte_zmalloc("timer_wheels", RTE_MAX_LCORE * sizeof(*wheels),
+			RTE_CACHE_LINE_SIZE);
+	if (wheels == NULL)
+		return -ENOMEM;
+
+	ret = rte_timer_data_alloc(&id);
+	if (ret < 0) {
+		rte_free(wheels);
+		return ret;
+	}
+
+	data = &rte_timer_data_arr[id];
+	now = rte_get_timer_cycles() >> shift;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		wheels[lcore_id].shift = shift;
+		wheels[lcore_id].now = now;
+		data->priv_timer[lcore_id].wheel = &wheels[lcore_id];
+		data->priv_timer[lcore_id].pending_head.expire = 0;
+	}
+
+	if (id_ptr)
+		*id_ptr = id;
+
+	return 0;
+}
+
 int
 rte_timer_data_dealloc(uint32_t id)
 {
 	struct rte_timer_data *timer_data;
+	int lcore_id;
+
 	TIMER_DATA_VALID_GET_OR_ERR_RET(id, timer_data, -EINVAL);
 
+	/* the wheels of all lcores are allocated at once */
+	rte_free(timer_data->priv_timer[0].wheel);
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		timer_data->priv_timer[lcore_id].wheel = NULL;
+
 	timer_data->internal_flags &= ~(FL_ALLOCATED);
 
 	return 0;
@@ -373,6 +460,213 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 	}
 }
 
+static inline uint32_t
+wheel_slot(const struct rte_timer *tim)
+{
+	return (uint32_t)(uintptr_t)tim->sl_next[WHEEL_SLOT];
+}
+
+static inline void
+wheel_set_slot(struct rte_timer *tim, uint32_t slot)
+{
+	tim->sl_next[WHEEL_SLOT] = (struct rte_timer *)(uintptr_t)slot;
+}
+
+/* first non-empty slot of level 0 from index idx, or WHEEL_LEVEL_SLOTS */
+static uint32_t
+wheel_next_slot(const struct timer_wheel *w, uint32_t idx)
+{
+	uint32_t i = idx / 64;
+	uint64_t bits;
+
+	bits = w->bitmap[i] & (UINT64_MAX << (idx % 64));
+	while (bits == 0) {
+		if (++i == WHEEL_LEVEL_SLOTS / 64)
+			return WHEEL_LEVEL_SLOTS;
+		bits = w->bitmap[i];
+	}
+
+	return i * 64 + rte_bsf64(bits);
+}
+
+/*
+ * Save the earliest time a timer of the wheel may expire into the expire
+ * field of the dummy hdr: the next non-empty slot of level 0, or the end
+ * of the current round when the higher levels are moved down.
+ */
+static void
+wheel_update_expire(struct priv_timer *priv)
+{
+	struct timer_wheel *w = priv->wheel;
+	uint32_t idx = w->now % WHEEL_LEVEL_SLOTS;
+	uint64_t tick = w->now;
+
+	/* at the start of a round, the higher levels are not moved yet */
+	if (idx != 0)
+		tick += wheel_next_slot(w, idx) - idx;
+
+	/* NOTE: this is not atomic on 32-bit */
+	priv->pending_head.expire = tick << w->shift;
+}
+
+/* link a timer to the slot of its expiry time */
+static void
+wheel_insert(struct timer_wheel *w, struct rte_timer *tim)
+{
+	const uint64_t span = UINT64_C(1) << (WHEEL_LEVELS * WHEEL_LEVEL_BITS);
+	uint64_t tick, delta;
+	uint32_t lvl, slot;
+
+	/* round up, not to expire early */
+	tick = (tim->expire >> w->shift) +
+		((tim->expire & ((UINT64_C(1) << w->shift) - 1)) != 0);
+	if (tick < w->now)
+		tick = w->now;
+
+	delta = tick - w->now;
+	for (lvl = 0; lvl < WHEEL_LEVELS - 1; lvl++)
+		if (delta >> ((lvl + 1) * WHEEL_LEVEL_BITS) == 0)
+			break;
+	/* beyond the wheel, wait in the last slot to be moved down */
+	if (delta >= span)
+		tick = w->now + span - 1;
+
+	slot = lvl * WHEEL_LEVEL_SLOTS +
+		(tick >> (lvl * WHEEL_LEVEL_BITS)) % WHEEL_LEVEL_SLOTS;
+
+	tim->sl_next[WHEEL_NEXT] = w->slots[slot];
+	tim->sl_next[WHEEL_PREV] = NULL;
+	wheel_set_slot(tim, slot);
+	if (w->slots[slot] != NULL)
+		w->slots[slot]->sl_next[WHEEL_PREV] = tim;
+	w->slots[slot] = tim;
+	w->bitmap[slot / 64] |= UINT64_C(1) << (slot % 64);
+}
+
+/* same as timer_add() for a timer wheel */
+static void
+wheel_add(struct priv_timer *priv, struct rte_timer *tim)
+{
+	struct timer_wheel *w = priv->wheel;
+	uint64_t now;
+
+	/* an empty wheel has not followed the time */
+	if (w->nb_timers == 0) {
+		now = rte_get_timer_cycles() >> w->shift;
+		if (now > w->now)
+			w->now = now;
+	}
+
+	wheel_insert(w, tim);
+	w->nb_timers++;
+
+	if (w->nb_timers == 1 || wheel_slot(tim) < WHEEL_LEVEL_SLOTS)
+		wheel_update_expire(priv);
+}
+
+/* same as timer_del() for a timer wheel, with lock held */
+static void
+wheel_del(struct priv_timer *priv, struct rte_timer *tim)
+{
+	struct timer_wheel *w = priv->wheel;
+	struct rte_timer *next = tim->sl_next[WHEEL_NEXT];
+	struct rte_timer *prev = tim->sl_next[WHEEL_PREV];
+	uint32_t slot = wheel_slot(tim);
+
+	/* already in a list of expired timers */
+	if (slot == WHEEL_NO_SLOT)
+		return;
+
+	if (next != NULL)
+		next->sl_next[WHEEL_PREV] = prev;
+	if (prev != NULL) {
+		prev->sl_next[WHEEL_NEXT] = next;
+	} else {
+		w->slots[slot] = next;
+		if (next == NULL)
+			w->bitmap[slot / 64] &= ~(UINT64_C(1) << (slot % 64));
+	}
+	w->nb_timers--;
+}
+
+/* unlink the timers of a slot, return the first one */
+static struct rte_timer *
+wheel_slot_detach(struct timer_wheel *w, uint32_t slot)
+{
+	struct rte_timer *tim = w->slots[slot];
+
+	w->slots[slot] = NULL;
+	w->bitmap[slot / 64] &= ~(UINT64_C(1) << (slot % 64));
+
+	return tim;
+}
+
+/* move the timers of a slot of a higher level to the lower levels */
+static void
+wheel_cascade(struct timer_wheel *w, uint32_t slot)
+{
+	struct rte_timer *tim, *next_tim;
+
+	for (tim = wheel_slot_detach(w, slot); tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[WHEEL_NEXT];
+		wheel_insert(w, tim);
+	}
+}
+
+/*
+ * Same as timer_get_expired() for a timer wheel: process the ticks until
+ * the current time, skipping the empty slots of level 0.
+ */
+static struct rte_timer *
+wheel_get_expired(struct priv_timer *priv, uint64_t cur_time)
+{
+	struct timer_wheel *w = priv->wheel;
+	const uint64_t last = cur_time >> w->shift;
+	struct rte_timer *run_first_tim = NULL;
+	struct rte_timer **pprev = &run_first_tim;
+	struct rte_timer *tim;
+	uint32_t idx, next, lvl, slot;
+
+	while (w->now <= last && w->nb_timers != 0) {
+		idx = w->now % WHEEL_LEVEL_SLOTS;
+
+		/* new round of level 0, and maybe of the higher levels */
+		if (idx == 0) {
+			for (lvl = 1; lvl < WHEEL_LEVELS; lvl++) {
+				slot = (w->now >> (lvl * WHEEL_LEVEL_BITS)) %
+					WHEEL_LEVEL_SLOTS;
+				wheel_cascade(w, lvl * WHEEL_LEVEL_SLOTS + slot);
+				if (slot != 0)
+					break;
+			}
+		}
+
+		next = wheel_next_slot(w, idx);
+		if (next == WHEEL_LEVEL_SLOTS) {
+			w->now = RTE_MIN(w->now + WHEEL_LEVEL_SLOTS - idx,
+				last + 1);
+			continue;
+		}
+		if (w->now + next - idx > last)
+			break;
+
+		/* the slot list is linked by sl_next[0], append it */
+		*pprev = wheel_slot_detach(w, next);
+		for (tim = *pprev; tim != NULL; tim = tim->sl_next[0]) {
+			wheel_set_slot(tim, WHEEL_NO_SLOT);
+			w->nb_timers--;
+			pprev = &tim->sl_next[0];
+		}
+		w->now += next - idx + 1;
+	}
+
+	if (w->now <= last)
+		w->now = last + 1;
+	wheel_update_expire(priv);
+
+	return run_first_tim;
+}
+
 /* call with lock held as necessary
  * add in list
  * timer must be in config state
@@ -385,6 +679,11 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
+	if (priv_timer[tim_lcore].wheel != NULL) {
+		wheel_add(&priv_timer[tim_lcore], tim);
+		return;
+	}
+
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
 	timer_get_prev_entries(tim->expire, tim_lcore, prev, priv_timer);
@@ -411,25 +710,15 @@ timer_add(struct rte_timer *tim, unsigned int tim_lcore,
 }
 
 /*
- * del from list, lock if needed
- * timer must be in config state
- * timer must be in a list
+ * del from the skiplist of lcore prev_owner, with lock held
  */
 static void
-timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
-	  int local_is_locked, struct priv_timer *priv_timer)
+timer_skiplist_del(struct rte_timer *tim, unsigned int prev_owner,
+		   struct priv_timer *priv_timer)
 {
-	unsigned lcore_id = rte_lcore_id();
-	unsigned prev_owner = prev_status.owner;
 	int i;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
-	/* if timer needs is pending another core, we need to lock the
-	 * list; if it is on local core, we need to lock if we are not
-	 * called from rte_timer_manage() */
-	if (prev_owner != lcore_id || !local_is_locked)
-		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
-
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
 	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
@@ -449,6 +738,30 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 			priv_timer[prev_owner].curr_skiplist_depth --;
 		else
 			break;
+}
+
+/*
+ * del from list, lock if needed
+ * timer must be in config state
+ * timer must be in a list
+ */
+static void
+timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
+	  int local_is_locked, struct priv_timer *priv_timer)
+{
+	unsigned lcore_id = rte_lcore_id();
+	unsigned prev_owner = prev_status.owner;
+
+	/* if timer needs is pending another core, we need to lock the
+	 * list; if it is on local core, we need to lock if we are not
+	 * called from rte_timer_manage() */
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+
+	if (priv_timer[prev_owner].wheel != NULL)
+		wheel_del(&priv_timer[prev_owner], tim);
+	else
+		timer_skiplist_del(tim, prev_owner, priv_timer);
 
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
@@ -636,6 +949,57 @@ rte_timer_pending(struct rte_timer *tim)
 	return tim->status.state == RTE_TIMER_PENDING;
 }
 
+static inline int
+timer_list_empty(const struct priv_timer *priv)
+{
+	if (priv->wheel != NULL)
+		return priv->wheel->nb_timers == 0;
+	return priv->pending_head.sl_next[0] == NULL;
+}
+
+/*
+ * Detach the expired timers from the pending list of an lcore, with lock
+ * held. Return them in a list linked by sl_next[0], ordered by expiry time
+ * (at the resolution of the wheel), or NULL if none expired.
+ */
+static struct rte_timer *
+timer_get_expired(unsigned int lcore_id, uint64_t cur_time,
+		  struct priv_timer *priv_timer)
+{
+	struct priv_timer *privp = &priv_timer[lcore_id];
+	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
+	struct rte_timer *tim;
+	int i;
+
+	if (privp->wheel != NULL)
+		return wheel_get_expired(privp, cur_time);
+
+	if (privp->pending_head.sl_next[0] == NULL ||
+	    privp->pending_head.sl_next[0]->expire > cur_time)
+		return NULL;
+
+	/* save start of list of expired timers */
+	tim = privp->pending_head.sl_next[0];
+
+	/* break the existing list at current time point */
+	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
+	for (i = privp->curr_skiplist_depth - 1; i >= 0; i--) {
+		if (prev[i] == &privp->pending_head)
+			continue;
+		privp->pending_head.sl_next[i] = prev[i]->sl_next[i];
+		if (prev[i]->sl_next[i] == NULL)
+			privp->curr_skiplist_depth--;
+		prev[i]->sl_next[i] = NULL;
+	}
+
+	/* update the next to expire timer value */
+	privp->pending_head.expire =
+	    (privp->pending_head.sl_next[0] == NULL) ? 0 :
+		privp->pending_head.sl_next[0]->expire;
+
+	return tim;
+}
+
 /* must be called periodically, run all timer that expired */
 static void
 __rte_timer_manage(struct rte_timer_data *timer_data)
@@ -644,9 +1008,8 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 	struct rte_timer *tim, *next_tim;
 	struct rte_timer *run_first_tim, **pprev;
 	unsigned lcore_id = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
 	uint64_t cur_time;
-	int i, ret;
+	int ret;
 	struct priv_timer *priv_timer = timer_data->priv_timer;
 
 	/* timer manager only runs on EAL thread with valid lcore_id */
@@ -654,7 +1017,7 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 
 	__TIMER_STAT_ADD(priv_timer, manage, 1);
 	/* optimize for the case where per-cpu list is empty */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
+	if (timer_list_empty(&priv_timer[lcore_id]))
 		return;
 	cur_time = rte_get_timer_cycles();
 
@@ -670,27 +1033,12 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
 
 	/* if nothing to do just unlock and return */
-	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
-	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
+	tim = timer_get_expired(lcore_id, cur_time, priv_timer);
+	if (tim == NULL) {
 		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
 		return;
 	}
 
-	/* save start of list of expired timers */
-	tim = priv_timer[lcore_id].pending_head.sl_next[0];
-
-	/* break the existing list at current time point */
-	timer_get_prev_entries(cur_time, lcore_id, prev, priv_timer);
-	for (i = priv_timer[lcore_id].curr_skiplist_depth -1; i >= 0; i--) {
-		if (prev[i] == &priv_timer[lcore_id].pending_head)
-			continue;
-		priv_timer[lcore_id].pending_head.sl_next[i] =
-		    prev[i]->sl_next[i];
-		if (prev[i]->sl_next[i] == NULL)
-			priv_timer[lcore_id].curr_skiplist_depth--;
-		prev[i] ->sl_next[i] = NULL;
-	}
-
 	/* transition run-list from PENDING to RUNNING */
 	run_first_tim = tim;
 	pprev = &run_first_tim;
@@ -709,11 +1057,6 @@ __rte_timer_manage(struct rte_timer_data *timer_data)
 		}
 	}
 
-	/* update the next to expire timer value */
-	priv_timer[lcore_id].pending_head.expire =
-	    (priv_timer[lcore_id].pending_head.sl_next[0] == NULL) ? 0 :
-		priv_timer[lcore_id].pending_head.sl_next[0]->expire;
-
 	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
 
 	/* now scan expired list and call callbacks */
@@ -778,9 +1121,8 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	struct rte_timer *tim, *next_tim, **pprev;
 	struct rte_timer *run_first_tims[RTE_MAX_LCORE];
 	unsigned int this_lcore = rte_lcore_id();
-	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
 	uint64_t cur_time;
-	int i, j, ret;
+	int i, ret;
 	int nb_runlists = 0;
 	struct rte_timer_data *data;
 	struct priv_timer *privp;
@@ -803,7 +1145,7 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 		privp = &data->priv_timer[poll_lcore];
 
 		/* optimize for the case where per-cpu list is empty */
-		if (privp->pending_head.sl_next[0] == NULL)
+		if (timer_list_empty(privp))
 			continue;
 		cur_time = rte_get_timer_cycles();
 
@@ -820,29 +1162,13 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 		rte_spinlock_lock(&privp->list_lock);
 
 		/* if nothing to do just unlock and return */
-		if (privp->pending_head.sl_next[0] == NULL ||
-		    privp->pending_head.sl_next[0]->expire > cur_time) {
+		tim = timer_get_expired(poll_lcore, cur_time,
+					data->priv_timer);
+		if (tim == NULL) {
 			rte_spinlock_unlock(&privp->list_lock);
 			continue;
 		}
 
-		/* save start of list of expired timers */
-		tim = privp->pending_head.sl_next[0];
-
-		/* break the existing list at current time point */
-		timer_get_prev_entries(cur_time, poll_lcore, prev,
-				       data->priv_timer);
-		for (j = privp->curr_skiplist_depth - 1; j >= 0; j--) {
-			if (prev[j] == &privp->pending_head)
-				continue;
-			privp->pending_head.sl_next[j] =
-				prev[j]->sl_next[j];
-			if (prev[j]->sl_next[j] == NULL)
-				privp->curr_skiplist_depth--;
-
-			prev[j]->sl_next[j] = NULL;
-		}
-
 		/* transition run-list from PENDING to RUNNING */
 		run_first_tims[nb_runlists] = tim;
 		pprev = &run_first_tims[nb_runlists];
@@ -862,11 +1188,6 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 			}
 		}
 
-		/* update the next to expire timer value */
-		privp->pending_head.expire =
-		    (privp->pending_head.sl_next[0] == NULL) ? 0 :
-			privp->pending_head.sl_next[0]->expire;
-
 		rte_spinlock_unlock(&privp->list_lock);
 	}
 
@@ -939,6 +1260,24 @@ rte_timer_alt_manage(uint32_t timer_data_id,
 	return 0;
 }
 
+/* Stop the timers of a list linked by sl_next[0] */
+static void
+timer_stop_list(struct rte_timer *tim, struct rte_timer_data *timer_data,
+		rte_timer_stop_all_cb_t f, void *f_arg)
+{
+	struct rte_timer *next_tim;
+
+	for (; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+
+		/* Call timer_stop with lock held */
+		__rte_timer_stop(tim, 1, timer_data);
+
+		if (f)
+			f(tim, f_arg);
+	}
+}
+
 /* Walk pending lists, stopping timers and calling user-specified function */
 int
 rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
@@ -947,8 +1286,7 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 {
 	int i;
 	struct priv_timer *priv_timer;
-	uint32_t walk_lcore;
-	struct rte_timer *tim, *next_tim;
+	uint32_t walk_lcore, slot;
 	struct rte_timer_data *timer_data;
 
 	TIMER_DATA_VALID_GET_OR_ERR_RET(timer_data_id, timer_data, -EINVAL);
@@ -959,16 +1297,13 @@ rte_timer_stop_all(uint32_t timer_data_id, unsigned int *walk_lcores,
 
 		rte_spinlock_lock(&priv_timer->list_lock);
 
-		for (tim = priv_timer->pending_head.sl_next[0];
-		     tim != NULL;
-		     tim = next_tim) {
-			next_tim = tim->sl_next[0];
-
-			/* Call timer_stop with lock held */
-			__rte_timer_stop(tim, 1, timer_data);
-
-			if (f)
-				f(tim, f_arg);
+		if (priv_timer->wheel != NULL) {
+			for (slot = 0; slot < WHEEL_SLOTS; slot++)
+				timer_stop_list(priv_timer->wheel->slots[slot],
+						timer_data, f, f_arg);
+		} else {
+			timer_stop_list(priv_timer->pending_head.sl_next[0],
+					timer_data, f, f_arg);
 		}
 
 		rte_spinlock_unlock(&priv_timer->list_lock);
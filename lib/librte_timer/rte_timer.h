@@ -150,6 +150,37 @@ struct rte_timer
 __rte_experimental
 int rte_timer_data_alloc(uint32_t *id_ptr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Allocate a timer data instance keeping the pending timers of each lcore
+ * in a hierarchical timing wheel, instead of a skiplist.
+ *
+ * Adding or removing a timer takes a constant time, whatever the number of
+ * pending timers, and the expired timers are collected a slot at a time.
+ * The timers expire at the first call to rte_timer_alt_manage() after
+ * their expiry time, rounded up to the resolution of the wheel. The timers
+ * of a same slot run in no particular order.
+ *
+ * The timer data instance is used with the rte_timer_alt_*() functions,
+ * and freed with rte_timer_data_dealloc().
+ *
+ * @param id_ptr
+ *   Pointer to variable into which to write the identifier of the allocated
+ *   timer data instance.
+ * @param resolution
+ *   Resolution of the wheel, in timer cycles (see rte_get_timer_hz()),
+ *   rounded down to a power of two. 0 selects about a microsecond.
+ *
+ * @return
+ *   - 0: Success
+ *   - -ENOSPC: maximum number of timer data instances already allocated
+ *   - -ENOMEM: timer subsystem not initialized, or no memory for the wheels
+ */
+__rte_experimental
+int rte_timer_data_alloc_wheel(uint32_t *id_ptr, uint64_t resolution);
+
 /**
  * @warning
  * @b EXPERIMENTAL: this API may change without prior notice